@@ -0,0 +1,191 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Linq::Expressions;
+using namespace System::Reflection;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// Reads a numeric property of an object as a double
+        /// </summary>
+        public delegate double AnimatedPropertyGetter(Object^ target);
+
+        /// <summary>
+        /// Writes a double to a numeric property of an object
+        /// </summary>
+        public delegate void AnimatedPropertySetter(Object^ target, double value);
+
+        /// <summary>
+        /// Typed accessor pair for one animatable property. Accessors are
+        /// either registered by hand or compiled once from an expression tree
+        /// over the property, so applying a value each frame is a direct
+        /// delegate call with no reflection, string lookup or boxing.
+        ///
+        /// Find caches one accessor per type and name for the life of the
+        /// process. Register custom accessors before the first Find on that
+        /// type.
+        /// </summary>
+        public ref class AnimatedProperty {
+        private:
+            static Dictionary<Type^, Dictionary<String^, AnimatedProperty^>^>^ registered =
+                gcnew Dictionary<Type^, Dictionary<String^, AnimatedProperty^>^>();
+            static Dictionary<Type^, Dictionary<String^, AnimatedProperty^>^>^ resolved =
+                gcnew Dictionary<Type^, Dictionary<String^, AnimatedProperty^>^>();
+
+            Type^ ownerType;
+            String^ name;
+            AnimatedPropertyGetter^ getter;
+            AnimatedPropertySetter^ setter;
+
+            static bool IsIntegral(Type^ type) {
+                return type == Int32::typeid || type == Int64::typeid || type == Int16::typeid || type == Byte::typeid;
+            }
+
+            static bool IsNumeric(Type^ type) {
+                return type == Double::typeid || type == Single::typeid || IsIntegral(type);
+            }
+
+            static AnimatedProperty^ Lookup(Dictionary<Type^, Dictionary<String^, AnimatedProperty^>^>^ table, Type^ type, String^ name, bool& found) {
+                Dictionary<String^, AnimatedProperty^>^ byName;
+                AnimatedProperty^ property = nullptr;
+                found = table->TryGetValue(type, byName) && byName->TryGetValue(name, property);
+                return property;
+            }
+
+            static void Store(Dictionary<Type^, Dictionary<String^, AnimatedProperty^>^>^ table, Type^ type, String^ name, AnimatedProperty^ property) {
+                Dictionary<String^, AnimatedProperty^>^ byName;
+                if (!table->TryGetValue(type, byName)) {
+                    byName = gcnew Dictionary<String^, AnimatedProperty^>();
+                    table->Add(type, byName);
+                }
+                byName[name] = property;
+            }
+
+        public:
+            AnimatedProperty(Type^ ownerType, String^ name, AnimatedPropertyGetter^ getter, AnimatedPropertySetter^ setter) {
+                if (ownerType == nullptr)
+                    throw gcnew ArgumentNullException("ownerType");
+                if (String::IsNullOrEmpty(name))
+                    throw gcnew ArgumentNullException("name");
+                if (getter == nullptr)
+                    throw gcnew ArgumentNullException("getter");
+                if (setter == nullptr)
+                    throw gcnew ArgumentNullException("setter");
+                this->ownerType = ownerType;
+                this->name = name;
+                this->getter = getter;
+                this->setter = setter;
+            }
+
+            /// <summary>
+            /// Gets the type declaring the property
+            /// </summary>
+            property Type^ OwnerType {
+                Type^ get() { return ownerType; }
+            }
+
+            /// <summary>
+            /// Gets the property name
+            /// </summary>
+            property String^ Name {
+                String^ get() { return name; }
+            }
+
+            double GetValue(Object^ target) {
+                return getter(target);
+            }
+
+            void SetValue(Object^ target, double value) {
+                setter(target, value);
+            }
+
+            /// <summary>
+            /// Makes a property animatable on a type and its subclasses
+            /// without reflection, or overrides the compiled accessor
+            /// </summary>
+            static void Register(AnimatedProperty^ property) {
+                if (property == nullptr)
+                    throw gcnew ArgumentNullException("property");
+                Store(registered, property->OwnerType, property->Name, property);
+            }
+
+            /// <summary>
+            /// Compiles accessors for a public, readable and writable instance
+            /// property of type double, float, long, int, short or byte on a
+            /// reference type. Integral properties get the value rounded and
+            /// clamped to their range. Returns null when there is no such
+            /// property.
+            /// </summary>
+            static AnimatedProperty^ Compile(Type^ type, String^ name) {
+                if (type == nullptr)
+                    throw gcnew ArgumentNullException("type");
+                if (String::IsNullOrEmpty(name))
+                    throw gcnew ArgumentNullException("name");
+                if (type->IsValueType)
+                    return nullptr;
+                // The most derived declaration wins, so a property hidden with
+                // new is not ambiguous with the one it hides
+                PropertyInfo^ info = nullptr;
+                for (Type^ t = type; t != nullptr && info == nullptr; t = t->BaseType)
+                    info = t->GetProperty(name, BindingFlags::Public | BindingFlags::Instance | BindingFlags::DeclaredOnly);
+                if (info == nullptr || info->GetIndexParameters()->Length != 0 || !IsNumeric(info->PropertyType) ||
+                    info->GetGetMethod() == nullptr || info->GetSetMethod() == nullptr)
+                    return nullptr;
+
+                Type^ valueType = info->PropertyType;
+                ParameterExpression^ target = Expression::Parameter(Object::typeid, "target");
+                ParameterExpression^ value = Expression::Parameter(Double::typeid, "value");
+                MemberExpression^ member = Expression::Property(Expression::Convert(target, type), info);
+
+                Expression^ converted = value;
+                if (IsIntegral(valueType)) {
+                    Type^ math = System::Math::typeid;
+                    array<Type^>^ pair = gcnew array<Type^>{ Double::typeid, Double::typeid };
+                    double low = Convert::ToDouble(valueType->GetField("MinValue")->GetValue(nullptr));
+                    double high = Convert::ToDouble(valueType->GetField("MaxValue")->GetValue(nullptr));
+                    // Int64.MaxValue rounds up to 2^63, which overflows the
+                    // conversion back; clamp to the largest double below it
+                    if (valueType == Int64::typeid)
+                        high = 9223372036854774784.0;
+                    converted = Expression::Call(math->GetMethod("Round", gcnew array<Type^>{ Double::typeid }), converted);
+                    converted = Expression::Call(math->GetMethod("Max", pair), converted, Expression::Constant(low));
+                    converted = Expression::Call(math->GetMethod("Min", pair), converted, Expression::Constant(high));
+                }
+                Expression^ assign = Expression::Assign(member, Expression::Convert(converted, valueType));
+
+                AnimatedPropertySetter^ setter = Expression::Lambda<AnimatedPropertySetter^>(assign, target, value)->Compile();
+                AnimatedPropertyGetter^ getter = Expression::Lambda<AnimatedPropertyGetter^>(
+                    Expression::Convert(member, Double::typeid), target)->Compile();
+                return gcnew AnimatedProperty(info->DeclaringType, name, getter, setter);
+            }
+
+            /// <summary>
+            /// Gets the accessor of a property on a type: a registered one on
+            /// the type or its nearest base, else a compiled one. Results,
+            /// including misses, are cached, so this is a hash lookup after
+            /// the first call. Returns null when the property cannot be
+            /// animated.
+            /// </summary>
+            static AnimatedProperty^ Find(Type^ type, String^ name) {
+                if (type == nullptr)
+                    throw gcnew ArgumentNullException("type");
+                if (String::IsNullOrEmpty(name))
+                    throw gcnew ArgumentNullException("name");
+
+                bool found;
+                AnimatedProperty^ property = Lookup(resolved, type, name, found);
+                if (found)
+                    return property;
+
+                for (Type^ t = type; t != nullptr && !found; t = t->BaseType)
+                    property = Lookup(registered, t, name, found);
+                if (!found)
+                    property = Compile(type, name);
+                Store(resolved, type, name, property);
+                return property;
+            }
+        };
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "AnimationEngine.h"
+
 using namespace System;
 using namespace System::ComponentModel;
 using namespace System::Collections;
@@ -14,7 +16,9 @@ namespace WPAnimation {
 	};
 
 	/// <summary>
-	/// Summary for Animation
+	/// Designer component holding animation settings (duration, delay,
+	/// easing) and starting animations with them on an AnimationEngine.
+	/// The engine does the work; any number of components share one.
 	/// </summary>
 	public ref class Animation :  public System::ComponentModel::Component
 	{
@@ -22,9 +26,8 @@ namespace WPAnimation {
 		Animation(void)
 		{
 			InitializeComponent();
-			//
-			//TODO: Add the constructor code here
-			//
+			duration = 0.25;
+			easing = WindowPlus::Animation::Easing::OutCubic;
 		}
 		Animation(System::ComponentModel::IContainer ^container)
 		{
@@ -34,20 +37,100 @@ namespace WPAnimation {
 
 			container->Add(this);
 			InitializeComponent();
+			duration = 0.25;
+			easing = WindowPlus::Animation::Easing::OutCubic;
+		}
+
+
+
+		/// <summary>
+		/// Gets or sets the engine that runs this component's animations
+		/// (AnimationEngine::Default unless set)
+		/// </summary>
+		[Browsable(false)]
+		[DesignerSerializationVisibility(DesignerSerializationVisibility::Hidden)]
+		property WindowPlus::Animation::AnimationEngine^ Engine
+		{
+			WindowPlus::Animation::AnimationEngine^ get()
+			{
+				return engine != nullptr ? engine : WindowPlus::Animation::AnimationEngine::Default;
+			}
+			void set(WindowPlus::Animation::AnimationEngine^ value) { engine = value; }
 		}
 
+		/// <summary>
+		/// Gets or sets the duration in seconds
+		/// </summary>
+		[Category("Animation")]
+		[DefaultValue(0.25)]
+		property double Duration
+		{
+			double get() { return duration; }
+			void set(double value)
+			{
+				if (!(value >= 0) || Double::IsInfinity(value))
+					throw gcnew ArgumentOutOfRangeException("value");
+				duration = value;
+			}
+		}
+
+		/// <summary>
+		/// Gets or sets the delay in seconds before the animation starts
+		/// </summary>
+		[Category("Animation")]
+		[DefaultValue(0.0)]
+		property double Delay
+		{
+			double get() { return delay; }
+			void set(double value)
+			{
+				if (!(value >= 0) || Double::IsInfinity(value))
+					throw gcnew ArgumentOutOfRangeException("value");
+				delay = value;
+			}
+		}
 
+		/// <summary>
+		/// Gets or sets the easing curve
+		/// </summary>
+		[Category("Animation")]
+		[DefaultValue(WindowPlus::Animation::Easing::OutCubic)]
+		property WindowPlus::Animation::Easing Easing
+		{
+			WindowPlus::Animation::Easing get() { return easing; }
+			void set(WindowPlus::Animation::Easing value) { easing = value; }
+		}
 
-		int i;
-		void putprop(int j) {
-			i = j;
+		/// <summary>
+		/// Gets or sets a custom easing curve used instead of Easing when set
+		/// </summary>
+		[Browsable(false)]
+		[DesignerSerializationVisibility(DesignerSerializationVisibility::Hidden)]
+		property WindowPlus::Animation::EasingCurve^ Curve
+		{
+			WindowPlus::Animation::EasingCurve^ get() { return curve; }
+			void set(WindowPlus::Animation::EasingCurve^ value) { curve = value; }
 		}
 
-		int getprop() {
-			return i;
+		/// <summary>
+		/// Animates an engine target from its current value to another with
+		/// this component's duration, delay and curve
+		/// </summary>
+		WindowPlus::Animation::AnimationHandle Start(int target, double to)
+		{
+			return Start(target, Engine->GetValue(target), to);
 		}
 
-		__declspec(property(get = getprop, put = putprop)) int the_prop;
+		/// <summary>
+		/// Animates an engine target between two values with this
+		/// component's duration, delay and curve
+		/// </summary>
+		WindowPlus::Animation::AnimationHandle Start(int target, double from, double to)
+		{
+			if (curve != nullptr)
+				return Engine->Start(target, from, to, duration, delay, curve);
+			return Engine->Start(target, from, to, duration, delay, easing);
+		}
 
 	protected:
 		/// <summary>
@@ -62,6 +145,12 @@ namespace WPAnimation {
 		}
 
 	private:
+		WindowPlus::Animation::AnimationEngine^ engine;
+		double duration;
+		double delay;
+		WindowPlus::Animation::Easing easing;
+		WindowPlus::Animation::EasingCurve^ curve;
+
 		/// <summary>
 		/// Required designer variable.
 		/// </summary>
@@ -0,0 +1,66 @@
+#pragma once
+
+using namespace System;
+using namespace System::Diagnostics;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// Source of time for an AnimationEngine, in seconds from an arbitrary
+        /// origin
+        /// </summary>
+        public interface class IAnimationClock {
+            property double Now {
+                double get();
+            }
+        };
+
+        /// <summary>
+        /// Wall-clock time from the high-resolution performance counter
+        /// </summary>
+        public ref class StopwatchClock : public IAnimationClock {
+        private:
+            double scale;
+
+        public:
+            StopwatchClock() {
+                scale = 1.0 / Stopwatch::Frequency;
+            }
+
+            virtual property double Now {
+                double get() { return Stopwatch::GetTimestamp() * scale; }
+            }
+        };
+
+        /// <summary>
+        /// Clock that only moves when told to, for headless runs and tests
+        /// </summary>
+        public ref class ManualClock : public IAnimationClock {
+        private:
+            double now;
+
+        public:
+            ManualClock() {
+            }
+
+            ManualClock(double start) {
+                now = start;
+            }
+
+            /// <summary>
+            /// Gets or sets the current time in seconds
+            /// </summary>
+            virtual property double Now {
+                double get() { return now; }
+                void set(double value) { now = value; }
+            }
+
+            /// <summary>
+            /// Moves the clock forward by the given number of seconds
+            /// </summary>
+            void Advance(double seconds) {
+                now += seconds;
+            }
+        };
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "AnimatedProperty.h"
+#include "EasingCurve.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// One property transition of an animation definition
+        /// </summary>
+        public ref class PropertyAnimation {
+        private:
+            String^ name;
+            Nullable<double> from;
+            double to;
+            double duration;
+            double delay;
+            EasingCurve^ curve;
+
+        public:
+            PropertyAnimation(String^ property, Nullable<double> from, double to, double duration, double delay, EasingCurve^ curve) {
+                if (String::IsNullOrEmpty(property))
+                    throw gcnew ArgumentNullException("property");
+                if (!(duration >= 0) || Double::IsInfinity(duration))
+                    throw gcnew ArgumentOutOfRangeException("duration");
+                if (!(delay >= 0) || Double::IsInfinity(delay))
+                    throw gcnew ArgumentOutOfRangeException("delay");
+                name = property;
+                this->from = from;
+                this->to = to;
+                this->duration = duration;
+                this->delay = delay;
+                this->curve = curve;
+            }
+
+            /// <summary>
+            /// Gets the animated property name
+            /// </summary>
+            property String^ Property {
+                String^ get() { return name; }
+            }
+
+            /// <summary>
+            /// Gets the start value, or null to start from the current value
+            /// </summary>
+            property Nullable<double> From {
+                Nullable<double> get() { return from; }
+            }
+
+            /// <summary>
+            /// Gets the end value
+            /// </summary>
+            property double To {
+                double get() { return to; }
+            }
+
+            /// <summary>
+            /// Gets the length in seconds
+            /// </summary>
+            property double Duration {
+                double get() { return duration; }
+            }
+
+            /// <summary>
+            /// Gets the wait before starting in seconds
+            /// </summary>
+            property double Delay {
+                double get() { return delay; }
+            }
+
+            /// <summary>
+            /// Gets the easing curve, or null for ease-out cubic
+            /// </summary>
+            property EasingCurve^ Curve {
+                EasingCurve^ get() { return curve; }
+            }
+        };
+
+        /// <summary>
+        /// Named set of property transitions started together on one object.
+        /// The property names are resolved to accessors once per target type
+        /// and cached, so starting the definition again does no reflection.
+        /// </summary>
+        public ref class AnimationDefinition {
+        private:
+            List<PropertyAnimation^>^ items;
+            Dictionary<Type^, array<AnimatedProperty^>^>^ plans;
+
+        internal:
+            /// <summary>
+            /// Accessor of each item on a target type, null where the type has
+            /// no such animatable property
+            /// </summary>
+            array<AnimatedProperty^>^ Resolve(Type^ type) {
+                array<AnimatedProperty^>^ plan;
+                if (!plans->TryGetValue(type, plan)) {
+                    plan = gcnew array<AnimatedProperty^>(items->Count);
+                    for (int i = 0; i < items->Count; i++)
+                        plan[i] = AnimatedProperty::Find(type, items[i]->Property);
+                    plans->Add(type, plan);
+                }
+                return plan;
+            }
+
+        public:
+            AnimationDefinition() {
+                items = gcnew List<PropertyAnimation^>();
+                plans = gcnew Dictionary<Type^, array<AnimatedProperty^>^>();
+            }
+
+            /// <summary>
+            /// Gets the number of property transitions
+            /// </summary>
+            property int Count {
+                int get() { return items->Count; }
+            }
+
+            property PropertyAnimation^ default[int] {
+                PropertyAnimation^ get(int index) { return items[index]; }
+            }
+
+            /// <summary>
+            /// Adds a transition and returns this definition
+            /// </summary>
+            AnimationDefinition^ Add(PropertyAnimation^ animation) {
+                if (animation == nullptr)
+                    throw gcnew ArgumentNullException("animation");
+                items->Add(animation);
+                plans->Clear();
+                return this;
+            }
+
+            /// <summary>
+            /// Adds a transition from the current value with ease-out cubic
+            /// </summary>
+            AnimationDefinition^ Animate(String^ property, double to, double duration) {
+                return Add(gcnew PropertyAnimation(property, Nullable<double>(), to, duration, 0, nullptr));
+            }
+
+            /// <summary>
+            /// Adds a transition from the current value along a curve
+            /// </summary>
+            AnimationDefinition^ Animate(String^ property, double to, double duration, EasingCurve^ curve) {
+                return Add(gcnew PropertyAnimation(property, Nullable<double>(), to, duration, 0, curve));
+            }
+
+            /// <summary>
+            /// Adds a transition between two values after a delay
+            /// </summary>
+            AnimationDefinition^ Animate(String^ property, double from, double to, double duration, double delay, EasingCurve^ curve) {
+                return Add(gcnew PropertyAnimation(property, Nullable<double>(from), to, duration, delay, curve));
+            }
+        };
+    }
+}
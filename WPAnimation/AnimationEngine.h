@@ -0,0 +1,440 @@
+#pragma once
+
+#include "AnimationClock.h"
+#include "EasingCurve.h"
+#include "Native/AnimationEngine.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// Identifies one running animation. Handles of animations that were
+        /// stopped, replaced or finished stay invalid for good.
+        /// </summary>
+        public value struct AnimationHandle : IEquatable<AnimationHandle> {
+        private:
+            long long id;
+
+        internal:
+            AnimationHandle(long long value) {
+                id = value;
+            }
+
+            property long long Id {
+                long long get() { return id; }
+            }
+
+        public:
+            /// <summary>
+            /// Gets whether this handle was ever issued
+            /// </summary>
+            property bool IsEmpty {
+                bool get() { return id == 0; }
+            }
+
+            virtual bool Equals(AnimationHandle other) {
+                return id == other.id;
+            }
+
+            virtual bool Equals(Object^ obj) override {
+                return obj != nullptr && obj->GetType() == AnimationHandle::typeid && Equals(safe_cast<AnimationHandle>(obj));
+            }
+
+            virtual int GetHashCode() override {
+                return id.GetHashCode();
+            }
+
+            static bool operator==(AnimationHandle a, AnimationHandle b) {
+                return a.id == b.id;
+            }
+
+            static bool operator!=(AnimationHandle a, AnimationHandle b) {
+                return a.id != b.id;
+            }
+        };
+
+        /// <summary>
+        /// Called once for each animation that ran to its end, after its final
+        /// value was written to the target
+        /// </summary>
+        public delegate void AnimationCompletedHandler(AnimationHandle animation, int target);
+
+        /// <summary>
+        /// Central animation scheduler: every running animation lives in one
+        /// native structure-of-arrays table and Tick advances all of them in a
+        /// single batched pass, so hundreds of animations cost one timer and no
+        /// per-animation objects. Start, Stop and Retarget are O(1).
+        ///
+        /// Animated values live in target slots owned by the engine. Callers
+        /// create a slot per animated property, start animations on it and
+        /// read the value back, or walk the targets written by the last tick.
+        /// Time comes from an injectable clock in seconds; with AutoTick off
+        /// nothing runs until Tick is called, which makes the engine usable
+        /// headless.
+        /// </summary>
+        public ref class AnimationEngine {
+        private:
+            static AnimationEngine^ defaultEngine;
+
+            Native::AnimationEngine* engine;
+            IAnimationClock^ clock;
+            System::Windows::Forms::Timer^ timer;
+            int frameInterval;
+            Dictionary<EasingCurve^, int>^ curveIds;
+            List<Func<double, bool>^>^ playbacks;
+
+            Native::AnimationEngine& Engine() {
+                if (!engine)
+                    throw gcnew ObjectDisposedException("AnimationEngine");
+                return *engine;
+            }
+
+            void CheckTarget(int target) {
+                if (!Engine().IsTarget(target))
+                    throw gcnew ArgumentOutOfRangeException("target");
+            }
+
+            static void CheckDuration(double duration) {
+                if (!(duration >= 0) || Double::IsInfinity(duration))
+                    throw gcnew ArgumentOutOfRangeException("duration");
+            }
+
+            void Initialize(IAnimationClock^ source, int capacity) {
+                if (source == nullptr)
+                    throw gcnew ArgumentNullException("clock");
+                if (capacity < 0)
+                    throw gcnew ArgumentOutOfRangeException("capacity");
+                clock = source;
+                frameInterval = 16;
+                curveIds = gcnew Dictionary<EasingCurve^, int>();
+                playbacks = gcnew List<Func<double, bool>^>();
+                engine = new Native::AnimationEngine(capacity);
+            }
+
+            /// <summary>
+            /// Native id of a curve, registered with the engine on first use
+            /// </summary>
+            int CurveId(EasingCurve^ curve) {
+                if (curve == nullptr)
+                    throw gcnew ArgumentNullException("curve");
+                int id;
+                if (!curveIds->TryGetValue(curve, id)) {
+                    id = Engine().RegisterCurve(curve->NativeCurve);
+                    curveIds->Add(curve, id);
+                }
+                return id;
+            }
+
+            AnimationHandle StartCurve(int target, double from, double to, double duration, double delay, int curve) {
+                CheckTarget(target);
+                CheckDuration(duration);
+                CheckDuration(delay);
+                AnimationHandle handle(Engine().Start(target, from, to, clock->Now + delay, duration, curve));
+                EnsureRunning();
+                return handle;
+            }
+
+            void OnTimer(Object^ sender, EventArgs^ e) {
+                Tick();
+            }
+
+            void EnsureRunning() {
+                if (timer != nullptr && !timer->Enabled)
+                    timer->Start();
+            }
+
+        internal:
+            /// <summary>
+            /// Calls advance with the tick time on every Tick, after the
+            /// engine's animations and before Ticked, until it returns false
+            /// </summary>
+            void AddPlayback(Func<double, bool>^ advance) {
+                if (!playbacks->Contains(advance))
+                    playbacks->Add(advance);
+                EnsureRunning();
+            }
+
+            void RemovePlayback(Func<double, bool>^ advance) {
+                playbacks->Remove(advance);
+            }
+
+            /// <summary>
+            /// Sets the value of a target and lists it among the targets
+            /// written by the current tick, so Ticked consumers apply it
+            /// </summary>
+            void WriteValue(int target, double value) {
+                CheckTarget(target);
+                Engine().Write(target, value);
+            }
+
+        public:
+            /// <summary>
+            /// Creates an engine on the wall clock
+            /// </summary>
+            AnimationEngine() {
+                Initialize(gcnew StopwatchClock(), 64);
+            }
+
+            /// <summary>
+            /// Creates an engine on the given clock
+            /// </summary>
+            AnimationEngine(IAnimationClock^ clock) {
+                Initialize(clock, 64);
+            }
+
+            /// <summary>
+            /// Creates an engine on the given clock with room for capacity
+            /// animations and targets before its tables grow
+            /// </summary>
+            AnimationEngine(IAnimationClock^ clock, int capacity) {
+                Initialize(clock, capacity);
+            }
+
+            ~AnimationEngine() {
+                if (timer != nullptr) {
+                    timer->Stop();
+                    delete timer;
+                    timer = nullptr;
+                }
+                this->!AnimationEngine();
+            }
+
+            !AnimationEngine() {
+                delete engine;
+                engine = nullptr;
+            }
+
+            /// <summary>
+            /// Gets the engine shared by components that are not given one,
+            /// on the wall clock with AutoTick on
+            /// </summary>
+            static property AnimationEngine^ Default {
+                AnimationEngine^ get() {
+                    if (defaultEngine == nullptr) {
+                        defaultEngine = gcnew AnimationEngine();
+                        defaultEngine->AutoTick = true;
+                    }
+                    return defaultEngine;
+                }
+            }
+
+            /// <summary>
+            /// Raised for each animation that finished during a tick
+            /// </summary>
+            event AnimationCompletedHandler^ Completed;
+
+            /// <summary>
+            /// Raised after every tick that wrote at least one target
+            /// </summary>
+            event EventHandler^ Ticked;
+
+            /// <summary>
+            /// Gets the clock that times the animations
+            /// </summary>
+            property IAnimationClock^ Clock {
+                IAnimationClock^ get() { return clock; }
+            }
+
+            /// <summary>
+            /// Gets the current time of the clock in seconds
+            /// </summary>
+            property double Now {
+                double get() { return clock->Now; }
+            }
+
+            /// <summary>
+            /// Gets the number of running animations
+            /// </summary>
+            property int Count {
+                int get() { return Engine().Count(); }
+            }
+
+            /// <summary>
+            /// Gets or sets whether a single UI-thread timer drives Tick while
+            /// animations are running. It stops by itself when the last one
+            /// finishes.
+            /// </summary>
+            property bool AutoTick {
+                bool get() { return timer != nullptr; }
+                void set(bool value) {
+                    if (value == (timer != nullptr))
+                        return;
+                    if (value) {
+                        timer = gcnew System::Windows::Forms::Timer();
+                        timer->Interval = frameInterval;
+                        timer->Tick += gcnew EventHandler(this, &AnimationEngine::OnTimer);
+                        if (Count > 0 || playbacks->Count > 0)
+                            timer->Start();
+                    }
+                    else {
+                        timer->Stop();
+                        delete timer;
+                        timer = nullptr;
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the AutoTick period in milliseconds
+            /// </summary>
+            property int FrameInterval {
+                int get() { return frameInterval; }
+                void set(int value) {
+                    if (value < 1)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    frameInterval = value;
+                    if (timer != nullptr)
+                        timer->Interval = value;
+                }
+            }
+
+            /// <summary>
+            /// Creates a target slot holding an initial value
+            /// </summary>
+            int CreateTarget(double initial) {
+                return Engine().CreateTarget(initial);
+            }
+
+            /// <summary>
+            /// Stops any animation on a target and frees the slot for reuse
+            /// </summary>
+            void ReleaseTarget(int target) {
+                CheckTarget(target);
+                Engine().ReleaseTarget(target);
+            }
+
+            /// <summary>
+            /// Gets the current value of a target
+            /// </summary>
+            double GetValue(int target) {
+                CheckTarget(target);
+                return Engine().Value(target);
+            }
+
+            /// <summary>
+            /// Sets the value of a target; a running animation on it
+            /// overwrites it on the next tick
+            /// </summary>
+            void SetValue(int target, double value) {
+                CheckTarget(target);
+                Engine().SetValue(target, value);
+            }
+
+            /// <summary>
+            /// Gets the animation currently driving a target, empty when idle
+            /// </summary>
+            AnimationHandle GetAnimation(int target) {
+                CheckTarget(target);
+                return AnimationHandle(Engine().Driver(target));
+            }
+
+            /// <summary>
+            /// Animates a target from its current value to another over
+            /// duration seconds, replacing any animation already on it
+            /// </summary>
+            AnimationHandle Start(int target, double to, double duration, Easing easing) {
+                CheckTarget(target);
+                return Start(target, Engine().Value(target), to, duration, 0, easing);
+            }
+
+            /// <summary>
+            /// Animates a target between two values over duration seconds,
+            /// after delay seconds, replacing any animation already on it
+            /// </summary>
+            AnimationHandle Start(int target, double from, double to, double duration, double delay, Easing easing) {
+                if ((int)easing < 0 || (int)easing >= Native::BuiltinEasingCount)
+                    throw gcnew ArgumentOutOfRangeException("easing");
+                return StartCurve(target, from, to, duration, delay, (int)easing);
+            }
+
+            /// <summary>
+            /// Animates a target between two values along a custom curve.
+            /// Each distinct curve object is registered once, so reuse curve
+            /// instances rather than creating one per start.
+            /// </summary>
+            AnimationHandle Start(int target, double from, double to, double duration, double delay, EasingCurve^ curve) {
+                return StartCurve(target, from, to, duration, delay, CurveId(curve));
+            }
+
+            /// <summary>
+            /// Stops an animation where it is. Returns false if it was not
+            /// running.
+            /// </summary>
+            bool Stop(AnimationHandle animation) {
+                return Engine().Stop(animation.Id);
+            }
+
+            /// <summary>
+            /// Sends a running animation to a new end value over duration
+            /// seconds from its current value, keeping the motion continuous.
+            /// Returns false if it was not running.
+            /// </summary>
+            bool Retarget(AnimationHandle animation, double to, double duration) {
+                CheckDuration(duration);
+                return Engine().Retarget(animation.Id, clock->Now, to, duration);
+            }
+
+            /// <summary>
+            /// Gets whether an animation is still running
+            /// </summary>
+            bool IsActive(AnimationHandle animation) {
+                return Engine().IsActive(animation.Id);
+            }
+
+            /// <summary>
+            /// Advances every animation to the clock's current time
+            /// </summary>
+            void Tick() {
+                Tick(clock->Now);
+            }
+
+            /// <summary>
+            /// Advances every animation to the given time in seconds, writes
+            /// their targets, advances the playing storyboards, then raises
+            /// Completed for the finished animations and Ticked
+            /// </summary>
+            void Tick(double now) {
+                Native::AnimationEngine& e = Engine();
+                e.Tick(now);
+
+                if (playbacks->Count > 0) {
+                    // A snapshot, since players may begin or stop others as they complete
+                    array<Func<double, bool>^>^ current = playbacks->ToArray();
+                    for (int i = 0; i < current->Length; i++) {
+                        if (!current[i](now))
+                            playbacks->Remove(current[i]);
+                    }
+                }
+
+                const std::vector<Native::Completion>& finished = e.Finished();
+                for (std::size_t i = 0; i < finished.size(); i++)
+                    Completed(AnimationHandle(finished[i].Id), finished[i].Target);
+                if (!e.Written().empty())
+                    Ticked(this, EventArgs::Empty);
+
+                if (timer != nullptr && e.Count() == 0 && playbacks->Count == 0)
+                    timer->Stop();
+            }
+
+            /// <summary>
+            /// Gets the number of targets written by the last tick, animations
+            /// and storyboard players alike
+            /// </summary>
+            property int WrittenCount {
+                int get() { return (int)Engine().Written().size(); }
+            }
+
+            /// <summary>
+            /// Gets the index-th target written by the last tick
+            /// </summary>
+            int GetWrittenTarget(int index) {
+                const std::vector<int>& written = Engine().Written();
+                if (index < 0 || index >= (int)written.size())
+                    throw gcnew ArgumentOutOfRangeException("index");
+                return written[index];
+            }
+        };
+    }
+}
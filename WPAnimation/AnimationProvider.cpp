@@ -0,0 +1,4 @@
+#include "pch.h"
+#include "AnimatedProperty.h"
+#include "AnimationDefinition.h"
+#include "AnimationProvider.h"
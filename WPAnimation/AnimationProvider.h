@@ -0,0 +1,327 @@
+#pragma once
+
+#include "AnimationDefinition.h"
+#include "AnimationEngine.h"
+#include "InvalidationBatcher.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// IAnimationProvider backed by an AnimationEngine. Animations are
+        /// registered by name as AnimationDefinitions and started on any
+        /// object whose animated properties are numeric.
+        ///
+        /// Every name, type and property lookup happens when an animation
+        /// starts, and each of them is a cached hash lookup after the first
+        /// time. While an animation runs, each engine target maps through an
+        /// array to its object and typed accessor. Each frame writes the
+        /// targets the engine touched with direct delegate calls on doubles,
+        /// with no strings, reflection or boxing. Writes to controls mark
+        /// their areas in an InvalidationBatcher, which repaints each window
+        /// once at the end of the frame.
+        /// </summary>
+        public ref class AnimationProvider : public WindowPlus::Controls::IAnimationProvider {
+        private:
+            ref class Binding {
+            public:
+                Object^ Target;
+                Control^ Visual;                // Target when it is a control
+                AnimatedProperty^ Property;
+                int Slot;
+                AnimationHandle Animation;
+                String^ Name;
+            };
+
+            AnimationEngine^ engine;
+            Dictionary<String^, AnimationDefinition^>^ definitions;
+            Dictionary<Object^, List<Binding^>^>^ active;
+            array<Binding^>^ slots;
+            InvalidationBatcher^ invalidation;
+            bool ownsInvalidation;              // created by Initialize, disposed with the provider
+            EventHandler^ tickedHandler;
+            AnimationCompletedHandler^ completedHandler;
+            bool enabled;
+
+            void Initialize(AnimationEngine^ source) {
+                if (source == nullptr)
+                    throw gcnew ArgumentNullException("engine");
+                engine = source;
+                definitions = gcnew Dictionary<String^, AnimationDefinition^>();
+                active = gcnew Dictionary<Object^, List<Binding^>^>();
+                slots = gcnew array<Binding^>(16);
+                invalidation = gcnew InvalidationBatcher();
+                ownsInvalidation = true;
+                enabled = true;
+                tickedHandler = gcnew EventHandler(this, &AnimationProvider::OnTicked);
+                completedHandler = gcnew AnimationCompletedHandler(this, &AnimationProvider::OnCompleted);
+                engine->Ticked += tickedHandler;
+                engine->Completed += completedHandler;
+            }
+
+            Binding^ BindingAt(int slot) {
+                return slot >= 0 && slot < slots->Length ? slots[slot] : nullptr;
+            }
+
+            /// <summary>
+            /// Binding of a property of a target, with an engine target
+            /// holding the property's current value when new
+            /// </summary>
+            Binding^ Bind(Object^ target, AnimatedProperty^ property) {
+                List<Binding^>^ bindings;
+                if (!active->TryGetValue(target, bindings)) {
+                    bindings = gcnew List<Binding^>();
+                    active->Add(target, bindings);
+                }
+                for (int i = 0; i < bindings->Count; i++) {
+                    if (bindings[i]->Property == property)
+                        return bindings[i];
+                }
+
+                Binding^ binding = gcnew Binding();
+                binding->Target = target;
+                binding->Visual = dynamic_cast<Control^>(target);
+                binding->Property = property;
+                binding->Slot = engine->CreateTarget(property->GetValue(target));
+                if (binding->Slot >= slots->Length)
+                    Array::Resize(slots, System::Math::Max(slots->Length * 2, binding->Slot + 1));
+                slots[binding->Slot] = binding;
+                bindings->Add(binding);
+                return binding;
+            }
+
+            void Release(Binding^ binding) {
+                slots[binding->Slot] = nullptr;
+                engine->ReleaseTarget(binding->Slot);
+                List<Binding^>^ bindings;
+                if (active->TryGetValue(binding->Target, bindings)) {
+                    bindings->Remove(binding);
+                    if (bindings->Count == 0)
+                        active->Remove(binding->Target);
+                }
+            }
+
+            /// <summary>
+            /// Writes a value, marking a control's area before and after so a
+            /// move or resize repaints both
+            /// </summary>
+            void Apply(Binding^ binding, double value) {
+                InvalidationBatcher^ batcher = invalidation;
+                if (batcher != nullptr && binding->Visual != nullptr) {
+                    batcher->Invalidate(binding->Visual);
+                    binding->Property->SetValue(binding->Target, value);
+                    batcher->Invalidate(binding->Visual);
+                }
+                else
+                    binding->Property->SetValue(binding->Target, value);
+            }
+
+            void OnTicked(Object^ sender, EventArgs^ e) {
+                int count = engine->WrittenCount;
+                for (int i = 0; i < count; i++) {
+                    int slot = engine->GetWrittenTarget(i);
+                    Binding^ binding = BindingAt(slot);
+                    if (binding != nullptr)
+                        Apply(binding, engine->GetValue(slot));
+                }
+                if (invalidation != nullptr)
+                    invalidation->Flush();
+            }
+
+            void OnCompleted(AnimationHandle animation, int slot) {
+                Binding^ binding = BindingAt(slot);
+                if (binding == nullptr || binding->Animation != animation)
+                    return;
+                Apply(binding, engine->GetValue(slot));
+                Release(binding);
+            }
+
+        public:
+            /// <summary>
+            /// Creates a provider on the shared engine
+            /// </summary>
+            AnimationProvider() {
+                Initialize(AnimationEngine::Default);
+            }
+
+            /// <summary>
+            /// Creates a provider on the given engine
+            /// </summary>
+            AnimationProvider(AnimationEngine^ engine) {
+                Initialize(engine);
+            }
+
+            ~AnimationProvider() {
+                StopAll();
+                engine->Ticked -= tickedHandler;
+                engine->Completed -= completedHandler;
+                if (ownsInvalidation)
+                    delete invalidation;
+                invalidation = nullptr;
+            }
+
+            /// <summary>
+            /// Registers a provider on the shared engine as the application's
+            /// IAnimationProvider and returns it
+            /// </summary>
+            static AnimationProvider^ Install() {
+                AnimationProvider^ provider = gcnew AnimationProvider();
+                WindowPlus::Controls::ServiceLocator::Instance->RegisterService<WindowPlus::Controls::IAnimationProvider^>(provider);
+                return provider;
+            }
+
+            /// <summary>
+            /// Gets the engine running the animations
+            /// </summary>
+            property AnimationEngine^ Engine {
+                AnimationEngine^ get() { return engine; }
+            }
+
+            /// <summary>
+            /// Gets or sets the batcher that repaints animated controls once
+            /// per window per frame, or null to leave repainting to the
+            /// controls' own property setters. The provider disposes the
+            /// batcher it created when that one is replaced or the provider
+            /// is disposed; a batcher set here stays owned by the caller.
+            /// </summary>
+            property InvalidationBatcher^ Invalidation {
+                InvalidationBatcher^ get() { return invalidation; }
+                void set(InvalidationBatcher^ value) {
+                    if (value == invalidation)
+                        return;
+                    if (ownsInvalidation)
+                        delete invalidation;
+                    invalidation = value;
+                    ownsInvalidation = false;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets whether new animations start; when off,
+            /// TryStartAnimation returns false
+            /// </summary>
+            property bool Enabled {
+                bool get() { return enabled; }
+                void set(bool value) { enabled = value; }
+            }
+
+            /// <summary>
+            /// Gets the number of object properties being animated
+            /// </summary>
+            property int ActiveCount {
+                int get() {
+                    int count = 0;
+                    for each (KeyValuePair<Object^, List<Binding^>^> pair in active)
+                        count += pair.Value->Count;
+                    return count;
+                }
+            }
+
+            /// <summary>
+            /// Registers or replaces a named animation
+            /// </summary>
+            void RegisterAnimation(String^ name, AnimationDefinition^ definition) {
+                if (String::IsNullOrEmpty(name))
+                    throw gcnew ArgumentNullException("name");
+                if (definition == nullptr)
+                    throw gcnew ArgumentNullException("definition");
+                definitions[name] = definition;
+            }
+
+            bool UnregisterAnimation(String^ name) {
+                if (name == nullptr)
+                    throw gcnew ArgumentNullException("name");
+                return definitions->Remove(name);
+            }
+
+            /// <summary>
+            /// Gets a registered animation, or null
+            /// </summary>
+            AnimationDefinition^ GetAnimation(String^ name) {
+                if (name == nullptr)
+                    throw gcnew ArgumentNullException("name");
+                AnimationDefinition^ definition;
+                return definitions->TryGetValue(name, definition) ? definition : nullptr;
+            }
+
+            virtual bool IsAnimationEnabled() {
+                return enabled;
+            }
+
+            /// <summary>
+            /// Starts an animation on target. properties may be null to play
+            /// the registered definition, an AnimationDefinition to play
+            /// instead under this name, or an IDictionary of property name to
+            /// double overriding the end values. A property that is already
+            /// animating continues smoothly from its current value. Returns
+            /// false when disabled, when the name is unknown, or when none of
+            /// the properties can be animated on the target.
+            /// </summary>
+            virtual bool TryStartAnimation(String^ animationName, Object^ target, Object^ properties) {
+                if (!enabled || animationName == nullptr || target == nullptr)
+                    return false;
+
+                AnimationDefinition^ definition = dynamic_cast<AnimationDefinition^>(properties);
+                if (definition == nullptr && !definitions->TryGetValue(animationName, definition))
+                    return false;
+                IDictionary<String^, double>^ overrides = dynamic_cast<IDictionary<String^, double>^>(properties);
+
+                array<AnimatedProperty^>^ plan = definition->Resolve(target->GetType());
+                bool started = false;
+                for (int i = 0; i < plan->Length; i++) {
+                    if (plan[i] == nullptr)
+                        continue;
+                    PropertyAnimation^ item = definition[i];
+                    double to = item->To, value;
+                    if (overrides != nullptr && overrides->TryGetValue(item->Property, value))
+                        to = value;
+
+                    Binding^ binding = Bind(target, plan[i]);
+                    double from = item->From.HasValue ? item->From.Value : engine->GetValue(binding->Slot);
+                    binding->Animation = item->Curve != nullptr
+                        ? engine->Start(binding->Slot, from, to, item->Duration, item->Delay, item->Curve)
+                        : engine->Start(binding->Slot, from, to, item->Duration, item->Delay, Easing::OutCubic);
+                    binding->Name = animationName;
+                    started = true;
+                }
+                return started;
+            }
+
+            /// <summary>
+            /// Stops the properties of target last started by the named
+            /// animation, leaving them at their current values
+            /// </summary>
+            virtual bool TryStopAnimation(String^ animationName, Object^ target) {
+                List<Binding^>^ bindings;
+                if (animationName == nullptr || target == nullptr || !active->TryGetValue(target, bindings))
+                    return false;
+
+                bool stopped = false;
+                for (int i = bindings->Count - 1; i >= 0; i--) {
+                    Binding^ binding = bindings[i];
+                    if (!String::Equals(binding->Name, animationName))
+                        continue;
+                    engine->Stop(binding->Animation);
+                    Release(binding);
+                    stopped = true;
+                }
+                return stopped;
+            }
+
+            /// <summary>
+            /// Stops every animation this provider started
+            /// </summary>
+            void StopAll() {
+                for (int slot = 0; slot < slots->Length; slot++) {
+                    Binding^ binding = slots[slot];
+                    if (binding != nullptr) {
+                        engine->Stop(binding->Animation);
+                        Release(binding);
+                    }
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "Native/Easing.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// Built-in easing curves
+        /// </summary>
+        public enum class Easing {
+            Linear = Native::EaseLinear,
+            InQuad = Native::EaseInQuad,
+            OutQuad = Native::EaseOutQuad,
+            InOutQuad = Native::EaseInOutQuad,
+            InCubic = Native::EaseInCubic,
+            OutCubic = Native::EaseOutCubic,
+            InOutCubic = Native::EaseInOutCubic,
+            InElastic = Native::EaseInElastic,
+            OutElastic = Native::EaseOutElastic,
+            InOutElastic = Native::EaseInOutElastic,
+            InBounce = Native::EaseInBounce,
+            OutBounce = Native::EaseOutBounce,
+            InOutBounce = Native::EaseInOutBounce,
+        };
+
+        /// <summary>
+        /// Which end of a mirrored curve family carries the effect
+        /// </summary>
+        public enum class EasingMode {
+            In,
+            Out,
+            InOut,
+        };
+
+        /// <summary>
+        /// Where the jumps of a steps curve fall, as in CSS steps()
+        /// </summary>
+        public enum class StepPosition {
+            JumpEnd = Native::StepJumpEnd,
+            JumpStart = Native::StepJumpStart,
+            JumpNone = Native::StepJumpNone,
+            JumpBoth = Native::StepJumpBoth,
+        };
+
+        /// <summary>
+        /// Immutable easing curve: a built-in, cubic-bezier, spring, elastic,
+        /// bounce or steps curve mapping progress in [0, 1] to eased progress.
+        /// Evaluating an array runs the whole batch through vectorized
+        /// kernels. Baked copies replace the curve by a lookup table, so each
+        /// value costs one lookup and a lerp, which pays off for cubic-bezier
+        /// curves evaluated thousands of times per frame.
+        ///
+        /// The CSS presets are shared instances; do not dispose them.
+        /// </summary>
+        public ref class EasingCurve {
+        private:
+            static EasingCurve^ ease;
+            static EasingCurve^ easeIn;
+            static EasingCurve^ easeOut;
+            static EasingCurve^ easeInOut;
+
+            Native::EasingCurve* curve;
+
+            EasingCurve(const Native::EasingCurve& source) {
+                curve = new Native::EasingCurve(source);
+            }
+
+            static int MirroredKind(int inKind, EasingMode mode) {
+                switch (mode) {
+                case EasingMode::In:
+                    return inKind;
+                case EasingMode::Out:
+                    return inKind + 1;
+                case EasingMode::InOut:
+                    return inKind + 2;
+                default:
+                    throw gcnew ArgumentOutOfRangeException("mode");
+                }
+            }
+
+            static void CheckFinite(double value, String^ name) {
+                if (Double::IsNaN(value) || Double::IsInfinity(value))
+                    throw gcnew ArgumentOutOfRangeException(name);
+            }
+
+        internal:
+            property const Native::EasingCurve& NativeCurve {
+                const Native::EasingCurve& get() {
+                    if (!curve)
+                        throw gcnew ObjectDisposedException("EasingCurve");
+                    return *curve;
+                }
+            }
+
+        public:
+            ~EasingCurve() {
+                this->!EasingCurve();
+            }
+
+            !EasingCurve() {
+                delete curve;
+                curve = nullptr;
+            }
+
+            /// <summary>
+            /// Creates a built-in curve
+            /// </summary>
+            static EasingCurve^ FromEasing(Easing easing) {
+                int kind = (int)easing;
+                if (kind < 0 || kind >= Native::BuiltinEasingCount)
+                    throw gcnew ArgumentOutOfRangeException("easing");
+                return gcnew EasingCurve(Native::EasingCurve::Builtin(kind));
+            }
+
+            /// <summary>
+            /// Creates a CSS-style cubic-bezier curve through (0, 0), (x1, y1),
+            /// (x2, y2), (1, 1). x1 and x2 must lie in [0, 1]; y1 and y2 may
+            /// overshoot.
+            /// </summary>
+            static EasingCurve^ CubicBezier(double x1, double y1, double x2, double y2) {
+                if (!(x1 >= 0 && x1 <= 1))
+                    throw gcnew ArgumentOutOfRangeException("x1");
+                if (!(x2 >= 0 && x2 <= 1))
+                    throw gcnew ArgumentOutOfRangeException("x2");
+                CheckFinite(y1, "y1");
+                CheckFinite(y2, "y2");
+                return gcnew EasingCurve(Native::EasingCurve::CubicBezier(x1, y1, x2, y2));
+            }
+
+            /// <summary>
+            /// Gets CSS ease, cubic-bezier(0.25, 0.1, 0.25, 1)
+            /// </summary>
+            static property EasingCurve^ Ease {
+                EasingCurve^ get() {
+                    if (ease == nullptr)
+                        ease = CubicBezier(0.25, 0.1, 0.25, 1);
+                    return ease;
+                }
+            }
+
+            /// <summary>
+            /// Gets CSS ease-in, cubic-bezier(0.42, 0, 1, 1)
+            /// </summary>
+            static property EasingCurve^ EaseIn {
+                EasingCurve^ get() {
+                    if (easeIn == nullptr)
+                        easeIn = CubicBezier(0.42, 0, 1, 1);
+                    return easeIn;
+                }
+            }
+
+            /// <summary>
+            /// Gets CSS ease-out, cubic-bezier(0, 0, 0.58, 1)
+            /// </summary>
+            static property EasingCurve^ EaseOut {
+                EasingCurve^ get() {
+                    if (easeOut == nullptr)
+                        easeOut = CubicBezier(0, 0, 0.58, 1);
+                    return easeOut;
+                }
+            }
+
+            /// <summary>
+            /// Gets CSS ease-in-out, cubic-bezier(0.42, 0, 0.58, 1)
+            /// </summary>
+            static property EasingCurve^ EaseInOut {
+                EasingCurve^ get() {
+                    if (easeInOut == nullptr)
+                        easeInOut = CubicBezier(0.42, 0, 0.58, 1);
+                    return easeInOut;
+                }
+            }
+
+            /// <summary>
+            /// Creates a damped spring released at rest at 0 and pulled to 1.
+            /// dampingRatio below 1 oscillates; frequency is the undamped
+            /// angular frequency in radians per unit of progress. The curve
+            /// snaps to 1 at the end, so pick a frequency that lets it settle.
+            /// </summary>
+            static EasingCurve^ Spring(double dampingRatio, double frequency) {
+                if (!(dampingRatio > 0) || Double::IsInfinity(dampingRatio))
+                    throw gcnew ArgumentOutOfRangeException("dampingRatio");
+                if (!(frequency > 0) || Double::IsInfinity(frequency))
+                    throw gcnew ArgumentOutOfRangeException("frequency");
+                return gcnew EasingCurve(Native::EasingCurve::Spring(dampingRatio, frequency));
+            }
+
+            /// <summary>
+            /// Creates an elastic curve with the given amplitude (at least 1)
+            /// and period in units of progress
+            /// </summary>
+            static EasingCurve^ Elastic(EasingMode mode, double amplitude, double period) {
+                CheckFinite(amplitude, "amplitude");
+                if (!(period > 0) || Double::IsInfinity(period))
+                    throw gcnew ArgumentOutOfRangeException("period");
+                return gcnew EasingCurve(
+                    Native::EasingCurve::Elastic(MirroredKind(Native::EaseInElastic, mode), amplitude, period));
+            }
+
+            /// <summary>
+            /// Creates a bouncing curve
+            /// </summary>
+            static EasingCurve^ Bounce(EasingMode mode) {
+                return gcnew EasingCurve(Native::EasingCurve::Builtin(MirroredKind(Native::EaseInBounce, mode)));
+            }
+
+            /// <summary>
+            /// Creates a staircase of count equal steps, as CSS steps()
+            /// </summary>
+            static EasingCurve^ Steps(int count, StepPosition position) {
+                if (position < StepPosition::JumpEnd || position > StepPosition::JumpBoth)
+                    throw gcnew ArgumentOutOfRangeException("position");
+                if (count < (position == StepPosition::JumpNone ? 2 : 1))
+                    throw gcnew ArgumentOutOfRangeException("count");
+                return gcnew EasingCurve(Native::EasingCurve::Steps(count, (int)position));
+            }
+
+            /// <summary>
+            /// Gets whether values come from a lookup table
+            /// </summary>
+            property bool IsBaked {
+                bool get() { return !NativeCurve.Table.empty(); }
+            }
+
+            /// <summary>
+            /// Returns a copy sampled into a lookup table of tableSize entries
+            /// (at least 2). The error is about max |y''| / (8 (tableSize - 1)^2);
+            /// 1025 entries keep the CSS curves within 2e-6. Steps curves are
+            /// returned unbaked.
+            /// </summary>
+            EasingCurve^ Bake(int tableSize) {
+                if (tableSize < 2)
+                    throw gcnew ArgumentOutOfRangeException("tableSize");
+                EasingCurve^ baked = gcnew EasingCurve(NativeCurve);
+                baked->curve->Bake(tableSize);
+                return baked;
+            }
+
+            /// <summary>
+            /// Eases one progress value; values outside [0, 1] are clamped
+            /// </summary>
+            double Evaluate(double progress) {
+                return NativeCurve.Evaluate(progress);
+            }
+
+            /// <summary>
+            /// Eases a batch of progress values into result, which may be the
+            /// same array
+            /// </summary>
+            void Evaluate(array<double>^ progress, array<double>^ result) {
+                if (progress == nullptr)
+                    throw gcnew ArgumentNullException("progress");
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                if (result->Length < progress->Length)
+                    throw gcnew ArgumentException("Result array is too short", "result");
+                if (progress->Length == 0)
+                    return;
+
+                pin_ptr<double> pt = &progress[0];
+                pin_ptr<double> py = &result[0];
+                Native::EaseBatch(NativeCurve, pt, py, progress->Length);
+            }
+        };
+    }
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "Native/DirtyRegion.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Drawing;
+using namespace System::Windows::Forms;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// Collects the areas dirtied by animated property writes during a
+        /// frame and repaints each window once per frame. Rectangles are
+        /// merged per window by a native dirty-region core: overlapping or
+        /// adjacent areas collapse into one, and each window keeps a few
+        /// rectangles at most. Flush then invalidates that region on each
+        /// window in a single call. Counters show how much merging saved.
+        /// </summary>
+        public ref class InvalidationBatcher {
+        private:
+            Native::InvalidationBatch* batch;
+            Dictionary<Control^, int>^ windowIds;
+            List<Control^>^ windows;
+            Stack<int>^ freeIds;
+            EventHandler^ disposedHandler;
+            int maxRectangles;
+            double mergeSlack;
+
+            Native::InvalidationBatch& Batch() {
+                if (!batch)
+                    throw gcnew ObjectDisposedException("InvalidationBatcher");
+                return *batch;
+            }
+
+            int WindowId(Control^ window) {
+                int id;
+                if (windowIds->TryGetValue(window, id))
+                    return id;
+                if (freeIds->Count > 0) {
+                    id = freeIds->Pop();
+                    windows[id] = window;
+                }
+                else {
+                    id = windows->Count;
+                    windows->Add(window);
+                }
+                windowIds->Add(window, id);
+                window->Disposed += disposedHandler;
+                return id;
+            }
+
+            void OnWindowDisposed(Object^ sender, EventArgs^ e) {
+                Control^ window = safe_cast<Control^>(sender);
+                int id;
+                if (!windowIds->TryGetValue(window, id))
+                    return;
+                window->Disposed -= disposedHandler;
+                windowIds->Remove(window);
+                windows[id] = nullptr;
+                freeIds->Push(id);
+                if (batch)
+                    batch->Release(id);
+            }
+
+        public:
+            InvalidationBatcher() {
+                maxRectangles = 8;
+                mergeSlack = 0.125;
+                batch = new Native::InvalidationBatch(maxRectangles, mergeSlack);
+                windowIds = gcnew Dictionary<Control^, int>();
+                windows = gcnew List<Control^>();
+                freeIds = gcnew Stack<int>();
+                disposedHandler = gcnew EventHandler(this, &InvalidationBatcher::OnWindowDisposed);
+            }
+
+            ~InvalidationBatcher() {
+                for each (Control^ window in windowIds->Keys)
+                    window->Disposed -= disposedHandler;
+                windowIds->Clear();
+                windows->Clear();
+                freeIds->Clear();
+                this->!InvalidationBatcher();
+            }
+
+            !InvalidationBatcher() {
+                delete batch;
+                batch = nullptr;
+            }
+
+            /// <summary>
+            /// Gets or sets how many rectangles a window keeps per frame
+            /// before the closest pair is merged
+            /// </summary>
+            property int MaxRectangles {
+                int get() { return maxRectangles; }
+                void set(int value) {
+                    if (value < 1)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    maxRectangles = value;
+                    Batch().Configure(maxRectangles, mergeSlack);
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the fraction of a merged rectangle allowed to be
+            /// area neither part covered. Higher values mean fewer, larger
+            /// rectangles.
+            /// </summary>
+            property double MergeSlack {
+                double get() { return mergeSlack; }
+                void set(double value) {
+                    if (!(value >= 0 && value <= 1))
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    mergeSlack = value;
+                    Batch().Configure(maxRectangles, mergeSlack);
+                }
+            }
+
+            /// <summary>
+            /// Gets whether any window has area waiting for Flush
+            /// </summary>
+            property bool IsPending {
+                bool get() { return Batch().Pending(); }
+            }
+
+            /// <summary>
+            /// Marks an area of a window, in its client coordinates, for the
+            /// next Flush
+            /// </summary>
+            void Invalidate(Control^ window, Rectangle area) {
+                if (window == nullptr)
+                    throw gcnew ArgumentNullException("window");
+                Native::InvalidationBatch& b = Batch();
+                int id = WindowId(window);
+                Size client = window->ClientSize;
+                b.SetBounds(id, client.Width, client.Height);
+                Native::DirtyRect r = { area.Left, area.Top, area.Right, area.Bottom };
+                b.Add(id, r);
+            }
+
+            /// <summary>
+            /// Marks the area a control covers in its parent, or its whole
+            /// client area when it has no parent. Call it before and after
+            /// changing a control's bounds so that both its old and new areas
+            /// are repainted.
+            /// </summary>
+            void Invalidate(Control^ control) {
+                if (control == nullptr)
+                    throw gcnew ArgumentNullException("control");
+                Control^ parent = control->Parent;
+                if (parent != nullptr)
+                    Invalidate(parent, control->Bounds);
+                else
+                    Invalidate(control, control->ClientRectangle);
+            }
+
+            /// <summary>
+            /// Ends the frame by invalidating each dirty window once, with the
+            /// children under its region. Returns the number of windows
+            /// invalidated.
+            /// </summary>
+            int Flush() {
+                Native::InvalidationBatch& b = Batch();
+                if (!b.Pending())
+                    return 0;
+                b.Flush();
+
+                int invalidated = 0;
+                for (int i = 0; i < b.FlushedCount(); i++) {
+                    Control^ window = windows[b.FlushedWindow(i)];
+                    if (window == nullptr || window->IsDisposed || !window->IsHandleCreated) {
+                        b.Skip(i);
+                        continue;
+                    }
+
+                    int first = b.FlushedFirst(i), end = b.FlushedEnd(i);
+                    if (end - first == 1) {
+                        const Native::DirtyRect& r = b.FlushedRect(first);
+                        window->Invalidate(Rectangle::FromLTRB(r.Left, r.Top, r.Right, r.Bottom), true);
+                    }
+                    else {
+                        Region^ region = gcnew Region(Rectangle::Empty);
+                        try {
+                            for (int k = first; k < end; k++) {
+                                const Native::DirtyRect& r = b.FlushedRect(k);
+                                region->Union(Rectangle::FromLTRB(r.Left, r.Top, r.Right, r.Bottom));
+                            }
+                            window->Invalidate(region, true);
+                        }
+                        finally {
+                            delete region;
+                        }
+                    }
+                    invalidated++;
+                }
+                return invalidated;
+            }
+
+            /// <summary>
+            /// Gets the number of flushes that invalidated anything
+            /// </summary>
+            property long long Frames {
+                long long get() { return Batch().Stats().Frames; }
+            }
+
+            /// <summary>
+            /// Gets the number of areas marked
+            /// </summary>
+            property long long Writes {
+                long long get() { return Batch().Stats().Writes; }
+            }
+
+            /// <summary>
+            /// Gets the number of rectangles merging removed
+            /// </summary>
+            property long long MergedRectangles {
+                long long get() { return Batch().Stats().Merged; }
+            }
+
+            /// <summary>
+            /// Gets the number of rectangles invalidated
+            /// </summary>
+            property long long Rectangles {
+                long long get() { return Batch().Stats().Rects; }
+            }
+
+            /// <summary>
+            /// Gets the number of window invalidations, at most one per window
+            /// per frame
+            /// </summary>
+            property long long Invalidations {
+                long long get() { return Batch().Stats().Invalidations; }
+            }
+
+            /// <summary>
+            /// Gets the total area invalidated in pixels
+            /// </summary>
+            property long long PixelsInvalidated {
+                long long get() { return Batch().Stats().Pixels; }
+            }
+
+            void ResetStatistics() {
+                Batch().ResetStats();
+            }
+        };
+    }
+}
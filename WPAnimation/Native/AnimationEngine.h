@@ -0,0 +1,487 @@
+#pragma once
+
+#include "Easing.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Animation {
+        namespace Native {
+            /// <summary>
+            /// Identifies one animation: generation in the high 32 bits, slot in
+            /// the low 32. Zero is never issued, and ids of stopped or finished
+            /// animations stay invalid when their slot is reused.
+            /// </summary>
+            typedef long long AnimationId;
+
+            /// <summary>
+            /// An animation that ran to its end and the target it drove
+            /// </summary>
+            struct Completion {
+                AnimationId Id;
+                int Target;
+            };
+
+            /// <summary>
+            /// Central scheduler for scalar animations. Active animations live
+            /// in structure-of-arrays form (start, inverse duration, from, to,
+            /// easing, target), densely packed, and Tick advances all of them
+            /// in one pass per frame: progress, easing and the write to the
+            /// target value are separate loops over contiguous arrays, with
+            /// each easing curve evaluated once per frame as a batch. Start,
+            /// Stop and Retarget are O(1) and allocate nothing once the arrays
+            /// have grown to the working set.
+            ///
+            /// Targets are value slots owned by the engine; each holds the
+            /// current value of one animated property and is driven by at most
+            /// one animation, so starting a new animation on a target replaces
+            /// the old one. Time is passed in by the caller in seconds, which
+            /// keeps the engine headless and deterministic.
+            /// </summary>
+            class AnimationEngine {
+            private:
+                struct Handle {
+                    int Dense;          // index into the active arrays, -1 while free
+                    int NextFree;
+                    unsigned Generation;
+                };
+
+                // Active animations, dense
+                std::vector<double> start;
+                std::vector<double> inverseDuration;
+                std::vector<double> from;
+                std::vector<double> to;
+                std::vector<int> easing;
+                std::vector<int> target;
+                std::vector<int> owner;         // handle slot of each active animation
+                std::vector<double> progress;   // per-tick scratch from here
+                std::vector<double> eased;
+                std::vector<double> gathered;
+                std::vector<int> order;
+                std::vector<int> buckets;
+
+                std::vector<EasingCurve> curves;
+
+                std::vector<Handle> handles;
+                int freeHandle;
+
+                // Targets
+                std::vector<double> values;
+                std::vector<int> driver;        // dense index animating each target, -1 when idle
+                std::vector<int> freeTargets;
+                std::vector<bool> liveTargets;
+
+                std::vector<Completion> finished;
+                std::vector<int> written;
+                std::vector<unsigned> writtenStamp;     // tick that last listed each target in written
+                unsigned stamp;
+
+                AnimationEngine(const AnimationEngine&);
+                AnimationEngine& operator=(const AnimationEngine&);
+
+                static AnimationId MakeId(int slot, unsigned generation) {
+                    return ((AnimationId)generation << 32) | (unsigned)slot;
+                }
+
+                /// <summary>
+                /// Dense index of a live animation, -1 for stale or unknown ids
+                /// </summary>
+                int Find(AnimationId id) const {
+                    long long slot = id & 0xFFFFFFFFLL;
+                    unsigned generation = (unsigned)((unsigned long long)id >> 32);
+                    if (id <= 0 || slot >= (long long)handles.size())
+                        return -1;
+                    const Handle& h = handles[(std::size_t)slot];
+                    return h.Generation == generation ? h.Dense : -1;
+                }
+
+                /// <summary>
+                /// Clamps progress to [0, 1]; NaN maps to 0
+                /// </summary>
+                static double Clamp01(double t) {
+                    return t > 0 ? (t < 1 ? t : 1) : 0;
+                }
+
+                void SetTiming(int i, double startTime, double duration) {
+                    if (duration > 0) {
+                        start[i] = startTime;
+                        inverseDuration[i] = 1 / duration;
+                    }
+                    else {
+                        // A zero duration ramps over the gap between startTime and
+                        // the double just below it, which holds no other time:
+                        // progress is 0 for every earlier tick and 1 from
+                        // startTime on. Near zero the gap is subnormal and its
+                        // inverse infinite; the 0 * inf of a tick exactly at
+                        // start is NaN, which Clamp01 takes as 0.
+                        start[i] = std::nextafter(startTime, -HUGE_VAL);
+                        inverseDuration[i] = 1 / (startTime - start[i]);
+                    }
+                }
+
+                double ValueAt(int i, double now) const {
+                    double t = Clamp01((now - start[i]) * inverseDuration[i]);
+                    return from[i] + (to[i] - from[i]) * curves[easing[i]].Evaluate(t);
+                }
+
+                /// <summary>
+                /// eased[i] = curve of animation i at progress[i]. Animations
+                /// are bucketed by curve (a counting sort over curve ids) so
+                /// each curve runs once as a batch over contiguous progress
+                /// values.
+                /// </summary>
+                void EaseAll(int n) {
+                    const int* e = &easing[0];
+                    eased.resize(n);
+                    bool uniform = true;
+                    for (int i = 1; i < n; ++i)
+                        uniform &= e[i] == e[0];
+                    if (uniform) {
+                        EaseBatch(curves[e[0]], &progress[0], &eased[0], n);
+                        return;
+                    }
+
+                    int curveCount = (int)curves.size();
+                    buckets.assign(curveCount + 1, 0);
+                    for (int i = 0; i < n; ++i)
+                        ++buckets[e[i] + 1];
+                    for (int c = 0; c < curveCount; ++c)
+                        buckets[c + 1] += buckets[c];
+                    order.resize(n);
+                    gathered.resize(n);
+                    for (int i = 0; i < n; ++i) {
+                        int k = buckets[e[i]]++;
+                        order[k] = i;
+                        gathered[k] = progress[i];
+                    }
+                    // Each bucket's cursor now sits at the next bucket's start
+                    int begin = 0;
+                    for (int c = 0; c < curveCount; ++c) {
+                        int end = buckets[c];
+                        if (end > begin)
+                            EaseBatch(curves[c], &gathered[begin], &gathered[begin], end - begin);
+                        begin = end;
+                    }
+                    for (int k = 0; k < n; ++k)
+                        eased[order[k]] = gathered[k];
+                }
+
+                /// <summary>
+                /// Removes dense entry i by moving the last entry into its place
+                /// </summary>
+                void RemoveAt(int i) {
+                    int slot = owner[i];
+                    Handle& h = handles[slot];
+                    h.Dense = -1;
+                    h.NextFree = freeHandle;
+                    ++h.Generation;
+                    if (h.Generation == 0)
+                        h.Generation = 1;
+                    freeHandle = slot;
+                    driver[target[i]] = -1;
+
+                    int last = (int)start.size() - 1;
+                    if (i != last) {
+                        start[i] = start[last];
+                        inverseDuration[i] = inverseDuration[last];
+                        from[i] = from[last];
+                        to[i] = to[last];
+                        easing[i] = easing[last];
+                        target[i] = target[last];
+                        owner[i] = owner[last];
+                        handles[owner[i]].Dense = i;
+                        driver[target[i]] = i;
+                    }
+                    start.pop_back();
+                    inverseDuration.pop_back();
+                    from.pop_back();
+                    to.pop_back();
+                    easing.pop_back();
+                    target.pop_back();
+                    owner.pop_back();
+                }
+
+            public:
+                /// <summary>
+                /// Creates an engine with room for capacity animations and
+                /// targets before any array grows
+                /// </summary>
+                explicit AnimationEngine(int capacity = 64) : freeHandle(-1), stamp(1) {
+                    Reserve(capacity);
+                    for (int k = 0; k < BuiltinEasingCount; ++k)
+                        curves.push_back(EasingCurve::Builtin(k));
+                }
+
+                void Reserve(int capacity) {
+                    std::size_t c = capacity > 0 ? (std::size_t)capacity : 0;
+                    start.reserve(c);
+                    inverseDuration.reserve(c);
+                    from.reserve(c);
+                    to.reserve(c);
+                    easing.reserve(c);
+                    target.reserve(c);
+                    owner.reserve(c);
+                    progress.reserve(c);
+                    eased.reserve(c);
+                    gathered.reserve(c);
+                    order.reserve(c);
+                    handles.reserve(c);
+                    values.reserve(c);
+                    driver.reserve(c);
+                    liveTargets.reserve(c);
+                    writtenStamp.reserve(c);
+                    finished.reserve(c);
+                    written.reserve(c);
+                }
+
+                /// <summary>
+                /// Number of running animations
+                /// </summary>
+                int Count() const {
+                    return (int)start.size();
+                }
+
+                /// <summary>
+                /// Adds an easing curve and returns its id; ids below
+                /// BuiltinEasingCount are the built-in EasingKinds
+                /// </summary>
+                int RegisterCurve(const EasingCurve& curve) {
+                    curves.push_back(curve);
+                    return (int)curves.size() - 1;
+                }
+
+                int CurveCount() const {
+                    return (int)curves.size();
+                }
+
+                /// <summary>
+                /// Number of target slots ever created; valid targets are below it
+                /// </summary>
+                int TargetCapacity() const {
+                    return (int)values.size();
+                }
+
+                /// <summary>
+                /// Creates a target slot holding initial; slots of released
+                /// targets are reused
+                /// </summary>
+                int CreateTarget(double initial) {
+                    int t;
+                    if (!freeTargets.empty()) {
+                        t = freeTargets.back();
+                        freeTargets.pop_back();
+                        liveTargets[t] = true;
+                    }
+                    else {
+                        t = (int)values.size();
+                        values.push_back(0);
+                        driver.push_back(-1);
+                        liveTargets.push_back(true);
+                        writtenStamp.push_back(0);
+                    }
+                    values[t] = initial;
+                    return t;
+                }
+
+                bool IsTarget(int t) const {
+                    return t >= 0 && t < (int)values.size() && liveTargets[t];
+                }
+
+                /// <summary>
+                /// Stops the animation driving a target and frees its slot
+                /// </summary>
+                void ReleaseTarget(int t) {
+                    if (driver[t] >= 0)
+                        RemoveAt(driver[t]);
+                    liveTargets[t] = false;
+                    freeTargets.push_back(t);
+                }
+
+                double Value(int t) const {
+                    return values[t];
+                }
+
+                /// <summary>
+                /// Sets a target's value directly; a running animation on it
+                /// overwrites it on the next tick
+                /// </summary>
+                void SetValue(int t, double value) {
+                    values[t] = value;
+                }
+
+                /// <summary>
+                /// Sets a target's value on behalf of playback other than the
+                /// engine's animations, such as a storyboard, and lists the
+                /// target in Written() once until the next Tick
+                /// </summary>
+                void Write(int t, double value) {
+                    values[t] = value;
+                    if (writtenStamp[t] != stamp) {
+                        writtenStamp[t] = stamp;
+                        written.push_back(t);
+                    }
+                }
+
+                /// <summary>
+                /// Id of the animation driving a target, 0 when idle
+                /// </summary>
+                AnimationId Driver(int t) const {
+                    int i = driver[t];
+                    return i < 0 ? 0 : MakeId(owner[i], handles[owner[i]].Generation);
+                }
+
+                /// <summary>
+                /// Animates target t from one value to another over duration
+                /// seconds beginning at startTime (which may lie in the future to
+                /// delay it), replacing any animation already on t
+                /// </summary>
+                AnimationId Start(int t, double fromValue, double toValue, double startTime, double duration, int easingId) {
+                    int i = driver[t];
+                    if (i < 0) {
+                        int slot;
+                        if (freeHandle >= 0) {
+                            slot = freeHandle;
+                            freeHandle = handles[slot].NextFree;
+                        }
+                        else {
+                            slot = (int)handles.size();
+                            Handle h = { -1, -1, 1 };
+                            handles.push_back(h);
+                        }
+                        i = (int)start.size();
+                        handles[slot].Dense = i;
+                        start.push_back(0);
+                        inverseDuration.push_back(0);
+                        from.push_back(0);
+                        to.push_back(0);
+                        easing.push_back(0);
+                        target.push_back(t);
+                        owner.push_back(slot);
+                        driver[t] = i;
+                    }
+                    else {
+                        // Replacing: the old id goes stale, the slot is reused in place
+                        Handle& h = handles[owner[i]];
+                        ++h.Generation;
+                        if (h.Generation == 0)
+                            h.Generation = 1;
+                    }
+                    SetTiming(i, startTime, duration);
+                    from[i] = fromValue;
+                    to[i] = toValue;
+                    easing[i] = easingId >= 0 && easingId < (int)curves.size() ? easingId : EaseLinear;
+                    return MakeId(owner[i], handles[owner[i]].Generation);
+                }
+
+                bool IsActive(AnimationId id) const {
+                    return Find(id) >= 0;
+                }
+
+                /// <summary>
+                /// Target of a running animation, -1 when it is not running
+                /// </summary>
+                int TargetOf(AnimationId id) const {
+                    int i = Find(id);
+                    return i < 0 ? -1 : target[i];
+                }
+
+                /// <summary>
+                /// Stops an animation, leaving its target at the last value
+                /// written. Returns false for ids that are not running.
+                /// </summary>
+                bool Stop(AnimationId id) {
+                    int i = Find(id);
+                    if (i < 0)
+                        return false;
+                    RemoveAt(i);
+                    return true;
+                }
+
+                /// <summary>
+                /// Redirects a running animation to a new end value: it restarts
+                /// at now from its current eased value, so motion stays
+                /// continuous. Returns false for ids that are not running.
+                /// </summary>
+                bool Retarget(AnimationId id, double now, double toValue, double duration) {
+                    int i = Find(id);
+                    if (i < 0)
+                        return false;
+                    from[i] = ValueAt(i, now);
+                    to[i] = toValue;
+                    SetTiming(i, now, duration);
+                    return true;
+                }
+
+                /// <summary>
+                /// Advances every animation to now and writes the values to
+                /// their targets. Finished animations write their end value and
+                /// are removed; their ids are listed by Finished().
+                /// </summary>
+                void Tick(double now) {
+                    finished.clear();
+                    written.clear();
+                    if (++stamp == 0) {
+                        writtenStamp.assign(writtenStamp.size(), 0u);
+                        stamp = 1;
+                    }
+                    int n = (int)start.size();
+                    if (n == 0)
+                        return;
+
+                    progress.resize(n);
+                    double* p = &progress[0];
+                    const double* s = &start[0];
+                    const double* inv = &inverseDuration[0];
+                    for (int i = 0; i < n; ++i)
+                        p[i] = Clamp01((now - s[i]) * inv[i]);
+
+                    EaseAll(n);
+                    const double* y = &eased[0];
+                    const int* tg = &target[0];
+                    const double* f = &from[0];
+                    const double* d = &to[0];
+                    double* v = &values[0];
+                    written.assign(tg, tg + n);
+                    unsigned* w = &writtenStamp[0];
+                    for (int i = 0; i < n; ++i) {
+                        v[tg[i]] = f[i] + (d[i] - f[i]) * y[i];
+                        w[tg[i]] = stamp;
+                    }
+
+                    // Backwards, so entries moved into place were already visited
+                    for (int i = n - 1; i >= 0; --i) {
+                        if (progress[i] >= 1) {
+                            Completion c = { MakeId(owner[i], handles[owner[i]].Generation), target[i] };
+                            finished.push_back(c);
+                            RemoveAt(i);
+                        }
+                    }
+                }
+
+                /// <summary>
+                /// Animations that finished during the last Tick
+                /// </summary>
+                const std::vector<Completion>& Finished() const {
+                    return finished;
+                }
+
+                /// <summary>
+                /// Targets written during the last Tick, and by Write since,
+                /// each once
+                /// </summary>
+                const std::vector<int>& Written() const {
+                    return written;
+                }
+            };
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
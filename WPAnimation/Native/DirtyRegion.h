@@ -0,0 +1,414 @@
+#pragma once
+
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Animation {
+        namespace Native {
+            /// <summary>
+            /// Integer rectangle, right and bottom exclusive
+            /// </summary>
+            struct DirtyRect {
+                int Left;
+                int Top;
+                int Right;
+                int Bottom;
+            };
+
+            namespace Detail {
+                inline bool IsEmpty(const DirtyRect& r) {
+                    return r.Right <= r.Left || r.Bottom <= r.Top;
+                }
+
+                inline long long Area(const DirtyRect& r) {
+                    return IsEmpty(r) ? 0 : (long long)(r.Right - r.Left) * (r.Bottom - r.Top);
+                }
+
+                inline DirtyRect Union(const DirtyRect& a, const DirtyRect& b) {
+                    DirtyRect u;
+                    u.Left = a.Left < b.Left ? a.Left : b.Left;
+                    u.Top = a.Top < b.Top ? a.Top : b.Top;
+                    u.Right = a.Right > b.Right ? a.Right : b.Right;
+                    u.Bottom = a.Bottom > b.Bottom ? a.Bottom : b.Bottom;
+                    return u;
+                }
+
+                inline DirtyRect Intersect(const DirtyRect& a, const DirtyRect& b) {
+                    DirtyRect i;
+                    i.Left = a.Left > b.Left ? a.Left : b.Left;
+                    i.Top = a.Top > b.Top ? a.Top : b.Top;
+                    i.Right = a.Right < b.Right ? a.Right : b.Right;
+                    i.Bottom = a.Bottom < b.Bottom ? a.Bottom : b.Bottom;
+                    return i;
+                }
+
+                /// <summary>
+                /// Pixels the union of a and b covers that neither does
+                /// </summary>
+                inline long long Waste(const DirtyRect& a, const DirtyRect& b) {
+                    return Area(Union(a, b)) - Area(a) - Area(b) + Area(Intersect(a, b));
+                }
+            }
+
+            /// <summary>
+            /// Dirty area of one window as a short list of rectangles. Adding a
+            /// rectangle merges it with any it touches or nearly touches while
+            /// the union wastes at most a fraction slack of its area, repeating
+            /// as the union grows. Above maxRects the pair whose union wastes
+            /// least is merged. The list stays short, and overlapping writes
+            /// such as a control's old and new bounds collapse into one
+            /// rectangle instead of being painted twice.
+            /// </summary>
+            class DirtyRegion {
+            private:
+                std::vector<DirtyRect> rects;
+                std::vector<long long> waste;   // pairwise Waste of rects, row length stride
+                std::size_t stride;
+                int maxRects;
+                double slack;
+
+                long long& PairWaste(std::size_t i, std::size_t j) {
+                    return waste[i * stride + j];
+                }
+
+                bool Mergeable(const DirtyRect& a, const DirtyRect& b) const {
+                    DirtyRect u = Detail::Union(a, b);
+                    return Detail::Waste(a, b) <= (long long)(slack * Detail::Area(u));
+                }
+
+                /// <summary>
+                /// Sizes the pair-waste cache for maxRects + 1 rectangles, or
+                /// for the current ones when there are more, and fills it
+                /// </summary>
+                void Reserve() {
+                    stride = (std::size_t)maxRects + 1;
+                    if (stride < rects.size())
+                        stride = rects.size();
+                    waste.assign(stride * stride, 0);
+                    for (std::size_t i = 0; i < rects.size(); ++i)
+                        Refresh(i);
+                }
+
+                /// <summary>
+                /// Recomputes the pair wastes of rectangle i
+                /// </summary>
+                void Refresh(std::size_t i) {
+                    for (std::size_t k = 0; k < rects.size(); ++k) {
+                        long long w = k == i ? 0 : Detail::Waste(rects[i], rects[k]);
+                        PairWaste(i, k) = w;
+                        PairWaste(k, i) = w;
+                    }
+                }
+
+                /// <summary>
+                /// Removes rectangle i by moving the last one into its place
+                /// </summary>
+                void Remove(std::size_t i) {
+                    std::size_t last = rects.size() - 1;
+                    if (i != last) {
+                        rects[i] = rects[last];
+                        for (std::size_t k = 0; k < last; ++k) {
+                            PairWaste(i, k) = PairWaste(last, k);
+                            PairWaste(k, i) = PairWaste(k, last);
+                        }
+                        PairWaste(i, i) = 0;
+                    }
+                    rects.pop_back();
+                }
+
+                /// <summary>
+                /// While over maxRects, merges the pair whose union wastes
+                /// least, found from the cached pair wastes. Returns the
+                /// number of merges.
+                /// </summary>
+                int MergeToLimit() {
+                    int merged = 0;
+                    while ((int)rects.size() > maxRects) {
+                        std::size_t bi = 0, bj = 1;
+                        long long best = PairWaste(0, 1);
+                        for (std::size_t i = 0; i < rects.size(); ++i) {
+                            for (std::size_t j = i + 1; j < rects.size(); ++j) {
+                                if (PairWaste(i, j) < best) {
+                                    best = PairWaste(i, j);
+                                    bi = i;
+                                    bj = j;
+                                }
+                            }
+                        }
+                        DirtyRect u = Detail::Union(rects[bi], rects[bj]);
+                        Remove(bj);
+                        rects[bi] = u;
+                        Refresh(bi);
+                        ++merged;
+                    }
+                    return merged;
+                }
+
+            public:
+                explicit DirtyRegion(int maxRects = 8, double slack = 0.125) : maxRects(maxRects < 1 ? 1 : maxRects), slack(slack) {
+                    Reserve();
+                }
+
+                /// <summary>
+                /// Changes the limits. A lower maxRects merges the current
+                /// rectangles down to it the same way Add does, cheapest pair
+                /// first.
+                /// </summary>
+                void Configure(int maxRects, double slack) {
+                    this->maxRects = maxRects < 1 ? 1 : maxRects;
+                    this->slack = slack;
+                    Reserve();
+                    // Shrink the cache back to the new limit
+                    if (MergeToLimit() > 0)
+                        Reserve();
+                }
+
+                /// <summary>
+                /// Adds a rectangle and returns how many rectangles merging
+                /// removed (counting the new one when it was absorbed)
+                /// </summary>
+                int Add(DirtyRect r) {
+                    if (Detail::IsEmpty(r))
+                        return 0;
+                    int merged = 0;
+                    bool again = true;
+                    while (again) {
+                        again = false;
+                        for (std::size_t i = 0; i < rects.size(); ++i) {
+                            if (Mergeable(rects[i], r)) {
+                                r = Detail::Union(rects[i], r);
+                                Remove(i);
+                                ++merged;
+                                again = true;
+                                break;
+                            }
+                        }
+                    }
+                    rects.push_back(r);
+                    Refresh(rects.size() - 1);
+
+                    return merged + MergeToLimit();
+                }
+
+                void Clear() {
+                    rects.clear();
+                }
+
+                bool Empty() const {
+                    return rects.empty();
+                }
+
+                int Count() const {
+                    return (int)rects.size();
+                }
+
+                const std::vector<DirtyRect>& Rects() const {
+                    return rects;
+                }
+
+                /// <summary>
+                /// Sum of the rectangle areas
+                /// </summary>
+                long long Area() const {
+                    long long area = 0;
+                    for (std::size_t i = 0; i < rects.size(); ++i)
+                        area += Detail::Area(rects[i]);
+                    return area;
+                }
+            };
+
+            /// <summary>
+            /// Running totals of an InvalidationBatch
+            /// </summary>
+            struct InvalidationStats {
+                long long Frames;           // flushes that invalidated anything
+                long long Writes;           // rectangles added
+                long long Merged;           // rectangles removed by merging
+                long long Rects;            // rectangles invalidated
+                long long Invalidations;    // window invalidations, at most one per window per frame
+                long long Pixels;           // area invalidated
+            };
+
+            /// <summary>
+            /// Collects the rectangles dirtied during one frame across many
+            /// windows and hands back, per window, a merged region to
+            /// invalidate once. Windows are small integer ids chosen by the
+            /// caller; each may carry client bounds that its rectangles are
+            /// clipped to.
+            /// </summary>
+            class InvalidationBatch {
+            private:
+                std::vector<DirtyRegion> regions;
+                std::vector<DirtyRect> bounds;          // empty: unbounded
+                std::vector<int> dirty;                 // windows with rectangles this frame
+                std::vector<int> flushedWindows;
+                std::vector<int> flushedFirst;          // rectangles of flushed window i: [first[i], first[i + 1])
+                std::vector<DirtyRect> flushedRects;
+                std::vector<char> flushedSkipped;
+                int flushedCounted;                     // flushed windows not skipped
+                InvalidationStats stats;
+                int maxRects;
+                double slack;
+
+                InvalidationBatch(const InvalidationBatch&);
+                InvalidationBatch& operator=(const InvalidationBatch&);
+
+                void Ensure(int window) {
+                    if (window >= (int)regions.size()) {
+                        regions.resize(window + 1, DirtyRegion(maxRects, slack));
+                        DirtyRect none = { 0, 0, 0, 0 };
+                        bounds.resize(window + 1, none);
+                    }
+                }
+
+            public:
+                explicit InvalidationBatch(int maxRects = 8, double slack = 0.125) : flushedCounted(0), maxRects(maxRects), slack(slack) {
+                    ResetStats();
+                    flushedFirst.push_back(0);
+                }
+
+                /// <summary>
+                /// Sets the merge limits for every window
+                /// </summary>
+                void Configure(int maxRects, double slack) {
+                    this->maxRects = maxRects;
+                    this->slack = slack;
+                    for (std::size_t i = 0; i < regions.size(); ++i)
+                        regions[i].Configure(maxRects, slack);
+                }
+
+                /// <summary>
+                /// Clips later rectangles of a window to [0, width) x [0, height);
+                /// zero size removes the clip
+                /// </summary>
+                void SetBounds(int window, int width, int height) {
+                    Ensure(window);
+                    DirtyRect b = { 0, 0, width, height };
+                    bounds[window] = b;
+                }
+
+                /// <summary>
+                /// Records a dirty rectangle of a window
+                /// </summary>
+                void Add(int window, DirtyRect r) {
+                    Ensure(window);
+                    ++stats.Writes;
+                    if (!Detail::IsEmpty(bounds[window]))
+                        r = Detail::Intersect(r, bounds[window]);
+                    if (Detail::IsEmpty(r))
+                        return;
+                    DirtyRegion& region = regions[window];
+                    if (region.Empty())
+                        dirty.push_back(window);
+                    stats.Merged += region.Add(r);
+                }
+
+                /// <summary>
+                /// Drops a window's pending rectangles and clip, for reuse of
+                /// its id
+                /// </summary>
+                void Release(int window) {
+                    if (window >= (int)regions.size())
+                        return;
+                    regions[window].Clear();
+                    DirtyRect none = { 0, 0, 0, 0 };
+                    bounds[window] = none;
+                    for (std::size_t i = 0; i < dirty.size(); ++i) {
+                        if (dirty[i] == window) {
+                            dirty.erase(dirty.begin() + i);
+                            break;
+                        }
+                    }
+                }
+
+                bool Pending() const {
+                    return !dirty.empty();
+                }
+
+                /// <summary>
+                /// Ends the frame: moves every dirty window's merged rectangles
+                /// to the flushed lists and clears the pending state. Returns
+                /// the number of windows to invalidate.
+                /// </summary>
+                int Flush() {
+                    flushedWindows.clear();
+                    flushedFirst.resize(1);
+                    flushedRects.clear();
+                    flushedSkipped.assign(dirty.size(), 0);
+                    flushedCounted = (int)dirty.size();
+                    for (std::size_t i = 0; i < dirty.size(); ++i) {
+                        DirtyRegion& region = regions[dirty[i]];
+                        const std::vector<DirtyRect>& rects = region.Rects();
+                        flushedWindows.push_back(dirty[i]);
+                        flushedRects.insert(flushedRects.end(), rects.begin(), rects.end());
+                        flushedFirst.push_back((int)flushedRects.size());
+                        stats.Rects += (long long)rects.size();
+                        stats.Pixels += region.Area();
+                        region.Clear();
+                    }
+                    if (!dirty.empty())
+                        ++stats.Frames;
+                    stats.Invalidations += (long long)dirty.size();
+                    dirty.clear();
+                    return (int)flushedWindows.size();
+                }
+
+                /// <summary>
+                /// Takes flushed window i back out of the stats, for a caller
+                /// that found the window gone and did not invalidate it. A
+                /// frame whose windows were all skipped is not counted.
+                /// </summary>
+                void Skip(int i) {
+                    if (flushedSkipped[i])
+                        return;
+                    flushedSkipped[i] = 1;
+                    --stats.Invalidations;
+                    stats.Rects -= flushedFirst[i + 1] - flushedFirst[i];
+                    for (int k = flushedFirst[i]; k < flushedFirst[i + 1]; ++k)
+                        stats.Pixels -= Detail::Area(flushedRects[k]);
+                    if (--flushedCounted == 0)
+                        --stats.Frames;
+                }
+
+                int FlushedCount() const {
+                    return (int)flushedWindows.size();
+                }
+
+                int FlushedWindow(int i) const {
+                    return flushedWindows[i];
+                }
+
+                int FlushedFirst(int i) const {
+                    return flushedFirst[i];
+                }
+
+                int FlushedEnd(int i) const {
+                    return flushedFirst[i + 1];
+                }
+
+                const DirtyRect& FlushedRect(int k) const {
+                    return flushedRects[k];
+                }
+
+                const InvalidationStats& Stats() const {
+                    return stats;
+                }
+
+                void ResetStats() {
+                    InvalidationStats zero = { 0, 0, 0, 0, 0, 0 };
+                    stats = zero;
+                    // The last flush is no longer in the stats, so Skip has nothing to take out
+                    flushedSkipped.assign(flushedSkipped.size(), 1);
+                }
+            };
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
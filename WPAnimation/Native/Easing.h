@@ -0,0 +1,502 @@
+#pragma once
+
+#include "../../WPMath/Native/Transcendental.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Animation {
+        namespace Native {
+            /// <summary>
+            /// Easing curve families. The ones up to EaseInOutBounce need no
+            /// parameters and double as the built-in easing ids of the engine.
+            /// </summary>
+            enum EasingKind {
+                EaseLinear = 0,
+                EaseInQuad,
+                EaseOutQuad,
+                EaseInOutQuad,
+                EaseInCubic,
+                EaseOutCubic,
+                EaseInOutCubic,
+                EaseInElastic,
+                EaseOutElastic,
+                EaseInOutElastic,
+                EaseInBounce,
+                EaseOutBounce,
+                EaseInOutBounce,
+                BuiltinEasingCount,
+
+                EaseCubicBezier = BuiltinEasingCount,
+                EaseSpring,
+                EaseSteps
+            };
+
+            /// <summary>
+            /// Where the jumps of a steps() curve fall, as in CSS
+            /// </summary>
+            enum StepPosition {
+                StepJumpEnd = 0,
+                StepJumpStart,
+                StepJumpNone,
+                StepJumpBoth
+            };
+
+            /// <summary>
+            /// Curve elements processed per pass of the transcendental kernels,
+            /// sized for stack scratch
+            /// </summary>
+            const int EasingChunk = 128;
+
+            namespace Detail {
+                typedef Math::Native::Simd<double> V;
+
+                inline double Clamp01(double t) {
+                    return t < 0 ? 0 : (t > 1 ? 1 : t);
+                }
+
+                /// <summary>
+                /// Penner's out-bounce: four parabolic arcs
+                /// </summary>
+                inline double OutBounce(double t) {
+                    const double n = 7.5625, d = 2.75;
+                    return t < 1 / d ? n * t * t
+                         : t < 2 / d ? n * (t - 1.5 / d) * (t - 1.5 / d) + 0.75
+                         : t < 2.5 / d ? n * (t - 2.25 / d) * (t - 2.25 / d) + 0.9375
+                         : n * (t - 2.625 / d) * (t - 2.625 / d) + 0.984375;
+                }
+
+                /// <summary>
+                /// Cubic-bezier polynomial coefficients, x(s) = ((a s + b) s + c) s
+                /// </summary>
+                struct Bezier {
+                    double Ax, Bx, Cx, Ay, By, Cy;
+
+                    Bezier(double x1, double y1, double x2, double y2) {
+                        Cx = 3 * x1;
+                        Bx = 3 * (x2 - x1) - Cx;
+                        Ax = 1 - Cx - Bx;
+                        Cy = 3 * y1;
+                        By = 3 * (y2 - y1) - Cy;
+                        Ay = 1 - Cy - By;
+                    }
+                };
+
+                /// <summary>
+                /// Bisection steps that shrink the bracket of x(s) = t to 1/64
+                /// before Newton takes over, so Newton starts close enough to
+                /// converge quadratically
+                /// </summary>
+                const int BezierBisections = 6;
+
+                /// <summary>
+                /// Newton steps after bisection, each clamped to the bracket
+                /// </summary>
+                const int BezierNewtonSteps = 4;
+
+                /// <summary>
+                /// y(s) where x(s) = t, for one register of t in [0, 1]. Every
+                /// lane runs the same fixed sequence of bisection and clamped
+                /// Newton steps, so there are no branches. Where x has a zero
+                /// tangent at an end (x1 = 0 or x2 = 1) the root is double and
+                /// Newton only halves the error per step, so t = 0 and t = 1 are
+                /// pinned to y = 0 and 1; within about 1e-6 of such an end y is
+                /// good to about 1e-3 rather than to rounding.
+                /// </summary>
+                WP_MATH_FORCEINLINE V::Vec BezierSolve(const Bezier& b, V::Vec t) {
+                    V::Vec ax = V::Broadcast(b.Ax), bx = V::Broadcast(b.Bx), cx = V::Broadcast(b.Cx);
+                    V::Vec half = V::Broadcast(0.5);
+                    V::Vec lo = V::Zero(), hi = V::Broadcast(1.0), s = half;
+                    for (int k = 0; k < BezierBisections; ++k) {
+                        V::Vec f = V::Sub(V::Mul(V::MulAdd(V::MulAdd(ax, s, bx), s, cx), s), t);
+                        V::Vec below = V::Less(f, V::Zero());
+                        lo = V::Select(below, s, lo);
+                        hi = V::Select(below, hi, s);
+                        s = V::Mul(V::Add(lo, hi), half);
+                    }
+                    V::Vec ax3 = V::Broadcast(3 * b.Ax), bx2 = V::Broadcast(2 * b.Bx);
+                    for (int k = 0; k < BezierNewtonSteps; ++k) {
+                        V::Vec f = V::Sub(V::Mul(V::MulAdd(V::MulAdd(ax, s, bx), s, cx), s), t);
+                        V::Vec d = V::MulAdd(V::MulAdd(ax3, s, bx2), s, cx);
+                        // A zero slope gives an infinite or NaN step; max/min
+                        // return their second operand on NaN, so lo wins
+                        V::Vec next = V::Sub(s, V::Div(f, d));
+                        s = V::Min(V::Max(next, lo), hi);
+                    }
+                    V::Vec ay = V::Broadcast(b.Ay), by = V::Broadcast(b.By), cy = V::Broadcast(b.Cy);
+                    V::Vec one = V::Broadcast(1.0);
+                    V::Vec y = V::Mul(V::MulAdd(V::MulAdd(ay, s, by), s, cy), s);
+                    y = V::Select(V::Less(V::Zero(), t), y, V::Zero());
+                    return V::Select(V::Less(t, one), y, one);
+                }
+
+                inline double BezierSolve(const Bezier& b, double t) {
+                    if (t <= 0 || t >= 1)
+                        return t <= 0 ? 0 : 1;
+                    double lo = 0, hi = 1, s = 0.5;
+                    for (int k = 0; k < BezierBisections; ++k) {
+                        double f = ((b.Ax * s + b.Bx) * s + b.Cx) * s - t;
+                        if (f < 0)
+                            lo = s;
+                        else
+                            hi = s;
+                        s = (lo + hi) / 2;
+                    }
+                    for (int k = 0; k < BezierNewtonSteps; ++k) {
+                        double f = ((b.Ax * s + b.Bx) * s + b.Cx) * s - t;
+                        double d = (3 * b.Ax * s + 2 * b.Bx) * s + b.Cx;
+                        double next = s - f / d;
+                        s = next > lo ? (next < hi ? next : hi) : lo;
+                    }
+                    return ((b.Ay * s + b.By) * s + b.Cy) * s;
+                }
+            }
+
+            /// <summary>
+            /// One easing curve: a family and its parameters, optionally baked
+            /// into a lookup table. Parameters by family:
+            /// cubic-bezier (X1, Y1, X2, Y2); spring (damping ratio, angular
+            /// frequency in radians per unit of progress); elastic (amplitude,
+            /// period); steps (count, StepPosition).
+            /// </summary>
+            struct EasingCurve {
+                int Kind;
+                double P0, P1, P2, P3;
+
+                /// <summary>
+                /// Samples at t = i / (size - 1) when baked, else empty
+                /// </summary>
+                std::vector<double> Table;
+
+                EasingCurve() : Kind(EaseLinear), P0(0), P1(0), P2(0), P3(0) {
+                }
+
+                explicit EasingCurve(int kind, double p0 = 0, double p1 = 0, double p2 = 0, double p3 = 0)
+                    : Kind(kind), P0(p0), P1(p1), P2(p2), P3(p3) {
+                }
+
+                /// <summary>
+                /// A parameterless family with its default parameters
+                /// (elastic: amplitude 1, period 0.3)
+                /// </summary>
+                static EasingCurve Builtin(int kind) {
+                    if (kind >= EaseInElastic && kind <= EaseInOutElastic)
+                        return EasingCurve(kind, 1, 0.3);
+                    return EasingCurve(kind >= 0 && kind < BuiltinEasingCount ? kind : EaseLinear);
+                }
+
+                static EasingCurve CubicBezier(double x1, double y1, double x2, double y2) {
+                    return EasingCurve(EaseCubicBezier, x1, y1, x2, y2);
+                }
+
+                static EasingCurve Spring(double dampingRatio, double frequency) {
+                    return EasingCurve(EaseSpring, dampingRatio, frequency);
+                }
+
+                static EasingCurve Elastic(int kind, double amplitude, double period) {
+                    return EasingCurve(kind, amplitude < 1 ? 1 : amplitude, period);
+                }
+
+                static EasingCurve Steps(int count, int position) {
+                    return EasingCurve(EaseSteps, count, position);
+                }
+
+                /// <summary>
+                /// Exact value at progress t (clamped to [0, 1]), ignoring any
+                /// table
+                /// </summary>
+                double Analytic(double t) const;
+
+                /// <summary>
+                /// Value at progress t, from the table when baked
+                /// </summary>
+                double Evaluate(double t) const {
+                    if (Table.empty())
+                        return Analytic(t);
+                    int last = (int)Table.size() - 1;
+                    double x = Detail::Clamp01(t) * last;
+                    int i = (int)x;
+                    if (i >= last)
+                        i = last - 1;
+                    return Table[i] + (Table[i + 1] - Table[i]) * (x - i);
+                }
+
+                /// <summary>
+                /// Samples the analytic curve into a size-entry table (size >= 2)
+                /// so evaluation becomes a lookup and a lerp. The error is about
+                /// max |y''| / (8 (size - 1)^2); steps() curves are not baked.
+                /// </summary>
+                void Bake(int size);
+
+                void Unbake() {
+                    std::vector<double>().swap(Table);
+                }
+            };
+
+            namespace Detail {
+                /// <summary>
+                /// Out-variant of a mirrored family (elastic, bounce) for u in
+                /// [0, 1], over a chunk
+                /// </summary>
+                inline void OutElasticChunk(double amplitude, double period, const double* u, double* y, int n) {
+                    // Returning before the scratch arrays exist also shows the
+                    // compiler that they are written before VectorExp reads them
+                    if (n <= 0)
+                        return;
+                    const double twoPi = 6.283185307179586476925;
+                    double shift = period / twoPi * std::asin(1 / amplitude);
+                    double w = twoPi / period;
+                    double decay[EasingChunk], phase[EasingChunk];
+                    for (int i = 0; i < n; ++i) {
+                        decay[i] = -6.931471805599453094172 * u[i];   // 2^(-10 u)
+                        phase[i] = (u[i] - shift) * w;
+                    }
+                    Math::Native::VectorExp(decay, decay, n);
+                    Math::Native::VectorSinCos<double>(phase, phase, 0, n);
+                    for (int i = 0; i < n; ++i)
+                        y[i] = u[i] >= 1 ? 1 : amplitude * decay[i] * phase[i] + 1;
+                }
+
+                inline void OutBounceChunk(const double* u, double* y, int n) {
+                    for (int i = 0; i < n; ++i)
+                        y[i] = OutBounce(u[i]);
+                }
+
+                /// <summary>
+                /// Applies a mirrored family: in(t) = 1 - out(1 - t) and in-out
+                /// joins the two halves at t = 1/2
+                /// </summary>
+                template<typename Out>
+                void MirroredChunk(int mode, const double* t, double* y, int n, Out out) {
+                    double u[EasingChunk];
+                    if (mode == 0) {
+                        for (int i = 0; i < n; ++i)
+                            u[i] = 1 - t[i];
+                        out(u, y, n);
+                        for (int i = 0; i < n; ++i)
+                            y[i] = 1 - y[i];
+                    }
+                    else if (mode == 1) {
+                        out(t, y, n);
+                    }
+                    else {
+                        for (int i = 0; i < n; ++i)
+                            u[i] = t[i] < 0.5 ? 1 - 2 * t[i] : 2 * t[i] - 1;
+                        out(u, y, n);
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] < 0.5 ? (1 - y[i]) * 0.5 : (1 + y[i]) * 0.5;
+                    }
+                }
+
+                struct ElasticOut {
+                    double Amplitude, Period;
+                    void operator()(const double* u, double* y, int n) const {
+                        OutElasticChunk(Amplitude, Period, u, y, n);
+                    }
+                };
+
+                struct BounceOut {
+                    void operator()(const double* u, double* y, int n) const {
+                        OutBounceChunk(u, y, n);
+                    }
+                };
+
+                /// <summary>
+                /// Damped spring from 0 to 1 released at rest; snaps to 1 at
+                /// t = 1
+                /// </summary>
+                inline void SpringChunk(double zeta, double omega, const double* t, double* y, int n) {
+                    // See OutElasticChunk
+                    if (n <= 0)
+                        return;
+                    double a[EasingChunk], b[EasingChunk];
+                    if (zeta < 1) {
+                        double wd = omega * std::sqrt(1 - zeta * zeta);
+                        double ratio = zeta * omega / wd;
+                        double c[EasingChunk];
+                        for (int i = 0; i < n; ++i) {
+                            a[i] = -zeta * omega * t[i];
+                            b[i] = wd * t[i];
+                        }
+                        Math::Native::VectorExp(a, a, n);
+                        Math::Native::VectorSinCos<double>(b, b, c, n);
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] >= 1 ? 1 : 1 - a[i] * (c[i] + ratio * b[i]);
+                    }
+                    else if (zeta == 1) {
+                        for (int i = 0; i < n; ++i)
+                            a[i] = -omega * t[i];
+                        Math::Native::VectorExp(a, a, n);
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] >= 1 ? 1 : 1 - a[i] * (1 + omega * t[i]);
+                    }
+                    else {
+                        double root = std::sqrt(zeta * zeta - 1);
+                        double r1 = -omega * (zeta - root), r2 = -omega * (zeta + root);
+                        double scale = 1 / (r2 - r1);
+                        for (int i = 0; i < n; ++i) {
+                            a[i] = r1 * t[i];
+                            b[i] = r2 * t[i];
+                        }
+                        Math::Native::VectorExp(a, a, n);
+                        Math::Native::VectorExp(b, b, n);
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] >= 1 ? 1 : 1 - (r2 * a[i] - r1 * b[i]) * scale;
+                    }
+                }
+
+                inline void StepsChunk(int count, int position, const double* t, double* y, int n) {
+                    int jumps = position == StepJumpNone ? count - 1 : (position == StepJumpBoth ? count + 1 : count);
+                    double offset = position == StepJumpStart || position == StepJumpBoth ? 1 : 0;
+                    double inverse = jumps > 0 ? 1.0 / jumps : 0;
+                    for (int i = 0; i < n; ++i) {
+                        double step = std::floor(t[i] * count) + offset;
+                        step = step > jumps ? jumps : step;
+                        y[i] = step * inverse;
+                    }
+                }
+
+                inline void BezierChunk(const EasingCurve& c, const double* t, double* y, int n) {
+                    Bezier b(c.P0, c.P1, c.P2, c.P3);
+                    int i = 0;
+                    for (; i + V::Width <= n; i += V::Width)
+                        V::Store(y + i, BezierSolve(b, V::Load(t + i)));
+                    for (; i < n; ++i)
+                        y[i] = BezierSolve(b, t[i]);
+                }
+
+                inline void LookupChunk(const std::vector<double>& table, const double* t, double* y, int n) {
+                    const double* s = &table[0];
+                    int last = (int)table.size() - 1;
+                    for (int i = 0; i < n; ++i) {
+                        double x = t[i] * last;
+                        int k = (int)x;
+                        k = k >= last ? last - 1 : k;
+                        double lo = s[k];
+                        y[i] = lo + (s[k + 1] - lo) * (x - k);
+                    }
+                }
+
+                /// <summary>
+                /// Evaluates one chunk of progress values already clamped to
+                /// [0, 1]
+                /// </summary>
+                inline void EaseChunk(const EasingCurve& c, const double* t, double* y, int n) {
+                    if (!c.Table.empty()) {
+                        LookupChunk(c.Table, t, y, n);
+                        return;
+                    }
+                    switch (c.Kind) {
+                    case EaseInQuad:
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] * t[i];
+                        break;
+                    case EaseOutQuad:
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] * (2 - t[i]);
+                        break;
+                    case EaseInOutQuad:
+                        for (int i = 0; i < n; ++i) {
+                            double u = 1 - t[i];
+                            y[i] = t[i] < 0.5 ? 2 * t[i] * t[i] : 1 - 2 * u * u;
+                        }
+                        break;
+                    case EaseInCubic:
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i] * t[i] * t[i];
+                        break;
+                    case EaseOutCubic:
+                        for (int i = 0; i < n; ++i) {
+                            double u = 1 - t[i];
+                            y[i] = 1 - u * u * u;
+                        }
+                        break;
+                    case EaseInOutCubic:
+                        for (int i = 0; i < n; ++i) {
+                            double u = 1 - t[i];
+                            y[i] = t[i] < 0.5 ? 4 * t[i] * t[i] * t[i] : 1 - 4 * u * u * u;
+                        }
+                        break;
+                    case EaseInElastic:
+                    case EaseOutElastic:
+                    case EaseInOutElastic: {
+                        ElasticOut out = { c.P0, c.P1 };
+                        MirroredChunk(c.Kind - EaseInElastic, t, y, n, out);
+                        break;
+                    }
+                    case EaseInBounce:
+                    case EaseOutBounce:
+                    case EaseInOutBounce:
+                        MirroredChunk(c.Kind - EaseInBounce, t, y, n, BounceOut());
+                        break;
+                    case EaseCubicBezier:
+                        BezierChunk(c, t, y, n);
+                        break;
+                    case EaseSpring:
+                        SpringChunk(c.P0, c.P1, t, y, n);
+                        break;
+                    case EaseSteps:
+                        StepsChunk((int)c.P0, (int)c.P1, t, y, n);
+                        break;
+                    default:
+                        for (int i = 0; i < n; ++i)
+                            y[i] = t[i];
+                        break;
+                    }
+                }
+            }
+
+            /// <summary>
+            /// y[i] = curve(t[i]) for progress values clamped to [0, 1]. Each
+            /// family runs as straight loops over the batch: polynomials,
+            /// bounce and steps as select-only arithmetic the compiler
+            /// vectorizes, cubic-bezier as a fixed-count Newton solve over
+            /// Simd lanes, elastic and spring through the vectorized exp and
+            /// sin/cos of WPMath. y may alias t.
+            /// </summary>
+            inline void EaseBatch(const EasingCurve& curve, const double* t, double* y, int count) {
+                double clamped[EasingChunk];
+                for (int i0 = 0; i0 < count; i0 += EasingChunk) {
+                    int n = count - i0 < EasingChunk ? count - i0 : EasingChunk;
+                    for (int i = 0; i < n; ++i)
+                        clamped[i] = Detail::Clamp01(t[i0 + i]);
+                    Detail::EaseChunk(curve, clamped, y + i0, n);
+                }
+            }
+
+            inline double EasingCurve::Analytic(double t) const {
+                double u = Detail::Clamp01(t), y;
+                if (Table.empty()) {
+                    Detail::EaseChunk(*this, &u, &y, 1);
+                }
+                else {
+                    EasingCurve exact(Kind, P0, P1, P2, P3);
+                    Detail::EaseChunk(exact, &u, &y, 1);
+                }
+                return y;
+            }
+
+            inline void EasingCurve::Bake(int size) {
+                if (Kind == EaseSteps || size < 2)
+                    return;
+                std::vector<double> samples(size);
+                for (int i = 0; i < size; ++i)
+                    samples[i] = (double)i / (size - 1);
+                Unbake();
+                EaseBatch(*this, &samples[0], &samples[0], size);
+                samples[0] = Analytic(0);
+                samples[size - 1] = Analytic(1);
+                Table.swap(samples);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
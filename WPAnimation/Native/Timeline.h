@@ -0,0 +1,551 @@
+#pragma once
+
+#include "Easing.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Animation {
+        namespace Native {
+            /// <summary>
+            /// Curve id of a segment that holds the previous key's value and
+            /// jumps at the next key. Played in reverse it jumps at the
+            /// previous key and holds the next key's value.
+            /// </summary>
+            const int HoldCurve = -1;
+
+            /// <summary>
+            /// Compiled storyboard: one track per animated property, each a
+            /// run of keyframes (time, value, curve easing the segment that
+            /// ends at the key) stored contiguously in key-time order. The
+            /// table is immutable once built, so any number of players can
+            /// share one, and sampling a track at any time is a binary search
+            /// over its key times, O(log k).
+            ///
+            /// A track holds its first value before its first key and its last
+            /// value after its last key. Keys may share a time; the later one
+            /// wins from that time on, which is how jumps are stored.
+            /// </summary>
+            class CompiledTimeline {
+            private:
+                friend class Storyboard;
+
+                std::vector<int> properties;    // per track, ascending
+                std::vector<int> first;         // key range of track k is [first[k], first[k + 1])
+                std::vector<double> times;
+                std::vector<double> values;
+                std::vector<int> curves;        // per key, easing the segment ending at it
+                std::vector<unsigned char> reversed;
+                std::vector<EasingCurve> table;
+                double duration;
+
+                CompiledTimeline(const CompiledTimeline&);
+                CompiledTimeline& operator=(const CompiledTimeline&);
+
+            public:
+                CompiledTimeline() : duration(0) {
+                    first.push_back(0);
+                }
+
+                int TrackCount() const {
+                    return (int)properties.size();
+                }
+
+                /// <summary>
+                /// Property id animated by a track
+                /// </summary>
+                int Property(int track) const {
+                    return properties[track];
+                }
+
+                /// <summary>
+                /// Track animating a property, or -1
+                /// </summary>
+                int TrackOf(int property) const {
+                    std::vector<int>::const_iterator it = std::lower_bound(properties.begin(), properties.end(), property);
+                    return it != properties.end() && *it == property ? (int)(it - properties.begin()) : -1;
+                }
+
+                /// <summary>
+                /// End time of the last key of the whole storyboard
+                /// </summary>
+                double Duration() const {
+                    return duration;
+                }
+
+                int KeyCount() const {
+                    return (int)times.size();
+                }
+
+                int FirstKey(int track) const {
+                    return first[track];
+                }
+
+                int EndKey(int track) const {
+                    return first[track + 1];
+                }
+
+                double KeyTime(int key) const {
+                    return times[key];
+                }
+
+                double KeyValue(int key) const {
+                    return values[key];
+                }
+
+                /// <summary>
+                /// Last key of a track at or before time t, or its first key
+                /// when t precedes it
+                /// </summary>
+                int Locate(int track, double t) const {
+                    // Branch-free halving: the select compiles to a conditional
+                    // move, so random seeks do not pay a misprediction per level
+                    int b = first[track], n = first[track + 1] - b;
+                    if (n <= 0)
+                        return b;
+                    const double* base = &times[b];
+                    while (n > 1) {
+                        int half = n / 2;
+                        base = base[half] <= t ? base + half : base;
+                        n -= half;
+                    }
+                    return b + (int)(base - &times[b]);
+                }
+
+                /// <summary>
+                /// Whether Locate(track, t) would return key, so a cached key
+                /// can be reused without searching
+                /// </summary>
+                bool Covers(int track, int key, double t) const {
+                    int b = first[track], e = first[track + 1];
+                    if (key < b || key >= e)
+                        return false;
+                    if (key > b && times[key] > t)
+                        return false;
+                    return key + 1 >= e || t < times[key + 1];
+                }
+
+                /// <summary>
+                /// Value of a track at time t given the key Locate returns
+                /// </summary>
+                double Interpolate(int track, int key, double t) const {
+                    int next = key + 1;
+                    if (next >= first[track + 1] || t <= times[key])
+                        return values[key];
+                    if (curves[next] == HoldCurve)
+                        return reversed[next] ? values[next] : values[key];
+                    double u = (t - times[key]) / (times[next] - times[key]);
+                    const EasingCurve& curve = table[curves[next]];
+                    double f = reversed[next] ? 1 - curve.Evaluate(1 - u) : curve.Evaluate(u);
+                    return values[key] + (values[next] - values[key]) * f;
+                }
+
+                double Sample(int track, double t) const {
+                    return Interpolate(track, Locate(track, t), t);
+                }
+
+                /// <summary>
+                /// Samples every track at time t into out[TrackCount()]
+                /// </summary>
+                void SampleAll(double t, double* out) const {
+                    for (int k = 0; k < TrackCount(); ++k)
+                        out[k] = Sample(k, t);
+                }
+            };
+
+            /// <summary>
+            /// Per-player sampling state over a shared CompiledTimeline: the
+            /// key each track was last found at. Playing forward reuses it or
+            /// steps to the next key, so a frame costs O(1) per track; any
+            /// other jump falls back to the binary search.
+            /// </summary>
+            class TimelineCursor {
+            private:
+                std::vector<int> keys;
+
+            public:
+                TimelineCursor() {
+                }
+
+                explicit TimelineCursor(const CompiledTimeline& timeline) {
+                    Reset(timeline);
+                }
+
+                void Reset(const CompiledTimeline& timeline) {
+                    keys.resize(timeline.TrackCount());
+                    for (int k = 0; k < timeline.TrackCount(); ++k)
+                        keys[k] = timeline.FirstKey(k);
+                }
+
+                /// <summary>
+                /// Samples every track at time t into out[TrackCount()]
+                /// </summary>
+                void Sample(const CompiledTimeline& timeline, double t, double* out) {
+                    if ((int)keys.size() != timeline.TrackCount())
+                        Reset(timeline);
+                    for (int k = 0; k < timeline.TrackCount(); ++k) {
+                        int key = keys[k];
+                        if (!timeline.Covers(k, key, t)) {
+                            if (timeline.Covers(k, key + 1, t))
+                                ++key;
+                            else
+                                key = timeline.Locate(k, t);
+                            keys[k] = key;
+                        }
+                        out[k] = timeline.Interpolate(k, key, t);
+                    }
+                }
+            };
+
+            /// <summary>
+            /// Storyboard description and compiler. Nodes are built bottom-up
+            /// and never change once created: clips of keyframes on one
+            /// property, and sequence, parallel, stagger, repeat, reverse and
+            /// delay nodes over earlier nodes (a node may be reused). Compile
+            /// flattens the graph under a root into a CompiledTimeline, so the
+            /// graph is interpreted once rather than every frame.
+            ///
+            /// When clips on the same property overlap, the clip that starts
+            /// later drops the earlier clip's keys after its first key, and
+            /// the track holds the last key left until then. Repeats are
+            /// unrolled, so the table grows with the repeat count.
+            /// </summary>
+            class Storyboard {
+            private:
+                enum NodeKind {
+                    ClipNode,
+                    SequenceNode,
+                    ParallelNode,
+                    StaggerNode,
+                    RepeatNode,
+                    ReverseNode,
+                    DelayNode,
+                };
+
+                struct Node {
+                    int Kind;
+                    int Property;       // clips only
+                    int First;          // clips: first key; others: first child
+                    int Count;          // keys or children
+                    double Interval;    // stagger step or delay
+                    bool Alternate;     // repeat: reverse every other pass
+                    double Duration;
+                };
+
+                struct Placed {
+                    int Property;
+                    int Run;
+                    double RunStart;
+                    double Time;
+                    double Value;
+                    int Curve;
+                    unsigned char Reversed;
+                };
+
+                struct PlacedOrder {
+                    bool operator()(const Placed& a, const Placed& b) const {
+                        if (a.Property != b.Property)
+                            return a.Property < b.Property;
+                        if (a.RunStart != b.RunStart)
+                            return a.RunStart < b.RunStart;
+                        return a.Run < b.Run;
+                    }
+                };
+
+                std::vector<Node> nodes;
+                std::vector<int> children;
+                std::vector<double> keyTimes;
+                std::vector<double> keyValues;
+                std::vector<int> keyCurves;
+                std::vector<EasingCurve> curves;
+
+                Storyboard(const Storyboard&);
+                Storyboard& operator=(const Storyboard&);
+
+                static Node MakeNode(int kind) {
+                    Node n;
+                    n.Kind = kind;
+                    n.Property = -1;
+                    n.First = 0;
+                    n.Count = 0;
+                    n.Interval = 0;
+                    n.Alternate = false;
+                    n.Duration = 0;
+                    return n;
+                }
+
+                int Add(const Node& n) {
+                    nodes.push_back(n);
+                    return (int)nodes.size() - 1;
+                }
+
+                int Composite(int kind, const int* items, int count, double interval) {
+                    Node n = MakeNode(kind);
+                    n.First = (int)children.size();
+                    n.Count = count;
+                    n.Interval = interval;
+                    double start = 0;
+                    for (int i = 0; i < count; ++i) {
+                        children.push_back(items[i]);
+                        double d = nodes[items[i]].Duration;
+                        if (kind == SequenceNode) {
+                            start += d;
+                            n.Duration = start;
+                        }
+                        else
+                            n.Duration = std::max(n.Duration, (kind == StaggerNode ? i * interval : 0) + d);
+                    }
+                    return Add(n);
+                }
+
+                void Place(const Node& parent, double offset, bool reversed, int child, double start, bool flip,
+                    std::vector<Placed>& out, int& run) const {
+                    double d = nodes[child].Duration;
+                    double at = reversed ? offset + parent.Duration - (start + d) : offset + start;
+                    Emit(child, at, reversed != flip, out, run);
+                }
+
+                void Emit(int node, double offset, bool reversed, std::vector<Placed>& out, int& run) const {
+                    const Node& n = nodes[node];
+                    switch (n.Kind) {
+                    case ClipNode: {
+                        Placed p;
+                        p.Property = n.Property;
+                        p.Run = run++;
+                        p.RunStart = reversed ? offset : offset + keyTimes[n.First];
+                        for (int j = 0; j < n.Count; ++j) {
+                            if (reversed) {
+                                // Key j of the mirrored clip is original key i; the
+                                // segment ending at it is the one that ended at i + 1
+                                int i = n.First + n.Count - 1 - j;
+                                p.Time = offset + n.Duration - keyTimes[i];
+                                p.Value = keyValues[i];
+                                p.Curve = j == 0 ? HoldCurve : keyCurves[i + 1];
+                                p.Reversed = 1;
+                            }
+                            else {
+                                int i = n.First + j;
+                                p.Time = offset + keyTimes[i];
+                                p.Value = keyValues[i];
+                                p.Curve = j == 0 ? HoldCurve : keyCurves[i];
+                                p.Reversed = 0;
+                            }
+                            out.push_back(p);
+                        }
+                        break;
+                    }
+                    case SequenceNode: {
+                        double start = 0;
+                        for (int i = 0; i < n.Count; ++i) {
+                            int child = children[n.First + i];
+                            Place(n, offset, reversed, child, start, false, out, run);
+                            start += nodes[child].Duration;
+                        }
+                        break;
+                    }
+                    case ParallelNode:
+                    case StaggerNode:
+                        for (int i = 0; i < n.Count; ++i)
+                            Place(n, offset, reversed, children[n.First + i], n.Kind == StaggerNode ? i * n.Interval : 0,
+                                false, out, run);
+                        break;
+                    case RepeatNode: {
+                        int child = children[n.First];
+                        double d = nodes[child].Duration;
+                        for (int k = 0; k < n.Count; ++k)
+                            Place(n, offset, reversed, child, k * d, n.Alternate && (k & 1), out, run);
+                        break;
+                    }
+                    case ReverseNode:
+                        Emit(children[n.First], offset, !reversed, out, run);
+                        break;
+                    case DelayNode:
+                        Place(n, offset, reversed, children[n.First], n.Interval, false, out, run);
+                        break;
+                    }
+                }
+
+            public:
+                Storyboard() {
+                    for (int k = 0; k < BuiltinEasingCount; ++k)
+                        curves.push_back(EasingCurve::Builtin(k));
+                }
+
+                /// <summary>
+                /// Adds a curve for clips to use and returns its id; ids below
+                /// BuiltinEasingCount are the built-in curves
+                /// </summary>
+                int RegisterCurve(const EasingCurve& curve) {
+                    curves.push_back(curve);
+                    return (int)curves.size() - 1;
+                }
+
+                int CurveCount() const {
+                    return (int)curves.size();
+                }
+
+                int NodeCount() const {
+                    return (int)nodes.size();
+                }
+
+                bool IsNode(int node) const {
+                    return node >= 0 && node < (int)nodes.size();
+                }
+
+                /// <summary>
+                /// Length of a node in seconds
+                /// </summary>
+                double Duration(int node) const {
+                    return nodes[node].Duration;
+                }
+
+                /// <summary>
+                /// Adds keyframes on one property. times are non-decreasing
+                /// and non-negative; curveIds[i] eases the segment ending at
+                /// key i (HoldCurve for a step) and curveIds[0] is unused.
+                /// A null curveIds means linear; unknown ids fall back to it.
+                /// </summary>
+                int Clip(int property, const double* times, const double* values, const int* curveIds, int count) {
+                    Node n = MakeNode(ClipNode);
+                    n.Property = property;
+                    n.First = (int)keyTimes.size();
+                    n.Count = count;
+                    for (int i = 0; i < count; ++i) {
+                        int c = curveIds ? curveIds[i] : EaseLinear;
+                        keyTimes.push_back(times[i]);
+                        keyValues.push_back(values[i]);
+                        keyCurves.push_back(c == HoldCurve || (c >= 0 && c < (int)curves.size()) ? c : EaseLinear);
+                    }
+                    n.Duration = count > 0 ? times[count - 1] : 0;
+                    return Add(n);
+                }
+
+                /// <summary>
+                /// Runs nodes one after another
+                /// </summary>
+                int Sequence(const int* items, int count) {
+                    return Composite(SequenceNode, items, count, 0);
+                }
+
+                /// <summary>
+                /// Runs nodes together from the same start
+                /// </summary>
+                int Parallel(const int* items, int count) {
+                    return Composite(ParallelNode, items, count, 0);
+                }
+
+                /// <summary>
+                /// Starts node i at i * interval seconds
+                /// </summary>
+                int Stagger(const int* items, int count, double interval) {
+                    return Composite(StaggerNode, items, count, interval);
+                }
+
+                /// <summary>
+                /// Plays a node count times back to back, mirroring every
+                /// other pass when alternate is set
+                /// </summary>
+                int Repeat(int node, int count, bool alternate) {
+                    Node n = MakeNode(RepeatNode);
+                    n.First = (int)children.size();
+                    n.Count = count;
+                    n.Alternate = alternate;
+                    n.Duration = count * nodes[node].Duration;
+                    children.push_back(node);
+                    return Add(n);
+                }
+
+                /// <summary>
+                /// Plays a node backwards in time, with each segment's curve
+                /// mirrored so the motion is the exact reverse
+                /// </summary>
+                int Reverse(int node) {
+                    Node n = MakeNode(ReverseNode);
+                    n.First = (int)children.size();
+                    n.Count = 1;
+                    n.Duration = nodes[node].Duration;
+                    children.push_back(node);
+                    return Add(n);
+                }
+
+                /// <summary>
+                /// Starts a node after seconds of idle time
+                /// </summary>
+                int Delay(int node, double seconds) {
+                    Node n = MakeNode(DelayNode);
+                    n.First = (int)children.size();
+                    n.Count = 1;
+                    n.Interval = seconds;
+                    n.Duration = seconds + nodes[node].Duration;
+                    children.push_back(node);
+                    return Add(n);
+                }
+
+                /// <summary>
+                /// Flattens the graph under root into a new track table owned by
+                /// the caller. Only the curves the table uses are copied.
+                /// </summary>
+                CompiledTimeline* Compile(int root) const {
+                    std::vector<Placed> placed;
+                    int run = 0;
+                    Emit(root, 0, false, placed, run);
+                    std::stable_sort(placed.begin(), placed.end(), PlacedOrder());
+
+                    CompiledTimeline* result = new CompiledTimeline();
+                    CompiledTimeline& c = *result;
+                    c.duration = nodes[root].Duration;
+                    std::vector<int> remap(curves.size(), -1);
+
+                    std::size_t i = 0;
+                    while (i < placed.size()) {
+                        int property = placed[i].Property;
+                        int begin = (int)c.times.size();
+                        c.properties.push_back(property);
+                        for (; i < placed.size() && placed[i].Property == property; ++i) {
+                            const Placed& p = placed[i];
+                            bool runStart = i == 0 || placed[i - 1].Run != p.Run || placed[i - 1].Property != property;
+                            if (runStart) {
+                                // A later clip cuts off whatever the track still had after its start
+                                while ((int)c.times.size() > begin && c.times.back() > p.RunStart) {
+                                    c.times.pop_back();
+                                    c.values.pop_back();
+                                    c.curves.pop_back();
+                                    c.reversed.pop_back();
+                                }
+                            }
+                            int curve = p.Curve;
+                            unsigned char mirrored = p.Reversed;
+                            if (runStart || (int)c.times.size() == begin) {
+                                // Entering a run holds the value before it, whichever way the run plays
+                                curve = HoldCurve;
+                                mirrored = 0;
+                            }
+                            else if (curve != HoldCurve) {
+                                if (remap[curve] < 0) {
+                                    remap[curve] = (int)c.table.size();
+                                    c.table.push_back(curves[curve]);
+                                }
+                                curve = remap[curve];
+                            }
+                            c.times.push_back(p.Time);
+                            c.values.push_back(p.Value);
+                            c.curves.push_back(curve);
+                            c.reversed.push_back(mirrored);
+                        }
+                        c.first.push_back((int)c.times.size());
+                    }
+                    return result;
+                }
+            };
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,3 @@
+#include "pch.h"
+#include "Storyboard.h"
+#include "StoryboardPlayer.h"
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "EasingCurve.h"
+#include "Native/Timeline.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// A node of a storyboard: a keyframe clip or a composition of other
+        /// nodes. Only valid with the storyboard that created it.
+        /// </summary>
+        public value struct TimelineNode {
+        private:
+            Object^ owner;
+            int id;
+
+        internal:
+            TimelineNode(Object^ source, int value) {
+                owner = source;
+                id = value;
+            }
+
+            property Object^ Owner {
+                Object^ get() { return owner; }
+            }
+
+            property int Id {
+                int get() { return id; }
+            }
+        };
+
+        /// <summary>
+        /// Storyboard compiled into a flat, immutable track table: one track
+        /// per animated property, with keyframe times kept sorted so sampling
+        /// any time is a binary search per track. Players share one instance,
+        /// so replaying or scrubbing never re-walks the storyboard.
+        /// </summary>
+        public ref class CompiledStoryboard {
+        private:
+            Native::CompiledTimeline* timeline;
+            array<String^>^ names;
+            Dictionary<String^, int>^ tracks;
+
+        internal:
+            CompiledStoryboard(Native::CompiledTimeline* compiled, array<String^>^ trackNames) {
+                timeline = compiled;
+                names = trackNames;
+                tracks = gcnew Dictionary<String^, int>();
+                for (int k = 0; k < names->Length; k++)
+                    tracks->Add(names[k], k);
+            }
+
+            property const Native::CompiledTimeline& Timeline {
+                const Native::CompiledTimeline& get() {
+                    if (!timeline)
+                        throw gcnew ObjectDisposedException("CompiledStoryboard");
+                    return *timeline;
+                }
+            }
+
+        public:
+            ~CompiledStoryboard() {
+                this->!CompiledStoryboard();
+            }
+
+            !CompiledStoryboard() {
+                delete timeline;
+                timeline = nullptr;
+            }
+
+            /// <summary>
+            /// Gets the length in seconds
+            /// </summary>
+            property double Duration {
+                double get() { return Timeline.Duration(); }
+            }
+
+            /// <summary>
+            /// Gets the number of animated properties
+            /// </summary>
+            property int TrackCount {
+                int get() { return Timeline.TrackCount(); }
+            }
+
+            /// <summary>
+            /// Gets the total number of keyframes over all tracks
+            /// </summary>
+            property int KeyCount {
+                int get() { return Timeline.KeyCount(); }
+            }
+
+            /// <summary>
+            /// Gets the property animated by a track
+            /// </summary>
+            String^ GetTrackName(int track) {
+                if (track < 0 || track >= names->Length)
+                    throw gcnew ArgumentOutOfRangeException("track");
+                return names[track];
+            }
+
+            /// <summary>
+            /// Gets the track animating a property, or -1
+            /// </summary>
+            int IndexOf(String^ property) {
+                if (property == nullptr)
+                    throw gcnew ArgumentNullException("property");
+                int track;
+                return tracks->TryGetValue(property, track) ? track : -1;
+            }
+
+            /// <summary>
+            /// Gets the value of one track at a time in seconds
+            /// </summary>
+            double Sample(int track, double time) {
+                const Native::CompiledTimeline& t = Timeline;
+                if (track < 0 || track >= t.TrackCount())
+                    throw gcnew ArgumentOutOfRangeException("track");
+                return t.Sample(track, time);
+            }
+
+            /// <summary>
+            /// Gets the value of every track at a time in seconds
+            /// </summary>
+            void Sample(double time, array<double>^ values) {
+                const Native::CompiledTimeline& t = Timeline;
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (values->Length < t.TrackCount())
+                    throw gcnew ArgumentException("Values array is too short", "values");
+                if (t.TrackCount() == 0)
+                    return;
+
+                pin_ptr<double> out = &values[0];
+                t.SampleAll(time, out);
+            }
+        };
+
+        /// <summary>
+        /// Builds multi-property storyboards out of keyframe clips composed
+        /// in sequence, in parallel, staggered, repeated, reversed and
+        /// delayed, then compiles them into a CompiledStoryboard. Nodes never
+        /// change once made and may be reused in several places.
+        /// </summary>
+        public ref class Storyboard {
+        private:
+            Native::Storyboard* storyboard;
+            Dictionary<String^, int>^ propertyIds;
+            List<String^>^ propertyNames;
+            Dictionary<EasingCurve^, int>^ curveIds;
+
+            Native::Storyboard& Board() {
+                if (!storyboard)
+                    throw gcnew ObjectDisposedException("Storyboard");
+                return *storyboard;
+            }
+
+            int PropertyId(String^ name) {
+                if (String::IsNullOrEmpty(name))
+                    throw gcnew ArgumentNullException("property");
+                int id;
+                if (!propertyIds->TryGetValue(name, id)) {
+                    id = propertyNames->Count;
+                    propertyIds->Add(name, id);
+                    propertyNames->Add(name);
+                }
+                return id;
+            }
+
+            int CurveId(EasingCurve^ curve) {
+                if (curve == nullptr)
+                    return Native::HoldCurve;
+                int id;
+                if (!curveIds->TryGetValue(curve, id)) {
+                    id = Board().RegisterCurve(curve->NativeCurve);
+                    curveIds->Add(curve, id);
+                }
+                return id;
+            }
+
+            int NodeId(TimelineNode node) {
+                if (node.Owner != this || !Board().IsNode(node.Id))
+                    throw gcnew ArgumentException("The node does not belong to this storyboard", "node");
+                return node.Id;
+            }
+
+            array<int>^ NodeIds(array<TimelineNode>^ nodes) {
+                if (nodes == nullptr)
+                    throw gcnew ArgumentNullException("nodes");
+                if (nodes->Length == 0)
+                    throw gcnew ArgumentException("At least one node is required", "nodes");
+                array<int>^ ids = gcnew array<int>(nodes->Length);
+                for (int i = 0; i < nodes->Length; i++)
+                    ids[i] = NodeId(nodes[i]);
+                return ids;
+            }
+
+            TimelineNode Node(int id) {
+                return TimelineNode(this, id);
+            }
+
+            TimelineNode AddClip(String^ property, array<double>^ times, array<double>^ values, array<int>^ curves) {
+                if (times == nullptr)
+                    throw gcnew ArgumentNullException("times");
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (times->Length == 0)
+                    throw gcnew ArgumentException("At least one keyframe is required", "times");
+                if (values->Length != times->Length)
+                    throw gcnew ArgumentException("There must be one value per keyframe time", "values");
+                for (int i = 0; i < times->Length; i++) {
+                    if (!(times[i] >= 0) || Double::IsInfinity(times[i]) || (i > 0 && times[i] < times[i - 1]))
+                        throw gcnew ArgumentException("Keyframe times must be finite, non-negative and non-decreasing", "times");
+                    if (Double::IsNaN(values[i]) || Double::IsInfinity(values[i]))
+                        throw gcnew ArgumentException("Keyframe values must be finite", "values");
+                }
+
+                int id = PropertyId(property);
+                pin_ptr<double> pt = &times[0];
+                pin_ptr<double> pv = &values[0];
+                pin_ptr<int> pc = &curves[0];
+                return Node(Board().Clip(id, pt, pv, pc, times->Length));
+            }
+
+        public:
+            Storyboard() {
+                storyboard = new Native::Storyboard();
+                propertyIds = gcnew Dictionary<String^, int>();
+                propertyNames = gcnew List<String^>();
+                curveIds = gcnew Dictionary<EasingCurve^, int>();
+            }
+
+            ~Storyboard() {
+                this->!Storyboard();
+            }
+
+            !Storyboard() {
+                delete storyboard;
+                storyboard = nullptr;
+            }
+
+            /// <summary>
+            /// Adds keyframes on a property, joined by straight lines. Times
+            /// are in seconds from the clip start, non-decreasing.
+            /// </summary>
+            TimelineNode Keyframes(String^ property, array<double>^ times, array<double>^ values) {
+                if (times == nullptr)
+                    throw gcnew ArgumentNullException("times");
+                array<int>^ ids = gcnew array<int>(System::Math::Max(times->Length, 1));
+                for (int i = 0; i < ids->Length; i++)
+                    ids[i] = Native::EaseLinear;
+                return AddClip(property, times, values, ids);
+            }
+
+            /// <summary>
+            /// Adds keyframes on a property with one curve easing every segment
+            /// </summary>
+            TimelineNode Keyframes(String^ property, array<double>^ times, array<double>^ values, EasingCurve^ curve) {
+                if (curve == nullptr)
+                    throw gcnew ArgumentNullException("curve");
+                if (times == nullptr)
+                    throw gcnew ArgumentNullException("times");
+                array<int>^ ids = gcnew array<int>(System::Math::Max(times->Length, 1));
+                int id = CurveId(curve);
+                for (int i = 0; i < ids->Length; i++)
+                    ids[i] = id;
+                return AddClip(property, times, values, ids);
+            }
+
+            /// <summary>
+            /// Adds keyframes on a property where curves[i] eases the segment
+            /// from key i to key i + 1; a null entry holds key i's value until
+            /// key i + 1
+            /// </summary>
+            TimelineNode Keyframes(String^ property, array<double>^ times, array<double>^ values, array<EasingCurve^>^ curves) {
+                if (times == nullptr)
+                    throw gcnew ArgumentNullException("times");
+                if (curves == nullptr)
+                    throw gcnew ArgumentNullException("curves");
+                if (curves->Length != System::Math::Max(times->Length - 1, 0))
+                    throw gcnew ArgumentException("There must be one curve per segment", "curves");
+                array<int>^ ids = gcnew array<int>(System::Math::Max(times->Length, 1));
+                ids[0] = Native::HoldCurve;
+                for (int i = 0; i < curves->Length; i++)
+                    ids[i + 1] = CurveId(curves[i]);
+                return AddClip(property, times, values, ids);
+            }
+
+            /// <summary>
+            /// Adds a single transition of a property between two values
+            /// </summary>
+            TimelineNode Tween(String^ property, double from, double to, double duration, EasingCurve^ curve) {
+                return Keyframes(property, gcnew array<double>{ 0, duration }, gcnew array<double>{ from, to }, curve);
+            }
+
+            /// <summary>
+            /// Plays nodes one after another
+            /// </summary>
+            TimelineNode Sequence(... array<TimelineNode>^ nodes) {
+                array<int>^ ids = NodeIds(nodes);
+                pin_ptr<int> p = &ids[0];
+                return Node(Board().Sequence(p, ids->Length));
+            }
+
+            /// <summary>
+            /// Plays nodes together; the result lasts as long as the longest
+            /// </summary>
+            TimelineNode Parallel(... array<TimelineNode>^ nodes) {
+                array<int>^ ids = NodeIds(nodes);
+                pin_ptr<int> p = &ids[0];
+                return Node(Board().Parallel(p, ids->Length));
+            }
+
+            /// <summary>
+            /// Starts node i at i * interval seconds
+            /// </summary>
+            TimelineNode Stagger(double interval, ... array<TimelineNode>^ nodes) {
+                if (!(interval >= 0) || Double::IsInfinity(interval))
+                    throw gcnew ArgumentOutOfRangeException("interval");
+                array<int>^ ids = NodeIds(nodes);
+                pin_ptr<int> p = &ids[0];
+                return Node(Board().Stagger(p, ids->Length, interval));
+            }
+
+            /// <summary>
+            /// Plays a node count times back to back
+            /// </summary>
+            TimelineNode Repeat(TimelineNode node, int count) {
+                return Repeat(node, count, false);
+            }
+
+            /// <summary>
+            /// Plays a node count times back to back, every other pass
+            /// backwards when alternate is set
+            /// </summary>
+            TimelineNode Repeat(TimelineNode node, int count, bool alternate) {
+                if (count < 1)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                return Node(Board().Repeat(NodeId(node), count, alternate));
+            }
+
+            /// <summary>
+            /// Plays a node backwards, mirroring each segment's easing
+            /// </summary>
+            TimelineNode Reverse(TimelineNode node) {
+                return Node(Board().Reverse(NodeId(node)));
+            }
+
+            /// <summary>
+            /// Starts a node after a pause in seconds
+            /// </summary>
+            TimelineNode Delay(TimelineNode node, double seconds) {
+                if (!(seconds >= 0) || Double::IsInfinity(seconds))
+                    throw gcnew ArgumentOutOfRangeException("seconds");
+                return Node(Board().Delay(NodeId(node), seconds));
+            }
+
+            /// <summary>
+            /// Gets the length of a node in seconds
+            /// </summary>
+            double GetDuration(TimelineNode node) {
+                return Board().Duration(NodeId(node));
+            }
+
+            /// <summary>
+            /// Flattens a node and everything under it into a track table.
+            /// Compile once and share the result between players.
+            /// </summary>
+            CompiledStoryboard^ Compile(TimelineNode root) {
+                Native::CompiledTimeline* compiled = Board().Compile(NodeId(root));
+                array<String^>^ names = gcnew array<String^>(compiled->TrackCount());
+                for (int k = 0; k < names->Length; k++)
+                    names[k] = propertyNames[compiled->Property(k)];
+                return gcnew CompiledStoryboard(compiled, names);
+            }
+        };
+    }
+}
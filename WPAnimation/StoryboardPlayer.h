@@ -0,0 +1,197 @@
+#pragma once
+
+#include "AnimationEngine.h"
+#include "Storyboard.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Animation {
+        /// <summary>
+        /// Plays one instance of a compiled storyboard against an engine's
+        /// clock, writing its tracks into bound engine targets. Many players
+        /// can share one CompiledStoryboard; each only keeps its start time
+        /// and the key each track was last found at, so playing forward costs
+        /// O(1) per track per frame and seeking anywhere O(log k).
+        ///
+        /// While running, the engine advances the player on every Tick and
+        /// lists the targets it writes among the tick's written targets, so
+        /// Ticked consumers such as AnimationProvider apply them.
+        /// </summary>
+        public ref class StoryboardPlayer {
+        private:
+            CompiledStoryboard^ storyboard;
+            AnimationEngine^ engine;
+            Func<double, bool>^ advance;
+            Native::TimelineCursor* cursor;
+            array<double>^ values;
+            array<int>^ targets;
+            double begin;
+            double time;
+            bool running;
+
+            Native::TimelineCursor& Cursor() {
+                if (!cursor)
+                    throw gcnew ObjectDisposedException("StoryboardPlayer");
+                return *cursor;
+            }
+
+            void MoveTo(double position) {
+                time = position;
+                if (values->Length == 0)
+                    return;
+
+                {
+                    pin_ptr<double> out = &values[0];
+                    Cursor().Sample(storyboard->Timeline, position, out);
+                }
+                for (int k = 0; k < targets->Length; k++) {
+                    if (targets[k] >= 0)
+                        engine->WriteValue(targets[k], values[k]);
+                }
+            }
+
+            /// <summary>
+            /// Called by the engine on every Tick while registered: moves to
+            /// the tick's time while running, or rewrites a seek made while
+            /// stopped. Returns whether to stay registered.
+            /// </summary>
+            bool Advance(double now) {
+                if (!cursor)
+                    return false;
+                if (!running) {
+                    MoveTo(time);
+                    return false;
+                }
+                MoveTo(now - begin);
+                if (time >= storyboard->Duration) {
+                    running = false;
+                    Completed(this, EventArgs::Empty);
+                }
+                return running;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a stopped player at time zero
+            /// </summary>
+            StoryboardPlayer(CompiledStoryboard^ storyboard, AnimationEngine^ engine) {
+                if (storyboard == nullptr)
+                    throw gcnew ArgumentNullException("storyboard");
+                if (engine == nullptr)
+                    throw gcnew ArgumentNullException("engine");
+                this->storyboard = storyboard;
+                this->engine = engine;
+                advance = gcnew Func<double, bool>(this, &StoryboardPlayer::Advance);
+                cursor = new Native::TimelineCursor(storyboard->Timeline);
+                values = gcnew array<double>(storyboard->TrackCount);
+                targets = gcnew array<int>(storyboard->TrackCount);
+                for (int k = 0; k < targets->Length; k++)
+                    targets[k] = -1;
+            }
+
+            ~StoryboardPlayer() {
+                running = false;
+                engine->RemovePlayback(advance);
+                this->!StoryboardPlayer();
+            }
+
+            !StoryboardPlayer() {
+                delete cursor;
+                cursor = nullptr;
+            }
+
+            /// <summary>
+            /// Raised during the engine's Tick, or by Update, when playback
+            /// reaches the end
+            /// </summary>
+            event EventHandler^ Completed;
+
+            /// <summary>
+            /// Gets the storyboard being played
+            /// </summary>
+            property CompiledStoryboard^ Storyboard {
+                CompiledStoryboard^ get() { return storyboard; }
+            }
+
+            /// <summary>
+            /// Gets the playback position in seconds
+            /// </summary>
+            property double Time {
+                double get() { return time; }
+            }
+
+            /// <summary>
+            /// Gets whether Begin was called and the end not yet reached
+            /// </summary>
+            property bool IsRunning {
+                bool get() { return running; }
+            }
+
+            /// <summary>
+            /// Writes a track into an engine target on every seek, or stops
+            /// writing it when target is -1
+            /// </summary>
+            void Bind(String^ track, int target) {
+                int k = storyboard->IndexOf(track);
+                if (k < 0)
+                    throw gcnew ArgumentException("The storyboard does not animate this property", "track");
+                if (target != -1)
+                    engine->GetValue(target);
+                targets[k] = target;
+            }
+
+            /// <summary>
+            /// Gets the value of a track at the current position
+            /// </summary>
+            double GetValue(int track) {
+                if (track < 0 || track >= values->Length)
+                    throw gcnew ArgumentOutOfRangeException("track");
+                return values[track];
+            }
+
+            /// <summary>
+            /// Starts playing from the beginning at the engine's current time;
+            /// the engine advances it from its next Tick on
+            /// </summary>
+            void Begin() {
+                begin = engine->Now;
+                running = true;
+                MoveTo(0);
+                engine->AddPlayback(advance);
+            }
+
+            /// <summary>
+            /// Stops playing, leaving the targets where they are
+            /// </summary>
+            void Stop() {
+                running = false;
+                engine->RemovePlayback(advance);
+            }
+
+            /// <summary>
+            /// Moves to the engine's current time while running, and raises
+            /// Completed once the end is reached. The engine's Tick already
+            /// does this; call it only to sample between ticks.
+            /// </summary>
+            void Update() {
+                if (running && !Advance(engine->Now))
+                    engine->RemovePlayback(advance);
+            }
+
+            /// <summary>
+            /// Samples every track at a time in seconds and writes the bound
+            /// targets, which Ticked consumers see on the next Tick. While
+            /// running, playback continues from there.
+            /// </summary>
+            void Seek(double position) {
+                if (Double::IsNaN(position))
+                    throw gcnew ArgumentOutOfRangeException("position");
+                if (running)
+                    begin = engine->Now - position;
+                MoveTo(position);
+                engine->AddPlayback(advance);
+            }
+        };
+    }
+}
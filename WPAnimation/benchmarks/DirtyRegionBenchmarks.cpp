@@ -0,0 +1,91 @@
+#include "Benchmark.h"
+#include "DirtyRegion.h"
+
+#include <vector>
+
+using namespace WindowPlus::Animation::Native;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    const int WindowWidth = 1920, WindowHeight = 1080;
+
+    DirtyRect Bounds(int x, int y, int width, int height) {
+        DirtyRect r = { x, y, x + width, y + height };
+        return r;
+    }
+
+    /// <summary>
+    /// A frame of controls sliding across four windows: each control
+    /// writes its old and new bounds, then the batch flushes. Reports the
+    /// rectangles left per window, the share of writes merged away and
+    /// the share of window area invalidated.
+    /// </summary>
+    void RunFrames(Context& context) {
+        static const int counts[] = { 64, 1024, 16384 };
+        const int windows = 4, width = 40, height = 24;
+        int sizes = context.Quick() ? 2 : 3;
+        for (int s = 0; s < sizes; ++s) {
+            int n = counts[s];
+            InvalidationBatch batch;
+            for (int w = 0; w < windows; ++w)
+                batch.SetBounds(w, WindowWidth, WindowHeight);
+            int frame = 0;
+            Timing t = context.Measure([&]() {
+                int shift = frame++ % 64, next = shift + 3;
+                for (int i = 0; i < n; ++i) {
+                    int window = i % windows, slot = i / windows;
+                    int x = slot % 40 * 48, y = slot / 40 % 40 * 27;
+                    batch.Add(window, Bounds(x + shift, y, width, height));
+                    batch.Add(window, Bounds(x + next, y, width, height));
+                }
+                batch.Flush();
+            });
+            const InvalidationStats& stats = batch.Stats();
+            context.Add("dirty-region", "frame", t).Param("controls", n).Param("windows", windows)
+                .Counter("ns_per_write", t.Median / (2.0 * n) * 1e9)
+                .Counter("rects_per_window", (double)stats.Rects / stats.Invalidations)
+                .Counter("merged_fraction", (double)stats.Merged / stats.Writes)
+                .Counter("area_fraction", (double)stats.Pixels / ((double)stats.Frames * windows * WindowWidth * WindowHeight));
+            context.Check(stats.Invalidations == stats.Frames * windows, "A window was invalidated more than once per frame");
+        }
+    }
+
+    /// <summary>
+    /// Scattered small rectangles in one window under growing maxRects,
+    /// where merging is driven by the limit rather than by overlap: a
+    /// higher limit costs more per add and invalidates less area
+    /// </summary>
+    void RunLimits(Context& context) {
+        static const int limits[] = { 1, 4, 8, 16, 32 };
+        const int n = 64;
+        std::vector<DirtyRect> rects(n);
+        unsigned seed = 99;
+        for (int i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            int x = (int)(seed >> 8) % (WindowWidth - 16);
+            seed = seed * 1664525u + 1013904223u;
+            int y = (int)(seed >> 8) % (WindowHeight - 16);
+            rects[i] = Bounds(x, y, 16, 16);
+        }
+
+        for (int l = 0; l < 5; ++l) {
+            DirtyRegion region(limits[l], 0.125);
+            Timing t = context.Measure([&]() {
+                region.Clear();
+                for (int i = 0; i < n; ++i)
+                    region.Add(rects[i]);
+            });
+            context.Add("dirty-region", "limit", t).Param("rects", n).Param("max_rects", limits[l])
+                .Counter("ns_per_add", t.Median / n * 1e9)
+                .Counter("area_fraction", (double)region.Area() / ((double)WindowWidth * WindowHeight));
+            context.Check(region.Count() <= limits[l], "Region exceeds its rectangle limit");
+        }
+    }
+
+    void Run(Context& context) {
+        RunFrames(context);
+        RunLimits(context);
+    }
+
+    SuiteRegistration registration("dirty-region", &Run);
+}
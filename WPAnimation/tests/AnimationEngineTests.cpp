@@ -0,0 +1,253 @@
+#include "Test.h"
+#include "AnimationEngine.h"
+#include "Timeline.h"
+
+#include <memory>
+
+using namespace WindowPlus::Animation::Native;
+using namespace WindowPlus::Animation::Tests;
+
+namespace {
+    void StartInterpolatesAndCompletes() {
+        AnimationEngine engine;
+        int t = engine.CreateTarget(5);
+        AnimationId id = engine.Start(t, 0, 100, 1, 2, EaseLinear);
+        WP_CHECK(id != 0);
+        WP_CHECK(engine.IsActive(id));
+        WP_CHECK(engine.Driver(t) == id);
+        WP_CHECK(engine.TargetOf(id) == t);
+        WP_CHECK(engine.Count() == 1);
+
+        engine.Tick(1.5);
+        WP_CHECK_NEAR(engine.Value(t), 25, 1e-12);
+        WP_CHECK(engine.Written().size() == 1 && engine.Written()[0] == t);
+        WP_CHECK(engine.Finished().empty());
+
+        engine.Tick(3.5);
+        WP_CHECK(engine.Value(t) == 100);
+        WP_CHECK(engine.Finished().size() == 1);
+        WP_CHECK(engine.Finished()[0].Id == id && engine.Finished()[0].Target == t);
+        WP_CHECK(!engine.IsActive(id));
+        WP_CHECK(engine.Driver(t) == 0);
+        WP_CHECK(engine.Count() == 0);
+
+        // Nothing left to run: the next tick writes and finishes nothing
+        engine.Tick(4);
+        WP_CHECK(engine.Finished().empty() && engine.Written().empty());
+        WP_CHECK(engine.Value(t) == 100);
+    }
+
+    void DelayHoldsTheStartValue() {
+        AnimationEngine engine;
+        int t = engine.CreateTarget(-1);
+        AnimationId id = engine.Start(t, 10, 20, 5, 1, EaseLinear);
+        engine.Tick(0);
+        WP_CHECK(engine.Value(t) == 10);
+        engine.Tick(4.999);
+        WP_CHECK(engine.Value(t) == 10);
+        WP_CHECK(engine.IsActive(id));
+        engine.Tick(5.5);
+        WP_CHECK_NEAR(engine.Value(t), 15, 1e-12);
+    }
+
+    void RetargetIsContinuous() {
+        AnimationEngine engine;
+        int t = engine.CreateTarget(0);
+        AnimationId id = engine.Start(t, 0, 100, 0, 1, EaseLinear);
+        engine.Tick(0.5);
+        WP_CHECK_NEAR(engine.Value(t), 50, 1e-12);
+
+        WP_CHECK(engine.Retarget(id, 0.5, 0, 2));
+        WP_CHECK(engine.IsActive(id));
+        engine.Tick(0.5);
+        WP_CHECK_NEAR(engine.Value(t), 50, 1e-12);
+        engine.Tick(1.5);
+        WP_CHECK_NEAR(engine.Value(t), 25, 1e-12);
+        engine.Tick(2.5);
+        WP_CHECK(engine.Value(t) == 0);
+        WP_CHECK(!engine.IsActive(id));
+        WP_CHECK(!engine.Retarget(id, 3, 1, 1));
+    }
+
+    void StartReplacesTheDriver() {
+        AnimationEngine engine;
+        int t = engine.CreateTarget(0);
+        AnimationId first = engine.Start(t, 0, 100, 0, 1, EaseLinear);
+        AnimationId second = engine.Start(t, 100, 200, 0, 1, EaseLinear);
+        WP_CHECK(first != second);
+        WP_CHECK(!engine.IsActive(first));
+        WP_CHECK(engine.IsActive(second));
+        WP_CHECK(engine.Count() == 1);
+        WP_CHECK(!engine.Stop(first));
+        engine.Tick(0.25);
+        WP_CHECK_NEAR(engine.Value(t), 125, 1e-12);
+    }
+
+    void StopLeavesTheLastValue() {
+        AnimationEngine engine;
+        int t = engine.CreateTarget(0);
+        AnimationId id = engine.Start(t, 0, 100, 0, 1, EaseLinear);
+        engine.Tick(0.75);
+        WP_CHECK(engine.Stop(id));
+        WP_CHECK(!engine.Stop(id));
+        engine.Tick(1);
+        WP_CHECK_NEAR(engine.Value(t), 75, 1e-12);
+        WP_CHECK(engine.Finished().empty());
+    }
+
+    void SlotsAreReusedWithNewGenerations() {
+        AnimationEngine engine;
+        int a = engine.CreateTarget(0), b = engine.CreateTarget(0), c = engine.CreateTarget(0);
+        AnimationId ia = engine.Start(a, 0, 1, 0, 1, EaseLinear);
+        AnimationId ib = engine.Start(b, 0, 2, 0, 2, EaseLinear);
+        AnimationId ic = engine.Start(c, 0, 3, 0, 3, EaseLinear);
+
+        // Removing the first moves the last into its dense place
+        WP_CHECK(engine.Stop(ia));
+        WP_CHECK(engine.IsActive(ib) && engine.IsActive(ic));
+        WP_CHECK(engine.TargetOf(ic) == c && engine.Driver(c) == ic);
+        engine.Tick(1.5);
+        WP_CHECK_NEAR(engine.Value(b), 1.5, 1e-12);
+        WP_CHECK_NEAR(engine.Value(c), 1.5, 1e-12);
+
+        // The freed handle slot comes back under a new generation
+        AnimationId reused = engine.Start(a, 0, 1, 2, 1, EaseLinear);
+        WP_CHECK((reused & 0xFFFFFFFFLL) == (ia & 0xFFFFFFFFLL));
+        WP_CHECK(reused != ia);
+        WP_CHECK(!engine.IsActive(ia));
+        WP_CHECK(engine.IsActive(reused));
+
+        // Released targets are reused and stop their animation
+        engine.ReleaseTarget(b);
+        WP_CHECK(!engine.IsTarget(b));
+        WP_CHECK(!engine.IsActive(ib));
+        int d = engine.CreateTarget(7);
+        WP_CHECK(d == b && engine.IsTarget(d));
+        WP_CHECK(engine.Value(d) == 7 && engine.Driver(d) == 0);
+        WP_CHECK(engine.TargetCapacity() == 3);
+        WP_CHECK(!engine.IsActive(0));
+    }
+
+    void CurvesAreAppliedPerAnimation() {
+        AnimationEngine engine;
+        static const int kinds[] = { EaseOutCubic, EaseLinear, EaseInQuad, EaseOutCubic, EaseOutBounce, EaseInQuad };
+        int targets[6];
+        for (int k = 0; k < 6; ++k) {
+            targets[k] = engine.CreateTarget(0);
+            engine.Start(targets[k], 0, 1, 0, 1, kinds[k]);
+        }
+        engine.Tick(0.3);
+        for (int k = 0; k < 6; ++k)
+            WP_CHECK_NEAR(engine.Value(targets[k]), EasingCurve::Builtin(kinds[k]).Evaluate(0.3), 1e-9);
+
+        // Unknown easing ids fall back to linear
+        int t = engine.CreateTarget(0);
+        engine.Start(t, 0, 1, 0, 1, 1000);
+        engine.Tick(0.4);
+        WP_CHECK_NEAR(engine.Value(t), 0.4, 1e-12);
+    }
+
+    /// <summary>
+    /// A zero duration steps from 0 to 1 at its start: a delayed one holds
+    /// the start value through its whole delay
+    /// </summary>
+    void ZeroDurationSteps() {
+        AnimationEngine engine;
+        int t = engine.CreateTarget(0);
+        AnimationId id = engine.Start(t, 0, 100, 10, 0, EaseLinear);
+        static const double before[] = { 0, 9, 9.25, 9.5, 9.9, 9.999999999 };
+        for (int k = 0; k < 6; ++k) {
+            engine.Tick(before[k]);
+            WP_CHECK(engine.Value(t) == 0);
+            WP_CHECK(engine.IsActive(id));
+        }
+        engine.Tick(10);
+        WP_CHECK(engine.Value(t) == 100);
+        WP_CHECK(engine.Finished().size() == 1 && engine.Finished()[0].Id == id);
+
+        // At time zero the gap below the start is subnormal
+        id = engine.Start(t, 0, 1, 0, 0, EaseLinear);
+        engine.Tick(-1e-300);
+        WP_CHECK(engine.Value(t) == 0 && engine.IsActive(id));
+        engine.Tick(0);
+        WP_CHECK(engine.Value(t) == 1 && !engine.IsActive(id));
+
+        // Late ticks and large start times complete too
+        id = engine.Start(t, 1, 2, 1e9, 0, EaseLinear);
+        engine.Tick(1e9 - 1e-6);
+        WP_CHECK(engine.Value(t) == 1);
+        engine.Tick(1e12);
+        WP_CHECK(engine.Value(t) == 2 && !engine.IsActive(id));
+
+        // Retargeting with zero duration jumps at the retarget time
+        id = engine.Start(t, 0, 100, 0, 1, EaseLinear);
+        engine.Tick(0.5);
+        WP_CHECK(engine.Retarget(id, 0.5, -100, 0));
+        engine.Tick(0.5);
+        WP_CHECK(engine.Value(t) == -100 && !engine.IsActive(id));
+    }
+
+    /// <summary>
+    /// A storyboard played inside the engine's tick, the way the managed
+    /// engine advances a StoryboardPlayer: its writes join the animations'
+    /// in Written(), each target once, so a consumer that applies the
+    /// written targets after every tick (as AnimationProvider does) sees
+    /// the storyboard's values
+    /// </summary>
+    void StoryboardWritesAreListed() {
+        Storyboard board;
+        double times[] = { 0, 1 };
+        double opacity[] = { 0, 1 }, left[] = { 10, 30 };
+        int items[] = { board.Clip(0, times, opacity, 0, 2), board.Clip(1, times, left, 0, 2) };
+        std::unique_ptr<CompiledTimeline> timeline(board.Compile(board.Parallel(items, 2)));
+        TimelineCursor cursor(*timeline);
+
+        AnimationEngine engine;
+        int targets[] = { engine.CreateTarget(0), engine.CreateTarget(0) };
+        int animated = engine.CreateTarget(0);
+        engine.Start(animated, 0, 4, 0, 2, EaseLinear);
+        double applied[3] = { -1, -1, -1 };
+
+        double sampled[2];
+        for (int frame = 0; frame <= 4; ++frame) {
+            double now = frame * 0.25;
+            engine.Tick(now);
+            cursor.Sample(*timeline, now, sampled);
+            for (int k = 0; k < 2; ++k)
+                engine.Write(targets[k], sampled[k]);
+            // The storyboard also writes over the animated target; it is still listed once
+            engine.Write(targets[0], sampled[0]);
+
+            const std::vector<int>& written = engine.Written();
+            WP_CHECK(written.size() == 3);
+            for (std::size_t i = 0; i < written.size(); ++i)
+                applied[written[i]] = engine.Value(written[i]);
+            WP_CHECK_NEAR(applied[targets[0]], now, 1e-12);
+            WP_CHECK_NEAR(applied[targets[1]], 10 + 20 * now, 1e-12);
+            WP_CHECK_NEAR(applied[animated], 2 * now, 1e-12);
+        }
+
+        // Once the storyboard stops writing, the tick lists only the animation
+        engine.Tick(1.5);
+        WP_CHECK(engine.Written().size() == 1 && engine.Written()[0] == animated);
+        engine.Tick(2);
+        engine.Tick(3);
+        WP_CHECK(engine.Written().empty());
+
+        // A write between ticks is listed until the next tick
+        engine.Write(targets[1], 7);
+        WP_CHECK(engine.Written().size() == 1 && engine.Value(targets[1]) == 7);
+        engine.Tick(4);
+        WP_CHECK(engine.Written().empty());
+    }
+
+    TestRegistration start("engine/start-interpolates-and-completes", &StartInterpolatesAndCompletes);
+    TestRegistration delay("engine/delay-holds-the-start-value", &DelayHoldsTheStartValue);
+    TestRegistration retarget("engine/retarget-is-continuous", &RetargetIsContinuous);
+    TestRegistration replace("engine/start-replaces-the-driver", &StartReplacesTheDriver);
+    TestRegistration stop("engine/stop-leaves-the-last-value", &StopLeavesTheLastValue);
+    TestRegistration reuse("engine/slots-are-reused-with-new-generations", &SlotsAreReusedWithNewGenerations);
+    TestRegistration curves("engine/curves-are-applied-per-animation", &CurvesAreAppliedPerAnimation);
+    TestRegistration zero("engine/zero-duration-steps", &ZeroDurationSteps);
+    TestRegistration storyboard("engine/storyboard-writes-are-listed", &StoryboardWritesAreListed);
+}
@@ -0,0 +1,291 @@
+#include "Test.h"
+#include "DirtyRegion.h"
+
+#include <vector>
+
+using namespace WindowPlus::Animation::Native;
+using namespace WindowPlus::Animation::Tests;
+
+namespace {
+    DirtyRect Rect(int left, int top, int right, int bottom) {
+        DirtyRect r = { left, top, right, bottom };
+        return r;
+    }
+
+    bool Same(const DirtyRect& a, const DirtyRect& b) {
+        return a.Left == b.Left && a.Top == b.Top && a.Right == b.Right && a.Bottom == b.Bottom;
+    }
+
+    bool Contains(const DirtyRect& r, int x, int y) {
+        return x >= r.Left && x < r.Right && y >= r.Top && y < r.Bottom;
+    }
+
+    /// <summary>
+    /// Whether the region covers every pixel of every rectangle added and
+    /// nothing outside their bounding box
+    /// </summary>
+    bool CoversExactlyEnough(const DirtyRegion& region, const std::vector<DirtyRect>& added) {
+        if (added.empty())
+            return region.Empty();
+        DirtyRect box = added[0];
+        for (std::size_t i = 0; i < added.size(); ++i) {
+            const DirtyRect& a = added[i];
+            box = Detail::Union(box, a);
+            for (int y = a.Top; y < a.Bottom; ++y) {
+                for (int x = a.Left; x < a.Right; ++x) {
+                    bool covered = false;
+                    for (std::size_t k = 0; k < region.Rects().size() && !covered; ++k)
+                        covered = Contains(region.Rects()[k], x, y);
+                    if (!covered)
+                        return false;
+                }
+            }
+        }
+        for (std::size_t k = 0; k < region.Rects().size(); ++k) {
+            const DirtyRect& r = region.Rects()[k];
+            if (Detail::IsEmpty(r) || !Same(Detail::Union(box, r), box))
+                return false;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Random rectangles on a 64 x 64 grid under several limits: the region
+    /// always covers every added pixel, stays within maxRects, and Add
+    /// reports the rectangles it merged away
+    /// </summary>
+    void RegionCoversEveryAddedPixel() {
+        static const int limits[] = { 1, 2, 4, 8 };
+        static const double slacks[] = { 0, 0.125, 1 };
+        unsigned seed = 12345;
+        for (int l = 0; l < 4; ++l) {
+            for (int s = 0; s < 3; ++s) {
+                DirtyRegion region(limits[l], slacks[s]);
+                std::vector<DirtyRect> added;
+                for (int i = 0; i < 40; ++i) {
+                    int v[4];
+                    for (int k = 0; k < 4; ++k) {
+                        seed = seed * 1664525u + 1013904223u;
+                        v[k] = (int)(seed >> 26);
+                    }
+                    DirtyRect r = Rect(v[0], v[1], v[0] + 1 + v[2] / 4, v[1] + 1 + v[3] / 4);
+                    int before = region.Count();
+                    int merged = region.Add(r);
+                    added.push_back(r);
+                    WP_CHECK(region.Count() == before + 1 - merged);
+                    WP_CHECK(region.Count() <= limits[l]);
+                    WP_CHECK(CoversExactlyEnough(region, added));
+                }
+            }
+        }
+    }
+
+    void OverlappingAndAdjacentRectsMerge() {
+        DirtyRegion region;
+        WP_CHECK(region.Add(Rect(5, 5, 5, 20)) == 0 && region.Empty());
+
+        // A control's old and new bounds collapse into one rectangle
+        WP_CHECK(region.Add(Rect(0, 0, 100, 20)) == 0);
+        WP_CHECK(region.Add(Rect(5, 0, 105, 20)) == 1);
+        WP_CHECK(region.Count() == 1 && Same(region.Rects()[0], Rect(0, 0, 105, 20)));
+        WP_CHECK(region.Add(Rect(105, 0, 120, 20)) == 1);
+        WP_CHECK(region.Count() == 1 && region.Area() == 120 * 20);
+
+        // Far apart rectangles stay apart
+        WP_CHECK(region.Add(Rect(300, 300, 310, 310)) == 0);
+        WP_CHECK(region.Count() == 2 && region.Area() == 120 * 20 + 100);
+
+        // A rectangle bridging two merges with both
+        DirtyRegion bridge(8, 0);
+        bridge.Add(Rect(0, 0, 10, 10));
+        bridge.Add(Rect(20, 0, 30, 10));
+        WP_CHECK(bridge.Count() == 2);
+        WP_CHECK(bridge.Add(Rect(10, 0, 20, 10)) == 2);
+        WP_CHECK(bridge.Count() == 1 && Same(bridge.Rects()[0], Rect(0, 0, 30, 10)));
+
+        region.Clear();
+        WP_CHECK(region.Empty() && region.Count() == 0 && region.Area() == 0);
+    }
+
+    /// <summary>
+    /// Over maxRects the pair whose union wastes least merges
+    /// </summary>
+    void LimitMergesTheCheapestPair() {
+        DirtyRegion region(2, 0);
+        region.Add(Rect(0, 0, 10, 10));
+        region.Add(Rect(20, 0, 30, 10));
+        WP_CHECK(region.Count() == 2);
+        WP_CHECK(region.Add(Rect(0, 100, 10, 110)) == 1);
+        WP_CHECK(region.Count() == 2);
+        bool joined = false, alone = false;
+        for (int k = 0; k < 2; ++k) {
+            joined = joined || Same(region.Rects()[k], Rect(0, 0, 30, 10));
+            alone = alone || Same(region.Rects()[k], Rect(0, 100, 10, 110));
+        }
+        WP_CHECK(joined && alone);
+
+        DirtyRegion single(0, 0);
+        single.Add(Rect(0, 0, 1, 1));
+        WP_CHECK(single.Add(Rect(9, 9, 10, 10)) == 1);
+        WP_CHECK(single.Count() == 1 && Same(single.Rects()[0], Rect(0, 0, 10, 10)));
+    }
+
+    /// <summary>
+    /// Lowering maxRects merges down to the new limit, keeps every pixel,
+    /// and later adds respect it
+    /// </summary>
+    void ConfigureShrinksTheRegion() {
+        DirtyRegion region(8, 0);
+        std::vector<DirtyRect> added;
+        for (int i = 0; i < 6; ++i) {
+            added.push_back(Rect(i * 20, (i % 3) * 20, i * 20 + 8, (i % 3) * 20 + 8));
+            region.Add(added.back());
+        }
+        WP_CHECK(region.Count() == 6);
+
+        region.Configure(8, 0);
+        WP_CHECK(region.Count() == 6);
+        region.Configure(3, 0);
+        WP_CHECK(region.Count() == 3);
+        WP_CHECK(CoversExactlyEnough(region, added));
+
+        for (int i = 0; i < 6; ++i) {
+            added.push_back(Rect(i * 20 + 10, 70, i * 20 + 14, 74));
+            region.Add(added.back());
+            WP_CHECK(region.Count() <= 3);
+        }
+        WP_CHECK(CoversExactlyEnough(region, added));
+
+        region.Configure(0, 0);
+        WP_CHECK(region.Count() == 1);
+        WP_CHECK(CoversExactlyEnough(region, added));
+
+        // The cheapest pair merges, not the last two added
+        DirtyRegion pair(8, 0);
+        pair.Add(Rect(0, 0, 10, 10));
+        pair.Add(Rect(20, 0, 30, 10));
+        pair.Add(Rect(0, 100, 10, 110));
+        pair.Configure(2, 0);
+        WP_CHECK(pair.Count() == 2);
+        bool joined = false, alone = false;
+        for (int k = 0; k < 2; ++k) {
+            joined = joined || Same(pair.Rects()[k], Rect(0, 0, 30, 10));
+            alone = alone || Same(pair.Rects()[k], Rect(0, 100, 10, 110));
+        }
+        WP_CHECK(joined && alone);
+        WP_CHECK(pair.Add(Rect(0, 200, 10, 210)) == 1 && pair.Count() == 2);
+    }
+
+    void BatchClipsToTheWindowBounds() {
+        InvalidationBatch batch;
+        batch.SetBounds(0, 50, 40);
+        batch.Add(0, Rect(-10, -10, 20, 20));
+        batch.Add(0, Rect(45, 30, 80, 90));
+        WP_CHECK(batch.Flush() == 1);
+        WP_CHECK(batch.FlushedEnd(0) - batch.FlushedFirst(0) == 2);
+        WP_CHECK(Same(batch.FlushedRect(0), Rect(0, 0, 20, 20)));
+        WP_CHECK(Same(batch.FlushedRect(1), Rect(45, 30, 50, 40)));
+
+        // Entirely outside: counted as a write, nothing to invalidate
+        batch.Add(0, Rect(60, 0, 70, 10));
+        WP_CHECK(!batch.Pending());
+        WP_CHECK(batch.Stats().Writes == 3);
+
+        // Zero size removes the clip
+        batch.SetBounds(0, 0, 0);
+        batch.Add(0, Rect(60, 0, 70, 10));
+        WP_CHECK(batch.Flush() == 1 && Same(batch.FlushedRect(0), Rect(60, 0, 70, 10)));
+    }
+
+    void BatchFlushesOncePerWindow() {
+        InvalidationBatch batch;
+        batch.Add(3, Rect(0, 0, 10, 10));
+        batch.Add(0, Rect(0, 0, 10, 10));
+        batch.Add(3, Rect(2, 0, 12, 10));
+        batch.Add(3, Rect(100, 100, 110, 110));
+        WP_CHECK(batch.Pending());
+        WP_CHECK(batch.Flush() == 2);
+        WP_CHECK(!batch.Pending());
+        WP_CHECK(batch.FlushedCount() == 2);
+        WP_CHECK(batch.FlushedWindow(0) == 3 && batch.FlushedWindow(1) == 0);
+        WP_CHECK(batch.FlushedFirst(0) == 0 && batch.FlushedEnd(0) == 2);
+        WP_CHECK(batch.FlushedFirst(1) == 2 && batch.FlushedEnd(1) == 3);
+
+        const InvalidationStats& stats = batch.Stats();
+        WP_CHECK(stats.Frames == 1 && stats.Writes == 4 && stats.Merged == 1);
+        WP_CHECK(stats.Rects == 3 && stats.Invalidations == 2);
+        WP_CHECK(stats.Pixels == 120 + 100 + 100);
+
+        // An empty frame flushes nothing and is not counted
+        WP_CHECK(batch.Flush() == 0 && batch.FlushedCount() == 0);
+        WP_CHECK(batch.Stats().Frames == 1);
+        batch.ResetStats();
+        WP_CHECK(batch.Stats().Writes == 0 && batch.Stats().Pixels == 0);
+
+        // Configure applies to windows that already exist
+        batch.Configure(1, 0);
+        batch.Add(3, Rect(0, 0, 1, 1));
+        batch.Add(3, Rect(9, 9, 10, 10));
+        WP_CHECK(batch.Flush() == 1 && batch.FlushedEnd(0) == 1);
+        WP_CHECK(Same(batch.FlushedRect(0), Rect(0, 0, 10, 10)));
+    }
+
+    /// <summary>
+    /// A flushed window the caller could not invalidate comes back out of
+    /// the stats, and a frame with nothing left is not counted
+    /// </summary>
+    void SkipUncountsAWindow() {
+        InvalidationBatch batch;
+        batch.Add(0, Rect(0, 0, 10, 10));
+        batch.Add(1, Rect(0, 0, 4, 5));
+        batch.Add(1, Rect(50, 50, 60, 60));
+        WP_CHECK(batch.Flush() == 2);
+        batch.Skip(1);
+        batch.Skip(1);
+        const InvalidationStats& stats = batch.Stats();
+        WP_CHECK(stats.Frames == 1 && stats.Invalidations == 1);
+        WP_CHECK(stats.Rects == 1 && stats.Pixels == 100);
+        WP_CHECK(stats.Writes == 3);
+
+        batch.Add(1, Rect(0, 0, 10, 10));
+        WP_CHECK(batch.Flush() == 1);
+        batch.Skip(0);
+        WP_CHECK(stats.Frames == 1 && stats.Invalidations == 1);
+        WP_CHECK(stats.Rects == 1 && stats.Pixels == 100);
+
+        // After a reset there is nothing left to take out
+        batch.Add(0, Rect(0, 0, 10, 10));
+        WP_CHECK(batch.Flush() == 1);
+        batch.ResetStats();
+        batch.Skip(0);
+        WP_CHECK(stats.Frames == 0 && stats.Invalidations == 0 && stats.Pixels == 0);
+    }
+
+    void ReleaseDropsAWindow() {
+        InvalidationBatch batch;
+        batch.SetBounds(1, 5, 5);
+        batch.Add(1, Rect(0, 0, 10, 10));
+        batch.Add(2, Rect(0, 0, 10, 10));
+        batch.Release(1);
+        batch.Release(40);
+        WP_CHECK(batch.Flush() == 1 && batch.FlushedWindow(0) == 2);
+
+        // The id comes back without its clip or rectangles
+        batch.Add(1, Rect(0, 0, 10, 10));
+        WP_CHECK(batch.Flush() == 1 && batch.FlushedWindow(0) == 1);
+        WP_CHECK(Same(batch.FlushedRect(0), Rect(0, 0, 10, 10)));
+
+        batch.Add(1, Rect(0, 0, 10, 10));
+        batch.Release(1);
+        WP_CHECK(!batch.Pending() && batch.Flush() == 0);
+    }
+
+    TestRegistration coverage("dirty-region/covers-every-added-pixel", &RegionCoversEveryAddedPixel);
+    TestRegistration merge("dirty-region/touching-rects-merge", &OverlappingAndAdjacentRectsMerge);
+    TestRegistration limit("dirty-region/limit-merges-the-cheapest-pair", &LimitMergesTheCheapestPair);
+    TestRegistration configure("dirty-region/configure-shrinks-the-region", &ConfigureShrinksTheRegion);
+    TestRegistration clip("dirty-region/batch-clips-to-the-window-bounds", &BatchClipsToTheWindowBounds);
+    TestRegistration flush("dirty-region/batch-flushes-once-per-window", &BatchFlushesOncePerWindow);
+    TestRegistration skip("dirty-region/skip-uncounts-a-window", &SkipUncountsAWindow);
+    TestRegistration release("dirty-region/release-drops-a-window", &ReleaseDropsAWindow);
+}
@@ -0,0 +1,233 @@
+#include "Test.h"
+#include "Easing.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Animation::Native;
+using namespace WindowPlus::Animation::Tests;
+
+namespace {
+    const double Pi = 3.14159265358979323846;
+
+    /// <summary>
+    /// Textbook scalar forms of the curves, written independently of
+    /// Easing.h with the CRT transcendentals
+    /// </summary>
+    double OutElastic(double amplitude, double period, double u) {
+        if (u >= 1)
+            return 1;
+        double shift = period / (2 * Pi) * std::asin(1 / amplitude);
+        return amplitude * std::pow(2.0, -10 * u) * std::sin((u - shift) * 2 * Pi / period) + 1;
+    }
+
+    double OutBounce(double u) {
+        if (u < 1 / 2.75)
+            return 7.5625 * u * u;
+        if (u < 2 / 2.75) {
+            u -= 1.5 / 2.75;
+            return 7.5625 * u * u + 0.75;
+        }
+        if (u < 2.5 / 2.75) {
+            u -= 2.25 / 2.75;
+            return 7.5625 * u * u + 0.9375;
+        }
+        u -= 2.625 / 2.75;
+        return 7.5625 * u * u + 0.984375;
+    }
+
+    template<typename Out>
+    double Mirrored(int mode, double t, Out out) {
+        if (mode == 0)
+            return 1 - out(1 - t);
+        if (mode == 1)
+            return out(t);
+        return t < 0.5 ? (1 - out(1 - 2 * t)) / 2 : (1 + out(2 * t - 1)) / 2;
+    }
+
+    struct Elastic {
+        double operator()(double u) const { return OutElastic(1, 0.3, u); }
+    };
+
+    struct Bounce {
+        double operator()(double u) const { return OutBounce(u); }
+    };
+
+    double Reference(int kind, double t) {
+        switch (kind) {
+        case EaseInQuad: return std::pow(t, 2);
+        case EaseOutQuad: return 1 - std::pow(1 - t, 2);
+        case EaseInOutQuad: return t < 0.5 ? 2 * std::pow(t, 2) : 1 - std::pow(-2 * t + 2, 2) / 2;
+        case EaseInCubic: return std::pow(t, 3);
+        case EaseOutCubic: return 1 - std::pow(1 - t, 3);
+        case EaseInOutCubic: return t < 0.5 ? 4 * std::pow(t, 3) : 1 - std::pow(-2 * t + 2, 3) / 2;
+        case EaseInElastic:
+        case EaseOutElastic:
+        case EaseInOutElastic: return Mirrored(kind - EaseInElastic, t, Elastic());
+        case EaseInBounce:
+        case EaseOutBounce:
+        case EaseInOutBounce: return Mirrored(kind - EaseInBounce, t, Bounce());
+        default: return t;
+        }
+    }
+
+    double Spring(double zeta, double omega, double t) {
+        if (t >= 1)
+            return 1;
+        if (zeta < 1) {
+            double wd = omega * std::sqrt(1 - zeta * zeta);
+            return 1 - std::exp(-zeta * omega * t) * (std::cos(wd * t) + zeta * omega / wd * std::sin(wd * t));
+        }
+        if (zeta == 1)
+            return 1 - std::exp(-omega * t) * (1 + omega * t);
+        double root = std::sqrt(zeta * zeta - 1);
+        double r1 = -omega * (zeta - root), r2 = -omega * (zeta + root);
+        return 1 - (r2 * std::exp(r1 * t) - r1 * std::exp(r2 * t)) / (r2 - r1);
+    }
+
+    /// <summary>
+    /// y(s) at x(s) = t by bisection to the last bit. The ends are exact:
+    /// at a double root bisection stops about 1e-8 short of them.
+    /// </summary>
+    double Bezier(double x1, double y1, double x2, double y2, double t) {
+        if (t <= 0 || t >= 1)
+            return t <= 0 ? 0 : 1;
+        double lo = 0, hi = 1;
+        for (int k = 0; k < 200 && lo < hi; ++k) {
+            double s = (lo + hi) / 2, u = 1 - s;
+            double x = 3 * u * u * s * x1 + 3 * u * s * s * x2 + s * s * s;
+            if (x < t)
+                lo = s;
+            else
+                hi = s;
+        }
+        double s = (lo + hi) / 2, u = 1 - s;
+        return 3 * u * u * s * y1 + 3 * u * s * s * y2 + s * s * s;
+    }
+
+    /// <summary>
+    /// 0, 1 and count - 2 evenly spread progress values in between, more
+    /// than one EasingChunk so the batch crosses chunk boundaries
+    /// </summary>
+    std::vector<double> Progress(int count) {
+        std::vector<double> t(count);
+        for (int i = 0; i < count; ++i)
+            t[i] = (double)i / (count - 1);
+        return t;
+    }
+
+    double MaxError(const EasingCurve& curve, const std::vector<double>& t, double (*reference)(const EasingCurve&, double)) {
+        std::vector<double> y(t.size());
+        EaseBatch(curve, &t[0], &y[0], (int)t.size());
+        double worst = 0;
+        for (std::size_t i = 0; i < t.size(); ++i)
+            worst = std::fmax(worst, std::fabs(y[i] - reference(curve, t[i])));
+        return worst;
+    }
+
+    double BuiltinReference(const EasingCurve& c, double t) { return Reference(c.Kind, t); }
+    double SpringReference(const EasingCurve& c, double t) { return Spring(c.P0, c.P1, t); }
+    double BezierReference(const EasingCurve& c, double t) { return Bezier(c.P0, c.P1, c.P2, c.P3, t); }
+
+    void BuiltinsMatchTheTextbookForms() {
+        std::vector<double> t = Progress(1001);
+        for (int kind = 0; kind < BuiltinEasingCount; ++kind) {
+            EasingCurve curve = EasingCurve::Builtin(kind);
+            WP_CHECK_NEAR(MaxError(curve, t, &BuiltinReference), 0, 1e-12);
+            WP_CHECK_NEAR(curve.Evaluate(0), 0, 1e-12);
+            WP_CHECK(curve.Evaluate(1) == 1);
+        }
+    }
+
+    void BatchMatchesEvaluate() {
+        // Out of range progress clamps, and y may alias t. The vector and
+        // scalar tails of the transcendentals may differ in the last bit.
+        std::vector<double> t = Progress(300);
+        t[0] = -0.5;
+        t[299] = 2;
+        for (int kind = 0; kind < BuiltinEasingCount; ++kind) {
+            EasingCurve curve = EasingCurve::Builtin(kind);
+            std::vector<double> y(t);
+            EaseBatch(curve, &y[0], &y[0], (int)y.size());
+            for (std::size_t i = 0; i < t.size(); ++i)
+                WP_CHECK_NEAR(y[i], curve.Evaluate(t[i]), 1e-15);
+        }
+    }
+
+    void SpringMatchesTheClosedForm() {
+        std::vector<double> t = Progress(513);
+        static const double dampings[] = { 0.2, 0.7, 1, 1.5, 4 };
+        for (int k = 0; k < 5; ++k) {
+            EasingCurve curve = EasingCurve::Spring(dampings[k], 20);
+            WP_CHECK_NEAR(MaxError(curve, t, &SpringReference), 0, 1e-12);
+            WP_CHECK_NEAR(curve.Evaluate(0), 0, 1e-15);
+            WP_CHECK(curve.Evaluate(1) == 1);
+        }
+    }
+
+    void CubicBezierMatchesBisection() {
+        std::vector<double> t = Progress(1025);
+        static const double curves[][4] = {
+            { 0.25, 0.1, 0.25, 1 },     // CSS ease
+            { 0.42, 0, 1, 1 },          // ease-in
+            { 0.42, 0, 0.58, 1 },       // ease-in-out
+            { 0.68, -0.55, 0.27, 1.55 }, // back in-out, overshooting in y
+            { 0.9, 0, 0.1, 1 },         // nearly flat in the middle
+            { 0, 0.9, 1, 0.1 }          // vertical tangents at the ends
+        };
+        for (int k = 0; k < 6; ++k) {
+            EasingCurve curve = EasingCurve::CubicBezier(curves[k][0], curves[k][1], curves[k][2], curves[k][3]);
+            WP_CHECK_NEAR(MaxError(curve, t, &BezierReference), 0, 1e-9);
+            WP_CHECK(curve.Evaluate(0) == 0 && curve.Evaluate(1) == 1);
+        }
+        EasingCurve linear = EasingCurve::CubicBezier(1.0 / 3, 1.0 / 3, 2.0 / 3, 2.0 / 3);
+        WP_CHECK_NEAR(linear.Evaluate(0.3), 0.3, 1e-15);
+    }
+
+    void StepsFollowCss() {
+        EasingCurve end = EasingCurve::Steps(4, StepJumpEnd);
+        EasingCurve start = EasingCurve::Steps(4, StepJumpStart);
+        EasingCurve none = EasingCurve::Steps(4, StepJumpNone);
+        EasingCurve both = EasingCurve::Steps(4, StepJumpBoth);
+        WP_CHECK(end.Evaluate(0) == 0 && end.Evaluate(0.3) == 0.25 && end.Evaluate(0.99) == 0.75 && end.Evaluate(1) == 1);
+        WP_CHECK(start.Evaluate(0) == 0.25 && start.Evaluate(0.3) == 0.5 && start.Evaluate(1) == 1);
+        WP_CHECK(none.Evaluate(0) == 0 && none.Evaluate(0.3) == 1.0 / 3 && none.Evaluate(1) == 1);
+        WP_CHECK(both.Evaluate(0) == 0.2 && both.Evaluate(0.3) == 0.4 && both.Evaluate(1) == 1);
+    }
+
+    /// <summary>
+    /// A baked table stays within its documented max |y''| / (8 (size - 1)^2)
+    /// </summary>
+    void BakedTablesStayWithinTheirBound() {
+        std::vector<double> t = Progress(4001);
+        const int size = 257;
+        // |y''| peaks at 12 for the cubics and 2 for the quadratics
+        static const int kinds[] = { EaseInQuad, EaseInOutQuad, EaseInCubic, EaseInOutCubic };
+        static const double curvature[] = { 2, 4, 6, 12 };
+        for (int k = 0; k < 4; ++k) {
+            EasingCurve curve = EasingCurve::Builtin(kinds[k]);
+            curve.Bake(size);
+            WP_CHECK((int)curve.Table.size() == size);
+            double bound = curvature[k] / (8.0 * (size - 1) * (size - 1));
+            double worst = 0;
+            for (std::size_t i = 0; i < t.size(); ++i)
+                worst = std::fmax(worst, std::fabs(curve.Evaluate(t[i]) - curve.Analytic(t[i])));
+            WP_CHECK(worst <= bound * (1 + 1e-9));
+            WP_CHECK(curve.Evaluate(0) == 0 && curve.Evaluate(1) == 1);
+            curve.Unbake();
+            WP_CHECK(curve.Table.empty());
+        }
+
+        // Steps curves are never baked
+        EasingCurve steps = EasingCurve::Steps(3, StepJumpEnd);
+        steps.Bake(size);
+        WP_CHECK(steps.Table.empty());
+    }
+
+    TestRegistration builtins("easing/builtins-match-the-textbook-forms", &BuiltinsMatchTheTextbookForms);
+    TestRegistration batch("easing/batch-matches-evaluate", &BatchMatchesEvaluate);
+    TestRegistration spring("easing/spring-matches-the-closed-form", &SpringMatchesTheClosedForm);
+    TestRegistration bezier("easing/cubic-bezier-matches-bisection", &CubicBezierMatchesBisection);
+    TestRegistration steps("easing/steps-follow-css", &StepsFollowCss);
+    TestRegistration baked("easing/baked-tables-stay-within-their-bound", &BakedTablesStayWithinTheirBound);
+}
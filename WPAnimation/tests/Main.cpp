@@ -0,0 +1,28 @@
+#include "Test.h"
+
+#include <cstring>
+
+using namespace WindowPlus::Animation::Tests;
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int ran = 0, failed = 0;
+    for (std::size_t i = 0; i < TestCases().size(); ++i) {
+        const TestCase& test = TestCases()[i];
+        if (filter != nullptr && std::strstr(test.Name, filter) == nullptr)
+            continue;
+        CheckFailures() = 0;
+        test.Run();
+        ++ran;
+        bool ok = CheckFailures() == 0;
+        if (!ok)
+            ++failed;
+        std::printf("%-48s %s\n", test.Name, ok ? "ok" : "FAILED");
+    }
+    if (ran == 0) {
+        std::printf("No test matches '%s'\n", filter);
+        return 2;
+    }
+    std::printf("%d of %d tests passed\n", ran - failed, ran);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+// Minimal harness for the headless WPAnimation native core. Tests register
+// themselves by name; the checks record failures with their location and the
+// run exits non-zero when any failed.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace WindowPlus {
+    namespace Animation {
+        namespace Tests {
+            /// <summary>
+            /// A named test function
+            /// </summary>
+            struct TestCase {
+                const char* Name;
+                void (*Run)();
+            };
+
+            inline std::vector<TestCase>& TestCases() {
+                static std::vector<TestCase> cases;
+                return cases;
+            }
+
+            /// <summary>
+            /// Adds a test at static initialization; declare one per test in
+            /// an anonymous namespace
+            /// </summary>
+            struct TestRegistration {
+                TestRegistration(const char* name, void (*run)()) {
+                    TestCase t = { name, run };
+                    TestCases().push_back(t);
+                }
+            };
+
+            /// <summary>
+            /// Failed checks of the running test
+            /// </summary>
+            inline int& CheckFailures() {
+                static int failures = 0;
+                return failures;
+            }
+
+            inline void Check(bool ok, const char* expression, const char* file, int line) {
+                if (ok)
+                    return;
+                ++CheckFailures();
+                std::printf("  %s:%d: check failed: %s\n", file, line, expression);
+            }
+
+            inline void CheckNear(double actual, double expected, double tolerance, const char* expression, const char* file, int line) {
+                if (std::fabs(actual - expected) <= tolerance)
+                    return;
+                ++CheckFailures();
+                std::printf("  %s:%d: %s is %.17g, expected %.17g within %g\n", file, line, expression, actual, expected, tolerance);
+            }
+        }
+    }
+}
+
+#define WP_CHECK(condition) \
+    ::WindowPlus::Animation::Tests::Check((condition), #condition, __FILE__, __LINE__)
+
+#define WP_CHECK_NEAR(actual, expected, tolerance) \
+    ::WindowPlus::Animation::Tests::CheckNear((actual), (expected), (tolerance), #actual, __FILE__, __LINE__)
@@ -0,0 +1,220 @@
+#include "Test.h"
+#include "Timeline.h"
+
+#include <memory>
+
+using namespace WindowPlus::Animation::Native;
+using namespace WindowPlus::Animation::Tests;
+
+namespace {
+    typedef std::unique_ptr<CompiledTimeline> Compiled;
+
+    /// <summary>
+    /// Two-key clip from one value to another over duration seconds
+    /// </summary>
+    int Line(Storyboard& board, int property, double from, double to, double duration, int curve = EaseLinear) {
+        double times[] = { 0, duration };
+        double values[] = { from, to };
+        int curves[] = { EaseLinear, curve };
+        return board.Clip(property, times, values, curves, 2);
+    }
+
+    void SequencePlaysOneAfterAnother() {
+        Storyboard board;
+        int a = Line(board, 0, 0, 10, 1);
+        int b = Line(board, 1, 0, 20, 2);
+        int back = Line(board, 0, 10, 0, 1);
+        int items[] = { a, b, back };
+        int root = board.Sequence(items, 3);
+        WP_CHECK(board.Duration(root) == 4);
+
+        Compiled c(board.Compile(root));
+        WP_CHECK(c->Duration() == 4);
+        WP_CHECK(c->TrackCount() == 2 && c->Property(0) == 0 && c->Property(1) == 1);
+        WP_CHECK(c->TrackOf(1) == 1 && c->TrackOf(2) == -1);
+
+        WP_CHECK_NEAR(c->Sample(0, 0.5), 5, 1e-12);
+        WP_CHECK(c->Sample(0, 2) == 10);
+        WP_CHECK_NEAR(c->Sample(0, 3.5), 5, 1e-12);
+        WP_CHECK(c->Sample(0, 5) == 0);
+
+        WP_CHECK(c->Sample(1, 0.5) == 0);
+        WP_CHECK_NEAR(c->Sample(1, 2), 10, 1e-12);
+        WP_CHECK(c->Sample(1, 3) == 20 && c->Sample(1, 4) == 20);
+    }
+
+    void ParallelStartsTogether() {
+        Storyboard board;
+        int items[] = { Line(board, 0, 0, 10, 1), Line(board, 1, 5, -5, 4) };
+        int root = board.Parallel(items, 2);
+        WP_CHECK(board.Duration(root) == 4);
+
+        Compiled c(board.Compile(root));
+        double out[2];
+        c->SampleAll(0.5, out);
+        WP_CHECK_NEAR(out[0], 5, 1e-12);
+        WP_CHECK_NEAR(out[1], 3.75, 1e-12);
+        c->SampleAll(2, out);
+        WP_CHECK(out[0] == 10);
+        WP_CHECK_NEAR(out[1], 0, 1e-12);
+    }
+
+    void StaggerOffsetsEachNode() {
+        Storyboard board;
+        int items[] = { Line(board, 0, 0, 1, 1), Line(board, 1, 0, 1, 1), Line(board, 2, 0, 1, 1) };
+        int root = board.Stagger(items, 3, 0.25);
+        WP_CHECK(board.Duration(root) == 1.5);
+
+        Compiled c(board.Compile(root));
+        double out[3];
+        c->SampleAll(0.1, out);
+        WP_CHECK_NEAR(out[0], 0.1, 1e-12);
+        WP_CHECK(out[1] == 0 && out[2] == 0);
+        c->SampleAll(0.75, out);
+        WP_CHECK_NEAR(out[0], 0.75, 1e-12);
+        WP_CHECK_NEAR(out[1], 0.5, 1e-12);
+        WP_CHECK_NEAR(out[2], 0.25, 1e-12);
+        c->SampleAll(1.5, out);
+        WP_CHECK(out[0] == 1 && out[1] == 1 && out[2] == 1);
+
+        // A zero interval is a parallel
+        WP_CHECK(board.Duration(board.Stagger(items, 3, 0)) == 1);
+    }
+
+    void RepeatRestartsEachPass() {
+        Storyboard board;
+        int root = board.Repeat(Line(board, 0, 0, 10, 1, EaseInQuad), 3, false);
+        WP_CHECK(board.Duration(root) == 3);
+
+        Compiled c(board.Compile(root));
+        WP_CHECK(c->KeyCount() == 6);
+        WP_CHECK_NEAR(c->Sample(0, 0.5), 2.5, 1e-12);
+        WP_CHECK_NEAR(c->Sample(0, 1 - 1e-9), 10, 1e-7);
+        // Both passes have a key at 1; the later one, the restart, wins
+        WP_CHECK(c->Sample(0, 1) == 0);
+        WP_CHECK_NEAR(c->Sample(0, 1.5), 2.5, 1e-12);
+        WP_CHECK_NEAR(c->Sample(0, 2.5), 2.5, 1e-12);
+        WP_CHECK(c->Sample(0, 3) == 10 && c->Sample(0, 7) == 10);
+    }
+
+    void AlternateMirrorsEveryOtherPass() {
+        Storyboard board;
+        int root = board.Repeat(Line(board, 0, 0, 10, 1, EaseInQuad), 4, true);
+        WP_CHECK(board.Duration(root) == 4);
+
+        Compiled c(board.Compile(root));
+        for (int i = 1; i < 64; ++i) {
+            double u = i / 64.0;
+            WP_CHECK_NEAR(c->Sample(0, u), 10 * u * u, 1e-12);
+            WP_CHECK_NEAR(c->Sample(0, 1 + u), 10 * (1 - u) * (1 - u), 1e-12);
+            WP_CHECK_NEAR(c->Sample(0, 2 + u), 10 * u * u, 1e-12);
+            WP_CHECK_NEAR(c->Sample(0, 3 + u), 10 * (1 - u) * (1 - u), 1e-12);
+        }
+        WP_CHECK(c->Sample(0, 1) == 10 && c->Sample(0, 2) == 0 && c->Sample(0, 4) == 0);
+    }
+
+    /// <summary>
+    /// A reversed node at time t is the original at duration - t, holds
+    /// and eased segments alike
+    /// </summary>
+    void ReverseIsTheMirrorImage() {
+        Storyboard board;
+        double times[] = { 0, 0.5, 1, 2 };
+        double values[] = { 0, 4, 6, 10 };
+        int curves[] = { EaseLinear, EaseInQuad, HoldCurve, EaseOutBounce };
+        int clip = board.Clip(0, times, values, curves, 4);
+        int reverse = board.Reverse(clip);
+        WP_CHECK(board.Duration(reverse) == 2);
+
+        Compiled forward(board.Compile(clip));
+        Compiled backward(board.Compile(reverse));
+        for (int i = -8; i <= 136; ++i) {
+            double t = i / 64.0;
+            WP_CHECK_NEAR(backward->Sample(0, t), forward->Sample(0, 2 - t), 1e-12);
+        }
+        WP_CHECK(forward->Sample(0, 0.75) == 4 && backward->Sample(0, 1.25) == 4);
+
+        // Reversing twice plays forward again, and a delay shifts it
+        Compiled twice(board.Compile(board.Reverse(reverse)));
+        Compiled delayed(board.Compile(board.Delay(reverse, 0.5)));
+        for (int i = 0; i <= 64; ++i) {
+            double t = i / 32.0;
+            WP_CHECK(twice->Sample(0, t) == forward->Sample(0, t));
+            WP_CHECK(delayed->Sample(0, t + 0.5) == backward->Sample(0, t));
+        }
+    }
+
+    void LaterClipsCutEarlierOnes() {
+        Storyboard board;
+        int items[] = { Line(board, 0, 0, 20, 2), board.Delay(Line(board, 0, 100, 200, 1), 1) };
+        Compiled c(board.Compile(board.Parallel(items, 2)));
+        WP_CHECK(c->TrackCount() == 1 && c->KeyCount() == 3);
+        // The first clip's end is dropped, so it holds 0 until the second starts
+        WP_CHECK(c->Sample(0, 0.5) == 0);
+        WP_CHECK(c->Sample(0, 1) == 100);
+        WP_CHECK_NEAR(c->Sample(0, 1.5), 150, 1e-12);
+    }
+
+    /// <summary>
+    /// Locate finds the last key at or before t, the later of keys sharing
+    /// a time, and Covers agrees with it for every key of every track
+    /// </summary>
+    void LocateAndCoversAgree() {
+        Storyboard board;
+        double times0[] = { 0, 1, 1, 2, 4 }, values0[] = { 0, 1, 2, 3, 4 };
+        double times1[] = { 0.5, 3 }, values1[] = { 0, 1 };
+        int items[] = { board.Clip(0, times0, values0, 0, 5), board.Clip(1, times1, values1, 0, 2) };
+        Compiled c(board.Compile(board.Parallel(items, 2)));
+        WP_CHECK(c->FirstKey(0) == 0 && c->EndKey(0) == 5 && c->FirstKey(1) == 5 && c->EndKey(1) == 7);
+
+        static const double at[] = { -1, 0, 0.5, 1, 1.5, 2, 3.9, 4, 9 };
+        static const int expected[] = { 0, 0, 0, 2, 2, 3, 3, 4, 4 };
+        for (int k = 0; k < 9; ++k)
+            WP_CHECK(c->Locate(0, at[k]) == expected[k]);
+        WP_CHECK(c->Locate(1, 0) == 5 && c->Locate(1, 0.5) == 5 && c->Locate(1, 3) == 6 && c->Locate(1, 1e9) == 6);
+        WP_CHECK_NEAR(c->Sample(0, 1.5), 2.5, 1e-12);
+
+        for (int i = -8; i <= 40; ++i) {
+            double t = i / 8.0;
+            for (int track = 0; track < 2; ++track) {
+                int found = c->Locate(track, t);
+                for (int key = -1; key <= c->KeyCount(); ++key)
+                    WP_CHECK(c->Covers(track, key, t) == (key == found));
+            }
+        }
+    }
+
+    void CursorMatchesSampleAll() {
+        Storyboard board;
+        int a = board.Repeat(Line(board, 0, 0, 1, 0.3, EaseInOutCubic), 5, true);
+        int b = Line(board, 1, -1, 1, 1.7, EaseOutCubic);
+        int items[] = { a, board.Delay(b, 0.2) };
+        Compiled c(board.Compile(board.Parallel(items, 2)));
+        TimelineCursor cursor(*c);
+        double expected[2], actual[2];
+
+        // Frames forward, then seeks back and forth
+        for (int frame = -2; frame < 130; ++frame) {
+            double t = frame / 60.0;
+            c->SampleAll(t, expected);
+            cursor.Sample(*c, t, actual);
+            WP_CHECK(actual[0] == expected[0] && actual[1] == expected[1]);
+        }
+        static const double seeks[] = { 0.7, 0.1, 1.9, 1.2, -1, 5, 0.3, 0.6 };
+        for (int k = 0; k < 8; ++k) {
+            c->SampleAll(seeks[k], expected);
+            cursor.Sample(*c, seeks[k], actual);
+            WP_CHECK(actual[0] == expected[0] && actual[1] == expected[1]);
+        }
+    }
+
+    TestRegistration sequence("timeline/sequence-plays-one-after-another", &SequencePlaysOneAfterAnother);
+    TestRegistration parallel("timeline/parallel-starts-together", &ParallelStartsTogether);
+    TestRegistration stagger("timeline/stagger-offsets-each-node", &StaggerOffsetsEachNode);
+    TestRegistration repeat("timeline/repeat-restarts-each-pass", &RepeatRestartsEachPass);
+    TestRegistration alternate("timeline/alternate-mirrors-every-other-pass", &AlternateMirrorsEveryOtherPass);
+    TestRegistration reverse("timeline/reverse-is-the-mirror-image", &ReverseIsTheMirrorImage);
+    TestRegistration cut("timeline/later-clips-cut-earlier-ones", &LaterClipsCutEarlierOnes);
+    TestRegistration locate("timeline/locate-and-covers-agree", &LocateAndCoversAgree);
+    TestRegistration cursor("timeline/cursor-matches-sample-all", &CursorMatchesSampleAll);
+}
@@ -1,4 +1,6 @@
 #include "pch.h"
 
 #include "WPControls.h"
+#include "Interfaces/IAnimationProvider.h"
+#include "Services/ServiceLocator.h"
 
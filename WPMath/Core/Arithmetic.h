@@ -0,0 +1,229 @@
+#pragma once
+
+#include "../Native/Summation.h"
+#include "Fixed.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// How long sums such as dot products, traces and matrix products are
+        /// accumulated. Every mode accumulates in double, except that Int32
+        /// and Fixed sums and dot products are accumulated exactly in 64-bit
+        /// integers whatever the mode and rounded to double once.
+        /// </summary>
+        public enum class Summation {
+            /// <summary>Plain summation; fastest, error grows with the length</summary>
+            Naive,
+            /// <summary>Compensated (Kahan-Neumaier) summation, with the
+            /// rounding error of double products included; as accurate as
+            /// computing in twice the precision, at a few times the cost</summary>
+            Kahan,
+            /// <summary>Pairwise summation; error grows with the logarithm of
+            /// the length at nearly naive speed</summary>
+            Pairwise
+        };
+
+        /// <summary>
+        /// Element arithmetic for the generic containers. Generic code cannot
+        /// use operators on T, so each operation dispatches on the element
+        /// type instead: double and float run native kernels accumulating in
+        /// double, Int32 and Fixed accumulate exactly in 64-bit integers and
+        /// throw OverflowException when an element-typed result does not fit,
+        /// and any other convertible type goes through double. The type tests
+        /// fold away when the JIT specializes for a value type.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        private ref class Arithmetic abstract sealed {
+        private:
+            static T FromExact(int value) {
+                if (T::typeid == Fixed::typeid)
+                    return safe_cast<T>(Fixed::FromRaw(value));
+                return safe_cast<T>(value);
+            }
+
+            static array<double>^ ToDoubles(Array^ source, long long offset, long long stride, int n) {
+                array<double>^ result = gcnew array<double>(n);
+                int cols = source->Rank == 2 ? source->GetLength(1) : 1;
+                for (int i = 0; i < n; i++) {
+                    long long flat = offset + i * stride;
+                    Object^ value = source->Rank == 2 ? source->GetValue((int)(flat / cols), (int)(flat % cols)) : source->GetValue(flat);
+                    result[i] = ToDouble(safe_cast<T>(value));
+                }
+                return result;
+            }
+
+            static double DotDouble(array<T>^ x, array<T>^ y, int n, Native::SummationMode mode) {
+                if (T::typeid == Double::typeid) {
+                    pin_ptr<double> px = &safe_cast<array<double>^>((Object^)x)[0];
+                    pin_ptr<double> py = &safe_cast<array<double>^>((Object^)y)[0];
+                    return Native::DotStrided<double>(px, 1, py, 1, n, mode);
+                }
+                if (T::typeid == Single::typeid) {
+                    pin_ptr<float> px = &safe_cast<array<float>^>((Object^)x)[0];
+                    pin_ptr<float> py = &safe_cast<array<float>^>((Object^)y)[0];
+                    return Native::DotStrided<float>(px, 1, py, 1, n, mode);
+                }
+                // Integer products are summed exactly; the mode does not apply
+                if (T::typeid == Int32::typeid) {
+                    pin_ptr<int> px = &safe_cast<array<int>^>((Object^)x)[0];
+                    pin_ptr<int> py = &safe_cast<array<int>^>((Object^)y)[0];
+                    return Native::DotExactDouble(px, 1, py, 1, n, 0);
+                }
+                if (T::typeid == Fixed::typeid) {
+                    pin_ptr<Fixed> px = &safe_cast<array<Fixed>^>((Object^)x)[0];
+                    pin_ptr<Fixed> py = &safe_cast<array<Fixed>^>((Object^)y)[0];
+                    return Native::DotExactDouble(reinterpret_cast<const int*>(px), 1, reinterpret_cast<const int*>(py), 1, n,
+                                                  2 * Fixed::FractionBits);
+                }
+
+                array<double>^ dx = ToDoubles(x, 0, 1, n);
+                array<double>^ dy = ToDoubles(y, 0, 1, n);
+                pin_ptr<double> px = &dx[0], py = &dy[0];
+                return Native::DotStrided<double>(px, 1, py, 1, n, mode);
+            }
+
+            static double SumDouble(array<T, 2>^ storage, long long offset, long long stride, int n, Native::SummationMode mode) {
+                if (T::typeid == Double::typeid) {
+                    pin_ptr<double> p = &safe_cast<array<double, 2>^>((Object^)storage)[0, 0];
+                    return Native::SumStrided<double>(p + offset, stride, n, mode);
+                }
+                if (T::typeid == Single::typeid) {
+                    pin_ptr<float> p = &safe_cast<array<float, 2>^>((Object^)storage)[0, 0];
+                    return Native::SumStrided<float>(p + offset, stride, n, mode);
+                }
+                if (T::typeid == Int32::typeid) {
+                    pin_ptr<int> p = &safe_cast<array<int, 2>^>((Object^)storage)[0, 0];
+                    return (double)Native::SumExact(p + offset, stride, n);
+                }
+                if (T::typeid == Fixed::typeid) {
+                    pin_ptr<Fixed> p = &safe_cast<array<Fixed, 2>^>((Object^)storage)[0, 0];
+                    return Native::SumExact(reinterpret_cast<const int*>(p) + offset, stride, n) / 65536.0;
+                }
+
+                array<double>^ values = ToDoubles(storage, offset, stride, n);
+                pin_ptr<double> p = &values[0];
+                return Native::SumStrided<double>(p, 1, n, mode);
+            }
+
+        public:
+            /// <summary>
+            /// Converts an element to double
+            /// </summary>
+            static double ToDouble(T value) {
+                if (T::typeid == Double::typeid)
+                    return safe_cast<double>(value);
+                if (T::typeid == Single::typeid)
+                    return safe_cast<float>(value);
+                if (T::typeid == Int32::typeid)
+                    return safe_cast<int>(value);
+                if (T::typeid == Fixed::typeid)
+                    return safe_cast<Fixed>(value).ToDouble();
+                return Convert::ToDouble((Object^)value);
+            }
+
+            /// <summary>
+            /// Converts a double to an element, rounding integers to nearest
+            /// and throwing OverflowException when out of range
+            /// </summary>
+            static T FromDouble(double value) {
+                if (T::typeid == Double::typeid)
+                    return safe_cast<T>(value);
+                if (T::typeid == Single::typeid)
+                    return safe_cast<T>((float)value);
+                if (T::typeid == Int32::typeid)
+                    return safe_cast<T>(Convert::ToInt32(value));
+                if (T::typeid == Fixed::typeid)
+                    return safe_cast<T>(Fixed::FromDouble(value));
+                return safe_cast<T>(Convert::ChangeType(value, T::typeid));
+            }
+
+            /// <summary>
+            /// Gets the element one
+            /// </summary>
+            static property T One {
+                T get() {
+                    if (T::typeid == Fixed::typeid)
+                        return safe_cast<T>(Fixed(1));
+                    return FromDouble(1);
+                }
+            }
+
+            /// <summary>
+            /// Calculates the dot product of the first n elements, accumulated
+            /// in double and rounded once, or exactly for Int32 and Fixed
+            /// </summary>
+            static T Dot(array<T>^ x, array<T>^ y, int n) {
+                if (n == 0)
+                    return T();
+                int result;
+                bool fits;
+                if (T::typeid == Int32::typeid) {
+                    pin_ptr<int> px = &safe_cast<array<int>^>((Object^)x)[0];
+                    pin_ptr<int> py = &safe_cast<array<int>^>((Object^)y)[0];
+                    fits = Native::DotExact(px, 1, py, 1, n, 0, &result);
+                }
+                else if (T::typeid == Fixed::typeid) {
+                    pin_ptr<Fixed> px = &safe_cast<array<Fixed>^>((Object^)x)[0];
+                    pin_ptr<Fixed> py = &safe_cast<array<Fixed>^>((Object^)y)[0];
+                    fits = Native::DotExact(reinterpret_cast<const int*>(px), 1, reinterpret_cast<const int*>(py), 1, n,
+                                            Fixed::FractionBits, &result);
+                }
+                else {
+                    return FromDouble(DotDouble(x, y, n, Native::SumNaive));
+                }
+                if (!fits)
+                    throw gcnew OverflowException("Dot product is out of range for the element type");
+                return FromExact(result);
+            }
+
+            /// <summary>
+            /// Calculates the dot product of the first n elements in double
+            /// with the given summation; Int32 and Fixed are summed exactly
+            /// and rounded once
+            /// </summary>
+            static double Dot(array<T>^ x, array<T>^ y, int n, Summation summation) {
+                if (n == 0)
+                    return 0;
+                return DotDouble(x, y, n, (Native::SummationMode)summation);
+            }
+
+            /// <summary>
+            /// Sums n elements of a row-major storage starting at flat
+            /// position offset and stepping by stride, in double and rounded
+            /// once, or exactly for Int32 and Fixed
+            /// </summary>
+            static T Sum(array<T, 2>^ storage, long long offset, long long stride, int n) {
+                if (n == 0)
+                    return T();
+                long long sum;
+                if (T::typeid == Int32::typeid) {
+                    pin_ptr<int> p = &safe_cast<array<int, 2>^>((Object^)storage)[0, 0];
+                    sum = Native::SumExact(p + offset, stride, n);
+                }
+                else if (T::typeid == Fixed::typeid) {
+                    pin_ptr<Fixed> p = &safe_cast<array<Fixed, 2>^>((Object^)storage)[0, 0];
+                    sum = Native::SumExact(reinterpret_cast<const int*>(p) + offset, stride, n);
+                }
+                else {
+                    return FromDouble(SumDouble(storage, offset, stride, n, Native::SumNaive));
+                }
+                if (sum > Int32::MaxValue || sum < Int32::MinValue)
+                    throw gcnew OverflowException("Sum is out of range for the element type");
+                return FromExact((int)sum);
+            }
+
+            /// <summary>
+            /// Sums n strided elements in double with the given summation;
+            /// Int32 and Fixed are summed exactly and rounded once
+            /// </summary>
+            static double Sum(array<T, 2>^ storage, long long offset, long long stride, int n, Summation summation) {
+                if (n == 0)
+                    return 0;
+                return SumDouble(storage, offset, stride, n, (Native::SummationMode)summation);
+            }
+        };
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Per-thread counts of the element buffers WPMath allocates: every
+        /// Matrix and Vector constructed and every array the BufferPool has to
+        /// create because none was free. Reset at the start of a frame and
+        /// check Arrays at the end to assert that the frame allocated nothing.
+        /// </summary>
+        public ref class AllocationCounters abstract sealed {
+        private:
+            [ThreadStatic] static long long arrays;
+            [ThreadStatic] static long long elements;
+            [ThreadStatic] static long long rented;
+
+        internal:
+            static void Record(long long length) {
+                arrays++;
+                elements += length;
+            }
+
+            static void RecordRent() {
+                rented++;
+            }
+
+        public:
+            /// <summary>
+            /// Gets the number of element buffers allocated on this thread
+            /// </summary>
+            static property long long Arrays {
+                long long get() { return arrays; }
+            }
+
+            /// <summary>
+            /// Gets the total length of those buffers
+            /// </summary>
+            static property long long Elements {
+                long long get() { return elements; }
+            }
+
+            /// <summary>
+            /// Gets the number of arrays rented from the BufferPool on this
+            /// thread, including those it had to allocate
+            /// </summary>
+            static property long long Rented {
+                long long get() { return rented; }
+            }
+
+            /// <summary>
+            /// Sets the counters of this thread to zero
+            /// </summary>
+            static void Reset() {
+                arrays = elements = rented = 0;
+            }
+        };
+
+        /// <summary>
+        /// A per-thread pool of one-dimensional arrays for temporaries. Lengths
+        /// are rounded up to a power of two, so a rented array may be longer
+        /// than requested; contents are not cleared. Matrix and vector
+        /// operations rent their scratch buffers here, so after the first call
+        /// of each size they allocate nothing but their results, and nothing at
+        /// all through the overloads writing into a caller-provided result.
+        /// </summary>
+        public ref class BufferPool abstract sealed {
+        private:
+            literal int MaxBucket = 30;
+            literal int MaxRetained = 16;
+
+            // Free arrays by element type, then by log2 of the length
+            [ThreadStatic] static Dictionary<Type^, array<Stack<Array^>^>^>^ pools;
+
+            static Stack<Array^>^ Bucket(Type^ type, int bucket) {
+                if (pools == nullptr)
+                    pools = gcnew Dictionary<Type^, array<Stack<Array^>^>^>();
+                array<Stack<Array^>^>^ buckets;
+                if (!pools->TryGetValue(type, buckets)) {
+                    buckets = gcnew array<Stack<Array^>^>(MaxBucket + 1);
+                    pools->Add(type, buckets);
+                }
+                if (buckets[bucket] == nullptr)
+                    buckets[bucket] = gcnew Stack<Array^>(MaxRetained);
+                return buckets[bucket];
+            }
+
+            static int Log2Ceiling(int length) {
+                int bucket = 0;
+                while ((1 << bucket) < length)
+                    bucket++;
+                return bucket;
+            }
+
+        internal:
+            /// <summary>
+            /// Returns a rented array of any element type
+            /// </summary>
+            static void ReturnArray(Array^ buffer) {
+                if (buffer == nullptr)
+                    return;
+                int length = buffer->Length;
+                if (buffer->Rank != 1 || length == 0 || length > (1 << MaxBucket) || (length & (length - 1)) != 0)
+                    throw gcnew ArgumentException("Array was not rented from the pool", "buffer");
+                int bucket = Log2Ceiling(length);
+
+                Stack<Array^>^ free = Bucket(buffer->GetType()->GetElementType(), bucket);
+                if (free->Count < MaxRetained)
+                    free->Push(buffer);
+            }
+
+        public:
+            /// <summary>
+            /// Rents an array of at least minimumLength elements from this
+            /// thread's pool. Return it when done.
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static array<T>^ Rent(int minimumLength) {
+                if (minimumLength < 0 || minimumLength > (1 << MaxBucket))
+                    throw gcnew ArgumentOutOfRangeException("minimumLength");
+
+                AllocationCounters::RecordRent();
+                int bucket = Log2Ceiling(System::Math::Max(minimumLength, 1));
+                Stack<Array^>^ free = Bucket(T::typeid, bucket);
+                if (free->Count > 0)
+                    return safe_cast<array<T>^>(free->Pop());
+
+                AllocationCounters::Record(1LL << bucket);
+                return gcnew array<T>(1 << bucket);
+            }
+
+            /// <summary>
+            /// Returns a rented array to this thread's pool. Null is ignored;
+            /// arrays beyond the few kept per size are left to the collector.
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static void Return(array<T>^ buffer) {
+                ReturnArray(buffer);
+            }
+
+            /// <summary>
+            /// Drops every free array held for this thread
+            /// </summary>
+            static void Trim() {
+                pools = nullptr;
+            }
+        };
+    }
+}
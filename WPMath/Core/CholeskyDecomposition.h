@@ -0,0 +1,120 @@
+#pragma once
+
+#include "../Native/Factorization.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Cholesky factorization (A = L * L^T) of a symmetric positive definite
+        /// matrix. Half the work of LU and no pivoting.
+        /// </summary>
+        public ref class CholeskyDecomposition {
+        private:
+            array<double>^ l;
+            int n;
+
+            CholeskyDecomposition(array<double>^ factors, int size) {
+                l = factors;
+                n = size;
+            }
+
+        public:
+            /// <summary>
+            /// Factors a symmetric positive definite matrix. Only the lower
+            /// triangle is read.
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static CholeskyDecomposition^ Factor(Matrix<T>^ matrix) {
+                CholeskyDecomposition^ result;
+                if (!TryFactor(matrix, result))
+                    throw gcnew ArgumentException("Matrix is not symmetric positive definite");
+                return result;
+            }
+
+            /// <summary>
+            /// Attempts to factor a matrix; returns false if it is not positive
+            /// definite
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static bool TryFactor(Matrix<T>^ matrix, [Runtime::InteropServices::Out] CholeskyDecomposition^% result) {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                result = nullptr;
+                int size = matrix->Rows;
+                array<double>^ data = matrix->ToRowMajorDouble();
+                if (size > 0) {
+                    pin_ptr<double> pa = &data[0];
+                    if (!Native::CholeskyFactor(pa, size))
+                        return false;
+                }
+                result = gcnew CholeskyDecomposition(data, size);
+                return true;
+            }
+
+            /// <summary>
+            /// Gets the order of the factored matrix
+            /// </summary>
+            property int Size {
+                int get() { return n; }
+            }
+
+            /// <summary>
+            /// Gets the determinant of the factored matrix
+            /// </summary>
+            property double Determinant {
+                double get() {
+                    double det = 1;
+                    for (int i = 0; i < n; i++)
+                        det *= l[i * n + i] * l[i * n + i];
+                    return det;
+                }
+            }
+
+            /// <summary>
+            /// Solves A * x = b
+            /// </summary>
+            Vector<double>^ Solve(Vector<double>^ b) {
+                if (b->Size != n)
+                    throw gcnew ArgumentException("Vector size does not match the matrix");
+
+                Vector<double>^ x = gcnew Vector<double>(b->Elements);
+                if (n == 0)
+                    return x;
+
+                pin_ptr<double> pl = &l[0];
+                pin_ptr<double> px = &x->Elements[0];
+                Native::CholeskySolve(pl, n, px, 1);
+                return x;
+            }
+
+            /// <summary>
+            /// Solves A * X = B for every column of B at once
+            /// </summary>
+            Matrix<double>^ Solve(Matrix<double>^ b) {
+                if (b->Rows != n)
+                    throw gcnew ArgumentException("Matrix row count does not match the factored matrix");
+
+                Matrix<double>^ x = gcnew Matrix<double>(b->Elements);
+                if (n == 0 || b->Columns == 0)
+                    return x;
+
+                pin_ptr<double> pl = &l[0];
+                pin_ptr<double> px = &x->Elements[0, 0];
+                Native::CholeskySolve(pl, n, px, b->Columns);
+                return x;
+            }
+
+            /// <summary>
+            /// Calculates the inverse of the factored matrix
+            /// </summary>
+            Matrix<double>^ Inverse() {
+                return Solve(Matrix<double>::Identity(n));
+            }
+        };
+    }
+}
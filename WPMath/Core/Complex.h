@@ -117,12 +117,52 @@ namespace WindowPlus {
             }
 
             /// <summary>
-            /// Raises a complex number to a power
+            /// Raises a complex number to a power. Real exponents take the
+            /// cheaper polar or repeated-squaring paths.
             /// </summary>
             static Complex Pow(Complex base, Complex exponent) {
+                if (exponent.imaginary == 0)
+                    return Pow(base, exponent.real);
+                if (base.real == 0 && base.imaginary == 0)
+                    return Complex(0, 0);
                 return Exp(Log(base) * exponent);
             }
 
+            /// <summary>
+            /// Raises a complex number to a real power using polar form: one
+            /// Pow, one Atan2 and one Sin/Cos pair instead of Exp(Log(z) * p)
+            /// </summary>
+            static Complex Pow(Complex base, double exponent) {
+                if (exponent == System::Math::Floor(exponent) && System::Math::Abs(exponent) <= 64)
+                    return Pow(base, (int)exponent);
+                if (base.real == 0 && base.imaginary == 0)
+                    return exponent > 0 ? Complex(0, 0) : Complex(Double::NaN, Double::NaN);
+
+                double magnitude = System::Math::Pow(base.Magnitude, exponent);
+                double angle = base.Phase * exponent;
+                return Complex(magnitude * System::Math::Cos(angle), magnitude * System::Math::Sin(angle));
+            }
+
+            /// <summary>
+            /// Raises a complex number to an integer power by repeated squaring,
+            /// with no transcendental calls
+            /// </summary>
+            static Complex Pow(Complex base, int exponent) {
+                long long e = exponent;
+                bool invert = e < 0;
+                if (invert)
+                    e = -e;
+
+                Complex result(1, 0);
+                while (e > 0) {
+                    if (e & 1)
+                        result = result * base;
+                    base = base * base;
+                    e >>= 1;
+                }
+                return invert ? Complex(1, 0) / result : result;
+            }
+
             /// <summary>
             /// Converts the complex number to string representation
             /// </summary>
@@ -0,0 +1,426 @@
+#pragma once
+
+#include "../Native/ComplexKernels.h"
+#include "../Native/Transcendental.h"
+#include "Complex.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// An array of complex numbers stored interleaved as (re, im) doubles,
+        /// the layout the FFT consumes. Arithmetic runs over the whole array in
+        /// native kernels and writes into a caller-provided result, which may be
+        /// one of the operands.
+        /// </summary>
+        public ref class ComplexArray {
+        private:
+            array<double>^ data;
+            int length;
+
+            static void CheckPair(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result) {
+                if (a == nullptr || b == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : b == nullptr ? "b" : "result");
+                if (a->length != b->length || a->length != result->length)
+                    throw gcnew ArgumentException("Arrays must have the same length");
+            }
+
+            static void CheckSingle(ComplexArray^ a, ComplexArray^ result) {
+                if (a == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : "result");
+                if (a->length != result->length)
+                    throw gcnew ArgumentException("Arrays must have the same length");
+            }
+
+            static void AddNative(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result, bool subtract) {
+                CheckPair(a, b, result);
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> pa = &a->data[0];
+                pin_ptr<double> pb = &b->data[0];
+                pin_ptr<double> pr = &result->data[0];
+                Native::ComplexAdd(pa, pb, pr, a->length, subtract);
+            }
+
+            static void MultiplyNative(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result, bool conjugate) {
+                CheckPair(a, b, result);
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> pa = &a->data[0];
+                pin_ptr<double> pb = &b->data[0];
+                pin_ptr<double> pr = &result->data[0];
+                Native::ComplexMultiply(pa, pb, pr, a->length, conjugate);
+            }
+
+            static void MagnitudeNative(ComplexArray^ a, array<double>^ result, bool squared) {
+                if (a == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : "result");
+                if (result->Length < a->length)
+                    throw gcnew ArgumentException("Result buffer is shorter than the array", "result");
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> pa = &a->data[0];
+                pin_ptr<double> pr = &result[0];
+                Native::ComplexMagnitude(pa, pr, a->length, squared);
+            }
+
+        internal:
+            /// <summary>
+            /// Gets the interleaved backing storage without copying
+            /// </summary>
+            property array<double>^ Data {
+                array<double>^ get() { return data; }
+            }
+
+        public:
+            /// <summary>
+            /// Creates a zeroed array with specified length
+            /// </summary>
+            ComplexArray(int length) {
+                if (length < 0)
+                    throw gcnew ArgumentOutOfRangeException("length");
+                this->length = length;
+                data = gcnew array<double>(2 * length);
+            }
+
+            /// <summary>
+            /// Creates an array from complex values
+            /// </summary>
+            ComplexArray(array<Complex>^ values) {
+                length = values->Length;
+                data = gcnew array<double>(2 * length);
+                for (int i = 0; i < length; i++) {
+                    data[2 * i] = values[i].Real;
+                    data[2 * i + 1] = values[i].Imaginary;
+                }
+            }
+
+            /// <summary>
+            /// Gets the number of complex values
+            /// </summary>
+            property int Length {
+                int get() { return length; }
+            }
+
+            /// <summary>
+            /// Gets or sets value at specified index
+            /// </summary>
+            property Complex default[int] {
+                Complex get(int index) {
+                    if (index < 0 || index >= length)
+                        throw gcnew ArgumentOutOfRangeException("index");
+                    return Complex(data[2 * index], data[2 * index + 1]);
+                }
+                void set(int index, Complex value) {
+                    if (index < 0 || index >= length)
+                        throw gcnew ArgumentOutOfRangeException("index");
+                    data[2 * index] = value.Real;
+                    data[2 * index + 1] = value.Imaginary;
+                }
+            }
+
+            /// <summary>
+            /// Copies the values into a new array
+            /// </summary>
+            array<Complex>^ ToArray() {
+                array<Complex>^ result = gcnew array<Complex>(length);
+                for (int i = 0; i < length; i++)
+                    result[i] = Complex(data[2 * i], data[2 * i + 1]);
+                return result;
+            }
+
+            /// <summary>
+            /// Computes result = a + b element by element
+            /// </summary>
+            static void Add(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result) {
+                AddNative(a, b, result, false);
+            }
+
+            /// <summary>
+            /// Computes result = a - b element by element
+            /// </summary>
+            static void Subtract(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result) {
+                AddNative(a, b, result, true);
+            }
+
+            /// <summary>
+            /// Computes result = a * b element by element
+            /// </summary>
+            static void Multiply(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result) {
+                MultiplyNative(a, b, result, false);
+            }
+
+            /// <summary>
+            /// Computes result = a * conj(b) element by element, the
+            /// cross-spectrum step of correlation
+            /// </summary>
+            static void MultiplyConjugate(ComplexArray^ a, ComplexArray^ b, ComplexArray^ result) {
+                MultiplyNative(a, b, result, true);
+            }
+
+            /// <summary>
+            /// Computes result = a * scale element by element
+            /// </summary>
+            static void Scale(ComplexArray^ a, double scale, ComplexArray^ result) {
+                CheckSingle(a, result);
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> pa = &a->data[0];
+                pin_ptr<double> pr = &result->data[0];
+                Native::ComplexScale(pa, pr, a->length, scale);
+            }
+
+            /// <summary>
+            /// Computes result = conj(a) element by element
+            /// </summary>
+            static void Conjugate(ComplexArray^ a, ComplexArray^ result) {
+                CheckSingle(a, result);
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> pa = &a->data[0];
+                pin_ptr<double> pr = &result->data[0];
+                Native::ComplexConjugate(pa, pr, a->length, 1.0);
+            }
+
+            /// <summary>
+            /// Writes |a[i]| into result
+            /// </summary>
+            static void Magnitude(ComplexArray^ a, array<double>^ result) {
+                MagnitudeNative(a, result, false);
+            }
+
+            /// <summary>
+            /// Writes |a[i]|^2 into result, the power spectrum of a transform
+            /// </summary>
+            static void SquaredMagnitude(ComplexArray^ a, array<double>^ result) {
+                MagnitudeNative(a, result, true);
+            }
+        };
+
+        /// <summary>
+        /// An array of complex numbers stored as separate real and imaginary
+        /// arrays. Every operation is a straight SIMD loop, so this layout is
+        /// the faster one for long element-wise chains.
+        /// </summary>
+        public ref class SplitComplexArray {
+        private:
+            array<double>^ real;
+            array<double>^ imaginary;
+            int length;
+
+            static void CheckPair(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result) {
+                if (a == nullptr || b == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : b == nullptr ? "b" : "result");
+                if (a->length != b->length || a->length != result->length)
+                    throw gcnew ArgumentException("Arrays must have the same length");
+            }
+
+            static void AddNative(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result, bool subtract) {
+                CheckPair(a, b, result);
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> ar = &a->real[0], ai = &a->imaginary[0];
+                pin_ptr<double> br = &b->real[0], bi = &b->imaginary[0];
+                pin_ptr<double> rr = &result->real[0], ri = &result->imaginary[0];
+                Native::SplitAdd(ar, ai, br, bi, rr, ri, a->length, subtract);
+            }
+
+            static void MultiplyNative(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result, bool conjugate) {
+                CheckPair(a, b, result);
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> ar = &a->real[0], ai = &a->imaginary[0];
+                pin_ptr<double> br = &b->real[0], bi = &b->imaginary[0];
+                pin_ptr<double> rr = &result->real[0], ri = &result->imaginary[0];
+                Native::SplitMultiply(ar, ai, br, bi, rr, ri, a->length, conjugate);
+            }
+
+            static void MagnitudeNative(SplitComplexArray^ a, array<double>^ result, bool squared) {
+                if (a == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : "result");
+                if (result->Length < a->length)
+                    throw gcnew ArgumentException("Result buffer is shorter than the array", "result");
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> ar = &a->real[0], ai = &a->imaginary[0];
+                pin_ptr<double> pr = &result[0];
+                Native::SplitMagnitude(ar, ai, pr, a->length, squared);
+            }
+
+        public:
+            /// <summary>
+            /// Creates a zeroed array with specified length
+            /// </summary>
+            SplitComplexArray(int length) {
+                if (length < 0)
+                    throw gcnew ArgumentOutOfRangeException("length");
+                this->length = length;
+                real = gcnew array<double>(length);
+                imaginary = gcnew array<double>(length);
+            }
+
+            /// <summary>
+            /// Creates an array from copies of the real and imaginary parts
+            /// </summary>
+            SplitComplexArray(array<double>^ real, array<double>^ imaginary) {
+                if (real->Length != imaginary->Length)
+                    throw gcnew ArgumentException("Real and imaginary parts must have the same length");
+                length = real->Length;
+                this->real = safe_cast<array<double>^>(real->Clone());
+                this->imaginary = safe_cast<array<double>^>(imaginary->Clone());
+            }
+
+            /// <summary>
+            /// Gets the number of complex values
+            /// </summary>
+            property int Length {
+                int get() { return length; }
+            }
+
+            /// <summary>
+            /// Gets the real parts. The array is the live storage, not a copy.
+            /// </summary>
+            property array<double>^ Real {
+                array<double>^ get() { return real; }
+            }
+
+            /// <summary>
+            /// Gets the imaginary parts. The array is the live storage, not a copy.
+            /// </summary>
+            property array<double>^ Imaginary {
+                array<double>^ get() { return imaginary; }
+            }
+
+            /// <summary>
+            /// Gets or sets value at specified index
+            /// </summary>
+            property Complex default[int] {
+                Complex get(int index) {
+                    if (index < 0 || index >= length)
+                        throw gcnew ArgumentOutOfRangeException("index");
+                    return Complex(real[index], imaginary[index]);
+                }
+                void set(int index, Complex value) {
+                    if (index < 0 || index >= length)
+                        throw gcnew ArgumentOutOfRangeException("index");
+                    real[index] = value.Real;
+                    imaginary[index] = value.Imaginary;
+                }
+            }
+
+            /// <summary>
+            /// Converts from the interleaved layout
+            /// </summary>
+            static SplitComplexArray^ FromInterleaved(ComplexArray^ source) {
+                SplitComplexArray^ result = gcnew SplitComplexArray(source->Length);
+                if (source->Length == 0)
+                    return result;
+                pin_ptr<double> ps = &source->Data[0];
+                pin_ptr<double> rr = &result->real[0], ri = &result->imaginary[0];
+                Native::Deinterleave(ps, rr, ri, source->Length);
+                return result;
+            }
+
+            /// <summary>
+            /// Converts to the interleaved layout
+            /// </summary>
+            ComplexArray^ ToInterleaved() {
+                ComplexArray^ result = gcnew ComplexArray(length);
+                if (length == 0)
+                    return result;
+                pin_ptr<double> pr = &real[0], pi = &imaginary[0];
+                pin_ptr<double> pd = &result->Data[0];
+                Native::Interleave(pr, pi, pd, length);
+                return result;
+            }
+
+            /// <summary>
+            /// Computes result = a + b element by element
+            /// </summary>
+            static void Add(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result) {
+                AddNative(a, b, result, false);
+            }
+
+            /// <summary>
+            /// Computes result = a - b element by element
+            /// </summary>
+            static void Subtract(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result) {
+                AddNative(a, b, result, true);
+            }
+
+            /// <summary>
+            /// Computes result = a * b element by element
+            /// </summary>
+            static void Multiply(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result) {
+                MultiplyNative(a, b, result, false);
+            }
+
+            /// <summary>
+            /// Computes result = a * conj(b) element by element
+            /// </summary>
+            static void MultiplyConjugate(SplitComplexArray^ a, SplitComplexArray^ b, SplitComplexArray^ result) {
+                MultiplyNative(a, b, result, true);
+            }
+
+            /// <summary>
+            /// Computes result = conj(a) element by element
+            /// </summary>
+            static void Conjugate(SplitComplexArray^ a, SplitComplexArray^ result) {
+                if (a == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : "result");
+                if (a->length != result->length)
+                    throw gcnew ArgumentException("Arrays must have the same length");
+                if (a != result)
+                    Array::Copy(a->real, result->real, a->length);
+                for (int i = 0; i < a->length; i++)
+                    result->imaginary[i] = -a->imaginary[i];
+            }
+
+            /// <summary>
+            /// Writes |a[i]| into result
+            /// </summary>
+            static void Magnitude(SplitComplexArray^ a, array<double>^ result) {
+                MagnitudeNative(a, result, false);
+            }
+
+            /// <summary>
+            /// Writes |a[i]|^2 into result
+            /// </summary>
+            static void SquaredMagnitude(SplitComplexArray^ a, array<double>^ result) {
+                MagnitudeNative(a, result, true);
+            }
+
+            /// <summary>
+            /// Writes the phase angle of a[i] into result, using the batched
+            /// atan2 kernel
+            /// </summary>
+            static void Phase(SplitComplexArray^ a, array<double>^ result) {
+                if (a == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : "result");
+                if (result->Length < a->length)
+                    throw gcnew ArgumentException("Result buffer is shorter than the array", "result");
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> ar = &a->real[0], ai = &a->imaginary[0];
+                pin_ptr<double> pr = &result[0];
+                Native::VectorAtan2<double>(ai, ar, pr, a->length);
+            }
+
+            /// <summary>
+            /// Computes result = e^a element by element
+            /// </summary>
+            static void Exp(SplitComplexArray^ a, SplitComplexArray^ result) {
+                if (a == nullptr || result == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : "result");
+                if (a->length != result->length)
+                    throw gcnew ArgumentException("Arrays must have the same length");
+                if (a->length == 0)
+                    return;
+                pin_ptr<double> ar = &a->real[0], ai = &a->imaginary[0];
+                pin_ptr<double> rr = &result->real[0], ri = &result->imaginary[0];
+                Native::SplitExp(ar, ai, rr, ri, a->length);
+            }
+        };
+    }
+}
@@ -0,0 +1,713 @@
+#pragma once
+
+#include "../Native/Expression.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+using namespace System::Threading;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// What an ExpressionProgram keeps between evaluations: its native
+        /// code, a workspace for its stack depth, the operand address table
+        /// and one pin handle per operand and the destination. The handles
+        /// have no target between runs, so nothing stays pinned.
+        /// </summary>
+        private ref class ExpressionRunCache {
+        public:
+            Native::AlignedBuffer<Native::ExpressionInstruction>* Code;
+            Native::ExpressionWorkspace* Workspace;
+            const void** Inputs;
+            array<GCHandle>^ Handles;
+
+            ExpressionRunCache(array<int>^ ops, array<int>^ inputs, array<double>^ scalars, int operands, int depth) {
+                Code = new Native::AlignedBuffer<Native::ExpressionInstruction>(ops->Length);
+                for (int k = 0; k < ops->Length; k++) {
+                    Native::ExpressionInstruction ins = { ops[k], inputs[k], scalars[k] };
+                    Code->Data()[k] = ins;
+                }
+                Workspace = new Native::ExpressionWorkspace(depth);
+                Inputs = new const void*[operands];
+                Handles = gcnew array<GCHandle>(operands + 1);
+                for (int k = 0; k < Handles->Length; k++)
+                    Handles[k] = GCHandle::Alloc(nullptr, GCHandleType::Pinned);
+            }
+
+            ~ExpressionRunCache() {
+                this->!ExpressionRunCache();
+            }
+
+            !ExpressionRunCache() {
+                if (Handles != nullptr) {
+                    for (int k = 0; k < Handles->Length; k++) {
+                        if (Handles[k].IsAllocated)
+                            Handles[k].Free();
+                    }
+                    Handles = nullptr;
+                }
+                delete Code;
+                Code = nullptr;
+                delete Workspace;
+                Workspace = nullptr;
+                delete[] Inputs;
+                Inputs = nullptr;
+            }
+        };
+
+        /// <summary>
+        /// Postfix element-wise program shared by the lazy vector and matrix
+        /// expressions. Programs are immutable; combining two copies them, which
+        /// is cheap for the short chains written by hand.
+        /// </summary>
+        private ref class ExpressionProgram {
+        private:
+            array<int>^ ops;
+            array<int>^ inputs;
+            array<double>^ scalars;
+            array<Object^>^ leaves;
+            int depth;
+            ExpressionRunCache^ runCache;
+
+            ExpressionProgram(int length, array<Object^>^ leaves, int depth) {
+                ops = gcnew array<int>(length);
+                inputs = gcnew array<int>(length);
+                scalars = gcnew array<double>(length);
+                this->leaves = leaves;
+                this->depth = depth;
+            }
+
+            void CopyFrom(ExpressionProgram^ source, int at, array<int>^ leafMap) {
+                for (int k = 0; k < source->ops->Length; k++) {
+                    ops[at + k] = source->ops[k];
+                    inputs[at + k] = source->ops[k] == Native::ExprLoad ? leafMap[source->inputs[k]] : 0;
+                    scalars[at + k] = source->scalars[k];
+                }
+            }
+
+            // Pins the inputs and destination and runs the native evaluator. When
+            // destination is null the program is reduced instead. The code,
+            // workspace and handles are built on the first run and reused.
+            double Run(array<Array^>^ arrays, Array^ destination, long long count, bool squares) {
+                int length = ops->Length;
+                bool isDouble = arrays[0]->GetType()->GetElementType() == Double::typeid;
+                // Take the cache while running; a run on another thread at the
+                // same time builds its own
+                ExpressionRunCache^ cache = Interlocked::Exchange<ExpressionRunCache^>(runCache, nullptr);
+                if (cache == nullptr)
+                    cache = gcnew ExpressionRunCache(ops, inputs, scalars, arrays->Length, depth);
+                array<GCHandle>^ handles = cache->Handles;
+
+                int pinned = 0;
+                try {
+                    for (; pinned < arrays->Length; pinned++) {
+                        handles[pinned].Target = arrays[pinned];
+                        cache->Inputs[pinned] = handles[pinned].AddrOfPinnedObject().ToPointer();
+                    }
+                    void* dst = nullptr;
+                    if (destination != nullptr) {
+                        handles[pinned++].Target = destination;
+                        dst = handles[pinned - 1].AddrOfPinnedObject().ToPointer();
+                    }
+
+                    const Native::ExpressionInstruction* code = cache->Code->Data();
+                    const Native::ExpressionWorkspace& workspace = *cache->Workspace;
+                    if (isDouble) {
+                        const double* const* in = reinterpret_cast<const double* const*>(cache->Inputs);
+                        if (dst)
+                            Native::EvaluateExpression(code, length, in, count, static_cast<double*>(dst), workspace);
+                        else
+                            return Native::ReduceExpression(code, length, in, count, squares, workspace);
+                    }
+                    else {
+                        const float* const* in = reinterpret_cast<const float* const*>(cache->Inputs);
+                        if (dst)
+                            Native::EvaluateExpression(code, length, in, count, static_cast<float*>(dst), workspace);
+                        else
+                            return Native::ReduceExpression(code, length, in, count, squares, workspace);
+                    }
+                    return 0;
+                }
+                finally {
+                    for (int k = 0; k < pinned; k++)
+                        handles[k].Target = nullptr;
+                    runCache = cache;
+                }
+            }
+
+        public:
+            /// <summary>
+            /// Creates a program that loads a single operand
+            /// </summary>
+            static ExpressionProgram^ Leaf(Object^ leaf) {
+                ExpressionProgram^ result = gcnew ExpressionProgram(1, gcnew array<Object^> { leaf }, 1);
+                result->ops[0] = Native::ExprLoad;
+                return result;
+            }
+
+            /// <summary>
+            /// Creates a program evaluating a, then b, then the binary op.
+            /// Operands shared by both sides are loaded from one input slot.
+            /// </summary>
+            static ExpressionProgram^ Binary(ExpressionProgram^ a, ExpressionProgram^ b, Native::ExpressionOp op) {
+                array<Object^>^ merged = gcnew array<Object^>(a->leaves->Length + b->leaves->Length);
+                Array::Copy(a->leaves, merged, a->leaves->Length);
+                int count = a->leaves->Length;
+
+                array<int>^ mapA = gcnew array<int>(a->leaves->Length);
+                for (int i = 0; i < mapA->Length; i++)
+                    mapA[i] = i;
+                array<int>^ mapB = gcnew array<int>(b->leaves->Length);
+                for (int i = 0; i < mapB->Length; i++) {
+                    int found = Array::IndexOf(merged, b->leaves[i], 0, count);
+                    if (found < 0) {
+                        merged[count] = b->leaves[i];
+                        found = count++;
+                    }
+                    mapB[i] = found;
+                }
+                Array::Resize(merged, count);
+
+                int length = a->ops->Length + b->ops->Length + 1;
+                ExpressionProgram^ result = gcnew ExpressionProgram(length, merged,
+                                                                    System::Math::Max(a->depth, b->depth + 1));
+                result->CopyFrom(a, 0, mapA);
+                result->CopyFrom(b, a->ops->Length, mapB);
+                result->ops[length - 1] = op;
+                return result;
+            }
+
+            /// <summary>
+            /// Creates a program applying a unary or scalar op to this one
+            /// </summary>
+            ExpressionProgram^ Unary(Native::ExpressionOp op, double scalar) {
+                int length = ops->Length + 1;
+                ExpressionProgram^ result = gcnew ExpressionProgram(length, leaves, depth);
+                array<int>^ map = gcnew array<int>(leaves->Length);
+                for (int i = 0; i < map->Length; i++)
+                    map[i] = i;
+                result->CopyFrom(this, 0, map);
+                result->ops[length - 1] = op;
+                result->scalars[length - 1] = scalar;
+                return result;
+            }
+
+            /// <summary>
+            /// Gets the distinct operands, in input slot order
+            /// </summary>
+            property array<Object^>^ Leaves {
+                array<Object^>^ get() { return leaves; }
+            }
+
+            /// <summary>
+            /// Gets whether the program only loads one operand
+            /// </summary>
+            property bool IsLeaf {
+                bool get() { return ops->Length == 1; }
+            }
+
+            /// <summary>
+            /// Evaluates count elements into destination in one pass. arrays
+            /// holds the storage of each leaf; destination may be one of them.
+            /// </summary>
+            void Evaluate(array<Array^>^ arrays, Array^ destination, long long count) {
+                if (count > 0)
+                    Run(arrays, destination, count, false);
+            }
+
+            /// <summary>
+            /// Sums the elements, or their squares, without storing them
+            /// </summary>
+            double Reduce(array<Array^>^ arrays, long long count, bool squares) {
+                return count > 0 ? Run(arrays, nullptr, count, squares) : 0;
+            }
+        };
+
+        /// <summary>
+        /// A lazily evaluated element-wise vector expression. Operators build a
+        /// small program instead of computing; Evaluate runs the whole chain in
+        /// one pass with no intermediate vectors. For example (a - b) * 2 + c
+        /// reads a, b and c once and writes the result once, where the eager
+        /// form makes three passes and allocates three vectors.
+        /// Supports double and float elements.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class VectorExpression {
+        private:
+            ExpressionProgram^ program;
+            int size;
+
+            VectorExpression(ExpressionProgram^ program, int size) {
+                this->program = program;
+                this->size = size;
+            }
+
+            static VectorExpression<T>^ Combine(VectorExpression<T>^ a, VectorExpression<T>^ b, Native::ExpressionOp op) {
+                if (a->size != b->size)
+                    throw gcnew ArgumentException("Vectors must be of same size");
+                return gcnew VectorExpression<T>(ExpressionProgram::Binary(a->program, b->program, op), a->size);
+            }
+
+            VectorExpression<T>^ Apply(Native::ExpressionOp op, double scalar) {
+                return gcnew VectorExpression<T>(program->Unary(op, scalar), size);
+            }
+
+            array<Array^>^ Resolve() {
+                array<Object^>^ leaves = program->Leaves;
+                array<Array^>^ arrays = gcnew array<Array^>(leaves->Length);
+                for (int i = 0; i < leaves->Length; i++)
+                    arrays[i] = safe_cast<Vector<T>^>(leaves[i])->Elements;
+                return arrays;
+            }
+
+        public:
+            /// <summary>
+            /// Wraps a vector as the operand of a lazy expression. The vector is
+            /// read when the expression is evaluated, not when it is built.
+            /// </summary>
+            static VectorExpression<T>^ Of(Vector<T>^ vector) {
+                if (vector == nullptr)
+                    throw gcnew ArgumentNullException("vector");
+                if (T::typeid != Double::typeid && T::typeid != Single::typeid)
+                    throw gcnew NotSupportedException("Lazy expressions support double and float elements");
+                return gcnew VectorExpression<T>(ExpressionProgram::Leaf(vector), vector->Size);
+            }
+
+            /// <summary>
+            /// Gets the size of the result
+            /// </summary>
+            property int Size {
+                int get() { return size; }
+            }
+
+            /// <summary>
+            /// Adds two expressions element by element
+            /// </summary>
+            static VectorExpression<T>^ operator+(VectorExpression<T>^ a, VectorExpression<T>^ b) {
+                return Combine(a, b, Native::ExprAdd);
+            }
+
+            /// <summary>
+            /// Subtracts two expressions element by element
+            /// </summary>
+            static VectorExpression<T>^ operator-(VectorExpression<T>^ a, VectorExpression<T>^ b) {
+                return Combine(a, b, Native::ExprSubtract);
+            }
+
+            /// <summary>
+            /// Adds a scalar to every element
+            /// </summary>
+            static VectorExpression<T>^ operator+(VectorExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprAddScalar, s);
+            }
+
+            /// <summary>
+            /// Adds a scalar to every element
+            /// </summary>
+            static VectorExpression<T>^ operator+(double s, VectorExpression<T>^ a) {
+                return a->Apply(Native::ExprAddScalar, s);
+            }
+
+            /// <summary>
+            /// Subtracts a scalar from every element
+            /// </summary>
+            static VectorExpression<T>^ operator-(VectorExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprAddScalar, -s);
+            }
+
+            /// <summary>
+            /// Subtracts every element from a scalar
+            /// </summary>
+            static VectorExpression<T>^ operator-(double s, VectorExpression<T>^ a) {
+                return a->Apply(Native::ExprScalarSubtract, s);
+            }
+
+            /// <summary>
+            /// Scales every element
+            /// </summary>
+            static VectorExpression<T>^ operator*(VectorExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprMultiplyScalar, s);
+            }
+
+            /// <summary>
+            /// Scales every element
+            /// </summary>
+            static VectorExpression<T>^ operator*(double s, VectorExpression<T>^ a) {
+                return a->Apply(Native::ExprMultiplyScalar, s);
+            }
+
+            /// <summary>
+            /// Divides every element by a scalar
+            /// </summary>
+            static VectorExpression<T>^ operator/(VectorExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprDivideByScalar, s);
+            }
+
+            /// <summary>
+            /// Divides a scalar by every element
+            /// </summary>
+            static VectorExpression<T>^ operator/(double s, VectorExpression<T>^ a) {
+                return a->Apply(Native::ExprScalarDivide, s);
+            }
+
+            /// <summary>
+            /// Negates every element
+            /// </summary>
+            static VectorExpression<T>^ operator-(VectorExpression<T>^ a) {
+                return a->Apply(Native::ExprNegate, 0);
+            }
+
+            /// <summary>
+            /// Multiplies two expressions element by element
+            /// </summary>
+            VectorExpression<T>^ MultiplyElements(VectorExpression<T>^ other) {
+                return Combine(this, other, Native::ExprMultiply);
+            }
+
+            /// <summary>
+            /// Divides two expressions element by element
+            /// </summary>
+            VectorExpression<T>^ DivideElements(VectorExpression<T>^ other) {
+                return Combine(this, other, Native::ExprDivide);
+            }
+
+            /// <summary>
+            /// Takes the absolute value of every element
+            /// </summary>
+            VectorExpression<T>^ Abs() {
+                return Apply(Native::ExprAbs, 0);
+            }
+
+            /// <summary>
+            /// Takes the square root of every element
+            /// </summary>
+            VectorExpression<T>^ Sqrt() {
+                return Apply(Native::ExprSqrt, 0);
+            }
+
+            /// <summary>
+            /// Sums the elements in one pass without materializing them
+            /// </summary>
+            double Sum() {
+                return program->Reduce(Resolve(), size, false);
+            }
+
+            /// <summary>
+            /// Sums the squared elements in one pass without materializing them
+            /// </summary>
+            double SumOfSquares() {
+                return program->Reduce(Resolve(), size, true);
+            }
+
+            /// <summary>
+            /// Calculates the magnitude (length) in one pass without
+            /// materializing the elements
+            /// </summary>
+            double Magnitude() {
+                return System::Math::Sqrt(SumOfSquares());
+            }
+
+            /// <summary>
+            /// Scales the expression to unit length. The magnitude is computed
+            /// now, in one pass over the operands; the division is fused into
+            /// the final evaluation, so (v - w).Normalize() costs two passes
+            /// and a single allocation.
+            /// </summary>
+            VectorExpression<T>^ Normalize() {
+                return Apply(Native::ExprDivideByScalar, Magnitude());
+            }
+
+            /// <summary>
+            /// Evaluates the expression into a new vector
+            /// </summary>
+            Vector<T>^ Evaluate() {
+                Vector<T>^ result = gcnew Vector<T>(size);
+                program->Evaluate(Resolve(), result->Elements, size);
+                return result;
+            }
+
+            /// <summary>
+            /// Evaluates the expression into an existing vector without
+            /// allocating. The destination may be one of the operands.
+            /// </summary>
+            void EvaluateInto(Vector<T>^ destination) {
+                if (destination == nullptr)
+                    throw gcnew ArgumentNullException("destination");
+                if (destination->Size != size)
+                    throw gcnew ArgumentException("Destination size does not match the expression");
+                program->Evaluate(Resolve(), destination->Elements, size);
+            }
+        };
+
+        generic<typename T>
+        where T : value class
+        ref class MatrixExpression;
+
+        /// <summary>
+        /// A deferred matrix product operand of a lazy matrix expression
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        private ref class MatrixProduct {
+        public:
+            MatrixExpression<T>^ Left;
+            MatrixExpression<T>^ Right;
+        };
+
+        /// <summary>
+        /// A lazily evaluated matrix expression. Element-wise chains run in one
+        /// pass with no intermediate matrices, and matrix products are written
+        /// by the GEMM kernel straight into the result when possible, so
+        /// A * B + C * 2 allocates only the result.
+        /// Supports double and float elements.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class MatrixExpression {
+        private:
+            ExpressionProgram^ program;
+            int rows, cols;
+
+            MatrixExpression(ExpressionProgram^ program, int rows, int cols) {
+                this->program = program;
+                this->rows = rows;
+                this->cols = cols;
+            }
+
+            static MatrixExpression<T>^ Combine(MatrixExpression<T>^ a, MatrixExpression<T>^ b, Native::ExpressionOp op) {
+                if (a->rows != b->rows || a->cols != b->cols)
+                    throw gcnew ArgumentException("Matrix dimensions must match");
+                return gcnew MatrixExpression<T>(ExpressionProgram::Binary(a->program, b->program, op), a->rows, a->cols);
+            }
+
+            MatrixExpression<T>^ Apply(Native::ExpressionOp op, double scalar) {
+                return gcnew MatrixExpression<T>(program->Unary(op, scalar), rows, cols);
+            }
+
+            /// <summary>
+            /// Gets the operand as a plain matrix, evaluating it if needed
+            /// </summary>
+            Matrix<T>^ Materialize() {
+                if (program->IsLeaf) {
+                    Matrix<T>^ leaf = dynamic_cast<Matrix<T>^>(program->Leaves[0]);
+                    if (leaf != nullptr)
+                        return leaf;
+                }
+                return Evaluate();
+            }
+
+            bool References(Matrix<T>^ matrix) {
+                for each (Object^ leaf in program->Leaves) {
+                    if (leaf == matrix)
+                        return true;
+                    MatrixProduct<T>^ product = dynamic_cast<MatrixProduct<T>^>(leaf);
+                    if (product != nullptr && (product->Left->References(matrix) || product->Right->References(matrix)))
+                        return true;
+                }
+                return false;
+            }
+
+            // Maps every leaf to its storage, computing deferred products first.
+            // The first product goes straight into destination unless the
+            // expression reads destination anywhere.
+            array<Array^>^ Resolve(Matrix<T>^ destination) {
+                array<Object^>^ leaves = program->Leaves;
+                array<Array^>^ arrays = gcnew array<Array^>(leaves->Length);
+                bool destinationFree = destination != nullptr && !References(destination);
+                for (int i = 0; i < leaves->Length; i++) {
+                    MatrixProduct<T>^ product = dynamic_cast<MatrixProduct<T>^>(leaves[i]);
+                    if (product == nullptr) {
+                        arrays[i] = safe_cast<Matrix<T>^>(leaves[i])->Elements;
+                        continue;
+                    }
+
+                    Matrix<T>^ left = product->Left->Materialize();
+                    Matrix<T>^ right = product->Right->Materialize();
+                    Matrix<T>^ target = destinationFree ? destination : gcnew Matrix<T>(left->Rows, right->Columns);
+                    destinationFree = false;
+                    Matrix<T>::MultiplyInto(left->View(), right->View(), target, Parallelism::DefaultDegree);
+                    arrays[i] = target->Elements;
+                }
+                return arrays;
+            }
+
+        public:
+            /// <summary>
+            /// Wraps a matrix as the operand of a lazy expression. The matrix is
+            /// read when the expression is evaluated, not when it is built.
+            /// </summary>
+            static MatrixExpression<T>^ Of(Matrix<T>^ matrix) {
+                if (matrix == nullptr)
+                    throw gcnew ArgumentNullException("matrix");
+                if (T::typeid != Double::typeid && T::typeid != Single::typeid)
+                    throw gcnew NotSupportedException("Lazy expressions support double and float elements");
+                return gcnew MatrixExpression<T>(ExpressionProgram::Leaf(matrix), matrix->Rows, matrix->Columns);
+            }
+
+            /// <summary>
+            /// Gets number of rows of the result
+            /// </summary>
+            property int Rows {
+                int get() { return rows; }
+            }
+
+            /// <summary>
+            /// Gets number of columns of the result
+            /// </summary>
+            property int Columns {
+                int get() { return cols; }
+            }
+
+            /// <summary>
+            /// Multiplies two expressions as matrices. The product is computed
+            /// at evaluation time.
+            /// </summary>
+            static MatrixExpression<T>^ operator*(MatrixExpression<T>^ a, MatrixExpression<T>^ b) {
+                if (a->cols != b->rows)
+                    throw gcnew ArgumentException("Matrix dimensions do not match for multiplication");
+                MatrixProduct<T>^ product = gcnew MatrixProduct<T>();
+                product->Left = a;
+                product->Right = b;
+                return gcnew MatrixExpression<T>(ExpressionProgram::Leaf(product), a->rows, b->cols);
+            }
+
+            /// <summary>
+            /// Adds two expressions element by element
+            /// </summary>
+            static MatrixExpression<T>^ operator+(MatrixExpression<T>^ a, MatrixExpression<T>^ b) {
+                return Combine(a, b, Native::ExprAdd);
+            }
+
+            /// <summary>
+            /// Subtracts two expressions element by element
+            /// </summary>
+            static MatrixExpression<T>^ operator-(MatrixExpression<T>^ a, MatrixExpression<T>^ b) {
+                return Combine(a, b, Native::ExprSubtract);
+            }
+
+            /// <summary>
+            /// Adds a scalar to every element
+            /// </summary>
+            static MatrixExpression<T>^ operator+(MatrixExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprAddScalar, s);
+            }
+
+            /// <summary>
+            /// Subtracts a scalar from every element
+            /// </summary>
+            static MatrixExpression<T>^ operator-(MatrixExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprAddScalar, -s);
+            }
+
+            /// <summary>
+            /// Scales every element
+            /// </summary>
+            static MatrixExpression<T>^ operator*(MatrixExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprMultiplyScalar, s);
+            }
+
+            /// <summary>
+            /// Scales every element
+            /// </summary>
+            static MatrixExpression<T>^ operator*(double s, MatrixExpression<T>^ a) {
+                return a->Apply(Native::ExprMultiplyScalar, s);
+            }
+
+            /// <summary>
+            /// Divides every element by a scalar
+            /// </summary>
+            static MatrixExpression<T>^ operator/(MatrixExpression<T>^ a, double s) {
+                return a->Apply(Native::ExprDivideByScalar, s);
+            }
+
+            /// <summary>
+            /// Negates every element
+            /// </summary>
+            static MatrixExpression<T>^ operator-(MatrixExpression<T>^ a) {
+                return a->Apply(Native::ExprNegate, 0);
+            }
+
+            /// <summary>
+            /// Multiplies two expressions element by element (Hadamard product)
+            /// </summary>
+            MatrixExpression<T>^ MultiplyElements(MatrixExpression<T>^ other) {
+                return Combine(this, other, Native::ExprMultiply);
+            }
+
+            /// <summary>
+            /// Divides two expressions element by element
+            /// </summary>
+            MatrixExpression<T>^ DivideElements(MatrixExpression<T>^ other) {
+                return Combine(this, other, Native::ExprDivide);
+            }
+
+            /// <summary>
+            /// Takes the absolute value of every element
+            /// </summary>
+            MatrixExpression<T>^ Abs() {
+                return Apply(Native::ExprAbs, 0);
+            }
+
+            /// <summary>
+            /// Sums the elements without materializing them
+            /// </summary>
+            double Sum() {
+                return program->Reduce(Resolve(nullptr), (long long)rows * cols, false);
+            }
+
+            /// <summary>
+            /// Calculates the Frobenius norm without materializing the elements
+            /// </summary>
+            double FrobeniusNorm() {
+                return System::Math::Sqrt(program->Reduce(Resolve(nullptr), (long long)rows * cols, true));
+            }
+
+            /// <summary>
+            /// Evaluates the expression into a new matrix
+            /// </summary>
+            Matrix<T>^ Evaluate() {
+                Matrix<T>^ result = gcnew Matrix<T>(rows, cols);
+                program->Evaluate(Resolve(result), result->Elements, (long long)rows * cols);
+                return result;
+            }
+
+            /// <summary>
+            /// Evaluates the expression into an existing matrix without
+            /// allocating the result. The destination may be an element-wise
+            /// operand; products that read it go through a temporary.
+            /// </summary>
+            void EvaluateInto(Matrix<T>^ destination) {
+                if (destination == nullptr)
+                    throw gcnew ArgumentNullException("destination");
+                if (destination->Rows != rows || destination->Columns != cols)
+                    throw gcnew ArgumentException("Destination dimensions do not match the expression");
+                program->Evaluate(Resolve(destination), destination->Elements, (long long)rows * cols);
+            }
+        };
+
+        /// <summary>
+        /// Entry points for lazy expressions
+        /// </summary>
+        public ref class Expressions abstract sealed {
+        public:
+            /// <summary>
+            /// Starts a lazy expression from a vector
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static VectorExpression<T>^ Of(Vector<T>^ vector) {
+                return VectorExpression<T>::Of(vector);
+            }
+
+            /// <summary>
+            /// Starts a lazy expression from a matrix
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static MatrixExpression<T>^ Of(Matrix<T>^ matrix) {
+                return MatrixExpression<T>::Of(matrix);
+            }
+        };
+    }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A signed Q16.16 fixed-point number: a 32-bit integer counting
+        /// 1/65536 steps, covering about -32768 to 32768. Arithmetic is exact
+        /// for + and -, rounds to nearest for * and /, and throws
+        /// OverflowException instead of wrapping. Vectors and matrices of
+        /// Fixed accumulate dot products and traces exactly.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Fixed {
+        private:
+            int raw;
+
+            static Fixed Checked(long long value) {
+                if (value > Int32::MaxValue || value < Int32::MinValue)
+                    throw gcnew OverflowException("Fixed-point result is out of range");
+                return FromRaw((int)value);
+            }
+
+            /// <summary>
+            /// Divides by 2^16 rounding to nearest, halves away from zero
+            /// </summary>
+            static long long RoundShift(long long value) {
+                return value >= 0 ? (value + 0x8000) >> 16 : -((-value + 0x8000) >> 16);
+            }
+
+        public:
+            /// <summary>
+            /// Number of fractional bits
+            /// </summary>
+            literal int FractionBits = 16;
+
+            /// <summary>
+            /// Creates a value from a whole number
+            /// </summary>
+            Fixed(int value) {
+                if (value > Int16::MaxValue || value < Int16::MinValue)
+                    throw gcnew OverflowException("Fixed-point value is out of range");
+                raw = value << FractionBits;
+            }
+
+            /// <summary>
+            /// Creates a value from its raw Q16.16 representation
+            /// </summary>
+            static Fixed FromRaw(int raw) {
+                Fixed f;
+                f.raw = raw;
+                return f;
+            }
+
+            /// <summary>
+            /// Converts a double, rounding to the nearest step
+            /// </summary>
+            static Fixed FromDouble(double value) {
+                double scaled = System::Math::Round(value * 65536.0);
+                if (!(scaled >= Int32::MinValue && scaled <= Int32::MaxValue))
+                    throw gcnew OverflowException("Fixed-point value is out of range");
+                return FromRaw((int)scaled);
+            }
+
+            /// <summary>
+            /// Gets the raw Q16.16 representation
+            /// </summary>
+            property int Raw {
+                int get() { return raw; }
+            }
+
+            /// <summary>
+            /// Gets the smallest positive value, 1/65536
+            /// </summary>
+            static property Fixed Epsilon {
+                Fixed get() { return FromRaw(1); }
+            }
+
+            /// <summary>
+            /// Gets the largest value
+            /// </summary>
+            static property Fixed MaxValue {
+                Fixed get() { return FromRaw(Int32::MaxValue); }
+            }
+
+            /// <summary>
+            /// Gets the smallest value
+            /// </summary>
+            static property Fixed MinValue {
+                Fixed get() { return FromRaw(Int32::MinValue); }
+            }
+
+            /// <summary>
+            /// Converts to double exactly
+            /// </summary>
+            double ToDouble() {
+                return raw / 65536.0;
+            }
+
+            static explicit operator double(Fixed value) {
+                return value.raw / 65536.0;
+            }
+
+            static explicit operator Fixed(double value) {
+                return FromDouble(value);
+            }
+
+            static Fixed operator+(Fixed a, Fixed b) {
+                return Checked((long long)a.raw + b.raw);
+            }
+
+            static Fixed operator-(Fixed a, Fixed b) {
+                return Checked((long long)a.raw - b.raw);
+            }
+
+            static Fixed operator-(Fixed a) {
+                return Checked(-(long long)a.raw);
+            }
+
+            static Fixed operator*(Fixed a, Fixed b) {
+                return Checked(RoundShift((long long)a.raw * b.raw));
+            }
+
+            static Fixed operator/(Fixed a, Fixed b) {
+                if (b.raw == 0)
+                    throw gcnew DivideByZeroException();
+                long long n = (long long)a.raw << FractionBits;
+                long long q = n / b.raw, r = n % b.raw;
+                // Round half away from zero
+                if (2 * System::Math::Abs(r) >= System::Math::Abs((long long)b.raw))
+                    q += (n < 0) == (b.raw < 0) ? 1 : -1;
+                return Checked(q);
+            }
+
+            static bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+            static bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+            static bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+            static bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+            static bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+            static bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+            virtual bool Equals(Object^ obj) override {
+                return obj != nullptr && obj->GetType() == Fixed::typeid && safe_cast<Fixed>(obj).raw == raw;
+            }
+
+            virtual int GetHashCode() override {
+                return raw;
+            }
+
+            /// <summary>
+            /// Converts the value to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return ToDouble().ToString();
+            }
+        };
+    }
+}
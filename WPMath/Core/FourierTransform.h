@@ -0,0 +1,191 @@
+#pragma once
+
+#include "../Native/ComplexKernels.h"
+#include "../Native/Fft.h"
+#include "ComplexArray.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A reusable discrete Fourier transform of one length. The radix
+        /// schedule and twiddle tables are built once in the constructor, so
+        /// repeated transforms only pay for the butterflies. Any length works;
+        /// lengths whose factors are 2, 3, 4 and 5 are the fastest. A plan keeps
+        /// one work buffer for its calls and may be shared between threads; a
+        /// call made while another holds the buffer allocates its own.
+        /// </summary>
+        public ref class FourierPlan {
+        private:
+            Native::FftPlan* plan;
+            Native::RealFftPlan* realPlan;
+            IntPtr workspace;           // Zero while a call holds it
+            long long workLength;
+            int length;
+
+            static Dictionary<int, FourierPlan^>^ cache = gcnew Dictionary<int, FourierPlan^>();
+
+            void Check(ComplexArray^ source, ComplexArray^ destination, int expected) {
+                if (source == nullptr || destination == nullptr)
+                    throw gcnew ArgumentNullException(source == nullptr ? "source" : "destination");
+                if (source->Length != expected || destination->Length != expected)
+                    throw gcnew ArgumentException("Array length does not match the plan");
+            }
+
+            double* TakeWorkspace() {
+                IntPtr w = Interlocked::Exchange(workspace, IntPtr::Zero);
+                if (w == IntPtr::Zero)
+                    w = IntPtr(Native::AlignedAlloc((size_t)workLength * sizeof(double)));
+                return static_cast<double*>(w.ToPointer());
+            }
+
+            // Caches w again; if another call returned one meanwhile, that one is freed
+            void ReturnWorkspace(double* w) {
+                IntPtr previous = Interlocked::Exchange(workspace, IntPtr(w));
+                if (previous != IntPtr::Zero)
+                    Native::AlignedFree(previous.ToPointer());
+            }
+
+            void Execute(ComplexArray^ source, ComplexArray^ destination, bool inverse) {
+                Check(source, destination, length);
+                if (length == 0)
+                    return;
+                pin_ptr<double> src = &source->Data[0];
+                pin_ptr<double> dst = &destination->Data[0];
+                double* w = TakeWorkspace();
+                try {
+                    plan->Execute(src, dst, inverse, w);
+                }
+                finally {
+                    ReturnWorkspace(w);
+                }
+                if (inverse)
+                    Native::ComplexScale(dst, dst, length, 1.0 / length);
+            }
+
+        public:
+            /// <summary>
+            /// Creates a plan for transforms of specified length
+            /// </summary>
+            FourierPlan(int length) {
+                if (length < 1)
+                    throw gcnew ArgumentOutOfRangeException("length", "Transform length must be positive");
+                this->length = length;
+                plan = new Native::FftPlan(length);
+                realPlan = new Native::RealFftPlan(length);
+                size_t complexWork = plan->WorkLength(), realWork = realPlan->WorkLength();
+                workLength = (long long)(complexWork > realWork ? complexWork : realWork);
+                workspace = IntPtr(Native::AlignedAlloc((size_t)workLength * sizeof(double)));
+                GC::AddMemoryPressure(32LL * length + 8 * workLength);
+            }
+
+            !FourierPlan() {
+                if (plan) {
+                    delete plan;
+                    delete realPlan;
+                    plan = nullptr;
+                    realPlan = nullptr;
+                    if (workspace != IntPtr::Zero)
+                        Native::AlignedFree(workspace.ToPointer());
+                    workspace = IntPtr::Zero;
+                    GC::RemoveMemoryPressure(32LL * length + 8 * workLength);
+                }
+            }
+
+            /// <summary>
+            /// Gets a shared plan for specified length, creating it on first use
+            /// </summary>
+            static FourierPlan^ Get(int length) {
+                Monitor::Enter(cache);
+                try {
+                    FourierPlan^ result;
+                    if (!cache->TryGetValue(length, result)) {
+                        result = gcnew FourierPlan(length);
+                        cache->Add(length, result);
+                    }
+                    return result;
+                }
+                finally {
+                    Monitor::Exit(cache);
+                }
+            }
+
+            /// <summary>
+            /// Gets the transform length
+            /// </summary>
+            property int Length {
+                int get() { return length; }
+            }
+
+            /// <summary>
+            /// Gets the number of bins produced by ForwardReal, Length / 2 + 1
+            /// </summary>
+            property int RealBins {
+                int get() { return length / 2 + 1; }
+            }
+
+            /// <summary>
+            /// Computes X[k] = sum x[j] * exp(-2*pi*i*j*k/n). Source and
+            /// destination may be the same array.
+            /// </summary>
+            void Forward(ComplexArray^ source, ComplexArray^ destination) {
+                Execute(source, destination, false);
+            }
+
+            /// <summary>
+            /// Computes the inverse transform, scaled by 1/n so that
+            /// Inverse(Forward(x)) == x. Source and destination may be the same array.
+            /// </summary>
+            void Inverse(ComplexArray^ source, ComplexArray^ destination) {
+                Execute(source, destination, true);
+            }
+
+            /// <summary>
+            /// Transforms real samples into the Length / 2 + 1 non-redundant
+            /// bins; the rest follow from X[n - k] = conj(X[k])
+            /// </summary>
+            void ForwardReal(array<double>^ source, ComplexArray^ destination) {
+                if (source == nullptr || destination == nullptr)
+                    throw gcnew ArgumentNullException(source == nullptr ? "source" : "destination");
+                if (source->Length != length || destination->Length != RealBins)
+                    throw gcnew ArgumentException("Array length does not match the plan");
+                pin_ptr<double> src = &source[0];
+                pin_ptr<double> dst = &destination->Data[0];
+                double* w = TakeWorkspace();
+                try {
+                    realPlan->Forward(src, dst, w);
+                }
+                finally {
+                    ReturnWorkspace(w);
+                }
+            }
+
+            /// <summary>
+            /// Reconstructs real samples from Length / 2 + 1 bins, scaled by
+            /// 1/n so that InverseReal(ForwardReal(x)) == x
+            /// </summary>
+            void InverseReal(ComplexArray^ source, array<double>^ destination) {
+                if (source == nullptr || destination == nullptr)
+                    throw gcnew ArgumentNullException(source == nullptr ? "source" : "destination");
+                if (source->Length != RealBins || destination->Length != length)
+                    throw gcnew ArgumentException("Array length does not match the plan");
+                pin_ptr<double> src = &source->Data[0];
+                pin_ptr<double> dst = &destination[0];
+                double* w = TakeWorkspace();
+                try {
+                    realPlan->Inverse(src, dst, w);
+                }
+                finally {
+                    ReturnWorkspace(w);
+                }
+
+                double scale = 1.0 / length;
+                for (int i = 0; i < length; i++)
+                    dst[i] *= scale;
+            }
+        };
+    }
+}
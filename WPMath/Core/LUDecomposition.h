@@ -0,0 +1,243 @@
+#pragma once
+
+#include "../Native/Factorization.h"
+#include "BufferPool.h"
+
+#include <cstring>
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// LU factorization with partial pivoting (P * A = L * U). The matrix is
+        /// factored once; determinant, solves, inverse and rank reuse the factors.
+        /// </summary>
+        public ref class LUDecomposition {
+        private:
+            array<double>^ lu;
+            array<int>^ permutation;
+            int n;
+            int rank;
+            double determinant;
+
+            LUDecomposition(array<double>^ data, int size) {
+                lu = data;
+                n = size;
+                permutation = gcnew array<int>(n);
+                rank = FactorInPlace(lu, permutation, n, determinant);
+            }
+
+            void EnsureNonSingular() {
+                if (IsSingular)
+                    throw gcnew InvalidOperationException("Matrix is singular");
+            }
+
+            /// <summary>
+            /// Solves for nrhs right-hand sides from pinned storage. LuSolve
+            /// needs b and x apart, so an in-place solve goes through a pooled
+            /// copy of b.
+            /// </summary>
+            void SolveInto(interior_ptr<double> b, interior_ptr<double> x, int nrhs) {
+                int count = n * nrhs;
+                array<double>^ copy = b == x ? BufferPool::Rent<double>(count) : nullptr;
+                try {
+                    pin_ptr<double> pb = b;
+                    pin_ptr<double> px = x;
+                    if (copy != nullptr) {
+                        pin_ptr<double> pc = &copy[0];
+                        memcpy(pc, pb, count * sizeof(double));
+                        pb = pc;
+                    }
+                    pin_ptr<double> pa = &lu[0];
+                    pin_ptr<int> pp = &permutation[0];
+                    Native::LuSolve(pa, n, pp, pb, nrhs, px);
+                }
+                finally {
+                    BufferPool::Return(copy);
+                }
+            }
+
+            static void CheckResult(int rows, int cols, int expectedRows, int expectedCols, String^ name) {
+                if (rows != expectedRows || cols != expectedCols)
+                    throw gcnew ArgumentException("Result has the wrong dimensions", name);
+            }
+
+        internal:
+            /// <summary>
+            /// Factors the leading n x n row-major block of a in place, with
+            /// the row permutation in perm. Both may be longer, as when rented
+            /// from the BufferPool. Returns the rank.
+            /// </summary>
+            static int FactorInPlace(array<double>^ a, array<int>^ perm, int n, double% determinant) {
+                int sign = 1;
+                if (n > 0) {
+                    pin_ptr<double> pa = &a[0];
+                    pin_ptr<int> pp = &perm[0];
+                    sign = Native::LuFactor(pa, n, pp);
+                }
+
+                double maxPivot = 0;
+                double det = sign;
+                for (int i = 0; i < n; i++) {
+                    double u = a[i * n + i];
+                    det *= u;
+                    maxPivot = System::Math::Max(maxPivot, System::Math::Abs(u));
+                }
+                determinant = det;
+
+                double threshold = maxPivot * Native::RankTolerance(n, n);
+                int rank = 0;
+                for (int i = 0; i < n; i++)
+                    if (System::Math::Abs(a[i * n + i]) > threshold)
+                        rank++;
+                return rank;
+            }
+
+        public:
+            /// <summary>
+            /// Factors a square matrix
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static LUDecomposition^ Factor(Matrix<T>^ matrix) {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                return gcnew LUDecomposition(matrix->ToRowMajorDouble(), matrix->Rows);
+            }
+
+            /// <summary>
+            /// Factors a square view without materializing it as a Matrix
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static LUDecomposition^ Factor(MatrixView<T>^ view) {
+                if (view->Rows != view->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                return gcnew LUDecomposition(view->ToRowMajorDouble(), view->Rows);
+            }
+
+            /// <summary>
+            /// Gets the order of the factored matrix
+            /// </summary>
+            property int Size {
+                int get() { return n; }
+            }
+
+            /// <summary>
+            /// Gets the determinant of the factored matrix
+            /// </summary>
+            property double Determinant {
+                double get() { return determinant; }
+            }
+
+            /// <summary>
+            /// Gets the number of pivots above the relative rank tolerance.
+            /// Use QRDecomposition when rank must be reliable.
+            /// </summary>
+            property int Rank {
+                int get() { return rank; }
+            }
+
+            /// <summary>
+            /// Gets whether the factored matrix is numerically singular
+            /// </summary>
+            property bool IsSingular {
+                bool get() { return rank < n; }
+            }
+
+            /// <summary>
+            /// Solves A * x = b
+            /// </summary>
+            Vector<double>^ Solve(Vector<double>^ b) {
+                if (b->Size != n)
+                    throw gcnew ArgumentException("Vector size does not match the matrix");
+                EnsureNonSingular();
+
+                Vector<double>^ x = gcnew Vector<double>(n);
+                Solve(b, x);
+                return x;
+            }
+
+            /// <summary>
+            /// Solves A * x = b into a caller-provided vector, which may be b,
+            /// without allocating
+            /// </summary>
+            void Solve(Vector<double>^ b, Vector<double>^ x) {
+                if (b->Size != n)
+                    throw gcnew ArgumentException("Vector size does not match the matrix");
+                CheckResult(x->Size, 1, n, 1, "x");
+                EnsureNonSingular();
+                if (n == 0)
+                    return;
+
+                SolveInto(&b->Elements[0], &x->Elements[0], 1);
+            }
+
+            /// <summary>
+            /// Solves A * X = B for every column of B at once
+            /// </summary>
+            Matrix<double>^ Solve(Matrix<double>^ b) {
+                if (b->Rows != n)
+                    throw gcnew ArgumentException("Matrix row count does not match the factored matrix");
+                EnsureNonSingular();
+
+                Matrix<double>^ x = gcnew Matrix<double>(n, b->Columns);
+                Solve(b, x);
+                return x;
+            }
+
+            /// <summary>
+            /// Solves A * X = B into a caller-provided matrix, which may be B,
+            /// without allocating
+            /// </summary>
+            void Solve(Matrix<double>^ b, Matrix<double>^ x) {
+                if (b->Rows != n)
+                    throw gcnew ArgumentException("Matrix row count does not match the factored matrix");
+                CheckResult(x->Rows, x->Columns, n, b->Columns, "x");
+                EnsureNonSingular();
+                if (n == 0 || b->Columns == 0)
+                    return;
+
+                SolveInto(&b->Elements[0, 0], &x->Elements[0, 0], b->Columns);
+            }
+
+            /// <summary>
+            /// Calculates the inverse of the factored matrix
+            /// </summary>
+            Matrix<double>^ Inverse() {
+                Matrix<double>^ result = gcnew Matrix<double>(n, n);
+                Inverse(result);
+                return result;
+            }
+
+            /// <summary>
+            /// Writes the inverse of the factored matrix into an n x n result
+            /// without allocating
+            /// </summary>
+            void Inverse(Matrix<double>^ result) {
+                CheckResult(result->Rows, result->Columns, n, n, "result");
+                EnsureNonSingular();
+                if (n == 0)
+                    return;
+
+                array<double>^ identity = BufferPool::Rent<double>(n * n);
+                try {
+                    Array::Clear(identity, 0, n * n);
+                    for (int i = 0; i < n; i++)
+                        identity[i * n + i] = 1;
+                    pin_ptr<double> pa = &lu[0];
+                    pin_ptr<int> pp = &permutation[0];
+                    pin_ptr<double> pb = &identity[0];
+                    pin_ptr<double> px = &result->Elements[0, 0];
+                    Native::LuSolve(pa, n, pp, pb, n, px);
+                }
+                finally {
+                    BufferPool::Return(identity);
+                }
+            }
+        };
+    }
+}
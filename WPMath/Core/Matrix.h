@@ -1,6 +1,16 @@
 #pragma once
 
+#include "../Native/Gemm.h"
+#include "../Native/Summation.h"
+#include "../Native/Transpose.h"
+#include "Arithmetic.h"
+#include "BufferPool.h"
+#include "MatrixView.h"
+#include "NativeStorage.h"
+#include "Parallelism.h"
+
 using namespace System;
+using namespace System::Runtime::InteropServices;
 
 namespace WindowPlus {
     namespace Math {
@@ -13,6 +23,332 @@ namespace WindowPlus {
         private:
             array<T, 2>^ elements;
             int rows, cols;
+            MatrixView<T>^ view;
+
+            /// <summary>
+            /// Runs the packed native GEMM kernel for float and double elements.
+            /// Views are passed as strided operands, so nothing is materialized.
+            /// Returns false for other element types.
+            /// </summary>
+            static bool TryMultiplyNative(MatrixView<T>^ a, MatrixView<T>^ b, Matrix<T>^ c, int degreeOfParallelism) {
+                if (T::typeid == Double::typeid) {
+                    MultiplyNative(safe_cast<MatrixView<double>^>((Object^)a), safe_cast<MatrixView<double>^>((Object^)b),
+                                   safe_cast<array<double, 2>^>((Object^)c->elements), degreeOfParallelism);
+                    return true;
+                }
+                if (T::typeid == Single::typeid) {
+                    MultiplyNative(safe_cast<MatrixView<float>^>((Object^)a), safe_cast<MatrixView<float>^>((Object^)b),
+                                   safe_cast<array<float, 2>^>((Object^)c->elements), degreeOfParallelism);
+                    return true;
+                }
+                return false;
+            }
+
+            static void MultiplyNative(MatrixView<double>^ a, MatrixView<double>^ b, array<double, 2>^ c,
+                                       int degreeOfParallelism) {
+                int m = a->Rows, n = b->Columns, k = a->Columns;
+                if (m == 0 || n == 0 || k == 0)
+                    return;
+                pin_ptr<double> pa = &a->Storage[0, 0];
+                pin_ptr<double> pb = &b->Storage[0, 0];
+                pin_ptr<double> pc = &c[0, 0];
+                if (degreeOfParallelism == 1 || (long long)m * n * k < Parallelism::MultiplyThreshold)
+                    Native::Gemm<double>(a->ToNative(pa), b->ToNative(pb), pc, n);
+                else
+                    Native::GemmParallel<double>(a->ToNative(pa), b->ToNative(pb), pc, n, degreeOfParallelism);
+            }
+
+            static void MultiplyNative(MatrixView<float>^ a, MatrixView<float>^ b, array<float, 2>^ c,
+                                       int degreeOfParallelism) {
+                int m = a->Rows, n = b->Columns, k = a->Columns;
+                if (m == 0 || n == 0 || k == 0)
+                    return;
+                pin_ptr<float> pa = &a->Storage[0, 0];
+                pin_ptr<float> pb = &b->Storage[0, 0];
+                pin_ptr<float> pc = &c[0, 0];
+                if (degreeOfParallelism == 1 || (long long)m * n * k < Parallelism::MultiplyThreshold)
+                    Native::Gemm<float>(a->ToNative(pa), b->ToNative(pb), pc, n);
+                else
+                    Native::GemmParallel<float>(a->ToNative(pa), b->ToNative(pb), pc, n, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Runs the blocked native transpose for float and double elements.
+            /// Returns false for other element types.
+            /// </summary>
+            static bool TryTransposeNative(Matrix<T>^ source, Matrix<T>^ result, int degreeOfParallelism) {
+                if (T::typeid == Double::typeid) {
+                    TransposeNative(safe_cast<array<double, 2>^>((Object^)source->elements),
+                                    safe_cast<array<double, 2>^>((Object^)result->elements),
+                                    source->rows, source->cols, degreeOfParallelism);
+                    return true;
+                }
+                if (T::typeid == Single::typeid) {
+                    TransposeNative(safe_cast<array<float, 2>^>((Object^)source->elements),
+                                    safe_cast<array<float, 2>^>((Object^)result->elements),
+                                    source->rows, source->cols, degreeOfParallelism);
+                    return true;
+                }
+                return false;
+            }
+
+            static void TransposeNative(array<double, 2>^ src, array<double, 2>^ dst, int m, int n, int degreeOfParallelism) {
+                if (m == 0 || n == 0)
+                    return;
+                pin_ptr<double> ps = &src[0, 0];
+                pin_ptr<double> pd = &dst[0, 0];
+                if (degreeOfParallelism == 1 || (long long)m * n < Parallelism::TransposeThreshold)
+                    Native::Transpose<double>(ps, m, n, pd);
+                else
+                    Native::TransposeParallel<double>(ps, m, n, pd, degreeOfParallelism);
+            }
+
+            static void TransposeNative(array<float, 2>^ src, array<float, 2>^ dst, int m, int n, int degreeOfParallelism) {
+                if (m == 0 || n == 0)
+                    return;
+                pin_ptr<float> ps = &src[0, 0];
+                pin_ptr<float> pd = &dst[0, 0];
+                if (degreeOfParallelism == 1 || (long long)m * n < Parallelism::TransposeThreshold)
+                    Native::Transpose<float>(ps, m, n, pd);
+                else
+                    Native::TransposeParallel<float>(ps, m, n, pd, degreeOfParallelism);
+            }
+
+            static bool TryTransposeInPlaceNative(Matrix<T>^ matrix) {
+                if (matrix->rows == 0)
+                    return true;
+                if (T::typeid == Double::typeid) {
+                    pin_ptr<double> p = &safe_cast<array<double, 2>^>((Object^)matrix->elements)[0, 0];
+                    Native::TransposeInPlace<double>(p, matrix->rows);
+                    return true;
+                }
+                if (T::typeid == Single::typeid) {
+                    pin_ptr<float> p = &safe_cast<array<float, 2>^>((Object^)matrix->elements)[0, 0];
+                    Native::TransposeInPlace<float>(p, matrix->rows);
+                    return true;
+                }
+                return false;
+            }
+
+            void CheckRow(int row) {
+                if (row < 0 || row >= rows)
+                    throw gcnew ArgumentOutOfRangeException("row");
+            }
+
+            void CheckColumn(int col) {
+                if (col < 0 || col >= cols)
+                    throw gcnew ArgumentOutOfRangeException("col");
+            }
+
+            /// <summary>
+            /// Checks that [index, index + count) lies within buffer; the
+            /// names are the caller's parameters, reported in the exception
+            /// </summary>
+            static void CheckSpan(array<T>^ buffer, String^ bufferName, int index, String^ indexName, int count) {
+                if (buffer == nullptr)
+                    throw gcnew ArgumentNullException(bufferName);
+                if (count < 0)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                if (index < 0 || index > buffer->Length - count)
+                    throw gcnew ArgumentOutOfRangeException(indexName);
+            }
+
+            /// <summary>
+            /// Copies count elements starting at row-major position start of the
+            /// storage to or from a one-dimensional buffer. start is 64-bit
+            /// because the rows of a large matrix can begin past 2^31 elements
+            /// or bytes.
+            /// </summary>
+            void CopyRange(long long start, array<T>^ buffer, int index, int count, bool toBuffer) {
+                int size = ElementInfo<T>::Size;
+                if (size != 0 && (start + count) * size <= Int32::MaxValue &&
+                    ((long long)index + count) * size <= Int32::MaxValue) {
+                    int offset = (int)(start * size);
+                    if (toBuffer)
+                        Buffer::BlockCopy(elements, offset, buffer, index * size, count * size);
+                    else
+                        Buffer::BlockCopy(buffer, index * size, elements, offset, count * size);
+                    return;
+                }
+                if (size != 0) {
+                    // Past the reach of BlockCopy's int offsets
+                    GCHandle storage, other;
+                    try {
+                        storage = GCHandle::Alloc(elements, GCHandleType::Pinned);
+                        other = GCHandle::Alloc(buffer, GCHandleType::Pinned);
+                        unsigned char* matrix = static_cast<unsigned char*>(storage.AddrOfPinnedObject().ToPointer()) + start * size;
+                        unsigned char* linear = static_cast<unsigned char*>(other.AddrOfPinnedObject().ToPointer()) + (long long)index * size;
+                        if (toBuffer)
+                            memcpy(linear, matrix, (size_t)count * size);
+                        else
+                            memcpy(matrix, linear, (size_t)count * size);
+                    }
+                    finally {
+                        if (other.IsAllocated)
+                            other.Free();
+                        if (storage.IsAllocated)
+                            storage.Free();
+                    }
+                    return;
+                }
+
+                for (int k = 0; k < count; k++) {
+                    int r = (int)((start + k) / cols), c = (int)((start + k) % cols);
+                    if (toBuffer)
+                        buffer[index + k] = elements[r, c];
+                    else
+                        elements[r, c] = buffer[index + k];
+                }
+            }
+
+            void CopyNative(IntPtr address, bool toAddress) {
+                int size = ElementInfo<T>::Size;
+                if (size == 0)
+                    throw gcnew NotSupportedException("Native copies require a primitive element type");
+                if (elements->Length == 0)
+                    return;
+
+                GCHandle handle = GCHandle::Alloc(elements, GCHandleType::Pinned);
+                try {
+                    void* storage = handle.AddrOfPinnedObject().ToPointer();
+                    size_t bytes = (size_t)elements->Length * size;
+                    if (toAddress)
+                        memcpy(address.ToPointer(), storage, bytes);
+                    else
+                        memcpy(storage, address.ToPointer(), bytes);
+                }
+                finally {
+                    handle.Free();
+                }
+            }
+
+        internal:
+            /// <summary>
+            /// Gets the backing storage without copying
+            /// </summary>
+            property array<T, 2>^ Elements {
+                array<T, 2>^ get() { return elements; }
+            }
+
+            /// <summary>
+            /// Copies the elements into a new row-major array of doubles
+            /// </summary>
+            array<double>^ ToRowMajorDouble() {
+                array<double>^ result = gcnew array<double>(rows * cols);
+                CopyToRowMajorDouble(result);
+                return result;
+            }
+
+            /// <summary>
+            /// Copies the elements as doubles into the start of a row-major
+            /// buffer, such as one rented from the BufferPool
+            /// </summary>
+            void CopyToRowMajorDouble(array<double>^ destination) {
+                if (T::typeid == Double::typeid) {
+                    Buffer::BlockCopy(elements, 0, destination, 0, rows * cols * sizeof(double));
+                    return;
+                }
+
+                int index = 0;
+                for (int i = 0; i < rows; i++)
+                    for (int j = 0; j < cols; j++)
+                        destination[index++] = Arithmetic<T>::ToDouble(elements[i, j]);
+            }
+
+            /// <summary>
+            /// Throws unless result is rows x cols and shares no storage with
+            /// the operands
+            /// </summary>
+            static void CheckResult(Matrix<T>^ result, int rows, int cols, Array^ left, Array^ right) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                if (result->rows != rows || result->cols != cols)
+                    throw gcnew ArgumentException("Result matrix has the wrong dimensions", "result");
+                if (result->elements == left || result->elements == right)
+                    throw gcnew ArgumentException("Result matrix must not share storage with an operand", "result");
+            }
+
+            /// <summary>
+            /// Overwrites result with left * right. Dimensions are validated by
+            /// the caller, and result must not share storage with either operand.
+            /// </summary>
+            static void MultiplyInto(MatrixView<T>^ left, MatrixView<T>^ right, Matrix<T>^ result, int degreeOfParallelism) {
+                if (left->Columns == 0) {
+                    Array::Clear(result->elements, 0, result->elements->Length);
+                    return;
+                }
+                if (TryMultiplyNative(left, right, result, degreeOfParallelism))
+                    return;
+                MultiplyAccumulatedInto(left, right, result, Summation::Naive, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Overwrites result with left * right, accumulating every element
+            /// in double with the given summation (exactly for Int32 and
+            /// Fixed) and rounding it once into T
+            /// </summary>
+            static void MultiplyAccumulatedInto(MatrixView<T>^ left, MatrixView<T>^ right, Matrix<T>^ result,
+                                                Summation summation, int degreeOfParallelism) {
+                int m = left->Rows, n = right->Columns, k = left->Columns;
+                if (m == 0 || n == 0)
+                    return;
+                if (k == 0) {
+                    Array::Clear(result->elements, 0, result->elements->Length);
+                    return;
+                }
+
+                Native::SummationMode mode = (Native::SummationMode)summation;
+                if (T::typeid == Double::typeid) {
+                    MatrixView<double>^ a = safe_cast<MatrixView<double>^>((Object^)left);
+                    MatrixView<double>^ b = safe_cast<MatrixView<double>^>((Object^)right);
+                    pin_ptr<double> pa = &a->Storage[0, 0];
+                    pin_ptr<double> pb = &b->Storage[0, 0];
+                    pin_ptr<double> pc = &safe_cast<array<double, 2>^>((Object^)result->elements)[0, 0];
+                    Native::MultiplyAccumulated<double>(a->ToNative(pa), b->ToNative(pb), pc, mode, degreeOfParallelism);
+                    return;
+                }
+                if (T::typeid == Single::typeid) {
+                    MatrixView<float>^ a = safe_cast<MatrixView<float>^>((Object^)left);
+                    MatrixView<float>^ b = safe_cast<MatrixView<float>^>((Object^)right);
+                    pin_ptr<float> pa = &a->Storage[0, 0];
+                    pin_ptr<float> pb = &b->Storage[0, 0];
+                    pin_ptr<float> pc = &safe_cast<array<float, 2>^>((Object^)result->elements)[0, 0];
+                    Native::MultiplyAccumulated<float>(a->ToNative(pa), b->ToNative(pb), pc, mode, degreeOfParallelism);
+                    return;
+                }
+
+                // Element by element through a row of A and a packed column of B
+                array<T>^ row = BufferPool::Rent<T>(k);
+                array<T>^ column = BufferPool::Rent<T>(k);
+                try {
+                    for (int j = 0; j < n; j++) {
+                        for (int p = 0; p < k; p++)
+                            column[p] = right[p, j];
+                        for (int i = 0; i < m; i++) {
+                            for (int p = 0; p < k; p++)
+                                row[p] = left[i, p];
+                            result->elements[i, j] = summation == Summation::Naive
+                                ? Arithmetic<T>::Dot(row, column, k)
+                                : Arithmetic<T>::FromDouble(Arithmetic<T>::Dot(row, column, k, summation));
+                        }
+                    }
+                }
+                finally {
+                    BufferPool::Return(column);
+                    BufferPool::Return(row);
+                }
+            }
+
+            void TransposeInto(Matrix<T>^ result, int degreeOfParallelism) {
+                if (TryTransposeNative(this, result, degreeOfParallelism))
+                    return;
+
+                for (int i = 0; i < rows; i++) {
+                    for (int j = 0; j < cols; j++) {
+                        result->elements[j, i] = elements[i, j];
+                    }
+                }
+            }
 
         public:
             /// <summary>
@@ -22,6 +358,7 @@ namespace WindowPlus {
                 this->rows = rows;
                 this->cols = cols;
                 elements = gcnew array<T, 2>(rows, cols);
+                AllocationCounters::Record(elements->LongLength);
             }
 
             /// <summary>
@@ -32,6 +369,17 @@ namespace WindowPlus {
                 cols = data->GetLength(1);
                 elements = gcnew array<T, 2>(rows, cols);
                 Array::Copy(data, elements, data->Length);
+                AllocationCounters::Record(elements->LongLength);
+            }
+
+            /// <summary>
+            /// Creates a matrix by copying the elements of a view
+            /// </summary>
+            Matrix(MatrixView<T>^ source) {
+                rows = source->Rows;
+                cols = source->Columns;
+                elements = source->ToArray();
+                AllocationCounters::Record(elements->LongLength);
             }
 
             /// <summary>
@@ -65,40 +413,275 @@ namespace WindowPlus {
             }
 
             /// <summary>
-            /// Multiplies matrix by another matrix
+            /// Multiplies matrix by another matrix, using the global
+            /// Parallelism settings
             /// </summary>
             Matrix<T>^ Multiply(Matrix<T>^ other) {
-                if (cols != other->Rows)
+                return Multiply(other, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Multiplies matrix by another matrix using at most the given number
+            /// of threads (0 means all hardware threads)
+            /// </summary>
+            Matrix<T>^ Multiply(Matrix<T>^ other, int degreeOfParallelism) {
+                return Multiply(View(), other->View(), degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Multiplies matrix by a view without materializing the view
+            /// </summary>
+            Matrix<T>^ Multiply(MatrixView<T>^ other) {
+                return Multiply(View(), other, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Multiplies two views, using the global Parallelism settings
+            /// </summary>
+            static Matrix<T>^ Multiply(MatrixView<T>^ left, MatrixView<T>^ right) {
+                return Multiply(left, right, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Multiplies two views using at most the given number of threads
+            /// (0 means all hardware threads)
+            /// </summary>
+            static Matrix<T>^ Multiply(MatrixView<T>^ left, MatrixView<T>^ right, int degreeOfParallelism) {
+                if (left->Columns != right->Rows)
                     throw gcnew ArgumentException("Matrix dimensions do not match for multiplication");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
 
-                Matrix<T>^ result = gcnew Matrix<T>(rows, other->Columns);
-                
-                for (int i = 0; i < rows; i++) {
-                    for (int j = 0; j < other->Columns; j++) {
-                        T sum = T();
-                        for (int k = 0; k < cols; k++) {
-                            sum += elements[i, k] * other[k, j];
-                        }
-                        result[i, j] = sum;
-                    }
-                }
-                
+                Matrix<T>^ result = gcnew Matrix<T>(left->Rows, right->Columns);
+                MultiplyInto(left, right, result, degreeOfParallelism);
+                return result;
+            }
+
+            /// <summary>
+            /// Overwrites result with the product of matrix and another matrix
+            /// without allocating. Result must not be either operand.
+            /// </summary>
+            void Multiply(Matrix<T>^ other, Matrix<T>^ result) {
+                Multiply(View(), other->View(), result, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Overwrites result with the product of two views using at most
+            /// the given number of threads, without allocating. Result must not
+            /// share storage with either view.
+            /// </summary>
+            static void Multiply(MatrixView<T>^ left, MatrixView<T>^ right, Matrix<T>^ result, int degreeOfParallelism) {
+                if (left->Columns != right->Rows)
+                    throw gcnew ArgumentException("Matrix dimensions do not match for multiplication");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                CheckResult(result, left->Rows, right->Columns, left->Storage, right->Storage);
+
+                MultiplyInto(left, right, result, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Multiplies matrix by another matrix, accumulating every element
+            /// in double with the given summation. Float matrices keep half
+            /// the memory of double ones while reaching double accuracy;
+            /// Int32 and Fixed products are exact and throw OverflowException
+            /// when an element does not fit. Slower than Multiply without a
+            /// summation, which accumulates float in float.
+            /// </summary>
+            Matrix<T>^ Multiply(Matrix<T>^ other, Summation summation) {
+                return Multiply(View(), other->View(), summation, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Multiplies two views, accumulating every element in double with
+            /// the given summation, using at most the given number of threads
+            /// </summary>
+            static Matrix<T>^ Multiply(MatrixView<T>^ left, MatrixView<T>^ right, Summation summation, int degreeOfParallelism) {
+                if (left->Columns != right->Rows)
+                    throw gcnew ArgumentException("Matrix dimensions do not match for multiplication");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+
+                Matrix<T>^ result = gcnew Matrix<T>(left->Rows, right->Columns);
+                MultiplyAccumulatedInto(left, right, result, summation, degreeOfParallelism);
                 return result;
             }
 
             /// <summary>
-            /// Transposes the matrix
+            /// Overwrites result with the product of two views accumulated with
+            /// the given summation, without allocating for float and double
+            /// </summary>
+            static void Multiply(MatrixView<T>^ left, MatrixView<T>^ right, Matrix<T>^ result, Summation summation,
+                                 int degreeOfParallelism) {
+                if (left->Columns != right->Rows)
+                    throw gcnew ArgumentException("Matrix dimensions do not match for multiplication");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                CheckResult(result, left->Rows, right->Columns, left->Storage, right->Storage);
+
+                MultiplyAccumulatedInto(left, right, result, summation, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Transposes the matrix, using the global Parallelism settings
             /// </summary>
             Matrix<T>^ Transpose() {
+                return Transpose(Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Transposes the matrix using at most the given number of threads
+            /// (0 means all hardware threads)
+            /// </summary>
+            Matrix<T>^ Transpose(int degreeOfParallelism) {
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+
                 Matrix<T>^ result = gcnew Matrix<T>(cols, rows);
-                
+                TransposeInto(result, degreeOfParallelism);
+                return result;
+            }
+
+            /// <summary>
+            /// Overwrites result, a Columns x Rows matrix other than this one,
+            /// with the transpose without allocating
+            /// </summary>
+            void Transpose(Matrix<T>^ result) {
+                CheckResult(result, cols, rows, elements, nullptr);
+                TransposeInto(result, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Transposes a square matrix in place without allocating
+            /// </summary>
+            void TransposeInPlace() {
+                if (rows != cols)
+                    throw gcnew InvalidOperationException("Matrix must be square");
+
+                if (TryTransposeInPlaceNative(this))
+                    return;
+
                 for (int i = 0; i < rows; i++) {
-                    for (int j = 0; j < cols; j++) {
-                        result[j, i] = elements[i, j];
+                    for (int j = i + 1; j < cols; j++) {
+                        T tmp = elements[i, j];
+                        elements[i, j] = elements[j, i];
+                        elements[j, i] = tmp;
                     }
                 }
-                
-                return result;
+            }
+
+            /// <summary>
+            /// Gets a view of the whole matrix. Views are immutable, so the
+            /// same one is returned every time.
+            /// </summary>
+            MatrixView<T>^ View() {
+                if (view == nullptr)
+                    view = gcnew MatrixView<T>(elements);
+                return view;
+            }
+
+            /// <summary>
+            /// Gets a zero-copy transposed view
+            /// </summary>
+            MatrixView<T>^ TransposeView() {
+                return View()->Transpose();
+            }
+
+            /// <summary>
+            /// Gets a 1 x Columns view of a row
+            /// </summary>
+            MatrixView<T>^ Row(int row) {
+                return View()->Row(row);
+            }
+
+            /// <summary>
+            /// Gets a Rows x 1 view of a column
+            /// </summary>
+            MatrixView<T>^ Column(int col) {
+                return View()->Column(col);
+            }
+
+            /// <summary>
+            /// Gets a view of a rectangular block
+            /// </summary>
+            MatrixView<T>^ Block(int row, int col, int blockRows, int blockCols) {
+                return View()->Block(row, col, blockRows, blockCols);
+            }
+
+            /// <summary>
+            /// Gets a view of every rowStep-th row and colStep-th column of a block
+            /// starting at (row, col)
+            /// </summary>
+            MatrixView<T>^ Block(int row, int col, int blockRows, int blockCols, int rowStep, int colStep) {
+                return View()->Block(row, col, blockRows, blockCols, rowStep, colStep);
+            }
+
+            /// <summary>
+            /// Copies a row into a buffer
+            /// </summary>
+            void CopyRowTo(int row, array<T>^ destination, int destinationIndex) {
+                CheckRow(row);
+                CheckSpan(destination, "destination", destinationIndex, "destinationIndex", cols);
+                CopyRange((long long)row * cols, destination, destinationIndex, cols, true);
+            }
+
+            /// <summary>
+            /// Overwrites a row from a buffer
+            /// </summary>
+            void SetRow(int row, array<T>^ source, int sourceIndex) {
+                CheckRow(row);
+                CheckSpan(source, "source", sourceIndex, "sourceIndex", cols);
+                CopyRange((long long)row * cols, source, sourceIndex, cols, false);
+            }
+
+            /// <summary>
+            /// Copies a column into a buffer
+            /// </summary>
+            void CopyColumnTo(int col, array<T>^ destination, int destinationIndex) {
+                CheckColumn(col);
+                CheckSpan(destination, "destination", destinationIndex, "destinationIndex", rows);
+                for (int i = 0; i < rows; i++)
+                    destination[destinationIndex + i] = elements[i, col];
+            }
+
+            /// <summary>
+            /// Overwrites a column from a buffer
+            /// </summary>
+            void SetColumn(int col, array<T>^ source, int sourceIndex) {
+                CheckColumn(col);
+                CheckSpan(source, "source", sourceIndex, "sourceIndex", rows);
+                for (int i = 0; i < rows; i++)
+                    elements[i, col] = source[sourceIndex + i];
+            }
+
+            /// <summary>
+            /// Copies all elements in row-major order into a buffer
+            /// </summary>
+            void CopyTo(array<T>^ destination, int destinationIndex) {
+                CheckSpan(destination, "destination", destinationIndex, "destinationIndex", rows * cols);
+                CopyRange(0, destination, destinationIndex, rows * cols, true);
+            }
+
+            /// <summary>
+            /// Overwrites all elements from a row-major buffer
+            /// </summary>
+            void CopyFrom(array<T>^ source, int sourceIndex) {
+                CheckSpan(source, "source", sourceIndex, "sourceIndex", rows * cols);
+                CopyRange(0, source, sourceIndex, rows * cols, false);
+            }
+
+            /// <summary>
+            /// Copies all elements in row-major order to caller-owned native memory
+            /// </summary>
+            void CopyTo(IntPtr destination) {
+                CopyNative(destination, true);
+            }
+
+            /// <summary>
+            /// Overwrites all elements from row-major caller-owned native memory
+            /// </summary>
+            void CopyFrom(IntPtr source) {
+                CopyNative(source, false);
             }
 
             /// <summary>
@@ -106,9 +689,10 @@ namespace WindowPlus {
             /// </summary>
             static Matrix<T>^ Identity(int size) {
                 Matrix<T>^ result = gcnew Matrix<T>(size, size);
+                T one = Arithmetic<T>::One;
                 
                 for (int i = 0; i < size; i++) {
-                    result[i, i] = T(1);
+                    result[i, i] = one;
                 }
                 
                 return result;
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "../Native/Transform.h"
+#include "Vector2.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A 3 x 3 matrix stored inline, used as a 2D affine transform. Points
+        /// are row vectors (p' = p * M), so M31 and M32 hold the translation and
+        /// a * b applies a first, then b.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Matrix3x3 {
+        private:
+            double m11, m12, m13;
+            double m21, m22, m23;
+            double m31, m32, m33;
+
+        internal:
+            /// <summary>
+            /// Writes the elements in row-major order for native kernels
+            /// </summary>
+            void Store(double* m) {
+                m[0] = m11; m[1] = m12; m[2] = m13;
+                m[3] = m21; m[4] = m22; m[5] = m23;
+                m[6] = m31; m[7] = m32; m[8] = m33;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a matrix from its elements in row-major order
+            /// </summary>
+            Matrix3x3(double m11, double m12, double m13,
+                      double m21, double m22, double m23,
+                      double m31, double m32, double m33) {
+                this->m11 = m11; this->m12 = m12; this->m13 = m13;
+                this->m21 = m21; this->m22 = m22; this->m23 = m23;
+                this->m31 = m31; this->m32 = m32; this->m33 = m33;
+            }
+
+            /// <summary>
+            /// Gets the identity matrix
+            /// </summary>
+            static property Matrix3x3 Identity {
+                Matrix3x3 get() { return Matrix3x3(1, 0, 0, 0, 1, 0, 0, 0, 1); }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 1
+            /// </summary>
+            property double M11 {
+                double get() { return m11; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 2
+            /// </summary>
+            property double M12 {
+                double get() { return m12; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 3
+            /// </summary>
+            property double M13 {
+                double get() { return m13; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 1
+            /// </summary>
+            property double M21 {
+                double get() { return m21; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 2
+            /// </summary>
+            property double M22 {
+                double get() { return m22; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 3
+            /// </summary>
+            property double M23 {
+                double get() { return m23; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 1
+            /// </summary>
+            property double M31 {
+                double get() { return m31; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 2
+            /// </summary>
+            property double M32 {
+                double get() { return m32; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 3
+            /// </summary>
+            property double M33 {
+                double get() { return m33; }
+            }
+            /// <summary>
+            /// Gets whether the last column is (0, 0, 1), so the matrix is affine
+            /// </summary>
+            property bool IsAffine {
+                bool get() { return m13 == 0 && m23 == 0 && m33 == 1; }
+            }
+
+            /// <summary>
+            /// Calculates the determinant
+            /// </summary>
+            property double Determinant {
+                double get() {
+                    return m11 * (m22 * m33 - m23 * m32) -
+                           m12 * (m21 * m33 - m23 * m31) +
+                           m13 * (m21 * m32 - m22 * m31);
+                }
+            }
+
+            /// <summary>
+            /// Creates a translation
+            /// </summary>
+            static Matrix3x3 CreateTranslation(double x, double y) {
+                return Matrix3x3(1, 0, 0, 0, 1, 0, x, y, 1);
+            }
+
+            /// <summary>
+            /// Creates a scale about the origin
+            /// </summary>
+            static Matrix3x3 CreateScale(double x, double y) {
+                return Matrix3x3(x, 0, 0, 0, y, 0, 0, 0, 1);
+            }
+
+            /// <summary>
+            /// Creates a counter-clockwise rotation about the origin
+            /// </summary>
+            static Matrix3x3 CreateRotation(double radians) {
+                double c = System::Math::Cos(radians), s = System::Math::Sin(radians);
+                return Matrix3x3(c, s, 0, -s, c, 0, 0, 0, 1);
+            }
+
+            /// <summary>
+            /// Creates scale, then rotation, then translation in one step,
+            /// without multiplying the three matrices
+            /// </summary>
+            static Matrix3x3 CreateAffine(double scaleX, double scaleY, double radians,
+                                          double translateX, double translateY) {
+                double c = System::Math::Cos(radians), s = System::Math::Sin(radians);
+                return Matrix3x3(scaleX * c, scaleX * s, 0,
+                                 -scaleY * s, scaleY * c, 0,
+                                 translateX, translateY, 1);
+            }
+
+            /// <summary>
+            /// Multiplies two matrices
+            /// </summary>
+            static Matrix3x3 operator*(Matrix3x3 a, Matrix3x3 b) {
+                return Matrix3x3(
+                    a.m11 * b.m11 + a.m12 * b.m21 + a.m13 * b.m31,
+                    a.m11 * b.m12 + a.m12 * b.m22 + a.m13 * b.m32,
+                    a.m11 * b.m13 + a.m12 * b.m23 + a.m13 * b.m33,
+                    a.m21 * b.m11 + a.m22 * b.m21 + a.m23 * b.m31,
+                    a.m21 * b.m12 + a.m22 * b.m22 + a.m23 * b.m32,
+                    a.m21 * b.m13 + a.m22 * b.m23 + a.m23 * b.m33,
+                    a.m31 * b.m11 + a.m32 * b.m21 + a.m33 * b.m31,
+                    a.m31 * b.m12 + a.m32 * b.m22 + a.m33 * b.m32,
+                    a.m31 * b.m13 + a.m32 * b.m23 + a.m33 * b.m33
+                );
+            }
+
+            /// <summary>
+            /// Composes two affine transforms (a first, then b). Skips the
+            /// products with the constant last column, so it is cheaper than
+            /// a * b; the result is only correct when both inputs are affine.
+            /// </summary>
+            static Matrix3x3 MultiplyAffine(Matrix3x3 a, Matrix3x3 b) {
+                return Matrix3x3(
+                    a.m11 * b.m11 + a.m12 * b.m21, a.m11 * b.m12 + a.m12 * b.m22, 0,
+                    a.m21 * b.m11 + a.m22 * b.m21, a.m21 * b.m12 + a.m22 * b.m22, 0,
+                    a.m31 * b.m11 + a.m32 * b.m21 + b.m31, a.m31 * b.m12 + a.m32 * b.m22 + b.m32, 1
+                );
+            }
+
+            /// <summary>
+            /// Gets the transpose
+            /// </summary>
+            Matrix3x3 Transpose() {
+                return Matrix3x3(
+                    m11, m21, m31,
+                    m12, m22, m32,
+                    m13, m23, m33
+                );
+            }
+
+            /// <summary>
+            /// Tries to invert the matrix; returns false when it is singular
+            /// </summary>
+            static bool TryInvert(Matrix3x3 m, [Out] Matrix3x3% result) {
+                double c11 = m.m22 * m.m33 - m.m23 * m.m32;
+                double c12 = m.m23 * m.m31 - m.m21 * m.m33;
+                double c13 = m.m21 * m.m32 - m.m22 * m.m31;
+                double det = m.m11 * c11 + m.m12 * c12 + m.m13 * c13;
+                if (det == 0 || Double::IsNaN(det)) {
+                    result = Matrix3x3();
+                    return false;
+                }
+
+                double inv = 1 / det;
+                result = Matrix3x3(
+                    c11 * inv, (m.m13 * m.m32 - m.m12 * m.m33) * inv, (m.m12 * m.m23 - m.m13 * m.m22) * inv,
+                    c12 * inv, (m.m11 * m.m33 - m.m13 * m.m31) * inv, (m.m13 * m.m21 - m.m11 * m.m23) * inv,
+                    c13 * inv, (m.m12 * m.m31 - m.m11 * m.m32) * inv, (m.m11 * m.m22 - m.m12 * m.m21) * inv
+                );
+                return true;
+            }
+
+            /// <summary>
+            /// Inverts the matrix
+            /// </summary>
+            static Matrix3x3 Invert(Matrix3x3 matrix) {
+                Matrix3x3 result;
+                if (!TryInvert(matrix, result))
+                    throw gcnew ArgumentException("Matrix is singular");
+                return result;
+            }
+
+            /// <summary>
+            /// Transforms a point, including translation. The last column is
+            /// assumed to be (0, 0, 1).
+            /// </summary>
+            Vector2 TransformPoint(Vector2 p) {
+                return Vector2(p.X * m11 + p.Y * m21 + m31, p.X * m12 + p.Y * m22 + m32);
+            }
+
+            /// <summary>
+            /// Transforms a direction, ignoring translation
+            /// </summary>
+            Vector2 TransformVector(Vector2 v) {
+                return Vector2(v.X * m11 + v.Y * m21, v.X * m12 + v.Y * m22);
+            }
+
+            /// <summary>
+            /// Transforms count points from source into destination in one
+            /// native call. The buffers may be the same array.
+            /// </summary>
+            void TransformPoints(array<Vector2>^ source, array<Vector2>^ destination, int count) {
+                if (source == nullptr)
+                    throw gcnew ArgumentNullException("source");
+                if (destination == nullptr)
+                    throw gcnew ArgumentNullException("destination");
+                if (count < 0 || count > source->Length || count > destination->Length)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                if (count == 0)
+                    return;
+
+                double m[9];
+                Store(m);
+                pin_ptr<Vector2> ps = &source[0];
+                pin_ptr<Vector2> pd = &destination[0];
+                Native::TransformPoints2(m, reinterpret_cast<const double*>(ps), reinterpret_cast<double*>(pd), count);
+            }
+
+            /// <summary>
+            /// Converts to a general 3 x 3 matrix
+            /// </summary>
+            Matrix<double>^ ToMatrix() {
+                Matrix<double>^ result = gcnew Matrix<double>(3, 3);
+                result[0, 0] = m11; result[0, 1] = m12; result[0, 2] = m13;
+                result[1, 0] = m21; result[1, 1] = m22; result[1, 2] = m23;
+                result[2, 0] = m31; result[2, 1] = m32; result[2, 2] = m33;
+                return result;
+            }
+
+            /// <summary>
+            /// Converts a general 3 x 3 matrix
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Matrix3x3 FromMatrix(Matrix<T>^ matrix) {
+                if (matrix->Rows != 3 || matrix->Columns != 3)
+                    throw gcnew ArgumentException("Matrix must be 3 x 3");
+                return Matrix3x3(
+                    Convert::ToDouble(matrix[0, 0]), Convert::ToDouble(matrix[0, 1]), Convert::ToDouble(matrix[0, 2]),
+                    Convert::ToDouble(matrix[1, 0]), Convert::ToDouble(matrix[1, 1]), Convert::ToDouble(matrix[1, 2]),
+                    Convert::ToDouble(matrix[2, 0]), Convert::ToDouble(matrix[2, 1]), Convert::ToDouble(matrix[2, 2])
+                );
+            }
+
+            /// <summary>
+            /// Converts the matrix to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("[[{0}, {1}, {2}], [{3}, {4}, {5}], [{6}, {7}, {8}]]",
+                                      gcnew array<Object^> { m11, m12, m13, m21, m22, m23, m31, m32, m33 });
+            }
+        };
+    }
+}
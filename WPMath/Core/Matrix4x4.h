@@ -0,0 +1,458 @@
+#pragma once
+
+#include "../Native/Transform.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Quaternion.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A 4 x 4 matrix stored inline, used as a 3D transform. Points are row
+        /// vectors (p' = p * M), so M41, M42 and M43 hold the translation and
+        /// a * b applies a first, then b.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Matrix4x4 {
+        private:
+            double m11, m12, m13, m14;
+            double m21, m22, m23, m24;
+            double m31, m32, m33, m34;
+            double m41, m42, m43, m44;
+
+            static void CheckBatch(Array^ source, Array^ destination, int count) {
+                if (source == nullptr)
+                    throw gcnew ArgumentNullException("source");
+                if (destination == nullptr)
+                    throw gcnew ArgumentNullException("destination");
+                if (count < 0 || count > source->Length || count > destination->Length)
+                    throw gcnew ArgumentOutOfRangeException("count");
+            }
+
+        internal:
+            /// <summary>
+            /// Writes the elements in row-major order for native kernels
+            /// </summary>
+            void Store(double* m) {
+                m[0] = m11; m[1] = m12; m[2] = m13; m[3] = m14;
+                m[4] = m21; m[5] = m22; m[6] = m23; m[7] = m24;
+                m[8] = m31; m[9] = m32; m[10] = m33; m[11] = m34;
+                m[12] = m41; m[13] = m42; m[14] = m43; m[15] = m44;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a matrix from its elements in row-major order
+            /// </summary>
+            Matrix4x4(double m11, double m12, double m13, double m14,
+                      double m21, double m22, double m23, double m24,
+                      double m31, double m32, double m33, double m34,
+                      double m41, double m42, double m43, double m44) {
+                this->m11 = m11; this->m12 = m12; this->m13 = m13; this->m14 = m14;
+                this->m21 = m21; this->m22 = m22; this->m23 = m23; this->m24 = m24;
+                this->m31 = m31; this->m32 = m32; this->m33 = m33; this->m34 = m34;
+                this->m41 = m41; this->m42 = m42; this->m43 = m43; this->m44 = m44;
+            }
+
+            /// <summary>
+            /// Gets the identity matrix
+            /// </summary>
+            static property Matrix4x4 Identity {
+                Matrix4x4 get() { return Matrix4x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1); }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 1
+            /// </summary>
+            property double M11 {
+                double get() { return m11; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 2
+            /// </summary>
+            property double M12 {
+                double get() { return m12; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 3
+            /// </summary>
+            property double M13 {
+                double get() { return m13; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 1, column 4
+            /// </summary>
+            property double M14 {
+                double get() { return m14; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 1
+            /// </summary>
+            property double M21 {
+                double get() { return m21; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 2
+            /// </summary>
+            property double M22 {
+                double get() { return m22; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 3
+            /// </summary>
+            property double M23 {
+                double get() { return m23; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 2, column 4
+            /// </summary>
+            property double M24 {
+                double get() { return m24; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 1
+            /// </summary>
+            property double M31 {
+                double get() { return m31; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 2
+            /// </summary>
+            property double M32 {
+                double get() { return m32; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 3
+            /// </summary>
+            property double M33 {
+                double get() { return m33; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 3, column 4
+            /// </summary>
+            property double M34 {
+                double get() { return m34; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 4, column 1
+            /// </summary>
+            property double M41 {
+                double get() { return m41; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 4, column 2
+            /// </summary>
+            property double M42 {
+                double get() { return m42; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 4, column 3
+            /// </summary>
+            property double M43 {
+                double get() { return m43; }
+            }
+
+            /// <summary>
+            /// Gets the element at row 4, column 4
+            /// </summary>
+            property double M44 {
+                double get() { return m44; }
+            }
+            /// <summary>
+            /// Gets whether the last column is (0, 0, 0, 1), so the matrix is affine
+            /// </summary>
+            property bool IsAffine {
+                bool get() { return m14 == 0 && m24 == 0 && m34 == 0 && m44 == 1; }
+            }
+
+            /// <summary>
+            /// Calculates the determinant
+            /// </summary>
+            property double Determinant {
+                double get() {
+                    // Laplace expansion over the 2 x 2 minors of the top and bottom row pairs
+                    double s0 = m11 * m22 - m21 * m12, s1 = m11 * m23 - m21 * m13, s2 = m11 * m24 - m21 * m14;
+                    double s3 = m12 * m23 - m22 * m13, s4 = m12 * m24 - m22 * m14, s5 = m13 * m24 - m23 * m14;
+                    double c0 = m31 * m42 - m41 * m32, c1 = m31 * m43 - m41 * m33, c2 = m31 * m44 - m41 * m34;
+                    double c3 = m32 * m43 - m42 * m33, c4 = m32 * m44 - m42 * m34, c5 = m33 * m44 - m43 * m34;
+                    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+                }
+            }
+
+            /// <summary>
+            /// Creates a translation
+            /// </summary>
+            static Matrix4x4 CreateTranslation(Vector3 offset) {
+                return Matrix4x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, offset.X, offset.Y, offset.Z, 1);
+            }
+
+            /// <summary>
+            /// Creates a scale about the origin
+            /// </summary>
+            static Matrix4x4 CreateScale(Vector3 scale) {
+                return Matrix4x4(scale.X, 0, 0, 0, 0, scale.Y, 0, 0, 0, 0, scale.Z, 0, 0, 0, 0, 1);
+            }
+
+            /// <summary>
+            /// Creates a rotation about the X axis
+            /// </summary>
+            static Matrix4x4 CreateRotationX(double radians) {
+                double c = System::Math::Cos(radians), s = System::Math::Sin(radians);
+                return Matrix4x4(1, 0, 0, 0, 0, c, s, 0, 0, -s, c, 0, 0, 0, 0, 1);
+            }
+
+            /// <summary>
+            /// Creates a rotation about the Y axis
+            /// </summary>
+            static Matrix4x4 CreateRotationY(double radians) {
+                double c = System::Math::Cos(radians), s = System::Math::Sin(radians);
+                return Matrix4x4(c, 0, -s, 0, 0, 1, 0, 0, s, 0, c, 0, 0, 0, 0, 1);
+            }
+
+            /// <summary>
+            /// Creates a rotation about the Z axis
+            /// </summary>
+            static Matrix4x4 CreateRotationZ(double radians) {
+                double c = System::Math::Cos(radians), s = System::Math::Sin(radians);
+                return Matrix4x4(c, s, 0, 0, -s, c, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+            }
+
+            /// <summary>
+            /// Creates the rotation described by a unit quaternion
+            /// </summary>
+            static Matrix4x4 CreateFromQuaternion(Quaternion q) {
+                return CreateAffine(Vector3(1, 1, 1), q, Vector3::Zero);
+            }
+
+            /// <summary>
+            /// Creates scale, then rotation, then translation in one step,
+            /// without multiplying the three matrices
+            /// </summary>
+            static Matrix4x4 CreateAffine(Vector3 scale, Quaternion rotation, Vector3 translation) {
+                double x = rotation.X, y = rotation.Y, z = rotation.Z, w = rotation.W;
+                double xx = x * x, yy = y * y, zz = z * z;
+                double xy = x * y, xz = x * z, yz = y * z, wx = w * x, wy = w * y, wz = w * z;
+                double sx = scale.X, sy = scale.Y, sz = scale.Z;
+                return Matrix4x4(
+                    sx * (1 - 2 * (yy + zz)), sx * 2 * (xy + wz), sx * 2 * (xz - wy), 0,
+                    sy * 2 * (xy - wz), sy * (1 - 2 * (xx + zz)), sy * 2 * (yz + wx), 0,
+                    sz * 2 * (xz + wy), sz * 2 * (yz - wx), sz * (1 - 2 * (xx + yy)), 0,
+                    translation.X, translation.Y, translation.Z, 1
+                );
+            }
+
+            /// <summary>
+            /// Multiplies two matrices
+            /// </summary>
+            static Matrix4x4 operator*(Matrix4x4 a, Matrix4x4 b) {
+                return Matrix4x4(
+                    a.m11 * b.m11 + a.m12 * b.m21 + a.m13 * b.m31 + a.m14 * b.m41,
+                    a.m11 * b.m12 + a.m12 * b.m22 + a.m13 * b.m32 + a.m14 * b.m42,
+                    a.m11 * b.m13 + a.m12 * b.m23 + a.m13 * b.m33 + a.m14 * b.m43,
+                    a.m11 * b.m14 + a.m12 * b.m24 + a.m13 * b.m34 + a.m14 * b.m44,
+                    a.m21 * b.m11 + a.m22 * b.m21 + a.m23 * b.m31 + a.m24 * b.m41,
+                    a.m21 * b.m12 + a.m22 * b.m22 + a.m23 * b.m32 + a.m24 * b.m42,
+                    a.m21 * b.m13 + a.m22 * b.m23 + a.m23 * b.m33 + a.m24 * b.m43,
+                    a.m21 * b.m14 + a.m22 * b.m24 + a.m23 * b.m34 + a.m24 * b.m44,
+                    a.m31 * b.m11 + a.m32 * b.m21 + a.m33 * b.m31 + a.m34 * b.m41,
+                    a.m31 * b.m12 + a.m32 * b.m22 + a.m33 * b.m32 + a.m34 * b.m42,
+                    a.m31 * b.m13 + a.m32 * b.m23 + a.m33 * b.m33 + a.m34 * b.m43,
+                    a.m31 * b.m14 + a.m32 * b.m24 + a.m33 * b.m34 + a.m34 * b.m44,
+                    a.m41 * b.m11 + a.m42 * b.m21 + a.m43 * b.m31 + a.m44 * b.m41,
+                    a.m41 * b.m12 + a.m42 * b.m22 + a.m43 * b.m32 + a.m44 * b.m42,
+                    a.m41 * b.m13 + a.m42 * b.m23 + a.m43 * b.m33 + a.m44 * b.m43,
+                    a.m41 * b.m14 + a.m42 * b.m24 + a.m43 * b.m34 + a.m44 * b.m44
+                );
+            }
+
+            /// <summary>
+            /// Composes two affine transforms (a first, then b). Skips the
+            /// products with the constant last column, so it is cheaper than
+            /// a * b; the result is only correct when both inputs are affine.
+            /// </summary>
+            static Matrix4x4 MultiplyAffine(Matrix4x4 a, Matrix4x4 b) {
+                return Matrix4x4(
+                    a.m11 * b.m11 + a.m12 * b.m21 + a.m13 * b.m31,
+                    a.m11 * b.m12 + a.m12 * b.m22 + a.m13 * b.m32,
+                    a.m11 * b.m13 + a.m12 * b.m23 + a.m13 * b.m33, 0,
+                    a.m21 * b.m11 + a.m22 * b.m21 + a.m23 * b.m31,
+                    a.m21 * b.m12 + a.m22 * b.m22 + a.m23 * b.m32,
+                    a.m21 * b.m13 + a.m22 * b.m23 + a.m23 * b.m33, 0,
+                    a.m31 * b.m11 + a.m32 * b.m21 + a.m33 * b.m31,
+                    a.m31 * b.m12 + a.m32 * b.m22 + a.m33 * b.m32,
+                    a.m31 * b.m13 + a.m32 * b.m23 + a.m33 * b.m33, 0,
+                    a.m41 * b.m11 + a.m42 * b.m21 + a.m43 * b.m31 + b.m41,
+                    a.m41 * b.m12 + a.m42 * b.m22 + a.m43 * b.m32 + b.m42,
+                    a.m41 * b.m13 + a.m42 * b.m23 + a.m43 * b.m33 + b.m43, 1
+                );
+            }
+
+            /// <summary>
+            /// Gets the transpose
+            /// </summary>
+            Matrix4x4 Transpose() {
+                return Matrix4x4(
+                    m11, m21, m31, m41,
+                    m12, m22, m32, m42,
+                    m13, m23, m33, m43,
+                    m14, m24, m34, m44
+                );
+            }
+
+            /// <summary>
+            /// Tries to invert the matrix; returns false when it is singular
+            /// </summary>
+            static bool TryInvert(Matrix4x4 m, [Out] Matrix4x4% result) {
+                double s0 = m.m11 * m.m22 - m.m21 * m.m12, s1 = m.m11 * m.m23 - m.m21 * m.m13;
+                double s2 = m.m11 * m.m24 - m.m21 * m.m14, s3 = m.m12 * m.m23 - m.m22 * m.m13;
+                double s4 = m.m12 * m.m24 - m.m22 * m.m14, s5 = m.m13 * m.m24 - m.m23 * m.m14;
+                double c0 = m.m31 * m.m42 - m.m41 * m.m32, c1 = m.m31 * m.m43 - m.m41 * m.m33;
+                double c2 = m.m31 * m.m44 - m.m41 * m.m34, c3 = m.m32 * m.m43 - m.m42 * m.m33;
+                double c4 = m.m32 * m.m44 - m.m42 * m.m34, c5 = m.m33 * m.m44 - m.m43 * m.m34;
+                double det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+                if (det == 0 || Double::IsNaN(det)) {
+                    result = Matrix4x4();
+                    return false;
+                }
+
+                double inv = 1 / det;
+                result = Matrix4x4(
+                    (m.m22 * c5 - m.m23 * c4 + m.m24 * c3) * inv, (-m.m12 * c5 + m.m13 * c4 - m.m14 * c3) * inv,
+                    (m.m42 * s5 - m.m43 * s4 + m.m44 * s3) * inv, (-m.m32 * s5 + m.m33 * s4 - m.m34 * s3) * inv,
+                    (-m.m21 * c5 + m.m23 * c2 - m.m24 * c1) * inv, (m.m11 * c5 - m.m13 * c2 + m.m14 * c1) * inv,
+                    (-m.m41 * s5 + m.m43 * s2 - m.m44 * s1) * inv, (m.m31 * s5 - m.m33 * s2 + m.m34 * s1) * inv,
+                    (m.m21 * c4 - m.m22 * c2 + m.m24 * c0) * inv, (-m.m11 * c4 + m.m12 * c2 - m.m14 * c0) * inv,
+                    (m.m41 * s4 - m.m42 * s2 + m.m44 * s0) * inv, (-m.m31 * s4 + m.m32 * s2 - m.m34 * s0) * inv,
+                    (-m.m21 * c3 + m.m22 * c1 - m.m23 * c0) * inv, (m.m11 * c3 - m.m12 * c1 + m.m13 * c0) * inv,
+                    (-m.m41 * s3 + m.m42 * s1 - m.m43 * s0) * inv, (m.m31 * s3 - m.m32 * s1 + m.m33 * s0) * inv
+                );
+                return true;
+            }
+
+            /// <summary>
+            /// Inverts the matrix
+            /// </summary>
+            static Matrix4x4 Invert(Matrix4x4 matrix) {
+                Matrix4x4 result;
+                if (!TryInvert(matrix, result))
+                    throw gcnew ArgumentException("Matrix is singular");
+                return result;
+            }
+
+            /// <summary>
+            /// Transforms a point, including translation. The last column is
+            /// assumed to be (0, 0, 0, 1).
+            /// </summary>
+            Vector3 TransformPoint(Vector3 p) {
+                return Vector3(p.X * m11 + p.Y * m21 + p.Z * m31 + m41,
+                               p.X * m12 + p.Y * m22 + p.Z * m32 + m42,
+                               p.X * m13 + p.Y * m23 + p.Z * m33 + m43);
+            }
+
+            /// <summary>
+            /// Transforms a direction, ignoring translation
+            /// </summary>
+            Vector3 TransformVector(Vector3 v) {
+                return Vector3(v.X * m11 + v.Y * m21 + v.Z * m31,
+                               v.X * m12 + v.Y * m22 + v.Z * m32,
+                               v.X * m13 + v.Y * m23 + v.Z * m33);
+            }
+
+            /// <summary>
+            /// Transforms a homogeneous vector
+            /// </summary>
+            Vector4 Transform(Vector4 v) {
+                return Vector4(v.X * m11 + v.Y * m21 + v.Z * m31 + v.W * m41,
+                               v.X * m12 + v.Y * m22 + v.Z * m32 + v.W * m42,
+                               v.X * m13 + v.Y * m23 + v.Z * m33 + v.W * m43,
+                               v.X * m14 + v.Y * m24 + v.Z * m34 + v.W * m44);
+            }
+
+            /// <summary>
+            /// Transforms count points from source into destination in one
+            /// native call, as TransformPoint does. The buffers may be the same array.
+            /// </summary>
+            void TransformPoints(array<Vector3>^ source, array<Vector3>^ destination, int count) {
+                CheckBatch(source, destination, count);
+                if (count == 0)
+                    return;
+
+                double m[16];
+                Store(m);
+                pin_ptr<Vector3> ps = &source[0];
+                pin_ptr<Vector3> pd = &destination[0];
+                Native::TransformPoints3(m, reinterpret_cast<const double*>(ps), reinterpret_cast<double*>(pd), count);
+            }
+
+            /// <summary>
+            /// Transforms count homogeneous vectors from source into destination
+            /// in one native call. The buffers may be the same array.
+            /// </summary>
+            void Transform(array<Vector4>^ source, array<Vector4>^ destination, int count) {
+                CheckBatch(source, destination, count);
+                if (count == 0)
+                    return;
+
+                double m[16];
+                Store(m);
+                pin_ptr<Vector4> ps = &source[0];
+                pin_ptr<Vector4> pd = &destination[0];
+                Native::TransformPoints4(m, reinterpret_cast<const double*>(ps), reinterpret_cast<double*>(pd), count);
+            }
+
+            /// <summary>
+            /// Converts to a general 4 x 4 matrix
+            /// </summary>
+            Matrix<double>^ ToMatrix() {
+                Matrix<double>^ result = gcnew Matrix<double>(4, 4);
+                result[0, 0] = m11; result[0, 1] = m12; result[0, 2] = m13; result[0, 3] = m14;
+                result[1, 0] = m21; result[1, 1] = m22; result[1, 2] = m23; result[1, 3] = m24;
+                result[2, 0] = m31; result[2, 1] = m32; result[2, 2] = m33; result[2, 3] = m34;
+                result[3, 0] = m41; result[3, 1] = m42; result[3, 2] = m43; result[3, 3] = m44;
+                return result;
+            }
+
+            /// <summary>
+            /// Converts a general 4 x 4 matrix
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Matrix4x4 FromMatrix(Matrix<T>^ matrix) {
+                if (matrix->Rows != 4 || matrix->Columns != 4)
+                    throw gcnew ArgumentException("Matrix must be 4 x 4");
+                return Matrix4x4(
+                    Convert::ToDouble(matrix[0, 0]), Convert::ToDouble(matrix[0, 1]), Convert::ToDouble(matrix[0, 2]), Convert::ToDouble(matrix[0, 3]),
+                    Convert::ToDouble(matrix[1, 0]), Convert::ToDouble(matrix[1, 1]), Convert::ToDouble(matrix[1, 2]), Convert::ToDouble(matrix[1, 3]),
+                    Convert::ToDouble(matrix[2, 0]), Convert::ToDouble(matrix[2, 1]), Convert::ToDouble(matrix[2, 2]), Convert::ToDouble(matrix[2, 3]),
+                    Convert::ToDouble(matrix[3, 0]), Convert::ToDouble(matrix[3, 1]), Convert::ToDouble(matrix[3, 2]), Convert::ToDouble(matrix[3, 3])
+                );
+            }
+
+            /// <summary>
+            /// Converts the matrix to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("[[{0}, {1}, {2}, {3}], [{4}, {5}, {6}, {7}], [{8}, {9}, {10}, {11}], [{12}, {13}, {14}, {15}]]",
+                                      gcnew array<Object^> { m11, m12, m13, m14, m21, m22, m23, m24,
+                                                             m31, m32, m33, m34, m41, m42, m43, m44 });
+            }
+        };
+    }
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "Arithmetic.h"
+#include "LUDecomposition.h"
+#include "QRDecomposition.h"
+#include "SingularValueDecomposition.h"
+
 using namespace System;
 
 namespace WindowPlus {
@@ -8,9 +13,28 @@ namespace WindowPlus {
         /// Provides advanced matrix operations
         /// </summary>
         public ref class MatrixOperations {
+        private:
+            /// <summary>
+            /// LU-factors a row-major copy held in a pooled buffer and returns
+            /// the determinant
+            /// </summary>
+            static double PooledDeterminant(array<double>^ lu, int n) {
+                array<int>^ permutation = BufferPool::Rent<int>(n);
+                try {
+                    double determinant;
+                    LUDecomposition::FactorInPlace(lu, permutation, n, determinant);
+                    return determinant;
+                }
+                finally {
+                    BufferPool::Return(permutation);
+                }
+            }
+
         public:
             /// <summary>
-            /// Calculates the determinant of a square matrix using LU decomposition
+            /// Calculates the determinant of a square matrix using LU decomposition.
+            /// Factor once with LUDecomposition when more than the determinant is needed.
+            /// Scratch memory comes from the BufferPool.
             /// </summary>
             generic<typename T>
             where T : value class
@@ -19,56 +43,34 @@ namespace WindowPlus {
                     throw gcnew ArgumentException("Matrix must be square");
 
                 int n = matrix->Rows;
-                array<double, 2>^ lu = gcnew array<double, 2>(n, n);
-                array<int>^ perm = gcnew array<int>(n);
-                int toggle = 1;
-
-                // Copy matrix to working array
-                for (int i = 0; i < n; ++i)
-                    for (int j = 0; j < n; ++j)
-                        lu[i, j] = (double)matrix[i, j];
-
-                // Initialize permutation array
-                for (int i = 0; i < n; ++i)
-                    perm[i] = i;
-
-                // LU decomposition
-                for (int j = 0; j < n - 1; ++j) {
-                    double max = Math::Abs(lu[j, j]);
-                    int piv = j;
-
-                    for (int i = j + 1; i < n; ++i) {
-                        double xij = Math::Abs(lu[i, j]);
-                        if (xij > max) {
-                            max = xij;
-                            piv = i;
-                        }
-                    }
-
-                    if (piv != j) {
-                        for (int k = 0; k < n; ++k) {
-                            double tmp = lu[piv, k];
-                            lu[piv, k] = lu[j, k];
-                            lu[j, k] = tmp;
-                        }
-                        int tmp = perm[piv];
-                        perm[piv] = perm[j];
-                        perm[j] = tmp;
-                        toggle = -toggle;
-                    }
-
-                    for (int i = j + 1; i < n; ++i) {
-                        lu[i, j] /= lu[j, j];
-                        for (int k = j + 1; k < n; ++k)
-                            lu[i, k] -= lu[i, j] * lu[j, k];
-                    }
+                array<double>^ lu = BufferPool::Rent<double>(n * n);
+                try {
+                    matrix->CopyToRowMajorDouble(lu);
+                    return PooledDeterminant(lu, n);
                 }
+                finally {
+                    BufferPool::Return(lu);
+                }
+            }
 
-                double det = toggle;
-                for (int i = 0; i < n; ++i)
-                    det *= lu[i, i];
+            /// <summary>
+            /// Calculates the determinant of a square view
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static double Determinant(MatrixView<T>^ view) {
+                if (view->Rows != view->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
 
-                return det;
+                int n = view->Rows;
+                array<double>^ lu = BufferPool::Rent<double>(n * n);
+                try {
+                    view->CopyToRowMajorDouble(lu);
+                    return PooledDeterminant(lu, n);
+                }
+                finally {
+                    BufferPool::Return(lu);
+                }
             }
 
             /// <summary>
@@ -77,90 +79,122 @@ namespace WindowPlus {
             generic<typename T>
             where T : value class
             static Matrix<double>^ Inverse(Matrix<T>^ matrix) {
-                if (matrix->Rows != matrix->Columns)
-                    throw gcnew ArgumentException("Matrix must be square");
-
-                if (Math::Abs(Determinant(matrix)) < 1e-10)
+                LUDecomposition^ lu = LUDecomposition::Factor(matrix);
+                if (lu->IsSingular)
                     throw gcnew ArgumentException("Matrix is singular");
 
+                return lu->Inverse();
+            }
+
+            /// <summary>
+            /// Writes the inverse of a matrix into a result of the same size,
+            /// which may be the matrix itself, without allocating
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static void Inverse(Matrix<T>^ matrix, Matrix<double>^ result) {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
                 int n = matrix->Rows;
-                Matrix<double>^ result = gcnew Matrix<double>(n, n);
-                array<double, 2>^ augmented = gcnew array<double, 2>(n, 2 * n);
-
-                // Create augmented matrix [A|I]
-                for (int i = 0; i < n; i++) {
-                    for (int j = 0; j < n; j++) {
-                        augmented[i, j] = (double)matrix[i, j];
-                        augmented[i, j + n] = (i == j) ? 1.0 : 0.0;
-                    }
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                if (result->Rows != n || result->Columns != n)
+                    throw gcnew ArgumentException("Result matrix has the wrong dimensions", "result");
+                if (n == 0)
+                    return;
+
+                array<double>^ lu = BufferPool::Rent<double>(n * n);
+                array<double>^ identity = BufferPool::Rent<double>(n * n);
+                array<int>^ permutation = BufferPool::Rent<int>(n);
+                try {
+                    matrix->CopyToRowMajorDouble(lu);
+                    double determinant;
+                    if (LUDecomposition::FactorInPlace(lu, permutation, n, determinant) < n)
+                        throw gcnew ArgumentException("Matrix is singular");
+
+                    Array::Clear(identity, 0, n * n);
+                    for (int i = 0; i < n; i++)
+                        identity[i * n + i] = 1;
+                    // The factors are a private copy, so result may be matrix
+                    pin_ptr<double> pa = &lu[0];
+                    pin_ptr<int> pp = &permutation[0];
+                    pin_ptr<double> pb = &identity[0];
+                    pin_ptr<double> px = &result->Elements[0, 0];
+                    Native::LuSolve(pa, n, pp, pb, n, px);
                 }
-
-                // Gaussian elimination
-                for (int i = 0; i < n; i++) {
-                    double pivot = augmented[i, i];
-                    for (int j = 0; j < 2 * n; j++)
-                        augmented[i, j] /= pivot;
-
-                    for (int k = 0; k < n; k++) {
-                        if (k != i) {
-                            double factor = augmented[k, i];
-                            for (int j = 0; j < 2 * n; j++)
-                                augmented[k, j] -= factor * augmented[i, j];
-                        }
-                    }
+                finally {
+                    BufferPool::Return(permutation);
+                    BufferPool::Return(identity);
+                    BufferPool::Return(lu);
                 }
-
-                // Extract inverse from augmented matrix
-                for (int i = 0; i < n; i++)
-                    for (int j = 0; j < n; j++)
-                        result[i, j] = augmented[i, j + n];
-
-                return result;
             }
 
             /// <summary>
-            /// Calculates the rank of a matrix
+            /// Calculates the rank of a matrix as the number of singular values
+            /// above the relative rank tolerance. Only the values are computed,
+            /// with scratch memory from the BufferPool.
             /// </summary>
             generic<typename T>
             where T : value class
             static int Rank(Matrix<T>^ matrix) {
-                int m = matrix->Rows;
-                int n = matrix->Columns;
-                array<double, 2>^ temp = gcnew array<double, 2>(m, n);
-
-                // Copy matrix to working array
-                for (int i = 0; i < m; i++)
-                    for (int j = 0; j < n; j++)
-                        temp[i, j] = (double)matrix[i, j];
-
-                int rank = 0;
-                array<bool>^ rowUsed = gcnew array<bool>(m);
-
-                for (int j = 0; j < n; j++) {
-                    int i;
-                    for (i = 0; i < m; i++) {
-                        if (!rowUsed[i] && Math::Abs(temp[i, j]) > 1e-10)
-                            break;
-                    }
-
-                    if (i < m) {
-                        rank++;
-                        rowUsed[i] = true;
-                        for (int p = i + 1; p < m; p++) {
-                            if (Math::Abs(temp[p, j]) > 1e-10) {
-                                double factor = temp[p, j] / temp[i, j];
-                                for (int k = j; k < n; k++)
-                                    temp[p, k] -= factor * temp[i, k];
-                            }
-                        }
-                    }
+                int m = matrix->Rows, n = matrix->Columns;
+                int p = System::Math::Min(m, n);
+                array<double>^ a = BufferPool::Rent<double>(m * n);
+                array<double>^ values = BufferPool::Rent<double>(p);
+                try {
+                    matrix->CopyToRowMajorDouble(a);
+                    SingularValueDecomposition::ComputeValues(a, m, n, values);
+                    if (p == 0)
+                        return 0;
+                    pin_ptr<double> ps = &values[0];
+                    return Native::SvdRank(ps, p, Native::RankTolerance(m, n));
+                }
+                finally {
+                    BufferPool::Return(values);
+                    BufferPool::Return(a);
                 }
+            }
 
-                return rank;
+            /// <summary>
+            /// Calculates the 2-norm condition number, the ratio of the largest
+            /// to the smallest singular value (infinite when singular)
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static double ConditionNumber(Matrix<T>^ matrix) {
+                int m = matrix->Rows, n = matrix->Columns;
+                int p = System::Math::Min(m, n);
+                if (p == 0)
+                    return 0;
+
+                array<double>^ a = BufferPool::Rent<double>(m * n);
+                array<double>^ values = BufferPool::Rent<double>(p);
+                try {
+                    matrix->CopyToRowMajorDouble(a);
+                    SingularValueDecomposition::ComputeValues(a, m, n, values);
+                    return values[p - 1] == 0 ? Double::PositiveInfinity : values[0] / values[p - 1];
+                }
+                finally {
+                    BufferPool::Return(values);
+                    BufferPool::Return(a);
+                }
+            }
+
+            /// <summary>
+            /// Calculates the Moore-Penrose pseudo-inverse of a matrix of any
+            /// shape from its singular value decomposition. Equals Inverse for
+            /// nonsingular square matrices.
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Matrix<double>^ PseudoInverse(Matrix<T>^ matrix) {
+                return SingularValueDecomposition::Factor(matrix)->PseudoInverse();
             }
 
             /// <summary>
-            /// Calculates the trace of a square matrix
+            /// Calculates the trace of a square matrix, accumulated in double
+            /// and rounded once into T; exact for Int32 and Fixed, which throw
+            /// OverflowException when the sum does not fit
             /// </summary>
             generic<typename T>
             where T : value class
@@ -168,10 +202,45 @@ namespace WindowPlus {
                 if (matrix->Rows != matrix->Columns)
                     throw gcnew ArgumentException("Matrix must be square");
 
-                T sum = T();
-                for (int i = 0; i < matrix->Rows; i++)
-                    sum += matrix[i, i];
-                return sum;
+                return Arithmetic<T>::Sum(matrix->Elements, 0, matrix->Columns + 1, matrix->Rows);
+            }
+
+            /// <summary>
+            /// Calculates the trace of a square matrix in double with the given
+            /// summation
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static double Trace(Matrix<T>^ matrix, Summation summation) {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                return Arithmetic<T>::Sum(matrix->Elements, 0, matrix->Columns + 1, matrix->Rows, summation);
+            }
+
+            /// <summary>
+            /// Calculates the trace of a square view
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static T Trace(MatrixView<T>^ view) {
+                if (view->Rows != view->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                return Arithmetic<T>::Sum(view->Storage, view->Offset, view->RowStride + view->ColumnStride, view->Rows);
+            }
+
+            /// <summary>
+            /// Calculates the trace of a square view in double with the given
+            /// summation
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static double Trace(MatrixView<T>^ view, Summation summation) {
+                if (view->Rows != view->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                return Arithmetic<T>::Sum(view->Storage, view->Offset, view->RowStride + view->ColumnStride, view->Rows, summation);
             }
         };
     }
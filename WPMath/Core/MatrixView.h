@@ -0,0 +1,221 @@
+#pragma once
+
+#include "../Native/Gemm.h"
+#include "Arithmetic.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A zero-copy window over the storage of a Matrix: transposes, row and
+        /// column slices and strided blocks. Reads and writes go straight to the
+        /// underlying matrix.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class MatrixView {
+        private:
+            array<T, 2>^ storage;
+            int rows, cols;
+            // Element (i, j) maps to storage[row0 + i * rowByRow + j * rowByCol,
+            //                              col0 + i * colByRow + j * colByCol].
+            int row0, col0;
+            int rowByRow, colByRow;
+            int rowByCol, colByCol;
+
+            MatrixView(array<T, 2>^ storage, int rows, int cols, int row0, int col0,
+                       int rowByRow, int colByRow, int rowByCol, int colByCol) {
+                this->storage = storage;
+                this->rows = rows;
+                this->cols = cols;
+                this->row0 = row0;
+                this->col0 = col0;
+                this->rowByRow = rowByRow;
+                this->colByRow = colByRow;
+                this->rowByCol = rowByCol;
+                this->colByCol = colByCol;
+            }
+
+        internal:
+            /// <summary>
+            /// Creates a view covering a whole storage array
+            /// </summary>
+            MatrixView(array<T, 2>^ storage) {
+                this->storage = storage;
+                rows = storage->GetLength(0);
+                cols = storage->GetLength(1);
+                row0 = col0 = 0;
+                rowByRow = 1;
+                colByRow = 0;
+                rowByCol = 0;
+                colByCol = 1;
+            }
+
+            /// <summary>
+            /// Gets the viewed storage array
+            /// </summary>
+            property array<T, 2>^ Storage {
+                array<T, 2>^ get() { return storage; }
+            }
+
+            /// <summary>
+            /// Gets whether the view covers its storage exactly in row-major order
+            /// </summary>
+            property bool IsContiguous {
+                bool get() {
+                    return row0 == 0 && col0 == 0 && rowByRow == 1 && colByRow == 0 && rowByCol == 0 && colByCol == 1 &&
+                           rows == storage->GetLength(0) && cols == storage->GetLength(1);
+                }
+            }
+
+            /// <summary>
+            /// Describes the view as a strided operand relative to a pinned
+            /// pointer to storage[0, 0]
+            /// </summary>
+            Native::ConstMatrixRef<double> ToNative(const double* base) {
+                Native::ConstMatrixRef<double> ref = { base + Offset, rows, cols, RowStride, ColumnStride };
+                return ref;
+            }
+
+            Native::ConstMatrixRef<float> ToNative(const float* base) {
+                Native::ConstMatrixRef<float> ref = { base + Offset, rows, cols, RowStride, ColumnStride };
+                return ref;
+            }
+
+            /// <summary>
+            /// Gets the flat row-major offset of element (0, 0) in the storage
+            /// </summary>
+            property long long Offset {
+                long long get() { return row0 * (long long)storage->GetLength(1) + col0; }
+            }
+
+            /// <summary>
+            /// Gets the flat distance between consecutive rows of the view
+            /// </summary>
+            property long long RowStride {
+                long long get() { return rowByRow * (long long)storage->GetLength(1) + colByRow; }
+            }
+
+            /// <summary>
+            /// Gets the flat distance between consecutive columns of the view
+            /// </summary>
+            property long long ColumnStride {
+                long long get() { return rowByCol * (long long)storage->GetLength(1) + colByCol; }
+            }
+
+            /// <summary>
+            /// Copies the viewed elements into a new row-major array of doubles
+            /// </summary>
+            array<double>^ ToRowMajorDouble() {
+                array<double>^ result = gcnew array<double>(rows * cols);
+                CopyToRowMajorDouble(result);
+                return result;
+            }
+
+            /// <summary>
+            /// Copies the viewed elements as doubles into the start of a
+            /// row-major buffer, such as one rented from the BufferPool
+            /// </summary>
+            void CopyToRowMajorDouble(array<double>^ destination) {
+                int index = 0;
+                for (int i = 0; i < rows; i++) {
+                    int r = row0 + i * rowByRow, c = col0 + i * colByRow;
+                    for (int j = 0; j < cols; j++)
+                        destination[index++] = Arithmetic<T>::ToDouble(storage[r + j * rowByCol, c + j * colByCol]);
+                }
+            }
+
+        public:
+            /// <summary>
+            /// Gets or sets element at specified position of the view
+            /// </summary>
+            property T default[int, int] {
+                T get(int row, int col) {
+                    if (row < 0 || row >= rows || col < 0 || col >= cols)
+                        throw gcnew ArgumentOutOfRangeException();
+                    return storage[row0 + row * rowByRow + col * rowByCol, col0 + row * colByRow + col * colByCol];
+                }
+                void set(int row, int col, T value) {
+                    if (row < 0 || row >= rows || col < 0 || col >= cols)
+                        throw gcnew ArgumentOutOfRangeException();
+                    storage[row0 + row * rowByRow + col * rowByCol, col0 + row * colByRow + col * colByCol] = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets number of rows
+            /// </summary>
+            property int Rows {
+                int get() { return rows; }
+            }
+
+            /// <summary>
+            /// Gets number of columns
+            /// </summary>
+            property int Columns {
+                int get() { return cols; }
+            }
+
+            /// <summary>
+            /// Gets a transposed view of this view
+            /// </summary>
+            MatrixView<T>^ Transpose() {
+                return gcnew MatrixView<T>(storage, cols, rows, row0, col0, rowByCol, colByCol, rowByRow, colByRow);
+            }
+
+            /// <summary>
+            /// Gets a view of a rectangular block
+            /// </summary>
+            MatrixView<T>^ Block(int row, int col, int blockRows, int blockCols) {
+                return Block(row, col, blockRows, blockCols, 1, 1);
+            }
+
+            /// <summary>
+            /// Gets a view of every rowStep-th row and colStep-th column of a block
+            /// starting at (row, col)
+            /// </summary>
+            MatrixView<T>^ Block(int row, int col, int blockRows, int blockCols, int rowStep, int colStep) {
+                if (rowStep < 1 || colStep < 1)
+                    throw gcnew ArgumentOutOfRangeException(rowStep < 1 ? "rowStep" : "colStep");
+                if (blockRows < 0 || blockCols < 0 || row < 0 || col < 0 ||
+                    (blockRows > 0 && row + (long long)(blockRows - 1) * rowStep >= rows) ||
+                    (blockCols > 0 && col + (long long)(blockCols - 1) * colStep >= cols))
+                    throw gcnew ArgumentOutOfRangeException();
+
+                return gcnew MatrixView<T>(storage, blockRows, blockCols,
+                                           row0 + row * rowByRow + col * rowByCol,
+                                           col0 + row * colByRow + col * colByCol,
+                                           rowByRow * rowStep, colByRow * rowStep,
+                                           rowByCol * colStep, colByCol * colStep);
+            }
+
+            /// <summary>
+            /// Gets a 1 x Columns view of a row
+            /// </summary>
+            MatrixView<T>^ Row(int row) {
+                return Block(row, 0, 1, cols);
+            }
+
+            /// <summary>
+            /// Gets a Rows x 1 view of a column
+            /// </summary>
+            MatrixView<T>^ Column(int col) {
+                return Block(0, col, rows, 1);
+            }
+
+            /// <summary>
+            /// Copies the viewed elements into a new 2D array
+            /// </summary>
+            array<T, 2>^ ToArray() {
+                array<T, 2>^ result = gcnew array<T, 2>(rows, cols);
+                for (int i = 0; i < rows; i++) {
+                    int r = row0 + i * rowByRow, c = col0 + i * colByRow;
+                    for (int j = 0; j < cols; j++)
+                        result[i, j] = storage[r + j * rowByCol, c + j * colByCol];
+                }
+                return result;
+            }
+        };
+    }
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "../Native/Gemm.h"
+#include "Arithmetic.h"
+#include "BufferPool.h"
+#include "NativeStorage.h"
+#include "Parallelism.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A row-major matrix stored in aligned native memory. Use it for data
+        /// that is exchanged with native code or multiplied repeatedly: kernels
+        /// read the storage directly with no pinning or copying.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class NativeMatrix {
+        private:
+            NativeStorage<T>^ storage;
+            int rows, cols;
+
+            void CheckRow(int row) {
+                if (row < 0 || row >= rows)
+                    throw gcnew ArgumentOutOfRangeException("row");
+            }
+
+            void CheckColumn(int col) {
+                if (col < 0 || col >= cols)
+                    throw gcnew ArgumentOutOfRangeException("col");
+            }
+
+            static void MultiplyNative(const double* a, const double* b, double* c, int m, int n, int k,
+                                       int degreeOfParallelism) {
+                if (degreeOfParallelism == 1 || (long long)m * n * k < Parallelism::MultiplyThreshold)
+                    Native::Gemm(m, n, k, a, b, c);
+                else
+                    Native::GemmParallel(Native::RowMajor(a, m, k), Native::RowMajor(b, k, n), c, n, degreeOfParallelism);
+            }
+
+            static void MultiplyNative(const float* a, const float* b, float* c, int m, int n, int k,
+                                       int degreeOfParallelism) {
+                if (degreeOfParallelism == 1 || (long long)m * n * k < Parallelism::MultiplyThreshold)
+                    Native::Gemm(m, n, k, a, b, c);
+                else
+                    Native::GemmParallel(Native::RowMajor(a, m, k), Native::RowMajor(b, k, n), c, n, degreeOfParallelism);
+            }
+
+        public:
+            /// <summary>
+            /// Creates a zeroed matrix with specified dimensions
+            /// </summary>
+            NativeMatrix(int rows, int cols) {
+                if (rows < 0 || cols < 0)
+                    throw gcnew ArgumentOutOfRangeException(rows < 0 ? "rows" : "cols");
+                this->rows = rows;
+                this->cols = cols;
+                storage = gcnew NativeStorage<T>((long long)rows * cols);
+            }
+
+            /// <summary>
+            /// Releases the native memory
+            /// </summary>
+            ~NativeMatrix() {
+                delete storage;
+            }
+
+            /// <summary>
+            /// Creates a native copy of a managed matrix
+            /// </summary>
+            static NativeMatrix<T>^ FromMatrix(Matrix<T>^ matrix) {
+                NativeMatrix<T>^ result = gcnew NativeMatrix<T>(matrix->Rows, matrix->Columns);
+                matrix->CopyTo(result->Pointer);
+                return result;
+            }
+
+            /// <summary>
+            /// Copies the elements into a new managed matrix
+            /// </summary>
+            Matrix<T>^ ToMatrix() {
+                Matrix<T>^ result = gcnew Matrix<T>(rows, cols);
+                result->CopyFrom(Pointer);
+                GC::KeepAlive(this);
+                return result;
+            }
+
+            /// <summary>
+            /// Gets number of rows
+            /// </summary>
+            property int Rows {
+                int get() { return rows; }
+            }
+
+            /// <summary>
+            /// Gets number of columns
+            /// </summary>
+            property int Columns {
+                int get() { return cols; }
+            }
+
+            /// <summary>
+            /// Gets the underlying storage
+            /// </summary>
+            property NativeStorage<T>^ Storage {
+                NativeStorage<T>^ get() { return storage; }
+            }
+
+            /// <summary>
+            /// Gets the address of element (0, 0); rows are Columns elements apart
+            /// </summary>
+            property IntPtr Pointer {
+                IntPtr get() { return storage->Pointer; }
+            }
+
+            /// <summary>
+            /// Gets or sets element at specified position
+            /// </summary>
+            property T default[int, int] {
+                T get(int row, int col) {
+                    if (row < 0 || row >= rows || col < 0 || col >= cols)
+                        throw gcnew ArgumentOutOfRangeException();
+                    return storage[(long long)row * cols + col];
+                }
+                void set(int row, int col, T value) {
+                    if (row < 0 || row >= rows || col < 0 || col >= cols)
+                        throw gcnew ArgumentOutOfRangeException();
+                    storage[(long long)row * cols + col] = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets the address of the first element of a row. The address is
+            /// only valid while the matrix is reachable; call GC.KeepAlive on
+            /// it after the last native use.
+            /// </summary>
+            IntPtr RowPointer(int row) {
+                CheckRow(row);
+                return IntPtr(static_cast<unsigned char*>(storage->Data) +
+                              (long long)row * cols * ElementInfo<T>::Size);
+            }
+
+            /// <summary>
+            /// Copies a row into a buffer
+            /// </summary>
+            void CopyRowTo(int row, array<T>^ destination, int destinationIndex) {
+                CheckRow(row);
+                storage->CopyTo((long long)row * cols, destination, destinationIndex, cols);
+            }
+
+            /// <summary>
+            /// Overwrites a row from a buffer
+            /// </summary>
+            void SetRow(int row, array<T>^ source, int sourceIndex) {
+                CheckRow(row);
+                storage->CopyFrom(source, sourceIndex, (long long)row * cols, cols);
+            }
+
+            /// <summary>
+            /// Copies a column into a buffer
+            /// </summary>
+            void CopyColumnTo(int col, array<T>^ destination, int destinationIndex) {
+                CheckColumn(col);
+                if (destinationIndex < 0 || destinationIndex > destination->Length - rows)
+                    throw gcnew ArgumentOutOfRangeException("destinationIndex");
+                for (int i = 0; i < rows; i++)
+                    destination[destinationIndex + i] = storage[(long long)i * cols + col];
+            }
+
+            /// <summary>
+            /// Overwrites a column from a buffer
+            /// </summary>
+            void SetColumn(int col, array<T>^ source, int sourceIndex) {
+                CheckColumn(col);
+                if (sourceIndex < 0 || sourceIndex > source->Length - rows)
+                    throw gcnew ArgumentOutOfRangeException("sourceIndex");
+                for (int i = 0; i < rows; i++)
+                    storage[(long long)i * cols + col] = source[sourceIndex + i];
+            }
+
+            /// <summary>
+            /// Multiplies matrix by another native matrix, using the global
+            /// Parallelism settings
+            /// </summary>
+            NativeMatrix<T>^ Multiply(NativeMatrix<T>^ other) {
+                return Multiply(other, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Multiplies matrix by another native matrix using at most the given
+            /// number of threads (0 means all hardware threads)
+            /// </summary>
+            NativeMatrix<T>^ Multiply(NativeMatrix<T>^ other, int degreeOfParallelism) {
+                if (cols != other->rows)
+                    throw gcnew ArgumentException("Matrix dimensions do not match for multiplication");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+
+                NativeMatrix<T>^ result = gcnew NativeMatrix<T>(rows, other->cols);
+                if (rows == 0 || other->cols == 0 || cols == 0)
+                    return result;
+
+                if (T::typeid == Double::typeid || T::typeid == Single::typeid) {
+                    if (T::typeid == Double::typeid)
+                        MultiplyNative(static_cast<const double*>(storage->Data), static_cast<const double*>(other->storage->Data),
+                                       static_cast<double*>(result->storage->Data), rows, other->cols, cols, degreeOfParallelism);
+                    else
+                        MultiplyNative(static_cast<const float*>(storage->Data), static_cast<const float*>(other->storage->Data),
+                                       static_cast<float*>(result->storage->Data), rows, other->cols, cols, degreeOfParallelism);
+                    // Only raw addresses reach the kernel: keep the owners, and
+                    // so their finalizers, away until it has returned
+                    GC::KeepAlive(this);
+                    GC::KeepAlive(other);
+                    GC::KeepAlive(result);
+                    return result;
+                }
+
+                // Int32 and Int64 go through Arithmetic, one packed row and
+                // column at a time
+                array<T>^ row = BufferPool::Rent<T>(cols);
+                array<T>^ column = BufferPool::Rent<T>(cols);
+                try {
+                    for (int j = 0; j < other->cols; j++) {
+                        for (int k = 0; k < cols; k++)
+                            column[k] = other->storage[(long long)k * other->cols + j];
+                        for (int i = 0; i < rows; i++) {
+                            for (int k = 0; k < cols; k++)
+                                row[k] = storage[(long long)i * cols + k];
+                            result->storage[(long long)i * other->cols + j] = Arithmetic<T>::Dot(row, column, cols);
+                        }
+                    }
+                }
+                finally {
+                    BufferPool::Return(column);
+                    BufferPool::Return(row);
+                }
+
+                return result;
+            }
+        };
+    }
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "../Native/Platform.h"
+
+#include <cstring>
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Size information for element types that can be block-copied
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        private ref class ElementInfo abstract sealed {
+        public:
+            /// <summary>
+            /// Size in bytes of a primitive T, or 0 when T is not primitive and
+            /// must be copied element by element
+            /// </summary>
+            static initonly int Size = T::typeid->IsPrimitive ? Buffer::ByteLength(gcnew array<T>(1)) : 0;
+        };
+
+        /// <summary>
+        /// A fixed-length block of aligned, contiguous native memory holding
+        /// double, float, int or long elements. The address never moves, so it
+        /// can be handed to native code without pinning, but the owner must
+        /// stay reachable (GC.KeepAlive) until that code returns or the
+        /// finalizer may free it. Dispose to release it early.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class NativeStorage {
+        private:
+            unsigned char* data;
+            long long length;
+            int elementSize;
+
+            void CheckRange(long long index, long long count, long long available) {
+                if (!data)
+                    throw gcnew ObjectDisposedException("NativeStorage");
+                if (index < 0 || count < 0 || index + count > available)
+                    throw gcnew ArgumentOutOfRangeException();
+            }
+
+        internal:
+            /// <summary>
+            /// Gets the raw address for kernels inside this assembly
+            /// </summary>
+            property void* Data {
+                void* get() {
+                    if (!data)
+                        throw gcnew ObjectDisposedException("NativeStorage");
+                    return data;
+                }
+            }
+
+        public:
+            /// <summary>
+            /// Allocates zeroed storage for the given number of elements
+            /// </summary>
+            NativeStorage(long long length) {
+                if (length < 0)
+                    throw gcnew ArgumentOutOfRangeException("length");
+                if (T::typeid != Double::typeid && T::typeid != Single::typeid &&
+                    T::typeid != Int32::typeid && T::typeid != Int64::typeid)
+                    throw gcnew NotSupportedException("Native storage supports double, float, int and long elements");
+                elementSize = ElementInfo<T>::Size;
+
+                long long bytes = length * elementSize;
+                data = static_cast<unsigned char*>(Native::AlignedAlloc((size_t)bytes));
+                memset(data, 0, (size_t)bytes);
+                this->length = length;
+                if (bytes > 0)
+                    GC::AddMemoryPressure(bytes);
+            }
+
+            ~NativeStorage() {
+                this->!NativeStorage();
+            }
+
+            !NativeStorage() {
+                if (data) {
+                    Native::AlignedFree(data);
+                    data = nullptr;
+                    if (length > 0)
+                        GC::RemoveMemoryPressure(length * elementSize);
+                }
+            }
+
+            /// <summary>
+            /// Gets the number of elements
+            /// </summary>
+            property long long Length {
+                long long get() { return length; }
+            }
+
+            /// <summary>
+            /// Gets the address of the first element (64-byte aligned)
+            /// </summary>
+            property IntPtr Pointer {
+                IntPtr get() { return IntPtr(Data); }
+            }
+
+            /// <summary>
+            /// Gets or sets element at specified index
+            /// </summary>
+            property T default[long long] {
+                // The type tests and box/unbox pairs fold away when the JIT
+                // specializes this class for a value type.
+                T get(long long index) {
+                    CheckRange(index, 1, length);
+                    if (T::typeid == Double::typeid)
+                        return safe_cast<T>(reinterpret_cast<double*>(data)[index]);
+                    if (T::typeid == Single::typeid)
+                        return safe_cast<T>(reinterpret_cast<float*>(data)[index]);
+                    if (T::typeid == Int32::typeid)
+                        return safe_cast<T>(reinterpret_cast<int*>(data)[index]);
+                    return safe_cast<T>(reinterpret_cast<long long*>(data)[index]);
+                }
+                void set(long long index, T value) {
+                    CheckRange(index, 1, length);
+                    if (T::typeid == Double::typeid)
+                        reinterpret_cast<double*>(data)[index] = safe_cast<double>(value);
+                    else if (T::typeid == Single::typeid)
+                        reinterpret_cast<float*>(data)[index] = safe_cast<float>(value);
+                    else if (T::typeid == Int32::typeid)
+                        reinterpret_cast<int*>(data)[index] = safe_cast<int>(value);
+                    else
+                        reinterpret_cast<long long*>(data)[index] = safe_cast<long long>(value);
+                }
+            }
+
+            /// <summary>
+            /// Copies count elements from a managed array into this storage
+            /// </summary>
+            void CopyFrom(array<T>^ source, int sourceIndex, long long destinationIndex, int count) {
+                CheckRange(sourceIndex, count, source->Length);
+                CheckRange(destinationIndex, count, length);
+                IntPtr destination(data + destinationIndex * elementSize);
+                Object^ boxed = source;
+                if (T::typeid == Double::typeid)
+                    Marshal::Copy(safe_cast<array<double>^>(boxed), sourceIndex, destination, count);
+                else if (T::typeid == Single::typeid)
+                    Marshal::Copy(safe_cast<array<float>^>(boxed), sourceIndex, destination, count);
+                else if (T::typeid == Int32::typeid)
+                    Marshal::Copy(safe_cast<array<int>^>(boxed), sourceIndex, destination, count);
+                else
+                    Marshal::Copy(safe_cast<array<long long>^>(boxed), sourceIndex, destination, count);
+
+                GC::KeepAlive(this);
+            }
+
+            /// <summary>
+            /// Copies count elements from this storage into a managed array
+            /// </summary>
+            void CopyTo(long long sourceIndex, array<T>^ destination, int destinationIndex, int count) {
+                CheckRange(sourceIndex, count, length);
+                CheckRange(destinationIndex, count, destination->Length);
+                IntPtr source(data + sourceIndex * elementSize);
+                Object^ boxed = destination;
+                if (T::typeid == Double::typeid)
+                    Marshal::Copy(source, safe_cast<array<double>^>(boxed), destinationIndex, count);
+                else if (T::typeid == Single::typeid)
+                    Marshal::Copy(source, safe_cast<array<float>^>(boxed), destinationIndex, count);
+                else if (T::typeid == Int32::typeid)
+                    Marshal::Copy(source, safe_cast<array<int>^>(boxed), destinationIndex, count);
+                else
+                    Marshal::Copy(source, safe_cast<array<long long>^>(boxed), destinationIndex, count);
+
+                GC::KeepAlive(this);
+            }
+
+            /// <summary>
+            /// Copies count elements from caller-owned native memory
+            /// </summary>
+            void CopyFrom(IntPtr source, long long destinationIndex, long long count) {
+                CheckRange(destinationIndex, count, length);
+                memcpy(data + destinationIndex * elementSize, source.ToPointer(), (size_t)(count * elementSize));
+
+                GC::KeepAlive(this);
+            }
+
+            /// <summary>
+            /// Copies count elements into caller-owned native memory
+            /// </summary>
+            void CopyTo(long long sourceIndex, IntPtr destination, long long count) {
+                CheckRange(sourceIndex, count, length);
+                memcpy(destination.ToPointer(), data + sourceIndex * elementSize, (size_t)(count * elementSize));
+
+                GC::KeepAlive(this);
+            }
+        };
+    }
+}
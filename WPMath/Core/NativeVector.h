@@ -0,0 +1,101 @@
+#pragma once
+
+#include "NativeStorage.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A vector stored in aligned native memory, for data that is exchanged
+        /// with native code without pinning or per-element copying
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class NativeVector {
+        private:
+            NativeStorage<T>^ storage;
+            int size;
+
+        public:
+            /// <summary>
+            /// Creates a zeroed vector with specified size
+            /// </summary>
+            NativeVector(int size) {
+                if (size < 0)
+                    throw gcnew ArgumentOutOfRangeException("size");
+                this->size = size;
+                storage = gcnew NativeStorage<T>(size);
+            }
+
+            /// <summary>
+            /// Releases the native memory
+            /// </summary>
+            ~NativeVector() {
+                delete storage;
+            }
+
+            /// <summary>
+            /// Creates a native copy of a managed vector
+            /// </summary>
+            static NativeVector<T>^ FromVector(Vector<T>^ vector) {
+                NativeVector<T>^ result = gcnew NativeVector<T>(vector->Size);
+                vector->CopyTo(result->Pointer);
+                return result;
+            }
+
+            /// <summary>
+            /// Copies the elements into a new managed vector
+            /// </summary>
+            Vector<T>^ ToVector() {
+                Vector<T>^ result = gcnew Vector<T>(size);
+                result->CopyFrom(Pointer);
+                GC::KeepAlive(this);
+                return result;
+            }
+
+            /// <summary>
+            /// Gets the size of the vector
+            /// </summary>
+            property int Size {
+                int get() { return size; }
+            }
+
+            /// <summary>
+            /// Gets the underlying storage
+            /// </summary>
+            property NativeStorage<T>^ Storage {
+                NativeStorage<T>^ get() { return storage; }
+            }
+
+            /// <summary>
+            /// Gets the address of the first element
+            /// </summary>
+            property IntPtr Pointer {
+                IntPtr get() { return storage->Pointer; }
+            }
+
+            /// <summary>
+            /// Gets or sets element at specified index
+            /// </summary>
+            property T default[int] {
+                T get(int index) { return storage[index]; }
+                void set(int index, T value) { storage[index] = value; }
+            }
+
+            /// <summary>
+            /// Copies count elements starting at index into a buffer
+            /// </summary>
+            void CopyTo(int index, array<T>^ destination, int destinationIndex, int count) {
+                storage->CopyTo(index, destination, destinationIndex, count);
+            }
+
+            /// <summary>
+            /// Overwrites count elements starting at index from a buffer
+            /// </summary>
+            void CopyFrom(array<T>^ source, int sourceIndex, int index, int count) {
+                storage->CopyFrom(source, sourceIndex, index, count);
+            }
+        };
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../Native/TileScheduler.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Global opt-in settings for multithreaded matrix operations
+        /// </summary>
+        public ref class Parallelism abstract sealed {
+        private:
+            static bool enabled = false;
+            static int maxDegree = 0;
+            static long long multiplyThreshold = 128LL * 128 * 128;
+            static long long transposeThreshold = 512LL * 512;
+            static long long sparseThreshold = 64LL * 1024;
+
+        public:
+            /// <summary>
+            /// Gets or sets whether operations without an explicit degree of
+            /// parallelism use the shared thread pool
+            /// </summary>
+            static property bool Enabled {
+                bool get() { return enabled; }
+                void set(bool value) { enabled = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the maximum number of threads used when enabled
+            /// (0 means all hardware threads)
+            /// </summary>
+            static property int MaxDegreeOfParallelism {
+                int get() { return maxDegree; }
+                void set(int value) {
+                    if (value < 0)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    maxDegree = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the multiply volume (rows * inner * columns) below
+            /// which products always run on the calling thread
+            /// </summary>
+            static property long long MultiplyThreshold {
+                long long get() { return multiplyThreshold; }
+                void set(long long value) { multiplyThreshold = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the element count below which transposes always
+            /// run on the calling thread
+            /// </summary>
+            static property long long TransposeThreshold {
+                long long get() { return transposeThreshold; }
+                void set(long long value) { transposeThreshold = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the nonzero count below which sparse products
+            /// always run on the calling thread
+            /// </summary>
+            static property long long SparseThreshold {
+                long long get() { return sparseThreshold; }
+                void set(long long value) { sparseThreshold = value; }
+            }
+
+            /// <summary>
+            /// Gets the number of hardware threads available
+            /// </summary>
+            static property int ProcessorCount {
+                int get() { return Native::HardwareConcurrency(); }
+            }
+
+            /// <summary>
+            /// Gets the degree of parallelism implied by the global settings
+            /// (1 when disabled)
+            /// </summary>
+            static property int DefaultDegree {
+                int get() { return enabled ? maxDegree : 1; }
+            }
+        };
+    }
+}
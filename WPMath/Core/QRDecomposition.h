@@ -0,0 +1,184 @@
+#pragma once
+
+#include "../Native/Factorization.h"
+#include "BufferPool.h"
+
+#include <cstring>
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Householder QR factorization with column pivoting (A * P = Q * R).
+        /// Provides a reliable rank and least squares solves from cached factors.
+        /// </summary>
+        public ref class QRDecomposition {
+        private:
+            array<double>^ qr;
+            array<double>^ tau;
+            array<int>^ permutation;
+            int m, n;
+            int rank;
+
+            QRDecomposition(array<double>^ data, int rows, int cols) {
+                qr = data;
+                m = rows;
+                n = cols;
+                tau = gcnew array<double>(System::Math::Min(m, n));
+                permutation = gcnew array<int>(n);
+                rank = FactorInPlace(qr, tau, permutation, m, n);
+            }
+
+            static void CheckResult(int rows, int cols, int expectedRows, int expectedCols) {
+                if (rows != expectedRows || cols != expectedCols)
+                    throw gcnew ArgumentException("Result has the wrong dimensions", "x");
+            }
+
+            /// <summary>
+            /// Solves from a work copy of B (m x nrhs) rented from the pool, so
+            /// x may be b itself
+            /// </summary>
+            void SolveInto(interior_ptr<double> b, interior_ptr<double> x, int nrhs) {
+                int count = m * nrhs;
+                array<double>^ work = BufferPool::Rent<double>(count);
+                try {
+                    pin_ptr<double> pb = b;
+                    pin_ptr<double> pw = &work[0];
+                    memcpy(pw, pb, count * sizeof(double));
+                    pin_ptr<double> pa = &qr[0];
+                    pin_ptr<double> pt = &tau[0];
+                    pin_ptr<int> pp = &permutation[0];
+                    pin_ptr<double> px = x;
+                    Native::QrSolve(pa, m, n, pt, pp, rank, pw, nrhs, px);
+                }
+                finally {
+                    BufferPool::Return(work);
+                }
+            }
+
+        internal:
+            /// <summary>
+            /// Factors the leading m x n row-major block of a in place; tau and
+            /// perm may be longer, as when rented from the BufferPool. The
+            /// 2 * n work buffer comes from the pool. Returns the rank.
+            /// </summary>
+            static int FactorInPlace(array<double>^ a, array<double>^ tau, array<int>^ perm, int m, int n) {
+                if (m == 0 || n == 0)
+                    return 0;
+
+                array<double>^ work = BufferPool::Rent<double>(2 * n);
+                try {
+                    pin_ptr<double> pa = &a[0];
+                    pin_ptr<double> pt = &tau[0];
+                    pin_ptr<int> pp = &perm[0];
+                    pin_ptr<double> pw = &work[0];
+                    Native::QrFactor(pa, m, n, pt, pp, pw);
+                    return Native::QrRank(pa, m, n, Native::RankTolerance(m, n));
+                }
+                finally {
+                    BufferPool::Return(work);
+                }
+            }
+
+        public:
+            /// <summary>
+            /// Factors a matrix of any shape
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static QRDecomposition^ Factor(Matrix<T>^ matrix) {
+                return gcnew QRDecomposition(matrix->ToRowMajorDouble(), matrix->Rows, matrix->Columns);
+            }
+
+            /// <summary>
+            /// Gets the number of rows of the factored matrix
+            /// </summary>
+            property int Rows {
+                int get() { return m; }
+            }
+
+            /// <summary>
+            /// Gets the number of columns of the factored matrix
+            /// </summary>
+            property int Columns {
+                int get() { return n; }
+            }
+
+            /// <summary>
+            /// Gets the numerical rank
+            /// </summary>
+            property int Rank {
+                int get() { return rank; }
+            }
+
+            /// <summary>
+            /// Gets whether the columns are linearly independent
+            /// </summary>
+            property bool IsFullRank {
+                bool get() { return rank == System::Math::Min(m, n); }
+            }
+
+            /// <summary>
+            /// Solves A * x = b in the least squares sense (requires Rows >= Columns).
+            /// Rank-deficient systems return the basic solution.
+            /// </summary>
+            Vector<double>^ Solve(Vector<double>^ b) {
+                if (b->Size != m)
+                    throw gcnew ArgumentException("Vector size does not match the matrix");
+                if (m < n)
+                    throw gcnew InvalidOperationException("Matrix must have at least as many rows as columns");
+
+                Vector<double>^ x = gcnew Vector<double>(n);
+                Solve(b, x);
+                return x;
+            }
+
+            /// <summary>
+            /// Solves A * x = b in the least squares sense into a
+            /// caller-provided vector without allocating
+            /// </summary>
+            void Solve(Vector<double>^ b, Vector<double>^ x) {
+                if (b->Size != m)
+                    throw gcnew ArgumentException("Vector size does not match the matrix");
+                if (m < n)
+                    throw gcnew InvalidOperationException("Matrix must have at least as many rows as columns");
+                CheckResult(x->Size, 1, n, 1);
+                if (n == 0)
+                    return;
+
+                SolveInto(&b->Elements[0], &x->Elements[0], 1);
+            }
+
+            /// <summary>
+            /// Solves A * X = B in the least squares sense for every column of B
+            /// </summary>
+            Matrix<double>^ Solve(Matrix<double>^ b) {
+                if (b->Rows != m)
+                    throw gcnew ArgumentException("Matrix row count does not match the factored matrix");
+                if (m < n)
+                    throw gcnew InvalidOperationException("Matrix must have at least as many rows as columns");
+
+                Matrix<double>^ x = gcnew Matrix<double>(n, b->Columns);
+                Solve(b, x);
+                return x;
+            }
+
+            /// <summary>
+            /// Solves A * X = B in the least squares sense into a
+            /// caller-provided matrix without allocating
+            /// </summary>
+            void Solve(Matrix<double>^ b, Matrix<double>^ x) {
+                if (b->Rows != m)
+                    throw gcnew ArgumentException("Matrix row count does not match the factored matrix");
+                if (m < n)
+                    throw gcnew InvalidOperationException("Matrix must have at least as many rows as columns");
+                CheckResult(x->Rows, x->Columns, n, b->Columns);
+                if (n == 0 || b->Columns == 0)
+                    return;
+
+                SolveInto(&b->Elements[0, 0], &x->Elements[0, 0], b->Columns);
+            }
+        };
+    }
+}
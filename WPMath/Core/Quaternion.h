@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Vector3.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A rotation quaternion x*i + y*j + z*k + w stored inline as four doubles
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Quaternion {
+        private:
+            double x;
+            double y;
+            double z;
+            double w;
+
+        public:
+            /// <summary>
+            /// Creates a new quaternion
+            /// </summary>
+            Quaternion(double x, double y, double z, double w) {
+                this->x = x;
+                this->y = y;
+                this->z = z;
+                this->w = w;
+            }
+
+            /// <summary>
+            /// Gets the identity rotation
+            /// </summary>
+            static property Quaternion Identity {
+                Quaternion get() { return Quaternion(0, 0, 0, 1); }
+            }
+
+            /// <summary>
+            /// Gets the X component of the vector part
+            /// </summary>
+            property double X {
+                double get() { return x; }
+            }
+
+            /// <summary>
+            /// Gets the Y component of the vector part
+            /// </summary>
+            property double Y {
+                double get() { return y; }
+            }
+
+            /// <summary>
+            /// Gets the Z component of the vector part
+            /// </summary>
+            property double Z {
+                double get() { return z; }
+            }
+
+            /// <summary>
+            /// Gets the scalar part
+            /// </summary>
+            property double W {
+                double get() { return w; }
+            }
+
+            /// <summary>
+            /// Gets the length of the quaternion
+            /// </summary>
+            property double Length {
+                double get() { return System::Math::Sqrt(x * x + y * y + z * z + w * w); }
+            }
+
+            /// <summary>
+            /// Creates a rotation of angle radians about an axis
+            /// </summary>
+            static Quaternion CreateFromAxisAngle(Vector3 axis, double angle) {
+                Vector3 n = axis.Normalize();
+                double s = System::Math::Sin(angle * 0.5);
+                return Quaternion(n.X * s, n.Y * s, n.Z * s, System::Math::Cos(angle * 0.5));
+            }
+
+            /// <summary>
+            /// Returns the quaternion scaled to unit length
+            /// </summary>
+            Quaternion Normalize() {
+                double length = Length;
+                return length > 0 ? Quaternion(x / length, y / length, z / length, w / length) : Identity;
+            }
+
+            /// <summary>
+            /// Gets the conjugate, which is the inverse rotation of a unit quaternion
+            /// </summary>
+            Quaternion Conjugate() {
+                return Quaternion(-x, -y, -z, w);
+            }
+
+            /// <summary>
+            /// Gets the multiplicative inverse
+            /// </summary>
+            Quaternion Inverse() {
+                double n = x * x + y * y + z * z + w * w;
+                return Quaternion(-x / n, -y / n, -z / n, w / n);
+            }
+
+            /// <summary>
+            /// Rotates a vector by this (unit) quaternion without building a matrix
+            /// </summary>
+            Vector3 Rotate(Vector3 v) {
+                // v' = v + 2w(q x v) + 2 q x (q x v)
+                double tx = 2 * (y * v.Z - z * v.Y);
+                double ty = 2 * (z * v.X - x * v.Z);
+                double tz = 2 * (x * v.Y - y * v.X);
+                return Vector3(v.X + w * tx + (y * tz - z * ty),
+                               v.Y + w * ty + (z * tx - x * tz),
+                               v.Z + w * tz + (x * ty - y * tx));
+            }
+
+            /// <summary>
+            /// Calculates the dot product of two quaternions
+            /// </summary>
+            static double Dot(Quaternion a, Quaternion b) {
+                return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+            }
+
+            /// <summary>
+            /// Interpolates along the shortest arc between two unit quaternions
+            /// </summary>
+            static Quaternion Slerp(Quaternion a, Quaternion b, double t) {
+                double cosTheta = Dot(a, b);
+                double sign = 1;
+                if (cosTheta < 0) {
+                    cosTheta = -cosTheta;
+                    sign = -1;
+                }
+
+                double wa, wb;
+                if (cosTheta > 0.9995) {
+                    // Nearly parallel: linear interpolation avoids dividing by sin(0)
+                    wa = 1 - t;
+                    wb = t * sign;
+                }
+                else {
+                    double theta = System::Math::Acos(cosTheta);
+                    double invSin = 1 / System::Math::Sin(theta);
+                    wa = System::Math::Sin((1 - t) * theta) * invSin;
+                    wb = System::Math::Sin(t * theta) * invSin * sign;
+                }
+
+                Quaternion q(wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z, wa * a.w + wb * b.w);
+                return q.Normalize();
+            }
+
+            /// <summary>
+            /// Composes two rotations: the result applies b first, then a
+            /// </summary>
+            static Quaternion operator*(Quaternion a, Quaternion b) {
+                return Quaternion(
+                    a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                    a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                    a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                    a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+                );
+            }
+
+            /// <summary>
+            /// Converts the quaternion to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("({0}, {1}, {2}, {3})", x, y, z, w);
+            }
+        };
+    }
+}
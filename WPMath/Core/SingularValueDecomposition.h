@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../Native/Spectral.h"
+#include "BufferPool.h"
+#include "Parallelism.h"
+
+#include <cstring>
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Thin singular value decomposition (A = U * S * V^T) of a matrix of
+        /// any shape by Golub-Kahan bidiagonalization and implicit shifted QR.
+        /// Gives the most reliable rank, the condition number and the
+        /// pseudo-inverse.
+        /// </summary>
+        public ref class SingularValueDecomposition {
+        private:
+            array<double>^ s;
+            array<double>^ u;
+            array<double>^ v;
+            int m, n, p;
+            int rank;
+            int degree;
+
+            SingularValueDecomposition(array<double>^ a, int rows, int cols, int degreeOfParallelism) {
+                m = rows;
+                n = cols;
+                p = System::Math::Min(m, n);
+                degree = degreeOfParallelism;
+                s = gcnew array<double>(p);
+                u = gcnew array<double>(m * p);
+                v = gcnew array<double>(n * p);
+                if (p > 0) {
+                    pin_ptr<double> pa = &a[0];
+                    pin_ptr<double> ps = &s[0];
+                    pin_ptr<double> pu = &u[0];
+                    pin_ptr<double> pv = &v[0];
+                    if (!Native::Svd(pa, m, n, ps, pu, pv, degree))
+                        throw gcnew ArithmeticException("Singular value iteration did not converge");
+                    rank = Native::SvdRank(ps, p, Native::RankTolerance(m, n));
+                }
+            }
+
+            static Matrix<double>^ ToMatrix(array<double>^ data, int rows, int cols) {
+                Matrix<double>^ result = gcnew Matrix<double>(rows, cols);
+                if (rows > 0 && cols > 0) {
+                    pin_ptr<double> src = &data[0];
+                    pin_ptr<double> dst = &result->Elements[0, 0];
+                    memcpy(dst, src, (size_t)rows * cols * sizeof(double));
+                }
+                return result;
+            }
+
+        internal:
+            /// <summary>
+            /// Singular values only, descending, of the leading m x n
+            /// row-major block of a into s; both may be longer, as when rented
+            /// from the BufferPool
+            /// </summary>
+            static void ComputeValues(array<double>^ a, int m, int n, array<double>^ s) {
+                if (m == 0 || n == 0)
+                    return;
+
+                pin_ptr<double> pa = &a[0];
+                pin_ptr<double> ps = &s[0];
+                if (!Native::Svd(pa, m, n, ps, 0, 0, 1))
+                    throw gcnew ArithmeticException("Singular value iteration did not converge");
+            }
+
+        public:
+            /// <summary>
+            /// Factors a matrix of any shape
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static SingularValueDecomposition^ Factor(Matrix<T>^ matrix) {
+                return Factor(matrix, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Factors a matrix with the given degree of parallelism for the
+            /// blocked updates (0 means all hardware threads)
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static SingularValueDecomposition^ Factor(Matrix<T>^ matrix, int degreeOfParallelism) {
+                return gcnew SingularValueDecomposition(matrix->ToRowMajorDouble(), matrix->Rows, matrix->Columns,
+                                                        degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Gets the number of rows of the factored matrix
+            /// </summary>
+            property int Rows {
+                int get() { return m; }
+            }
+
+            /// <summary>
+            /// Gets the number of columns of the factored matrix
+            /// </summary>
+            property int Columns {
+                int get() { return n; }
+            }
+
+            /// <summary>
+            /// Gets the min(Rows, Columns) singular values in descending order
+            /// </summary>
+            property Vector<double>^ Values {
+                Vector<double>^ get() { return gcnew Vector<double>(s); }
+            }
+
+            /// <summary>
+            /// Gets the left singular vectors as the columns of a Rows x
+            /// min(Rows, Columns) matrix
+            /// </summary>
+            property Matrix<double>^ U {
+                Matrix<double>^ get() { return ToMatrix(u, m, p); }
+            }
+
+            /// <summary>
+            /// Gets the right singular vectors as the columns of a Columns x
+            /// min(Rows, Columns) matrix
+            /// </summary>
+            property Matrix<double>^ V {
+                Matrix<double>^ get() { return ToMatrix(v, n, p); }
+            }
+
+            /// <summary>
+            /// Gets the number of singular values above the relative rank
+            /// tolerance
+            /// </summary>
+            property int Rank {
+                int get() { return rank; }
+            }
+
+            /// <summary>
+            /// Gets the 2-norm, the largest singular value
+            /// </summary>
+            property double Norm2 {
+                double get() { return p > 0 ? s[0] : 0; }
+            }
+
+            /// <summary>
+            /// Gets the 2-norm condition number, the ratio of the largest to
+            /// the smallest singular value
+            /// </summary>
+            property double ConditionNumber {
+                double get() {
+                    if (p == 0)
+                        return 0;
+                    return s[p - 1] == 0 ? Double::PositiveInfinity : s[0] / s[p - 1];
+                }
+            }
+
+            /// <summary>
+            /// Calculates the Moore-Penrose pseudo-inverse (Columns x Rows),
+            /// dropping singular values below the rank tolerance
+            /// </summary>
+            Matrix<double>^ PseudoInverse() {
+                Matrix<double>^ result = gcnew Matrix<double>(n, m);
+                if (p == 0)
+                    return result;
+
+                array<double>^ scaled = BufferPool::Rent<double>(n * p);
+                try {
+                    Array::Copy(v, scaled, n * p);
+                    pin_ptr<double> pu = &u[0];
+                    pin_ptr<double> ps = &s[0];
+                    pin_ptr<double> pv = &scaled[0];
+                    pin_ptr<double> px = &result->Elements[0, 0];
+                    Native::SvdPseudoInverse(pu, ps, pv, m, n, rank, px, degree);
+                }
+                finally {
+                    BufferPool::Return(scaled);
+                }
+                return result;
+            }
+
+            /// <summary>
+            /// Solves A * x = b for the minimum-norm least squares solution,
+            /// which exists for any shape and rank
+            /// </summary>
+            Vector<double>^ Solve(Vector<double>^ b) {
+                if (b->Size != m)
+                    throw gcnew ArgumentException("Vector size does not match the matrix");
+
+                // x = V * diag(1 / s) * U^T * b over the leading rank triplets
+                array<double>^ c = gcnew array<double>(rank);
+                for (int i = 0; i < m; i++) {
+                    double bi = b->Elements[i];
+                    for (int k = 0; k < rank; k++)
+                        c[k] += u[i * p + k] * bi;
+                }
+                for (int k = 0; k < rank; k++)
+                    c[k] /= s[k];
+
+                Vector<double>^ x = gcnew Vector<double>(n);
+                for (int j = 0; j < n; j++) {
+                    double sum = 0;
+                    for (int k = 0; k < rank; k++)
+                        sum += v[j * p + k] * c[k];
+                    x->Elements[j] = sum;
+                }
+                return x;
+            }
+        };
+    }
+}
@@ -0,0 +1,778 @@
+#pragma once
+
+#include "../Native/Sparse.h"
+#include "Matrix.h"
+#include "Parallelism.h"
+#include "Vector.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Math {
+        generic<typename T> where T : value class ref class CsrMatrix;
+        generic<typename T> where T : value class ref class CscMatrix;
+
+        /// <summary>
+        /// Compressed storage shared by the CSR and CSC types. Line i of the
+        /// major dimension (a row for CSR, a column for CSC) owns entries
+        /// pointers[i]..pointers[i+1]-1 of indices and values; indices are
+        /// sorted and unique within a line.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        private ref class SparseStorage {
+        private:
+            array<int>^ pointers;
+            array<int>^ indices;
+            array<T>^ values;
+            int majorCount, minorCount;
+
+            static void GatherNative(SparseStorage<T>^ s, array<double>^ x, array<double>^ y, int degreeOfParallelism) {
+                pin_ptr<int> pp = &s->pointers[0];
+                pin_ptr<int> pi = &s->indices[0];
+                pin_ptr<double> pv = &safe_cast<array<double>^>((Object^)s->values)[0];
+                pin_ptr<double> px = &x[0];
+                pin_ptr<double> py = &y[0];
+                if (degreeOfParallelism == 1 || s->NonZeroCount < Parallelism::SparseThreshold)
+                    Native::SparseGather<double>(pp, pi, pv, s->majorCount, px, py);
+                else
+                    Native::SparseGatherParallel<double>(pp, pi, pv, s->majorCount, px, py, degreeOfParallelism);
+            }
+
+            static void GatherNative(SparseStorage<T>^ s, array<float>^ x, array<float>^ y, int degreeOfParallelism) {
+                pin_ptr<int> pp = &s->pointers[0];
+                pin_ptr<int> pi = &s->indices[0];
+                pin_ptr<float> pv = &safe_cast<array<float>^>((Object^)s->values)[0];
+                pin_ptr<float> px = &x[0];
+                pin_ptr<float> py = &y[0];
+                if (degreeOfParallelism == 1 || s->NonZeroCount < Parallelism::SparseThreshold)
+                    Native::SparseGather<float>(pp, pi, pv, s->majorCount, px, py);
+                else
+                    Native::SparseGatherParallel<float>(pp, pi, pv, s->majorCount, px, py, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Scatter only pays off in parallel when the private output
+            /// copies are small next to the work
+            /// </summary>
+            bool ScatterInParallel(int degreeOfParallelism) {
+                return degreeOfParallelism != 1 && NonZeroCount >= Parallelism::SparseThreshold &&
+                       NonZeroCount >= 16LL * minorCount;
+            }
+
+            static void ScatterNative(SparseStorage<T>^ s, array<double>^ x, array<double>^ y, int degreeOfParallelism) {
+                pin_ptr<int> pp = &s->pointers[0];
+                pin_ptr<int> pi = &s->indices[0];
+                pin_ptr<double> pv = &safe_cast<array<double>^>((Object^)s->values)[0];
+                pin_ptr<double> px = &x[0];
+                pin_ptr<double> py = &y[0];
+                if (!s->ScatterInParallel(degreeOfParallelism))
+                    Native::SparseScatter<double>(pp, pi, pv, s->majorCount, s->minorCount, px, py);
+                else
+                    Native::SparseScatterParallel<double>(pp, pi, pv, s->majorCount, s->minorCount, px, py,
+                                                          degreeOfParallelism);
+            }
+
+            static void ScatterNative(SparseStorage<T>^ s, array<float>^ x, array<float>^ y, int degreeOfParallelism) {
+                pin_ptr<int> pp = &s->pointers[0];
+                pin_ptr<int> pi = &s->indices[0];
+                pin_ptr<float> pv = &safe_cast<array<float>^>((Object^)s->values)[0];
+                pin_ptr<float> px = &x[0];
+                pin_ptr<float> py = &y[0];
+                if (!s->ScatterInParallel(degreeOfParallelism))
+                    Native::SparseScatter<float>(pp, pi, pv, s->majorCount, s->minorCount, px, py);
+                else
+                    Native::SparseScatterParallel<float>(pp, pi, pv, s->majorCount, s->minorCount, px, py,
+                                                         degreeOfParallelism);
+            }
+
+        internal:
+            SparseStorage(int majorCount, int minorCount, array<int>^ pointers, array<int>^ indices, array<T>^ values) {
+                this->majorCount = majorCount;
+                this->minorCount = minorCount;
+                this->pointers = pointers;
+                this->indices = indices;
+                this->values = values;
+            }
+
+            property array<int>^ Pointers {
+                array<int>^ get() { return pointers; }
+            }
+
+            property array<int>^ Indices {
+                array<int>^ get() { return indices; }
+            }
+
+            property array<T>^ Values {
+                array<T>^ get() { return values; }
+            }
+
+            property int MajorCount {
+                int get() { return majorCount; }
+            }
+
+            property int MinorCount {
+                int get() { return minorCount; }
+            }
+
+            property int NonZeroCount {
+                int get() { return pointers[majorCount]; }
+            }
+
+            /// <summary>
+            /// Gets the bytes held by the three arrays
+            /// </summary>
+            property long long MemorySize {
+                long long get() {
+                    return 4LL * (pointers->Length + indices->Length) +
+                           (long long)values->Length * ElementInfo<T>::Size;
+                }
+            }
+
+            /// <summary>
+            /// Compresses count (major, minor, value) triplets. Two stable
+            /// counting sorts, first by minor then by major, leave every line
+            /// sorted without a comparison sort; duplicate positions are summed.
+            /// </summary>
+            static SparseStorage<T>^ FromTriplets(int majorCount, int minorCount, array<int>^ major, array<int>^ minor,
+                                                  array<T>^ tripletValues, int count) {
+                if (majorCount < 0 || minorCount < 0)
+                    throw gcnew ArgumentOutOfRangeException(majorCount < 0 ? "rows" : "columns");
+                if (major == nullptr || minor == nullptr || tripletValues == nullptr)
+                    throw gcnew ArgumentNullException(tripletValues == nullptr ? "values" : "indices");
+                if (count < 0 || count > major->Length || count > minor->Length || count > tripletValues->Length)
+                    throw gcnew ArgumentException("Triplet arrays are shorter than the triplet count");
+
+                array<int>^ minorStart = gcnew array<int>(minorCount + 1);
+                array<int>^ pointers = gcnew array<int>(majorCount + 1);
+                for (int k = 0; k < count; k++) {
+                    if ((unsigned)major[k] >= (unsigned)majorCount || (unsigned)minor[k] >= (unsigned)minorCount)
+                        throw gcnew ArgumentOutOfRangeException("indices", "Triplet " + k + " lies outside the matrix");
+                    minorStart[minor[k] + 1]++;
+                    pointers[major[k] + 1]++;
+                }
+                for (int j = 0; j < minorCount; j++)
+                    minorStart[j + 1] += minorStart[j];
+                for (int i = 0; i < majorCount; i++)
+                    pointers[i + 1] += pointers[i];
+
+                array<int>^ byMinor = gcnew array<int>(count);
+                for (int k = 0; k < count; k++)
+                    byMinor[minorStart[minor[k]]++] = k;
+
+                array<int>^ cursor = gcnew array<int>(majorCount);
+                Array::Copy(pointers, cursor, majorCount);
+                array<int>^ indices = gcnew array<int>(count);
+                array<T>^ values = gcnew array<T>(count);
+                for (int s = 0; s < count; s++) {
+                    int k = byMinor[s];
+                    int slot = cursor[major[k]]++;
+                    indices[slot] = minor[k];
+                    values[slot] = tripletValues[k];
+                }
+
+                // Merge duplicates, compacting in place
+                int write = 0;
+                for (int i = 0; i < majorCount; i++) {
+                    int begin = pointers[i], end = pointers[i + 1];
+                    pointers[i] = write;
+                    for (int k = begin; k < end; k++) {
+                        if (write > pointers[i] && indices[write - 1] == indices[k]) {
+                            values[write - 1] += values[k];
+                        }
+                        else {
+                            indices[write] = indices[k];
+                            values[write] = values[k];
+                            write++;
+                        }
+                    }
+                }
+                pointers[majorCount] = write;
+                if (write != count) {
+                    Array::Resize(indices, write);
+                    Array::Resize(values, write);
+                }
+                return gcnew SparseStorage<T>(majorCount, minorCount, pointers, indices, values);
+            }
+
+            /// <summary>
+            /// Compresses the nonzero elements of a dense array, along rows
+            /// when rowMajor is set and along columns otherwise
+            /// </summary>
+            static SparseStorage<T>^ FromDense(array<T, 2>^ elements, bool rowMajor) {
+                int rows = elements->GetLength(0), cols = elements->GetLength(1);
+                int majorCount = rowMajor ? rows : cols, minorCount = rowMajor ? cols : rows;
+                EqualityComparer<T>^ comparer = EqualityComparer<T>::Default;
+                T zero = T();
+
+                array<int>^ pointers = gcnew array<int>(majorCount + 1);
+                for (int i = 0; i < majorCount; i++) {
+                    int n = 0;
+                    for (int j = 0; j < minorCount; j++)
+                        if (!comparer->Equals(rowMajor ? elements[i, j] : elements[j, i], zero))
+                            n++;
+                    pointers[i + 1] = pointers[i] + n;
+                }
+
+                array<int>^ indices = gcnew array<int>(pointers[majorCount]);
+                array<T>^ values = gcnew array<T>(pointers[majorCount]);
+                int k = 0;
+                for (int i = 0; i < majorCount; i++) {
+                    for (int j = 0; j < minorCount; j++) {
+                        T v = rowMajor ? elements[i, j] : elements[j, i];
+                        if (!comparer->Equals(v, zero)) {
+                            indices[k] = j;
+                            values[k] = v;
+                            k++;
+                        }
+                    }
+                }
+                return gcnew SparseStorage<T>(majorCount, minorCount, pointers, indices, values);
+            }
+
+            /// <summary>
+            /// Expands into a dense array, along rows when rowMajor is set
+            /// </summary>
+            array<T, 2>^ ToDense(bool rowMajor) {
+                array<T, 2>^ result = rowMajor ? gcnew array<T, 2>(majorCount, minorCount)
+                                               : gcnew array<T, 2>(minorCount, majorCount);
+                for (int i = 0; i < majorCount; i++) {
+                    for (int k = pointers[i]; k < pointers[i + 1]; k++) {
+                        if (rowMajor)
+                            result[i, indices[k]] = values[k];
+                        else
+                            result[indices[k], i] = values[k];
+                    }
+                }
+                return result;
+            }
+
+            /// <summary>
+            /// Re-compresses along the other dimension in O(nnz)
+            /// </summary>
+            SparseStorage<T>^ Recompress() {
+                int nnz = NonZeroCount;
+                array<int>^ outPointers = gcnew array<int>(minorCount + 1);
+                array<int>^ outIndices = gcnew array<int>(nnz);
+                array<T>^ outValues = gcnew array<T>(nnz);
+
+                if (T::typeid == Double::typeid && nnz > 0) {
+                    pin_ptr<int> pp = &pointers[0], pi = &indices[0];
+                    pin_ptr<double> pv = &safe_cast<array<double>^>((Object^)values)[0];
+                    pin_ptr<int> op = &outPointers[0], oi = &outIndices[0];
+                    pin_ptr<double> ov = &safe_cast<array<double>^>((Object^)outValues)[0];
+                    Native::SparseTranspose<double>(pp, pi, pv, majorCount, minorCount, op, oi, ov);
+                }
+                else {
+                    for (int k = 0; k < nnz; k++)
+                        outPointers[indices[k] + 1]++;
+                    for (int j = 0; j < minorCount; j++)
+                        outPointers[j + 1] += outPointers[j];
+
+                    array<int>^ cursor = gcnew array<int>(minorCount);
+                    Array::Copy(outPointers, cursor, minorCount);
+                    for (int i = 0; i < majorCount; i++) {
+                        for (int k = pointers[i]; k < pointers[i + 1]; k++) {
+                            int slot = cursor[indices[k]]++;
+                            outIndices[slot] = i;
+                            outValues[slot] = values[k];
+                        }
+                    }
+                }
+                return gcnew SparseStorage<T>(minorCount, majorCount, outPointers, outIndices, outValues);
+            }
+
+            /// <summary>
+            /// Gets the element at (major, minor) by binary search of the line
+            /// </summary>
+            T Get(int major, int minor) {
+                int k = Array::BinarySearch<int>(indices, pointers[major], pointers[major + 1] - pointers[major], minor);
+                return k >= 0 ? values[k] : T();
+            }
+
+            /// <summary>
+            /// y[i] = dot(line i, x) for every major line
+            /// </summary>
+            void Gather(array<T>^ x, array<T>^ y, int degreeOfParallelism) {
+                if (majorCount == 0)
+                    return;
+                if (NonZeroCount == 0) {
+                    Array::Clear(y, 0, majorCount);
+                    return;
+                }
+                if (T::typeid == Double::typeid) {
+                    GatherNative(this, safe_cast<array<double>^>((Object^)x), safe_cast<array<double>^>((Object^)y),
+                                 degreeOfParallelism);
+                    return;
+                }
+                if (T::typeid == Single::typeid) {
+                    GatherNative(this, safe_cast<array<float>^>((Object^)x), safe_cast<array<float>^>((Object^)y),
+                                 degreeOfParallelism);
+                    return;
+                }
+
+                for (int i = 0; i < majorCount; i++) {
+                    T sum = T();
+                    for (int k = pointers[i]; k < pointers[i + 1]; k++)
+                        sum += values[k] * x[indices[k]];
+                    y[i] = sum;
+                }
+            }
+
+            /// <summary>
+            /// y = sum over major lines j of x[j] * line j
+            /// </summary>
+            void Scatter(array<T>^ x, array<T>^ y, int degreeOfParallelism) {
+                if (minorCount == 0)
+                    return;
+                if (NonZeroCount == 0) {
+                    Array::Clear(y, 0, minorCount);
+                    return;
+                }
+                if (T::typeid == Double::typeid) {
+                    ScatterNative(this, safe_cast<array<double>^>((Object^)x), safe_cast<array<double>^>((Object^)y),
+                                  degreeOfParallelism);
+                    return;
+                }
+                if (T::typeid == Single::typeid) {
+                    ScatterNative(this, safe_cast<array<float>^>((Object^)x), safe_cast<array<float>^>((Object^)y),
+                                  degreeOfParallelism);
+                    return;
+                }
+
+                Array::Clear(y, 0, minorCount);
+                for (int j = 0; j < majorCount; j++) {
+                    T xj = x[j];
+                    for (int k = pointers[j]; k < pointers[j + 1]; k++)
+                        y[indices[k]] += values[k] * xj;
+                }
+            }
+        };
+
+        /// <summary>
+        /// A sparse matrix in compressed sparse row (CSR) form. Rows are
+        /// stored back to back, so matrix-vector products stream the storage
+        /// once and split across threads by row without any reduction. The
+        /// structure is immutable; assemble it with SparseBuilder or
+        /// FromTriplets.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class CsrMatrix {
+        private:
+            SparseStorage<T>^ storage;
+
+        internal:
+            CsrMatrix(SparseStorage<T>^ storage) {
+                this->storage = storage;
+            }
+
+            /// <summary>
+            /// Gets the compressed storage; Pointers index rows and Indices
+            /// hold column numbers
+            /// </summary>
+            property SparseStorage<T>^ Storage {
+                SparseStorage<T>^ get() { return storage; }
+            }
+
+        public:
+            /// <summary>
+            /// Builds a rows x columns matrix from (row, column, value)
+            /// triplets in any order. Repeated positions are summed, which is
+            /// what finite-element style assembly expects.
+            /// </summary>
+            static CsrMatrix<T>^ FromTriplets(int rows, int columns, array<int>^ rowIndices, array<int>^ columnIndices,
+                                              array<T>^ values) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                return FromTriplets(rows, columns, rowIndices, columnIndices, values, values->Length);
+            }
+
+            /// <summary>
+            /// Builds a matrix from the first count triplets of the arrays
+            /// </summary>
+            static CsrMatrix<T>^ FromTriplets(int rows, int columns, array<int>^ rowIndices, array<int>^ columnIndices,
+                                              array<T>^ values, int count) {
+                return gcnew CsrMatrix<T>(SparseStorage<T>::FromTriplets(rows, columns, rowIndices, columnIndices,
+                                                                         values, count));
+            }
+
+            /// <summary>
+            /// Compresses the nonzero elements of a dense matrix
+            /// </summary>
+            static CsrMatrix<T>^ FromMatrix(Matrix<T>^ matrix) {
+                return gcnew CsrMatrix<T>(SparseStorage<T>::FromDense(matrix->Elements, true));
+            }
+
+            /// <summary>
+            /// Gets number of rows
+            /// </summary>
+            property int Rows {
+                int get() { return storage->MajorCount; }
+            }
+
+            /// <summary>
+            /// Gets number of columns
+            /// </summary>
+            property int Columns {
+                int get() { return storage->MinorCount; }
+            }
+
+            /// <summary>
+            /// Gets the number of stored elements
+            /// </summary>
+            property int NonZeroCount {
+                int get() { return storage->NonZeroCount; }
+            }
+
+            /// <summary>
+            /// Gets the bytes used by the compressed arrays
+            /// </summary>
+            property long long MemorySize {
+                long long get() { return storage->MemorySize; }
+            }
+
+            /// <summary>
+            /// Gets element at specified position; positions that are not
+            /// stored read as zero
+            /// </summary>
+            property T default[int, int] {
+                T get(int row, int col) {
+                    if (row < 0 || row >= Rows || col < 0 || col >= Columns)
+                        throw gcnew ArgumentOutOfRangeException();
+                    return storage->Get(row, col);
+                }
+            }
+
+            /// <summary>
+            /// Computes this * x, using the global Parallelism settings
+            /// </summary>
+            Vector<T>^ Multiply(Vector<T>^ x) {
+                Vector<T>^ result = gcnew Vector<T>(Rows);
+                Multiply(x, result, Parallelism::DefaultDegree);
+                return result;
+            }
+
+            /// <summary>
+            /// Overwrites result with this * x, using the global Parallelism settings
+            /// </summary>
+            void Multiply(Vector<T>^ x, Vector<T>^ result) {
+                Multiply(x, result, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Overwrites result with this * x using at most the given number of
+            /// threads (0 means all hardware threads). Rows are split into bands
+            /// of equal nonzero count. result must not be x.
+            /// </summary>
+            void Multiply(Vector<T>^ x, Vector<T>^ result, int degreeOfParallelism) {
+                if (x->Size != Columns || result->Size != Rows)
+                    throw gcnew ArgumentException("Vector sizes do not match the matrix");
+                if (x == result)
+                    throw gcnew ArgumentException("Result must not be the input vector", "result");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                storage->Gather(x->Elements, result->Elements, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Computes transpose(this) * x without forming the transpose
+            /// </summary>
+            Vector<T>^ TransposeMultiply(Vector<T>^ x) {
+                Vector<T>^ result = gcnew Vector<T>(Columns);
+                TransposeMultiply(x, result, Parallelism::DefaultDegree);
+                return result;
+            }
+
+            /// <summary>
+            /// Overwrites result with transpose(this) * x. Threads accumulate
+            /// into private copies of the result, so this only goes parallel when
+            /// there are many nonzeros per column.
+            /// </summary>
+            void TransposeMultiply(Vector<T>^ x, Vector<T>^ result, int degreeOfParallelism) {
+                if (x->Size != Rows || result->Size != Columns)
+                    throw gcnew ArgumentException("Vector sizes do not match the matrix");
+                if (x == result)
+                    throw gcnew ArgumentException("Result must not be the input vector", "result");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                storage->Scatter(x->Elements, result->Elements, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Creates the transpose in O(nonzeros + rows + columns)
+            /// </summary>
+            CsrMatrix<T>^ Transpose() {
+                return gcnew CsrMatrix<T>(storage->Recompress());
+            }
+
+            /// <summary>
+            /// Converts to compressed sparse column form
+            /// </summary>
+            CscMatrix<T>^ ToCsc();
+
+            /// <summary>
+            /// Expands into a dense matrix
+            /// </summary>
+            Matrix<T>^ ToMatrix() {
+                return gcnew Matrix<T>(storage->ToDense(true));
+            }
+        };
+
+        /// <summary>
+        /// A sparse matrix in compressed sparse column (CSC) form. Column
+        /// access and transpose(A) * x are the cheap directions; convert to
+        /// CsrMatrix for repeated A * x.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class CscMatrix {
+        private:
+            SparseStorage<T>^ storage;
+
+        internal:
+            CscMatrix(SparseStorage<T>^ storage) {
+                this->storage = storage;
+            }
+
+            /// <summary>
+            /// Gets the compressed storage; Pointers index columns and Indices
+            /// hold row numbers
+            /// </summary>
+            property SparseStorage<T>^ Storage {
+                SparseStorage<T>^ get() { return storage; }
+            }
+
+        public:
+            /// <summary>
+            /// Builds a rows x columns matrix from (row, column, value)
+            /// triplets in any order. Repeated positions are summed.
+            /// </summary>
+            static CscMatrix<T>^ FromTriplets(int rows, int columns, array<int>^ rowIndices, array<int>^ columnIndices,
+                                              array<T>^ values) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                return FromTriplets(rows, columns, rowIndices, columnIndices, values, values->Length);
+            }
+
+            /// <summary>
+            /// Builds a matrix from the first count triplets of the arrays
+            /// </summary>
+            static CscMatrix<T>^ FromTriplets(int rows, int columns, array<int>^ rowIndices, array<int>^ columnIndices,
+                                              array<T>^ values, int count) {
+                return gcnew CscMatrix<T>(SparseStorage<T>::FromTriplets(columns, rows, columnIndices, rowIndices,
+                                                                         values, count));
+            }
+
+            /// <summary>
+            /// Compresses the nonzero elements of a dense matrix
+            /// </summary>
+            static CscMatrix<T>^ FromMatrix(Matrix<T>^ matrix) {
+                return gcnew CscMatrix<T>(SparseStorage<T>::FromDense(matrix->Elements, false));
+            }
+
+            /// <summary>
+            /// Gets number of rows
+            /// </summary>
+            property int Rows {
+                int get() { return storage->MinorCount; }
+            }
+
+            /// <summary>
+            /// Gets number of columns
+            /// </summary>
+            property int Columns {
+                int get() { return storage->MajorCount; }
+            }
+
+            /// <summary>
+            /// Gets the number of stored elements
+            /// </summary>
+            property int NonZeroCount {
+                int get() { return storage->NonZeroCount; }
+            }
+
+            /// <summary>
+            /// Gets the bytes used by the compressed arrays
+            /// </summary>
+            property long long MemorySize {
+                long long get() { return storage->MemorySize; }
+            }
+
+            /// <summary>
+            /// Gets element at specified position; positions that are not
+            /// stored read as zero
+            /// </summary>
+            property T default[int, int] {
+                T get(int row, int col) {
+                    if (row < 0 || row >= Rows || col < 0 || col >= Columns)
+                        throw gcnew ArgumentOutOfRangeException();
+                    return storage->Get(col, row);
+                }
+            }
+
+            /// <summary>
+            /// Computes this * x, using the global Parallelism settings
+            /// </summary>
+            Vector<T>^ Multiply(Vector<T>^ x) {
+                Vector<T>^ result = gcnew Vector<T>(Rows);
+                Multiply(x, result, Parallelism::DefaultDegree);
+                return result;
+            }
+
+            /// <summary>
+            /// Overwrites result with this * x using at most the given number of
+            /// threads (0 means all hardware threads). result must not be x.
+            /// </summary>
+            void Multiply(Vector<T>^ x, Vector<T>^ result, int degreeOfParallelism) {
+                if (x->Size != Columns || result->Size != Rows)
+                    throw gcnew ArgumentException("Vector sizes do not match the matrix");
+                if (x == result)
+                    throw gcnew ArgumentException("Result must not be the input vector", "result");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                storage->Scatter(x->Elements, result->Elements, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Computes transpose(this) * x without forming the transpose
+            /// </summary>
+            Vector<T>^ TransposeMultiply(Vector<T>^ x) {
+                Vector<T>^ result = gcnew Vector<T>(Columns);
+                TransposeMultiply(x, result, Parallelism::DefaultDegree);
+                return result;
+            }
+
+            /// <summary>
+            /// Overwrites result with transpose(this) * x; columns are split
+            /// across threads without any reduction
+            /// </summary>
+            void TransposeMultiply(Vector<T>^ x, Vector<T>^ result, int degreeOfParallelism) {
+                if (x->Size != Rows || result->Size != Columns)
+                    throw gcnew ArgumentException("Vector sizes do not match the matrix");
+                if (x == result)
+                    throw gcnew ArgumentException("Result must not be the input vector", "result");
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                storage->Gather(x->Elements, result->Elements, degreeOfParallelism);
+            }
+
+            /// <summary>
+            /// Creates the transpose in O(nonzeros + rows + columns)
+            /// </summary>
+            CscMatrix<T>^ Transpose() {
+                return gcnew CscMatrix<T>(storage->Recompress());
+            }
+
+            /// <summary>
+            /// Converts to compressed sparse row form
+            /// </summary>
+            CsrMatrix<T>^ ToCsr() {
+                return gcnew CsrMatrix<T>(storage->Recompress());
+            }
+
+            /// <summary>
+            /// Expands into a dense matrix
+            /// </summary>
+            Matrix<T>^ ToMatrix() {
+                return gcnew Matrix<T>(storage->ToDense(false));
+            }
+        };
+
+        generic<typename T>
+        where T : value class
+        CscMatrix<T>^ CsrMatrix<T>::ToCsc() {
+            return gcnew CscMatrix<T>(storage->Recompress());
+        }
+
+        /// <summary>
+        /// Collects (row, column, value) triplets for a sparse matrix whose
+        /// structure is discovered while it is assembled. Storage grows
+        /// geometrically; Clear keeps the capacity so per-frame reassembly
+        /// does not allocate.
+        /// </summary>
+        generic<typename T>
+        where T : value class
+        public ref class SparseBuilder {
+        private:
+            array<int>^ rowIndices;
+            array<int>^ columnIndices;
+            array<T>^ values;
+            int rows, cols, count;
+
+            void Initialize(int rows, int columns, int capacity) {
+                if (rows < 0 || columns < 0)
+                    throw gcnew ArgumentOutOfRangeException(rows < 0 ? "rows" : "columns");
+                if (capacity < 1)
+                    capacity = 1;
+                this->rows = rows;
+                this->cols = columns;
+                rowIndices = gcnew array<int>(capacity);
+                columnIndices = gcnew array<int>(capacity);
+                values = gcnew array<T>(capacity);
+            }
+
+        public:
+            /// <summary>
+            /// Creates a builder for a rows x columns matrix
+            /// </summary>
+            SparseBuilder(int rows, int columns) {
+                Initialize(rows, columns, 16);
+            }
+
+            /// <summary>
+            /// Creates a builder with room for capacity triplets
+            /// </summary>
+            SparseBuilder(int rows, int columns, int capacity) {
+                Initialize(rows, columns, capacity);
+            }
+
+            /// <summary>
+            /// Gets the number of triplets added so far
+            /// </summary>
+            property int Count {
+                int get() { return count; }
+            }
+
+            /// <summary>
+            /// Adds value at (row, col); repeated positions are summed
+            /// </summary>
+            void Add(int row, int col, T value) {
+                if (row < 0 || row >= rows || col < 0 || col >= cols)
+                    throw gcnew ArgumentOutOfRangeException();
+                if (count == values->Length) {
+                    int capacity = 2 * count;
+                    Array::Resize(rowIndices, capacity);
+                    Array::Resize(columnIndices, capacity);
+                    Array::Resize(values, capacity);
+                }
+                rowIndices[count] = row;
+                columnIndices[count] = col;
+                values[count] = value;
+                count++;
+            }
+
+            /// <summary>
+            /// Removes all triplets, keeping the allocated capacity
+            /// </summary>
+            void Clear() {
+                count = 0;
+            }
+
+            /// <summary>
+            /// Compresses the triplets into CSR form
+            /// </summary>
+            CsrMatrix<T>^ ToCsr() {
+                return CsrMatrix<T>::FromTriplets(rows, cols, rowIndices, columnIndices, values, count);
+            }
+
+            /// <summary>
+            /// Compresses the triplets into CSC form
+            /// </summary>
+            CscMatrix<T>^ ToCsc() {
+                return CscMatrix<T>::FromTriplets(rows, cols, rowIndices, columnIndices, values, count);
+            }
+        };
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "../Native/Spectral.h"
+#include "Parallelism.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Eigendecomposition (A = V * D * V^T) of a symmetric matrix by
+        /// Householder tridiagonalization and implicit QL. The eigenvector
+        /// update runs in blocks through the GEMM kernel.
+        /// </summary>
+        public ref class SymmetricEigenDecomposition {
+        private:
+            array<double>^ values;
+            Matrix<double>^ vectors;
+            int n;
+
+            SymmetricEigenDecomposition(array<double>^ eigenvalues, Matrix<double>^ eigenvectors, int size) {
+                values = eigenvalues;
+                vectors = eigenvectors;
+                n = size;
+            }
+
+        public:
+            /// <summary>
+            /// Factors a symmetric matrix. Only the lower triangle is read.
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static SymmetricEigenDecomposition^ Factor(Matrix<T>^ matrix) {
+                return Factor(matrix, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Factors a symmetric matrix with the given degree of parallelism
+            /// for the blocked updates (0 means all hardware threads)
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static SymmetricEigenDecomposition^ Factor(Matrix<T>^ matrix, int degreeOfParallelism) {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                int size = matrix->Rows;
+                array<double>^ work = matrix->ToRowMajorDouble();
+                array<double>^ eigenvalues = gcnew array<double>(size);
+                Matrix<double>^ eigenvectors = gcnew Matrix<double>(size, size);
+                if (size > 0) {
+                    pin_ptr<double> pa = &work[0];
+                    pin_ptr<double> pd = &eigenvalues[0];
+                    pin_ptr<double> pv = &eigenvectors->Elements[0, 0];
+                    if (!Native::SymmetricEigen(pa, size, pd, pv, degreeOfParallelism))
+                        throw gcnew ArithmeticException("Eigenvalue iteration did not converge");
+                }
+                return gcnew SymmetricEigenDecomposition(eigenvalues, eigenvectors, size);
+            }
+
+            /// <summary>
+            /// Calculates only the eigenvalues of a symmetric matrix, in
+            /// ascending order, skipping the eigenvector accumulation
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Vector<double>^ Eigenvalues(Matrix<T>^ matrix) {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                int size = matrix->Rows;
+                array<double>^ work = matrix->ToRowMajorDouble();
+                Vector<double>^ result = gcnew Vector<double>(size);
+                if (size > 0) {
+                    pin_ptr<double> pa = &work[0];
+                    pin_ptr<double> pd = &result->Elements[0];
+                    if (!Native::SymmetricEigen(pa, size, pd, 0, 1))
+                        throw gcnew ArithmeticException("Eigenvalue iteration did not converge");
+                }
+                return result;
+            }
+
+            /// <summary>
+            /// Gets the order of the factored matrix
+            /// </summary>
+            property int Size {
+                int get() { return n; }
+            }
+
+            /// <summary>
+            /// Gets the eigenvalues in ascending order
+            /// </summary>
+            property Vector<double>^ Values {
+                Vector<double>^ get() { return gcnew Vector<double>(values); }
+            }
+
+            /// <summary>
+            /// Gets the orthonormal eigenvectors as columns, in the order of
+            /// Values
+            /// </summary>
+            property Matrix<double>^ Vectors {
+                Matrix<double>^ get() { return gcnew Matrix<double>(vectors->Elements); }
+            }
+
+            /// <summary>
+            /// Gets the 2-norm condition number, the ratio of the largest to
+            /// the smallest eigenvalue magnitude
+            /// </summary>
+            property double ConditionNumber {
+                double get() {
+                    if (n == 0)
+                        return 0;
+                    double largest = 0, smallest = Double::PositiveInfinity;
+                    for (int i = 0; i < n; i++) {
+                        double magnitude = System::Math::Abs(values[i]);
+                        largest = System::Math::Max(largest, magnitude);
+                        smallest = System::Math::Min(smallest, magnitude);
+                    }
+                    return smallest == 0 ? Double::PositiveInfinity : largest / smallest;
+                }
+            }
+
+            /// <summary>
+            /// Gets whether every eigenvalue is positive, i.e. the matrix is
+            /// positive definite
+            /// </summary>
+            property bool IsPositiveDefinite {
+                bool get() { return n > 0 && values[0] > 0; }
+            }
+        };
+    }
+}
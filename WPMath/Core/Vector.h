@@ -1,6 +1,11 @@
 #pragma once
 
+#include "Arithmetic.h"
+#include "BufferPool.h"
+#include "NativeStorage.h"
+
 using namespace System;
+using namespace System::Runtime::InteropServices;
 using namespace System::Collections::Generic;
 
 namespace WindowPlus {
@@ -14,12 +19,55 @@ namespace WindowPlus {
         private:
             array<T>^ elements;
 
+            /// <summary>
+            /// Checks that [index, index + count) lies within buffer; the
+            /// names are the caller's parameters, reported in the exception
+            /// </summary>
+            static void CheckSpan(array<T>^ buffer, String^ bufferName, int index, String^ indexName, int count) {
+                if (buffer == nullptr)
+                    throw gcnew ArgumentNullException(bufferName);
+                if (count < 0)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                if (index < 0 || index > buffer->Length - count)
+                    throw gcnew ArgumentOutOfRangeException(indexName);
+            }
+
+            void CopyNative(IntPtr address, bool toAddress) {
+                int size = ElementInfo<T>::Size;
+                if (size == 0)
+                    throw gcnew NotSupportedException("Native copies require a primitive element type");
+                if (elements->Length == 0)
+                    return;
+
+                GCHandle handle = GCHandle::Alloc(elements, GCHandleType::Pinned);
+                try {
+                    void* storage = handle.AddrOfPinnedObject().ToPointer();
+                    size_t bytes = (size_t)elements->Length * size;
+                    if (toAddress)
+                        memcpy(address.ToPointer(), storage, bytes);
+                    else
+                        memcpy(storage, address.ToPointer(), bytes);
+                }
+                finally {
+                    handle.Free();
+                }
+            }
+
+        internal:
+            /// <summary>
+            /// Gets the backing storage without copying
+            /// </summary>
+            property array<T>^ Elements {
+                array<T>^ get() { return elements; }
+            }
+
         public:
             /// <summary>
             /// Creates a new vector with specified size
             /// </summary>
             Vector(int size) {
                 elements = gcnew array<T>(size);
+                AllocationCounters::Record(size);
             }
 
             /// <summary>
@@ -28,6 +76,7 @@ namespace WindowPlus {
             Vector(array<T>^ data) {
                 elements = gcnew array<T>(data->Length);
                 Array::Copy(data, elements, data->Length);
+                AllocationCounters::Record(data->Length);
             }
 
             /// <summary>
@@ -56,26 +105,33 @@ namespace WindowPlus {
             }
 
             /// <summary>
-            /// Calculates dot product with another vector
+            /// Calculates dot product with another vector, accumulated in
+            /// double and rounded once into T; exact for Int32 and Fixed,
+            /// which throw OverflowException when the result does not fit
             /// </summary>
             T DotProduct(Vector<T>^ other) {
                 if (other->Size != Size)
                     throw gcnew ArgumentException("Vectors must be of same size");
 
-                T sum = T();
-                for (int i = 0; i < Size; i++)
-                    sum += elements[i] * other[i];
-                return sum;
+                return Arithmetic<T>::Dot(elements, other->elements, Size);
+            }
+
+            /// <summary>
+            /// Calculates dot product with another vector in double with the
+            /// given summation
+            /// </summary>
+            double DotProduct(Vector<T>^ other, Summation summation) {
+                if (other->Size != Size)
+                    throw gcnew ArgumentException("Vectors must be of same size");
+
+                return Arithmetic<T>::Dot(elements, other->elements, Size, summation);
             }
 
             /// <summary>
             /// Calculates magnitude (length) of the vector
             /// </summary>
             double Magnitude() {
-                double sum = 0;
-                for (int i = 0; i < Size; i++)
-                    sum += (double)(elements[i] * elements[i]);
-                return System::Math::Sqrt(sum);
+                return System::Math::Sqrt(Arithmetic<T>::Dot(elements, elements, Size, Summation::Naive));
             }
 
             /// <summary>
@@ -85,9 +141,56 @@ namespace WindowPlus {
                 double mag = Magnitude();
                 Vector<double>^ result = gcnew Vector<double>(Size);
                 for (int i = 0; i < Size; i++)
-                    result[i] = (double)elements[i] / mag;
+                    result[i] = Arithmetic<T>::ToDouble(elements[i]) / mag;
                 return result;
             }
+
+            /// <summary>
+            /// Writes the normalized vector into result, which may be this
+            /// vector when T is double, without allocating
+            /// </summary>
+            void Normalize(Vector<double>^ result) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                if (result->Size != Size)
+                    throw gcnew ArgumentException("Vectors must be of same size", "result");
+
+                double mag = Magnitude();
+                for (int i = 0; i < Size; i++)
+                    result[i] = Arithmetic<T>::ToDouble(elements[i]) / mag;
+            }
+
+            /// <summary>
+            /// Copies count elements starting at index into a buffer
+            /// </summary>
+            void CopyTo(int index, array<T>^ destination, int destinationIndex, int count) {
+                CheckSpan(elements, "index", index, "index", count);
+                CheckSpan(destination, "destination", destinationIndex, "destinationIndex", count);
+                Array::Copy(elements, index, destination, destinationIndex, count);
+            }
+
+            /// <summary>
+            /// Overwrites count elements starting at index from a buffer
+            /// </summary>
+            void CopyFrom(array<T>^ source, int sourceIndex, int index, int count) {
+                CheckSpan(source, "source", sourceIndex, "sourceIndex", count);
+                CheckSpan(elements, "index", index, "index", count);
+                Array::Copy(source, sourceIndex, elements, index, count);
+            }
+
+            /// <summary>
+            /// Copies all elements to caller-owned native memory
+            /// </summary>
+            void CopyTo(IntPtr destination) {
+                CopyNative(destination, true);
+            }
+
+            /// <summary>
+            /// Overwrites all elements from caller-owned native memory
+            /// </summary>
+            void CopyFrom(IntPtr source) {
+                CopyNative(source, false);
+            }
         };
     }
 } 
\ No newline at end of file
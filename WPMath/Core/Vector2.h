@@ -0,0 +1,185 @@
+#pragma once
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A 2D vector stored inline as two doubles. Operations never allocate;
+        /// arrays of Vector2 are packed (x, y) pairs that native kernels read
+        /// directly.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Vector2 {
+        private:
+            double x;
+            double y;
+
+        public:
+            /// <summary>
+            /// Creates a new vector
+            /// </summary>
+            Vector2(double x, double y) {
+                this->x = x;
+                this->y = y;
+            }
+
+            /// <summary>
+            /// Gets the zero vector
+            /// </summary>
+            static property Vector2 Zero {
+                Vector2 get() { return Vector2(0, 0); }
+            }
+
+            /// <summary>
+            /// Gets the unit vector along X
+            /// </summary>
+            static property Vector2 UnitX {
+                Vector2 get() { return Vector2(1, 0); }
+            }
+
+            /// <summary>
+            /// Gets the unit vector along Y
+            /// </summary>
+            static property Vector2 UnitY {
+                Vector2 get() { return Vector2(0, 1); }
+            }
+
+            /// <summary>
+            /// Gets the X component
+            /// </summary>
+            property double X {
+                double get() { return x; }
+            }
+
+            /// <summary>
+            /// Gets the Y component
+            /// </summary>
+            property double Y {
+                double get() { return y; }
+            }
+
+            /// <summary>
+            /// Gets the length of the vector
+            /// </summary>
+            property double Length {
+                double get() { return System::Math::Sqrt(x * x + y * y); }
+            }
+
+            /// <summary>
+            /// Gets the squared length, avoiding the square root
+            /// </summary>
+            property double LengthSquared {
+                double get() { return x * x + y * y; }
+            }
+
+            /// <summary>
+            /// Returns the vector scaled to unit length, or zero for a zero vector
+            /// </summary>
+            Vector2 Normalize() {
+                double length = Length;
+                return length > 0 ? Vector2(x / length, y / length) : Vector2(0, 0);
+            }
+
+            /// <summary>
+            /// Calculates the dot product of two vectors
+            /// </summary>
+            static double Dot(Vector2 a, Vector2 b) {
+                return a.x * b.x + a.y * b.y;
+            }
+
+            /// <summary>
+            /// Calculates the z component of the 3D cross product of two vectors
+            /// </summary>
+            static double Cross(Vector2 a, Vector2 b) {
+                return a.x * b.y - a.y * b.x;
+            }
+
+            /// <summary>
+            /// Calculates the distance between two points
+            /// </summary>
+            static double Distance(Vector2 a, Vector2 b) {
+                double dx = a.x - b.x, dy = a.y - b.y;
+                return System::Math::Sqrt(dx * dx + dy * dy);
+            }
+
+            /// <summary>
+            /// Interpolates linearly between two vectors
+            /// </summary>
+            static Vector2 Lerp(Vector2 a, Vector2 b, double t) {
+                return Vector2(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t);
+            }
+
+            /// <summary>
+            /// Adds two vectors
+            /// </summary>
+            static Vector2 operator+(Vector2 a, Vector2 b) {
+                return Vector2(a.x + b.x, a.y + b.y);
+            }
+
+            /// <summary>
+            /// Subtracts two vectors
+            /// </summary>
+            static Vector2 operator-(Vector2 a, Vector2 b) {
+                return Vector2(a.x - b.x, a.y - b.y);
+            }
+
+            /// <summary>
+            /// Negates a vector
+            /// </summary>
+            static Vector2 operator-(Vector2 a) {
+                return Vector2(-a.x, -a.y);
+            }
+
+            /// <summary>
+            /// Scales a vector
+            /// </summary>
+            static Vector2 operator*(Vector2 a, double s) {
+                return Vector2(a.x * s, a.y * s);
+            }
+
+            /// <summary>
+            /// Scales a vector
+            /// </summary>
+            static Vector2 operator*(double s, Vector2 a) {
+                return Vector2(a.x * s, a.y * s);
+            }
+
+            /// <summary>
+            /// Divides a vector by a scalar
+            /// </summary>
+            static Vector2 operator/(Vector2 a, double s) {
+                return Vector2(a.x / s, a.y / s);
+            }
+
+            /// <summary>
+            /// Converts to a general vector of size 2
+            /// </summary>
+            Vector<double>^ ToVector() {
+                Vector<double>^ result = gcnew Vector<double>(2);
+                result[0] = x;
+                result[1] = y;
+                return result;
+            }
+
+            /// <summary>
+            /// Converts a general vector of size 2
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Vector2 FromVector(Vector<T>^ vector) {
+                if (vector->Size != 2)
+                    throw gcnew ArgumentException("Vector must have 2 elements");
+                return Vector2(Convert::ToDouble(vector[0]), Convert::ToDouble(vector[1]));
+            }
+
+            /// <summary>
+            /// Converts the vector to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("({0}, {1})", x, y);
+            }
+        };
+    }
+}
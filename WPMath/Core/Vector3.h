@@ -0,0 +1,202 @@
+#pragma once
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A 3D vector stored inline as three doubles. Operations never allocate;
+        /// arrays of Vector3 are packed (x, y, z) triples that native kernels
+        /// read directly.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Vector3 {
+        private:
+            double x;
+            double y;
+            double z;
+
+        public:
+            /// <summary>
+            /// Creates a new vector
+            /// </summary>
+            Vector3(double x, double y, double z) {
+                this->x = x;
+                this->y = y;
+                this->z = z;
+            }
+
+            /// <summary>
+            /// Gets the zero vector
+            /// </summary>
+            static property Vector3 Zero {
+                Vector3 get() { return Vector3(0, 0, 0); }
+            }
+
+            /// <summary>
+            /// Gets the unit vector along X
+            /// </summary>
+            static property Vector3 UnitX {
+                Vector3 get() { return Vector3(1, 0, 0); }
+            }
+
+            /// <summary>
+            /// Gets the unit vector along Y
+            /// </summary>
+            static property Vector3 UnitY {
+                Vector3 get() { return Vector3(0, 1, 0); }
+            }
+
+            /// <summary>
+            /// Gets the unit vector along Z
+            /// </summary>
+            static property Vector3 UnitZ {
+                Vector3 get() { return Vector3(0, 0, 1); }
+            }
+
+            /// <summary>
+            /// Gets the X component
+            /// </summary>
+            property double X {
+                double get() { return x; }
+            }
+
+            /// <summary>
+            /// Gets the Y component
+            /// </summary>
+            property double Y {
+                double get() { return y; }
+            }
+
+            /// <summary>
+            /// Gets the Z component
+            /// </summary>
+            property double Z {
+                double get() { return z; }
+            }
+
+            /// <summary>
+            /// Gets the length of the vector
+            /// </summary>
+            property double Length {
+                double get() { return System::Math::Sqrt(x * x + y * y + z * z); }
+            }
+
+            /// <summary>
+            /// Gets the squared length, avoiding the square root
+            /// </summary>
+            property double LengthSquared {
+                double get() { return x * x + y * y + z * z; }
+            }
+
+            /// <summary>
+            /// Returns the vector scaled to unit length, or zero for a zero vector
+            /// </summary>
+            Vector3 Normalize() {
+                double length = Length;
+                return length > 0 ? Vector3(x / length, y / length, z / length) : Vector3(0, 0, 0);
+            }
+
+            /// <summary>
+            /// Calculates the dot product of two vectors
+            /// </summary>
+            static double Dot(Vector3 a, Vector3 b) {
+                return a.x * b.x + a.y * b.y + a.z * b.z;
+            }
+
+            /// <summary>
+            /// Calculates the cross product of two vectors
+            /// </summary>
+            static Vector3 Cross(Vector3 a, Vector3 b) {
+                return Vector3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+            }
+
+            /// <summary>
+            /// Calculates the distance between two points
+            /// </summary>
+            static double Distance(Vector3 a, Vector3 b) {
+                double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+                return System::Math::Sqrt(dx * dx + dy * dy + dz * dz);
+            }
+
+            /// <summary>
+            /// Interpolates linearly between two vectors
+            /// </summary>
+            static Vector3 Lerp(Vector3 a, Vector3 b, double t) {
+                return Vector3(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+            }
+
+            /// <summary>
+            /// Adds two vectors
+            /// </summary>
+            static Vector3 operator+(Vector3 a, Vector3 b) {
+                return Vector3(a.x + b.x, a.y + b.y, a.z + b.z);
+            }
+
+            /// <summary>
+            /// Subtracts two vectors
+            /// </summary>
+            static Vector3 operator-(Vector3 a, Vector3 b) {
+                return Vector3(a.x - b.x, a.y - b.y, a.z - b.z);
+            }
+
+            /// <summary>
+            /// Negates a vector
+            /// </summary>
+            static Vector3 operator-(Vector3 a) {
+                return Vector3(-a.x, -a.y, -a.z);
+            }
+
+            /// <summary>
+            /// Scales a vector
+            /// </summary>
+            static Vector3 operator*(Vector3 a, double s) {
+                return Vector3(a.x * s, a.y * s, a.z * s);
+            }
+
+            /// <summary>
+            /// Scales a vector
+            /// </summary>
+            static Vector3 operator*(double s, Vector3 a) {
+                return Vector3(a.x * s, a.y * s, a.z * s);
+            }
+
+            /// <summary>
+            /// Divides a vector by a scalar
+            /// </summary>
+            static Vector3 operator/(Vector3 a, double s) {
+                return Vector3(a.x / s, a.y / s, a.z / s);
+            }
+
+            /// <summary>
+            /// Converts to a general vector of size 3
+            /// </summary>
+            Vector<double>^ ToVector() {
+                Vector<double>^ result = gcnew Vector<double>(3);
+                result[0] = x;
+                result[1] = y;
+                result[2] = z;
+                return result;
+            }
+
+            /// <summary>
+            /// Converts a general vector of size 3
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Vector3 FromVector(Vector<T>^ vector) {
+                if (vector->Size != 3)
+                    throw gcnew ArgumentException("Vector must have 3 elements");
+                return Vector3(Convert::ToDouble(vector[0]), Convert::ToDouble(vector[1]), Convert::ToDouble(vector[2]));
+            }
+
+            /// <summary>
+            /// Converts the vector to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("({0}, {1}, {2})", x, y, z);
+            }
+        };
+    }
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "Vector3.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A 4D (homogeneous) vector stored inline as four doubles. Operations
+        /// never allocate; arrays of Vector4 are packed (x, y, z, w) quadruples
+        /// that native kernels read directly.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Vector4 {
+        private:
+            double x;
+            double y;
+            double z;
+            double w;
+
+        public:
+            /// <summary>
+            /// Creates a new vector
+            /// </summary>
+            Vector4(double x, double y, double z, double w) {
+                this->x = x;
+                this->y = y;
+                this->z = z;
+                this->w = w;
+            }
+
+            /// <summary>
+            /// Creates a homogeneous vector from a 3D vector and w
+            /// </summary>
+            Vector4(Vector3 v, double w) {
+                x = v.X;
+                y = v.Y;
+                z = v.Z;
+                this->w = w;
+            }
+
+            /// <summary>
+            /// Gets the zero vector
+            /// </summary>
+            static property Vector4 Zero {
+                Vector4 get() { return Vector4(0, 0, 0, 0); }
+            }
+
+            /// <summary>
+            /// Gets the X component
+            /// </summary>
+            property double X {
+                double get() { return x; }
+            }
+
+            /// <summary>
+            /// Gets the Y component
+            /// </summary>
+            property double Y {
+                double get() { return y; }
+            }
+
+            /// <summary>
+            /// Gets the Z component
+            /// </summary>
+            property double Z {
+                double get() { return z; }
+            }
+
+            /// <summary>
+            /// Gets the W component
+            /// </summary>
+            property double W {
+                double get() { return w; }
+            }
+
+            /// <summary>
+            /// Gets the length of the vector
+            /// </summary>
+            property double Length {
+                double get() { return System::Math::Sqrt(x * x + y * y + z * z + w * w); }
+            }
+
+            /// <summary>
+            /// Gets the squared length, avoiding the square root
+            /// </summary>
+            property double LengthSquared {
+                double get() { return x * x + y * y + z * z + w * w; }
+            }
+
+            /// <summary>
+            /// Returns the vector scaled to unit length, or zero for a zero vector
+            /// </summary>
+            Vector4 Normalize() {
+                double length = Length;
+                return length > 0 ? Vector4(x / length, y / length, z / length, w / length) : Vector4(0, 0, 0, 0);
+            }
+
+            /// <summary>
+            /// Divides x, y and z by w to project back to 3D
+            /// </summary>
+            Vector3 ToVector3() {
+                return Vector3(x / w, y / w, z / w);
+            }
+
+            /// <summary>
+            /// Calculates the dot product of two vectors
+            /// </summary>
+            static double Dot(Vector4 a, Vector4 b) {
+                return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+            }
+
+            /// <summary>
+            /// Interpolates linearly between two vectors
+            /// </summary>
+            static Vector4 Lerp(Vector4 a, Vector4 b, double t) {
+                return Vector4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                               a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+            }
+
+            /// <summary>
+            /// Adds two vectors
+            /// </summary>
+            static Vector4 operator+(Vector4 a, Vector4 b) {
+                return Vector4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+            }
+
+            /// <summary>
+            /// Subtracts two vectors
+            /// </summary>
+            static Vector4 operator-(Vector4 a, Vector4 b) {
+                return Vector4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+            }
+
+            /// <summary>
+            /// Negates a vector
+            /// </summary>
+            static Vector4 operator-(Vector4 a) {
+                return Vector4(-a.x, -a.y, -a.z, -a.w);
+            }
+
+            /// <summary>
+            /// Scales a vector
+            /// </summary>
+            static Vector4 operator*(Vector4 a, double s) {
+                return Vector4(a.x * s, a.y * s, a.z * s, a.w * s);
+            }
+
+            /// <summary>
+            /// Scales a vector
+            /// </summary>
+            static Vector4 operator*(double s, Vector4 a) {
+                return Vector4(a.x * s, a.y * s, a.z * s, a.w * s);
+            }
+
+            /// <summary>
+            /// Converts to a general vector of size 4
+            /// </summary>
+            Vector<double>^ ToVector() {
+                Vector<double>^ result = gcnew Vector<double>(4);
+                result[0] = x;
+                result[1] = y;
+                result[2] = z;
+                result[3] = w;
+                return result;
+            }
+
+            /// <summary>
+            /// Converts a general vector of size 4
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static Vector4 FromVector(Vector<T>^ vector) {
+                if (vector->Size != 4)
+                    throw gcnew ArgumentException("Vector must have 4 elements");
+                return Vector4(Convert::ToDouble(vector[0]), Convert::ToDouble(vector[1]),
+                               Convert::ToDouble(vector[2]), Convert::ToDouble(vector[3]));
+            }
+
+            /// <summary>
+            /// Converts the vector to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("({0}, {1}, {2}, {3})", x, y, z, w);
+            }
+        };
+    }
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "../Native/VectorBatch.h"
+#include "Arithmetic.h"
+
 using namespace System;
 
 namespace WindowPlus {
@@ -8,6 +11,134 @@ namespace WindowPlus {
         /// Provides advanced vector operations
         /// </summary>
         public ref class VectorOperations {
+        private:
+            static void CheckBatch(Array^ buffer, String^ name, long long count) {
+                if (buffer == nullptr)
+                    throw gcnew ArgumentNullException(name);
+                if (buffer->Length < count)
+                    throw gcnew ArgumentException("Buffer is shorter than the batch", name);
+            }
+
+            static void CheckCount(int count) {
+                if (count < 0)
+                    throw gcnew ArgumentOutOfRangeException("count");
+            }
+
+            template<typename T>
+            static void BatchDot(array<T>^ ax, array<T>^ ay, array<T>^ bx, array<T>^ by, array<T>^ result, int count) {
+                CheckCount(count);
+                CheckBatch(ax, "ax", count); CheckBatch(ay, "ay", count);
+                CheckBatch(bx, "bx", count); CheckBatch(by, "by", count);
+                CheckBatch(result, "result", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> pax = &ax[0], pay = &ay[0], pbx = &bx[0], pby = &by[0], pr = &result[0];
+                Native::BatchDot<T>(pax, pay, pbx, pby, pr, count);
+            }
+
+            template<typename T>
+            static void BatchDot(array<T>^ ax, array<T>^ ay, array<T>^ az, array<T>^ bx, array<T>^ by, array<T>^ bz,
+                                 array<T>^ result, int count) {
+                CheckCount(count);
+                CheckBatch(ax, "ax", count); CheckBatch(ay, "ay", count); CheckBatch(az, "az", count);
+                CheckBatch(bx, "bx", count); CheckBatch(by, "by", count); CheckBatch(bz, "bz", count);
+                CheckBatch(result, "result", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> pax = &ax[0], pay = &ay[0], paz = &az[0];
+                pin_ptr<T> pbx = &bx[0], pby = &by[0], pbz = &bz[0], pr = &result[0];
+                Native::BatchDot<T>(pax, pay, paz, pbx, pby, pbz, pr, count);
+            }
+
+            template<typename T>
+            static void BatchCross(array<T>^ ax, array<T>^ ay, array<T>^ az, array<T>^ bx, array<T>^ by, array<T>^ bz,
+                                   array<T>^ rx, array<T>^ ry, array<T>^ rz, int count) {
+                CheckCount(count);
+                CheckBatch(ax, "ax", count); CheckBatch(ay, "ay", count); CheckBatch(az, "az", count);
+                CheckBatch(bx, "bx", count); CheckBatch(by, "by", count); CheckBatch(bz, "bz", count);
+                CheckBatch(rx, "rx", count); CheckBatch(ry, "ry", count); CheckBatch(rz, "rz", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> pax = &ax[0], pay = &ay[0], paz = &az[0];
+                pin_ptr<T> pbx = &bx[0], pby = &by[0], pbz = &bz[0];
+                pin_ptr<T> prx = &rx[0], pry = &ry[0], prz = &rz[0];
+                Native::BatchCross<T>(pax, pay, paz, pbx, pby, pbz, prx, pry, prz, count);
+            }
+
+            template<typename T>
+            static void BatchDistance(array<T>^ ax, array<T>^ ay, array<T>^ bx, array<T>^ by, array<T>^ result, int count) {
+                CheckCount(count);
+                CheckBatch(ax, "ax", count); CheckBatch(ay, "ay", count);
+                CheckBatch(bx, "bx", count); CheckBatch(by, "by", count);
+                CheckBatch(result, "result", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> pax = &ax[0], pay = &ay[0], pbx = &bx[0], pby = &by[0], pr = &result[0];
+                Native::BatchDistance<T>(pax, pay, pbx, pby, pr, count);
+            }
+
+            template<typename T>
+            static void BatchDistance(array<T>^ ax, array<T>^ ay, array<T>^ az, array<T>^ bx, array<T>^ by, array<T>^ bz,
+                                      array<T>^ result, int count) {
+                CheckCount(count);
+                CheckBatch(ax, "ax", count); CheckBatch(ay, "ay", count); CheckBatch(az, "az", count);
+                CheckBatch(bx, "bx", count); CheckBatch(by, "by", count); CheckBatch(bz, "bz", count);
+                CheckBatch(result, "result", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> pax = &ax[0], pay = &ay[0], paz = &az[0];
+                pin_ptr<T> pbx = &bx[0], pby = &by[0], pbz = &bz[0], pr = &result[0];
+                Native::BatchDistance<T>(pax, pay, paz, pbx, pby, pbz, pr, count);
+            }
+
+            template<typename T>
+            static void BatchPairwise(array<T>^ ax, array<T>^ ay, array<T>^ az, int aCount,
+                                      array<T>^ bx, array<T>^ by, array<T>^ bz, int bCount, array<T>^ result) {
+                if (aCount < 0)
+                    throw gcnew ArgumentOutOfRangeException("aCount");
+                if (bCount < 0)
+                    throw gcnew ArgumentOutOfRangeException("bCount");
+                CheckBatch(ax, "ax", aCount); CheckBatch(ay, "ay", aCount);
+                CheckBatch(bx, "bx", bCount); CheckBatch(by, "by", bCount);
+                if (az != nullptr || bz != nullptr) {
+                    CheckBatch(az, "az", aCount);
+                    CheckBatch(bz, "bz", bCount);
+                }
+                CheckBatch(result, "result", (long long)aCount * bCount);
+                if (aCount == 0 || bCount == 0)
+                    return;
+
+                pin_ptr<T> pax = &ax[0], pay = &ay[0], pbx = &bx[0], pby = &by[0], pr = &result[0];
+                pin_ptr<T> paz = nullptr;
+                if (az != nullptr)
+                    paz = &az[0];
+                pin_ptr<T> pbz = nullptr;
+                if (bz != nullptr)
+                    pbz = &bz[0];
+                Native::PairwiseDistances<T>(pax, pay, paz, aCount, pbx, pby, pbz, bCount, pr);
+            }
+
+            template<typename T>
+            static void BatchNormalize(array<T>^ x, array<T>^ y, array<T>^ z, int count) {
+                CheckCount(count);
+                CheckBatch(x, "x", count); CheckBatch(y, "y", count);
+                if (z != nullptr)
+                    CheckBatch(z, "z", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> px = &x[0], py = &y[0];
+                pin_ptr<T> pz = nullptr;
+                if (z != nullptr)
+                    pz = &z[0];
+                Native::BatchNormalize<T>(px, py, pz, px, py, pz, count);
+            }
+
         public:
             /// <summary>
             /// Calculates the cross product of two 3D vectors
@@ -19,27 +150,55 @@ namespace WindowPlus {
                     throw gcnew ArgumentException("Cross product is only defined for 3D vectors");
 
                 Vector<T>^ result = gcnew Vector<T>(3);
-                result[0] = T((double)a[1] * (double)b[2] - (double)a[2] * (double)b[1]);
-                result[1] = T((double)a[2] * (double)b[0] - (double)a[0] * (double)b[2]);
-                result[2] = T((double)a[0] * (double)b[1] - (double)a[1] * (double)b[0]);
+                CrossProduct(a, b, result);
                 return result;
             }
 
+            /// <summary>
+            /// Writes the cross product of two 3D vectors into result, which
+            /// may be either operand, without allocating
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static void CrossProduct(Vector<T>^ a, Vector<T>^ b, Vector<T>^ result) {
+                if (a->Size != 3 || b->Size != 3 || result->Size != 3)
+                    throw gcnew ArgumentException("Cross product is only defined for 3D vectors");
+
+                double ax = Arithmetic<T>::ToDouble(a[0]), ay = Arithmetic<T>::ToDouble(a[1]), az = Arithmetic<T>::ToDouble(a[2]);
+                double bx = Arithmetic<T>::ToDouble(b[0]), by = Arithmetic<T>::ToDouble(b[1]), bz = Arithmetic<T>::ToDouble(b[2]);
+                result[0] = Arithmetic<T>::FromDouble(ay * bz - az * by);
+                result[1] = Arithmetic<T>::FromDouble(az * bx - ax * bz);
+                result[2] = Arithmetic<T>::FromDouble(ax * by - ay * bx);
+            }
+
             /// <summary>
             /// Projects vector a onto vector b
             /// </summary>
             generic<typename T>
             where T : value class
             static Vector<T>^ Project(Vector<T>^ a, Vector<T>^ b) {
-                double dotProduct = (double)a->DotProduct(b);
+                Vector<T>^ result = gcnew Vector<T>(a->Size);
+                Project(a, b, result);
+                return result;
+            }
+
+            /// <summary>
+            /// Writes the projection of vector a onto vector b into result,
+            /// which may be either operand, without allocating
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            static void Project(Vector<T>^ a, Vector<T>^ b, Vector<T>^ result) {
+                if (result->Size != a->Size)
+                    throw gcnew ArgumentException("Vectors must have the same dimension", "result");
+
+                double dotProduct = a->DotProduct(b, Summation::Naive);
                 double bMagnitudeSquared = Math::Pow(b->Magnitude(), 2);
                 double scalar = dotProduct / bMagnitudeSquared;
 
-                Vector<T>^ result = gcnew Vector<T>(a->Size);
                 for (int i = 0; i < a->Size; i++) {
-                    result[i] = T(scalar * (double)b[i]);
+                    result[i] = Arithmetic<T>::FromDouble(scalar * Arithmetic<T>::ToDouble(b[i]));
                 }
-                return result;
             }
 
             /// <summary>
@@ -48,7 +207,7 @@ namespace WindowPlus {
             generic<typename T>
             where T : value class
             static double AngleBetween(Vector<T>^ a, Vector<T>^ b) {
-                double dotProduct = (double)a->DotProduct(b);
+                double dotProduct = a->DotProduct(b, Summation::Naive);
                 double magnitudeProduct = a->Magnitude() * b->Magnitude();
                 return Math::Acos(dotProduct / magnitudeProduct);
             }
@@ -59,7 +218,7 @@ namespace WindowPlus {
             generic<typename T>
             where T : value class
             static bool AreOrthogonal(Vector<T>^ a, Vector<T>^ b) {
-                return Math::Abs((double)a->DotProduct(b)) < 1e-10;
+                return Math::Abs(a->DotProduct(b, Summation::Naive)) < 1e-10;
             }
 
             /// <summary>
@@ -73,11 +232,178 @@ namespace WindowPlus {
 
                 double sumSquared = 0;
                 for (int i = 0; i < a->Size; i++) {
-                    double diff = (double)a[i] - (double)b[i];
+                    double diff = Arithmetic<T>::ToDouble(a[i]) - Arithmetic<T>::ToDouble(b[i]);
                     sumSquared += diff * diff;
                 }
                 return Math::Sqrt(sumSquared);
             }
+
+            // Batch operations over structure-of-arrays buffers: point i is
+            // (x[i], y[i]) or (x[i], y[i], z[i]). Results go into caller-owned
+            // buffers, so steady-state loops allocate nothing. Only the first
+            // count elements of each buffer are read or written.
+
+            /// <summary>
+            /// Computes result[i] = a[i] . b[i] for count 2D points
+            /// </summary>
+            static void DotProduct(array<double>^ ax, array<double>^ ay, array<double>^ bx, array<double>^ by,
+                                   array<double>^ result, int count) {
+                BatchDot(ax, ay, bx, by, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = a[i] . b[i] for count 2D points
+            /// </summary>
+            static void DotProduct(array<float>^ ax, array<float>^ ay, array<float>^ bx, array<float>^ by,
+                                   array<float>^ result, int count) {
+                BatchDot(ax, ay, bx, by, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = a[i] . b[i] for count 3D points
+            /// </summary>
+            static void DotProduct(array<double>^ ax, array<double>^ ay, array<double>^ az,
+                                   array<double>^ bx, array<double>^ by, array<double>^ bz,
+                                   array<double>^ result, int count) {
+                BatchDot(ax, ay, az, bx, by, bz, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = a[i] . b[i] for count 3D points
+            /// </summary>
+            static void DotProduct(array<float>^ ax, array<float>^ ay, array<float>^ az,
+                                   array<float>^ bx, array<float>^ by, array<float>^ bz,
+                                   array<float>^ result, int count) {
+                BatchDot(ax, ay, az, bx, by, bz, result, count);
+            }
+
+            /// <summary>
+            /// Computes r[i] = a[i] x b[i] for count 3D points. The result
+            /// buffers may be the input buffers.
+            /// </summary>
+            static void CrossProduct(array<double>^ ax, array<double>^ ay, array<double>^ az,
+                                     array<double>^ bx, array<double>^ by, array<double>^ bz,
+                                     array<double>^ rx, array<double>^ ry, array<double>^ rz, int count) {
+                BatchCross(ax, ay, az, bx, by, bz, rx, ry, rz, count);
+            }
+
+            /// <summary>
+            /// Computes r[i] = a[i] x b[i] for count 3D points. The result
+            /// buffers may be the input buffers.
+            /// </summary>
+            static void CrossProduct(array<float>^ ax, array<float>^ ay, array<float>^ az,
+                                     array<float>^ bx, array<float>^ by, array<float>^ bz,
+                                     array<float>^ rx, array<float>^ ry, array<float>^ rz, int count) {
+                BatchCross(ax, ay, az, bx, by, bz, rx, ry, rz, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = |a[i] - b[i]| for count 2D points
+            /// </summary>
+            static void Distance(array<double>^ ax, array<double>^ ay, array<double>^ bx, array<double>^ by,
+                                 array<double>^ result, int count) {
+                BatchDistance(ax, ay, bx, by, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = |a[i] - b[i]| for count 2D points
+            /// </summary>
+            static void Distance(array<float>^ ax, array<float>^ ay, array<float>^ bx, array<float>^ by,
+                                 array<float>^ result, int count) {
+                BatchDistance(ax, ay, bx, by, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = |a[i] - b[i]| for count 3D points
+            /// </summary>
+            static void Distance(array<double>^ ax, array<double>^ ay, array<double>^ az,
+                                 array<double>^ bx, array<double>^ by, array<double>^ bz,
+                                 array<double>^ result, int count) {
+                BatchDistance(ax, ay, az, bx, by, bz, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = |a[i] - b[i]| for count 3D points
+            /// </summary>
+            static void Distance(array<float>^ ax, array<float>^ ay, array<float>^ az,
+                                 array<float>^ bx, array<float>^ by, array<float>^ bz,
+                                 array<float>^ result, int count) {
+                BatchDistance(ax, ay, az, bx, by, bz, result, count);
+            }
+
+            /// <summary>
+            /// Writes the distance between every pair of 2D points into the
+            /// row-major aCount x bCount buffer result: result[i * bCount + j] = |a[i] - b[j]|
+            /// </summary>
+            static void PairwiseDistances(array<double>^ ax, array<double>^ ay, int aCount,
+                                          array<double>^ bx, array<double>^ by, int bCount, array<double>^ result) {
+                BatchPairwise<double>(ax, ay, nullptr, aCount, bx, by, nullptr, bCount, result);
+            }
+
+            /// <summary>
+            /// Writes the distance between every pair of 2D points into the
+            /// row-major aCount x bCount buffer result: result[i * bCount + j] = |a[i] - b[j]|
+            /// </summary>
+            static void PairwiseDistances(array<float>^ ax, array<float>^ ay, int aCount,
+                                          array<float>^ bx, array<float>^ by, int bCount, array<float>^ result) {
+                BatchPairwise<float>(ax, ay, nullptr, aCount, bx, by, nullptr, bCount, result);
+            }
+
+            /// <summary>
+            /// Writes the distance between every pair of 3D points into the
+            /// row-major aCount x bCount buffer result: result[i * bCount + j] = |a[i] - b[j]|
+            /// </summary>
+            static void PairwiseDistances(array<double>^ ax, array<double>^ ay, array<double>^ az, int aCount,
+                                          array<double>^ bx, array<double>^ by, array<double>^ bz, int bCount,
+                                          array<double>^ result) {
+                if (az == nullptr)
+                    throw gcnew ArgumentNullException("az");
+                BatchPairwise(ax, ay, az, aCount, bx, by, bz, bCount, result);
+            }
+
+            /// <summary>
+            /// Writes the distance between every pair of 3D points into the
+            /// row-major aCount x bCount buffer result: result[i * bCount + j] = |a[i] - b[j]|
+            /// </summary>
+            static void PairwiseDistances(array<float>^ ax, array<float>^ ay, array<float>^ az, int aCount,
+                                          array<float>^ bx, array<float>^ by, array<float>^ bz, int bCount,
+                                          array<float>^ result) {
+                if (az == nullptr)
+                    throw gcnew ArgumentNullException("az");
+                BatchPairwise(ax, ay, az, aCount, bx, by, bz, bCount, result);
+            }
+
+            /// <summary>
+            /// Normalizes count 2D points in place. Zero-length points stay zero.
+            /// </summary>
+            static void Normalize(array<double>^ x, array<double>^ y, int count) {
+                BatchNormalize<double>(x, y, nullptr, count);
+            }
+
+            /// <summary>
+            /// Normalizes count 2D points in place. Zero-length points stay zero.
+            /// </summary>
+            static void Normalize(array<float>^ x, array<float>^ y, int count) {
+                BatchNormalize<float>(x, y, nullptr, count);
+            }
+
+            /// <summary>
+            /// Normalizes count 3D points in place. Zero-length points stay zero.
+            /// </summary>
+            static void Normalize(array<double>^ x, array<double>^ y, array<double>^ z, int count) {
+                if (z == nullptr)
+                    throw gcnew ArgumentNullException("z");
+                BatchNormalize(x, y, z, count);
+            }
+
+            /// <summary>
+            /// Normalizes count 3D points in place. Zero-length points stay zero.
+            /// </summary>
+            static void Normalize(array<float>^ x, array<float>^ y, array<float>^ z, int count) {
+                if (z == nullptr)
+                    throw gcnew ArgumentNullException("z");
+                BatchNormalize(x, y, z, count);
+            }
         };
     }
 } 
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "BufferPool.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A scoped arena for the temporaries of one frame or computation.
+        /// Arrays are rented from the BufferPool, and matrices and vectors are
+        /// kept by shape, so once a frame has run the same frame allocates
+        /// nothing. Reset at the end of the frame makes everything rented
+        /// available again; disposing returns the arrays to the pool. Contents
+        /// are not cleared between rentals. A workspace belongs to the thread
+        /// that uses it.
+        /// </summary>
+        public ref class Workspace sealed {
+        private:
+            List<Array^>^ arrays;
+            // Matrices and vectors handed out since the last Reset, with the
+            // type and shape each is filed under
+            List<Object^>^ used;
+            List<Type^>^ usedTypes;
+            List<long long>^ usedShapes;
+            Dictionary<Type^, Dictionary<long long, Stack<Object^>^>^>^ free;
+
+            Stack<Object^>^ FreeList(Type^ type, long long shape) {
+                Dictionary<long long, Stack<Object^>^>^ shapes;
+                if (!free->TryGetValue(type, shapes)) {
+                    shapes = gcnew Dictionary<long long, Stack<Object^>^>();
+                    free->Add(type, shapes);
+                }
+                Stack<Object^>^ list;
+                if (!shapes->TryGetValue(shape, list)) {
+                    list = gcnew Stack<Object^>();
+                    shapes->Add(shape, list);
+                }
+                return list;
+            }
+
+            Object^ Take(Type^ type, long long shape) {
+                if (arrays == nullptr)
+                    throw gcnew ObjectDisposedException("Workspace");
+                Stack<Object^>^ list = FreeList(type, shape);
+                return list->Count > 0 ? list->Pop() : nullptr;
+            }
+
+            void Track(Object^ item, Type^ type, long long shape) {
+                used->Add(item);
+                usedTypes->Add(type);
+                usedShapes->Add(shape);
+            }
+
+        public:
+            /// <summary>
+            /// Creates an empty workspace
+            /// </summary>
+            Workspace() {
+                arrays = gcnew List<Array^>();
+                used = gcnew List<Object^>();
+                usedTypes = gcnew List<Type^>();
+                usedShapes = gcnew List<long long>();
+                free = gcnew Dictionary<Type^, Dictionary<long long, Stack<Object^>^>^>();
+            }
+
+            ~Workspace() {
+                if (arrays == nullptr)
+                    return;
+                Reset();
+                arrays = nullptr;
+                free = nullptr;
+            }
+
+            /// <summary>
+            /// Rents an array of at least minimumLength elements until the next
+            /// Reset
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            array<T>^ Rent(int minimumLength) {
+                if (arrays == nullptr)
+                    throw gcnew ObjectDisposedException("Workspace");
+                array<T>^ buffer = BufferPool::Rent<T>(minimumLength);
+                arrays->Add(buffer);
+                return buffer;
+            }
+
+            /// <summary>
+            /// Gets a rows x cols matrix until the next Reset, reusing one
+            /// from an earlier frame when available
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            Matrix<T>^ RentMatrix(int rows, int cols) {
+                if (rows < 0)
+                    throw gcnew ArgumentOutOfRangeException("rows");
+                if (cols < 0)
+                    throw gcnew ArgumentOutOfRangeException("cols");
+
+                long long shape = ((long long)rows << 32) | (unsigned int)cols;
+                Object^ item = Take(Matrix<T>::typeid, shape);
+                Matrix<T>^ matrix = item != nullptr ? safe_cast<Matrix<T>^>(item) : gcnew Matrix<T>(rows, cols);
+                Track(matrix, Matrix<T>::typeid, shape);
+                return matrix;
+            }
+
+            /// <summary>
+            /// Gets a vector of the given size until the next Reset, reusing
+            /// one from an earlier frame when available
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            Vector<T>^ RentVector(int size) {
+                if (size < 0)
+                    throw gcnew ArgumentOutOfRangeException("size");
+
+                Object^ item = Take(Vector<T>::typeid, size);
+                Vector<T>^ vector = item != nullptr ? safe_cast<Vector<T>^>(item) : gcnew Vector<T>(size);
+                Track(vector, Vector<T>::typeid, size);
+                return vector;
+            }
+
+            /// <summary>
+            /// Makes everything rented since the last Reset available again.
+            /// Arrays go back to the BufferPool; matrices and vectors are kept
+            /// here for the next frame. Nothing rented before may be used
+            /// afterwards.
+            /// </summary>
+            void Reset() {
+                if (arrays == nullptr)
+                    throw gcnew ObjectDisposedException("Workspace");
+
+                for (int i = 0; i < arrays->Count; i++)
+                    BufferPool::ReturnArray(arrays[i]);
+                arrays->Clear();
+
+                for (int i = 0; i < used->Count; i++)
+                    FreeList(usedTypes[i], usedShapes[i])->Push(used[i]);
+                used->Clear();
+                usedTypes->Clear();
+                usedShapes->Clear();
+            }
+        };
+    }
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Rect.h"
+#include "../Native/AabbTree.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Spatial index over rectangles for hit testing: a dynamic bounding
+        /// volume hierarchy that answers point, rectangle and nearest-item
+        /// queries in logarithmic time. Items are identified by integer handles
+        /// that stay valid until removed.
+        ///
+        /// Items moving a little each frame are cheap with a Margin: Move only
+        /// restructures when an item leaves its enlarged box. For wholesale
+        /// changes, SetBounds every item and call Refit once, or Rebuild when
+        /// the layout changed shape. Queries are read-only and may run on
+        /// several threads while no thread modifies the tree.
+        /// </summary>
+        public ref class AabbTree {
+        private:
+            Native::AabbTree* tree;
+
+            Native::AabbTree& Tree() {
+                if (!tree)
+                    throw gcnew ObjectDisposedException("AabbTree");
+                return *tree;
+            }
+
+            static Native::Box ToBox(Rect r) {
+                Native::Box b = { r.Left, r.Top, r.Right, r.Bottom };
+                return b;
+            }
+
+            void CheckHandle(int handle) {
+                if (!Tree().IsItem(handle))
+                    throw gcnew ArgumentOutOfRangeException("handle");
+            }
+
+        public:
+            /// <summary>
+            /// Creates an empty tree
+            /// </summary>
+            AabbTree() {
+                tree = new Native::AabbTree();
+            }
+
+            ~AabbTree() {
+                this->!AabbTree();
+            }
+
+            !AabbTree() {
+                delete tree;
+                tree = nullptr;
+            }
+
+            /// <summary>
+            /// Gets or sets how far stored boxes extend past the items, so that
+            /// small moves need no restructuring. Applies to items added, moved
+            /// or rebuilt afterwards.
+            /// </summary>
+            property double Margin {
+                double get() { return Tree().Margin(); }
+                void set(double value) {
+                    if (!(value >= 0) || Double::IsInfinity(value))
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    Tree().SetMargin(value);
+                }
+            }
+
+            /// <summary>
+            /// Gets the number of items
+            /// </summary>
+            property int Count {
+                int get() { return Tree().Count(); }
+            }
+
+            /// <summary>
+            /// Gets the height of the tree, a measure of query cost
+            /// </summary>
+            property int Height {
+                int get() { return Tree().Height(); }
+            }
+
+            /// <summary>
+            /// Gets the rectangle of an item
+            /// </summary>
+            Rect GetBounds(int handle) {
+                CheckHandle(handle);
+                const Native::Box& b = Tree().Bounds(handle);
+                return Rect::FromEdges(b.MinX, b.MinY, b.MaxX, b.MaxY);
+            }
+
+            /// <summary>
+            /// Adds an item and returns its handle
+            /// </summary>
+            int Add(Rect bounds) {
+                return Tree().Insert(ToBox(bounds));
+            }
+
+            /// <summary>
+            /// Removes an item; its handle may be reused
+            /// </summary>
+            void Remove(int handle) {
+                CheckHandle(handle);
+                Tree().Remove(handle);
+            }
+
+            /// <summary>
+            /// Moves an item to new bounds. Returns true when the tree had to
+            /// be restructured.
+            /// </summary>
+            bool Move(int handle, Rect bounds) {
+                CheckHandle(handle);
+                return Tree().Move(handle, ToBox(bounds));
+            }
+
+            /// <summary>
+            /// Sets an item's bounds without updating the tree; call Refit
+            /// after the last change and before the next query
+            /// </summary>
+            void SetBounds(int handle, Rect bounds) {
+                CheckHandle(handle);
+                Tree().SetBounds(handle, ToBox(bounds));
+            }
+
+            /// <summary>
+            /// Updates the tree after SetBounds calls in one linear pass,
+            /// keeping its structure
+            /// </summary>
+            void Refit() {
+                Tree().Refit();
+            }
+
+            /// <summary>
+            /// Rebuilds the tree top-down over the current items for the best
+            /// query speed; handles are kept
+            /// </summary>
+            void Rebuild() {
+                Tree().Rebuild();
+            }
+
+            /// <summary>
+            /// Replaces the contents with the first count rectangles; item i
+            /// gets handle i. Much faster than adding them one by one.
+            /// </summary>
+            void Build(array<Rect>^ bounds, int count) {
+                if (bounds == nullptr)
+                    throw gcnew ArgumentNullException("bounds");
+                if (count < 0 || count > bounds->Length)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                if (count == 0) {
+                    Tree().Clear();
+                    return;
+                }
+                pin_ptr<Rect> pb = &bounds[0];
+                Tree().Build(reinterpret_cast<const Native::Box*>(pb), count);
+            }
+
+            /// <summary>
+            /// Removes all items
+            /// </summary>
+            void Clear() {
+                Tree().Clear();
+            }
+
+            /// <summary>
+            /// Finds items containing a point. Writes up to results->Length
+            /// handles and returns the total number of hits, which may be more.
+            /// </summary>
+            int QueryPoint(Vector2 point, array<int>^ results) {
+                if (results == nullptr)
+                    throw gcnew ArgumentNullException("results");
+                pin_ptr<int> pr = nullptr;
+                if (results->Length > 0)
+                    pr = &results[0];
+                return Tree().QueryPoint(point.X, point.Y, pr, results->Length);
+            }
+
+            /// <summary>
+            /// Finds items overlapping or touching a rectangle. Writes up to
+            /// results->Length handles and returns the total number of hits.
+            /// </summary>
+            int QueryRect(Rect area, array<int>^ results) {
+                if (results == nullptr)
+                    throw gcnew ArgumentNullException("results");
+                pin_ptr<int> pr = nullptr;
+                if (results->Length > 0)
+                    pr = &results[0];
+                return Tree().QueryBox(ToBox(area), pr, results->Length);
+            }
+
+            /// <summary>
+            /// Finds the item nearest to a point, with distance zero for items
+            /// containing it. Returns -1 when the tree is empty.
+            /// </summary>
+            int Nearest(Vector2 point) {
+                return Tree().Nearest(point.X, point.Y, Double::PositiveInfinity, nullptr);
+            }
+
+            /// <summary>
+            /// Finds the item nearest to a point within maxDistance, giving its
+            /// distance. Returns -1 when no item is that close.
+            /// </summary>
+            int Nearest(Vector2 point, double maxDistance, double% distance) {
+                if (!(maxDistance >= 0))
+                    throw gcnew ArgumentOutOfRangeException("maxDistance");
+                double squared;
+                int handle = Tree().Nearest(point.X, point.Y, maxDistance * maxDistance, &squared);
+                distance = System::Math::Sqrt(squared);
+                return handle;
+            }
+        };
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "../Core/Vector2.h"
+#include "../Native/PathGeometry.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Commands of a path, each followed by its points: MoveTo and LineTo
+        /// take one, QuadraticTo two (control, end), CubicTo three (two
+        /// controls, end) and Close none
+        /// </summary>
+        public enum class PathVerb : unsigned char {
+            MoveTo,
+            LineTo,
+            QuadraticTo,
+            CubicTo,
+            Close
+        };
+
+        /// <summary>
+        /// Curve flattening and convex clipping for custom drawing. Results go
+        /// into caller-owned arrays so that per-frame use does not allocate;
+        /// methods write what fits and return the full size, so a caller can
+        /// grow its buffers once and call again.
+        ///
+        /// Tolerances are in path units. To flatten for a transformed target,
+        /// divide the device tolerance (a quarter pixel is a good default) by
+        /// the transform's scale, so zooming in adds segments and zooming out
+        /// removes them.
+        /// </summary>
+        public ref class PathGeometry {
+        private:
+            static void CheckTolerance(double tolerance) {
+                if (!(tolerance > 0) || Double::IsInfinity(tolerance))
+                    throw gcnew ArgumentOutOfRangeException("tolerance");
+            }
+
+            static void CheckBatch(Array^ buffer, String^ name, int count) {
+                if (buffer == nullptr)
+                    throw gcnew ArgumentNullException(name);
+                if (count < 0 || buffer->Length < count)
+                    throw gcnew ArgumentOutOfRangeException("count", "Count exceeds the buffer " + name);
+            }
+
+            static Native::Point2 ToPoint(Vector2 v) {
+                Native::Point2 p = { v.X, v.Y };
+                return p;
+            }
+
+        public:
+            /// <summary>
+            /// Flattens a quadratic Bezier into line segments within tolerance
+            /// of the curve. Writes the points after p0, ending with p2, and
+            /// returns how many there are; only as many as fit are written.
+            /// </summary>
+            static int FlattenQuadratic(Vector2 p0, Vector2 p1, Vector2 p2, double tolerance, array<Vector2>^ result) {
+                CheckTolerance(tolerance);
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                pin_ptr<Vector2> pr = nullptr;
+                if (result->Length > 0)
+                    pr = &result[0];
+                return Native::FlattenQuadratic(ToPoint(p0), ToPoint(p1), ToPoint(p2), tolerance,
+                    reinterpret_cast<Native::Point2*>(pr), result->Length);
+            }
+
+            /// <summary>
+            /// Flattens a cubic Bezier into line segments within tolerance of
+            /// the curve. Writes the points after p0, ending with p3, and
+            /// returns how many there are; only as many as fit are written.
+            /// </summary>
+            static int FlattenCubic(Vector2 p0, Vector2 p1, Vector2 p2, Vector2 p3, double tolerance, array<Vector2>^ result) {
+                CheckTolerance(tolerance);
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                pin_ptr<Vector2> pr = nullptr;
+                if (result->Length > 0)
+                    pr = &result[0];
+                return Native::FlattenCubic(ToPoint(p0), ToPoint(p1), ToPoint(p2), ToPoint(p3), tolerance,
+                    reinterpret_cast<Native::Point2*>(pr), result->Length);
+            }
+
+            /// <summary>
+            /// Flattens a whole path into polylines, one per contour; a
+            /// closing edge back to the contour start is implied. Writes the
+            /// points and each contour's exclusive end index as far as they
+            /// fit, sets contourCount to the number of contours and returns the
+            /// number of points. Contours of a single point are dropped.
+            /// </summary>
+            static int Flatten(array<PathVerb>^ verbs, int verbCount, array<Vector2>^ points, int pointCount, double tolerance,
+                array<Vector2>^ result, array<int>^ contourEnds, int% contourCount) {
+                CheckTolerance(tolerance);
+                CheckBatch(verbs, "verbs", verbCount);
+                CheckBatch(points, "points", pointCount);
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                if (contourEnds == nullptr)
+                    throw gcnew ArgumentNullException("contourEnds");
+
+                pin_ptr<PathVerb> pv = nullptr;
+                if (verbCount > 0)
+                    pv = &verbs[0];
+                pin_ptr<Vector2> pp = nullptr;
+                if (pointCount > 0)
+                    pp = &points[0];
+                pin_ptr<Vector2> pr = nullptr;
+                if (result->Length > 0)
+                    pr = &result[0];
+                pin_ptr<int> pe = nullptr;
+                if (contourEnds->Length > 0)
+                    pe = &contourEnds[0];
+
+                int contours;
+                int total = Native::FlattenPath(reinterpret_cast<const unsigned char*>(pv), verbCount,
+                    reinterpret_cast<const Native::Point2*>(pp), pointCount, tolerance,
+                    reinterpret_cast<Native::Point2*>(pr), result->Length, pe, contourEnds->Length, &contours);
+                if (total < 0)
+                    throw gcnew ArgumentException("Path verbs do not match the points", "verbs");
+                contourCount = contours;
+                return total;
+            }
+
+            /// <summary>
+            /// Clips a polygon to a convex polygon of either winding
+            /// (Sutherland-Hodgman), returning the vertex count of the result.
+            /// result and scratch must each hold count + clipCount vertices;
+            /// concave subjects split in several pieces come back joined along
+            /// the clip edges. Use PolygonClipper for general polygons.
+            /// </summary>
+            static int ClipConvex(array<Vector2>^ subject, int count, array<Vector2>^ clip, int clipCount,
+                array<Vector2>^ result, array<Vector2>^ scratch) {
+                CheckBatch(subject, "subject", count);
+                CheckBatch(clip, "clip", clipCount);
+                if (count < 3 || clipCount < 3)
+                    return 0;
+                int capacity = count + clipCount;
+                if (result == nullptr || scratch == nullptr)
+                    throw gcnew ArgumentNullException(result == nullptr ? "result" : "scratch");
+                if (result->Length < capacity || scratch->Length < capacity)
+                    throw gcnew ArgumentException("Buffers must hold count + clipCount vertices", result->Length < capacity ? "result" : "scratch");
+
+                pin_ptr<Vector2> ps = &subject[0], pc = &clip[0], pr = &result[0], pt = &scratch[0];
+                int n = Native::ClipToConvex(reinterpret_cast<const Native::Point2*>(ps), count,
+                    reinterpret_cast<const Native::Point2*>(pc), clipCount,
+                    reinterpret_cast<Native::Point2*>(pr), reinterpret_cast<Native::Point2*>(pt),
+                    System::Math::Min(result->Length, scratch->Length));
+                if (n < 0)
+                    throw gcnew ArgumentException("Buffers are too small for the clipped polygon", "result");
+                return n;
+            }
+        };
+    }
+}
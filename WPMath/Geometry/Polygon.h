@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Rect.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A simple polygon given by its vertices in order; the closing edge
+        /// from the last vertex back to the first is implied. The vertex array
+        /// is shared, not copied.
+        /// </summary>
+        public ref class Polygon {
+        private:
+            array<Vector2>^ vertices;
+
+        public:
+            /// <summary>
+            /// Creates a polygon over the given vertices
+            /// </summary>
+            Polygon(array<Vector2>^ vertices) {
+                if (vertices == nullptr)
+                    throw gcnew ArgumentNullException("vertices");
+                if (vertices->Length < 3)
+                    throw gcnew ArgumentException("A polygon needs at least three vertices", "vertices");
+                this->vertices = vertices;
+            }
+
+            /// <summary>
+            /// Gets the vertices
+            /// </summary>
+            property array<Vector2>^ Vertices {
+                array<Vector2>^ get() { return vertices; }
+            }
+
+            /// <summary>
+            /// Gets the number of vertices
+            /// </summary>
+            property int Count {
+                int get() { return vertices->Length; }
+            }
+
+            /// <summary>
+            /// Gets the signed area: positive when the vertices run
+            /// counter-clockwise in a Y-up frame (clockwise on screen)
+            /// </summary>
+            property double SignedArea {
+                double get() {
+                    int n = vertices->Length;
+                    double sum = 0;
+                    for (int i = 0, j = n - 1; i < n; j = i++)
+                        sum += Vector2::Cross(vertices[j], vertices[i]);
+                    return sum / 2;
+                }
+            }
+
+            /// <summary>
+            /// Gets the area
+            /// </summary>
+            property double Area {
+                double get() { return System::Math::Abs(SignedArea); }
+            }
+
+            /// <summary>
+            /// Gets the centre of mass of the enclosed area
+            /// </summary>
+            property Vector2 Centroid {
+                Vector2 get() {
+                    int n = vertices->Length;
+                    // Offset by the first vertex to limit cancellation far from the origin
+                    Vector2 origin = vertices[0];
+                    double area = 0, cx = 0, cy = 0;
+                    for (int i = 0, j = n - 1; i < n; j = i++) {
+                        Vector2 a = vertices[j] - origin, b = vertices[i] - origin;
+                        double cross = Vector2::Cross(a, b);
+                        area += cross;
+                        cx += (a.X + b.X) * cross;
+                        cy += (a.Y + b.Y) * cross;
+                    }
+                    if (area == 0)
+                        return origin;
+                    return origin + Vector2(cx, cy) / (3 * area);
+                }
+            }
+
+            /// <summary>
+            /// Gets the bounding rectangle
+            /// </summary>
+            property Rect Bounds {
+                Rect get() {
+                    double minX = vertices[0].X, minY = vertices[0].Y, maxX = minX, maxY = minY;
+                    for (int i = 1; i < vertices->Length; i++) {
+                        minX = System::Math::Min(minX, vertices[i].X);
+                        minY = System::Math::Min(minY, vertices[i].Y);
+                        maxX = System::Math::Max(maxX, vertices[i].X);
+                        maxY = System::Math::Max(maxY, vertices[i].Y);
+                    }
+                    return Rect::FromEdges(minX, minY, maxX, maxY);
+                }
+            }
+
+            /// <summary>
+            /// Gets whether every turn goes the same way
+            /// </summary>
+            property bool IsConvex {
+                bool get() {
+                    int n = vertices->Length, sign = 0;
+                    for (int i = 0; i < n; i++) {
+                        Vector2 a = vertices[i], b = vertices[(i + 1) % n], c = vertices[(i + 2) % n];
+                        double cross = Vector2::Cross(b - a, c - b);
+                        int s = cross > 0 ? 1 : cross < 0 ? -1 : 0;
+                        if (s == 0)
+                            continue;
+                        if (sign != 0 && s != sign)
+                            return false;
+                        sign = s;
+                    }
+                    return true;
+                }
+            }
+
+            /// <summary>
+            /// Tests whether a point lies inside by the even-odd rule
+            /// </summary>
+            bool Contains(Vector2 point) {
+                int n = vertices->Length;
+                bool inside = false;
+                double x = point.X, y = point.Y;
+                for (int i = 0, j = n - 1; i < n; j = i++) {
+                    Vector2 a = vertices[i], b = vertices[j];
+                    if ((a.Y > y) != (b.Y > y) && x < a.X + (y - a.Y) * (b.X - a.X) / (b.Y - a.Y))
+                        inside = !inside;
+                }
+                return inside;
+            }
+        };
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../Core/Vector2.h"
+#include "../Native/PathGeometry.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Boolean operations on polygons
+        /// </summary>
+        public enum class PolygonOperation {
+            /// <summary>Area inside both polygons</summary>
+            Intersection,
+            /// <summary>Area inside either polygon</summary>
+            Union,
+            /// <summary>Area inside the subject but not the clip</summary>
+            Difference
+        };
+
+        /// <summary>
+        /// Boolean operations on two simple polygons of any shape and winding
+        /// (Greiner-Hormann). The result is a list of contours: outer
+        /// contours counter-clockwise in a Y-up frame, holes clockwise.
+        /// Vertices lying exactly on the other polygon's edges are resolved by
+        /// moving the subject by about 1e-9 of its size. For a convex clip
+        /// polygon, PathGeometry::ClipConvex is cheaper.
+        ///
+        /// The clipper keeps its scratch memory between calls, so reuse one
+        /// instance per thread to clip every frame without allocating.
+        /// </summary>
+        public ref class PolygonClipper {
+        private:
+            Native::PolygonClipper* clipper;
+
+            Native::PolygonClipper& Instance() {
+                if (!clipper)
+                    throw gcnew ObjectDisposedException("PolygonClipper");
+                return *clipper;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a clipper
+            /// </summary>
+            PolygonClipper() {
+                clipper = new Native::PolygonClipper();
+            }
+
+            ~PolygonClipper() {
+                this->!PolygonClipper();
+            }
+
+            !PolygonClipper() {
+                delete clipper;
+                clipper = nullptr;
+            }
+
+            /// <summary>
+            /// Combines the first subjectCount vertices of subject with the
+            /// first clipCount of clip. Writes the result points contour after
+            /// contour, and each contour's exclusive end index, as far as they
+            /// fit; sets contourCount to the number of contours and returns the
+            /// number of points.
+            /// </summary>
+            int Combine(array<Vector2>^ subject, int subjectCount, array<Vector2>^ clip, int clipCount, PolygonOperation operation,
+                array<Vector2>^ result, array<int>^ contourEnds, int% contourCount) {
+                if (subject == nullptr || clip == nullptr)
+                    throw gcnew ArgumentNullException(subject == nullptr ? "subject" : "clip");
+                if (result == nullptr || contourEnds == nullptr)
+                    throw gcnew ArgumentNullException(result == nullptr ? "result" : "contourEnds");
+                if (subjectCount < 0 || subjectCount > subject->Length)
+                    throw gcnew ArgumentOutOfRangeException("subjectCount");
+                if (clipCount < 0 || clipCount > clip->Length)
+                    throw gcnew ArgumentOutOfRangeException("clipCount");
+
+                pin_ptr<Vector2> ps = nullptr;
+                if (subjectCount > 0)
+                    ps = &subject[0];
+                pin_ptr<Vector2> pc = nullptr;
+                if (clipCount > 0)
+                    pc = &clip[0];
+                Native::PolygonClipper& c = Instance();
+                int contours = c.Combine(reinterpret_cast<const Native::Point2*>(ps), subjectCount,
+                    reinterpret_cast<const Native::Point2*>(pc), clipCount, (Native::ClipOperation)operation);
+
+                const std::vector<Native::Point2>& points = c.Points();
+                const std::vector<int>& ends = c.Ends();
+                int total = (int)points.size();
+                for (int i = 0, n = System::Math::Min(total, result->Length); i < n; i++)
+                    result[i] = Vector2(points[i].X, points[i].Y);
+                for (int k = 0, n = System::Math::Min(contours, contourEnds->Length); k < n; k++)
+                    contourEnds[k] = ends[k];
+                contourCount = contours;
+                return total;
+            }
+        };
+    }
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "../Core/Vector2.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// An axis-aligned rectangle stored as its four edges, with Y growing
+        /// downwards as in window coordinates. Edges are inclusive, so a point
+        /// on the border is inside. The layout matches the native box used by
+        /// AabbTree, so arrays of Rect pass to it without copying.
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Rect {
+        private:
+            double left;
+            double top;
+            double right;
+            double bottom;
+
+        public:
+            /// <summary>
+            /// Creates a rectangle from its top-left corner and size
+            /// </summary>
+            Rect(double x, double y, double width, double height) {
+                if (width < 0 || height < 0)
+                    throw gcnew ArgumentOutOfRangeException(width < 0 ? "width" : "height");
+                left = x;
+                top = y;
+                right = x + width;
+                bottom = y + height;
+            }
+
+            /// <summary>
+            /// Creates a rectangle from its edges
+            /// </summary>
+            static Rect FromEdges(double left, double top, double right, double bottom) {
+                if (right < left || bottom < top)
+                    throw gcnew ArgumentException("Edges are out of order");
+                Rect r;
+                r.left = left;
+                r.top = top;
+                r.right = right;
+                r.bottom = bottom;
+                return r;
+            }
+
+            /// <summary>
+            /// Creates the smallest rectangle containing two points
+            /// </summary>
+            static Rect FromPoints(Vector2 a, Vector2 b) {
+                return FromEdges(System::Math::Min(a.X, b.X), System::Math::Min(a.Y, b.Y),
+                    System::Math::Max(a.X, b.X), System::Math::Max(a.Y, b.Y));
+            }
+
+            /// <summary>
+            /// Gets the left edge
+            /// </summary>
+            property double Left {
+                double get() { return left; }
+            }
+
+            /// <summary>
+            /// Gets the top edge
+            /// </summary>
+            property double Top {
+                double get() { return top; }
+            }
+
+            /// <summary>
+            /// Gets the right edge
+            /// </summary>
+            property double Right {
+                double get() { return right; }
+            }
+
+            /// <summary>
+            /// Gets the bottom edge
+            /// </summary>
+            property double Bottom {
+                double get() { return bottom; }
+            }
+
+            /// <summary>
+            /// Gets the width
+            /// </summary>
+            property double Width {
+                double get() { return right - left; }
+            }
+
+            /// <summary>
+            /// Gets the height
+            /// </summary>
+            property double Height {
+                double get() { return bottom - top; }
+            }
+
+            /// <summary>
+            /// Gets the area
+            /// </summary>
+            property double Area {
+                double get() { return (right - left) * (bottom - top); }
+            }
+
+            /// <summary>
+            /// Gets the centre point
+            /// </summary>
+            property Vector2 Center {
+                Vector2 get() { return Vector2((left + right) / 2, (top + bottom) / 2); }
+            }
+
+            /// <summary>
+            /// Gets whether the rectangle has zero width or height
+            /// </summary>
+            property bool IsEmpty {
+                bool get() { return !(right > left && bottom > top); }
+            }
+
+            /// <summary>
+            /// Tests whether a point lies inside or on the border
+            /// </summary>
+            bool Contains(Vector2 point) {
+                return point.X >= left && point.X <= right && point.Y >= top && point.Y <= bottom;
+            }
+
+            /// <summary>
+            /// Tests whether another rectangle lies entirely inside
+            /// </summary>
+            bool Contains(Rect other) {
+                return other.left >= left && other.right <= right && other.top >= top && other.bottom <= bottom;
+            }
+
+            /// <summary>
+            /// Tests whether two rectangles overlap or touch
+            /// </summary>
+            bool Intersects(Rect other) {
+                return other.left <= right && other.right >= left && other.top <= bottom && other.bottom >= top;
+            }
+
+            /// <summary>
+            /// Calculates the squared distance from a point to the nearest
+            /// point of the rectangle, zero inside
+            /// </summary>
+            double DistanceSquared(Vector2 point) {
+                double dx = System::Math::Max(System::Math::Max(left - point.X, point.X - right), 0.0);
+                double dy = System::Math::Max(System::Math::Max(top - point.Y, point.Y - bottom), 0.0);
+                return dx * dx + dy * dy;
+            }
+
+            /// <summary>
+            /// Returns the rectangle grown by dx on the left and right and dy
+            /// on the top and bottom; negative amounts shrink it down to empty
+            /// </summary>
+            Rect Inflate(double dx, double dy) {
+                double cx = (left + right) / 2, cy = (top + bottom) / 2;
+                return FromEdges(System::Math::Min(left - dx, cx), System::Math::Min(top - dy, cy),
+                    System::Math::Max(right + dx, cx), System::Math::Max(bottom + dy, cy));
+            }
+
+            /// <summary>
+            /// Returns the rectangle moved by an offset
+            /// </summary>
+            Rect Offset(Vector2 offset) {
+                return FromEdges(left + offset.X, top + offset.Y, right + offset.X, bottom + offset.Y);
+            }
+
+            /// <summary>
+            /// Calculates the smallest rectangle containing both
+            /// </summary>
+            static Rect Union(Rect a, Rect b) {
+                return FromEdges(System::Math::Min(a.left, b.left), System::Math::Min(a.top, b.top),
+                    System::Math::Max(a.right, b.right), System::Math::Max(a.bottom, b.bottom));
+            }
+
+            /// <summary>
+            /// Calculates the overlap of two rectangles; returns false and an
+            /// empty rectangle when they do not intersect
+            /// </summary>
+            static bool Intersect(Rect a, Rect b, Rect% result) {
+                if (!a.Intersects(b)) {
+                    result = Rect();
+                    return false;
+                }
+                result = FromEdges(System::Math::Max(a.left, b.left), System::Math::Max(a.top, b.top),
+                    System::Math::Min(a.right, b.right), System::Math::Min(a.bottom, b.bottom));
+                return true;
+            }
+
+            /// <summary>
+            /// Converts the rectangle to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("[{0}, {1}, {2}, {3}]", left, top, right, bottom);
+            }
+        };
+    }
+}
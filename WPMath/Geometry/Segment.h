@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Rect.h"
+
+using namespace System;
+using namespace System::Runtime::InteropServices;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// A line segment between two points
+        /// </summary>
+        [StructLayout(LayoutKind::Sequential)]
+        public value class Segment {
+        private:
+            Vector2 start;
+            Vector2 end;
+
+        public:
+            /// <summary>
+            /// Creates a segment between two points
+            /// </summary>
+            Segment(Vector2 start, Vector2 end) {
+                this->start = start;
+                this->end = end;
+            }
+
+            /// <summary>
+            /// Gets the start point
+            /// </summary>
+            property Vector2 Start {
+                Vector2 get() { return start; }
+            }
+
+            /// <summary>
+            /// Gets the end point
+            /// </summary>
+            property Vector2 End {
+                Vector2 get() { return end; }
+            }
+
+            /// <summary>
+            /// Gets the length
+            /// </summary>
+            property double Length {
+                double get() { return Vector2::Distance(start, end); }
+            }
+
+            /// <summary>
+            /// Gets the bounding rectangle
+            /// </summary>
+            property Rect Bounds {
+                Rect get() { return Rect::FromPoints(start, end); }
+            }
+
+            /// <summary>
+            /// Gets the point at parameter t, from Start at 0 to End at 1
+            /// </summary>
+            Vector2 PointAt(double t) {
+                return Vector2::Lerp(start, end, t);
+            }
+
+            /// <summary>
+            /// Finds the point on the segment closest to a point
+            /// </summary>
+            Vector2 ClosestPoint(Vector2 point) {
+                Vector2 d = end - start;
+                double lengthSquared = d.LengthSquared;
+                if (lengthSquared == 0)
+                    return start;
+                double t = Vector2::Dot(point - start, d) / lengthSquared;
+                return PointAt(System::Math::Min(System::Math::Max(t, 0.0), 1.0));
+            }
+
+            /// <summary>
+            /// Calculates the squared distance from a point to the segment
+            /// </summary>
+            double DistanceSquared(Vector2 point) {
+                return (point - ClosestPoint(point)).LengthSquared;
+            }
+
+            /// <summary>
+            /// Tests whether two segments cross or touch, giving the crossing
+            /// point. Collinear overlapping segments report the first shared
+            /// point along this segment.
+            /// </summary>
+            bool Intersects(Segment other, Vector2% point) {
+                Vector2 r = end - start, s = other.end - other.start, q = other.start - start;
+                double denominator = Vector2::Cross(r, s);
+                if (denominator == 0) {
+                    if (Vector2::Cross(q, r) != 0)
+                        return false;
+                    // Collinear: project the other segment onto this one
+                    double rr = r.LengthSquared;
+                    if (rr == 0) {
+                        if (other.DistanceSquared(start) != 0)
+                            return false;
+                        point = start;
+                        return true;
+                    }
+                    double t0 = Vector2::Dot(q, r) / rr, t1 = t0 + Vector2::Dot(s, r) / rr;
+                    double lo = System::Math::Max(System::Math::Min(t0, t1), 0.0);
+                    double hi = System::Math::Min(System::Math::Max(t0, t1), 1.0);
+                    if (lo > hi)
+                        return false;
+                    point = PointAt(lo);
+                    return true;
+                }
+
+                double t = Vector2::Cross(q, s) / denominator;
+                double u = Vector2::Cross(q, r) / denominator;
+                if (t < 0 || t > 1 || u < 0 || u > 1)
+                    return false;
+                point = PointAt(t);
+                return true;
+            }
+
+            /// <summary>
+            /// Converts the segment to string representation
+            /// </summary>
+            virtual String^ ToString() override {
+                return String::Format("{0} - {1}", start, end);
+            }
+        };
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "../Core/Vector2.h"
+#include "../Native/PathGeometry.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Triangulates simple polygons into index buffers for drawing.
+        /// Monotone polygons, which include every convex one, take a linear
+        /// sweep; others are ear-clipped. Triangles keep the polygon's winding.
+        /// The triangulator keeps its scratch memory between calls, so reuse
+        /// one instance per thread to triangulate every frame without
+        /// allocating. Holes are not supported.
+        /// </summary>
+        public ref class Triangulator {
+        private:
+            Native::Triangulator* triangulator;
+
+            Native::Triangulator& Instance() {
+                if (!triangulator)
+                    throw gcnew ObjectDisposedException("Triangulator");
+                return *triangulator;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a triangulator
+            /// </summary>
+            Triangulator() {
+                triangulator = new Native::Triangulator();
+            }
+
+            ~Triangulator() {
+                this->!Triangulator();
+            }
+
+            !Triangulator() {
+                delete triangulator;
+                triangulator = nullptr;
+            }
+
+            /// <summary>
+            /// Triangulates the first count vertices of a polygon, writing
+            /// 3 * (count - 2) vertex indices. Returns the number of indices
+            /// written.
+            /// </summary>
+            int Triangulate(array<Vector2>^ polygon, int count, array<int>^ indices) {
+                if (polygon == nullptr)
+                    throw gcnew ArgumentNullException("polygon");
+                if (indices == nullptr)
+                    throw gcnew ArgumentNullException("indices");
+                if (count < 0 || count > polygon->Length)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                if (count < 3)
+                    return 0;
+                if (indices->Length < 3 * (count - 2))
+                    throw gcnew ArgumentException("Index buffer must hold 3 * (count - 2) indices", "indices");
+
+                pin_ptr<Vector2> pp = &polygon[0];
+                pin_ptr<int> pi = &indices[0];
+                return Instance().Triangulate(reinterpret_cast<const Native::Point2*>(pp), count, pi, 0);
+            }
+
+            /// <summary>
+            /// Triangulates several polygons stored one after another, as
+            /// returned by PathGeometry::Flatten and PolygonClipper::Combine;
+            /// contour k ends before contourEnds[k]. Indices refer to points.
+            /// Contours of fewer than three points are skipped. Returns the
+            /// number of indices written; indices must hold 3 * (points - 2 *
+            /// contours).
+            /// </summary>
+            int Triangulate(array<Vector2>^ points, array<int>^ contourEnds, int contourCount, array<int>^ indices) {
+                if (points == nullptr)
+                    throw gcnew ArgumentNullException("points");
+                if (contourEnds == nullptr)
+                    throw gcnew ArgumentNullException("contourEnds");
+                if (indices == nullptr)
+                    throw gcnew ArgumentNullException("indices");
+                if (contourCount < 0 || contourCount > contourEnds->Length)
+                    throw gcnew ArgumentOutOfRangeException("contourCount");
+
+                int needed = 0;
+                for (int k = 0, start = 0; k < contourCount; k++) {
+                    int end = contourEnds[k];
+                    if (end < start || end > points->Length)
+                        throw gcnew ArgumentException("Contour ends must ascend within the points", "contourEnds");
+                    if (end - start >= 3)
+                        needed += 3 * (end - start - 2);
+                    start = end;
+                }
+                if (needed == 0)
+                    return 0;
+                if (indices->Length < needed)
+                    throw gcnew ArgumentException("Index buffer is too small for the contours", "indices");
+
+                pin_ptr<Vector2> pp = &points[0];
+                pin_ptr<int> pi = &indices[0];
+                const Native::Point2* p = reinterpret_cast<const Native::Point2*>(pp);
+                int written = 0;
+                for (int k = 0, start = 0; k < contourCount; k++) {
+                    int end = contourEnds[k];
+                    written += Instance().Triangulate(p + start, end - start, pi + written, start);
+                    start = end;
+                }
+                return written;
+            }
+        };
+    }
+}
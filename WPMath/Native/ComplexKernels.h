@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Simd.h"
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            // Complex array kernels in two layouts. Interleaved arrays hold
+            // (re, im) pairs, matching the Complex value type and the FFT.
+            // Split arrays hold re[] and im[] separately, so every operation
+            // is a plain lane-wise Simd<double> loop. Outputs may alias inputs.
+
+            /// <summary>
+            /// r = a + b (or a - b when subtract is set) for count interleaved values
+            /// </summary>
+            inline void ComplexAdd(const double* a, const double* b, double* r, int count, bool subtract) {
+                typedef Simd<double> V;
+                long long n = 2LL * count, i = 0;
+                for (; i + V::Width <= n; i += V::Width) {
+                    V::Vec x = V::Load(a + i), y = V::Load(b + i);
+                    V::Store(r + i, subtract ? V::Sub(x, y) : V::Add(x, y));
+                }
+                for (; i < n; ++i)
+                    r[i] = subtract ? a[i] - b[i] : a[i] + b[i];
+            }
+
+            /// <summary>
+            /// r = a * b, or a * conj(b) when conjugate is set, for count
+            /// interleaved values
+            /// </summary>
+            inline void ComplexMultiply(const double* a, const double* b, double* r, int count, bool conjugate) {
+                int i = 0;
+#if defined(WP_MATH_SSE2)
+                // One value per register: (ar*br, ai*br) + (ai*bi, ar*bi) * sign
+                __m128d sign = conjugate ? _mm_set_pd(-1.0, 1.0) : _mm_set_pd(1.0, -1.0);
+                for (; i < count; ++i) {
+                    __m128d x = _mm_loadu_pd(a + 2 * i);
+                    __m128d y = _mm_loadu_pd(b + 2 * i);
+                    __m128d swapped = _mm_shuffle_pd(x, x, 1);
+                    __m128d t = _mm_mul_pd(_mm_mul_pd(swapped, _mm_unpackhi_pd(y, y)), sign);
+                    _mm_storeu_pd(r + 2 * i, _mm_add_pd(_mm_mul_pd(x, _mm_unpacklo_pd(y, y)), t));
+                }
+#endif
+                for (; i < count; ++i) {
+                    double ar = a[2 * i], ai = a[2 * i + 1];
+                    double br = b[2 * i], bi = conjugate ? -b[2 * i + 1] : b[2 * i + 1];
+                    r[2 * i] = ar * br - ai * bi;
+                    r[2 * i + 1] = ar * bi + ai * br;
+                }
+            }
+
+            /// <summary>
+            /// r = conj(a) * scale for count interleaved values
+            /// </summary>
+            inline void ComplexConjugate(const double* a, double* r, int count, double scale) {
+                for (int i = 0; i < count; ++i) {
+                    r[2 * i] = a[2 * i] * scale;
+                    r[2 * i + 1] = -a[2 * i + 1] * scale;
+                }
+            }
+
+            /// <summary>
+            /// r = a * scale for count interleaved values
+            /// </summary>
+            inline void ComplexScale(const double* a, double* r, int count, double scale) {
+                typedef Simd<double> V;
+                V::Vec s = V::Broadcast(scale);
+                long long n = 2LL * count, i = 0;
+                for (; i + V::Width <= n; i += V::Width)
+                    V::Store(r + i, V::Mul(V::Load(a + i), s));
+                for (; i < n; ++i)
+                    r[i] = a[i] * scale;
+            }
+
+            /// <summary>
+            /// magnitude[i] = |a[i]| (or |a[i]|^2 when squared is set) for
+            /// count interleaved values
+            /// </summary>
+            inline void ComplexMagnitude(const double* a, double* magnitude, int count, bool squared) {
+                for (int i = 0; i < count; ++i) {
+                    double re = a[2 * i], im = a[2 * i + 1];
+                    double m = re * re + im * im;
+                    magnitude[i] = squared ? m : std::sqrt(m);
+                }
+            }
+
+            /// <summary>
+            /// r = a + b (or a - b) for count split values
+            /// </summary>
+            inline void SplitAdd(const double* are, const double* aim, const double* bre, const double* bim,
+                                 double* rre, double* rim, int count, bool subtract) {
+                typedef Simd<double> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    V::Vec xr = V::Load(are + i), xi = V::Load(aim + i);
+                    V::Vec yr = V::Load(bre + i), yi = V::Load(bim + i);
+                    V::Store(rre + i, subtract ? V::Sub(xr, yr) : V::Add(xr, yr));
+                    V::Store(rim + i, subtract ? V::Sub(xi, yi) : V::Add(xi, yi));
+                }
+                for (; i < count; ++i) {
+                    rre[i] = subtract ? are[i] - bre[i] : are[i] + bre[i];
+                    rim[i] = subtract ? aim[i] - bim[i] : aim[i] + bim[i];
+                }
+            }
+
+            /// <summary>
+            /// r = a * b, or a * conj(b) when conjugate is set, for count split values
+            /// </summary>
+            inline void SplitMultiply(const double* are, const double* aim, const double* bre, const double* bim,
+                                      double* rre, double* rim, int count, bool conjugate) {
+                typedef Simd<double> V;
+                V::Vec sign = V::Broadcast(conjugate ? -1.0 : 1.0);
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    V::Vec xr = V::Load(are + i), xi = V::Load(aim + i);
+                    V::Vec yr = V::Load(bre + i), yi = V::Mul(V::Load(bim + i), sign);
+                    V::Store(rre + i, V::Sub(V::Mul(xr, yr), V::Mul(xi, yi)));
+                    V::Store(rim + i, V::MulAdd(xr, yi, V::Mul(xi, yr)));
+                }
+                for (; i < count; ++i) {
+                    double xr = are[i], xi = aim[i], yr = bre[i], yi = conjugate ? -bim[i] : bim[i];
+                    rre[i] = xr * yr - xi * yi;
+                    rim[i] = xr * yi + xi * yr;
+                }
+            }
+
+            /// <summary>
+            /// magnitude[i] = |a[i]| (or |a[i]|^2 when squared is set) for count split values
+            /// </summary>
+            inline void SplitMagnitude(const double* are, const double* aim, double* magnitude, int count, bool squared) {
+                typedef Simd<double> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    V::Vec xr = V::Load(are + i), xi = V::Load(aim + i);
+                    V::Vec m = V::MulAdd(xi, xi, V::Mul(xr, xr));
+                    V::Store(magnitude + i, squared ? m : V::Sqrt(m));
+                }
+                for (; i < count; ++i) {
+                    double m = are[i] * are[i] + aim[i] * aim[i];
+                    magnitude[i] = squared ? m : std::sqrt(m);
+                }
+            }
+
+            /// <summary>
+            /// Splits count interleaved values into re[] and im[]
+            /// </summary>
+            inline void Deinterleave(const double* a, double* re, double* im, int count) {
+                for (int i = 0; i < count; ++i) {
+                    re[i] = a[2 * i];
+                    im[i] = a[2 * i + 1];
+                }
+            }
+
+            /// <summary>
+            /// Interleaves re[] and im[] into count (re, im) pairs
+            /// </summary>
+            inline void Interleave(const double* re, const double* im, double* a, int count) {
+                for (int i = 0; i < count; ++i) {
+                    a[2 * i] = re[i];
+                    a[2 * i + 1] = im[i];
+                }
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
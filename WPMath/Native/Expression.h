@@ -0,0 +1,286 @@
+#pragma once
+
+#include "Simd.h"
+
+#include <cstring>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Instructions of a postfix element-wise program. Load pushes an
+            /// input; the binary ops pop two operands; the rest replace the top
+            /// of the stack. Scalar ops take their constant from the instruction.
+            /// </summary>
+            enum ExpressionOp {
+                ExprLoad,
+                ExprAdd,
+                ExprSubtract,
+                ExprMultiply,
+                ExprDivide,
+                ExprAddScalar,          // x + c
+                ExprMultiplyScalar,     // x * c
+                ExprDivideByScalar,     // x / c
+                ExprScalarSubtract,     // c - x
+                ExprScalarDivide,       // c / x
+                ExprNegate,
+                ExprAbs,
+                ExprSqrt
+            };
+
+            struct ExpressionInstruction {
+                int Op;
+                int Input;
+                double Scalar;
+            };
+
+            /// <summary>
+            /// Elements evaluated per step. Every stack level gets one chunk of
+            /// scratch, so intermediates stay in L1 no matter how long the
+            /// vectors are.
+            /// </summary>
+            const int ExpressionChunk = 256;
+
+            namespace Detail {
+                struct AddOp {
+                    template<typename V> static WP_MATH_FORCEINLINE typename V::Vec Apply(typename V::Vec a, typename V::Vec b) { return V::Add(a, b); }
+                    template<typename T> static WP_MATH_FORCEINLINE T Apply(T a, T b) { return a + b; }
+                };
+
+                struct SubtractOp {
+                    template<typename V> static WP_MATH_FORCEINLINE typename V::Vec Apply(typename V::Vec a, typename V::Vec b) { return V::Sub(a, b); }
+                    template<typename T> static WP_MATH_FORCEINLINE T Apply(T a, T b) { return a - b; }
+                };
+
+                struct MultiplyOp {
+                    template<typename V> static WP_MATH_FORCEINLINE typename V::Vec Apply(typename V::Vec a, typename V::Vec b) { return V::Mul(a, b); }
+                    template<typename T> static WP_MATH_FORCEINLINE T Apply(T a, T b) { return a * b; }
+                };
+
+                struct DivideOp {
+                    template<typename V> static WP_MATH_FORCEINLINE typename V::Vec Apply(typename V::Vec a, typename V::Vec b) { return V::Div(a, b); }
+                    template<typename T> static WP_MATH_FORCEINLINE T Apply(T a, T b) { return a / b; }
+                };
+
+                template<typename T, typename Op>
+                void Map(const T* a, const T* b, T* out, int n) {
+                    typedef Simd<T> V;
+                    int i = 0;
+                    for (; i + V::Width <= n; i += V::Width)
+                        V::Store(out + i, Op::template Apply<V>(V::Load(a + i), V::Load(b + i)));
+                    for (; i < n; ++i)
+                        out[i] = Op::Apply(a[i], b[i]);
+                }
+
+                // a op c, or c op a when swap is set
+                template<typename T, typename Op>
+                void MapScalar(const T* a, T c, T* out, int n, bool swap) {
+                    typedef Simd<T> V;
+                    typename V::Vec vc = V::Broadcast(c);
+                    int i = 0;
+                    if (swap) {
+                        for (; i + V::Width <= n; i += V::Width)
+                            V::Store(out + i, Op::template Apply<V>(vc, V::Load(a + i)));
+                        for (; i < n; ++i)
+                            out[i] = Op::Apply(c, a[i]);
+                    }
+                    else {
+                        for (; i + V::Width <= n; i += V::Width)
+                            V::Store(out + i, Op::template Apply<V>(V::Load(a + i), vc));
+                        for (; i < n; ++i)
+                            out[i] = Op::Apply(a[i], c);
+                    }
+                }
+
+                template<typename T>
+                void MapSqrt(const T* a, T* out, int n) {
+                    typedef Simd<T> V;
+                    int i = 0;
+                    for (; i + V::Width <= n; i += V::Width)
+                        V::Store(out + i, V::Sqrt(V::Load(a + i)));
+                    for (; i < n; ++i)
+                        out[i] = std::sqrt(a[i]);
+                }
+
+                template<typename T>
+                void MapAbs(const T* a, T* out, int n) {
+                    typedef Simd<T> V;
+                    typename V::Vec zero = V::Zero();
+                    int i = 0;
+                    for (; i + V::Width <= n; i += V::Width) {
+                        typename V::Vec x = V::Load(a + i);
+                        V::Store(out + i, V::Max(x, V::Sub(zero, x)));
+                    }
+                    for (; i < n; ++i)
+                        out[i] = a[i] < 0 ? -a[i] : a[i];
+                }
+
+                /// <summary>
+                /// Runs the program over elements [offset, offset + n) and
+                /// returns a pointer to the result. The last instruction writes
+                /// to out when it is not null; otherwise results land in scratch.
+                /// </summary>
+                template<typename T>
+                const T* RunChunk(const ExpressionInstruction* program, int length, const T* const* inputs,
+                                  long long offset, int n, T* scratch, const T** stack, T* out) {
+                    int sp = 0;
+                    for (int k = 0; k < length; ++k) {
+                        const ExpressionInstruction& ins = program[k];
+                        if (ins.Op == ExprLoad) {
+                            stack[sp++] = inputs[ins.Input] + offset;
+                            continue;
+                        }
+
+                        bool binary = ins.Op <= ExprDivide;
+                        const T* a = stack[sp - (binary ? 2 : 1)];
+                        const T* b = stack[sp - 1];
+                        int level = sp - (binary ? 2 : 1);
+                        T* target = (k == length - 1 && out) ? out : scratch + (long long)level * ExpressionChunk;
+                        T c = (T)ins.Scalar;
+
+                        switch (ins.Op) {
+                        case ExprAdd: Map<T, AddOp>(a, b, target, n); break;
+                        case ExprSubtract: Map<T, SubtractOp>(a, b, target, n); break;
+                        case ExprMultiply: Map<T, MultiplyOp>(a, b, target, n); break;
+                        case ExprDivide: Map<T, DivideOp>(a, b, target, n); break;
+                        case ExprAddScalar: MapScalar<T, AddOp>(a, c, target, n, false); break;
+                        case ExprMultiplyScalar: MapScalar<T, MultiplyOp>(a, c, target, n, false); break;
+                        case ExprDivideByScalar: MapScalar<T, DivideOp>(a, c, target, n, false); break;
+                        case ExprScalarSubtract: MapScalar<T, SubtractOp>(a, c, target, n, true); break;
+                        case ExprScalarDivide: MapScalar<T, DivideOp>(a, c, target, n, true); break;
+                        case ExprNegate: MapScalar<T, MultiplyOp>(a, T(-1), target, n, false); break;
+                        case ExprAbs: MapAbs(a, target, n); break;
+                        case ExprSqrt: MapSqrt(a, target, n); break;
+                        }
+
+                        if (binary)
+                            --sp;
+                        stack[sp - 1] = target;
+                    }
+                    return stack[0];
+                }
+
+                inline double SumChunk(const double* r, int n, bool squares, double*) {
+                    typedef Simd<double> V;
+                    V::Vec acc = V::Zero();
+                    int i = 0;
+                    for (; i + V::Width <= n; i += V::Width) {
+                        V::Vec x = V::Load(r + i);
+                        acc = squares ? V::MulAdd(x, x, acc) : V::Add(acc, x);
+                    }
+                    double sum = V::Sum(acc);
+                    for (; i < n; ++i)
+                        sum += squares ? r[i] * r[i] : r[i];
+                    return sum;
+                }
+
+                // Widens the chunk first, so float results are squared and
+                // added in double
+                inline double SumChunk(const float* r, int n, bool squares, double* wide) {
+                    for (int i = 0; i < n; ++i)
+                        wide[i] = r[i];
+                    return SumChunk(wide, n, squares, wide);
+                }
+            }
+
+            /// <summary>
+            /// Scratch for evaluating programs up to a given stack depth, in
+            /// either precision: one chunk per stack level, one chunk for
+            /// reductions and the operand stack. Keep one per program to
+            /// evaluate it repeatedly without allocating.
+            /// </summary>
+            class ExpressionWorkspace {
+            private:
+                AlignedBuffer<double> scratch;
+                AlignedBuffer<const void*> stack;
+                int depth;
+
+                ExpressionWorkspace(const ExpressionWorkspace&);
+                ExpressionWorkspace& operator=(const ExpressionWorkspace&);
+
+            public:
+                explicit ExpressionWorkspace(int depth)
+                    : scratch((std::size_t)(depth + 1) * ExpressionChunk), stack((std::size_t)depth), depth(depth) {
+                }
+
+                int Depth() const { return depth; }
+
+                template<typename T>
+                T* Scratch() const { return reinterpret_cast<T*>(scratch.Data()); }
+
+                template<typename T>
+                const T** Stack() const { return reinterpret_cast<const T**>(stack.Data()); }
+
+                double* Wide() const { return scratch.Data() + (std::size_t)depth * ExpressionChunk; }
+            };
+
+            /// <summary>
+            /// Evaluates a postfix program over count elements into dst in one
+            /// pass: each input element is read once and each output written
+            /// once, with no full-length temporaries. The workspace must be at
+            /// least the maximum stack depth of the program. dst may alias any
+            /// input.
+            /// </summary>
+            template<typename T>
+            void EvaluateExpression(const ExpressionInstruction* program, int length, const T* const* inputs,
+                                    long long count, T* dst, const ExpressionWorkspace& workspace) {
+                for (long long offset = 0; offset < count; offset += ExpressionChunk) {
+                    int n = (int)(count - offset < ExpressionChunk ? count - offset : ExpressionChunk);
+                    const T* result = Detail::RunChunk(program, length, inputs, offset, n, workspace.Scratch<T>(),
+                                                       workspace.Stack<T>(), dst + offset);
+                    // A bare Load never reaches the write-through path
+                    if (result != dst + offset)
+                        memmove(dst + offset, result, (size_t)n * sizeof(T));
+                }
+            }
+
+            /// <summary>
+            /// Evaluates a program into dst with a workspace of its own. depth
+            /// is the maximum stack depth of the program.
+            /// </summary>
+            template<typename T>
+            void EvaluateExpression(const ExpressionInstruction* program, int length, int depth,
+                                    const T* const* inputs, long long count, T* dst) {
+                ExpressionWorkspace workspace(depth);
+                EvaluateExpression(program, length, inputs, count, dst, workspace);
+            }
+
+            /// <summary>
+            /// Evaluates a program and returns the sum of its elements, or of
+            /// their squares, without storing them. Accumulates in double,
+            /// float results included.
+            /// </summary>
+            template<typename T>
+            double ReduceExpression(const ExpressionInstruction* program, int length, const T* const* inputs,
+                                    long long count, bool squares, const ExpressionWorkspace& workspace) {
+                double total = 0;
+                for (long long offset = 0; offset < count; offset += ExpressionChunk) {
+                    int n = (int)(count - offset < ExpressionChunk ? count - offset : ExpressionChunk);
+                    const T* r = Detail::RunChunk<T>(program, length, inputs, offset, n, workspace.Scratch<T>(),
+                                                     workspace.Stack<T>(), 0);
+                    total += Detail::SumChunk(r, n, squares, workspace.Wide());
+                }
+                return total;
+            }
+
+            /// <summary>
+            /// Reduces a program with a workspace of its own. depth is the
+            /// maximum stack depth of the program.
+            /// </summary>
+            template<typename T>
+            double ReduceExpression(const ExpressionInstruction* program, int length, int depth,
+                                    const T* const* inputs, long long count, bool squares) {
+                ExpressionWorkspace workspace(depth);
+                return ReduceExpression(program, length, inputs, count, squares, workspace);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
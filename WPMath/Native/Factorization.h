@@ -0,0 +1,347 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <cmath>
+#include <cfloat>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            namespace Detail {
+                /// <summary>
+                /// y[0..n) -= alpha * x[0..n); the workhorse of every row-oriented
+                /// elimination below, written so compilers vectorize it
+                /// </summary>
+                inline void SubtractScaled(double* WP_MATH_RESTRICT y, const double* WP_MATH_RESTRICT x,
+                                           double alpha, int n) {
+                    for (int i = 0; i < n; ++i)
+                        y[i] -= alpha * x[i];
+                }
+
+                inline double Dot(const double* x, const double* y, int n) {
+                    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                    int i = 0;
+                    for (; i + 4 <= n; i += 4) {
+                        s0 += x[i] * y[i];
+                        s1 += x[i + 1] * y[i + 1];
+                        s2 += x[i + 2] * y[i + 2];
+                        s3 += x[i + 3] * y[i + 3];
+                    }
+                    for (; i < n; ++i)
+                        s0 += x[i] * y[i];
+                    return (s0 + s1) + (s2 + s3);
+                }
+
+                inline void SwapRows(double* a, int cols, int r0, int r1) {
+                    double* x = a + (long long)r0 * cols;
+                    double* y = a + (long long)r1 * cols;
+                    for (int j = 0; j < cols; ++j) {
+                        double t = x[j];
+                        x[j] = y[j];
+                        y[j] = t;
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Factors the row-major n x n matrix a in place into P * A = L * U
+            /// with partial pivoting. L (unit diagonal) is stored below the
+            /// diagonal and U on and above it. perm[i] receives the source row of
+            /// row i. Returns the permutation sign. Zero pivots are left in place
+            /// so singular matrices still factor; callers check the diagonal.
+            /// </summary>
+            inline int LuFactor(double* a, int n, int* perm) {
+                int sign = 1;
+                for (int i = 0; i < n; ++i)
+                    perm[i] = i;
+
+                for (int j = 0; j < n; ++j) {
+                    int piv = j;
+                    double max = std::fabs(a[(long long)j * n + j]);
+                    for (int i = j + 1; i < n; ++i) {
+                        double v = std::fabs(a[(long long)i * n + j]);
+                        if (v > max) {
+                            max = v;
+                            piv = i;
+                        }
+                    }
+
+                    if (piv != j) {
+                        Detail::SwapRows(a, n, piv, j);
+                        int t = perm[piv];
+                        perm[piv] = perm[j];
+                        perm[j] = t;
+                        sign = -sign;
+                    }
+
+                    if (max == 0)
+                        continue;
+
+                    const double* rowJ = a + (long long)j * n;
+                    double inv = 1.0 / rowJ[j];
+                    for (int i = j + 1; i < n; ++i) {
+                        double* rowI = a + (long long)i * n;
+                        double l = rowI[j] *= inv;
+                        if (l != 0)
+                            Detail::SubtractScaled(rowI + j + 1, rowJ + j + 1, l, n - j - 1);
+                    }
+                }
+                return sign;
+            }
+
+            /// <summary>
+            /// Solves A * X = B from LuFactor output. b is n x nrhs row-major and
+            /// x receives the solution (b and x must not overlap).
+            /// </summary>
+            inline void LuSolve(const double* lu, int n, const int* perm, const double* b, int nrhs, double* x) {
+                for (int i = 0; i < n; ++i) {
+                    const double* src = b + (long long)perm[i] * nrhs;
+                    double* dst = x + (long long)i * nrhs;
+                    for (int c = 0; c < nrhs; ++c)
+                        dst[c] = src[c];
+                }
+
+                for (int i = 1; i < n; ++i) {
+                    const double* row = lu + (long long)i * n;
+                    double* xi = x + (long long)i * nrhs;
+                    for (int k = 0; k < i; ++k)
+                        if (row[k] != 0)
+                            Detail::SubtractScaled(xi, x + (long long)k * nrhs, row[k], nrhs);
+                }
+
+                for (int i = n - 1; i >= 0; --i) {
+                    const double* row = lu + (long long)i * n;
+                    double* xi = x + (long long)i * nrhs;
+                    for (int k = i + 1; k < n; ++k)
+                        if (row[k] != 0)
+                            Detail::SubtractScaled(xi, x + (long long)k * nrhs, row[k], nrhs);
+                    double inv = 1.0 / row[i];
+                    for (int c = 0; c < nrhs; ++c)
+                        xi[c] *= inv;
+                }
+            }
+
+            /// <summary>
+            /// Default relative tolerance for rank decisions on an m x n matrix
+            /// </summary>
+            inline double RankTolerance(int m, int n) {
+                return (m > n ? m : n) * DBL_EPSILON;
+            }
+
+            /// <summary>
+            /// Factors the symmetric positive definite row-major matrix a in place
+            /// into L * L^T, leaving L in the lower triangle (the upper triangle is
+            /// not referenced). Returns false if a is not positive definite.
+            /// </summary>
+            inline bool CholeskyFactor(double* a, int n) {
+                for (int j = 0; j < n; ++j) {
+                    double* rowJ = a + (long long)j * n;
+                    double d = rowJ[j] - Detail::Dot(rowJ, rowJ, j);
+                    if (!(d > 0))
+                        return false;
+                    double ljj = std::sqrt(d);
+                    rowJ[j] = ljj;
+                    double inv = 1.0 / ljj;
+                    for (int i = j + 1; i < n; ++i) {
+                        double* rowI = a + (long long)i * n;
+                        rowI[j] = (rowI[j] - Detail::Dot(rowI, rowJ, j)) * inv;
+                    }
+                }
+                return true;
+            }
+
+            /// <summary>
+            /// Solves A * X = B in place from CholeskyFactor output; x holds B
+            /// (n x nrhs row-major) on entry and X on exit
+            /// </summary>
+            inline void CholeskySolve(const double* l, int n, double* x, int nrhs) {
+                for (int i = 0; i < n; ++i) {
+                    const double* row = l + (long long)i * n;
+                    double* xi = x + (long long)i * nrhs;
+                    for (int k = 0; k < i; ++k)
+                        if (row[k] != 0)
+                            Detail::SubtractScaled(xi, x + (long long)k * nrhs, row[k], nrhs);
+                    double inv = 1.0 / row[i];
+                    for (int c = 0; c < nrhs; ++c)
+                        xi[c] *= inv;
+                }
+
+                for (int i = n - 1; i >= 0; --i) {
+                    const double* row = l + (long long)i * n;
+                    double* xi = x + (long long)i * nrhs;
+                    double inv = 1.0 / row[i];
+                    for (int c = 0; c < nrhs; ++c)
+                        xi[c] *= inv;
+                    for (int k = 0; k < i; ++k)
+                        if (row[k] != 0)
+                            Detail::SubtractScaled(x + (long long)k * nrhs, xi, row[k], nrhs);
+                }
+            }
+
+            /// <summary>
+            /// Householder QR with column pivoting of the row-major m x n matrix a:
+            /// A * P = Q * R. R is left on and above the diagonal, the essential
+            /// parts of the reflectors below it (unit leading entry implied), their
+            /// scalars in tau[min(m, n)], and perm[j] is the source column of
+            /// column j. work must hold 2 * n doubles.
+            /// </summary>
+            inline void QrFactor(double* a, int m, int n, double* tau, int* perm, double* work) {
+                double* norms = work;
+                double* w = work + n;
+                int steps = m < n ? m : n;
+
+                for (int j = 0; j < n; ++j) {
+                    perm[j] = j;
+                    norms[j] = 0;
+                }
+                for (int i = 0; i < m; ++i) {
+                    const double* row = a + (long long)i * n;
+                    for (int j = 0; j < n; ++j)
+                        norms[j] += row[j] * row[j];
+                }
+
+                for (int j = 0; j < steps; ++j) {
+                    int piv = j;
+                    for (int c = j + 1; c < n; ++c)
+                        if (norms[c] > norms[piv])
+                            piv = c;
+                    if (piv != j) {
+                        for (int i = 0; i < m; ++i) {
+                            double* row = a + (long long)i * n;
+                            double t = row[j];
+                            row[j] = row[piv];
+                            row[piv] = t;
+                        }
+                        double t = norms[j];
+                        norms[j] = norms[piv];
+                        norms[piv] = t;
+                        int p = perm[j];
+                        perm[j] = perm[piv];
+                        perm[piv] = p;
+                    }
+
+                    // Generate the reflector for column j, rows j..m-1.
+                    double alpha = a[(long long)j * n + j];
+                    double sigma = 0;
+                    for (int i = j + 1; i < m; ++i) {
+                        double v = a[(long long)i * n + j];
+                        sigma += v * v;
+                    }
+                    if (sigma == 0) {
+                        tau[j] = 0;
+                    }
+                    else {
+                        double norm = std::sqrt(alpha * alpha + sigma);
+                        double beta = alpha <= 0 ? norm : -norm;
+                        tau[j] = (beta - alpha) / beta;
+                        double scale = 1.0 / (alpha - beta);
+                        for (int i = j + 1; i < m; ++i)
+                            a[(long long)i * n + j] *= scale;
+                        a[(long long)j * n + j] = beta;
+
+                        // Apply H = I - tau v v^T to the trailing columns: w = v^T A, A -= tau v w.
+                        int width = n - j - 1;
+                        if (width > 0) {
+                            const double* rowJ = a + (long long)j * n + j + 1;
+                            for (int c = 0; c < width; ++c)
+                                w[c] = rowJ[c];
+                            for (int i = j + 1; i < m; ++i) {
+                                double* row = a + (long long)i * n;
+                                double v = row[j];
+                                if (v != 0)
+                                    Detail::SubtractScaled(w, row + j + 1, -v, width);
+                            }
+                            double* rowJw = a + (long long)j * n + j + 1;
+                            Detail::SubtractScaled(rowJw, w, tau[j], width);
+                            for (int i = j + 1; i < m; ++i) {
+                                double* row = a + (long long)i * n;
+                                double v = row[j];
+                                if (v != 0)
+                                    Detail::SubtractScaled(row + j + 1, w, tau[j] * v, width);
+                            }
+                        }
+                    }
+
+                    // Downdate the remaining column norms, recomputing on cancellation.
+                    const double* rowJ = a + (long long)j * n;
+                    for (int c = j + 1; c < n; ++c) {
+                        double updated = norms[c] - rowJ[c] * rowJ[c];
+                        if (updated <= 1e-8 * norms[c]) {
+                            updated = 0;
+                            for (int i = j + 1; i < m; ++i) {
+                                double v = a[(long long)i * n + c];
+                                updated += v * v;
+                            }
+                        }
+                        norms[c] = updated;
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Counts the diagonal entries of a pivoted R whose magnitude exceeds
+            /// tolerance * |R(0, 0)|
+            /// </summary>
+            inline int QrRank(const double* qr, int m, int n, double tolerance) {
+                int steps = m < n ? m : n;
+                if (steps == 0)
+                    return 0;
+                double threshold = std::fabs(qr[0]) * tolerance;
+                int rank = 0;
+                while (rank < steps && std::fabs(qr[(long long)rank * n + rank]) > threshold)
+                    ++rank;
+                return rank;
+            }
+
+            /// <summary>
+            /// Computes the least squares solution of A * X = B (m x n, m >= n)
+            /// from QrFactor output using the leading rank columns of R; the
+            /// remaining unknowns are set to zero. b (m x nrhs) is overwritten
+            /// with Q^T B and x receives X (n x nrhs).
+            /// </summary>
+            inline void QrSolve(const double* qr, int m, int n, const double* tau, const int* perm, int rank,
+                                double* b, int nrhs, double* x) {
+                int steps = m < n ? m : n;
+                for (int j = 0; j < steps; ++j) {
+                    if (tau[j] == 0)
+                        continue;
+                    // b -= tau v (v^T b) with v = (1, qr[j+1..m, j])
+                    for (int c = 0; c < nrhs; ++c) {
+                        double s = b[(long long)j * nrhs + c];
+                        for (int i = j + 1; i < m; ++i)
+                            s += qr[(long long)i * n + j] * b[(long long)i * nrhs + c];
+                        s *= tau[j];
+                        b[(long long)j * nrhs + c] -= s;
+                        for (int i = j + 1; i < m; ++i)
+                            b[(long long)i * nrhs + c] -= s * qr[(long long)i * n + j];
+                    }
+                }
+
+                for (int i = rank - 1; i >= 0; --i) {
+                    double* bi = b + (long long)i * nrhs;
+                    const double* row = qr + (long long)i * n;
+                    for (int k = i + 1; k < rank; ++k)
+                        Detail::SubtractScaled(bi, b + (long long)k * nrhs, row[k], nrhs);
+                    double inv = 1.0 / row[i];
+                    for (int c = 0; c < nrhs; ++c)
+                        bi[c] *= inv;
+                }
+
+                for (int j = 0; j < n; ++j) {
+                    double* dst = x + (long long)perm[j] * nrhs;
+                    for (int c = 0; c < nrhs; ++c)
+                        dst[c] = j < rank ? b[(long long)j * nrhs + c] : 0.0;
+                }
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
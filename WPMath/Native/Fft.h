@@ -0,0 +1,372 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// A precomputed FFT of one length: the radix schedule and the
+            /// twiddle table exp(-2*pi*i*k/n) are built once and shared by every
+            /// call, forward or inverse, and so is the work buffer allocated on
+            /// the first Execute, so later calls allocate nothing. To run one
+            /// plan on several threads at once, give each its own workspace of
+            /// WorkLength doubles. Data is interleaved (re, im).
+            /// </summary>
+            class FftPlan {
+            private:
+                int n;
+                std::vector<int> radices;
+                std::vector<double> twiddles;
+                std::vector<double> work;
+
+                FftPlan(const FftPlan&);
+                FftPlan& operator=(const FftPlan&);
+
+                /// <summary>
+                /// Twiddle w^k for the current direction
+                /// </summary>
+                WP_MATH_FORCEINLINE void Twiddle(long long k, bool inverse, double& re, double& im) const {
+                    re = twiddles[2 * k];
+                    im = inverse ? -twiddles[2 * k + 1] : twiddles[2 * k + 1];
+                }
+
+                /// <summary>
+                /// In-place DFT of the r values in v (interleaved), using the
+                /// closed-form butterflies for radix 2, 3, 4 and 5 and the
+                /// O(r^2) sum for any other prime
+                /// </summary>
+                void Butterfly(double* v, int r, bool inverse, double* scratch) const {
+                    double s = inverse ? 1.0 : -1.0;
+                    switch (r) {
+                    case 2: {
+                        double ar = v[0], ai = v[1], br = v[2], bi = v[3];
+                        v[0] = ar + br; v[1] = ai + bi;
+                        v[2] = ar - br; v[3] = ai - bi;
+                        return;
+                    }
+                    case 3: {
+                        const double c = -0.5, d = 0.86602540378443864676 * s;
+                        double ar = v[0], ai = v[1];
+                        double tr = v[2] + v[4], ti = v[3] + v[5];
+                        double ur = (v[3] - v[5]) * -d, ui = (v[2] - v[4]) * d;
+                        double mr = ar + c * tr, mi = ai + c * ti;
+                        v[0] = ar + tr; v[1] = ai + ti;
+                        v[2] = mr + ur; v[3] = mi + ui;
+                        v[4] = mr - ur; v[5] = mi - ui;
+                        return;
+                    }
+                    case 4: {
+                        double t0r = v[0] + v[4], t0i = v[1] + v[5];
+                        double t1r = v[0] - v[4], t1i = v[1] - v[5];
+                        double t2r = v[2] + v[6], t2i = v[3] + v[7];
+                        // (x1 - x3) * (s * i)
+                        double t3r = -(v[3] - v[7]) * s, t3i = (v[2] - v[6]) * s;
+                        v[0] = t0r + t2r; v[1] = t0i + t2i;
+                        v[2] = t1r + t3r; v[3] = t1i + t3i;
+                        v[4] = t0r - t2r; v[5] = t0i - t2i;
+                        v[6] = t1r - t3r; v[7] = t1i - t3i;
+                        return;
+                    }
+                    case 5: {
+                        const double c1 = 0.30901699437494742410, c2 = -0.80901699437494742410;
+                        const double s1 = 0.95105651629515357212 * s, s2 = 0.58778525229247312917 * s;
+                        double ar = v[0], ai = v[1];
+                        double b1r = v[2] + v[8], b1i = v[3] + v[9], d1r = v[2] - v[8], d1i = v[3] - v[9];
+                        double b2r = v[4] + v[6], b2i = v[5] + v[7], d2r = v[4] - v[6], d2i = v[5] - v[7];
+                        double m1r = ar + c1 * b1r + c2 * b2r, m1i = ai + c1 * b1i + c2 * b2i;
+                        double m2r = ar + c2 * b1r + c1 * b2r, m2i = ai + c2 * b1i + c1 * b2i;
+                        // i * (s1 * d1 + s2 * d2) and i * (s2 * d1 - s1 * d2)
+                        double n1r = -(s1 * d1i + s2 * d2i), n1i = s1 * d1r + s2 * d2r;
+                        double n2r = -(s2 * d1i - s1 * d2i), n2i = s2 * d1r - s1 * d2r;
+                        v[0] = ar + b1r + b2r; v[1] = ai + b1i + b2i;
+                        v[2] = m1r + n1r; v[3] = m1i + n1i;
+                        v[8] = m1r - n1r; v[9] = m1i - n1i;
+                        v[4] = m2r + n2r; v[5] = m2i + n2i;
+                        v[6] = m2r - n2r; v[7] = m2i - n2i;
+                        return;
+                    }
+                    }
+
+                    long long stride = n / r;
+                    for (int k = 0; k < r; ++k) {
+                        double sr = 0, si = 0;
+                        for (int j = 0; j < r; ++j) {
+                            double wr, wi;
+                            Twiddle((long long)j * k % r * stride, inverse, wr, wi);
+                            sr += v[2 * j] * wr - v[2 * j + 1] * wi;
+                            si += v[2 * j] * wi + v[2 * j + 1] * wr;
+                        }
+                        scratch[2 * k] = sr;
+                        scratch[2 * k + 1] = si;
+                    }
+                    memcpy(v, scratch, sizeof(double) * 2 * r);
+                }
+
+                /// <summary>
+                /// One Stockham autosort pass: combines r sub-transforms of length
+                /// ns from src into transforms of length ns * r in dst
+                /// </summary>
+                void Pass(const double* src, double* dst, int r, int ns, bool inverse, double* v, double* scratch) const {
+                    int m = n / r;
+                    long long step = n / ((long long)ns * r);
+                    for (int j = 0; j < m; ++j) {
+                        int k = j % ns;
+                        for (int q = 0; q < r; ++q) {
+                            double xr = src[2 * (j + (long long)q * m)], xi = src[2 * (j + (long long)q * m) + 1];
+                            if (k == 0 || q == 0) {
+                                v[2 * q] = xr;
+                                v[2 * q + 1] = xi;
+                            }
+                            else {
+                                double wr, wi;
+                                Twiddle((long long)k * q * step, inverse, wr, wi);
+                                v[2 * q] = xr * wr - xi * wi;
+                                v[2 * q + 1] = xr * wi + xi * wr;
+                            }
+                        }
+                        Butterfly(v, r, inverse, scratch);
+                        long long base = (long long)(j / ns) * ns * r + k;
+                        for (int q = 0; q < r; ++q) {
+                            dst[2 * (base + (long long)q * ns)] = v[2 * q];
+                            dst[2 * (base + (long long)q * ns) + 1] = v[2 * q + 1];
+                        }
+                    }
+                }
+
+            public:
+                explicit FftPlan(int length) : n(length), twiddles(2 * (size_t)(length > 0 ? length : 0)) {
+                    const double pi = 3.14159265358979323846;
+                    for (int k = 0; k < n; ++k) {
+                        double angle = -2 * pi * k / n;
+                        twiddles[2 * k] = std::cos(angle);
+                        twiddles[2 * k + 1] = std::sin(angle);
+                    }
+
+                    // Largest radices first: fewer passes over memory
+                    int rest = n;
+                    while (rest > 1 && rest % 4 == 0) { radices.push_back(4); rest /= 4; }
+                    while (rest > 1 && rest % 2 == 0) { radices.push_back(2); rest /= 2; }
+                    for (int p = 3; rest > 1; p += 2) {
+                        if ((long long)p * p > rest)
+                            p = rest;
+                        while (rest % p == 0) { radices.push_back(p); rest /= p; }
+                    }
+                }
+
+                int Length() const { return n; }
+
+                /// <summary>
+                /// Gets the number of doubles a workspace for Execute needs: a
+                /// ping-pong buffer, a copy of the input for in-place calls and
+                /// room for one butterfly
+                /// </summary>
+                std::size_t WorkLength() const {
+                    return n > 1 ? 4 * (std::size_t)n + 4 * (std::size_t)LargestRadix() : 0;
+                }
+
+                /// <summary>
+                /// Gets the largest prime factor, which bounds the per-element cost
+                /// </summary>
+                int LargestRadix() const {
+                    int r = 1;
+                    for (size_t i = 0; i < radices.size(); ++i)
+                        r = radices[i] > r ? radices[i] : r;
+                    return r;
+                }
+
+                /// <summary>
+                /// Transforms n interleaved values from in to out. The inverse is
+                /// unscaled; multiply by 1/n to undo a forward transform. in and
+                /// out may be the same buffer. Uses the plan's own work buffer.
+                /// </summary>
+                void Execute(const double* in, double* out, bool inverse) {
+                    // Sized on first use, so plans nested in a RealFftPlan never allocate it
+                    if (work.size() < WorkLength())
+                        work.resize(WorkLength());
+                    Execute(in, out, inverse, work.empty() ? 0 : &work[0]);
+                }
+
+                /// <summary>
+                /// Transforms n interleaved values from in to out using a
+                /// caller-owned workspace of WorkLength doubles
+                /// </summary>
+                void Execute(const double* in, double* out, bool inverse, double* workspace) const {
+                    if (n <= 1) {
+                        if (n == 1 && in != out)
+                            memcpy(out, in, 2 * sizeof(double));
+                        return;
+                    }
+
+                    int r = LargestRadix();
+                    double* temp = workspace;
+                    double* v = workspace + 4 * (size_t)n;
+                    double* scratch = v + 2 * r;
+                    if (in == out) {
+                        memcpy(temp + 2 * (size_t)n, in, 2 * sizeof(double) * n);
+                        in = temp + 2 * (size_t)n;
+                    }
+
+                    // Ping-pong so that the last pass lands in out
+                    int passes = (int)radices.size();
+                    const double* src = in;
+                    int ns = 1;
+                    for (int p = 0; p < passes; ++p) {
+                        double* dst = (passes - 1 - p) % 2 == 0 ? out : temp;
+                        Pass(src, dst, radices[p], ns, inverse, v, scratch);
+                        ns *= radices[p];
+                        src = dst;
+                    }
+                }
+            };
+
+            /// <summary>
+            /// FFT of n real samples (n even) through a complex FFT of length
+            /// n / 2, producing the n / 2 + 1 non-redundant bins. Odd lengths go
+            /// through a full complex FFT. Keeps a work buffer as FftPlan does.
+            /// </summary>
+            class RealFftPlan {
+            private:
+                int n;
+                FftPlan half;
+                FftPlan full;
+                std::vector<double> twiddles;
+                std::vector<double> work;
+
+                RealFftPlan(const RealFftPlan&);
+                RealFftPlan& operator=(const RealFftPlan&);
+
+            public:
+                explicit RealFftPlan(int length)
+                    : n(length), half(length % 2 == 0 ? length / 2 : 0), full(length % 2 == 0 ? 0 : length),
+                      twiddles(length > 0 ? (size_t)length : 0) {
+                    const double pi = 3.14159265358979323846;
+                    for (int k = 0; k < n / 2; ++k) {
+                        double angle = -2 * pi * k / n;
+                        twiddles[2 * k] = std::cos(angle);
+                        twiddles[2 * k + 1] = std::sin(angle);
+                    }
+                }
+
+                int Length() const { return n; }
+
+                /// <summary>
+                /// Gets the number of doubles a workspace for Forward and Inverse
+                /// needs: the complex signal and the inner plan's workspace
+                /// </summary>
+                std::size_t WorkLength() const {
+                    if (n == 0)
+                        return 0;
+                    return n % 2 != 0 ? 4 * (std::size_t)n + full.WorkLength() : (std::size_t)n + half.WorkLength();
+                }
+
+                /// <summary>
+                /// Transforms n real samples into n / 2 + 1 interleaved bins.
+                /// Uses the plan's own work buffer.
+                /// </summary>
+                void Forward(const double* in, double* out) {
+                    if (work.size() < WorkLength())
+                        work.resize(WorkLength());
+                    Forward(in, out, work.empty() ? 0 : &work[0]);
+                }
+
+                /// <summary>
+                /// Forward transform using a caller-owned workspace of
+                /// WorkLength doubles
+                /// </summary>
+                void Forward(const double* in, double* out, double* workspace) const {
+                    if (n == 0)
+                        return;
+                    if (n % 2 != 0) {
+                        double* z = workspace;
+                        for (int i = 0; i < n; ++i) {
+                            z[2 * i] = in[i];
+                            z[2 * i + 1] = 0;
+                        }
+                        full.Execute(z, z + 2 * (size_t)n, false, z + 4 * (size_t)n);
+                        memcpy(out, z + 2 * (size_t)n, sizeof(double) * 2 * (n / 2 + 1));
+                        return;
+                    }
+
+                    // Even samples as real parts, odd samples as imaginary parts
+                    int h = n / 2;
+                    double* z = workspace;
+                    half.Execute(in, z, false, z + 2 * (size_t)h);
+
+                    for (int k = 0; k <= h; ++k) {
+                        int a = k % h, b = (h - k) % h;
+                        double zr = z[2 * a], zi = z[2 * a + 1];
+                        double cr = z[2 * b], ci = -z[2 * b + 1];
+                        double er = 0.5 * (zr + cr), ei = 0.5 * (zi + ci);
+                        // (z - conj(z')) / 2i
+                        double or_ = 0.5 * (zi - ci), oi = -0.5 * (zr - cr);
+                        double wr = k < h ? twiddles[2 * k] : -1, wi = k < h ? twiddles[2 * k + 1] : 0;
+                        out[2 * k] = er + or_ * wr - oi * wi;
+                        out[2 * k + 1] = ei + or_ * wi + oi * wr;
+                    }
+                }
+
+                /// <summary>
+                /// Reconstructs n real samples from n / 2 + 1 interleaved bins.
+                /// Unscaled: the result is n times the original signal. Uses the
+                /// plan's own work buffer.
+                /// </summary>
+                void Inverse(const double* in, double* out) {
+                    if (work.size() < WorkLength())
+                        work.resize(WorkLength());
+                    Inverse(in, out, work.empty() ? 0 : &work[0]);
+                }
+
+                /// <summary>
+                /// Inverse transform using a caller-owned workspace of
+                /// WorkLength doubles
+                /// </summary>
+                void Inverse(const double* in, double* out, double* workspace) const {
+                    if (n == 0)
+                        return;
+                    if (n % 2 != 0) {
+                        // Rebuild the Hermitian spectrum, then a full inverse
+                        double* z = workspace;
+                        for (int k = 0; k < n; ++k) {
+                            int src = k <= n / 2 ? k : n - k;
+                            z[2 * k] = in[2 * src];
+                            z[2 * k + 1] = k <= n / 2 ? in[2 * src + 1] : -in[2 * src + 1];
+                        }
+                        full.Execute(z, z + 2 * (size_t)n, true, z + 4 * (size_t)n);
+                        for (int i = 0; i < n; ++i)
+                            out[i] = z[2 * (n + i)];
+                        return;
+                    }
+
+                    int h = n / 2;
+                    double* z = workspace;
+                    for (int k = 0; k < h; ++k) {
+                        double xr = in[2 * k], xi = in[2 * k + 1];
+                        double cr = in[2 * (h - k)], ci = -in[2 * (h - k) + 1];
+                        double er = xr + cr, ei = xi + ci;
+                        // (x - conj(x')) * conj(w)
+                        double dr = xr - cr, di = xi - ci;
+                        double wr = twiddles[2 * k], wi = -twiddles[2 * k + 1];
+                        double or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+                        // z = e + i * o
+                        z[2 * k] = er - oi;
+                        z[2 * k + 1] = ei + or_;
+                    }
+                    half.Execute(z, out, true, z + 2 * (size_t)h);
+                }
+            };
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
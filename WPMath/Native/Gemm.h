@@ -0,0 +1,344 @@
+#pragma once
+
+#include "Simd.h"
+#include "TileScheduler.h"
+
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Register and cache blocking parameters for the GEMM kernel.
+            /// MR x NR is the register tile; KC x NR panels of B stay in L1,
+            /// MC x KC blocks of A stay in L2, KC x NC blocks of B in L3.
+            /// </summary>
+            template<typename T>
+            struct GemmBlocking {
+                static const int VectorsPerRow = Simd<T>::Width >= 2 ? 2 : 4;
+                static const int MR = 4;
+                static const int NR = VectorsPerRow * Simd<T>::Width;
+                static const int KC = 256;
+                static const int MC = sizeof(T) == 4 ? 128 : 96;
+                static const int NC = sizeof(T) == 4 ? 4096 : 2048;
+            };
+
+            /// <summary>
+            /// Describes a read-only strided 2D operand: element (i, j) lives at
+            /// Data[i * RowStride + j * ColStride]. A transposed operand is the
+            /// same memory with the two strides swapped.
+            /// </summary>
+            template<typename T>
+            struct ConstMatrixRef {
+                const T* Data;
+                int Rows;
+                int Cols;
+                long long RowStride;
+                long long ColStride;
+
+                WP_MATH_FORCEINLINE const T& At(int i, int j) const {
+                    return Data[i * RowStride + j * ColStride];
+                }
+            };
+
+            /// <summary>
+            /// Wraps a contiguous row-major buffer
+            /// </summary>
+            template<typename T>
+            inline ConstMatrixRef<T> RowMajor(const T* data, int rows, int cols) {
+                ConstMatrixRef<T> ref = { data, rows, cols, cols, 1 };
+                return ref;
+            }
+
+            namespace Detail {
+                /// <summary>
+                /// Packs an mc x kc block of A into MR-row micro-panels laid out
+                /// k-major, zero padding the last panel.
+                /// </summary>
+                template<typename T>
+                void PackA(const ConstMatrixRef<T>& a, int i0, int p0, int mc, int kc, T* WP_MATH_RESTRICT dst) {
+                    const int MR = GemmBlocking<T>::MR;
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int mr = mc - ir < MR ? mc - ir : MR;
+                        const T* src = a.Data + (i0 + ir) * a.RowStride + p0 * a.ColStride;
+                        for (int p = 0; p < kc; ++p) {
+                            const T* col = src + p * a.ColStride;
+                            int r = 0;
+                            for (; r < mr; ++r)
+                                dst[r] = col[r * a.RowStride];
+                            for (; r < MR; ++r)
+                                dst[r] = T();
+                            dst += MR;
+                        }
+                    }
+                }
+
+                /// <summary>
+                /// Packs a kc x nc block of B into NR-column micro-panels laid out
+                /// k-major, zero padding the last panel.
+                /// </summary>
+                template<typename T>
+                void PackB(const ConstMatrixRef<T>& b, int p0, int j0, int kc, int nc, T* WP_MATH_RESTRICT dst) {
+                    const int NR = GemmBlocking<T>::NR;
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        int nr = nc - jr < NR ? nc - jr : NR;
+                        const T* src = b.Data + p0 * b.RowStride + (j0 + jr) * b.ColStride;
+                        if (b.ColStride == 1 && nr == NR) {
+                            for (int p = 0; p < kc; ++p) {
+                                const T* row = src + p * b.RowStride;
+                                for (int c = 0; c < NR; ++c)
+                                    dst[c] = row[c];
+                                dst += NR;
+                            }
+                        }
+                        else {
+                            for (int p = 0; p < kc; ++p) {
+                                const T* row = src + p * b.RowStride;
+                                int c = 0;
+                                for (; c < nr; ++c)
+                                    dst[c] = row[c * b.ColStride];
+                                for (; c < NR; ++c)
+                                    dst[c] = T();
+                                dst += NR;
+                            }
+                        }
+                    }
+                }
+
+                /// <summary>
+                /// Computes an MR x NR tile of C from packed panels. When
+                /// accumulate is set the tile is added to C, otherwise it
+                /// overwrites it. Partial edge tiles go through a stack buffer.
+                /// </summary>
+                template<typename T>
+                void MicroKernel(int kc, const T* WP_MATH_RESTRICT a, const T* WP_MATH_RESTRICT b,
+                                 T* c, long long ldc, int mr, int nr, bool accumulate) {
+                    typedef Simd<T> S;
+                    typedef typename S::Vec V;
+                    const int MR = GemmBlocking<T>::MR;
+                    const int NV = GemmBlocking<T>::VectorsPerRow;
+                    const int NR = GemmBlocking<T>::NR;
+                    const int W = S::Width;
+
+                    V acc[MR][NV];
+                    for (int r = 0; r < MR; ++r)
+                        for (int v = 0; v < NV; ++v)
+                            acc[r][v] = S::Zero();
+
+                    for (int p = 0; p < kc; ++p) {
+                        V bv[NV];
+                        for (int v = 0; v < NV; ++v)
+                            bv[v] = S::Load(b + v * W);
+                        for (int r = 0; r < MR; ++r) {
+                            V av = S::Broadcast(a[r]);
+                            for (int v = 0; v < NV; ++v)
+                                acc[r][v] = S::MulAdd(av, bv[v], acc[r][v]);
+                        }
+                        a += MR;
+                        b += NR;
+                    }
+
+                    if (mr == MR && nr == NR) {
+                        for (int r = 0; r < MR; ++r) {
+                            T* row = c + r * ldc;
+                            for (int v = 0; v < NV; ++v) {
+                                V x = acc[r][v];
+                                if (accumulate)
+                                    x = S::Add(x, S::Load(row + v * W));
+                                S::Store(row + v * W, x);
+                            }
+                        }
+                        return;
+                    }
+
+                    T tile[MR * NR];
+                    for (int r = 0; r < MR; ++r)
+                        for (int v = 0; v < NV; ++v)
+                            S::Store(tile + r * NR + v * W, acc[r][v]);
+                    for (int r = 0; r < mr; ++r) {
+                        T* row = c + r * ldc;
+                        for (int j = 0; j < nr; ++j)
+                            row[j] = accumulate ? row[j] + tile[r * NR + j] : tile[r * NR + j];
+                    }
+                }
+
+                /// <summary>
+                /// Direct i-k-j product for operands too small to amortize packing
+                /// </summary>
+                template<typename T>
+                void GemmSmall(const ConstMatrixRef<T>& a, const ConstMatrixRef<T>& b, T* c, long long ldc,
+                               int i0, int i1) {
+                    int n = b.Cols;
+                    int k = a.Cols;
+                    for (int i = i0; i < i1; ++i) {
+                        T* row = c + i * ldc;
+                        for (int j = 0; j < n; ++j)
+                            row[j] = T();
+                        for (int p = 0; p < k; ++p) {
+                            T aip = a.At(i, p);
+                            const T* brow = b.Data + p * b.RowStride;
+                            for (int j = 0; j < n; ++j)
+                                row[j] += aip * brow[j * b.ColStride];
+                        }
+                    }
+                }
+
+                /// <summary>
+                /// Blocked product restricted to rows [i0, i1) and columns
+                /// [j0, j1) of C. Packing buffers are supplied by the caller.
+                /// </summary>
+                template<typename T>
+                void GemmBlock(const ConstMatrixRef<T>& a, const ConstMatrixRef<T>& b, T* c, long long ldc,
+                               int i0, int i1, int j0, int j1, T* packA, T* packB) {
+                    typedef GemmBlocking<T> B;
+                    int k = a.Cols;
+
+                    for (int jc = j0; jc < j1; jc += B::NC) {
+                        int nc = j1 - jc < B::NC ? j1 - jc : B::NC;
+                        for (int pc = 0; pc < k; pc += B::KC) {
+                            int kc = k - pc < B::KC ? k - pc : B::KC;
+                            PackB(b, pc, jc, kc, nc, packB);
+                            for (int ic = i0; ic < i1; ic += B::MC) {
+                                int mc = i1 - ic < B::MC ? i1 - ic : B::MC;
+                                PackA(a, ic, pc, mc, kc, packA);
+                                for (int jr = 0; jr < nc; jr += B::NR) {
+                                    int nr = nc - jr < B::NR ? nc - jr : B::NR;
+                                    const T* bp = packB + (long long)(jr / B::NR) * kc * B::NR;
+                                    for (int ir = 0; ir < mc; ir += B::MR) {
+                                        int mr = mc - ir < B::MR ? mc - ir : B::MR;
+                                        const T* ap = packA + (long long)(ir / B::MR) * kc * B::MR;
+                                        MicroKernel(kc, ap, bp, c + (ic + ir) * ldc + jc + jr, ldc, mr, nr, pc > 0);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+
+                inline int RoundUp(int x, int m) {
+                    return (x + m - 1) / m * m;
+                }
+            }
+
+            /// <summary>
+            /// Operand volume (m * n * k) below which packing is skipped
+            /// </summary>
+            const long long GemmSmallVolume = 32LL * 32 * 32;
+
+            /// <summary>
+            /// Computes C = A * B where C is a row-major buffer with row stride ldc.
+            /// A and B may be arbitrarily strided (including transposed views).
+            /// </summary>
+            template<typename T>
+            void Gemm(const ConstMatrixRef<T>& a, const ConstMatrixRef<T>& b, T* c, long long ldc) {
+                typedef GemmBlocking<T> B;
+                int m = a.Rows, n = b.Cols, k = a.Cols;
+                if (m == 0 || n == 0)
+                    return;
+                if (k == 0 || (long long)m * n * k <= GemmSmallVolume) {
+                    Detail::GemmSmall(a, b, c, ldc, 0, m);
+                    return;
+                }
+
+                int mc = m < B::MC ? Detail::RoundUp(m, B::MR) : B::MC;
+                int nc = n < B::NC ? Detail::RoundUp(n, B::NR) : B::NC;
+                int kc = k < B::KC ? k : B::KC;
+                AlignedBuffer<T> packA((std::size_t)mc * kc);
+                AlignedBuffer<T> packB((std::size_t)nc * kc);
+                Detail::GemmBlock(a, b, c, ldc, 0, m, 0, n, packA.Data(), packB.Data());
+            }
+
+            namespace Detail {
+                template<typename T>
+                struct GemmTiles {
+                    ConstMatrixRef<T> A;
+                    ConstMatrixRef<T> B;
+                    T* C;
+                    long long Ldc;
+                    int TileRows;
+                    int TileCols;
+                    int ColumnTiles;
+                    int PackACount;
+                    int PackBCount;
+                    std::vector<T*> Scratch;
+
+                    ~GemmTiles() {
+                        for (std::size_t i = 0; i < Scratch.size(); ++i)
+                            if (Scratch[i])
+                                AlignedFree(Scratch[i]);
+                    }
+
+                    static void Run(void* context, int tile, int worker) {
+                        GemmTiles& t = *static_cast<GemmTiles*>(context);
+                        // Each slot is only ever used by one thread, so lazy allocation is race-free.
+                        T*& scratch = t.Scratch[worker];
+                        if (!scratch)
+                            scratch = static_cast<T*>(AlignedAlloc(((std::size_t)t.PackACount + t.PackBCount) * sizeof(T)));
+
+                        int i0 = (tile / t.ColumnTiles) * t.TileRows;
+                        int j0 = (tile % t.ColumnTiles) * t.TileCols;
+                        int i1 = i0 + t.TileRows < t.A.Rows ? i0 + t.TileRows : t.A.Rows;
+                        int j1 = j0 + t.TileCols < t.B.Cols ? j0 + t.TileCols : t.B.Cols;
+                        GemmBlock(t.A, t.B, t.C, t.Ldc, i0, i1, j0, j1, scratch, scratch + t.PackACount);
+                    }
+                };
+            }
+
+            /// <summary>
+            /// Computes C = A * B by splitting C into MC-row tiles distributed over
+            /// the work-stealing pool. Each participant packs into its own buffers.
+            /// </summary>
+            template<typename T>
+            void GemmParallel(const ConstMatrixRef<T>& a, const ConstMatrixRef<T>& b, T* c, long long ldc,
+                              int degreeOfParallelism) {
+                typedef GemmBlocking<T> B;
+                int m = a.Rows, n = b.Cols, k = a.Cols;
+                if (m == 0 || n == 0)
+                    return;
+
+                int rowTiles = (m + B::MC - 1) / B::MC;
+                int tileCols = Detail::RoundUp(n < B::NC / 4 ? n : B::NC / 4, B::NR);
+                int participants = EffectiveParallelism(rowTiles * ((n + tileCols - 1) / tileCols), degreeOfParallelism);
+                // Narrow the column tiles until there is enough slack for stealing.
+                while (tileCols > 4 * B::NR && rowTiles * ((n + tileCols - 1) / tileCols) < 4 * participants)
+                    tileCols = Detail::RoundUp(tileCols / 2, B::NR);
+                int tileCount = rowTiles * ((n + tileCols - 1) / tileCols);
+                participants = EffectiveParallelism(tileCount, degreeOfParallelism);
+
+                if (participants == 1 || k == 0 || (long long)m * n * k <= GemmSmallVolume) {
+                    Gemm(a, b, c, ldc);
+                    return;
+                }
+
+                Detail::GemmTiles<T> tiles;
+                tiles.A = a;
+                tiles.B = b;
+                tiles.C = c;
+                tiles.Ldc = ldc;
+                tiles.TileRows = B::MC;
+                tiles.TileCols = tileCols;
+                tiles.ColumnTiles = (n + tileCols - 1) / tileCols;
+                tiles.PackACount = B::MC * (k < B::KC ? k : B::KC);
+                tiles.PackBCount = tileCols * (k < B::KC ? k : B::KC);
+                tiles.Scratch.assign(participants, (T*)nullptr);
+                ParallelForTiles(tileCount, participants, &Detail::GemmTiles<T>::Run, &tiles);
+            }
+
+            /// <summary>
+            /// Computes C = A * B for contiguous row-major operands
+            /// </summary>
+            template<typename T>
+            void Gemm(int m, int n, int k, const T* a, const T* b, T* c) {
+                Gemm(RowMajor(a, m, k), RowMajor(b, k, n), c, n);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
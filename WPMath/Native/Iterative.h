@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Simd.h"
+
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            // Level-1 kernels and incomplete factorizations used by the Krylov
+            // solvers. Everything is double precision: the solvers accumulate
+            // long recurrences where float round-off stalls convergence.
+
+            /// <summary>
+            /// Returns x . y
+            /// </summary>
+            inline double KrylovDot(const double* x, const double* y, int n) {
+                typedef Simd<double> V;
+                V::Vec s0 = V::Zero(), s1 = V::Zero();
+                int i = 0;
+                for (; i + 2 * V::Width <= n; i += 2 * V::Width) {
+                    s0 = V::MulAdd(V::Load(x + i), V::Load(y + i), s0);
+                    s1 = V::MulAdd(V::Load(x + i + V::Width), V::Load(y + i + V::Width), s1);
+                }
+                double s = V::Sum(V::Add(s0, s1));
+                for (; i < n; ++i)
+                    s += x[i] * y[i];
+                return s;
+            }
+
+            /// <summary>
+            /// y += alpha * x
+            /// </summary>
+            inline void KrylovAxpy(double alpha, const double* x, double* y, int n) {
+                typedef Simd<double> V;
+                V::Vec a = V::Broadcast(alpha);
+                int i = 0;
+                for (; i + V::Width <= n; i += V::Width)
+                    V::Store(y + i, V::MulAdd(a, V::Load(x + i), V::Load(y + i)));
+                for (; i < n; ++i)
+                    y[i] += alpha * x[i];
+            }
+
+            /// <summary>
+            /// y = x + beta * y
+            /// </summary>
+            inline void KrylovXpay(const double* x, double beta, double* y, int n) {
+                typedef Simd<double> V;
+                V::Vec b = V::Broadcast(beta);
+                int i = 0;
+                for (; i + V::Width <= n; i += V::Width)
+                    V::Store(y + i, V::MulAdd(b, V::Load(y + i), V::Load(x + i)));
+                for (; i < n; ++i)
+                    y[i] = x[i] + beta * y[i];
+            }
+
+            /// <summary>
+            /// z = x + alpha * y, where z may alias x or y
+            /// </summary>
+            inline void KrylovCombine(const double* x, double alpha, const double* y, double* z, int n) {
+                typedef Simd<double> V;
+                V::Vec a = V::Broadcast(alpha);
+                int i = 0;
+                for (; i + V::Width <= n; i += V::Width)
+                    V::Store(z + i, V::MulAdd(a, V::Load(y + i), V::Load(x + i)));
+                for (; i < n; ++i)
+                    z[i] = x[i] + alpha * y[i];
+            }
+
+            /// <summary>
+            /// z = d * r element by element; the Jacobi preconditioner with d
+            /// holding reciprocal diagonal entries
+            /// </summary>
+            inline void KrylovDiagonalScale(const double* d, const double* r, double* z, int n) {
+                typedef Simd<double> V;
+                int i = 0;
+                for (; i + V::Width <= n; i += V::Width)
+                    V::Store(z + i, V::Mul(V::Load(d + i), V::Load(r + i)));
+                for (; i < n; ++i)
+                    z[i] = d[i] * r[i];
+            }
+
+            /// <summary>
+            /// Factors the n x n CSR matrix in place into L * U restricted to
+            /// its own sparsity pattern (ILU(0)). L has a unit diagonal and
+            /// shares the strictly lower entries; U takes the rest. Column
+            /// indices must be sorted within each row. diagonal[i] receives the
+            /// position of entry (i, i). Returns the first row with a missing or
+            /// zero pivot, or -1 on success.
+            /// </summary>
+            inline int IluFactor(const int* pointers, const int* indices, double* values, int n, int* diagonal) {
+                for (int i = 0; i < n; ++i) {
+                    diagonal[i] = -1;
+                    for (int k = pointers[i]; k < pointers[i + 1]; ++k) {
+                        if (indices[k] == i) {
+                            diagonal[i] = k;
+                            break;
+                        }
+                    }
+                    if (diagonal[i] < 0)
+                        return i;
+                }
+
+                // position[j] is the slot of column j in the current row, or -1
+                std::vector<int> position(n, -1);
+                for (int i = 0; i < n; ++i) {
+                    int begin = pointers[i], end = pointers[i + 1];
+                    for (int k = begin; k < end; ++k)
+                        position[indices[k]] = k;
+
+                    for (int k = begin; k < end && indices[k] < i; ++k) {
+                        int row = indices[k];
+                        double factor = values[k] / values[diagonal[row]];
+                        values[k] = factor;
+                        for (int q = diagonal[row] + 1; q < pointers[row + 1]; ++q) {
+                            int slot = position[indices[q]];
+                            if (slot >= 0)
+                                values[slot] -= factor * values[q];
+                        }
+                    }
+
+                    for (int k = begin; k < end; ++k)
+                        position[indices[k]] = -1;
+                    if (values[diagonal[i]] == 0)
+                        return i;
+                }
+                return -1;
+            }
+
+            /// <summary>
+            /// Solves (L * U) z = r with the factors from IluFactor: a unit
+            /// lower forward sweep followed by an upper backward sweep. z may
+            /// alias r.
+            /// </summary>
+            inline void IluSolve(const int* pointers, const int* indices, const double* values, const int* diagonal,
+                                 int n, const double* r, double* z) {
+                for (int i = 0; i < n; ++i) {
+                    double s = r[i];
+                    for (int k = pointers[i]; k < diagonal[i]; ++k)
+                        s -= values[k] * z[indices[k]];
+                    z[i] = s;
+                }
+                for (int i = n - 1; i >= 0; --i) {
+                    double s = z[i];
+                    for (int k = diagonal[i] + 1; k < pointers[i + 1]; ++k)
+                        s -= values[k] * z[indices[k]];
+                    z[i] = s / values[diagonal[i]];
+                }
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "Simd.h"
+#include "TileScheduler.h"
+
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Count, mean, central moment sums M2..M4 and extremes of a sample.
+            /// Two summaries merge exactly (Chan et al., Pébay), so a sample can
+            /// be reduced in any grouping and order.
+            /// </summary>
+            struct Moments {
+                long long Count;
+                double Mean;
+                double M2;
+                double M3;
+                double M4;
+                double Min;
+                double Max;
+            };
+
+            inline void ClearMoments(Moments& m) {
+                m.Count = 0;
+                m.Mean = m.M2 = m.M3 = m.M4 = 0;
+                m.Min = m.Max = 0;
+            }
+
+            /// <summary>
+            /// Adds one value (Welford's update extended to the third and
+            /// fourth moments)
+            /// </summary>
+            inline void PushMoment(Moments& m, double x) {
+                long long n1 = m.Count;
+                long long n = ++m.Count;
+                if (n1 == 0) {
+                    m.Mean = x;
+                    m.M2 = m.M3 = m.M4 = 0;
+                    m.Min = m.Max = x;
+                    return;
+                }
+
+                double delta = x - m.Mean;
+                double dn = delta / (double)n;
+                double dn2 = dn * dn;
+                double term = delta * dn * (double)n1;
+                m.Mean += dn;
+                m.M4 += term * dn2 * ((double)n * n - 3.0 * n + 3) + 6 * dn2 * m.M2 - 4 * dn * m.M3;
+                m.M3 += term * dn * (double)(n - 2) - 3 * dn * m.M2;
+                m.M2 += term;
+                if (x < m.Min)
+                    m.Min = x;
+                if (x > m.Max)
+                    m.Max = x;
+            }
+
+            /// <summary>
+            /// Folds b into a
+            /// </summary>
+            inline void MergeMoments(Moments& a, const Moments& b) {
+                if (b.Count == 0)
+                    return;
+                if (a.Count == 0) {
+                    a = b;
+                    return;
+                }
+
+                double na = (double)a.Count, nb = (double)b.Count, n = na + nb;
+                double delta = b.Mean - a.Mean;
+                double dn = delta / n;
+                double dn2 = dn * dn;
+
+                double m4 = a.M4 + b.M4 + delta * dn * dn2 * na * nb * (na * na - na * nb + nb * nb) +
+                            6 * dn2 * (na * na * b.M2 + nb * nb * a.M2) + 4 * dn * (na * b.M3 - nb * a.M3);
+                double m3 = a.M3 + b.M3 + delta * dn2 * na * nb * (na - nb) + 3 * dn * (na * b.M2 - nb * a.M2);
+                double m2 = a.M2 + b.M2 + delta * dn * na * nb;
+
+                a.Count += b.Count;
+                a.Mean += dn * nb;
+                a.M2 = m2;
+                a.M3 = m3;
+                a.M4 = m4;
+                if (b.Min < a.Min)
+                    a.Min = b.Min;
+                if (b.Max > a.Max)
+                    a.Max = b.Max;
+            }
+
+            /// <summary>
+            /// Elements per block of AccumulateMoments: small enough to stay in
+            /// L1 for the second pass, large enough to amortize the merge
+            /// </summary>
+            const int MomentBlock = 1024;
+
+            namespace Detail {
+                /// <summary>
+                /// Two-pass moments of one block: a SIMD sum for the mean, then
+                /// centered power sums accumulated in double
+                /// </summary>
+                template<typename T>
+                void BlockMoments(const T* x, int n, Moments& m) {
+                    typedef Simd<T> V;
+                    typename V::Vec sum = V::Zero();
+                    typename V::Vec lo = V::Broadcast(x[0]), hi = lo;
+                    int i = 0;
+                    for (; i + V::Width <= n; i += V::Width) {
+                        typename V::Vec v = V::Load(x + i);
+                        sum = V::Add(sum, v);
+                        lo = V::Min(lo, v);
+                        hi = V::Max(hi, v);
+                    }
+
+                    double s = V::Sum(sum);
+                    T mn = x[0], mx = x[0];
+                    T lanesLo[V::Width], lanesHi[V::Width];
+                    V::Store(lanesLo, lo);
+                    V::Store(lanesHi, hi);
+                    for (int k = 0; k < V::Width; ++k) {
+                        mn = lanesLo[k] < mn ? lanesLo[k] : mn;
+                        mx = lanesHi[k] > mx ? lanesHi[k] : mx;
+                    }
+                    for (int k = i; k < n; ++k) {
+                        s += x[k];
+                        mn = x[k] < mn ? x[k] : mn;
+                        mx = x[k] > mx ? x[k] : mx;
+                    }
+                    double mean = s / n;
+
+                    // Centered sums in double regardless of T
+                    double d1 = 0, d2 = 0, d3 = 0, d4 = 0;
+                    for (int k = 0; k < n; ++k) {
+                        double d = (double)x[k] - mean;
+                        double dd = d * d;
+                        d1 += d;
+                        d2 += dd;
+                        d3 += dd * d;
+                        d4 += dd * dd;
+                    }
+
+                    m.Count = n;
+                    // Correct for the rounding of the mean
+                    m.Mean = mean + d1 / n;
+                    m.M2 = d2 - d1 * d1 / n;
+                    m.M3 = d3;
+                    m.M4 = d4;
+                    m.Min = mn;
+                    m.Max = mx;
+                }
+
+                template<typename T>
+                struct MomentTiles {
+                    const T* Data;
+                    long long Count;
+                    long long TileSize;
+                    Moments* Results;
+
+                    static void Run(void* context, int tile, int) {
+                        MomentTiles& t = *static_cast<MomentTiles*>(context);
+                        long long begin = tile * t.TileSize;
+                        long long end = begin + t.TileSize < t.Count ? begin + t.TileSize : t.Count;
+                        Moments& m = t.Results[tile];
+                        ClearMoments(m);
+                        for (long long b = begin; b < end; b += MomentBlock) {
+                            Moments block;
+                            BlockMoments(t.Data + b, (int)(end - b < MomentBlock ? end - b : MomentBlock), block);
+                            MergeMoments(m, block);
+                        }
+                    }
+                };
+            }
+
+            /// <summary>
+            /// Folds count values into m, block by block
+            /// </summary>
+            template<typename T>
+            void AccumulateMoments(const T* x, long long count, Moments& m) {
+                for (long long b = 0; b < count; b += MomentBlock) {
+                    Moments block;
+                    Detail::BlockMoments(x + b, (int)(count - b < MomentBlock ? count - b : MomentBlock), block);
+                    MergeMoments(m, block);
+                }
+            }
+
+            /// <summary>
+            /// AccumulateMoments over the work-stealing pool. Tiles are merged in
+            /// index order, so the result does not depend on scheduling.
+            /// </summary>
+            template<typename T>
+            void AccumulateMomentsParallel(const T* x, long long count, Moments& m, int degreeOfParallelism) {
+                const long long tileSize = 64 * MomentBlock;
+                long long tiles = (count + tileSize - 1) / tileSize;
+                if (tiles <= 1 || tiles > 0x7fffffff) {
+                    AccumulateMoments(x, count, m);
+                    return;
+                }
+
+                std::vector<Moments> results((size_t)tiles);
+                Detail::MomentTiles<T> context = { x, count, tileSize, &results[0] };
+                ParallelForTiles((int)tiles, degreeOfParallelism, &Detail::MomentTiles<T>::Run, &context);
+                for (size_t t = 0; t < results.size(); ++t)
+                    MergeMoments(m, results[t]);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
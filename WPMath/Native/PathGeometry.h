@@ -0,0 +1,808 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// A 2D point; same layout as the managed Vector2
+            /// </summary>
+            struct Point2 {
+                double X;
+                double Y;
+            };
+
+            /// <summary>
+            /// Twice the signed area of triangle (o, a, b): positive when the
+            /// turn o -> a -> b is counter-clockwise in a Y-up frame
+            /// </summary>
+            inline double Orient(const Point2& o, const Point2& a, const Point2& b) {
+                return (a.X - o.X) * (b.Y - o.Y) - (a.Y - o.Y) * (b.X - o.X);
+            }
+
+            /// <summary>
+            /// Twice the signed area of a closed polygon
+            /// </summary>
+            inline double PolygonArea2(const Point2* p, int n) {
+                double sum = 0;
+                for (int i = 0, j = n - 1; i < n; j = i++)
+                    sum += p[j].X * p[i].Y - p[j].Y * p[i].X;
+                return sum;
+            }
+
+            /// <summary>
+            /// Even-odd point-in-polygon test
+            /// </summary>
+            inline bool PolygonContains(const Point2* p, int n, const Point2& q) {
+                bool inside = false;
+                for (int i = 0, j = n - 1; i < n; j = i++) {
+                    if ((p[i].Y > q.Y) != (p[j].Y > q.Y) &&
+                        q.X < p[i].X + (q.Y - p[i].Y) * (p[j].X - p[i].X) / (p[j].Y - p[i].Y))
+                        inside = !inside;
+                }
+                return inside;
+            }
+
+            /// <summary>
+            /// Path commands; each consumes 1, 1, 2, 3 and 0 points
+            /// </summary>
+            enum PathVerb {
+                PathMoveTo,
+                PathLineTo,
+                PathQuadraticTo,
+                PathCubicTo,
+                PathClose
+            };
+
+            /// <summary>
+            /// Upper bound on the segments one curve is split into, so that a
+            /// tiny tolerance or a huge curve cannot run away
+            /// </summary>
+            const int MaxCurveSegments = 1 << 16;
+
+            namespace Detail {
+                /// <summary>
+                /// Writes points up to a capacity while counting all of them, so
+                /// that callers learn the size they need
+                /// </summary>
+                struct PointSink {
+                    Point2* Out;
+                    int Capacity;
+                    int Count;
+
+                    void Add(const Point2& p) {
+                        if (Count < Capacity)
+                            Out[Count] = p;
+                        Count++;
+                    }
+                };
+
+                /// <summary>
+                /// Segment count from Wang's formula: n segments keep a
+                /// polynomial curve within tolerance of its chords when
+                /// n^2 >= factor * |largest second difference| / tolerance
+                /// </summary>
+                inline int CurveSegments(double dx, double dy, double factor, double tolerance) {
+                    double n = std::ceil(std::sqrt(factor * std::sqrt(dx * dx + dy * dy) / tolerance));
+                    if (!(n >= 1))
+                        return 1;
+                    return n > MaxCurveSegments ? MaxCurveSegments : (int)n;
+                }
+
+                inline void FlattenQuadratic(const Point2& p0, const Point2& p1, const Point2& p2, double tolerance, PointSink& sink) {
+                    int n = CurveSegments(p0.X - 2 * p1.X + p2.X, p0.Y - 2 * p1.Y + p2.Y, 0.25, tolerance);
+                    double step = 1.0 / n;
+                    for (int i = 1; i < n; ++i) {
+                        double t = i * step, s = 1 - t;
+                        double a = s * s, b = 2 * s * t, c = t * t;
+                        Point2 p = { a * p0.X + b * p1.X + c * p2.X, a * p0.Y + b * p1.Y + c * p2.Y };
+                        sink.Add(p);
+                    }
+                    sink.Add(p2);
+                }
+
+                inline void FlattenCubic(const Point2& p0, const Point2& p1, const Point2& p2, const Point2& p3, double tolerance, PointSink& sink) {
+                    double ax = p0.X - 2 * p1.X + p2.X, ay = p0.Y - 2 * p1.Y + p2.Y;
+                    double bx = p1.X - 2 * p2.X + p3.X, by = p1.Y - 2 * p2.Y + p3.Y;
+                    bool first = ax * ax + ay * ay > bx * bx + by * by;
+                    int n = CurveSegments(first ? ax : bx, first ? ay : by, 0.75, tolerance);
+                    double step = 1.0 / n;
+                    for (int i = 1; i < n; ++i) {
+                        double t = i * step, s = 1 - t;
+                        double a = s * s * s, b = 3 * s * s * t, c = 3 * s * t * t, d = t * t * t;
+                        Point2 p = {
+                            a * p0.X + b * p1.X + c * p2.X + d * p3.X,
+                            a * p0.Y + b * p1.Y + c * p2.Y + d * p3.Y
+                        };
+                        sink.Add(p);
+                    }
+                    sink.Add(p3);
+                }
+            }
+
+            /// <summary>
+            /// Flattens a quadratic Bezier into chords no further than
+            /// tolerance from the curve. Writes the points after p0, ending
+            /// with p2, up to capacity and returns how many there are.
+            /// </summary>
+            inline int FlattenQuadratic(const Point2& p0, const Point2& p1, const Point2& p2, double tolerance, Point2* out, int capacity) {
+                Detail::PointSink sink = { out, capacity, 0 };
+                Detail::FlattenQuadratic(p0, p1, p2, tolerance, sink);
+                return sink.Count;
+            }
+
+            /// <summary>
+            /// Flattens a cubic Bezier into chords no further than tolerance
+            /// from the curve. Writes the points after p0, ending with p3, up
+            /// to capacity and returns how many there are.
+            /// </summary>
+            inline int FlattenCubic(const Point2& p0, const Point2& p1, const Point2& p2, const Point2& p3, double tolerance, Point2* out, int capacity) {
+                Detail::PointSink sink = { out, capacity, 0 };
+                Detail::FlattenCubic(p0, p1, p2, p3, tolerance, sink);
+                return sink.Count;
+            }
+
+            /// <summary>
+            /// Flattens a path into polylines, one per contour. Writes up to
+            /// capacity points and up to contourCapacity exclusive end indices,
+            /// and returns the total number of points with the total number of
+            /// contours in contourCount; -1 when the verbs need more points
+            /// than given or a segment has no start point. Contours of a single
+            /// point are dropped. After Close, drawing continues from the start
+            /// of the closed contour.
+            /// </summary>
+            inline int FlattenPath(const unsigned char* verbs, int verbCount, const Point2* points, int pointCount,
+                double tolerance, Point2* out, int capacity, int* contourEnds, int contourCapacity, int* contourCount) {
+                Detail::PointSink sink = { out, capacity, 0 };
+                int contours = 0, contourStart = 0, used = 0;
+                bool open = false, started = false;
+                Point2 current = { 0, 0 }, start = { 0, 0 };
+
+                for (int v = 0; v < verbCount; ++v) {
+                    int verb = verbs[v];
+                    if (verb == PathClose || verb == PathMoveTo) {
+                        if (open) {
+                            if (sink.Count - contourStart > 1) {
+                                if (contours < contourCapacity)
+                                    contourEnds[contours] = sink.Count;
+                                contours++;
+                            }
+                            else {
+                                sink.Count = contourStart;
+                            }
+                            open = false;
+                        }
+                        if (verb == PathClose) {
+                            current = start;
+                            continue;
+                        }
+                        if (used + 1 > pointCount)
+                            return -1;
+                        start = current = points[used++];
+                        started = true;
+                        continue;
+                    }
+
+                    int needed = verb == PathLineTo ? 1 : verb == PathQuadraticTo ? 2 : verb == PathCubicTo ? 3 : -1;
+                    if (needed < 0 || !started || used + needed > pointCount)
+                        return -1;
+                    if (!open) {
+                        contourStart = sink.Count;
+                        start = current;
+                        sink.Add(current);
+                        open = true;
+                    }
+
+                    const Point2* p = points + used;
+                    if (verb == PathLineTo)
+                        sink.Add(p[0]);
+                    else if (verb == PathQuadraticTo)
+                        Detail::FlattenQuadratic(current, p[0], p[1], tolerance, sink);
+                    else
+                        Detail::FlattenCubic(current, p[0], p[1], p[2], tolerance, sink);
+                    used += needed;
+                    current = p[needed - 1];
+                }
+
+                if (open) {
+                    if (sink.Count - contourStart > 1) {
+                        if (contours < contourCapacity)
+                            contourEnds[contours] = sink.Count;
+                        contours++;
+                    }
+                    else {
+                        sink.Count = contourStart;
+                    }
+                }
+                *contourCount = contours;
+                return sink.Count;
+            }
+
+            /// <summary>
+            /// Sutherland-Hodgman: clips a polygon against each edge of a
+            /// convex polygon of either winding in turn, ping-ponging between
+            /// out and scratch so the result lands in out. Returns the vertex
+            /// count, or -1 when a stage needs more than capacity vertices;
+            /// n + m always suffices for a convex subject. Concave subjects
+            /// split by the clip come back joined along the clip edges.
+            /// </summary>
+            inline int ClipToConvex(const Point2* subject, int n, const Point2* clip, int m, Point2* out, Point2* scratch, int capacity) {
+                double area = PolygonArea2(clip, m);
+                if (area == 0 || n < 3)
+                    return 0;
+                double sign = area > 0 ? 1 : -1;
+
+                const Point2* src = subject;
+                int count = n;
+                for (int k = 0; k < m && count > 0; ++k) {
+                    Point2* dst = (m - 1 - k) % 2 == 0 ? out : scratch;
+                    const Point2& e0 = clip[k];
+                    const Point2& e1 = clip[k + 1 < m ? k + 1 : 0];
+                    int written = 0;
+                    const Point2* prev = &src[count - 1];
+                    double dPrev = sign * Orient(e0, e1, *prev);
+                    for (int i = 0; i < count; ++i) {
+                        const Point2& cur = src[i];
+                        double dCur = sign * Orient(e0, e1, cur);
+                        if ((dCur >= 0) != (dPrev >= 0)) {
+                            if (written >= capacity)
+                                return -1;
+                            double t = dPrev / (dPrev - dCur);
+                            Point2 p = { prev->X + t * (cur.X - prev->X), prev->Y + t * (cur.Y - prev->Y) };
+                            dst[written++] = p;
+                        }
+                        if (dCur >= 0) {
+                            if (written >= capacity)
+                                return -1;
+                            dst[written++] = cur;
+                        }
+                        prev = &cur;
+                        dPrev = dCur;
+                    }
+                    src = dst;
+                    count = written;
+                }
+                if (count > 0 && src != out)
+                    std::copy(src, src + count, out);
+                return count;
+            }
+
+            /// <summary>
+            /// Triangulates simple polygons into index triples. Monotone
+            /// polygons (including every convex one) take a linear sweep;
+            /// others are ear-clipped, in O(n * r) for r reflex vertices.
+            /// Triangles keep the polygon's winding. Scratch memory is kept
+            /// between calls, so steady-state use does not allocate.
+            /// </summary>
+            class Triangulator {
+            private:
+                std::vector<int> prev;
+                std::vector<int> next;
+                std::vector<int> order;
+                std::vector<int> stack;
+                std::vector<unsigned char> side;
+                std::vector<unsigned char> reflex;
+                const Point2* p;
+                double sign;
+                int* out;
+                int base;
+                int written;
+
+                Triangulator(const Triangulator&);
+                Triangulator& operator=(const Triangulator&);
+
+                /// <summary>
+                /// Sweep order: by Y, then X, then index
+                /// </summary>
+                bool Before(int a, int b) const {
+                    if (p[a].Y != p[b].Y)
+                        return p[a].Y < p[b].Y;
+                    if (p[a].X != p[b].X)
+                        return p[a].X < p[b].X;
+                    return a < b;
+                }
+
+                void Emit(int a, int b, int c) {
+                    if (sign * Orient(p[a], p[b], p[c]) < 0)
+                        std::swap(b, c);
+                    out[written++] = base + a;
+                    out[written++] = base + b;
+                    out[written++] = base + c;
+                }
+
+                bool Convex(int a, int b, int c) const {
+                    return sign * Orient(p[a], p[b], p[c]) > 0;
+                }
+
+                int FindTop(int n, bool& monotone) const {
+                    int top = 0, minima = 0;
+                    for (int i = 0; i < n; ++i) {
+                        int a = i > 0 ? i - 1 : n - 1, c = i + 1 < n ? i + 1 : 0;
+                        if (Before(i, a) && Before(i, c)) {
+                            minima++;
+                            top = i;
+                        }
+                    }
+                    monotone = minima == 1;
+                    return top;
+                }
+
+                /// <summary>
+                /// Stack sweep over a polygon monotone in Y: merge the two
+                /// chains from the top vertex, then cut off every triangle
+                /// that becomes visible
+                /// </summary>
+                void Monotone(int n, int top) {
+                    order.resize(n);
+                    side.resize(n);
+                    int a = top + 1 < n ? top + 1 : 0, b = top > 0 ? top - 1 : n - 1;
+                    order[0] = top;
+                    side[0] = 0;
+                    for (int k = 1; k < n; ++k) {
+                        // The chains meet at the bottom vertex, taken last
+                        if (Before(a, b)) {
+                            order[k] = a;
+                            side[k] = 0;
+                            a = a + 1 < n ? a + 1 : 0;
+                        }
+                        else {
+                            order[k] = b;
+                            side[k] = 1;
+                            b = b > 0 ? b - 1 : n - 1;
+                        }
+                    }
+
+                    stack.clear();
+                    stack.push_back(0);
+                    stack.push_back(1);
+                    for (int k = 2; k < n - 1; ++k) {
+                        if (side[k] != side[stack.back()]) {
+                            for (size_t s = 0; s + 1 < stack.size(); ++s)
+                                Emit(order[k], order[stack[s]], order[stack[s + 1]]);
+                            stack.clear();
+                            stack.push_back(k - 1);
+                            stack.push_back(k);
+                            continue;
+                        }
+
+                        int last = stack.back();
+                        stack.pop_back();
+                        while (!stack.empty()) {
+                            int u = order[k], l = order[last], t = order[stack.back()];
+                            bool visible = side[k] == 0 ? Convex(t, l, u) : Convex(u, l, t);
+                            if (!visible)
+                                break;
+                            Emit(u, l, t);
+                            last = stack.back();
+                            stack.pop_back();
+                        }
+                        stack.push_back(last);
+                        stack.push_back(k);
+                    }
+                    for (size_t s = 0; s + 1 < stack.size(); ++s)
+                        Emit(order[n - 1], order[stack[s]], order[stack[s + 1]]);
+                }
+
+                bool UpdateReflex(int i) {
+                    bool r = !Convex(prev[i], i, next[i]);
+                    reflex[i] = r;
+                    return r;
+                }
+
+                bool IsEar(int b, int reflexCount) const {
+                    int a = prev[b], c = next[b];
+                    if (reflex[b])
+                        return false;
+                    if (reflexCount == 0)
+                        return true;
+                    const Point2& pa = p[a];
+                    const Point2& pb = p[b];
+                    const Point2& pc = p[c];
+                    for (int v = next[c]; v != a; v = next[v]) {
+                        if (!reflex[v])
+                            continue;
+                        const Point2& q = p[v];
+                        if ((q.X == pa.X && q.Y == pa.Y) || (q.X == pc.X && q.Y == pc.Y))
+                            continue;
+                        if (sign * Orient(pa, pb, q) >= 0 && sign * Orient(pb, pc, q) >= 0 && sign * Orient(pc, pa, q) >= 0)
+                            return false;
+                    }
+                    return true;
+                }
+
+                void EarClip(int n) {
+                    prev.resize(n);
+                    next.resize(n);
+                    reflex.resize(n);
+                    for (int i = 0; i < n; ++i) {
+                        prev[i] = i > 0 ? i - 1 : n - 1;
+                        next[i] = i + 1 < n ? i + 1 : 0;
+                    }
+                    int reflexCount = 0;
+                    for (int i = 0; i < n; ++i)
+                        reflexCount += UpdateReflex(i);
+
+                    int remaining = n, i = 0, stall = 0;
+                    while (remaining > 3) {
+                        // Without an ear in a full lap the input is not simple;
+                        // cut anyway so that the output stays complete
+                        bool ear = IsEar(i, reflexCount);
+                        if (!ear && ++stall <= remaining) {
+                            i = next[i];
+                            continue;
+                        }
+
+                        int a = prev[i], c = next[i];
+                        Emit(a, i, c);
+                        reflexCount -= reflex[i];
+                        next[a] = c;
+                        prev[c] = a;
+                        reflexCount -= reflex[a] + reflex[c];
+                        reflexCount += UpdateReflex(a);
+                        reflexCount += UpdateReflex(c);
+                        remaining--;
+                        stall = 0;
+                        i = c;
+                    }
+                    Emit(prev[i], i, next[i]);
+                }
+
+            public:
+                Triangulator() : p(0), sign(1), out(0), base(0), written(0) {}
+
+                /// <summary>
+                /// Writes the 3 * (n - 2) indices of a triangulation of a simple
+                /// polygon, each offset by base, and returns their count
+                /// </summary>
+                int Triangulate(const Point2* points, int n, int* indices, int indexBase) {
+                    if (n < 3)
+                        return 0;
+                    p = points;
+                    out = indices;
+                    base = indexBase;
+                    written = 0;
+                    sign = PolygonArea2(points, n) < 0 ? -1 : 1;
+
+                    bool monotone;
+                    int top = FindTop(n, monotone);
+                    if (monotone)
+                        Monotone(n, top);
+                    else
+                        EarClip(n);
+                    return written;
+                }
+            };
+
+            /// <summary>
+            /// Boolean operations on simple polygons
+            /// </summary>
+            enum ClipOperation {
+                ClipIntersection,
+                ClipUnion,
+                ClipDifference
+            };
+
+            /// <summary>
+            /// Greiner-Hormann boolean operations on two simple polygons. Both
+            /// are taken counter-clockwise (reversed if needed); the result is
+            /// a set of contours with outer contours counter-clockwise and
+            /// holes clockwise. Vertices lying exactly on the other polygon's
+            /// edges are resolved by nudging the subject by about 1e-9 of its
+            /// size. Edge pairs are tested with a bounding-box prefilter, so
+            /// cost is O(n * m) in the worst case. Scratch memory is kept
+            /// between calls.
+            /// </summary>
+            class PolygonClipper {
+            private:
+                struct Node {
+                    Point2 P;
+                    int Next;
+                    int Prev;
+                    int Neighbor;       // matching node on the other polygon, -1 for vertices
+                    bool Entry;
+                    bool Visited;
+                };
+
+                struct Crossing {
+                    int SubjectEdge;
+                    int ClipEdge;
+                    double T;           // position along the subject edge
+                    double U;           // position along the clip edge
+                    Point2 P;
+                };
+
+                struct BySubject {
+                    const std::vector<Crossing>& C;
+                    explicit BySubject(const std::vector<Crossing>& c) : C(c) {}
+                    bool operator()(int a, int b) const {
+                        return C[a].SubjectEdge != C[b].SubjectEdge ? C[a].SubjectEdge < C[b].SubjectEdge : C[a].T < C[b].T;
+                    }
+                };
+
+                struct ByClip {
+                    const std::vector<Crossing>& C;
+                    explicit ByClip(const std::vector<Crossing>& c) : C(c) {}
+                    bool operator()(int a, int b) const {
+                        return C[a].ClipEdge != C[b].ClipEdge ? C[a].ClipEdge < C[b].ClipEdge : C[a].U < C[b].U;
+                    }
+                };
+
+                std::vector<Point2> subject;
+                std::vector<Point2> clip;
+                std::vector<Crossing> crossings;
+                std::vector<int> sorted;
+                std::vector<Node> nodes;
+                std::vector<Point2> points;
+                std::vector<int> ends;
+
+                PolygonClipper(const PolygonClipper&);
+                PolygonClipper& operator=(const PolygonClipper&);
+
+                static void Load(std::vector<Point2>& target, const Point2* source, int n) {
+                    target.assign(source, source + n);
+                    if (PolygonArea2(source, n) < 0)
+                        std::reverse(target.begin(), target.end());
+                }
+
+                /// <summary>
+                /// Finds all proper edge crossings; returns false when a vertex
+                /// touches the other polygon or edges overlap
+                /// </summary>
+                bool FindCrossings() {
+                    const double eps = 1e-10;
+                    int n = (int)subject.size(), m = (int)clip.size();
+                    crossings.clear();
+                    for (int i = 0; i < n; ++i) {
+                        const Point2& a0 = subject[i];
+                        const Point2& a1 = subject[i + 1 < n ? i + 1 : 0];
+                        double minX = std::min(a0.X, a1.X), maxX = std::max(a0.X, a1.X);
+                        double minY = std::min(a0.Y, a1.Y), maxY = std::max(a0.Y, a1.Y);
+                        for (int j = 0; j < m; ++j) {
+                            const Point2& b0 = clip[j];
+                            const Point2& b1 = clip[j + 1 < m ? j + 1 : 0];
+                            if (std::max(b0.X, b1.X) < minX || std::min(b0.X, b1.X) > maxX ||
+                                std::max(b0.Y, b1.Y) < minY || std::min(b0.Y, b1.Y) > maxY)
+                                continue;
+
+                            double rx = a1.X - a0.X, ry = a1.Y - a0.Y;
+                            double sx = b1.X - b0.X, sy = b1.Y - b0.Y;
+                            double qx = b0.X - a0.X, qy = b0.Y - a0.Y;
+                            double d = rx * sy - ry * sx;
+                            if (d == 0) {
+                                // Parallel; collinear overlap is degenerate
+                                if (qx * ry - qy * rx == 0)
+                                    return false;
+                                continue;
+                            }
+                            double t = (qx * sy - qy * sx) / d;
+                            double u = (qx * ry - qy * rx) / d;
+                            if (t < -eps || t > 1 + eps || u < -eps || u > 1 + eps)
+                                continue;
+                            if (t < eps || t > 1 - eps || u < eps || u > 1 - eps)
+                                return false;
+                            Crossing c = { i, j, t, u, { a0.X + t * rx, a0.Y + t * ry } };
+                            crossings.push_back(c);
+                        }
+                    }
+                    return true;
+                }
+
+                /// <summary>
+                /// Moves every subject vertex by a small pseudo-random offset
+                /// </summary>
+                void Nudge(double amount, unsigned int seed) {
+                    for (size_t i = 0; i < subject.size(); ++i) {
+                        seed = seed * 1664525u + 1013904223u;
+                        double dx = (seed >> 8) / 16777216.0 - 0.5;
+                        seed = seed * 1664525u + 1013904223u;
+                        double dy = (seed >> 8) / 16777216.0 - 0.5;
+                        subject[i].X += amount * dx;
+                        subject[i].Y += amount * dy;
+                    }
+                }
+
+                /// <summary>
+                /// Builds one ring of vertices with its crossings spliced in
+                /// edge order, returning the index of its first node
+                /// </summary>
+                int BuildRing(const std::vector<Point2>& ring, bool isSubject) {
+                    int first = (int)nodes.size(), n = (int)ring.size();
+                    sorted.resize(crossings.size());
+                    for (size_t k = 0; k < sorted.size(); ++k)
+                        sorted[k] = (int)k;
+                    if (isSubject)
+                        std::sort(sorted.begin(), sorted.end(), BySubject(crossings));
+                    else
+                        std::sort(sorted.begin(), sorted.end(), ByClip(crossings));
+
+                    size_t k = 0;
+                    for (int i = 0; i < n; ++i) {
+                        Node v = { ring[i], -1, -1, -1, false, false };
+                        nodes.push_back(v);
+                        while (k < sorted.size()) {
+                            const Crossing& c = crossings[sorted[k]];
+                            if ((isSubject ? c.SubjectEdge : c.ClipEdge) != i)
+                                break;
+                            // Neighbor temporarily holds the crossing index
+                            Node x = { c.P, -1, -1, sorted[k], false, false };
+                            nodes.push_back(x);
+                            k++;
+                        }
+                    }
+                    int last = (int)nodes.size() - 1;
+                    for (int i = first; i <= last; ++i) {
+                        nodes[i].Next = i < last ? i + 1 : first;
+                        nodes[i].Prev = i > first ? i - 1 : last;
+                    }
+                    return first;
+                }
+
+                /// <summary>
+                /// Marks each crossing of the ring starting at first as entering
+                /// or leaving the other polygon, inverted when requested
+                /// </summary>
+                void MarkEntries(int first, const std::vector<Point2>& other, bool invert) {
+                    bool inside = PolygonContains(&other[0], (int)other.size(), nodes[first].P);
+                    int i = first;
+                    do {
+                        if (nodes[i].Neighbor >= 0) {
+                            nodes[i].Entry = !inside != invert;
+                            inside = !inside;
+                        }
+                        i = nodes[i].Next;
+                    } while (i != first);
+                }
+
+                void EndContour() {
+                    int start = ends.empty() ? 0 : ends.back();
+                    if ((int)points.size() - start >= 3)
+                        ends.push_back((int)points.size());
+                    else
+                        points.resize(start);
+                }
+
+                void AddRing(const std::vector<Point2>& ring, bool reversed) {
+                    if (reversed)
+                        points.insert(points.end(), ring.rbegin(), ring.rend());
+                    else
+                        points.insert(points.end(), ring.begin(), ring.end());
+                    EndContour();
+                }
+
+            public:
+                PolygonClipper() {}
+
+                /// <summary>
+                /// Combines two simple polygons; returns the number of contours.
+                /// Read them back with Points and Ends.
+                /// </summary>
+                int Combine(const Point2* a, int n, const Point2* b, int m, ClipOperation operation) {
+                    points.clear();
+                    ends.clear();
+                    if (n < 3 || m < 3) {
+                        if (operation != ClipIntersection) {
+                            if (n >= 3)
+                                AddRing(std::vector<Point2>(a, a + n), PolygonArea2(a, n) < 0);
+                            if (m >= 3 && operation == ClipUnion)
+                                AddRing(std::vector<Point2>(b, b + m), PolygonArea2(b, m) < 0);
+                        }
+                        return (int)ends.size();
+                    }
+
+                    Load(subject, a, n);
+                    Load(clip, b, m);
+                    double extent = 0;
+                    for (int i = 0; i < n; ++i)
+                        extent = std::max(extent, std::max(std::fabs(a[i].X), std::fabs(a[i].Y)));
+                    double nudge = 1e-9 * (extent > 0 ? extent : 1);
+                    for (unsigned int attempt = 1; !FindCrossings(); ++attempt) {
+                        Load(subject, a, n);
+                        Nudge(nudge * attempt, attempt);
+                        if (attempt == 16) {
+                            crossings.clear();
+                            break;
+                        }
+                    }
+
+                    if (crossings.empty()) {
+                        bool aInB = PolygonContains(&clip[0], m, subject[0]);
+                        bool bInA = PolygonContains(&subject[0], n, clip[0]);
+                        if (operation == ClipIntersection) {
+                            if (aInB)
+                                AddRing(subject, false);
+                            else if (bInA)
+                                AddRing(clip, false);
+                        }
+                        else if (operation == ClipUnion) {
+                            if (aInB) {
+                                AddRing(clip, false);
+                            }
+                            else if (bInA) {
+                                AddRing(subject, false);
+                            }
+                            else {
+                                AddRing(subject, false);
+                                AddRing(clip, false);
+                            }
+                        }
+                        else if (!aInB) {
+                            AddRing(subject, false);
+                            if (bInA)
+                                AddRing(clip, true);
+                        }
+                        return (int)ends.size();
+                    }
+
+                    nodes.clear();
+                    int firstA = BuildRing(subject, true);
+                    int firstB = BuildRing(clip, false);
+                    // Turn crossing indices into node links
+                    sorted.assign(crossings.size(), -1);
+                    for (int i = firstA; i < firstB; ++i)
+                        if (nodes[i].Neighbor >= 0)
+                            sorted[nodes[i].Neighbor] = i;
+                    for (int i = firstB; i < (int)nodes.size(); ++i) {
+                        if (nodes[i].Neighbor >= 0) {
+                            int partner = sorted[nodes[i].Neighbor];
+                            nodes[i].Neighbor = partner;
+                            nodes[partner].Neighbor = i;
+                        }
+                    }
+                    MarkEntries(firstA, clip, operation != ClipIntersection);
+                    MarkEntries(firstB, subject, operation == ClipUnion);
+
+                    // Walk from each unvisited crossing, switching polygons at
+                    // every crossing, until the contour closes. Starting where
+                    // the subject is walked forwards keeps the winding of the
+                    // result counter-clockwise.
+                    int limit = 2 * (int)nodes.size();
+                    for (int start = firstA; start < firstB; ++start) {
+                        if (nodes[start].Neighbor < 0 || nodes[start].Visited || !nodes[start].Entry)
+                            continue;
+                        int cur = start, steps = 0;
+                        points.push_back(nodes[cur].P);
+                        while (steps < limit) {
+                            nodes[cur].Visited = nodes[nodes[cur].Neighbor].Visited = true;
+                            bool forward = nodes[cur].Entry;
+                            do {
+                                cur = forward ? nodes[cur].Next : nodes[cur].Prev;
+                                points.push_back(nodes[cur].P);
+                                steps++;
+                            } while (nodes[cur].Neighbor < 0 && steps < limit);
+                            cur = nodes[cur].Neighbor;
+                            if (nodes[cur].Visited)
+                                break;
+                        }
+                        // The walk ends on the start point again
+                        points.pop_back();
+                        EndContour();
+                    }
+                    return (int)ends.size();
+                }
+
+                /// <summary>
+                /// Gets the points of the last result, contour after contour
+                /// </summary>
+                const std::vector<Point2>& Points() const { return points; }
+
+                /// <summary>
+                /// Gets the exclusive end index of each contour of the last result
+                /// </summary>
+                const std::vector<int>& Ends() const { return ends; }
+            };
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+// Instruction set selection. MSVC only defines __AVX2__ under /arch:AVX2 and
+// always has SSE2 on x64; GCC/Clang follow -m flags (-mavx2 -mfma).
+#if defined(__AVX2__)
+#define WP_MATH_AVX2 1
+#if defined(__FMA__) || defined(_MSC_VER)
+#define WP_MATH_FMA 1
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WP_MATH_SSE2 1
+#endif
+
+#if defined(WP_MATH_AVX2) || defined(WP_MATH_SSE2)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#define WP_MATH_FORCEINLINE __forceinline
+#define WP_MATH_RESTRICT __restrict
+#else
+#define WP_MATH_FORCEINLINE inline __attribute__((always_inline))
+#define WP_MATH_RESTRICT __restrict__
+#endif
+
+// Native kernels must not be compiled to MSIL when included from /clr code.
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Alignment used for packed buffers (one cache line, covers AVX)
+            /// </summary>
+            const std::size_t CacheLineSize = 64;
+
+            /// <summary>
+            /// Allocates memory aligned to the given power-of-two boundary
+            /// </summary>
+            inline void* AlignedAlloc(std::size_t bytes, std::size_t alignment = CacheLineSize) {
+                if (bytes == 0)
+                    bytes = alignment;
+#if defined(_MSC_VER)
+                void* p = _aligned_malloc(bytes, alignment);
+#else
+                void* p = nullptr;
+                if (posix_memalign(&p, alignment, bytes) != 0)
+                    p = nullptr;
+#endif
+                if (!p)
+                    throw std::bad_alloc();
+                return p;
+            }
+
+            /// <summary>
+            /// Releases memory obtained from AlignedAlloc
+            /// </summary>
+            inline void AlignedFree(void* p) {
+#if defined(_MSC_VER)
+                _aligned_free(p);
+#else
+                std::free(p);
+#endif
+            }
+
+            /// <summary>
+            /// Owning, non-copyable aligned scratch buffer
+            /// </summary>
+            template<typename T>
+            class AlignedBuffer {
+            private:
+                T* data;
+                std::size_t count;
+
+                AlignedBuffer(const AlignedBuffer&);
+                AlignedBuffer& operator=(const AlignedBuffer&);
+
+            public:
+                explicit AlignedBuffer(std::size_t count)
+                    : data(static_cast<T*>(AlignedAlloc(count * sizeof(T)))), count(count) {
+                }
+
+                ~AlignedBuffer() {
+                    AlignedFree(data);
+                }
+
+                T* Data() const { return data; }
+                std::size_t Size() const { return count; }
+            };
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "Platform.h"
+
+#include <cmath>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Thin wrapper over the widest available vector registers for T.
+            /// The primary template is the scalar fallback (Width == 1).
+            /// </summary>
+            template<typename T>
+            struct Simd {
+                typedef T Vec;
+                static const int Width = 1;
+
+                static WP_MATH_FORCEINLINE Vec Zero() { return T(); }
+                static WP_MATH_FORCEINLINE Vec Broadcast(T x) { return x; }
+                static WP_MATH_FORCEINLINE Vec Load(const T* p) { return *p; }
+                static WP_MATH_FORCEINLINE void Store(T* p, Vec v) { *p = v; }
+                static WP_MATH_FORCEINLINE Vec Add(Vec a, Vec b) { return a + b; }
+                static WP_MATH_FORCEINLINE Vec Sub(Vec a, Vec b) { return a - b; }
+                static WP_MATH_FORCEINLINE Vec Mul(Vec a, Vec b) { return a * b; }
+                static WP_MATH_FORCEINLINE Vec Div(Vec a, Vec b) { return a / b; }
+                static WP_MATH_FORCEINLINE Vec MulAdd(Vec a, Vec b, Vec c) { return a * b + c; }
+                static WP_MATH_FORCEINLINE Vec Max(Vec a, Vec b) { return a > b ? a : b; }
+                static WP_MATH_FORCEINLINE Vec Min(Vec a, Vec b) { return a < b ? a : b; }
+                static WP_MATH_FORCEINLINE Vec Sqrt(Vec a) { return std::sqrt(a); }
+                static WP_MATH_FORCEINLINE T Sum(Vec v) { return v; }
+
+                // Lane-wise comparison, selection and exponent manipulation
+                // for the transcendental kernels
+                typedef bool Mask;
+                static WP_MATH_FORCEINLINE Mask Less(Vec a, Vec b) { return a < b; }
+                static WP_MATH_FORCEINLINE Vec Select(Mask m, Vec a, Vec b) { return m ? a : b; }
+                static WP_MATH_FORCEINLINE Vec Abs(Vec a) { return std::fabs(a); }
+                static WP_MATH_FORCEINLINE Vec Round(Vec a) { return std::nearbyint(a); }
+                /// <summary>2^k for integral k in [-126, 127] (float) or [-1022, 1023] (double)</summary>
+                static WP_MATH_FORCEINLINE Vec Pow2(Vec k) { return k == k ? std::ldexp(T(1), (int)k) : k; }
+                /// <summary>Splits a normal, positive a into a mantissa in [1, 2) and its exponent</summary>
+                static WP_MATH_FORCEINLINE Vec Frexp(Vec a, Vec& exponent) {
+                    int e = 0;
+                    T m = std::frexp(a, &e);
+                    exponent = T(e - 1);
+                    return m * 2;
+                }
+            };
+
+#if defined(WP_MATH_AVX2)
+            template<>
+            struct Simd<double> {
+                typedef __m256d Vec;
+                static const int Width = 4;
+
+                static WP_MATH_FORCEINLINE Vec Zero() { return _mm256_setzero_pd(); }
+                static WP_MATH_FORCEINLINE Vec Broadcast(double x) { return _mm256_set1_pd(x); }
+                static WP_MATH_FORCEINLINE Vec Load(const double* p) { return _mm256_loadu_pd(p); }
+                static WP_MATH_FORCEINLINE void Store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+                static WP_MATH_FORCEINLINE Vec Add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec MulAdd(Vec a, Vec b, Vec c) {
+#if defined(WP_MATH_FMA)
+                    return _mm256_fmadd_pd(a, b, c);
+#else
+                    return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+                }
+                static WP_MATH_FORCEINLINE Vec Max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sqrt(Vec a) { return _mm256_sqrt_pd(a); }
+                static WP_MATH_FORCEINLINE double Sum(Vec v) {
+                    __m128d lo = _mm256_castpd256_pd128(v);
+                    __m128d hi = _mm256_extractf128_pd(v, 1);
+                    lo = _mm_add_pd(lo, hi);
+                    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+                }
+
+                typedef __m256d Mask;
+                static WP_MATH_FORCEINLINE Mask Less(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+                static WP_MATH_FORCEINLINE Vec Select(Mask m, Vec a, Vec b) { return _mm256_blendv_pd(b, a, m); }
+                static WP_MATH_FORCEINLINE Vec Abs(Vec a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+                static WP_MATH_FORCEINLINE Vec Round(Vec a) {
+                    return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                }
+                static WP_MATH_FORCEINLINE Vec Pow2(Vec k) {
+                    // k + 2^52 + 1023 holds the biased exponent in its low bits
+                    __m256i bits = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(4503599627371519.0)));
+                    return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+                }
+                static WP_MATH_FORCEINLINE Vec Frexp(Vec a, Vec& exponent) {
+                    __m256i bits = _mm256_castpd_si256(a);
+                    __m256i e = _mm256_srli_epi64(bits, 52);
+                    // OR the biased exponent into the mantissa of 2^52 to convert it
+                    __m256d biased = _mm256_sub_pd(
+                        _mm256_castsi256_pd(_mm256_or_si256(e, _mm256_set1_epi64x(0x4330000000000000LL))),
+                        _mm256_set1_pd(4503599627370496.0));
+                    exponent = _mm256_sub_pd(biased, _mm256_set1_pd(1023.0));
+                    __m256i m = _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+                    return _mm256_castsi256_pd(_mm256_or_si256(m, _mm256_set1_epi64x(0x3FF0000000000000LL)));
+                }
+            };
+
+            template<>
+            struct Simd<float> {
+                typedef __m256 Vec;
+                static const int Width = 8;
+
+                static WP_MATH_FORCEINLINE Vec Zero() { return _mm256_setzero_ps(); }
+                static WP_MATH_FORCEINLINE Vec Broadcast(float x) { return _mm256_set1_ps(x); }
+                static WP_MATH_FORCEINLINE Vec Load(const float* p) { return _mm256_loadu_ps(p); }
+                static WP_MATH_FORCEINLINE void Store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+                static WP_MATH_FORCEINLINE Vec Add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec MulAdd(Vec a, Vec b, Vec c) {
+#if defined(WP_MATH_FMA)
+                    return _mm256_fmadd_ps(a, b, c);
+#else
+                    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+                }
+                static WP_MATH_FORCEINLINE Vec Max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+                static WP_MATH_FORCEINLINE float Sum(Vec v) {
+                    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+                    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+                    return _mm_cvtss_f32(_mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1)));
+                }
+
+                typedef __m256 Mask;
+                static WP_MATH_FORCEINLINE Mask Less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+                static WP_MATH_FORCEINLINE Vec Select(Mask m, Vec a, Vec b) { return _mm256_blendv_ps(b, a, m); }
+                static WP_MATH_FORCEINLINE Vec Abs(Vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+                static WP_MATH_FORCEINLINE Vec Round(Vec a) {
+                    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                }
+                static WP_MATH_FORCEINLINE Vec Pow2(Vec k) {
+                    __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(k), _mm256_set1_epi32(127));
+                    return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+                }
+                static WP_MATH_FORCEINLINE Vec Frexp(Vec a, Vec& exponent) {
+                    __m256i bits = _mm256_castps_si256(a);
+                    __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+                    exponent = _mm256_cvtepi32_ps(e);
+                    __m256i m = _mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF));
+                    return _mm256_castsi256_ps(_mm256_or_si256(m, _mm256_set1_epi32(0x3F800000)));
+                }
+            };
+#elif defined(WP_MATH_SSE2)
+            template<>
+            struct Simd<double> {
+                typedef __m128d Vec;
+                static const int Width = 2;
+
+                static WP_MATH_FORCEINLINE Vec Zero() { return _mm_setzero_pd(); }
+                static WP_MATH_FORCEINLINE Vec Broadcast(double x) { return _mm_set1_pd(x); }
+                static WP_MATH_FORCEINLINE Vec Load(const double* p) { return _mm_loadu_pd(p); }
+                static WP_MATH_FORCEINLINE void Store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+                static WP_MATH_FORCEINLINE Vec Add(Vec a, Vec b) { return _mm_add_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Mul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Div(Vec a, Vec b) { return _mm_div_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec MulAdd(Vec a, Vec b, Vec c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+                static WP_MATH_FORCEINLINE Vec Max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sqrt(Vec a) { return _mm_sqrt_pd(a); }
+                static WP_MATH_FORCEINLINE double Sum(Vec v) {
+                    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+                }
+
+                typedef __m128d Mask;
+                static WP_MATH_FORCEINLINE Mask Less(Vec a, Vec b) { return _mm_cmplt_pd(a, b); }
+                static WP_MATH_FORCEINLINE Vec Select(Mask m, Vec a, Vec b) {
+                    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+                }
+                static WP_MATH_FORCEINLINE Vec Abs(Vec a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+                static WP_MATH_FORCEINLINE Vec Round(Vec a) {
+                    // No roundpd before SSE4.1; adding 1.5 * 2^52 rounds to
+                    // nearest for |a| < 2^51
+                    const __m128d magic = _mm_set1_pd(6755399441055744.0);
+                    return _mm_sub_pd(_mm_add_pd(a, magic), magic);
+                }
+                static WP_MATH_FORCEINLINE Vec Pow2(Vec k) {
+                    __m128i bits = _mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(4503599627371519.0)));
+                    return _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+                }
+                static WP_MATH_FORCEINLINE Vec Frexp(Vec a, Vec& exponent) {
+                    __m128i bits = _mm_castpd_si128(a);
+                    __m128i e = _mm_srli_epi64(bits, 52);
+                    __m128d biased = _mm_sub_pd(
+                        _mm_castsi128_pd(_mm_or_si128(e, _mm_set1_epi64x(0x4330000000000000LL))),
+                        _mm_set1_pd(4503599627370496.0));
+                    exponent = _mm_sub_pd(biased, _mm_set1_pd(1023.0));
+                    __m128i m = _mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+                    return _mm_castsi128_pd(_mm_or_si128(m, _mm_set1_epi64x(0x3FF0000000000000LL)));
+                }
+            };
+
+            template<>
+            struct Simd<float> {
+                typedef __m128 Vec;
+                static const int Width = 4;
+
+                static WP_MATH_FORCEINLINE Vec Zero() { return _mm_setzero_ps(); }
+                static WP_MATH_FORCEINLINE Vec Broadcast(float x) { return _mm_set1_ps(x); }
+                static WP_MATH_FORCEINLINE Vec Load(const float* p) { return _mm_loadu_ps(p); }
+                static WP_MATH_FORCEINLINE void Store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+                static WP_MATH_FORCEINLINE Vec Add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec MulAdd(Vec a, Vec b, Vec c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+                static WP_MATH_FORCEINLINE Vec Max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Sqrt(Vec a) { return _mm_sqrt_ps(a); }
+                static WP_MATH_FORCEINLINE float Sum(Vec v) {
+                    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+                    return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+                }
+
+                typedef __m128 Mask;
+                static WP_MATH_FORCEINLINE Mask Less(Vec a, Vec b) { return _mm_cmplt_ps(a, b); }
+                static WP_MATH_FORCEINLINE Vec Select(Mask m, Vec a, Vec b) {
+                    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+                }
+                static WP_MATH_FORCEINLINE Vec Abs(Vec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                static WP_MATH_FORCEINLINE Vec Round(Vec a) {
+                    // Valid for |a| < 2^22
+                    const __m128 magic = _mm_set1_ps(12582912.0f);
+                    return _mm_sub_ps(_mm_add_ps(a, magic), magic);
+                }
+                static WP_MATH_FORCEINLINE Vec Pow2(Vec k) {
+                    __m128i e = _mm_add_epi32(_mm_cvtps_epi32(k), _mm_set1_epi32(127));
+                    return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+                }
+                static WP_MATH_FORCEINLINE Vec Frexp(Vec a, Vec& exponent) {
+                    __m128i bits = _mm_castps_si128(a);
+                    __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+                    exponent = _mm_cvtepi32_ps(e);
+                    __m128i m = _mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF));
+                    return _mm_castsi128_ps(_mm_or_si128(m, _mm_set1_epi32(0x3F800000)));
+                }
+            };
+#endif
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Platform.h"
+#include "TileScheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            // Kernels over compressed sparse storage. A compressed matrix has
+            // majorCount + 1 pointers; entries pointers[i]..pointers[i+1]-1 of
+            // indices/values belong to major line i (a row for CSR, a column
+            // for CSC). Gather walks the lines and dots each with x, which is
+            // y = A * x for CSR. Scatter adds each line into y, which is
+            // y = A * x for CSC and y = A^T * x for CSR.
+
+            namespace Detail {
+                template<typename T>
+                void SparseGatherRange(const int* pointers, const int* indices, const T* values,
+                                       const T* x, T* y, int begin, int end) {
+                    for (int i = begin; i < end; ++i) {
+                        int k = pointers[i], last = pointers[i + 1];
+                        // Two accumulators hide the add latency on long rows
+                        T s0 = T(), s1 = T();
+                        for (; k + 1 < last; k += 2) {
+                            s0 += values[k] * x[indices[k]];
+                            s1 += values[k + 1] * x[indices[k + 1]];
+                        }
+                        if (k < last)
+                            s0 += values[k] * x[indices[k]];
+                        y[i] = s0 + s1;
+                    }
+                }
+
+                template<typename T>
+                void SparseScatterRange(const int* pointers, const int* indices, const T* values,
+                                        const T* x, T* y, int begin, int end) {
+                    for (int j = begin; j < end; ++j) {
+                        T xj = x[j];
+                        if (xj == T())
+                            continue;
+                        for (int k = pointers[j]; k < pointers[j + 1]; ++k)
+                            y[indices[k]] += values[k] * xj;
+                    }
+                }
+
+                /// <summary>
+                /// Splits [0, majorCount) into tiles holding roughly equal
+                /// numbers of nonzeros, so a few dense rows cannot stall a worker
+                /// </summary>
+                inline void SparseTileBounds(const int* pointers, int majorCount, int tileCount, std::vector<int>& bounds) {
+                    bounds.assign(tileCount + 1, majorCount);
+                    bounds[0] = 0;
+                    long long nnz = pointers[majorCount];
+                    for (int t = 1; t < tileCount; ++t) {
+                        int target = (int)(nnz * t / tileCount);
+                        bounds[t] = (int)(std::lower_bound(pointers + bounds[t - 1], pointers + majorCount, target) - pointers);
+                    }
+                }
+
+                template<typename T>
+                struct SparseTiles {
+                    const int* Pointers;
+                    const int* Indices;
+                    const T* Values;
+                    const T* X;
+                    T* Y;
+                    int MinorCount;
+                    const int* Bounds;
+                    T* const* WorkerY;
+
+                    static void Gather(void* context, int tile, int) {
+                        SparseTiles& t = *static_cast<SparseTiles*>(context);
+                        SparseGatherRange(t.Pointers, t.Indices, t.Values, t.X, t.Y, t.Bounds[tile], t.Bounds[tile + 1]);
+                    }
+
+                    static void Scatter(void* context, int tile, int worker) {
+                        SparseTiles& t = *static_cast<SparseTiles*>(context);
+                        SparseScatterRange(t.Pointers, t.Indices, t.Values, t.X, t.WorkerY[worker],
+                                           t.Bounds[tile], t.Bounds[tile + 1]);
+                    }
+                };
+            }
+
+            /// <summary>
+            /// y[i] = sum over line i of values * x[indices] for every major line
+            /// </summary>
+            template<typename T>
+            void SparseGather(const int* pointers, const int* indices, const T* values, int majorCount,
+                              const T* x, T* y) {
+                Detail::SparseGatherRange(pointers, indices, values, x, y, 0, majorCount);
+            }
+
+            /// <summary>
+            /// SparseGather with nonzero-balanced bands of lines distributed over
+            /// the work-stealing pool. Every line is written by exactly one tile,
+            /// so no reduction is needed.
+            /// </summary>
+            template<typename T>
+            void SparseGatherParallel(const int* pointers, const int* indices, const T* values, int majorCount,
+                                      const T* x, T* y, int degreeOfParallelism) {
+                int participants = EffectiveParallelism(majorCount, degreeOfParallelism);
+                int tileCount = 4 * participants < majorCount ? 4 * participants : majorCount;
+                if (participants == 1 || tileCount <= 1) {
+                    SparseGather(pointers, indices, values, majorCount, x, y);
+                    return;
+                }
+
+                std::vector<int> bounds;
+                Detail::SparseTileBounds(pointers, majorCount, tileCount, bounds);
+                Detail::SparseTiles<T> tiles = { pointers, indices, values, x, y, 0, &bounds[0], 0 };
+                ParallelForTiles(tileCount, participants, &Detail::SparseTiles<T>::Gather, &tiles);
+            }
+
+            /// <summary>
+            /// y = sum over major lines j of x[j] * line j, where y has
+            /// minorCount elements. y is overwritten.
+            /// </summary>
+            template<typename T>
+            void SparseScatter(const int* pointers, const int* indices, const T* values, int majorCount,
+                               int minorCount, const T* x, T* y) {
+                memset(y, 0, (size_t)minorCount * sizeof(T));
+                Detail::SparseScatterRange(pointers, indices, values, x, y, 0, majorCount);
+            }
+
+            /// <summary>
+            /// SparseScatter over the pool. Lines of different tiles may hit the
+            /// same output, so every participant accumulates into a private
+            /// copy of y and the copies are summed at the end. Worth it only
+            /// when the nonzero count dwarfs participants * minorCount.
+            /// </summary>
+            template<typename T>
+            void SparseScatterParallel(const int* pointers, const int* indices, const T* values, int majorCount,
+                                       int minorCount, const T* x, T* y, int degreeOfParallelism) {
+                int participants = EffectiveParallelism(majorCount, degreeOfParallelism);
+                int tileCount = 4 * participants < majorCount ? 4 * participants : majorCount;
+                if (participants == 1 || tileCount <= 1) {
+                    SparseScatter(pointers, indices, values, majorCount, minorCount, x, y);
+                    return;
+                }
+
+                AlignedBuffer<T> scratch((size_t)(participants - 1) * minorCount);
+                memset(y, 0, (size_t)minorCount * sizeof(T));
+                memset(scratch.Data(), 0, scratch.Size() * sizeof(T));
+                std::vector<T*> workerY(participants);
+                workerY[0] = y;
+                for (int w = 1; w < participants; ++w)
+                    workerY[w] = scratch.Data() + (size_t)(w - 1) * minorCount;
+
+                std::vector<int> bounds;
+                Detail::SparseTileBounds(pointers, majorCount, tileCount, bounds);
+                Detail::SparseTiles<T> tiles = { pointers, indices, values, x, y, minorCount, &bounds[0], &workerY[0] };
+                ParallelForTiles(tileCount, participants, &Detail::SparseTiles<T>::Scatter, &tiles);
+
+                for (int w = 1; w < participants; ++w) {
+                    const T* part = workerY[w];
+                    for (int i = 0; i < minorCount; ++i)
+                        y[i] += part[i];
+                }
+            }
+
+            /// <summary>
+            /// Re-compresses along the other dimension: the CSR arrays of A
+            /// become the CSR arrays of A^T (equivalently, the CSC arrays of A).
+            /// A counting sort, O(nnz + majorCount + minorCount); indices of the
+            /// result come out sorted within each line.
+            /// </summary>
+            template<typename T>
+            void SparseTranspose(const int* pointers, const int* indices, const T* values, int majorCount,
+                                 int minorCount, int* outPointers, int* outIndices, T* outValues) {
+                memset(outPointers, 0, (size_t)(minorCount + 1) * sizeof(int));
+                int nnz = pointers[majorCount];
+                for (int k = 0; k < nnz; ++k)
+                    ++outPointers[indices[k] + 1];
+                for (int j = 0; j < minorCount; ++j)
+                    outPointers[j + 1] += outPointers[j];
+
+                // outPointers[j] doubles as the insertion cursor, then is
+                // shifted back into place
+                for (int i = 0; i < majorCount; ++i) {
+                    for (int k = pointers[i]; k < pointers[i + 1]; ++k) {
+                        int slot = outPointers[indices[k]]++;
+                        outIndices[slot] = i;
+                        outValues[slot] = values[k];
+                    }
+                }
+                for (int j = minorCount; j > 0; --j)
+                    outPointers[j] = outPointers[j - 1];
+                outPointers[0] = 0;
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,900 @@
+#pragma once
+
+#include "Factorization.h"
+#include "Gemm.h"
+#include "Transpose.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            namespace Detail {
+                /// <summary>
+                /// Reflectors per block when accumulating Householder products
+                /// </summary>
+                const int ReflectorBlock = 32;
+
+                /// <summary>
+                /// Rows of the target handled per pass of a blocked update,
+                /// bounding the scratch to PanelRows x columns
+                /// </summary>
+                const int ReflectorPanelRows = 128;
+
+                /// <summary>
+                /// Iterations allowed per eigenvalue or singular value before the
+                /// QR iteration gives up
+                /// </summary>
+                const int MaxSpectralIterations = 75;
+
+                /// <summary>
+                /// Columns reduced per panel of the blocked tridiagonal and
+                /// bidiagonal reductions
+                /// </summary>
+                const int ReductionBlock = 32;
+
+                /// <summary>
+                /// Trailing order at or below which the reductions finish one
+                /// column at a time, where the Gemm update no longer pays
+                /// </summary>
+                const int ReductionCrossover = 128;
+
+                /// <summary>
+                /// Turns x[0], x[inc], ..., x[(len - 1) * inc] into a Householder
+                /// reflector H = I - tau * v * v^T with H * x = (beta, 0, ...):
+                /// beta goes to x[0] and the essential part of v (unit leading
+                /// entry implied) to the rest. Returns tau, 0 when x is already
+                /// reduced.
+                /// </summary>
+                inline double MakeReflector(double* x, long long inc, int len) {
+                    double alpha = x[0];
+                    double sigma = 0;
+                    for (int i = 1; i < len; ++i)
+                        sigma += x[i * inc] * x[i * inc];
+                    if (sigma == 0)
+                        return 0;
+
+                    double norm = std::sqrt(alpha * alpha + sigma);
+                    double beta = alpha <= 0 ? norm : -norm;
+                    double scale = 1.0 / (alpha - beta);
+                    for (int i = 1; i < len; ++i)
+                        x[i * inc] *= scale;
+                    x[0] = beta;
+                    return (beta - alpha) / beta;
+                }
+
+                /// <summary>
+                /// x = c * x + s * y, y = c * y - s * x over n elements
+                /// </summary>
+                inline void RotateRows(double* WP_MATH_RESTRICT x, double* WP_MATH_RESTRICT y, int n, double c, double s) {
+                    for (int i = 0; i < n; ++i) {
+                        double t = c * x[i] + s * y[i];
+                        y[i] = c * y[i] - s * x[i];
+                        x[i] = t;
+                    }
+                }
+
+                /// <summary>
+                /// Accumulates Householder products one block of reflectors at a
+                /// time in compact WY form, H(k0) ... H(k1 - 1) = I - Y T Y^T, so
+                /// the bulk of the work runs through Gemm instead of rank-1
+                /// updates
+                /// </summary>
+                class ReflectorBlocks {
+                private:
+                    std::vector<double> y, t, w, wt, p;
+                    int degree;
+
+                    ReflectorBlocks(const ReflectorBlocks&);
+                    ReflectorBlocks& operator=(const ReflectorBlocks&);
+
+                public:
+                    explicit ReflectorBlocks(int degreeOfParallelism) : degree(degreeOfParallelism) {
+                    }
+
+                    /// <summary>
+                    /// Gathers nb reflectors acting on len consecutive indices
+                    /// into Y (len x nb): reflector j has its unit entry at row j
+                    /// and its essential element r at base[r * along + j *
+                    /// across] for r > j. Builds the triangular factor T.
+                    /// </summary>
+                    void Load(const double* base, long long along, long long across, int len, int nb, const double* tau) {
+                        y.assign((std::size_t)len * nb, 0.0);
+                        for (int r = 0; r < len; ++r) {
+                            double* row = &y[(std::size_t)r * nb];
+                            int limit = r < nb ? r : nb;
+                            for (int j = 0; j < limit; ++j)
+                                row[j] = base[r * along + j * across];
+                            if (r < nb)
+                                row[r] = 1;
+                        }
+
+                        // Forward columnwise T: T(0:j, j) = -tau_j T(0:j, 0:j) Y(:, 0:j)^T y_j
+                        t.assign((std::size_t)nb * nb, 0.0);
+                        std::vector<double> z(nb);
+                        for (int j = 0; j < nb; ++j) {
+                            t[(std::size_t)j * nb + j] = tau[j];
+                            if (tau[j] == 0)
+                                continue;
+                            for (int i = 0; i < j; ++i)
+                                z[i] = 0;
+                            for (int r = j; r < len; ++r) {
+                                const double* row = &y[(std::size_t)r * nb];
+                                double yj = row[j];
+                                for (int i = 0; i < j; ++i)
+                                    z[i] += row[i] * yj;
+                            }
+                            for (int i = 0; i < j; ++i) {
+                                double sum = 0;
+                                for (int l = i; l < j; ++l)
+                                    sum += t[(std::size_t)i * nb + l] * z[l];
+                                t[(std::size_t)i * nb + j] = -tau[j] * sum;
+                            }
+                        }
+                    }
+
+                    /// <summary>
+                    /// E = E * (H(k1 - 1) ... H(k0)) = E - (E Y) T^T Y^T for the
+                    /// rows x len block at e with row stride lde
+                    /// </summary>
+                    void ApplyRight(double* e, int rows, long long lde, int len, int nb) {
+                        int panel = rows < ReflectorPanelRows ? rows : ReflectorPanelRows;
+                        w.resize((std::size_t)panel * nb);
+                        wt.resize((std::size_t)panel * nb);
+                        p.resize((std::size_t)panel * len);
+                        ConstMatrixRef<double> ry = { &y[0], len, nb, nb, 1 };
+                        ConstMatrixRef<double> ryt = { &y[0], nb, len, 1, nb };
+
+                        for (int r0 = 0; r0 < rows; r0 += panel) {
+                            int pr = rows - r0 < panel ? rows - r0 : panel;
+                            double* block = e + r0 * lde;
+                            ConstMatrixRef<double> re = { block, pr, len, lde, 1 };
+                            GemmParallel<double>(re, ry, &w[0], nb, degree);
+
+                            for (int r = 0; r < pr; ++r) {
+                                const double* wr = &w[(std::size_t)r * nb];
+                                double* out = &wt[(std::size_t)r * nb];
+                                for (int j = 0; j < nb; ++j) {
+                                    const double* tj = &t[(std::size_t)j * nb];
+                                    double sum = 0;
+                                    for (int i = j; i < nb; ++i)
+                                        sum += wr[i] * tj[i];
+                                    out[j] = sum;
+                                }
+                            }
+
+                            ConstMatrixRef<double> rw = { &wt[0], pr, nb, nb, 1 };
+                            GemmParallel<double>(rw, ryt, &p[0], len, degree);
+                            for (int r = 0; r < pr; ++r) {
+                                double* target = block + r * lde;
+                                const double* source = &p[(std::size_t)r * len];
+                                for (int c = 0; c < len; ++c)
+                                    target[c] -= source[c];
+                            }
+                        }
+                    }
+                };
+
+                /// <summary>
+                /// Subtracts L R^T from the rows x cols block at c (row stride
+                /// ldc), with L (rows x k) and R (cols x k) dense row-major, one
+                /// panel of rows at a time through Gemm. With lower set the block
+                /// is square and only its lower triangle is written.
+                /// </summary>
+                inline void SubtractPanelProduct(double* c, long long ldc, const double* l, const double* r, int rows, int cols,
+                                                 int k, bool lower, int degreeOfParallelism, std::vector<double>& scratch) {
+                    for (int r0 = 0; r0 < rows; r0 += ReflectorPanelRows) {
+                        int pr = rows - r0 < ReflectorPanelRows ? rows - r0 : ReflectorPanelRows;
+                        int width = lower ? r0 + pr : cols;
+                        scratch.resize((std::size_t)pr * width);
+                        ConstMatrixRef<double> rl = { l + (long long)r0 * k, pr, k, k, 1 };
+                        ConstMatrixRef<double> rrt = { r, k, width, 1, k };
+                        GemmParallel<double>(rl, rrt, &scratch[0], width, degreeOfParallelism);
+                        for (int i = 0; i < pr; ++i) {
+                            double* target = c + (long long)(r0 + i) * ldc;
+                            const double* source = &scratch[(std::size_t)i * width];
+                            int end = lower ? r0 + i + 1 : width;
+                            for (int j = 0; j < end; ++j)
+                                target[j] -= source[j];
+                        }
+                    }
+                }
+
+                /// <summary>
+                /// Reduces the symmetric row-major n x n matrix a (lower triangle
+                /// read) to tridiagonal form Q^T A Q with diagonal d and
+                /// subdiagonal e (e[n - 1] = 0). Reflector k acts on indices k + 1
+                /// .. n - 1; its essential part is left in column k below the
+                /// subdiagonal and its scalar in tau[k].
+                /// </summary>
+                /// <remarks>
+                /// Panels of ReductionBlock columns are reduced as in LAPACK's
+                /// DSYTRD: each reflector's symmetric product reads the trailing
+                /// block as it stood before the panel and is corrected by the
+                /// panel's earlier reflectors, and the trailing block then takes
+                /// the whole panel as one rank-2nb update A -= V W^T + W V^T
+                /// through Gemm. The symmetric products stay level-2, about half
+                /// the flops. The last ReductionCrossover columns go one at a time.
+                /// </remarks>
+                inline void Tridiagonalize(double* a, int n, double* d, double* e, double* tau, int degreeOfParallelism) {
+                    std::vector<double> v(n), y(n);
+                    const int nb = ReductionBlock, width = 2 * nb;
+                    std::vector<double> vw, wv, z(width), scratch;
+                    int k = 0;
+                    for (; n - k > ReductionCrossover; k += nb) {
+                        // Row i of vw is index k + 1 + i: V in its first nb columns, W in the rest
+                        vw.assign((std::size_t)(n - k - 1) * width, 0.0);
+                        for (int j = 0; j < nb; ++j) {
+                            int c = k + j, s = c + 1, len = n - s;
+                            if (j > 0) {
+                                // Column c below the diagonal takes the panel's earlier updates
+                                const double* vc = &vw[(std::size_t)(j - 1) * width];
+                                for (int r = c; r < n; ++r) {
+                                    const double* vr = &vw[(std::size_t)(r - k - 1) * width];
+                                    double sum = 0;
+                                    for (int l = 0; l < j; ++l)
+                                        sum += vr[l] * vc[nb + l] + vr[nb + l] * vc[l];
+                                    a[(long long)r * n + c] -= sum;
+                                }
+                            }
+
+                            d[c] = a[(long long)c * n + c];
+                            double* column = a + (long long)s * n + c;
+                            double h = MakeReflector(column, n, len);
+                            e[c] = column[0];
+                            tau[c] = h;
+                            double* panel = &vw[(std::size_t)j * width];
+                            panel[j] = 1;
+                            v[0] = 1;
+                            for (int i = 1; i < len; ++i)
+                                panel[(std::size_t)i * width + j] = v[i] = column[(long long)i * n];
+                            if (h == 0)
+                                continue;
+
+                            // y = B v over the trailing block as it was before this panel
+                            for (int i = 0; i < len; ++i)
+                                y[i] = 0;
+                            for (int i = 0; i < len; ++i) {
+                                const double* row = a + (long long)(s + i) * n + s;
+                                y[i] += Dot(row, &v[0], i) + row[i] * v[i];
+                                SubtractScaled(&y[0], row, -v[i], i);
+                            }
+
+                            // less the panel's earlier updates, y -= W (V^T v) + V (W^T v)
+                            for (int l = 0; l < width; ++l)
+                                z[l] = 0;
+                            for (int i = 0; i < len; ++i) {
+                                const double* row = panel + (std::size_t)i * width;
+                                for (int l = 0; l < j; ++l) {
+                                    z[l] += row[l] * v[i];
+                                    z[nb + l] += row[nb + l] * v[i];
+                                }
+                            }
+                            for (int i = 0; i < len; ++i) {
+                                const double* row = panel + (std::size_t)i * width;
+                                double sum = 0;
+                                for (int l = 0; l < j; ++l)
+                                    sum += row[nb + l] * z[l] + row[l] * z[nb + l];
+                                y[i] = h * (y[i] - sum);
+                            }
+
+                            double alpha = -0.5 * h * Dot(&y[0], &v[0], len);
+                            for (int i = 0; i < len; ++i)
+                                panel[(std::size_t)i * width + nb + j] = y[i] + alpha * v[i];
+                        }
+
+                        // B -= [V W] [W V]^T over the block past the panel
+                        int t = k + nb, rows = n - t;
+                        const double* lower = &vw[(std::size_t)(nb - 1) * width];
+                        wv.resize((std::size_t)rows * width);
+                        for (int i = 0; i < rows; ++i) {
+                            const double* source = lower + (std::size_t)i * width;
+                            double* target = &wv[(std::size_t)i * width];
+                            for (int l = 0; l < nb; ++l) {
+                                target[l] = source[nb + l];
+                                target[nb + l] = source[l];
+                            }
+                        }
+                        SubtractPanelProduct(a + (long long)t * n + t, n, lower, &wv[0], rows, rows, width, true,
+                                             degreeOfParallelism, scratch);
+                    }
+
+                    for (; k + 1 < n; ++k) {
+                        d[k] = a[(long long)k * n + k];
+                        int s = k + 1, len = n - s;
+                        double* column = a + (long long)s * n + k;
+                        double h = MakeReflector(column, n, len);
+                        e[k] = column[0];
+                        tau[k] = h;
+                        if (h == 0)
+                            continue;
+
+                        v[0] = 1;
+                        for (int i = 1; i < len; ++i)
+                            v[i] = column[(long long)i * n];
+
+                        // y = tau * B v over the trailing block, from its lower triangle
+                        for (int i = 0; i < len; ++i)
+                            y[i] = 0;
+                        for (int i = 0; i < len; ++i) {
+                            const double* row = a + (long long)(s + i) * n + s;
+                            y[i] += Dot(row, &v[0], i) + row[i] * v[i];
+                            SubtractScaled(&y[0], row, -v[i], i);
+                        }
+                        for (int i = 0; i < len; ++i)
+                            y[i] *= h;
+
+                        // w = y - (tau / 2) (y . v) v; B -= v w^T + w v^T
+                        double alpha = -0.5 * h * Dot(&y[0], &v[0], len);
+                        for (int i = 0; i < len; ++i)
+                            y[i] += alpha * v[i];
+                        for (int i = 0; i < len; ++i) {
+                            double* row = a + (long long)(s + i) * n + s;
+                            SubtractScaled(row, &y[0], v[i], i + 1);
+                            SubtractScaled(row, &v[0], y[i], i + 1);
+                        }
+                    }
+                    if (n > 0) {
+                        d[n - 1] = a[(long long)(n - 1) * n + (n - 1)];
+                        e[n - 1] = 0;
+                    }
+                }
+
+                /// <summary>
+                /// Implicit QL iteration with Wilkinson shifts on the symmetric
+                /// tridiagonal (d, e), e[i] coupling i and i + 1. Rotations are
+                /// applied to the rows of zt (n x n) when given. Returns false if
+                /// an eigenvalue fails to converge.
+                /// </summary>
+                inline bool TridiagonalQl(double* d, double* e, int n, double* zt) {
+                    const double eps = DBL_EPSILON;
+                    double f = 0, norm = 0;
+                    for (int l = 0; l < n; ++l) {
+                        double size = std::fabs(d[l]) + std::fabs(e[l]);
+                        if (size > norm)
+                            norm = size;
+                        int m = l;
+                        while (m < n - 1 && std::fabs(e[m]) > eps * norm)
+                            ++m;
+
+                        if (m > l) {
+                            int iterations = 0;
+                            do {
+                                if (++iterations > MaxSpectralIterations)
+                                    return false;
+
+                                double g = d[l];
+                                double p = (d[l + 1] - g) / (2 * e[l]);
+                                double r = std::sqrt(p * p + 1);
+                                if (p < 0)
+                                    r = -r;
+                                d[l] = e[l] / (p + r);
+                                d[l + 1] = e[l] * (p + r);
+                                double dl1 = d[l + 1];
+                                double h = g - d[l];
+                                for (int i = l + 2; i < n; ++i)
+                                    d[i] -= h;
+                                f += h;
+
+                                p = d[m];
+                                double c = 1, c2 = 1, c3 = 1;
+                                double el1 = e[l + 1];
+                                double s = 0, s2 = 0;
+                                for (int i = m - 1; i >= l; --i) {
+                                    c3 = c2;
+                                    c2 = c;
+                                    s2 = s;
+                                    g = c * e[i];
+                                    h = c * p;
+                                    r = std::sqrt(p * p + e[i] * e[i]);
+                                    e[i + 1] = s * r;
+                                    s = e[i] / r;
+                                    c = p / r;
+                                    p = c * d[i] - s * g;
+                                    d[i + 1] = h + s * (c * g + s * d[i]);
+                                    if (zt)
+                                        RotateRows(zt + (long long)i * n, zt + (long long)(i + 1) * n, n, c, -s);
+                                }
+                                p = -s * s2 * c3 * el1 * e[l] / dl1;
+                                e[l] = s * p;
+                                d[l] = c * p;
+                            } while (std::fabs(e[l]) > eps * norm);
+                        }
+                        d[l] += f;
+                        e[l] = 0;
+                    }
+                    return true;
+                }
+
+                /// <summary>
+                /// Singular values of the upper bidiagonal (s, e) by implicit
+                /// shifted QR (Golub-Kahan), left in descending order and
+                /// nonnegative. Rotations go to the rows of ut (n x ldu) and vt
+                /// (n x n) when given. Returns false on nonconvergence.
+                /// </summary>
+                inline bool BidiagonalQr(double* s, double* e, int n, double* ut, int ldu, double* vt) {
+                    const double eps = DBL_EPSILON;
+                    const double tiny = std::ldexp(1.0, -966);
+                    int p = n, iterations = 0;
+                    while (p > 0) {
+                        int k, kase;
+                        for (k = p - 2; k >= 0; --k) {
+                            if (std::fabs(e[k]) <= tiny + eps * (std::fabs(s[k]) + std::fabs(s[k + 1]))) {
+                                e[k] = 0;
+                                break;
+                            }
+                        }
+                        if (k == p - 2) {
+                            kase = 4;
+                        }
+                        else {
+                            int ks;
+                            for (ks = p - 1; ks > k; --ks) {
+                                double t = (ks != p ? std::fabs(e[ks]) : 0) + (ks != k + 1 ? std::fabs(e[ks - 1]) : 0);
+                                if (std::fabs(s[ks]) <= tiny + eps * t) {
+                                    s[ks] = 0;
+                                    break;
+                                }
+                            }
+                            if (ks == k) {
+                                kase = 3;
+                            }
+                            else if (ks == p - 1) {
+                                kase = 1;
+                            }
+                            else {
+                                kase = 2;
+                                k = ks;
+                            }
+                        }
+                        ++k;
+
+                        if (kase == 1) {
+                            // s[p - 1] is negligible: chase e[p - 2] out
+                            double f = e[p - 2];
+                            e[p - 2] = 0;
+                            for (int j = p - 2; j >= k; --j) {
+                                double t = std::sqrt(s[j] * s[j] + f * f);
+                                double cs = s[j] / t, sn = f / t;
+                                s[j] = t;
+                                if (j != k) {
+                                    f = -sn * e[j - 1];
+                                    e[j - 1] = cs * e[j - 1];
+                                }
+                                if (vt)
+                                    RotateRows(vt + (long long)j * n, vt + (long long)(p - 1) * n, n, cs, sn);
+                            }
+                        }
+                        else if (kase == 2) {
+                            // s[k - 1] is negligible: split there
+                            double f = e[k - 1];
+                            e[k - 1] = 0;
+                            for (int j = k; j < p; ++j) {
+                                double t = std::sqrt(s[j] * s[j] + f * f);
+                                double cs = s[j] / t, sn = f / t;
+                                s[j] = t;
+                                f = -sn * e[j];
+                                e[j] = cs * e[j];
+                                if (ut)
+                                    RotateRows(ut + (long long)j * ldu, ut + (long long)(k - 1) * ldu, ldu, cs, sn);
+                            }
+                        }
+                        else if (kase == 3) {
+                            if (++iterations > MaxSpectralIterations)
+                                return false;
+
+                            // Shift from the trailing 2 x 2 of B^T B
+                            double scale = std::fabs(s[p - 1]);
+                            double values[4] = { s[p - 2], e[p - 2], s[k], e[k] };
+                            for (int i = 0; i < 4; ++i)
+                                if (std::fabs(values[i]) > scale)
+                                    scale = std::fabs(values[i]);
+                            double sp = s[p - 1] / scale, spm1 = s[p - 2] / scale, epm1 = e[p - 2] / scale;
+                            double sk = s[k] / scale, ek = e[k] / scale;
+                            double b = ((spm1 + sp) * (spm1 - sp) + epm1 * epm1) / 2;
+                            double c = (sp * epm1) * (sp * epm1);
+                            double shift = 0;
+                            if (b != 0 || c != 0) {
+                                shift = std::sqrt(b * b + c);
+                                if (b < 0)
+                                    shift = -shift;
+                                shift = c / (b + shift);
+                            }
+                            double f = (sk + sp) * (sk - sp) + shift;
+                            double g = sk * ek;
+
+                            for (int j = k; j < p - 1; ++j) {
+                                double t = std::sqrt(f * f + g * g);
+                                double cs = f / t, sn = g / t;
+                                if (j != k)
+                                    e[j - 1] = t;
+                                f = cs * s[j] + sn * e[j];
+                                e[j] = cs * e[j] - sn * s[j];
+                                g = sn * s[j + 1];
+                                s[j + 1] = cs * s[j + 1];
+                                if (vt)
+                                    RotateRows(vt + (long long)j * n, vt + (long long)(j + 1) * n, n, cs, sn);
+
+                                t = std::sqrt(f * f + g * g);
+                                cs = f / t;
+                                sn = g / t;
+                                s[j] = t;
+                                f = cs * e[j] + sn * s[j + 1];
+                                s[j + 1] = -sn * e[j] + cs * s[j + 1];
+                                g = sn * e[j + 1];
+                                e[j + 1] = cs * e[j + 1];
+                                if (ut)
+                                    RotateRows(ut + (long long)j * ldu, ut + (long long)(j + 1) * ldu, ldu, cs, sn);
+                            }
+                            e[p - 2] = f;
+                        }
+                        else {
+                            // Converged: make s[k] nonnegative and sort it into place
+                            if (s[k] <= 0) {
+                                s[k] = s[k] < 0 ? -s[k] : 0;
+                                if (vt) {
+                                    double* row = vt + (long long)k * n;
+                                    for (int i = 0; i < n; ++i)
+                                        row[i] = -row[i];
+                                }
+                            }
+                            while (k < n - 1 && s[k] < s[k + 1]) {
+                                double t = s[k];
+                                s[k] = s[k + 1];
+                                s[k + 1] = t;
+                                if (vt)
+                                    SwapRows(vt, n, k, k + 1);
+                                if (ut)
+                                    SwapRows(ut, ldu, k, k + 1);
+                                ++k;
+                            }
+                            iterations = 0;
+                            --p;
+                        }
+                    }
+                    return true;
+                }
+
+                /// <summary>
+                /// Thin SVD of the row-major m x n matrix a with m >= n, which is
+                /// destroyed. ut (n x m) and vt (n x n) receive the singular
+                /// vectors as rows when given.
+                /// </summary>
+                /// <remarks>
+                /// The bidiagonalization reduces panels of ReductionBlock columns
+                /// as in LAPACK's DGEBRD: each reflector pair reads the trailing
+                /// block as it stood before the panel, corrected by the panel's
+                /// earlier reflectors, and the trailing block then takes the whole
+                /// panel as one update A -= V Y^T + X U^T through Gemm. The
+                /// matrix-vector products stay level-2, about half the flops.
+                /// </remarks>
+                inline bool SvdTall(double* a, int m, int n, double* s, double* ut, double* vt, int degreeOfParallelism) {
+                    std::vector<double> e(n + 1), tauq(n), taup(n + 1), w(n);
+                    // Golub-Kahan bidiagonalization A = Q B P^T, row-oriented
+                    const int nb = ReductionBlock, width = 2 * nb;
+                    std::vector<double> vx, yu, z(width), scratch;
+                    int k = 0;
+                    for (; n - k > ReductionCrossover; k += nb) {
+                        // Row i of vx is row k + i, V then X; row j of yu is column k + j, Y then U
+                        vx.assign((std::size_t)(m - k) * width, 0.0);
+                        yu.assign((std::size_t)(n - k) * width, 0.0);
+                        for (int i = 0; i < nb; ++i) {
+                            int c = k + i, len = n - c - 1;
+                            double* vc = &vx[(std::size_t)i * width];
+                            if (i > 0) {
+                                // Column c from the diagonal down takes the panel's earlier updates
+                                const double* yc = &yu[(std::size_t)i * width];
+                                for (int r = c; r < m; ++r) {
+                                    const double* vr = &vx[(std::size_t)(r - k) * width];
+                                    double sum = 0;
+                                    for (int l = 0; l < i; ++l)
+                                        sum += vr[l] * yc[l] + vr[nb + l] * yc[nb + l];
+                                    a[(long long)r * n + c] -= sum;
+                                }
+                            }
+
+                            double* column = a + (long long)c * n + c;
+                            tauq[c] = MakeReflector(column, n, m - c);
+                            s[c] = column[0];
+                            vc[i] = 1;
+                            for (int r = 1; r < m - c; ++r)
+                                vc[(std::size_t)r * width + i] = column[(long long)r * n];
+
+                            double* rowC = column + 1;
+                            double* yNext = &yu[(std::size_t)(i + 1) * width];
+                            if (tauq[c] != 0) {
+                                // Y(:, i) = tau (A^T v - Y (V^T v) - U (X^T v)) over columns c + 1 ..,
+                                // A as it was before this panel
+                                for (int j = 0; j < len; ++j)
+                                    w[j] = rowC[j];
+                                for (int r = c + 1; r < m; ++r) {
+                                    double coefficient = vc[(std::size_t)(r - c) * width + i];
+                                    if (coefficient != 0)
+                                        SubtractScaled(&w[0], a + (long long)r * n + c + 1, -coefficient, len);
+                                }
+                                for (int l = 0; l < width; ++l)
+                                    z[l] = 0;
+                                for (int r = c; r < m; ++r) {
+                                    const double* row = &vx[(std::size_t)(r - k) * width];
+                                    for (int l = 0; l < i; ++l) {
+                                        z[l] += row[l] * row[i];
+                                        z[nb + l] += row[nb + l] * row[i];
+                                    }
+                                }
+                                for (int j = 0; j < len; ++j) {
+                                    double* row = yNext + (std::size_t)j * width;
+                                    double sum = 0;
+                                    for (int l = 0; l < i; ++l)
+                                        sum += row[l] * z[l] + row[nb + l] * z[nb + l];
+                                    row[i] = tauq[c] * (w[j] - sum);
+                                }
+                            }
+
+                            // Row c past the diagonal takes the panel's updates, this left reflector's included
+                            for (int j = 0; j < len; ++j) {
+                                const double* row = yNext + (std::size_t)j * width;
+                                double sum = row[i] * vc[i];
+                                for (int l = 0; l < i; ++l)
+                                    sum += row[l] * vc[l] + row[nb + l] * vc[nb + l];
+                                rowC[j] -= sum;
+                            }
+
+                            taup[c] = MakeReflector(rowC, 1, len);
+                            e[c] = rowC[0];
+                            yNext[nb + i] = 1;
+                            for (int j = 1; j < len; ++j)
+                                yNext[(std::size_t)j * width + nb + i] = rowC[j];
+                            if (taup[c] != 0) {
+                                // X(:, i) = tau (A u - V (Y^T u) - X (U^T u)) over rows c + 1 ..
+                                for (int l = 0; l < width; ++l)
+                                    z[l] = 0;
+                                for (int j = 0; j < len; ++j) {
+                                    const double* row = yNext + (std::size_t)j * width;
+                                    double coefficient = row[nb + i];
+                                    for (int l = 0; l <= i; ++l)
+                                        z[l] += row[l] * coefficient;
+                                    for (int l = 0; l < i; ++l)
+                                        z[nb + l] += row[nb + l] * coefficient;
+                                }
+                                for (int r = c + 1; r < m; ++r) {
+                                    const double* row = a + (long long)r * n + c + 1;
+                                    double* xr = &vx[(std::size_t)(r - k) * width];
+                                    double sum = 0;
+                                    for (int l = 0; l <= i; ++l)
+                                        sum += xr[l] * z[l];
+                                    for (int l = 0; l < i; ++l)
+                                        sum += xr[nb + l] * z[nb + l];
+                                    xr[nb + i] = taup[c] * (row[0] + Dot(row + 1, rowC + 1, len - 1) - sum);
+                                }
+                            }
+                        }
+
+                        // A -= [V X] [Y U]^T over the block past the panel
+                        int t = k + nb;
+                        SubtractPanelProduct(a + (long long)t * n + t, n, &vx[(std::size_t)nb * width],
+                                             &yu[(std::size_t)nb * width], m - t, n - t, width, false, degreeOfParallelism,
+                                             scratch);
+                    }
+
+                    for (; k < n; ++k) {
+                        double* column = a + (long long)k * n + k;
+                        tauq[k] = MakeReflector(column, n, m - k);
+                        s[k] = column[0];
+                        int width = n - k - 1;
+                        if (tauq[k] != 0 && width > 0) {
+                            // w = v^T A(k:, k+1:), A(k:, k+1:) -= tau v w^T
+                            const double* rowK = column + 1;
+                            for (int c = 0; c < width; ++c)
+                                w[c] = rowK[c];
+                            for (int i = k + 1; i < m; ++i) {
+                                const double* row = a + (long long)i * n;
+                                if (row[k] != 0)
+                                    SubtractScaled(&w[0], row + k + 1, -row[k], width);
+                            }
+                            SubtractScaled(column + 1, &w[0], tauq[k], width);
+                            for (int i = k + 1; i < m; ++i) {
+                                double* row = a + (long long)i * n;
+                                if (row[k] != 0)
+                                    SubtractScaled(row + k + 1, &w[0], tauq[k] * row[k], width);
+                            }
+                        }
+
+                        if (width > 0) {
+                            double* rowK = column + 1;
+                            taup[k] = MakeReflector(rowK, 1, width);
+                            e[k] = rowK[0];
+                            if (taup[k] != 0) {
+                                // A(k+1:, k+1:) -= tau (A u) u^T, one row at a time
+                                for (int i = k + 1; i < m; ++i) {
+                                    double* row = a + (long long)i * n + k + 1;
+                                    double dot = row[0] + Dot(row + 1, rowK + 1, width - 1);
+                                    double scale = taup[k] * dot;
+                                    row[0] -= scale;
+                                    SubtractScaled(row + 1, rowK + 1, scale, width - 1);
+                                }
+                            }
+                        }
+                        else {
+                            e[k] = 0;
+                            taup[k] = 0;
+                        }
+                    }
+
+                    ReflectorBlocks blocks(degreeOfParallelism);
+                    if (ut) {
+                        // U^T = I(n x m) H(n - 1) ... H(0); rows above a block stay untouched
+                        for (long long i = 0; i < (long long)n * m; ++i)
+                            ut[i] = 0;
+                        for (int i = 0; i < n; ++i)
+                            ut[(long long)i * m + i] = 1;
+                        for (int k0 = ((n - 1) / ReflectorBlock) * ReflectorBlock; k0 >= 0; k0 -= ReflectorBlock) {
+                            int nb = n - k0 < ReflectorBlock ? n - k0 : ReflectorBlock;
+                            blocks.Load(a + (long long)k0 * n + k0, n, 1, m - k0, nb, &tauq[k0]);
+                            blocks.ApplyRight(ut + (long long)k0 * m + k0, n - k0, m, m - k0, nb);
+                        }
+                    }
+                    if (vt) {
+                        // V^T = I P(n - 2) ... P(0); reflector k acts on k + 1 .. n - 1
+                        for (long long i = 0; i < (long long)n * n; ++i)
+                            vt[i] = 0;
+                        for (int i = 0; i < n; ++i)
+                            vt[(long long)i * n + i] = 1;
+                        int count = n - 1;
+                        for (int k0 = count > 0 ? ((count - 1) / ReflectorBlock) * ReflectorBlock : -1; k0 >= 0;
+                             k0 -= ReflectorBlock) {
+                            int nb = count - k0 < ReflectorBlock ? count - k0 : ReflectorBlock;
+                            int o = k0 + 1;
+                            blocks.Load(a + (long long)k0 * n + o, 1, n, n - o, nb, &taup[k0]);
+                            blocks.ApplyRight(vt + (long long)o * n + o, n - o, n, n - o, nb);
+                        }
+                    }
+
+                    return BidiagonalQr(s, &e[0], n, ut, m, vt);
+                }
+            }
+
+            /// <summary>
+            /// Eigendecomposition A = V diag(values) V^T of the symmetric
+            /// row-major n x n matrix a, of which only the lower triangle is
+            /// read and which is destroyed. Householder tridiagonalization is
+            /// followed by implicit QL; the reflectors are accumulated in
+            /// blocks through Gemm. values are ascending; vectors (n x n
+            /// row-major, may be null) receives the orthonormal eigenvectors as
+            /// columns. Returns false if the iteration fails to converge.
+            /// </summary>
+            inline bool SymmetricEigen(double* a, int n, double* values, double* vectors, int degreeOfParallelism) {
+                if (n == 0)
+                    return true;
+                std::vector<double> e(n), tau(n);
+                Detail::Tridiagonalize(a, n, values, &e[0], &tau[0], degreeOfParallelism);
+
+                std::vector<double> zt;
+                if (vectors) {
+                    zt.assign((std::size_t)n * n, 0.0);
+                    for (int i = 0; i < n; ++i)
+                        zt[(std::size_t)i * n + i] = 1;
+                }
+                if (!Detail::TridiagonalQl(values, &e[0], n, vectors ? &zt[0] : 0))
+                    return false;
+
+                // Selection sort keeps the row swaps of zt to n
+                for (int i = 0; i + 1 < n; ++i) {
+                    int min = i;
+                    for (int j = i + 1; j < n; ++j)
+                        if (values[j] < values[min])
+                            min = j;
+                    if (min != i) {
+                        double t = values[i];
+                        values[i] = values[min];
+                        values[min] = t;
+                        if (vectors)
+                            Detail::SwapRows(&zt[0], n, i, min);
+                    }
+                }
+                if (!vectors)
+                    return true;
+
+                // V^T = Z^T Q^T = Z^T H(n - 2) ... H(0)
+                Detail::ReflectorBlocks blocks(degreeOfParallelism);
+                int count = n - 1;
+                for (int k0 = count > 0 ? ((count - 1) / Detail::ReflectorBlock) * Detail::ReflectorBlock : -1; k0 >= 0;
+                     k0 -= Detail::ReflectorBlock) {
+                    int nb = count - k0 < Detail::ReflectorBlock ? count - k0 : Detail::ReflectorBlock;
+                    int o = k0 + 1;
+                    blocks.Load(a + (long long)o * n + k0, n, 1, n - o, nb, &tau[k0]);
+                    blocks.ApplyRight(&zt[0] + o, n, n, n - o, nb);
+                }
+                Transpose<double>(&zt[0], n, n, vectors);
+                return true;
+            }
+
+            /// <summary>
+            /// Thin singular value decomposition A = U diag(s) V^T of the
+            /// row-major m x n matrix a, with p = min(m, n). Golub-Kahan
+            /// bidiagonalization is followed by implicit shifted QR, and the
+            /// reflectors are accumulated in blocks through Gemm. s receives
+            /// the p singular values in descending order; u (m x p) and v
+            /// (n x p), row-major and each may be null, receive the singular
+            /// vectors as columns. Returns false if the iteration fails to
+            /// converge.
+            /// </summary>
+            inline bool Svd(const double* a, int m, int n, double* s, double* u, double* v, int degreeOfParallelism) {
+                if (m == 0 || n == 0)
+                    return true;
+
+                // Work on the tall orientation; for wide matrices A^T = V S U^T
+                bool wide = m < n;
+                int rows = wide ? n : m, cols = wide ? m : n;
+                std::vector<double> work((std::size_t)rows * cols);
+                if (wide)
+                    Transpose<double>(a, m, n, &work[0]);
+                else
+                    for (std::size_t i = 0; i < work.size(); ++i)
+                        work[i] = a[i];
+
+                double* left = wide ? v : u;
+                double* right = wide ? u : v;
+                std::vector<double> ut, vt;
+                if (left)
+                    ut.resize((std::size_t)cols * rows);
+                if (right)
+                    vt.resize((std::size_t)cols * cols);
+                if (!Detail::SvdTall(&work[0], rows, cols, s, left ? &ut[0] : 0, right ? &vt[0] : 0, degreeOfParallelism))
+                    return false;
+
+                if (left)
+                    Transpose<double>(&ut[0], cols, rows, left);
+                if (right)
+                    Transpose<double>(&vt[0], cols, cols, right);
+                return true;
+            }
+
+            /// <summary>
+            /// Number of singular values (descending, p of them) above
+            /// tolerance relative to the largest
+            /// </summary>
+            inline int SvdRank(const double* s, int p, double tolerance) {
+                if (p == 0 || s[0] == 0)
+                    return 0;
+                double threshold = s[0] * tolerance;
+                int rank = 0;
+                while (rank < p && s[rank] > threshold)
+                    ++rank;
+                return rank;
+            }
+
+            /// <summary>
+            /// Moore-Penrose pseudo-inverse X = V diag(1 / s) U^T (n x m,
+            /// row-major) from a thin SVD as produced by Svd, keeping the
+            /// leading rank singular triplets. v is overwritten with the
+            /// scaled columns; the product runs through Gemm.
+            /// </summary>
+            inline void SvdPseudoInverse(const double* u, const double* s, double* v, int m, int n, int rank, double* x,
+                                         int degreeOfParallelism) {
+                int p = m < n ? m : n;
+                for (int i = 0; i < n; ++i) {
+                    double* row = v + (long long)i * p;
+                    for (int k = 0; k < rank; ++k)
+                        row[k] /= s[k];
+                }
+                if (rank == 0) {
+                    for (long long i = 0; i < (long long)n * m; ++i)
+                        x[i] = 0;
+                    return;
+                }
+                ConstMatrixRef<double> rv = { v, n, rank, p, 1 };
+                ConstMatrixRef<double> rut = { u, rank, m, 1, p };
+                GemmParallel<double>(rv, rut, x, m, degreeOfParallelism);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "Gemm.h"
+#include "TileScheduler.h"
+
+#include <cmath>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// How a sum of many terms is accumulated, all in double:
+            /// SumNaive runs four interleaved partial sums, error growing with
+            /// n; SumKahan keeps a running compensation (Neumaier's variant) and
+            /// for double and Int32 products also the rounding error of each
+            /// product, so the result is as if computed in twice the precision;
+            /// SumPairwise adds blocks in a tree, error growing with log n at
+            /// naive speed.
+            /// </summary>
+            enum SummationMode {
+                SumNaive,
+                SumKahan,
+                SumPairwise
+            };
+
+            namespace Detail {
+                /// <summary>
+                /// Rounding error of the double product of a and b, rounded to p.
+                /// Float products are exact. Int32 products above 2^53 are not;
+                /// their error is the exact 64-bit product less p, an integer
+                /// below 2^10 in magnitude.
+                /// </summary>
+                WP_MATH_FORCEINLINE double ProductError(float, float, double) {
+                    return 0;
+                }
+
+                WP_MATH_FORCEINLINE double ProductError(double a, double b, double p) {
+                    return std::fma(a, b, -p);
+                }
+
+                WP_MATH_FORCEINLINE double ProductError(int a, int b, double p) {
+                    return (double)((long long)a * b - (long long)p);
+                }
+
+                /// <summary>
+                /// The terms x[i * incX] * y[i * incY], or x[i * incX] alone
+                /// </summary>
+                template<typename T, bool Products>
+                struct SumTerms {
+                    const T* X;
+                    long long IncX;
+                    const T* Y;
+                    long long IncY;
+
+                    WP_MATH_FORCEINLINE double Value(int i) const {
+                        return Products ? (double)X[i * IncX] * (double)Y[i * IncY] : (double)X[i * IncX];
+                    }
+
+                    /// <summary>
+                    /// Rounding error of Value(i); single terms are exact
+                    /// </summary>
+                    WP_MATH_FORCEINLINE double Error(int i, double value) const {
+                        if (!Products)
+                            return 0;
+                        return ProductError(X[i * IncX], Y[i * IncY], value);
+                    }
+                };
+
+                template<typename Terms>
+                double NaiveSum(const Terms& t, int begin, int end) {
+                    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                    int i = begin;
+                    for (; i + 4 <= end; i += 4) {
+                        s0 += t.Value(i);
+                        s1 += t.Value(i + 1);
+                        s2 += t.Value(i + 2);
+                        s3 += t.Value(i + 3);
+                    }
+                    for (; i < end; ++i)
+                        s0 += t.Value(i);
+                    return (s0 + s1) + (s2 + s3);
+                }
+
+                template<typename Terms>
+                double KahanSum(const Terms& t, int n) {
+                    double sum = 0, compensation = 0;
+                    for (int i = 0; i < n; ++i) {
+                        double v = t.Value(i);
+                        compensation += t.Error(i, v);
+                        double next = sum + v;
+                        if (std::fabs(sum) >= std::fabs(v))
+                            compensation += (sum - next) + v;
+                        else
+                            compensation += (v - next) + sum;
+                        sum = next;
+                    }
+                    return sum + compensation;
+                }
+
+                template<typename Terms>
+                double PairwiseSum(const Terms& t, int begin, int end) {
+                    if (end - begin <= 128)
+                        return NaiveSum(t, begin, end);
+                    // Split on a block boundary so the leaves stay full
+                    int half = ((end - begin) / 2 + 127) & ~127;
+                    return PairwiseSum(t, begin, begin + half) + PairwiseSum(t, begin + half, end);
+                }
+
+                template<typename Terms>
+                double Sum(const Terms& t, int n, SummationMode mode) {
+                    if (mode == SumKahan)
+                        return KahanSum(t, n);
+                    if (mode == SumPairwise)
+                        return PairwiseSum(t, 0, n);
+                    return NaiveSum(t, 0, n);
+                }
+            }
+
+            /// <summary>
+            /// Sums x[i * incX] for i in [0, n) in double
+            /// </summary>
+            template<typename T>
+            double SumStrided(const T* x, long long incX, int n, SummationMode mode) {
+                Detail::SumTerms<T, false> t = { x, incX, 0, 0 };
+                return Detail::Sum(t, n, mode);
+            }
+
+            /// <summary>
+            /// Sums x[i * incX] * y[i * incY] for i in [0, n) in double
+            /// </summary>
+            template<typename T>
+            double DotStrided(const T* x, long long incX, const T* y, long long incY, int n, SummationMode mode) {
+                Detail::SumTerms<T, true> t = { x, incX, y, incY };
+                return Detail::Sum(t, n, mode);
+            }
+
+            /// <summary>
+            /// Exact sum of n 32-bit integers
+            /// </summary>
+            inline long long SumExact(const int* x, long long incX, int n) {
+                long long sum = 0;
+                for (int i = 0; i < n; ++i)
+                    sum += x[i * incX];
+                return sum;
+            }
+
+            /// <summary>
+            /// Exact sum of n products of 32-bit integers, divided by 2^shift
+            /// and rounded to nearest (shift 16 gives the Q16.16 product of
+            /// Q16.16 operands). The 64-bit products are split into high and
+            /// low words summed separately, so nothing wraps for any n below
+            /// 2^31. Returns false when the result is outside the int range
+            /// or shift is outside [0, 32].
+            /// </summary>
+            inline bool DotExact(const int* x, long long incX, const int* y, long long incY, int n, int shift, int* result) {
+                if (shift < 0 || shift > 32)
+                    return false;
+                long long high = 0;
+                unsigned long long low = 0;
+                for (int i = 0; i < n; ++i) {
+                    long long p = (long long)x[i * incX] * y[i * incY];
+                    high += p >> 32;
+                    low += (unsigned long long)(p & 0xFFFFFFFFLL);
+                }
+                // Carry the low words' excess so the sum is high * 2^32 + low
+                // with low below 2^32; high stays below 2^62 in magnitude
+                high += (long long)(low >> 32);
+                low &= 0xFFFFFFFFULL;
+                // |value| >= 2^(63 - shift) whenever high leaves this range;
+                // inside it high * 2^(32 - shift) + low / 2^shift cannot wrap
+                if (high > 0x7FFFFFFFLL || high < -0x80000000LL)
+                    return false;
+                long long half = shift > 0 ? 1LL << (shift - 1) : 0;
+                long long value = high * (1LL << (32 - shift)) + (long long)((low + half) >> shift);
+                if (value > 0x7FFFFFFFLL || value < -0x80000000LL)
+                    return false;
+                *result = (int)value;
+                return true;
+            }
+
+            /// <summary>
+            /// Exact sum of n products of 32-bit integers divided by 2^shift,
+            /// accumulated like DotExact and rounded to double once at the end
+            /// (exactly once while the sum stays below 2^85 in magnitude).
+            /// Never overflows for n below 2^31.
+            /// </summary>
+            inline double DotExactDouble(const int* x, long long incX, const int* y, long long incY, int n, int shift) {
+                long long high = 0;
+                unsigned long long low = 0;
+                for (int i = 0; i < n; ++i) {
+                    long long p = (long long)x[i * incX] * y[i * incY];
+                    high += p >> 32;
+                    low += (unsigned long long)(p & 0xFFFFFFFFLL);
+                }
+                high += (long long)(low >> 32);
+                low &= 0xFFFFFFFFULL;
+                return std::ldexp((double)high, 32 - shift) + std::ldexp((double)low, -shift);
+            }
+
+            namespace Detail {
+                template<typename T>
+                struct AccumulatedTiles {
+                    ConstMatrixRef<T> A;
+                    const T* BT;            // B transposed, n x k contiguous
+                    T* C;
+                    long long Ldc;
+                    SummationMode Mode;
+                    int TileRows;
+
+                    static void Run(void* context, int tile, int worker) {
+                        AccumulatedTiles& t = *static_cast<AccumulatedTiles*>(context);
+                        int k = t.A.Cols, n = (int)(t.Ldc);
+                        int i0 = tile * t.TileRows;
+                        int i1 = i0 + t.TileRows < t.A.Rows ? i0 + t.TileRows : t.A.Rows;
+                        for (int i = i0; i < i1; ++i) {
+                            const T* row = t.A.Data + i * t.A.RowStride;
+                            for (int j = 0; j < n; ++j)
+                                t.C[i * t.Ldc + j] = (T)DotStrided(row, t.A.ColStride, t.BT + (long long)j * k, 1, k, t.Mode);
+                        }
+                    }
+                };
+            }
+
+            /// <summary>
+            /// Computes C = A * B with every element accumulated in double by
+            /// the given mode and rounded once into T. B is transposed into a
+            /// contiguous copy first, so each element is one unit-stride dot
+            /// product. C is row-major with ldc equal to the columns of B.
+            /// Several times slower than Gemm; use it when float storage needs
+            /// double accuracy or when long sums cancel.
+            /// </summary>
+            template<typename T>
+            void MultiplyAccumulated(const ConstMatrixRef<T>& a, const ConstMatrixRef<T>& b, T* c, SummationMode mode,
+                                     int degreeOfParallelism) {
+                int m = a.Rows, n = b.Cols, k = a.Cols;
+                if (m == 0 || n == 0)
+                    return;
+                AlignedBuffer<T> bt((std::size_t)n * k);
+                for (int j = 0; j < n; ++j)
+                    for (int p = 0; p < k; ++p)
+                        bt.Data()[(long long)j * k + p] = b.At(p, j);
+
+                Detail::AccumulatedTiles<T> t;
+                t.A = a;
+                t.BT = bt.Data();
+                t.C = c;
+                t.Ldc = n;
+                t.Mode = mode;
+                t.TileRows = 16;
+                int tiles = (m + t.TileRows - 1) / t.TileRows;
+                if (degreeOfParallelism == 1 || tiles == 1) {
+                    for (int tile = 0; tile < tiles; ++tile)
+                        Detail::AccumulatedTiles<T>::Run(&t, tile, 0);
+                    return;
+                }
+                ParallelForTiles(tiles, degreeOfParallelism, &Detail::AccumulatedTiles<T>::Run, &t);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
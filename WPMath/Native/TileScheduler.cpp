@@ -0,0 +1,4 @@
+// Compiled without /clr (see WPMath.vcxproj): std::thread and friends are not
+// available to managed translation units.
+
+#include "TileSchedulerImpl.h"
@@ -0,0 +1,56 @@
+#pragma once
+
+// This header is included from /clr code, so it must not pull in <thread>,
+// <mutex> or <atomic>. The pool itself lives in TileSchedulerImpl.h, compiled
+// as native code through TileScheduler.cpp, or included inline below when a
+// native build defines WP_MATH_HEADER_ONLY.
+
+#if defined(WP_MATH_HEADER_ONLY) && !defined(_MANAGED)
+#define WP_MATH_SCHEDULER_INLINE inline
+#else
+#define WP_MATH_SCHEDULER_INLINE
+#endif
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Processes one tile. worker is the participant slot in
+            /// [0, degreeOfParallelism) and can index per-thread scratch.
+            /// </summary>
+            typedef void (*TileFunction)(void* context, int tile, int worker);
+
+            /// <summary>
+            /// Runs function for every tile in [0, tileCount) on the shared
+            /// work-stealing pool and returns once all tiles have completed.
+            /// The calling thread participates as worker 0. A degree of 0 or
+            /// less means all hardware threads. Calls made from inside a tile,
+            /// or while another thread owns the pool, run on the caller alone.
+            /// </summary>
+            WP_MATH_SCHEDULER_INLINE void ParallelForTiles(int tileCount, int degreeOfParallelism, TileFunction function, void* context);
+
+            /// <summary>
+            /// Resolves a requested degree of parallelism to the number of
+            /// participants ParallelForTiles will actually use for tileCount tiles
+            /// </summary>
+            WP_MATH_SCHEDULER_INLINE int EffectiveParallelism(int tileCount, int degreeOfParallelism);
+
+            /// <summary>
+            /// Gets the number of hardware threads available to the process
+            /// </summary>
+            WP_MATH_SCHEDULER_INLINE int HardwareConcurrency();
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
+
+#if defined(WP_MATH_HEADER_ONLY) && !defined(_MANAGED)
+#include "TileSchedulerImpl.h"
+#endif
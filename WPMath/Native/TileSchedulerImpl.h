@@ -0,0 +1,260 @@
+#pragma once
+
+// The work-stealing pool behind TileScheduler.h. Managed translation units
+// cannot use std::thread and friends, so the DLL compiles this once, without
+// /clr, through TileScheduler.cpp. Portable native builds may instead define
+// WP_MATH_HEADER_ONLY, which makes TileScheduler.h include this file with
+// every function inline.
+
+#include "TileScheduler.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            namespace SchedulerDetail {
+                const int MaxParticipants = 64;
+
+                /// <summary>
+                /// A contiguous range of tile indices owned by one participant.
+                /// The owner takes from the front, thieves split off the back half.
+                /// </summary>
+                struct TileRange {
+                    std::mutex lock;
+                    int begin;
+                    int end;
+
+                    bool Pop(int& tile) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        if (begin >= end)
+                            return false;
+                        tile = begin++;
+                        return true;
+                    }
+
+                    bool StealHalf(int& stolenBegin, int& stolenEnd) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        int remaining = end - begin;
+                        if (remaining <= 0)
+                            return false;
+                        int take = (remaining + 1) / 2;
+                        stolenBegin = end - take;
+                        stolenEnd = end;
+                        end = stolenBegin;
+                        return true;
+                    }
+
+                    int Remaining() {
+                        std::lock_guard<std::mutex> guard(lock);
+                        return end - begin;
+                    }
+
+                    void Reset(int newBegin, int newEnd) {
+                        std::lock_guard<std::mutex> guard(lock);
+                        begin = newBegin;
+                        end = newEnd;
+                    }
+                };
+
+                struct Job {
+                    TileFunction function;
+                    void* context;
+                    int participants;
+                    TileRange ranges[MaxParticipants];
+                    std::mutex errorLock;
+                    std::exception_ptr error;
+                };
+
+                /// <summary>
+                /// Whether the calling thread is running a tile; a function
+                /// local so header-only builds share one flag per thread
+                /// </summary>
+                inline bool& InsideTile() {
+                    thread_local bool inside = false;
+                    return inside;
+                }
+
+                class Pool {
+                private:
+                    std::vector<std::thread> workers;
+                    std::mutex submitLock;
+                    std::mutex stateLock;
+                    std::condition_variable wake;
+                    std::condition_variable done;
+                    Job* job;
+                    unsigned long long generation;
+                    int running;
+
+                    static void Work(Job& job, int slot) {
+                        InsideTile() = true;
+                        try {
+                            int tile;
+                            for (;;) {
+                                while (job.ranges[slot].Pop(tile))
+                                    job.function(job.context, tile, slot);
+
+                                // Steal from the fullest victim to keep splits coarse.
+                                int victim = -1, most = 0;
+                                for (int i = 0; i < job.participants; ++i) {
+                                    if (i == slot)
+                                        continue;
+                                    int left = job.ranges[i].Remaining();
+                                    if (left > most) {
+                                        most = left;
+                                        victim = i;
+                                    }
+                                }
+                                if (victim < 0)
+                                    break;
+
+                                int b, e;
+                                if (job.ranges[victim].StealHalf(b, e))
+                                    job.ranges[slot].Reset(b, e);
+                            }
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> guard(job.errorLock);
+                            if (!job.error)
+                                job.error = std::current_exception();
+                            for (int i = 0; i < job.participants; ++i)
+                                job.ranges[i].Reset(0, 0);
+                        }
+                        InsideTile() = false;
+                    }
+
+                    void WorkerLoop(int slot) {
+                        unsigned long long seen = 0;
+                        for (;;) {
+                            Job* current;
+                            {
+                                std::unique_lock<std::mutex> guard(stateLock);
+                                wake.wait(guard, [&] { return generation != seen; });
+                                seen = generation;
+                                current = job;
+                                // The job may already be finished if this worker woke late.
+                                if (current == nullptr || slot >= current->participants)
+                                    continue;
+                                ++running;
+                            }
+
+                            Work(*current, slot);
+
+                            std::lock_guard<std::mutex> guard(stateLock);
+                            if (--running == 0)
+                                done.notify_all();
+                        }
+                    }
+
+                public:
+                    Pool() : job(nullptr), generation(0), running(0) {
+                        int count = HardwareConcurrency() - 1;
+                        if (count > MaxParticipants - 1)
+                            count = MaxParticipants - 1;
+                        for (int i = 0; i < count; ++i)
+                            workers.push_back(std::thread(&Pool::WorkerLoop, this, i + 1));
+                    }
+
+                    int Capacity() const {
+                        return (int)workers.size() + 1;
+                    }
+
+                    bool TryRun(Job& newJob) {
+                        std::unique_lock<std::mutex> owner(submitLock, std::try_to_lock);
+                        if (!owner.owns_lock())
+                            return false;
+
+                        {
+                            std::lock_guard<std::mutex> guard(stateLock);
+                            job = &newJob;
+                            ++generation;
+                        }
+                        wake.notify_all();
+
+                        Work(newJob, 0);
+
+                        // Every tile has been claimed; wait for workers still finishing theirs.
+                        std::unique_lock<std::mutex> guard(stateLock);
+                        done.wait(guard, [&] { return running == 0; });
+                        job = nullptr;
+                        return true;
+                    }
+                };
+
+                inline Pool& SharedPool() {
+                    // Deliberately never destroyed: joining threads during DLL
+                    // unload would deadlock on the loader lock.
+                    static Pool* pool = new Pool();
+                    return *pool;
+                }
+
+                inline void RunSerial(int tileCount, TileFunction function, void* context) {
+                    bool nested = InsideTile();
+                    InsideTile() = true;
+                    try {
+                        for (int tile = 0; tile < tileCount; ++tile)
+                            function(context, tile, 0);
+                    }
+                    catch (...) {
+                        InsideTile() = nested;
+                        throw;
+                    }
+                    InsideTile() = nested;
+                }
+            }
+
+            WP_MATH_SCHEDULER_INLINE int HardwareConcurrency() {
+                unsigned count = std::thread::hardware_concurrency();
+                return count == 0 ? 1 : (int)count;
+            }
+
+            WP_MATH_SCHEDULER_INLINE int EffectiveParallelism(int tileCount, int degreeOfParallelism) {
+                int limit = HardwareConcurrency();
+                if (limit > SchedulerDetail::MaxParticipants)
+                    limit = SchedulerDetail::MaxParticipants;
+                int count = degreeOfParallelism <= 0 || degreeOfParallelism > limit ? limit : degreeOfParallelism;
+                if (count > tileCount)
+                    count = tileCount;
+                return count < 1 ? 1 : count;
+            }
+
+            WP_MATH_SCHEDULER_INLINE void ParallelForTiles(int tileCount, int degreeOfParallelism, TileFunction function, void* context) {
+                if (tileCount <= 0)
+                    return;
+
+                int participants = EffectiveParallelism(tileCount, degreeOfParallelism);
+                if (participants == 1 || SchedulerDetail::InsideTile()) {
+                    SchedulerDetail::RunSerial(tileCount, function, context);
+                    return;
+                }
+
+                SchedulerDetail::Pool& pool = SchedulerDetail::SharedPool();
+                if (participants > pool.Capacity())
+                    participants = pool.Capacity();
+
+                SchedulerDetail::Job job;
+                job.function = function;
+                job.context = context;
+                job.participants = participants;
+                for (int i = 0; i < participants; ++i) {
+                    long long b = (long long)tileCount * i / participants;
+                    long long e = (long long)tileCount * (i + 1) / participants;
+                    job.ranges[i].begin = (int)b;
+                    job.ranges[i].end = (int)e;
+                }
+
+                if (!pool.TryRun(job)) {
+                    SchedulerDetail::RunSerial(tileCount, function, context);
+                    return;
+                }
+
+                if (job.error)
+                    std::rethrow_exception(job.error);
+            }
+        }
+    }
+}
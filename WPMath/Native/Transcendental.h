@@ -0,0 +1,548 @@
+#pragma once
+
+#include "Simd.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            // Vectorized sin, cos, exp, log and atan2 over Simd<T> lanes.
+            // Each function reduces its argument to a short interval with
+            // extra-precision constants (Cody-Waite), evaluates a minimax
+            // polynomial or rational approximation there and rebuilds the
+            // result with lane-wise selects, so there are no branches per
+            // element. Coefficients are Cephes' (single precision, and double
+            // precision sin, cos, exp and atan) and fdlibm's (double log).
+            // Outputs may alias inputs.
+
+            namespace Detail {
+                template<typename T, int N>
+                WP_MATH_FORCEINLINE typename Simd<T>::Vec Horner(typename Simd<T>::Vec z, const T (&c)[N]) {
+                    typedef Simd<T> V;
+                    typename V::Vec p = V::Broadcast(c[0]);
+                    for (int k = 1; k < N; ++k)
+                        p = V::MulAdd(p, z, V::Broadcast(c[k]));
+                    return p;
+                }
+
+                const double SinCoefficients64[] = {
+                    1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+                    -1.98412698295895385996E-4, 8.33333333332211858878E-3, -1.66666666666666307295E-1
+                };
+                const double CosCoefficients64[] = {
+                    -1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7,
+                    2.48015872888517045348E-5, -1.38888888888730564116E-3, 4.16666666666665929218E-2
+                };
+                const double ExpNumerator64[] = {
+                    1.26177193074810590878E-4, 3.02994407707441961300E-2, 9.99999999999999999910E-1
+                };
+                const double ExpDenominator64[] = {
+                    3.00198505138664455042E-6, 2.52448340349684104192E-3, 2.27265548208155028766E-1,
+                    2.00000000000000000009E0
+                };
+                const double LogCoefficients64[] = {
+                    1.479819860511658591e-01, 1.531383769920937332e-01, 1.818357216161805012e-01,
+                    2.222219843214978396e-01, 2.857142874366239149e-01, 3.999999999940941908e-01,
+                    6.666666666666735130e-01
+                };
+                const double AtanNumerator64[] = {
+                    -8.750608600031904122785E-1, -1.615753718733365076637E1, -7.500855792314704667340E1,
+                    -1.228866684490136173410E2, -6.485021904942025371773E1
+                };
+                const double AtanDenominator64[] = {
+                    1.0, 2.485846490142306297962E1, 1.650270098316988542046E2, 4.328810604912902668951E2,
+                    4.853903996359136964868E2, 1.945506571482613964425E2
+                };
+
+                const float SinCoefficients32[] = { -1.9515295891E-4f, 8.3321608736E-3f, -1.6666654611E-1f };
+                const float CosCoefficients32[] = { 2.443315711809948E-5f, -1.388731625493765E-3f, 4.166664568298827E-2f };
+                const float ExpCoefficients32[] = {
+                    1.9875691500E-4f, 1.3981999507E-3f, 8.3334519073E-3f, 4.1665795894E-2f, 1.6666665459E-1f,
+                    5.0000001201E-1f
+                };
+                const float LogCoefficients32[] = {
+                    7.0376836292E-2f, -1.1514610310E-1f, 1.1676998740E-1f, -1.2420140846E-1f, 1.4249322787E-1f,
+                    -1.6668057665E-1f, 2.0000714765E-1f, -2.4999993993E-1f, 3.3333331174E-1f
+                };
+                const float AtanCoefficients32[] = { 8.05374449538E-2f, -1.38776856032E-1f, 1.99777106478E-1f, -3.33329491539E-1f };
+
+                /// <summary>
+                /// Reduction constants and core approximations per element type
+                /// </summary>
+                template<typename T>
+                struct TranscendentalTraits;
+
+                template<>
+                struct TranscendentalTraits<double> {
+                    typedef Simd<double> V;
+                    typedef V::Vec Vec;
+
+                    // pi / 2 in three parts; q * the first two parts is exact for
+                    // |q| < 2^27, which covers |x| below TrigLimit
+                    static double TwoOverPi() { return 6.36619772367581343076E-1; }
+                    static double HalfPi1() { return 1.57079625129699707031E0; }
+                    static double HalfPi2() { return 7.54978941586159635336E-8; }
+                    static double HalfPi3() { return 5.39030285815811905290E-15; }
+                    static double TrigLimit() { return 1.0e8; }
+
+                    /// <summary>x - q * pi / 2</summary>
+                    static WP_MATH_FORCEINLINE Vec Reduce(Vec x, Vec q) {
+                        Vec r = V::MulAdd(q, V::Broadcast(-HalfPi1()), x);
+                        r = V::MulAdd(q, V::Broadcast(-HalfPi2()), r);
+                        return V::MulAdd(q, V::Broadcast(-HalfPi3()), r);
+                    }
+
+                    static double Log2E() { return 1.44269504088896340736E0; }
+                    static double Ln2Hi() { return 6.93145751953125E-1; }
+                    static double Ln2Lo() { return 1.42860682030941723212E-6; }
+                    static double ExpHigh() { return 7.09782712893383973096E2; }
+                    static double ExpLow() { return -7.45133219101941108420E2; }
+
+                    static double LogLn2Hi() { return 6.93147180369123816490E-1; }
+                    static double LogLn2Lo() { return 1.90821492927058770002E-10; }
+                    static double MinNormal() { return 2.2250738585072014E-308; }
+                    static double MinPositive() { return 4.9406564584124654E-324; }
+                    static double MaxFinite() { return 1.7976931348623157E308; }
+                    static double SubnormalScale() { return 18014398509481984.0; }
+                    static double SubnormalBits() { return 54.0; }
+
+                    static double TanPiOver8() { return 4.14213562373095048802E-1; }
+                    static double QuarterPiHi() { return 7.85398163397448278999E-1; }
+                    static double QuarterPiLo() { return 3.06161699786838301793E-17; }
+                    static double HalfPiHi() { return 1.57079632679489655800E0; }
+                    static double HalfPiLo() { return 6.12323399573676603587E-17; }
+                    static double PiHi() { return 3.14159265358979311600E0; }
+                    static double PiLo() { return 1.22464679914735320717E-16; }
+
+                    /// <summary>sin(r) for |r| <= pi / 4, with z = r * r</summary>
+                    static WP_MATH_FORCEINLINE Vec Sin(Vec r, Vec z) {
+                        return V::MulAdd(V::Mul(r, z), Horner(z, SinCoefficients64), r);
+                    }
+
+                    /// <summary>cos(r) for |r| <= pi / 4, with z = r * r</summary>
+                    static WP_MATH_FORCEINLINE Vec Cos(Vec z) {
+                        Vec p = V::Mul(V::Mul(z, z), Horner(z, CosCoefficients64));
+                        return V::Add(V::Sub(V::Broadcast(1.0), V::Mul(V::Broadcast(0.5), z)), p);
+                    }
+
+                    /// <summary>exp(r) for |r| <= ln(2) / 2, as 1 + 2 r P / (Q - r P)</summary>
+                    static WP_MATH_FORCEINLINE Vec Exp(Vec r) {
+                        Vec z = V::Mul(r, r);
+                        Vec p = V::Mul(r, Horner(z, ExpNumerator64));
+                        Vec q = Horner(z, ExpDenominator64);
+                        Vec e = V::Div(p, V::Sub(q, p));
+                        return V::MulAdd(V::Broadcast(2.0), e, V::Broadcast(1.0));
+                    }
+
+                    /// <summary>log(1 + f) for f in [sqrt(1/2) - 1, sqrt(2) - 1]</summary>
+                    static WP_MATH_FORCEINLINE Vec Log1p(Vec f) {
+                        Vec s = V::Div(f, V::Add(V::Broadcast(2.0), f));
+                        Vec z = V::Mul(s, s);
+                        Vec r = V::Mul(z, Horner(z, LogCoefficients64));
+                        Vec half = V::Mul(V::Mul(V::Broadcast(0.5), f), f);
+                        return V::Sub(f, V::Sub(half, V::Mul(s, V::Add(half, r))));
+                    }
+
+                    /// <summary>atan(t) for t in [-tan(pi / 8), tan(pi / 8)]</summary>
+                    static WP_MATH_FORCEINLINE Vec Atan(Vec t) {
+                        Vec z = V::Mul(t, t);
+                        Vec p = V::Div(V::Mul(z, Horner(z, AtanNumerator64)), Horner(z, AtanDenominator64));
+                        return V::MulAdd(t, p, t);
+                    }
+                };
+
+                template<>
+                struct TranscendentalTraits<float> {
+                    typedef Simd<float> V;
+                    typedef V::Vec Vec;
+
+                    // pi / 2 in four parts of at most 12 bits (SLEEF's split), so
+                    // the products with q below TrigLimit are exact
+                    static float TwoOverPi() { return 6.36619772367581343076E-1f; }
+                    static float HalfPi1() { return 1.5703125f; }
+                    static float HalfPi2() { return 4.8351287841796875E-4f; }
+                    static float HalfPi3() { return 3.13855707645416259765E-7f; }
+                    static float HalfPi4() { return 6.07710062827671038E-11f; }
+                    static float TrigLimit() { return 8192.0f; }
+
+                    /// <summary>x - q * pi / 2</summary>
+                    static WP_MATH_FORCEINLINE Vec Reduce(Vec x, Vec q) {
+                        Vec r = V::MulAdd(q, V::Broadcast(-HalfPi1()), x);
+                        r = V::MulAdd(q, V::Broadcast(-HalfPi2()), r);
+                        r = V::MulAdd(q, V::Broadcast(-HalfPi3()), r);
+                        return V::MulAdd(q, V::Broadcast(-HalfPi4()), r);
+                    }
+
+                    static float Log2E() { return 1.44269504088896341f; }
+                    static float Ln2Hi() { return 0.693359375f; }
+                    static float Ln2Lo() { return -2.12194440E-4f; }
+                    static float ExpHigh() { return 88.7228391f; }
+                    static float ExpLow() { return -103.972084f; }
+
+                    static float LogLn2Hi() { return 0.693359375f; }
+                    static float LogLn2Lo() { return -2.12194440E-4f; }
+                    static float MinNormal() { return 1.17549435E-38f; }
+                    static float MinPositive() { return 1.40129846E-45f; }
+                    static float MaxFinite() { return 3.40282347E38f; }
+                    static float SubnormalScale() { return 33554432.0f; }
+                    static float SubnormalBits() { return 25.0f; }
+
+                    static float TanPiOver8() { return 4.14213562373095048802E-1f; }
+                    static float QuarterPiHi() { return 7.85398185253143310547E-1f; }
+                    static float QuarterPiLo() { return -2.18556950e-8f; }
+                    static float HalfPiHi() { return 1.57079637050628662109E0f; }
+                    static float HalfPiLo() { return -4.37113900e-8f; }
+                    static float PiHi() { return 3.14159274101257324219E0f; }
+                    static float PiLo() { return -8.74227801e-8f; }
+
+                    static WP_MATH_FORCEINLINE Vec Sin(Vec r, Vec z) {
+                        return V::MulAdd(V::Mul(r, z), Horner(z, SinCoefficients32), r);
+                    }
+
+                    static WP_MATH_FORCEINLINE Vec Cos(Vec z) {
+                        Vec p = V::Mul(V::Mul(z, z), Horner(z, CosCoefficients32));
+                        return V::Add(V::Sub(V::Broadcast(1.0f), V::Mul(V::Broadcast(0.5f), z)), p);
+                    }
+
+                    /// <summary>exp(r) as 1 + r + r^2 P(r)</summary>
+                    static WP_MATH_FORCEINLINE Vec Exp(Vec r) {
+                        Vec p = Horner(r, ExpCoefficients32);
+                        return V::Add(V::MulAdd(V::Mul(r, r), p, r), V::Broadcast(1.0f));
+                    }
+
+                    /// <summary>log(1 + f) as f - f^2 / 2 + f^3 P(f)</summary>
+                    static WP_MATH_FORCEINLINE Vec Log1p(Vec f) {
+                        Vec z = V::Mul(f, f);
+                        Vec y = V::Mul(V::Mul(f, z), Horner(f, LogCoefficients32));
+                        y = V::Sub(y, V::Mul(V::Broadcast(0.5f), z));
+                        return V::Add(f, y);
+                    }
+
+                    static WP_MATH_FORCEINLINE Vec Atan(Vec t) {
+                        Vec z = V::Mul(t, t);
+                        return V::MulAdd(V::Mul(t, z), Horner(z, AtanCoefficients32), t);
+                    }
+                };
+
+                /// <summary>
+                /// Whole-register kernels shared by the array functions
+                /// </summary>
+                template<typename T>
+                struct Transcendental {
+                    typedef Simd<T> V;
+                    typedef typename V::Vec Vec;
+                    typedef typename V::Mask Mask;
+                    typedef TranscendentalTraits<T> C;
+
+                    static WP_MATH_FORCEINLINE Vec Negate(Mask m, Vec v) {
+                        return V::Select(m, V::Sub(V::Zero(), v), v);
+                    }
+
+                    /// <summary>
+                    /// sin and cos for |x| <= C::TrigLimit(); larger arguments
+                    /// lose the reduction and must be handled by the caller
+                    /// </summary>
+                    static WP_MATH_FORCEINLINE void SinCos(Vec x, Vec& s, Vec& c) {
+                        Vec q = V::Round(V::Mul(x, V::Broadcast(C::TwoOverPi())));
+                        Vec r = C::Reduce(x, q);
+                        Vec z = V::Mul(r, r);
+                        Vec sr = C::Sin(r, z);
+                        Vec cr = C::Cos(z);
+
+                        // Quadrant m = q mod 4 and its parity, in floating point
+                        Vec k = V::Round(V::MulAdd(q, V::Broadcast(T(0.25)), V::Broadcast(T(-0.375))));
+                        Vec m = V::MulAdd(k, V::Broadcast(T(-4)), q);
+                        Vec half = V::Round(V::MulAdd(m, V::Broadcast(T(0.5)), V::Broadcast(T(-0.25))));
+                        Vec odd = V::MulAdd(half, V::Broadcast(T(-2)), m);
+
+                        Mask swap = V::Less(V::Broadcast(T(0.5)), odd);
+                        Vec sv = V::Select(swap, cr, sr);
+                        Vec cv = V::Select(swap, sr, cr);
+                        s = Negate(V::Less(V::Broadcast(T(1.5)), m), sv);
+                        c = Negate(V::Less(V::Abs(V::Sub(m, V::Broadcast(T(1.5)))), V::Broadcast(T(1))), cv);
+                    }
+
+                    static WP_MATH_FORCEINLINE Vec Exp(Vec x) {
+                        // NaN is the second operand so it survives the clamp
+                        Vec xc = V::Min(V::Broadcast(C::ExpHigh()), V::Max(V::Broadcast(C::ExpLow()), x));
+                        Vec k = V::Round(V::Mul(xc, V::Broadcast(C::Log2E())));
+                        Vec r = V::MulAdd(k, V::Broadcast(-C::Ln2Hi()), xc);
+                        r = V::MulAdd(k, V::Broadcast(-C::Ln2Lo()), r);
+                        Vec p = C::Exp(r);
+
+                        // 2^k in two halves so results near overflow and in
+                        // the subnormal range scale correctly
+                        Vec a = V::Round(V::Mul(k, V::Broadcast(T(0.5))));
+                        Vec b = V::Sub(k, a);
+                        Vec e = V::Mul(V::Mul(p, V::Pow2(a)), V::Pow2(b));
+
+                        e = V::Select(V::Less(V::Broadcast(C::ExpHigh()), x), V::Broadcast(std::numeric_limits<T>::infinity()), e);
+                        return V::Select(V::Less(x, V::Broadcast(C::ExpLow())), V::Zero(), e);
+                    }
+
+                    static WP_MATH_FORCEINLINE Vec Log(Vec x) {
+                        Mask tiny = V::Less(x, V::Broadcast(C::MinNormal()));
+                        Vec xs = V::Select(tiny, V::Mul(x, V::Broadcast(C::SubnormalScale())), x);
+                        Vec e;
+                        Vec m = V::Frexp(xs, e);
+                        e = V::Sub(e, V::Select(tiny, V::Broadcast(C::SubnormalBits()), V::Zero()));
+
+                        // Centre the mantissa on 1: [sqrt(1/2), sqrt(2))
+                        Mask big = V::Less(V::Broadcast(T(1.41421356237309504880)), m);
+                        m = V::Select(big, V::Mul(m, V::Broadcast(T(0.5))), m);
+                        e = V::Select(big, V::Add(e, V::Broadcast(T(1))), e);
+
+                        Vec y = C::Log1p(V::Sub(m, V::Broadcast(T(1))));
+                        y = V::MulAdd(e, V::Broadcast(C::LogLn2Lo()), y);
+                        y = V::MulAdd(e, V::Broadcast(C::LogLn2Hi()), y);
+
+                        // x - x is NaN for NaN and infinite x, zero otherwise
+                        y = V::Add(y, V::Sub(xs, xs));
+                        y = V::Select(V::Less(V::Broadcast(C::MaxFinite()), x), x, y);
+                        y = V::Select(V::Less(x, V::Broadcast(C::MinPositive())),
+                                      V::Broadcast(-std::numeric_limits<T>::infinity()), y);
+                        return V::Select(V::Less(x, V::Zero()), V::Broadcast(std::numeric_limits<T>::quiet_NaN()), y);
+                    }
+
+                    static WP_MATH_FORCEINLINE Vec Atan2(Vec y, Vec x) {
+                        Vec ax = V::Abs(x), ay = V::Abs(y);
+                        Mask swap = V::Less(ax, ay);
+                        Vec num = V::Select(swap, ax, ay);
+                        Vec den = V::Select(swap, ay, ax);
+                        Vec t = V::Div(num, den);
+                        t = V::Select(V::Less(den, V::Broadcast(C::MinPositive())), V::Zero(), t);
+
+                        // atan(t) = pi / 4 + atan((t - 1) / (t + 1)) above tan(pi / 8)
+                        Mask reduce = V::Less(V::Broadcast(C::TanPiOver8()), t);
+                        Vec one = V::Broadcast(T(1));
+                        Vec tr = V::Select(reduce, V::Div(V::Sub(t, one), V::Add(t, one)), t);
+                        Vec a = C::Atan(tr);
+                        a = V::Select(reduce, V::Add(V::Broadcast(C::QuarterPiHi()), V::Add(a, V::Broadcast(C::QuarterPiLo()))), a);
+
+                        a = V::Select(swap, V::Add(V::Sub(V::Broadcast(C::HalfPiHi()), a), V::Broadcast(C::HalfPiLo())), a);
+                        a = V::Select(V::Less(x, V::Zero()), V::Add(V::Sub(V::Broadcast(C::PiHi()), a), V::Broadcast(C::PiLo())), a);
+                        return Negate(V::Less(y, V::Zero()), a);
+                    }
+
+                    struct ExpOp {
+                        static WP_MATH_FORCEINLINE Vec Apply(Vec x) { return Exp(x); }
+                    };
+
+                    struct LogOp {
+                        static WP_MATH_FORCEINLINE Vec Apply(Vec x) { return Log(x); }
+                    };
+                };
+
+                /// <summary>
+                /// y = Op(x) register by register; the tail runs through a
+                /// zero-padded register so every element sees the same code
+                /// </summary>
+                template<typename T, typename Op>
+                void MapUnary(const T* x, T* y, int count) {
+                    typedef Simd<T> V;
+                    int i = 0;
+                    for (; i + V::Width <= count; i += V::Width)
+                        V::Store(y + i, Op::Apply(V::Load(x + i)));
+                    if (i < count) {
+                        T in[V::Width], out[V::Width];
+                        for (int k = 0; k < V::Width; ++k)
+                            in[k] = i + k < count ? x[i + k] : T(0);
+                        V::Store(out, Op::Apply(V::Load(in)));
+                        for (int k = 0; i + k < count; ++k)
+                            y[i + k] = out[k];
+                    }
+                }
+
+                /// <summary>
+                /// Elements per range check of the trigonometric kernels
+                /// </summary>
+                const int TrigChunk = 256;
+
+                /// <summary>
+                /// True when every element of the chunk is within the
+                /// reduction range (false for NaN)
+                /// </summary>
+                template<typename T>
+                bool WithinTrigLimit(const T* x, int count) {
+                    typedef Simd<T> V;
+                    typename V::Vec largest = V::Zero();
+                    int i = 0;
+                    for (; i + V::Width <= count; i += V::Width)
+                        largest = V::Max(largest, V::Abs(V::Load(x + i)));
+                    T lanes[V::Width];
+                    V::Store(lanes, largest);
+                    T limit = TranscendentalTraits<T>::TrigLimit();
+                    for (int k = 0; k < V::Width; ++k)
+                        if (!(lanes[k] <= limit))
+                            return false;
+                    for (; i < count; ++i)
+                        if (!(std::fabs(x[i]) <= limit))
+                            return false;
+                    return true;
+                }
+
+                /// <summary>
+                /// sin and/or cos of one chunk; either output may be null
+                /// </summary>
+                template<typename T>
+                void SinCosChunk(const T* x, T* s, T* c, int count) {
+                    typedef Simd<T> V;
+                    typedef Transcendental<T> K;
+                    if (!WithinTrigLimit(x, count)) {
+                        // Huge, infinite or NaN arguments: exact reduction in the CRT
+                        for (int i = 0; i < count; ++i) {
+                            T v = x[i];
+                            if (s)
+                                s[i] = std::sin(v);
+                            if (c)
+                                c[i] = std::cos(v);
+                        }
+                        return;
+                    }
+
+                    int i = 0;
+                    typename V::Vec vs, vc;
+                    for (; i + V::Width <= count; i += V::Width) {
+                        K::SinCos(V::Load(x + i), vs, vc);
+                        if (s)
+                            V::Store(s + i, vs);
+                        if (c)
+                            V::Store(c + i, vc);
+                    }
+                    if (i < count) {
+                        T in[V::Width], os[V::Width], oc[V::Width];
+                        for (int k = 0; k < V::Width; ++k)
+                            in[k] = i + k < count ? x[i + k] : T(0);
+                        K::SinCos(V::Load(in), vs, vc);
+                        V::Store(os, vs);
+                        V::Store(oc, vc);
+                        for (int k = 0; i + k < count; ++k) {
+                            if (s)
+                                s[i + k] = os[k];
+                            if (c)
+                                c[i + k] = oc[k];
+                        }
+                    }
+                }
+            }
+
+            /// <summary>
+            /// s[i] = sin(x[i]) and c[i] = cos(x[i]); either output may be null.
+            /// Max error 2 ulp (double) and 3 ulp (float) for |x| up to 1e8
+            /// (double) or 8192 (float); larger arguments fall back to the CRT.
+            /// </summary>
+            template<typename T>
+            void VectorSinCos(const T* x, T* s, T* c, int count) {
+                for (int i = 0; i < count; i += Detail::TrigChunk) {
+                    int n = count - i < Detail::TrigChunk ? count - i : Detail::TrigChunk;
+                    Detail::SinCosChunk(x + i, s ? s + i : 0, c ? c + i : 0, n);
+                }
+            }
+
+            /// <summary>
+            /// y[i] = exp(x[i]). Max error 2 ulp (double) and 1.5 ulp (float);
+            /// overflow gives +inf and results below the smallest subnormal 0.
+            /// </summary>
+            template<typename T>
+            void VectorExp(const T* x, T* y, int count) {
+                Detail::MapUnary<T, typename Detail::Transcendental<T>::ExpOp>(x, y, count);
+            }
+
+            /// <summary>
+            /// y[i] = log(x[i]). Max error 1.5 ulp (double) and 1 ulp (float);
+            /// log(0) is -inf and negative arguments give NaN.
+            /// </summary>
+            template<typename T>
+            void VectorLog(const T* x, T* y, int count) {
+                Detail::MapUnary<T, typename Detail::Transcendental<T>::LogOp>(x, y, count);
+            }
+
+            /// <summary>
+            /// r[i] = atan2(y[i], x[i]). Max error 3 ulp. Signed zeros are
+            /// treated as +0, and two infinite arguments give NaN.
+            /// </summary>
+            template<typename T>
+            void VectorAtan2(const T* y, const T* x, T* r, int count) {
+                typedef Simd<T> V;
+                typedef Detail::Transcendental<T> K;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width)
+                    V::Store(r + i, K::Atan2(V::Load(y + i), V::Load(x + i)));
+                if (i < count) {
+                    T iy[V::Width], ix[V::Width], out[V::Width];
+                    for (int k = 0; k < V::Width; ++k) {
+                        iy[k] = i + k < count ? y[i + k] : T(0);
+                        ix[k] = i + k < count ? x[i + k] : T(1);
+                    }
+                    V::Store(out, K::Atan2(V::Load(iy), V::Load(ix)));
+                    for (int k = 0; i + k < count; ++k)
+                        r[i + k] = out[k];
+                }
+            }
+
+            /// <summary>
+            /// Fills a sine table for the lookup kernels: size + size / 4 + 1
+            /// samples of sin over [0, 2 pi + pi / 2], so cosine reads the same
+            /// table a quarter period later without wrapping. size must be a
+            /// power of two.
+            /// </summary>
+            template<typename T>
+            void BuildSineTable(T* table, int size) {
+                const double step = 6.28318530717958647692 / size;
+                int length = size + size / 4 + 1;
+                for (int i = 0; i < length; ++i)
+                    table[i] = (T)std::sin(i * step);
+            }
+
+            /// <summary>
+            /// Linearly interpolated table lookup of sin and/or cos; either
+            /// output may be null. Max absolute error (2 pi / size)^2 / 8 plus
+            /// rounding, for |x| below about 1e6.
+            /// </summary>
+            template<typename T>
+            void TableSinCos(const T* table, int size, const T* x, T* s, T* c, int count) {
+                const double scale = size / 6.28318530717958647692;
+                const int mask = size - 1, quarter = size / 4;
+                for (int i = 0; i < count; ++i) {
+                    double t = x[i] * scale;
+                    double floor = std::floor(t);
+                    T f = (T)(t - floor);
+                    int k = (int)((long long)floor & mask);
+                    if (s)
+                        s[i] = table[k] + f * (table[k + 1] - table[k]);
+                    if (c) {
+                        int j = k + quarter;
+                        c[i] = table[j] + f * (table[j + 1] - table[j]);
+                    }
+                }
+            }
+
+            /// <summary>
+            /// r = exp(a) for count split complex values:
+            /// exp(ar) * (cos(ai), sin(ai))
+            /// </summary>
+            inline void SplitExp(const double* ar, const double* ai, double* rr, double* ri, int count) {
+                double e[Detail::TrigChunk], s[Detail::TrigChunk], c[Detail::TrigChunk];
+                for (int i = 0; i < count; i += Detail::TrigChunk) {
+                    int n = count - i < Detail::TrigChunk ? count - i : Detail::TrigChunk;
+                    VectorExp(ar + i, e, n);
+                    Detail::SinCosChunk(ai + i, s, c, n);
+                    for (int k = 0; k < n; ++k) {
+                        rr[i + k] = e[k] * c[k];
+                        ri[i + k] = e[k] * s[k];
+                    }
+                }
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
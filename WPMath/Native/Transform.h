@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Simd.h"
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            // Bulk point transforms for the fixed-size value types. Matrices are
+            // row-major and use the row-vector convention (p' = p * M), so the
+            // translation sits in the last row. Points are packed doubles
+            // (x, y) or (x, y, z); src and dst may be the same buffer.
+
+            /// <summary>
+            /// Applies the 2D affine transform m (3 x 3) to count points
+            /// </summary>
+            inline void TransformPoints2(const double* m, const double* src, double* dst, int count) {
+                double m11 = m[0], m12 = m[1], m21 = m[3], m22 = m[4], m31 = m[6], m32 = m[7];
+                for (int i = 0; i < count; ++i) {
+                    double x = src[2 * i], y = src[2 * i + 1];
+                    dst[2 * i] = x * m11 + y * m21 + m31;
+                    dst[2 * i + 1] = x * m12 + y * m22 + m32;
+                }
+            }
+
+            /// <summary>
+            /// Applies the 3D affine transform m (4 x 4) to count points; the
+            /// fourth column is ignored
+            /// </summary>
+            inline void TransformPoints3(const double* m, const double* src, double* dst, int count) {
+                int i = 0;
+#if defined(WP_MATH_AVX2)
+                // One row of m fills a register, so each point is three
+                // broadcasts and three fused multiply-adds. The 4th lane is
+                // dropped on store.
+                typedef Simd<double> V;
+                V::Vec r1 = V::Load(m), r2 = V::Load(m + 4), r3 = V::Load(m + 8), r4 = V::Load(m + 12);
+                for (; i < count; ++i) {
+                    const double* p = src + 3 * i;
+                    V::Vec v = V::MulAdd(V::Broadcast(p[0]), r1,
+                               V::MulAdd(V::Broadcast(p[1]), r2,
+                               V::MulAdd(V::Broadcast(p[2]), r3, r4)));
+                    double* q = dst + 3 * i;
+                    _mm_storeu_pd(q, _mm256_castpd256_pd128(v));
+                    _mm_store_sd(q + 2, _mm256_extractf128_pd(v, 1));
+                }
+#endif
+                for (; i < count; ++i) {
+                    double x = src[3 * i], y = src[3 * i + 1], z = src[3 * i + 2];
+                    dst[3 * i] = x * m[0] + y * m[4] + z * m[8] + m[12];
+                    dst[3 * i + 1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+                    dst[3 * i + 2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+                }
+            }
+
+            /// <summary>
+            /// Applies the 4 x 4 transform m to count homogeneous (x, y, z, w) points
+            /// </summary>
+            inline void TransformPoints4(const double* m, const double* src, double* dst, int count) {
+                typedef Simd<double> V;
+                // Each output is a linear combination of the rows of m,
+                // computed Width lanes at a time.
+                for (int i = 0; i < count; ++i) {
+                    const double* p = src + 4 * i;
+                    double x = p[0], y = p[1], z = p[2], w = p[3];
+                    double* q = dst + 4 * i;
+                    for (int j = 0; j < 4; j += V::Width) {
+                        V::Vec v = V::Mul(V::Broadcast(x), V::Load(m + j));
+                        v = V::MulAdd(V::Broadcast(y), V::Load(m + 4 + j), v);
+                        v = V::MulAdd(V::Broadcast(z), V::Load(m + 8 + j), v);
+                        V::Store(q + j, V::MulAdd(V::Broadcast(w), V::Load(m + 12 + j), v));
+                    }
+                }
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Platform.h"
+#include "TileScheduler.h"
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            /// <summary>
+            /// Edge of the square blocks copied by the out-of-place transpose.
+            /// Two 32 x 32 double blocks fit comfortably in L1.
+            /// </summary>
+            const int TransposeBlock = 32;
+
+            namespace Detail {
+                template<typename T>
+                void TransposeRows(const T* WP_MATH_RESTRICT src, int rows, int cols, T* WP_MATH_RESTRICT dst,
+                                   int i0, int i1) {
+                    for (int ib = i0; ib < i1; ib += TransposeBlock) {
+                        int ie = ib + TransposeBlock < i1 ? ib + TransposeBlock : i1;
+                        for (int jb = 0; jb < cols; jb += TransposeBlock) {
+                            int je = jb + TransposeBlock < cols ? jb + TransposeBlock : cols;
+                            for (int i = ib; i < ie; ++i) {
+                                const T* row = src + (long long)i * cols;
+                                for (int j = jb; j < je; ++j)
+                                    dst[(long long)j * rows + i] = row[j];
+                            }
+                        }
+                    }
+                }
+
+                template<typename T>
+                struct TransposeTiles {
+                    const T* Src;
+                    T* Dst;
+                    int Rows;
+                    int Cols;
+                    int TileRows;
+
+                    static void Run(void* context, int tile, int) {
+                        TransposeTiles& t = *static_cast<TransposeTiles*>(context);
+                        int i0 = tile * t.TileRows;
+                        int i1 = i0 + t.TileRows < t.Rows ? i0 + t.TileRows : t.Rows;
+                        TransposeRows(t.Src, t.Rows, t.Cols, t.Dst, i0, i1);
+                    }
+                };
+
+                /// <summary>
+                /// Swaps the block at (r0, c0) of size rows x cols with the
+                /// transpose of the mirrored block at (c0, r0), halving the larger
+                /// side until the pair fits in cache
+                /// </summary>
+                template<typename T>
+                void TransposeSwap(T* a, long long n, int r0, int c0, int rows, int cols) {
+                    if (rows <= TransposeBlock && cols <= TransposeBlock) {
+                        for (int i = r0; i < r0 + rows; ++i) {
+                            T* row = a + i * n;
+                            for (int j = c0; j < c0 + cols; ++j) {
+                                T t = row[j];
+                                row[j] = a[j * n + i];
+                                a[j * n + i] = t;
+                            }
+                        }
+                    }
+                    else if (rows >= cols) {
+                        int h = rows / 2;
+                        TransposeSwap(a, n, r0, c0, h, cols);
+                        TransposeSwap(a, n, r0 + h, c0, rows - h, cols);
+                    }
+                    else {
+                        int h = cols / 2;
+                        TransposeSwap(a, n, r0, c0, rows, h);
+                        TransposeSwap(a, n, r0, c0 + h, rows, cols - h);
+                    }
+                }
+
+                template<typename T>
+                void TransposeDiagonal(T* a, long long n, int d0, int size) {
+                    if (size <= TransposeBlock) {
+                        for (int i = d0; i < d0 + size; ++i)
+                            for (int j = i + 1; j < d0 + size; ++j) {
+                                T t = a[i * n + j];
+                                a[i * n + j] = a[j * n + i];
+                                a[j * n + i] = t;
+                            }
+                        return;
+                    }
+                    int h = size / 2;
+                    TransposeDiagonal(a, n, d0, h);
+                    TransposeDiagonal(a, n, d0 + h, size - h);
+                    TransposeSwap(a, n, d0 + h, d0, size - h, h);
+                }
+            }
+
+            /// <summary>
+            /// Transposes the row-major n x n matrix a in place. Recursively
+            /// splits into diagonal and mirrored off-diagonal blocks, so it is
+            /// cache-oblivious and needs no scratch memory.
+            /// </summary>
+            template<typename T>
+            void TransposeInPlace(T* a, int n) {
+                Detail::TransposeDiagonal(a, (long long)n, 0, n);
+            }
+
+            /// <summary>
+            /// Writes the transpose of the row-major rows x cols matrix src into
+            /// dst (cols x rows), block by block so both sides stay cache resident
+            /// </summary>
+            template<typename T>
+            void Transpose(const T* src, int rows, int cols, T* dst) {
+                Detail::TransposeRows(src, rows, cols, dst, 0, rows);
+            }
+
+            /// <summary>
+            /// Out-of-place transpose with bands of source rows distributed over
+            /// the work-stealing pool
+            /// </summary>
+            template<typename T>
+            void TransposeParallel(const T* src, int rows, int cols, T* dst, int degreeOfParallelism) {
+                int tileRows = 4 * TransposeBlock;
+                Detail::TransposeTiles<T> tiles = { src, dst, rows, cols, tileRows };
+                ParallelForTiles((rows + tileRows - 1) / tileRows, degreeOfParallelism,
+                                 &Detail::TransposeTiles<T>::Run, &tiles);
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Simd.h"
+
+#if defined(_MANAGED)
+#pragma managed(push, off)
+#endif
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Native {
+            // Kernels over structure-of-arrays point sets: component k of point i
+            // lives at xk[i]. Each loop handles Simd<T>::Width points per step and
+            // finishes the tail with the scalar fallback, so callers need no
+            // padding or alignment.
+
+            /// <summary>
+            /// result[i] = a[i] . b[i] for 2D points
+            /// </summary>
+            template<typename T>
+            void BatchDot(const T* ax, const T* ay, const T* bx, const T* by, T* result, int count) {
+                typedef Simd<T> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    typename V::Vec d = V::Mul(V::Load(ax + i), V::Load(bx + i));
+                    V::Store(result + i, V::MulAdd(V::Load(ay + i), V::Load(by + i), d));
+                }
+                for (; i < count; ++i)
+                    result[i] = ax[i] * bx[i] + ay[i] * by[i];
+            }
+
+            /// <summary>
+            /// result[i] = a[i] . b[i] for 3D points
+            /// </summary>
+            template<typename T>
+            void BatchDot(const T* ax, const T* ay, const T* az, const T* bx, const T* by, const T* bz,
+                          T* result, int count) {
+                typedef Simd<T> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    typename V::Vec d = V::Mul(V::Load(ax + i), V::Load(bx + i));
+                    d = V::MulAdd(V::Load(ay + i), V::Load(by + i), d);
+                    V::Store(result + i, V::MulAdd(V::Load(az + i), V::Load(bz + i), d));
+                }
+                for (; i < count; ++i)
+                    result[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+            }
+
+            /// <summary>
+            /// r[i] = a[i] x b[i] for 3D points. The outputs may alias either input.
+            /// </summary>
+            template<typename T>
+            void BatchCross(const T* ax, const T* ay, const T* az, const T* bx, const T* by, const T* bz,
+                            T* rx, T* ry, T* rz, int count) {
+                typedef Simd<T> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    typename V::Vec x1 = V::Load(ax + i), y1 = V::Load(ay + i), z1 = V::Load(az + i);
+                    typename V::Vec x2 = V::Load(bx + i), y2 = V::Load(by + i), z2 = V::Load(bz + i);
+                    V::Store(rx + i, V::Sub(V::Mul(y1, z2), V::Mul(z1, y2)));
+                    V::Store(ry + i, V::Sub(V::Mul(z1, x2), V::Mul(x1, z2)));
+                    V::Store(rz + i, V::Sub(V::Mul(x1, y2), V::Mul(y1, x2)));
+                }
+                for (; i < count; ++i) {
+                    T x1 = ax[i], y1 = ay[i], z1 = az[i];
+                    T x2 = bx[i], y2 = by[i], z2 = bz[i];
+                    rx[i] = y1 * z2 - z1 * y2;
+                    ry[i] = z1 * x2 - x1 * z2;
+                    rz[i] = x1 * y2 - y1 * x2;
+                }
+            }
+
+            /// <summary>
+            /// result[i] = |a[i] - b[i]| for 2D points
+            /// </summary>
+            template<typename T>
+            void BatchDistance(const T* ax, const T* ay, const T* bx, const T* by, T* result, int count) {
+                typedef Simd<T> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    typename V::Vec dx = V::Sub(V::Load(ax + i), V::Load(bx + i));
+                    typename V::Vec dy = V::Sub(V::Load(ay + i), V::Load(by + i));
+                    V::Store(result + i, V::Sqrt(V::MulAdd(dy, dy, V::Mul(dx, dx))));
+                }
+                for (; i < count; ++i) {
+                    T dx = ax[i] - bx[i], dy = ay[i] - by[i];
+                    result[i] = std::sqrt(dx * dx + dy * dy);
+                }
+            }
+
+            /// <summary>
+            /// result[i] = |a[i] - b[i]| for 3D points
+            /// </summary>
+            template<typename T>
+            void BatchDistance(const T* ax, const T* ay, const T* az, const T* bx, const T* by, const T* bz,
+                               T* result, int count) {
+                typedef Simd<T> V;
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    typename V::Vec dx = V::Sub(V::Load(ax + i), V::Load(bx + i));
+                    typename V::Vec dy = V::Sub(V::Load(ay + i), V::Load(by + i));
+                    typename V::Vec dz = V::Sub(V::Load(az + i), V::Load(bz + i));
+                    typename V::Vec s = V::MulAdd(dy, dy, V::Mul(dx, dx));
+                    V::Store(result + i, V::Sqrt(V::MulAdd(dz, dz, s)));
+                }
+                for (; i < count; ++i) {
+                    T dx = ax[i] - bx[i], dy = ay[i] - by[i], dz = az[i] - bz[i];
+                    result[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+                }
+            }
+
+            /// <summary>
+            /// Writes the distance from every point of a (aCount) to every point
+            /// of b (bCount) into the row-major aCount x bCount matrix result.
+            /// Pass null az and bz for 2D points.
+            /// </summary>
+            template<typename T>
+            void PairwiseDistances(const T* ax, const T* ay, const T* az, int aCount,
+                                   const T* bx, const T* by, const T* bz, int bCount, T* result) {
+                typedef Simd<T> V;
+                for (int i = 0; i < aCount; ++i) {
+                    T* row = result + (long long)i * bCount;
+                    typename V::Vec px = V::Broadcast(ax[i]), py = V::Broadcast(ay[i]);
+                    typename V::Vec pz = V::Broadcast(az ? az[i] : T());
+                    int j = 0;
+                    for (; j + V::Width <= bCount; j += V::Width) {
+                        typename V::Vec dx = V::Sub(px, V::Load(bx + j));
+                        typename V::Vec dy = V::Sub(py, V::Load(by + j));
+                        typename V::Vec s = V::MulAdd(dy, dy, V::Mul(dx, dx));
+                        if (az) {
+                            typename V::Vec dz = V::Sub(pz, V::Load(bz + j));
+                            s = V::MulAdd(dz, dz, s);
+                        }
+                        V::Store(row + j, V::Sqrt(s));
+                    }
+                    for (; j < bCount; ++j) {
+                        T dx = ax[i] - bx[j], dy = ay[i] - by[j];
+                        T s = dx * dx + dy * dy;
+                        if (az) {
+                            T dz = az[i] - bz[j];
+                            s += dz * dz;
+                        }
+                        row[j] = std::sqrt(s);
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Scales every point to unit length. As in Vector2.Normalize, a point
+            /// whose squared length is zero, including one so short that it
+            /// underflows, stays zero instead of becoming NaN. Pass null z for
+            /// 2D points; the outputs may be the inputs for an in-place normalize.
+            /// </summary>
+            template<typename T>
+            void BatchNormalize(const T* x, const T* y, const T* z, T* rx, T* ry, T* rz, int count) {
+                typedef Simd<T> V;
+                typename V::Vec zero = V::Zero();
+                typename V::Vec one = V::Broadcast(T(1));
+                int i = 0;
+                for (; i + V::Width <= count; i += V::Width) {
+                    typename V::Vec vx = V::Load(x + i), vy = V::Load(y + i);
+                    typename V::Vec s = V::MulAdd(vy, vy, V::Mul(vx, vx));
+                    typename V::Vec vz = V::Zero();
+                    if (z) {
+                        vz = V::Load(z + i);
+                        s = V::MulAdd(vz, vz, s);
+                    }
+                    // A zero length gives an infinite reciprocal; select zero instead
+                    typename V::Vec inv = V::Select(V::Less(zero, s), V::Div(one, V::Sqrt(s)), zero);
+                    V::Store(rx + i, V::Mul(vx, inv));
+                    V::Store(ry + i, V::Mul(vy, inv));
+                    if (z)
+                        V::Store(rz + i, V::Mul(vz, inv));
+                }
+                for (; i < count; ++i) {
+                    T vz = z ? z[i] : T();
+                    T s = x[i] * x[i] + y[i] * y[i] + vz * vz;
+                    T inv = s > 0 ? T(1) / std::sqrt(s) : T();
+                    rx[i] = x[i] * inv;
+                    ry[i] = y[i] * inv;
+                    if (z)
+                        rz[i] = vz * inv;
+                }
+            }
+        }
+    }
+}
+
+#if defined(_MANAGED)
+#pragma managed(pop)
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+// Every numeric kernel behind the managed WPMath types, as portable C++11 with
+// no .NET dependency: GEMM, transposes, factorizations, eigen and singular
+// value decompositions, summation, sparse and iterative solvers, FFT, complex
+// and vector batches, transcendentals, statistics moments and 2D geometry.
+// The managed classes in Core, Geometry and Statistics pin their storage and
+// call these directly.
+//
+// Outside the DLL, the headers build with any C++11 compiler (GCC, Clang,
+// MSVC); pass -mavx2 -mfma or /arch:AVX2 for the wide SIMD paths. Either
+// compile TileScheduler.cpp alongside or define WP_MATH_HEADER_ONLY before
+// including this header to get the thread pool inline as well.
+
+#include "Platform.h"
+#include "Simd.h"
+#include "TileScheduler.h"
+
+#include "AabbTree.h"
+#include "ComplexKernels.h"
+#include "Expression.h"
+#include "Factorization.h"
+#include "Fft.h"
+#include "Gemm.h"
+#include "Iterative.h"
+#include "Moments.h"
+#include "PathGeometry.h"
+#include "Sparse.h"
+#include "Spectral.h"
+#include "Summation.h"
+#include "Transcendental.h"
+#include "Transform.h"
+#include "Transpose.h"
+#include "VectorBatch.h"
@@ -0,0 +1,506 @@
+#pragma once
+
+#include "../Native/Iterative.h"
+#include "../Core/SparseMatrix.h"
+#include "../Core/Vector.h"
+#include "Preconditioners.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Receives the relative residual ||b - A x|| / ||b|| after every
+        /// iteration. Return false to stop the solve early.
+        /// </summary>
+        public delegate bool SolverProgress(int iteration, double residual);
+
+        /// <summary>
+        /// Outcome of an iterative solve
+        /// </summary>
+        public value struct SolverResult {
+        private:
+            bool converged;
+            int iterations;
+            double residual;
+
+        public:
+            SolverResult(bool converged, int iterations, double residual) {
+                this->converged = converged;
+                this->iterations = iterations;
+                this->residual = residual;
+            }
+
+            /// <summary>
+            /// Gets whether the residual reached the tolerance
+            /// </summary>
+            property bool Converged {
+                bool get() { return converged; }
+            }
+
+            /// <summary>
+            /// Gets the number of iterations performed
+            /// </summary>
+            property int Iterations {
+                int get() { return iterations; }
+            }
+
+            /// <summary>
+            /// Gets the final relative residual ||b - A x|| / ||b||
+            /// </summary>
+            property double Residual {
+                double get() { return residual; }
+            }
+        };
+
+        /// <summary>
+        /// Base class of the Krylov solvers for sparse systems A x = b. The
+        /// vector passed as x is the starting guess, so re-solving a slowly
+        /// changing system from the previous solution (a warm start) usually
+        /// takes a handful of iterations. Work vectors are kept between solves
+        /// of the same size, so repeated solves do not allocate. A solver
+        /// instance is not thread-safe.
+        /// </summary>
+        public ref class IterativeSolver abstract {
+        private:
+            double tolerance;
+            int maxIterations;
+            WindowPlus::Math::Preconditioner^ preconditioner;
+            SolverProgress^ progress;
+            array<Vector<double>^>^ workspace;
+
+        protected:
+            IterativeSolver() {
+                tolerance = 1e-8;
+                maxIterations = 1000;
+                workspace = gcnew array<Vector<double>^>(0);
+            }
+
+            /// <summary>
+            /// Gets work vector index of size n, reusing it across solves
+            /// </summary>
+            Vector<double>^ Workspace(int index, int n) {
+                if (index >= workspace->Length)
+                    Array::Resize(workspace, index + 1);
+                if (workspace[index] == nullptr || workspace[index]->Size != n)
+                    workspace[index] = gcnew Vector<double>(n);
+                return workspace[index];
+            }
+
+            /// <summary>
+            /// z = M^-1 r, or a copy of r without a preconditioner
+            /// </summary>
+            void Precondition(Vector<double>^ r, Vector<double>^ z) {
+                if (preconditioner != nullptr)
+                    preconditioner->Apply(r, z);
+                else
+                    Array::Copy(r->Elements, z->Elements, r->Size);
+            }
+
+            /// <summary>
+            /// Reports progress; returns false when the callback asked to stop
+            /// </summary>
+            bool Report(int iteration, double residual) {
+                return progress == nullptr || progress(iteration, residual);
+            }
+
+            /// <summary>
+            /// r = b - A x
+            /// </summary>
+            static void Residual(CsrMatrix<double>^ a, Vector<double>^ b, Vector<double>^ x, Vector<double>^ r) {
+                a->Multiply(x, r);
+                int n = r->Size;
+                pin_ptr<double> pb = &b->Elements[0];
+                pin_ptr<double> pr = &r->Elements[0];
+                Native::KrylovCombine(pb, -1.0, pr, pr, n);
+            }
+
+            static double Dot(Vector<double>^ x, Vector<double>^ y) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                return Native::KrylovDot(px, py, x->Size);
+            }
+
+            static double Norm(Vector<double>^ x) {
+                return System::Math::Sqrt(Dot(x, x));
+            }
+
+            /// <summary>
+            /// y += alpha * x
+            /// </summary>
+            static void Axpy(double alpha, Vector<double>^ x, Vector<double>^ y) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                Native::KrylovAxpy(alpha, px, py, x->Size);
+            }
+
+            /// <summary>
+            /// y = x + beta * y
+            /// </summary>
+            static void Xpay(Vector<double>^ x, double beta, Vector<double>^ y) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                Native::KrylovXpay(px, beta, py, x->Size);
+            }
+
+            /// <summary>
+            /// z = x + alpha * y
+            /// </summary>
+            static void Combine(Vector<double>^ x, double alpha, Vector<double>^ y, Vector<double>^ z) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                pin_ptr<double> pz = &z->Elements[0];
+                Native::KrylovCombine(px, alpha, py, pz, x->Size);
+            }
+
+            /// <summary>
+            /// Runs the method on a validated, non-empty system with ||b|| > 0
+            /// </summary>
+            virtual SolverResult Run(CsrMatrix<double>^ a, Vector<double>^ b, Vector<double>^ x, double bNorm) abstract;
+
+        public:
+            /// <summary>
+            /// Gets or sets the relative residual ||b - A x|| / ||b|| at which
+            /// the solve stops (default 1e-8)
+            /// </summary>
+            property double Tolerance {
+                double get() { return tolerance; }
+                void set(double value) {
+                    if (!(value > 0))
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    tolerance = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the iteration limit (default 1000)
+            /// </summary>
+            property int MaxIterations {
+                int get() { return maxIterations; }
+                void set(int value) {
+                    if (value < 0)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    maxIterations = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the preconditioner, or null for none
+            /// </summary>
+            property WindowPlus::Math::Preconditioner^ Preconditioner {
+                WindowPlus::Math::Preconditioner^ get() { return preconditioner; }
+                void set(WindowPlus::Math::Preconditioner^ value) { preconditioner = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the per-iteration callback, or null for none
+            /// </summary>
+            property SolverProgress^ Progress {
+                SolverProgress^ get() { return progress; }
+                void set(SolverProgress^ value) { progress = value; }
+            }
+
+            /// <summary>
+            /// Solves A x = b starting from the current contents of x, which
+            /// receives the solution
+            /// </summary>
+            SolverResult Solve(CsrMatrix<double>^ a, Vector<double>^ b, Vector<double>^ x) {
+                if (a == nullptr || b == nullptr || x == nullptr)
+                    throw gcnew ArgumentNullException(a == nullptr ? "a" : b == nullptr ? "b" : "x");
+                if (a->Rows != a->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+                if (b->Size != a->Rows || x->Size != a->Rows)
+                    throw gcnew ArgumentException("Vector sizes do not match the matrix");
+                if (b == x)
+                    throw gcnew ArgumentException("Solution must not be the right-hand side", "x");
+
+                if (a->Rows == 0)
+                    return SolverResult(true, 0, 0);
+                double bNorm = Norm(b);
+                if (bNorm == 0) {
+                    Array::Clear(x->Elements, 0, x->Size);
+                    return SolverResult(true, 0, 0);
+                }
+                return Run(a, b, x, bNorm);
+            }
+
+            /// <summary>
+            /// Solves A x = b starting from zero
+            /// </summary>
+            Vector<double>^ Solve(CsrMatrix<double>^ a, Vector<double>^ b) {
+                Vector<double>^ x = gcnew Vector<double>(a->Columns);
+                Solve(a, b, x);
+                return x;
+            }
+        };
+
+        /// <summary>
+        /// Preconditioned conjugate gradients, for symmetric positive definite
+        /// matrices such as graph Laplacians and normal equations. One product
+        /// and one preconditioner application per iteration. The
+        /// preconditioner must be symmetric too (Jacobi is; ILU(0) of a
+        /// symmetric matrix is close enough in practice).
+        /// </summary>
+        public ref class ConjugateGradientSolver : IterativeSolver {
+        protected:
+            virtual SolverResult Run(CsrMatrix<double>^ a, Vector<double>^ b, Vector<double>^ x, double bNorm) override {
+                int n = b->Size;
+                Vector<double>^ r = Workspace(0, n);
+                Vector<double>^ z = Workspace(1, n);
+                Vector<double>^ p = Workspace(2, n);
+                Vector<double>^ ap = Workspace(3, n);
+
+                Residual(a, b, x, r);
+                double residual = Norm(r) / bNorm;
+                if (residual <= Tolerance)
+                    return SolverResult(true, 0, residual);
+
+                Precondition(r, z);
+                Array::Copy(z->Elements, p->Elements, n);
+                double rz = Dot(r, z);
+
+                for (int iteration = 1; iteration <= MaxIterations; iteration++) {
+                    a->Multiply(p, ap);
+                    double curvature = Dot(p, ap);
+                    // Not positive definite along p
+                    if (!(curvature > 0))
+                        return SolverResult(false, iteration - 1, residual);
+
+                    double alpha = rz / curvature;
+                    Axpy(alpha, p, x);
+                    Axpy(-alpha, ap, r);
+                    residual = Norm(r) / bNorm;
+
+                    bool proceed = Report(iteration, residual);
+                    if (residual <= Tolerance)
+                        return SolverResult(true, iteration, residual);
+                    if (!proceed)
+                        return SolverResult(false, iteration, residual);
+
+                    Precondition(r, z);
+                    double rzNext = Dot(r, z);
+                    Xpay(z, rzNext / rz, p);
+                    rz = rzNext;
+                }
+                return SolverResult(false, MaxIterations, residual);
+            }
+        };
+
+        /// <summary>
+        /// Stabilized biconjugate gradients (BiCGSTAB) for general square
+        /// matrices, right-preconditioned. Two products and two preconditioner
+        /// applications per iteration with a constant amount of memory; may
+        /// stall on strongly non-normal matrices, where GMRES is safer.
+        /// </summary>
+        public ref class BiCgStabSolver : IterativeSolver {
+        protected:
+            virtual SolverResult Run(CsrMatrix<double>^ a, Vector<double>^ b, Vector<double>^ x, double bNorm) override {
+                int n = b->Size;
+                Vector<double>^ r = Workspace(0, n);
+                Vector<double>^ shadow = Workspace(1, n);
+                Vector<double>^ p = Workspace(2, n);
+                Vector<double>^ v = Workspace(3, n);
+                Vector<double>^ ph = Workspace(4, n);
+                Vector<double>^ s = Workspace(5, n);
+                Vector<double>^ sh = Workspace(6, n);
+                Vector<double>^ t = Workspace(7, n);
+
+                Residual(a, b, x, r);
+                double residual = Norm(r) / bNorm;
+                if (residual <= Tolerance)
+                    return SolverResult(true, 0, residual);
+
+                Array::Copy(r->Elements, shadow->Elements, n);
+                double rho = 1, alpha = 1, omega = 1;
+
+                for (int iteration = 1; iteration <= MaxIterations; iteration++) {
+                    double rhoNext = Dot(shadow, r);
+                    if (rhoNext == 0)
+                        return SolverResult(false, iteration - 1, residual);
+
+                    if (iteration == 1) {
+                        Array::Copy(r->Elements, p->Elements, n);
+                    }
+                    else {
+                        // p = r + beta * (p - omega * v)
+                        Axpy(-omega, v, p);
+                        Xpay(r, (rhoNext / rho) * (alpha / omega), p);
+                    }
+                    rho = rhoNext;
+
+                    Precondition(p, ph);
+                    a->Multiply(ph, v);
+                    double projection = Dot(shadow, v);
+                    if (projection == 0)
+                        return SolverResult(false, iteration - 1, residual);
+                    alpha = rho / projection;
+
+                    Combine(r, -alpha, v, s);
+                    double sResidual = Norm(s) / bNorm;
+                    if (sResidual <= Tolerance) {
+                        Axpy(alpha, ph, x);
+                        Report(iteration, sResidual);
+                        return SolverResult(true, iteration, sResidual);
+                    }
+
+                    Precondition(s, sh);
+                    a->Multiply(sh, t);
+                    double tt = Dot(t, t);
+                    omega = tt > 0 ? Dot(t, s) / tt : 0;
+
+                    Axpy(alpha, ph, x);
+                    Axpy(omega, sh, x);
+                    Combine(s, -omega, t, r);
+                    residual = Norm(r) / bNorm;
+
+                    bool proceed = Report(iteration, residual);
+                    if (residual <= Tolerance)
+                        return SolverResult(true, iteration, residual);
+                    if (!proceed || omega == 0)
+                        return SolverResult(false, iteration, residual);
+                }
+                return SolverResult(false, MaxIterations, residual);
+            }
+        };
+
+        /// <summary>
+        /// Restarted GMRES(m) for general square matrices, right-preconditioned.
+        /// Minimizes the residual over a Krylov basis of up to Restart
+        /// vectors, so it converges monotonically where BiCGSTAB may stall,
+        /// at the cost of Restart + 1 stored vectors and growing
+        /// orthogonalization work within each cycle.
+        /// </summary>
+        public ref class GmresSolver : IterativeSolver {
+        private:
+            int restart;
+            array<double>^ hessenberg;
+            array<double>^ cosines;
+            array<double>^ sines;
+            array<double>^ rhs;
+
+        protected:
+            virtual SolverResult Run(CsrMatrix<double>^ a, Vector<double>^ b, Vector<double>^ x, double bNorm) override {
+                int n = b->Size, m = restart;
+                Vector<double>^ r = Workspace(0, n);
+                Vector<double>^ w = Workspace(1, n);
+                Vector<double>^ z = Workspace(2, n);
+                if (hessenberg == nullptr || hessenberg->Length != (m + 1) * m) {
+                    hessenberg = gcnew array<double>((m + 1) * m);
+                    cosines = gcnew array<double>(m);
+                    sines = gcnew array<double>(m);
+                    rhs = gcnew array<double>(m + 1);
+                }
+
+                int total = 0;
+                double residual = 0;
+                while (true) {
+                    Residual(a, b, x, r);
+                    double beta = Norm(r);
+                    residual = beta / bNorm;
+                    if (residual <= Tolerance)
+                        return SolverResult(true, total, residual);
+                    if (total >= MaxIterations)
+                        return SolverResult(false, total, residual);
+
+                    Vector<double>^ v0 = Workspace(3, n);
+                    Array::Clear(v0->Elements, 0, n);
+                    Axpy(1.0 / beta, r, v0);
+                    Array::Clear(rhs, 0, m + 1);
+                    rhs[0] = beta;
+
+                    int j = 0;
+                    bool converged = false, proceed = true;
+                    while (j < m && total < MaxIterations) {
+                        total++;
+                        Vector<double>^ vj = Workspace(3 + j, n);
+                        Precondition(vj, z);
+                        a->Multiply(z, w);
+
+                        // Modified Gram-Schmidt against the basis so far
+                        for (int i = 0; i <= j; i++) {
+                            Vector<double>^ vi = Workspace(3 + i, n);
+                            double h = Dot(w, vi);
+                            hessenberg[i * m + j] = h;
+                            Axpy(-h, vi, w);
+                        }
+                        double next = Norm(w);
+                        hessenberg[(j + 1) * m + j] = next;
+                        if (next != 0) {
+                            Vector<double>^ v = Workspace(4 + j, n);
+                            Array::Clear(v->Elements, 0, n);
+                            Axpy(1.0 / next, w, v);
+                        }
+
+                        // Fold the new column into the QR factorization of H
+                        for (int i = 0; i < j; i++) {
+                            double h0 = hessenberg[i * m + j], h1 = hessenberg[(i + 1) * m + j];
+                            hessenberg[i * m + j] = cosines[i] * h0 + sines[i] * h1;
+                            hessenberg[(i + 1) * m + j] = -sines[i] * h0 + cosines[i] * h1;
+                        }
+                        double diagonal = hessenberg[j * m + j];
+                        double radius = System::Math::Sqrt(diagonal * diagonal + next * next);
+                        cosines[j] = radius != 0 ? diagonal / radius : 1;
+                        sines[j] = radius != 0 ? next / radius : 0;
+                        hessenberg[j * m + j] = radius;
+                        hessenberg[(j + 1) * m + j] = 0;
+                        rhs[j + 1] = -sines[j] * rhs[j];
+                        rhs[j] = cosines[j] * rhs[j];
+                        j++;
+
+                        residual = System::Math::Abs(rhs[j]) / bNorm;
+                        converged = residual <= Tolerance;
+                        proceed = Report(total, residual);
+                        // next == 0 means the basis spans the solution exactly
+                        if (converged || !proceed || next == 0)
+                            break;
+                    }
+
+                    // Back-substitute H y = g, then x += M^-1 (V y)
+                    for (int i = j - 1; i >= 0; i--) {
+                        double sum = rhs[i];
+                        for (int k = i + 1; k < j; k++)
+                            sum -= hessenberg[i * m + k] * rhs[k];
+                        rhs[i] = hessenberg[i * m + i] != 0 ? sum / hessenberg[i * m + i] : 0;
+                    }
+                    Array::Clear(w->Elements, 0, n);
+                    for (int i = 0; i < j; i++)
+                        Axpy(rhs[i], Workspace(3 + i, n), w);
+                    Precondition(w, z);
+                    Axpy(1.0, z, x);
+
+                    if (converged)
+                        return SolverResult(true, total, residual);
+                    if (!proceed)
+                        return SolverResult(false, total, residual);
+                }
+            }
+
+        public:
+            /// <summary>
+            /// Creates a solver that restarts every 30 iterations
+            /// </summary>
+            GmresSolver() {
+                restart = 30;
+            }
+
+            /// <summary>
+            /// Creates a solver with specified restart length
+            /// </summary>
+            GmresSolver(int restart) {
+                Restart = restart;
+            }
+
+            /// <summary>
+            /// Gets or sets the number of basis vectors built before restarting
+            /// </summary>
+            property int Restart {
+                int get() { return restart; }
+                void set(int value) {
+                    if (value < 1)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    restart = value;
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+#include "../Native/Iterative.h"
+#include "Minimizer.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Limited-memory BFGS for smooth unconstrained objectives. Keeps the
+        /// last History correction pairs instead of an n x n Hessian, so each
+        /// iteration costs O(History * n) beyond the objective itself. Steps
+        /// satisfy the weak Wolfe conditions. Without an analytic gradient the
+        /// gradient is taken by central differences, split into chunks that
+        /// run in parallel when ParallelEvaluation is set.
+        /// </summary>
+        public ref class LbfgsMinimizer : Minimizer {
+        private:
+            int history;
+            double gradientTolerance;
+            double functionTolerance;
+            array<double>^ rho;
+            array<double>^ alpha;
+
+            // State of the current run, read by the finite-difference workers
+            GradientFunction^ gradient;
+            ObjectiveFunction^ objective;
+            Vector<double>^ differencePoint;
+            Vector<double>^ differenceGradient;
+            int differenceChunks;
+            Action<int>^ differenceBody;
+
+            static bool IsFinite(double value) {
+                return !Double::IsNaN(value) && !Double::IsInfinity(value);
+            }
+
+            static double Dot(Vector<double>^ x, Vector<double>^ y) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                return Native::KrylovDot(px, py, x->Size);
+            }
+
+            /// <summary>
+            /// y += a * x
+            /// </summary>
+            static void Axpy(double a, Vector<double>^ x, Vector<double>^ y) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                Native::KrylovAxpy(a, px, py, x->Size);
+            }
+
+            /// <summary>
+            /// z = x + a * y
+            /// </summary>
+            static void Combine(Vector<double>^ x, double a, Vector<double>^ y, Vector<double>^ z) {
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                pin_ptr<double> pz = &z->Elements[0];
+                Native::KrylovCombine(px, a, py, pz, x->Size);
+            }
+
+            /// <summary>
+            /// Central differences for the elements of one chunk, each chunk
+            /// perturbing its own copy of the point
+            /// </summary>
+            void DifferenceChunk(int chunk) {
+                int n = differencePoint->Size;
+                int begin = (int)((long long)n * chunk / differenceChunks);
+                int end = (int)((long long)n * (chunk + 1) / differenceChunks);
+                array<double>^ x = differencePoint->Elements;
+                Vector<double>^ probe = Workspace(4 + 2 * history + chunk, n);
+                array<double>^ p = probe->Elements;
+                Array::Copy(x, p, n);
+
+                for (int i = begin; i < end; i++) {
+                    // cbrt(machine epsilon) balances truncation and round-off
+                    double h = 6.055454452393343e-6 * System::Math::Max(1.0, System::Math::Abs(x[i]));
+                    p[i] = x[i] + h;
+                    double up = objective(probe);
+                    p[i] = x[i] - h;
+                    double down = objective(probe);
+                    p[i] = x[i];
+                    differenceGradient->Elements[i] = (up - down) / (2 * h);
+                }
+                CountEvaluations(2 * (end - begin));
+            }
+
+            /// <summary>
+            /// Returns f(x) and writes the gradient into g
+            /// </summary>
+            double Evaluate(Vector<double>^ x, Vector<double>^ g) {
+                CountEvaluation();
+                if (gradient != nullptr) {
+                    CountGradientEvaluation();
+                    return gradient(x, g);
+                }
+
+                int n = x->Size;
+                differencePoint = x;
+                differenceGradient = g;
+                differenceChunks = ChunkCount(n);
+                for (int c = 0; c < differenceChunks; c++)
+                    Workspace(4 + 2 * history + c, n);
+                double value = objective(x);
+                ForEach(differenceChunks, differenceBody);
+                return value;
+            }
+
+            /// <summary>
+            /// Bisection search for a step t along d satisfying the weak Wolfe
+            /// conditions. Leaves the accepted point in xNew and gNew.
+            /// </summary>
+            bool LineSearch(Vector<double>^ x, double fx, double slope, Vector<double>^ d, double step,
+                            Vector<double>^ xNew, Vector<double>^ gNew, double% fNew) {
+                const double sufficientDecrease = 1e-4, curvature = 0.9;
+                double lo = 0, hi = Double::PositiveInfinity, t = step;
+                for (int k = 0; k < 50; k++) {
+                    Combine(x, t, d, xNew);
+                    fNew = Evaluate(xNew, gNew);
+                    if (!IsFinite(fNew) || fNew > fx + sufficientDecrease * t * slope)
+                        hi = t;
+                    else if (Dot(gNew, d) < curvature * slope)
+                        lo = t;
+                    else
+                        return true;
+                    if (EvaluationsExhausted)
+                        return false;
+                    t = Double::IsPositiveInfinity(hi) ? 2 * lo : 0.5 * (lo + hi);
+                }
+                return false;
+            }
+
+            MinimizationResult Run(Vector<double>^ x) {
+                int n = x->Size, m = history;
+                ResetCounters();
+                if (rho == nullptr || rho->Length != m) {
+                    rho = gcnew array<double>(m);
+                    alpha = gcnew array<double>(m);
+                }
+
+                Vector<double>^ g = Workspace(0, n);
+                Vector<double>^ d = Workspace(1, n);
+                Vector<double>^ xNew = Workspace(2, n);
+                Vector<double>^ gNew = Workspace(3, n);
+
+                double f = Evaluate(x, g);
+                if (!IsFinite(f))
+                    return Result(MinimizerStatus::Stalled, f, 0);
+                if (n == 0 || NormInf(g) <= gradientTolerance)
+                    return Result(MinimizerStatus::Converged, f, 0);
+
+                int stored = 0, newest = -1;
+                for (int iteration = 1; iteration <= MaxIterations; iteration++) {
+                    // Two-loop recursion: d = -H * g
+                    Array::Copy(g->Elements, d->Elements, n);
+                    for (int k = 0; k < stored; k++) {
+                        int i = (newest - k + m) % m;
+                        alpha[i] = rho[i] * Dot(Workspace(4 + i, n), d);
+                        Axpy(-alpha[i], Workspace(4 + m + i, n), d);
+                    }
+                    // Initial Hessian gamma * I with gamma = s.y / y.y of the newest pair
+                    double gamma = 1;
+                    if (stored > 0) {
+                        Vector<double>^ y = Workspace(4 + m + newest, n);
+                        gamma = 1 / (rho[newest] * Dot(y, y));
+                    }
+                    for (int i = 0; i < n; i++)
+                        d->Elements[i] *= gamma;
+                    for (int k = stored - 1; k >= 0; k--) {
+                        int i = (newest - k + m) % m;
+                        double beta = rho[i] * Dot(Workspace(4 + m + i, n), d);
+                        Axpy(alpha[i] - beta, Workspace(4 + i, n), d);
+                    }
+                    double slope = 0;
+                    for (int i = 0; i < n; i++) {
+                        d->Elements[i] = -d->Elements[i];
+                        slope += g->Elements[i] * d->Elements[i];
+                    }
+                    // Fall back to steepest descent if the model went bad
+                    if (!(slope < 0)) {
+                        stored = 0;
+                        for (int i = 0; i < n; i++)
+                            d->Elements[i] = -g->Elements[i];
+                        slope = -Dot(g, g);
+                    }
+
+                    double step = stored == 0 ? System::Math::Min(1.0, 1.0 / NormInf(g)) : 1.0;
+                    double fNew;
+                    if (!LineSearch(x, f, slope, d, step, xNew, gNew, fNew))
+                        return Result(EvaluationsExhausted ? MinimizerStatus::LimitReached : MinimizerStatus::Stalled,
+                                      f, iteration - 1);
+
+                    // Store s = xNew - x and y = gNew - g in the ring buffer
+                    int slot = (newest + 1) % m;
+                    Vector<double>^ s = Workspace(4 + slot, n);
+                    Vector<double>^ y = Workspace(4 + m + slot, n);
+                    Combine(xNew, -1, x, s);
+                    Combine(gNew, -1, g, y);
+                    double sy = Dot(s, y);
+                    // Skip pairs that would break positive definiteness
+                    if (sy > 1e-10 * Dot(y, y)) {
+                        rho[slot] = 1 / sy;
+                        newest = slot;
+                        if (stored < m)
+                            stored++;
+                    }
+
+                    double fPrevious = f;
+                    f = fNew;
+                    Array::Copy(xNew->Elements, x->Elements, n);
+                    Array::Copy(gNew->Elements, g->Elements, n);
+
+                    bool proceed = Report(iteration, f);
+                    if (NormInf(g) <= gradientTolerance ||
+                        System::Math::Abs(fPrevious - f) <=
+                            functionTolerance * System::Math::Max(1.0, System::Math::Max(System::Math::Abs(f), System::Math::Abs(fPrevious))))
+                        return Result(MinimizerStatus::Converged, f, iteration);
+                    if (!proceed)
+                        return Result(MinimizerStatus::Stopped, f, iteration);
+                    if (EvaluationsExhausted)
+                        return Result(MinimizerStatus::LimitReached, f, iteration);
+                }
+                return Result(MinimizerStatus::LimitReached, f, MaxIterations);
+            }
+
+        public:
+            LbfgsMinimizer() {
+                history = 8;
+                gradientTolerance = 1e-6;
+                functionTolerance = 1e-12;
+                differenceBody = gcnew Action<int>(this, &LbfgsMinimizer::DifferenceChunk);
+            }
+
+            /// <summary>
+            /// Gets or sets the number of correction pairs kept (default 8)
+            /// </summary>
+            property int History {
+                int get() { return history; }
+                void set(int value) {
+                    if (value < 1)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    history = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the largest gradient element at which the run
+            /// counts as converged (default 1e-6)
+            /// </summary>
+            property double GradientTolerance {
+                double get() { return gradientTolerance; }
+                void set(double value) { gradientTolerance = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the relative decrease of the objective below which
+            /// the run counts as converged (default 1e-12)
+            /// </summary>
+            property double FunctionTolerance {
+                double get() { return functionTolerance; }
+                void set(double value) { functionTolerance = value; }
+            }
+
+            /// <summary>
+            /// Minimizes an objective with an analytic gradient starting from
+            /// x, which receives the minimizer
+            /// </summary>
+            MinimizationResult Minimize(GradientFunction^ function, Vector<double>^ x) {
+                if (function == nullptr || x == nullptr)
+                    throw gcnew ArgumentNullException(function == nullptr ? "function" : "x");
+                gradient = function;
+                objective = nullptr;
+                try {
+                    return Run(x);
+                }
+                finally {
+                    gradient = nullptr;
+                }
+            }
+
+            /// <summary>
+            /// Minimizes an objective using central-difference gradients
+            /// (2n + 1 evaluations per gradient) starting from x, which
+            /// receives the minimizer
+            /// </summary>
+            MinimizationResult Minimize(ObjectiveFunction^ function, Vector<double>^ x) {
+                if (function == nullptr || x == nullptr)
+                    throw gcnew ArgumentNullException(function == nullptr ? "function" : "x");
+                gradient = nullptr;
+                objective = function;
+                try {
+                    return Run(x);
+                }
+                finally {
+                    objective = nullptr;
+                    differencePoint = nullptr;
+                    differenceGradient = nullptr;
+                }
+            }
+        };
+    }
+}
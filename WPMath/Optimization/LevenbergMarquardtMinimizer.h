@@ -0,0 +1,317 @@
+#pragma once
+
+#include "../Native/Factorization.h"
+#include "../Native/Iterative.h"
+#include "../Core/Matrix.h"
+#include "Minimizer.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Writes the residuals r(parameters) of a least-squares problem into
+        /// residuals. Must be thread-safe when the minimizer evaluates in parallel.
+        /// </summary>
+        public delegate void ResidualFunction(Vector<double>^ parameters, Vector<double>^ residuals);
+
+        /// <summary>
+        /// Writes the Jacobian d r[i] / d parameters[j] into jacobian
+        /// (residuals x parameters)
+        /// </summary>
+        public delegate void JacobianFunction(Vector<double>^ parameters, Matrix<double>^ jacobian);
+
+        /// <summary>
+        /// Levenberg-Marquardt for nonlinear least squares: minimizes the sum
+        /// of squared residuals, as in curve fitting. Each iteration solves the
+        /// damped normal equations (J^T J + lambda D) delta = -J^T r by
+        /// Cholesky, with D the running maximum of diag(J^T J) (Moré scaling)
+        /// and lambda adapted by Nielsen's gain-ratio rule. Without an
+        /// analytic Jacobian, forward differences are used; their columns are
+        /// independent and run in parallel when ParallelEvaluation is set.
+        /// Reported values are sums of squared residuals.
+        /// </summary>
+        public ref class LevenbergMarquardtMinimizer : Minimizer {
+        private:
+            double tolerance;
+            double functionTolerance;
+            double gradientTolerance;
+            double initialDamping;
+            Matrix<double>^ jacobian;
+            MatrixView<double>^ jacobianView;
+            MatrixView<double>^ jacobianTransposeView;
+            Matrix<double>^ normal;
+            array<double>^ factor;
+            array<Vector<double>^>^ probeResiduals;
+
+            // State of the current run, read by the finite-difference workers
+            ResidualFunction^ residualFunction;
+            Vector<double>^ differencePoint;
+            Vector<double>^ differenceBase;
+            int differenceChunks;
+            Action<int>^ differenceBody;
+
+            static bool IsFinite(double value) {
+                return !Double::IsNaN(value) && !Double::IsInfinity(value);
+            }
+
+            static double Dot(Vector<double>^ x, Vector<double>^ y) {
+                if (x->Size == 0)
+                    return 0;
+                pin_ptr<double> px = &x->Elements[0];
+                pin_ptr<double> py = &y->Elements[0];
+                return Native::KrylovDot(px, py, x->Size);
+            }
+
+            /// <summary>
+            /// Forward differences for the Jacobian columns of one chunk
+            /// </summary>
+            void DifferenceChunk(int chunk) {
+                int n = differencePoint->Size, m = differenceBase->Size;
+                int begin = (int)((long long)n * chunk / differenceChunks);
+                int end = (int)((long long)n * (chunk + 1) / differenceChunks);
+                array<double>^ x = differencePoint->Elements;
+                array<double>^ r0 = differenceBase->Elements;
+                Vector<double>^ probe = Workspace(6 + chunk, n);
+                Vector<double>^ rProbe = probeResiduals[chunk];
+                array<double>^ p = probe->Elements;
+                array<double>^ r = rProbe->Elements;
+                array<double, 2>^ jac = jacobian->Elements;
+                Array::Copy(x, p, n);
+
+                for (int j = begin; j < end; j++) {
+                    // sqrt(machine epsilon) for one-sided differences
+                    double h = 1.4901161193847656e-8 * System::Math::Max(1.0, System::Math::Abs(x[j]));
+                    p[j] = x[j] + h;
+                    residualFunction(probe, rProbe);
+                    p[j] = x[j];
+                    double inv = 1.0 / h;
+                    for (int i = 0; i < m; i++)
+                        jac[i, j] = (r[i] - r0[i]) * inv;
+                }
+                CountEvaluations(end - begin);
+            }
+
+            void Allocate(int m, int n) {
+                if (jacobian == nullptr || jacobian->Rows != m || jacobian->Columns != n) {
+                    jacobian = gcnew Matrix<double>(m, n);
+                    jacobianView = jacobian->View();
+                    jacobianTransposeView = jacobian->TransposeView();
+                }
+                if (normal == nullptr || normal->Rows != n) {
+                    normal = gcnew Matrix<double>(n, n);
+                    factor = gcnew array<double>(n * n);
+                }
+                int chunks = ChunkCount(n);
+                if (probeResiduals == nullptr || probeResiduals->Length < chunks)
+                    probeResiduals = gcnew array<Vector<double>^>(chunks);
+                for (int c = 0; c < chunks; c++) {
+                    Workspace(6 + c, n);
+                    if (probeResiduals[c] == nullptr || probeResiduals[c]->Size != m)
+                        probeResiduals[c] = gcnew Vector<double>(m);
+                }
+            }
+
+            MinimizationResult Run(ResidualFunction^ function, JacobianFunction^ analytic, int residualCount,
+                                   Vector<double>^ x) {
+                int n = x->Size, m = residualCount;
+                ResetCounters();
+                Allocate(m, n);
+
+                Vector<double>^ r = Workspace(0, m);
+                Vector<double>^ rTrial = Workspace(1, m);
+                Vector<double>^ trial = Workspace(2, n);
+                Vector<double>^ g = Workspace(3, n);
+                Vector<double>^ delta = Workspace(4, n);
+                Vector<double>^ scale = Workspace(5, n);
+                Array::Clear(scale->Elements, 0, n);
+
+                function(x, r);
+                CountEvaluation();
+                double sum = Dot(r, r);
+                if (!IsFinite(sum))
+                    return Result(MinimizerStatus::Stalled, sum, 0);
+                if (n == 0 || m == 0)
+                    return Result(MinimizerStatus::Converged, sum, 0);
+
+                array<double, 2>^ jac = jacobian->Elements;
+                array<double, 2>^ jtj = normal->Elements;
+                double lambda = initialDamping, nu = 2;
+
+                for (int iteration = 1; iteration <= MaxIterations; iteration++) {
+                    if (analytic != nullptr) {
+                        analytic(x, jacobian);
+                        CountGradientEvaluation();
+                    }
+                    else {
+                        differencePoint = x;
+                        differenceBase = r;
+                        differenceChunks = ChunkCount(n);
+                        ForEach(differenceChunks, differenceBody);
+                    }
+
+                    Matrix<double>::MultiplyInto(jacobianTransposeView, jacobianView, normal, 1);
+                    double gradientNorm = 0;
+                    for (int j = 0; j < n; j++) {
+                        double s = 0;
+                        for (int i = 0; i < m; i++)
+                            s += jac[i, j] * r->Elements[i];
+                        g->Elements[j] = s;
+                        gradientNorm = System::Math::Max(gradientNorm, System::Math::Abs(s));
+
+                        double d = jtj[j, j];
+                        if (d > scale->Elements[j])
+                            scale->Elements[j] = d;
+                        if (scale->Elements[j] == 0)
+                            scale->Elements[j] = 1;
+                    }
+                    if (gradientNorm <= gradientTolerance)
+                        return Result(MinimizerStatus::Converged, sum, iteration - 1);
+
+                    // Retry with more damping until the step reduces the sum
+                    while (true) {
+                        pin_ptr<double> pf = &factor[0];
+                        pin_ptr<double> pn = &jtj[0, 0];
+                        memcpy(pf, pn, (size_t)n * n * sizeof(double));
+                        for (int j = 0; j < n; j++)
+                            pf[j * n + j] += lambda * scale->Elements[j];
+
+                        bool factored = Native::CholeskyFactor(pf, n);
+                        if (factored) {
+                            for (int j = 0; j < n; j++)
+                                delta->Elements[j] = -g->Elements[j];
+                            pin_ptr<double> pd = &delta->Elements[0];
+                            Native::CholeskySolve(pf, n, pd, 1);
+
+                            double stepNorm = System::Math::Sqrt(Dot(delta, delta));
+                            double pointNorm = System::Math::Sqrt(Dot(x, x));
+                            if (stepNorm <= tolerance * (pointNorm + tolerance))
+                                return Result(MinimizerStatus::Converged, sum, iteration);
+
+                            // Predicted reduction of the sum: delta . (lambda D delta - g)
+                            double predicted = 0;
+                            for (int j = 0; j < n; j++) {
+                                trial->Elements[j] = x->Elements[j] + delta->Elements[j];
+                                predicted += delta->Elements[j] *
+                                             (lambda * scale->Elements[j] * delta->Elements[j] - g->Elements[j]);
+                            }
+                            function(trial, rTrial);
+                            CountEvaluation();
+                            double trialSum = Dot(rTrial, rTrial);
+                            double gain = predicted > 0 ? (sum - trialSum) / predicted : -1;
+
+                            if (IsFinite(trialSum) && gain > 0) {
+                                Array::Copy(trial->Elements, x->Elements, n);
+                                Array::Copy(rTrial->Elements, r->Elements, m);
+                                double reduction = sum - trialSum;
+                                sum = trialSum;
+                                double t = 2 * gain - 1;
+                                lambda *= System::Math::Max(1.0 / 3, 1 - t * t * t);
+                                nu = 2;
+
+                                if (reduction <= functionTolerance * System::Math::Max(sum + reduction, 1e-300)) {
+                                    Report(iteration, sum);
+                                    return Result(MinimizerStatus::Converged, sum, iteration);
+                                }
+                                break;
+                            }
+                        }
+
+                        lambda *= nu;
+                        nu *= 2;
+                        if (EvaluationsExhausted)
+                            return Result(MinimizerStatus::LimitReached, sum, iteration);
+                        if (lambda > 1e20)
+                            return Result(MinimizerStatus::Stalled, sum, iteration);
+                    }
+
+                    if (!Report(iteration, sum))
+                        return Result(MinimizerStatus::Stopped, sum, iteration);
+                    if (EvaluationsExhausted)
+                        return Result(MinimizerStatus::LimitReached, sum, iteration);
+                }
+                return Result(MinimizerStatus::LimitReached, sum, MaxIterations);
+            }
+
+        public:
+            LevenbergMarquardtMinimizer() {
+                tolerance = 1e-10;
+                functionTolerance = 1e-12;
+                gradientTolerance = 1e-10;
+                initialDamping = 1e-3;
+                differenceBody = gcnew Action<int>(this, &LevenbergMarquardtMinimizer::DifferenceChunk);
+            }
+
+            /// <summary>
+            /// Gets or sets the relative step size at which the run counts as
+            /// converged (default 1e-10)
+            /// </summary>
+            property double Tolerance {
+                double get() { return tolerance; }
+                void set(double value) { tolerance = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the relative reduction of the sum of squares below
+            /// which the run counts as converged (default 1e-12)
+            /// </summary>
+            property double FunctionTolerance {
+                double get() { return functionTolerance; }
+                void set(double value) { functionTolerance = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the largest element of J^T r at which the run
+            /// counts as converged (default 1e-10)
+            /// </summary>
+            property double GradientTolerance {
+                double get() { return gradientTolerance; }
+                void set(double value) { gradientTolerance = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the starting damping factor (default 1e-3). Larger
+            /// values start closer to gradient descent.
+            /// </summary>
+            property double InitialDamping {
+                double get() { return initialDamping; }
+                void set(double value) {
+                    if (!(value > 0))
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    initialDamping = value;
+                }
+            }
+
+            /// <summary>
+            /// Minimizes the sum of squares of residualCount residuals using
+            /// finite-difference Jacobians, starting from parameters, which
+            /// receives the solution
+            /// </summary>
+            MinimizationResult Minimize(ResidualFunction^ residuals, int residualCount, Vector<double>^ parameters) {
+                return Minimize(residuals, nullptr, residualCount, parameters);
+            }
+
+            /// <summary>
+            /// Minimizes the sum of squares with an analytic Jacobian (null
+            /// selects finite differences)
+            /// </summary>
+            MinimizationResult Minimize(ResidualFunction^ residuals, JacobianFunction^ jacobianFunction, int residualCount,
+                                        Vector<double>^ parameters) {
+                if (residuals == nullptr || parameters == nullptr)
+                    throw gcnew ArgumentNullException(residuals == nullptr ? "residuals" : "parameters");
+                if (residualCount < 0)
+                    throw gcnew ArgumentOutOfRangeException("residualCount");
+
+                residualFunction = residuals;
+                try {
+                    return Run(residuals, jacobianFunction, residualCount, parameters);
+                }
+                finally {
+                    residualFunction = nullptr;
+                    differencePoint = nullptr;
+                    differenceBase = nullptr;
+                }
+            }
+        };
+    }
+}
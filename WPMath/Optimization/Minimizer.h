@@ -0,0 +1,288 @@
+#pragma once
+
+#include "../Core/Vector.h"
+
+using namespace System;
+using namespace System::Threading;
+using namespace System::Threading::Tasks;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Returns the objective value at x. Must be thread-safe when the
+        /// minimizer evaluates in parallel.
+        /// </summary>
+        public delegate double ObjectiveFunction(Vector<double>^ x);
+
+        /// <summary>
+        /// Returns the objective value at x and writes its gradient into gradient
+        /// </summary>
+        public delegate double GradientFunction(Vector<double>^ x, Vector<double>^ gradient);
+
+        /// <summary>
+        /// Receives the best objective value after every iteration. Return
+        /// false to stop early.
+        /// </summary>
+        public delegate bool MinimizerProgress(int iteration, double value);
+
+        /// <summary>
+        /// Why a minimization stopped
+        /// </summary>
+        public enum class MinimizerStatus {
+            /// <summary>A convergence test was met</summary>
+            Converged,
+            /// <summary>MaxIterations or MaxEvaluations was reached</summary>
+            LimitReached,
+            /// <summary>The progress callback returned false</summary>
+            Stopped,
+            /// <summary>No further progress was possible (failed line search,
+            /// non-finite values)</summary>
+            Stalled
+        };
+
+        /// <summary>
+        /// Outcome and cost of a minimization
+        /// </summary>
+        public value struct MinimizationResult {
+        private:
+            MinimizerStatus status;
+            double value;
+            int iterations;
+            int evaluations;
+            int gradientEvaluations;
+
+        public:
+            MinimizationResult(MinimizerStatus status, double value, int iterations, int evaluations, int gradientEvaluations) {
+                this->status = status;
+                this->value = value;
+                this->iterations = iterations;
+                this->evaluations = evaluations;
+                this->gradientEvaluations = gradientEvaluations;
+            }
+
+            /// <summary>
+            /// Gets why the minimization stopped
+            /// </summary>
+            property MinimizerStatus Status {
+                MinimizerStatus get() { return status; }
+            }
+
+            /// <summary>
+            /// Gets whether a convergence test was met
+            /// </summary>
+            property bool Converged {
+                bool get() { return status == MinimizerStatus::Converged; }
+            }
+
+            /// <summary>
+            /// Gets the objective value at the returned point
+            /// </summary>
+            property double Value {
+                double get() { return value; }
+            }
+
+            /// <summary>
+            /// Gets the number of iterations performed
+            /// </summary>
+            property int Iterations {
+                int get() { return iterations; }
+            }
+
+            /// <summary>
+            /// Gets the number of objective (or residual) evaluations,
+            /// including those spent on finite differences
+            /// </summary>
+            property int Evaluations {
+                int get() { return evaluations; }
+            }
+
+            /// <summary>
+            /// Gets the number of analytic gradient (or Jacobian) evaluations
+            /// </summary>
+            property int GradientEvaluations {
+                int get() { return gradientEvaluations; }
+            }
+        };
+
+        /// <summary>
+        /// Shared settings, counters and scratch management of the minimizers.
+        /// Work vectors are kept between runs of the same dimension, so the
+        /// iteration loops do not allocate once warmed up. An instance is not
+        /// thread-safe, though it may call the objective from several threads.
+        /// </summary>
+        public ref class Minimizer abstract {
+        private:
+            int maxIterations;
+            int maxEvaluations;
+            bool parallelEvaluation;
+            MinimizerProgress^ progress;
+            array<Vector<double>^>^ workspace;
+            int evaluations;
+            int gradientEvaluations;
+
+        protected:
+            Minimizer() {
+                maxIterations = 1000;
+                maxEvaluations = Int32::MaxValue;
+                workspace = gcnew array<Vector<double>^>(0);
+            }
+
+            /// <summary>
+            /// Gets work vector index of size n, reusing it across runs
+            /// </summary>
+            Vector<double>^ Workspace(int index, int n) {
+                if (index >= workspace->Length)
+                    Array::Resize(workspace, index + 1);
+                if (workspace[index] == nullptr || workspace[index]->Size != n)
+                    workspace[index] = gcnew Vector<double>(n);
+                return workspace[index];
+            }
+
+            /// <summary>
+            /// Clears the evaluation counters at the start of a run
+            /// </summary>
+            void ResetCounters() {
+                evaluations = 0;
+                gradientEvaluations = 0;
+            }
+
+            /// <summary>
+            /// Records one objective evaluation; safe to call from workers
+            /// </summary>
+            void CountEvaluation() {
+                Interlocked::Increment(evaluations);
+            }
+
+            /// <summary>
+            /// Records count objective evaluations; safe to call from workers
+            /// </summary>
+            void CountEvaluations(int count) {
+                Interlocked::Add(evaluations, count);
+            }
+
+            /// <summary>
+            /// Records one gradient evaluation
+            /// </summary>
+            void CountGradientEvaluation() {
+                Interlocked::Increment(gradientEvaluations);
+            }
+
+            /// <summary>
+            /// Gets whether the evaluation budget is used up
+            /// </summary>
+            property bool EvaluationsExhausted {
+                bool get() { return evaluations >= maxEvaluations; }
+            }
+
+            /// <summary>
+            /// Reports progress; returns false when the callback asked to stop
+            /// </summary>
+            bool Report(int iteration, double value) {
+                return progress == nullptr || progress(iteration, value);
+            }
+
+            /// <summary>
+            /// Packages the counters into a result
+            /// </summary>
+            MinimizationResult Result(MinimizerStatus status, double value, int iterations) {
+                return MinimizationResult(status, value, iterations, evaluations, gradientEvaluations);
+            }
+
+            /// <summary>
+            /// Runs body(0) .. body(count - 1), concurrently when
+            /// ParallelEvaluation is set. The calls must be independent.
+            /// </summary>
+            void ForEach(int count, Action<int>^ body) {
+                if (!parallelEvaluation || count < 2) {
+                    for (int i = 0; i < count; i++)
+                        body(i);
+                    return;
+                }
+                Parallel::For(0, count, body);
+            }
+
+            /// <summary>
+            /// Gets the number of independent chunks a batch of count
+            /// evaluations is split into
+            /// </summary>
+            int ChunkCount(int count) {
+                if (!parallelEvaluation)
+                    return 1;
+                int chunks = Environment::ProcessorCount;
+                return chunks < count ? chunks : (count > 0 ? count : 1);
+            }
+
+            /// <summary>
+            /// Returns the largest absolute element
+            /// </summary>
+            static double NormInf(Vector<double>^ x) {
+                array<double>^ e = x->Elements;
+                double m = 0;
+                for (int i = 0; i < e->Length; i++) {
+                    double a = System::Math::Abs(e[i]);
+                    if (a > m)
+                        m = a;
+                }
+                return m;
+            }
+
+        public:
+            /// <summary>
+            /// Gets or sets the iteration limit (default 1000)
+            /// </summary>
+            property int MaxIterations {
+                int get() { return maxIterations; }
+                void set(int value) {
+                    if (value < 0)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    maxIterations = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets the objective evaluation limit (default unlimited)
+            /// </summary>
+            property int MaxEvaluations {
+                int get() { return maxEvaluations; }
+                void set(int value) {
+                    if (value < 1)
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    maxEvaluations = value;
+                }
+            }
+
+            /// <summary>
+            /// Gets or sets whether independent objective calls (simplex
+            /// vertices, finite-difference columns) run on the thread pool. The
+            /// objective must then be thread-safe. Worth enabling when one call
+            /// costs far more than a task dispatch.
+            /// </summary>
+            property bool ParallelEvaluation {
+                bool get() { return parallelEvaluation; }
+                void set(bool value) { parallelEvaluation = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the per-iteration callback, or null for none
+            /// </summary>
+            property MinimizerProgress^ Progress {
+                MinimizerProgress^ get() { return progress; }
+                void set(MinimizerProgress^ value) { progress = value; }
+            }
+
+            /// <summary>
+            /// Gets the objective evaluations of the current or last run
+            /// </summary>
+            property int Evaluations {
+                int get() { return evaluations; }
+            }
+
+            /// <summary>
+            /// Gets the gradient evaluations of the current or last run
+            /// </summary>
+            property int GradientEvaluations {
+                int get() { return gradientEvaluations; }
+            }
+        };
+    }
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "Minimizer.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Derivative-free Nelder-Mead simplex search for objectives that are
+        /// noisy, non-smooth or too expensive to differentiate. Uses the
+        /// dimension-adaptive coefficients of Gao and Han, which keep the
+        /// method from stalling beyond a handful of dimensions. The initial
+        /// simplex and shrink steps evaluate n independent vertices, which run
+        /// in parallel when ParallelEvaluation is set.
+        /// </summary>
+        public ref class NelderMeadMinimizer : Minimizer {
+        private:
+            double tolerance;
+            double functionTolerance;
+            double initialStep;
+            array<double>^ values;
+            array<int>^ order;
+
+            // State of the current run, read by the vertex workers
+            ObjectiveFunction^ objective;
+            int dimension;
+            Action<int>^ vertexBody;
+            Action<int>^ shrinkBody;
+
+            Vector<double>^ Vertex(int index) {
+                return Workspace(index, dimension);
+            }
+
+            void EvaluateVertex(int index) {
+                values[index] = objective(Vertex(index));
+                CountEvaluation();
+            }
+
+            /// <summary>
+            /// Pulls vertex order[index + 1] halfway towards the best vertex and
+            /// evaluates it
+            /// </summary>
+            void ShrinkVertex(int index) {
+                array<double>^ best = Vertex(order[0])->Elements;
+                int target = order[index + 1];
+                array<double>^ v = Vertex(target)->Elements;
+                double delta = ShrinkCoefficient();
+                for (int i = 0; i < dimension; i++)
+                    v[i] = best[i] + delta * (v[i] - best[i]);
+                EvaluateVertex(target);
+            }
+
+            double ShrinkCoefficient() {
+                return dimension > 1 ? 1.0 - 1.0 / dimension : 0.5;
+            }
+
+            /// <summary>
+            /// Sorts order by vertex value; insertion sort since at most a
+            /// couple of entries move per iteration
+            /// </summary>
+            void SortVertices() {
+                for (int i = 1; i <= dimension; i++) {
+                    int key = order[i];
+                    int j = i - 1;
+                    while (j >= 0 && Compare(values[key], values[order[j]]) < 0) {
+                        order[j + 1] = order[j];
+                        j--;
+                    }
+                    order[j + 1] = key;
+                }
+            }
+
+            /// <summary>
+            /// Orders values with NaN last
+            /// </summary>
+            static int Compare(double a, double b) {
+                if (Double::IsNaN(a))
+                    return Double::IsNaN(b) ? 0 : 1;
+                if (Double::IsNaN(b))
+                    return -1;
+                return a < b ? -1 : (a > b ? 1 : 0);
+            }
+
+            /// <summary>
+            /// target = centroid + coefficient * (centroid - worst)
+            /// </summary>
+            void Extrapolate(Vector<double>^ centroid, double coefficient, Vector<double>^ target) {
+                array<double>^ c = centroid->Elements;
+                array<double>^ w = Vertex(order[dimension])->Elements;
+                array<double>^ t = target->Elements;
+                for (int i = 0; i < dimension; i++)
+                    t[i] = c[i] + coefficient * (c[i] - w[i]);
+            }
+
+            /// <summary>
+            /// Replaces the worst vertex with point
+            /// </summary>
+            void Accept(Vector<double>^ point, double value) {
+                int worst = order[dimension];
+                Array::Copy(point->Elements, Vertex(worst)->Elements, dimension);
+                values[worst] = value;
+            }
+
+            bool Converged() {
+                double best = values[order[0]];
+                array<double>^ b = Vertex(order[0])->Elements;
+                for (int k = 1; k <= dimension; k++) {
+                    int v = order[k];
+                    if (!(System::Math::Abs(values[v] - best) <= functionTolerance))
+                        return false;
+                    array<double>^ x = Vertex(v)->Elements;
+                    for (int i = 0; i < dimension; i++)
+                        if (System::Math::Abs(x[i] - b[i]) > tolerance)
+                            return false;
+                }
+                return true;
+            }
+
+        public:
+            NelderMeadMinimizer() {
+                tolerance = 1e-8;
+                functionTolerance = 1e-10;
+                initialStep = 0.05;
+                vertexBody = gcnew Action<int>(this, &NelderMeadMinimizer::EvaluateVertex);
+                shrinkBody = gcnew Action<int>(this, &NelderMeadMinimizer::ShrinkVertex);
+            }
+
+            /// <summary>
+            /// Gets or sets the largest coordinate spread of the simplex at
+            /// which the run counts as converged (default 1e-8)
+            /// </summary>
+            property double Tolerance {
+                double get() { return tolerance; }
+                void set(double value) { tolerance = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the largest spread of vertex values at which the
+            /// run counts as converged (default 1e-10)
+            /// </summary>
+            property double FunctionTolerance {
+                double get() { return functionTolerance; }
+                void set(double value) { functionTolerance = value; }
+            }
+
+            /// <summary>
+            /// Gets or sets the relative size of the initial simplex: vertex i
+            /// moves coordinate i by this fraction of its value (default 0.05)
+            /// </summary>
+            property double InitialStep {
+                double get() { return initialStep; }
+                void set(double value) {
+                    if (!(value > 0))
+                        throw gcnew ArgumentOutOfRangeException("value");
+                    initialStep = value;
+                }
+            }
+
+            /// <summary>
+            /// Minimizes an objective starting from x, which receives the best
+            /// vertex found
+            /// </summary>
+            MinimizationResult Minimize(ObjectiveFunction^ function, Vector<double>^ x) {
+                if (function == nullptr || x == nullptr)
+                    throw gcnew ArgumentNullException(function == nullptr ? "function" : "x");
+
+                int n = x->Size;
+                objective = function;
+                dimension = n;
+                ResetCounters();
+                try {
+                    if (values == nullptr || values->Length != n + 1) {
+                        values = gcnew array<double>(n + 1);
+                        order = gcnew array<int>(n + 1);
+                    }
+                    // Vertices 0..n, then centroid and trial points
+                    for (int k = 0; k <= n + 3; k++)
+                        Workspace(k, n);
+                    Vector<double>^ centroid = Vertex(n + 1);
+                    Vector<double>^ trial = Vertex(n + 2);
+                    Vector<double>^ second = Vertex(n + 3);
+
+                    for (int k = 0; k <= n; k++) {
+                        array<double>^ v = Vertex(k)->Elements;
+                        Array::Copy(x->Elements, v, n);
+                        if (k > 0) {
+                            // Zero coordinates get a small absolute step
+                            double xi = v[k - 1];
+                            v[k - 1] = xi != 0 ? xi * (1 + initialStep) : 0.00025;
+                        }
+                        order[k] = k;
+                    }
+                    ForEach(n + 1, vertexBody);
+                    SortVertices();
+
+                    double reflection = 1;
+                    double expansion = n > 1 ? 1.0 + 2.0 / n : 2.0;
+                    double contraction = n > 1 ? 0.75 - 0.5 / n : 0.5;
+
+                    int iteration = 0;
+                    MinimizerStatus status = MinimizerStatus::LimitReached;
+                    while (iteration < MaxIterations) {
+                        if (Converged()) {
+                            status = MinimizerStatus::Converged;
+                            break;
+                        }
+                        if (EvaluationsExhausted)
+                            break;
+                        iteration++;
+
+                        array<double>^ c = centroid->Elements;
+                        Array::Clear(c, 0, n);
+                        for (int k = 0; k < n; k++) {
+                            array<double>^ v = Vertex(order[k])->Elements;
+                            for (int i = 0; i < n; i++)
+                                c[i] += v[i];
+                        }
+                        for (int i = 0; i < n; i++)
+                            c[i] /= n;
+
+                        double best = values[order[0]];
+                        double nextWorst = values[order[n - 1 >= 0 ? n - 1 : 0]];
+                        double worst = values[order[n]];
+
+                        Extrapolate(centroid, reflection, trial);
+                        double fr = objective(trial);
+                        CountEvaluation();
+
+                        if (Compare(fr, best) < 0) {
+                            Extrapolate(centroid, reflection * expansion, second);
+                            double fe = objective(second);
+                            CountEvaluation();
+                            if (Compare(fe, fr) < 0)
+                                Accept(second, fe);
+                            else
+                                Accept(trial, fr);
+                        }
+                        else if (Compare(fr, nextWorst) < 0) {
+                            Accept(trial, fr);
+                        }
+                        else {
+                            // Outside contraction if the reflection improved on
+                            // the worst vertex, inside contraction otherwise
+                            bool outside = Compare(fr, worst) < 0;
+                            Extrapolate(centroid, outside ? reflection * contraction : -contraction, second);
+                            double fc = objective(second);
+                            CountEvaluation();
+                            if (Compare(fc, outside ? fr : worst) <= 0) {
+                                Accept(second, fc);
+                            }
+                            else {
+                                ForEach(n, shrinkBody);
+                            }
+                        }
+                        SortVertices();
+
+                        if (!Report(iteration, values[order[0]])) {
+                            status = MinimizerStatus::Stopped;
+                            break;
+                        }
+                    }
+
+                    Array::Copy(Vertex(order[0])->Elements, x->Elements, n);
+                    return Result(status, values[order[0]], iteration);
+                }
+                finally {
+                    objective = nullptr;
+                }
+            }
+        };
+    }
+}
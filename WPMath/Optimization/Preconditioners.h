@@ -0,0 +1,139 @@
+#pragma once
+
+#include "../Native/Iterative.h"
+#include "../Core/SparseMatrix.h"
+#include "../Core/Vector.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Approximates the inverse of a system matrix so that Krylov solvers
+        /// converge in fewer iterations. Apply must not allocate; it runs once
+        /// or twice per iteration.
+        /// </summary>
+        public ref class Preconditioner abstract {
+        public:
+            /// <summary>
+            /// Writes z = M^-1 * r. z is never the same vector as r.
+            /// </summary>
+            virtual void Apply(Vector<double>^ r, Vector<double>^ z) abstract;
+
+            /// <summary>
+            /// Rebuilds the preconditioner for a matrix with new values. Cheap
+            /// to call every frame when the sparsity pattern is unchanged.
+            /// </summary>
+            virtual void Update(CsrMatrix<double>^ matrix) abstract;
+        };
+
+        /// <summary>
+        /// Diagonal (Jacobi) preconditioner: M = diag(A). Nearly free to build
+        /// and apply; effective when the matrix is diagonally dominant with
+        /// widely varying row scales.
+        /// </summary>
+        public ref class JacobiPreconditioner : Preconditioner {
+        private:
+            array<double>^ inverseDiagonal;
+
+        public:
+            /// <summary>
+            /// Creates a preconditioner from the diagonal of a square matrix
+            /// </summary>
+            JacobiPreconditioner(CsrMatrix<double>^ matrix) {
+                Update(matrix);
+            }
+
+            virtual void Update(CsrMatrix<double>^ matrix) override {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                int n = matrix->Rows;
+                if (inverseDiagonal == nullptr || inverseDiagonal->Length != n)
+                    inverseDiagonal = gcnew array<double>(n);
+
+                SparseStorage<double>^ s = matrix->Storage;
+                for (int i = 0; i < n; i++) {
+                    double d = s->Get(i, i);
+                    // A missing diagonal leaves that row unscaled
+                    inverseDiagonal[i] = d != 0 ? 1.0 / d : 1.0;
+                }
+            }
+
+            virtual void Apply(Vector<double>^ r, Vector<double>^ z) override {
+                int n = inverseDiagonal->Length;
+                if (n == 0)
+                    return;
+                pin_ptr<double> pd = &inverseDiagonal[0];
+                pin_ptr<double> pr = &r->Elements[0];
+                pin_ptr<double> pz = &z->Elements[0];
+                Native::KrylovDiagonalScale(pd, pr, pz, n);
+            }
+        };
+
+        /// <summary>
+        /// Incomplete LU factorization with zero fill-in, ILU(0): L and U keep
+        /// exactly the sparsity pattern of A. Much stronger than Jacobi for
+        /// matrices from grids and constraint graphs, at the cost of two
+        /// triangular sweeps per application. Every diagonal entry must be
+        /// stored and nonzero.
+        /// </summary>
+        public ref class IncompleteLUPreconditioner : Preconditioner {
+        private:
+            array<int>^ pointers;
+            array<int>^ indices;
+            array<double>^ factors;
+            array<int>^ diagonal;
+
+        public:
+            /// <summary>
+            /// Factors a square matrix
+            /// </summary>
+            IncompleteLUPreconditioner(CsrMatrix<double>^ matrix) {
+                Update(matrix);
+            }
+
+            virtual void Update(CsrMatrix<double>^ matrix) override {
+                if (matrix->Rows != matrix->Columns)
+                    throw gcnew ArgumentException("Matrix must be square");
+
+                SparseStorage<double>^ s = matrix->Storage;
+                int n = matrix->Rows;
+                // The pattern is shared with the matrix, which is immutable;
+                // only the values are copied and factored
+                pointers = s->Pointers;
+                indices = s->Indices;
+                if (factors == nullptr || factors->Length != s->Values->Length)
+                    factors = gcnew array<double>(s->Values->Length);
+                Array::Copy(s->Values, factors, factors->Length);
+                if (diagonal == nullptr || diagonal->Length != n)
+                    diagonal = gcnew array<int>(n);
+                if (n == 0)
+                    return;
+                if (factors->Length == 0)
+                    throw gcnew ArgumentException("ILU(0) requires a nonzero diagonal");
+
+                pin_ptr<int> pp = &pointers[0];
+                pin_ptr<int> pi = &indices[0];
+                pin_ptr<double> pv = &factors[0];
+                pin_ptr<int> pd = &diagonal[0];
+                int row = Native::IluFactor(pp, pi, pv, n, pd);
+                if (row >= 0)
+                    throw gcnew ArgumentException("ILU(0) requires a nonzero diagonal; pivot " + row + " is zero or missing");
+            }
+
+            virtual void Apply(Vector<double>^ r, Vector<double>^ z) override {
+                int n = diagonal->Length;
+                if (n == 0)
+                    return;
+                pin_ptr<int> pp = &pointers[0];
+                pin_ptr<int> pi = &indices[0];
+                pin_ptr<double> pv = &factors[0];
+                pin_ptr<int> pd = &diagonal[0];
+                pin_ptr<double> pr = &r->Elements[0];
+                pin_ptr<double> pz = &z->Elements[0];
+                Native::IluSolve(pp, pi, pv, pd, n, pr, pz);
+            }
+        };
+    }
+}
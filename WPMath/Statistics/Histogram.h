@@ -0,0 +1,209 @@
+#pragma once
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Fixed-range histogram with uniform bins over [Minimum, Maximum),
+        /// plus underflow and overflow counters, so memory stays bounded
+        /// however long the stream. The upper bound itself falls into the last
+        /// bin; NaN is ignored. Histograms with the same layout merge exactly.
+        /// </summary>
+        public ref class Histogram {
+        private:
+            double minimum, maximum, scale;
+            array<long long>^ bins;
+            long long underflow, overflow, total;
+
+            void Add(double x) {
+                if (x < minimum) {
+                    underflow++;
+                }
+                else if (x > maximum) {
+                    overflow++;
+                }
+                else if (x >= minimum) {
+                    int bin = (int)((x - minimum) * scale);
+                    bins[bin < bins->Length ? bin : bins->Length - 1]++;
+                }
+                else {
+                    return;
+                }
+                total++;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a histogram of binCount equal bins spanning [minimum, maximum)
+            /// </summary>
+            Histogram(double minimum, double maximum, int binCount) {
+                if (binCount <= 0)
+                    throw gcnew ArgumentOutOfRangeException("binCount");
+                if (!(maximum > minimum) || Double::IsInfinity(maximum - minimum))
+                    throw gcnew ArgumentException("Range must be finite and non-empty", "maximum");
+                this->minimum = minimum;
+                this->maximum = maximum;
+                scale = binCount / (maximum - minimum);
+                bins = gcnew array<long long>(binCount);
+            }
+
+            /// <summary>
+            /// Gets the lower bound of the range
+            /// </summary>
+            property double Minimum {
+                double get() { return minimum; }
+            }
+
+            /// <summary>
+            /// Gets the upper bound of the range
+            /// </summary>
+            property double Maximum {
+                double get() { return maximum; }
+            }
+
+            /// <summary>
+            /// Gets the number of bins
+            /// </summary>
+            property int BinCount {
+                int get() { return bins->Length; }
+            }
+
+            /// <summary>
+            /// Gets the width of each bin
+            /// </summary>
+            property double BinWidth {
+                double get() { return (maximum - minimum) / bins->Length; }
+            }
+
+            /// <summary>
+            /// Gets the number of values in a bin
+            /// </summary>
+            property long long default[int] {
+                long long get(int bin) { return bins[bin]; }
+            }
+
+            /// <summary>
+            /// Gets the number of values below Minimum
+            /// </summary>
+            property long long Underflow {
+                long long get() { return underflow; }
+            }
+
+            /// <summary>
+            /// Gets the number of values above Maximum
+            /// </summary>
+            property long long Overflow {
+                long long get() { return overflow; }
+            }
+
+            /// <summary>
+            /// Gets the number of values, including under- and overflow
+            /// </summary>
+            property long long Count {
+                long long get() { return total; }
+            }
+
+            /// <summary>
+            /// Gets the lower edge of a bin
+            /// </summary>
+            double BinLowerBound(int bin) {
+                if (bin < 0 || bin > bins->Length)
+                    throw gcnew ArgumentOutOfRangeException("bin");
+                return bin == bins->Length ? maximum : minimum + bin / scale;
+            }
+
+            /// <summary>
+            /// Gets the bin a value falls into, -1 below the range and
+            /// BinCount above it
+            /// </summary>
+            int BinOf(double x) {
+                if (Double::IsNaN(x))
+                    throw gcnew ArgumentOutOfRangeException("x");
+                if (x < minimum)
+                    return -1;
+                if (x > maximum)
+                    return bins->Length;
+                int bin = (int)((x - minimum) * scale);
+                return bin < bins->Length ? bin : bins->Length - 1;
+            }
+
+            /// <summary>
+            /// Adds one value
+            /// </summary>
+            void Push(double x) {
+                Add(x);
+            }
+
+            /// <summary>
+            /// Adds length values starting at offset
+            /// </summary>
+            void Push(array<double>^ values, int offset, int length) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (offset < 0 || length < 0 || offset > values->Length - length)
+                    throw gcnew ArgumentOutOfRangeException("offset");
+                for (int i = 0; i < length; i++)
+                    Add(values[offset + i]);
+            }
+
+            /// <summary>
+            /// Adds length values starting at offset
+            /// </summary>
+            void Push(array<float>^ values, int offset, int length) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (offset < 0 || length < 0 || offset > values->Length - length)
+                    throw gcnew ArgumentOutOfRangeException("offset");
+                for (int i = 0; i < length; i++)
+                    Add(values[offset + i]);
+            }
+
+            /// <summary>
+            /// Adds the counts of a histogram with the same range and bins
+            /// </summary>
+            void Merge(Histogram^ other) {
+                if (other == nullptr)
+                    throw gcnew ArgumentNullException("other");
+                if (other->minimum != minimum || other->maximum != maximum || other->bins->Length != bins->Length)
+                    throw gcnew ArgumentException("Histogram layouts differ", "other");
+                for (int i = 0; i < bins->Length; i++)
+                    bins[i] += other->bins[i];
+                underflow += other->underflow;
+                overflow += other->overflow;
+                total += other->total;
+            }
+
+            /// <summary>
+            /// Estimates the value at probability q in [0, 1], assuming values
+            /// are spread evenly within each bin. Under- and overflow count
+            /// towards the rank but clamp to the range. NaN when empty.
+            /// </summary>
+            double Quantile(double q) {
+                if (!(q >= 0 && q <= 1))
+                    throw gcnew ArgumentOutOfRangeException("q");
+                if (total == 0)
+                    return Double::NaN;
+                double rank = q * total;
+                double seen = (double)underflow;
+                if (rank <= seen)
+                    return minimum;
+                for (int i = 0; i < bins->Length; i++) {
+                    long long c = bins[i];
+                    if (c > 0 && rank <= seen + c)
+                        return minimum + (i + (rank - seen) / c) / scale;
+                    seen += c;
+                }
+                return maximum;
+            }
+
+            /// <summary>
+            /// Forgets all values
+            /// </summary>
+            void Clear() {
+                Array::Clear(bins, 0, bins->Length);
+                underflow = overflow = total = 0;
+            }
+        };
+    }
+}
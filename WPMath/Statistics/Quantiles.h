@@ -0,0 +1,473 @@
+#pragma once
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Streaming estimate of one quantile with the P² algorithm (Jain and
+        /// Chlamtac): five markers whose heights follow a piecewise-parabolic
+        /// fit of the empirical distribution. Constant memory and time per
+        /// value, no allocation after construction. Cannot be merged; use
+        /// TDigest when partial results must be combined.
+        /// </summary>
+        public ref class P2Quantile {
+        private:
+            double probability;
+            array<double>^ heights;
+            array<double>^ positions;
+            array<double>^ desired;
+            array<double>^ increments;
+            long long count;
+
+            double Parabolic(int i, double d) {
+                double np = positions[i + 1], n = positions[i], nm = positions[i - 1];
+                return heights[i] + d / (np - nm) *
+                       ((n - nm + d) * (heights[i + 1] - heights[i]) / (np - n) +
+                        (np - n - d) * (heights[i] - heights[i - 1]) / (n - nm));
+            }
+
+            double Linear(int i, int d) {
+                return heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+            }
+
+        public:
+            /// <summary>
+            /// Creates an estimator for the quantile at probability p in (0, 1)
+            /// </summary>
+            P2Quantile(double p) {
+                if (!(p > 0 && p < 1))
+                    throw gcnew ArgumentOutOfRangeException("p");
+                probability = p;
+                heights = gcnew array<double>(5);
+                positions = gcnew array<double>(5);
+                desired = gcnew array<double>(5);
+                increments = gcnew array<double>(5);
+                Clear();
+            }
+
+            /// <summary>
+            /// Gets the target probability
+            /// </summary>
+            property double Probability {
+                double get() { return probability; }
+            }
+
+            /// <summary>
+            /// Gets the number of values seen
+            /// </summary>
+            property long long Count {
+                long long get() { return count; }
+            }
+
+            /// <summary>
+            /// Adds one value; NaN is ignored
+            /// </summary>
+            void Push(double x) {
+                if (Double::IsNaN(x))
+                    return;
+
+                // The first five values are kept sorted and are the markers
+                if (count < 5) {
+                    int i = (int)count;
+                    while (i > 0 && heights[i - 1] > x) {
+                        heights[i] = heights[i - 1];
+                        i--;
+                    }
+                    heights[i] = x;
+                    count++;
+                    return;
+                }
+
+                int k;
+                if (x < heights[0]) {
+                    heights[0] = x;
+                    k = 0;
+                }
+                else if (x >= heights[4]) {
+                    heights[4] = x;
+                    k = 3;
+                }
+                else {
+                    k = 0;
+                    while (x >= heights[k + 1])
+                        k++;
+                }
+                count++;
+
+                for (int i = k + 1; i < 5; i++)
+                    positions[i] += 1;
+                for (int i = 0; i < 5; i++)
+                    desired[i] += increments[i];
+
+                // Move the middle markers towards their desired positions
+                for (int i = 1; i <= 3; i++) {
+                    double d = desired[i] - positions[i];
+                    if ((d >= 1 && positions[i + 1] - positions[i] > 1) ||
+                        (d <= -1 && positions[i - 1] - positions[i] < -1)) {
+                        int step = d > 0 ? 1 : -1;
+                        double h = Parabolic(i, step);
+                        if (!(heights[i - 1] < h && h < heights[i + 1]))
+                            h = Linear(i, step);
+                        heights[i] = h;
+                        positions[i] += step;
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Adds length values starting at offset
+            /// </summary>
+            void Push(array<double>^ values, int offset, int length) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (offset < 0 || length < 0 || offset > values->Length - length)
+                    throw gcnew ArgumentOutOfRangeException("offset");
+                for (int i = 0; i < length; i++)
+                    Push(values[offset + i]);
+            }
+
+            /// <summary>
+            /// Gets the current estimate (NaN when empty). Exact, by
+            /// interpolation, until five values have been seen.
+            /// </summary>
+            property double Value {
+                double get() {
+                    if (count == 0)
+                        return Double::NaN;
+                    if (count <= 5) {
+                        double index = probability * (count - 1);
+                        int lo = (int)index;
+                        int hi = lo + 1 < count ? lo + 1 : lo;
+                        return heights[lo] + (index - lo) * (heights[hi] - heights[lo]);
+                    }
+                    return heights[2];
+                }
+            }
+
+            /// <summary>
+            /// Forgets all values
+            /// </summary>
+            void Clear() {
+                count = 0;
+                double p = probability;
+                for (int i = 0; i < 5; i++)
+                    positions[i] = i;
+                desired[0] = 0;
+                desired[1] = 2 * p;
+                desired[2] = 4 * p;
+                desired[3] = 2 + 2 * p;
+                desired[4] = 4;
+                increments[0] = 0;
+                increments[1] = p / 2;
+                increments[2] = p;
+                increments[3] = (1 + p) / 2;
+                increments[4] = 1;
+            }
+        };
+
+        /// <summary>
+        /// Mergeable streaming quantile sketch (Dunning's merging t-digest).
+        /// Values are clustered into weighted centroids whose size is limited
+        /// by the arcsine scale function, so clusters are small near the tails
+        /// and quantiles like p99.9 stay accurate. Memory is bounded by the
+        /// compression: about Compression centroids plus a buffer of
+        /// 5 * Compression values. Pushes do not allocate.
+        /// </summary>
+        public ref class TDigest {
+        private:
+            double compression;
+            array<double>^ means;
+            array<double>^ weights;
+            int centroids;
+            array<double>^ bufferMeans;
+            array<double>^ bufferWeights;
+            int buffered;
+            array<double>^ mergedMeans;
+            array<double>^ mergedWeights;
+            double totalWeight;
+            double min, max;
+
+            double ScaleK(double q) {
+                return compression / (2 * System::Math::PI) * System::Math::Asin(2 * q - 1);
+            }
+
+            double ScaleQ(double k) {
+                return (System::Math::Sin(k * 2 * System::Math::PI / compression) + 1) / 2;
+            }
+
+            void Add(double mean, double weight) {
+                if (buffered == bufferMeans->Length)
+                    Flush();
+                bufferMeans[buffered] = mean;
+                bufferWeights[buffered] = weight;
+                buffered++;
+                if (mean < min)
+                    min = mean;
+                if (mean > max)
+                    max = mean;
+            }
+
+            /// <summary>
+            /// Sorts the buffer and merges it with the centroids in one sweep,
+            /// combining neighbours while the merged cluster fits the scale
+            /// function's size limit
+            /// </summary>
+            void Flush() {
+                if (buffered == 0)
+                    return;
+                Array::Sort(bufferMeans, bufferWeights, 0, buffered);
+
+                double total = totalWeight;
+                for (int i = 0; i < buffered; i++)
+                    total += bufferWeights[i];
+
+                int a = 0, b = 0, out = 0;
+                double soFar = 0, limit = 0;
+                double curMean = 0, curWeight = 0;
+                while (a < centroids || b < buffered) {
+                    double m, w;
+                    if (b >= buffered || (a < centroids && means[a] <= bufferMeans[b])) {
+                        m = means[a];
+                        w = weights[a];
+                        a++;
+                    }
+                    else {
+                        m = bufferMeans[b];
+                        w = bufferWeights[b];
+                        b++;
+                    }
+
+                    if (curWeight == 0) {
+                        curMean = m;
+                        curWeight = w;
+                        limit = total * ScaleQ(ScaleK(0) + 1);
+                    }
+                    else if (soFar + curWeight + w <= limit) {
+                        curWeight += w;
+                        curMean += (m - curMean) * w / curWeight;
+                    }
+                    else {
+                        mergedMeans[out] = curMean;
+                        mergedWeights[out] = curWeight;
+                        out++;
+                        soFar += curWeight;
+                        limit = total * ScaleQ(ScaleK(System::Math::Min(1.0, soFar / total)) + 1);
+                        curMean = m;
+                        curWeight = w;
+                    }
+                }
+                mergedMeans[out] = curMean;
+                mergedWeights[out] = curWeight;
+                out++;
+
+                array<double>^ t = means;
+                means = mergedMeans;
+                mergedMeans = t;
+                t = weights;
+                weights = mergedWeights;
+                mergedWeights = t;
+                centroids = out;
+                totalWeight = total;
+                buffered = 0;
+            }
+
+        public:
+            /// <summary>
+            /// Creates a digest with compression 100 (about 1% worst-case
+            /// error in the middle, far less in the tails)
+            /// </summary>
+            TDigest() {
+                Initialize(100);
+            }
+
+            /// <summary>
+            /// Creates a digest with specified compression (at least 10);
+            /// larger is more accurate and uses more memory
+            /// </summary>
+            TDigest(double compression) {
+                if (!(compression >= 10))
+                    throw gcnew ArgumentOutOfRangeException("compression");
+                Initialize(compression);
+            }
+
+        private:
+            void Initialize(double compression) {
+                this->compression = compression;
+                // The arcsine scale spans compression / 2 units of k; each
+                // centroid but the last covers at least one unit together
+                // with its neighbour, which bounds the count by compression
+                int capacity = (int)System::Math::Ceiling(compression) + 8;
+                int buffer = 5 * capacity;
+                means = gcnew array<double>(capacity + buffer);
+                weights = gcnew array<double>(capacity + buffer);
+                mergedMeans = gcnew array<double>(capacity + buffer);
+                mergedWeights = gcnew array<double>(capacity + buffer);
+                bufferMeans = gcnew array<double>(buffer);
+                bufferWeights = gcnew array<double>(buffer);
+                Clear();
+            }
+
+        public:
+            /// <summary>
+            /// Gets the compression parameter
+            /// </summary>
+            property double Compression {
+                double get() { return compression; }
+            }
+
+            /// <summary>
+            /// Gets the total weight (number of values) seen
+            /// </summary>
+            property double Count {
+                double get() { return totalWeight + BufferedWeight(); }
+            }
+
+            /// <summary>
+            /// Gets the number of centroids after merging pending values
+            /// </summary>
+            property int CentroidCount {
+                int get() {
+                    Flush();
+                    return centroids;
+                }
+            }
+
+            /// <summary>
+            /// Adds one value; NaN is ignored
+            /// </summary>
+            void Push(double x) {
+                if (!Double::IsNaN(x))
+                    Add(x, 1);
+            }
+
+            /// <summary>
+            /// Adds a value with specified positive weight
+            /// </summary>
+            void Push(double x, double weight) {
+                if (!(weight > 0))
+                    throw gcnew ArgumentOutOfRangeException("weight");
+                if (!Double::IsNaN(x))
+                    Add(x, weight);
+            }
+
+            /// <summary>
+            /// Adds length values starting at offset
+            /// </summary>
+            void Push(array<double>^ values, int offset, int length) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (offset < 0 || length < 0 || offset > values->Length - length)
+                    throw gcnew ArgumentOutOfRangeException("offset");
+                for (int i = 0; i < length; i++)
+                    Push(values[offset + i]);
+            }
+
+            /// <summary>
+            /// Folds another digest into this one. Digests built on separate
+            /// threads over parts of a stream merge into a sketch of the whole.
+            /// </summary>
+            void Merge(TDigest^ other) {
+                if (other == nullptr)
+                    throw gcnew ArgumentNullException("other");
+                if (other == this)
+                    throw gcnew ArgumentException("Cannot merge a digest into itself", "other");
+                other->Flush();
+                for (int i = 0; i < other->centroids; i++)
+                    Add(other->means[i], other->weights[i]);
+                if (other->centroids > 0) {
+                    if (other->min < min)
+                        min = other->min;
+                    if (other->max > max)
+                        max = other->max;
+                }
+            }
+
+            /// <summary>
+            /// Estimates the value at probability q in [0, 1] (NaN when empty)
+            /// </summary>
+            double Quantile(double q) {
+                if (!(q >= 0 && q <= 1))
+                    throw gcnew ArgumentOutOfRangeException("q");
+                Flush();
+                if (centroids == 0)
+                    return Double::NaN;
+                if (centroids == 1 || q == 0)
+                    return q == 0 ? min : (q == 1 ? max : means[0]);
+                if (q == 1)
+                    return max;
+
+                double index = q * totalWeight;
+                // Centroid i is treated as centred at cumulative weight
+                // sum(w[0..i-1]) + w[i] / 2, with min and max as the ends
+                double left = weights[0] / 2;
+                if (index < left)
+                    return min + (means[0] - min) * (index / left);
+
+                double position = left;
+                for (int i = 0; i < centroids - 1; i++) {
+                    double step = (weights[i] + weights[i + 1]) / 2;
+                    if (index < position + step)
+                        return means[i] + (means[i + 1] - means[i]) * ((index - position) / step);
+                    position += step;
+                }
+                double right = weights[centroids - 1] / 2;
+                double t = right > 0 ? System::Math::Min(1.0, (index - position) / right) : 1;
+                return means[centroids - 1] + (max - means[centroids - 1]) * t;
+            }
+
+            /// <summary>
+            /// Estimates the fraction of values at or below x (NaN when empty)
+            /// </summary>
+            double Cdf(double x) {
+                Flush();
+                if (centroids == 0)
+                    return Double::NaN;
+                if (x < min)
+                    return 0;
+                if (x >= max)
+                    return 1;
+                if (centroids == 1)
+                    return max > min ? (x - min) / (max - min) : 0.5;
+
+                double left = weights[0] / 2;
+                if (x < means[0])
+                    return means[0] > min ? left * (x - min) / (means[0] - min) / totalWeight : 0;
+
+                double position = left;
+                for (int i = 0; i < centroids - 1; i++) {
+                    double step = (weights[i] + weights[i + 1]) / 2;
+                    if (x < means[i + 1]) {
+                        double span = means[i + 1] - means[i];
+                        double t = span > 0 ? (x - means[i]) / span : 0.5;
+                        return (position + step * t) / totalWeight;
+                    }
+                    position += step;
+                }
+                double right = weights[centroids - 1] / 2;
+                double span = max - means[centroids - 1];
+                double t = span > 0 ? (x - means[centroids - 1]) / span : 1;
+                return (position + right * t) / totalWeight;
+            }
+
+            /// <summary>
+            /// Forgets all values
+            /// </summary>
+            void Clear() {
+                centroids = 0;
+                buffered = 0;
+                totalWeight = 0;
+                min = Double::PositiveInfinity;
+                max = Double::NegativeInfinity;
+            }
+
+        private:
+            double BufferedWeight() {
+                double w = 0;
+                for (int i = 0; i < buffered; i++)
+                    w += bufferWeights[i];
+                return w;
+            }
+        };
+    }
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "../Native/Moments.h"
+#include "../Core/Parallelism.h"
+#include "../Core/Vector.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Single-pass, numerically stable summary of a stream: count, mean,
+        /// variance, skewness, kurtosis and extremes, in constant memory.
+        /// Single values use Welford's update; arrays are reduced block by
+        /// block in native code. Accumulators merge exactly, so each thread
+        /// can summarize its own share of the data and combine the results.
+        /// Updates never allocate. An instance is not thread-safe.
+        /// </summary>
+        public ref class RunningStatistics {
+        private:
+            long long count;
+            double mean, m2, m3, m4, min, max;
+
+            void Load(Native::Moments& m) {
+                m.Count = count;
+                m.Mean = mean;
+                m.M2 = m2;
+                m.M3 = m3;
+                m.M4 = m4;
+                m.Min = min;
+                m.Max = max;
+            }
+
+            void Store(const Native::Moments& m) {
+                count = m.Count;
+                mean = m.Mean;
+                m2 = m.M2;
+                m3 = m.M3;
+                m4 = m.M4;
+                min = m.Min;
+                max = m.Max;
+            }
+
+            static void CheckRange(Array^ values, int offset, int length) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (offset < 0 || length < 0 || offset > values->Length - length)
+                    throw gcnew ArgumentOutOfRangeException("offset");
+            }
+
+            void PushNative(array<double>^ values, int offset, int length, int degreeOfParallelism) {
+                if (length == 0)
+                    return;
+                Native::Moments m;
+                Load(m);
+                pin_ptr<double> p = &values[offset];
+                if (degreeOfParallelism == 1)
+                    Native::AccumulateMoments<double>(p, length, m);
+                else
+                    Native::AccumulateMomentsParallel<double>(p, length, m, degreeOfParallelism);
+                Store(m);
+            }
+
+            void PushNative(array<float>^ values, int offset, int length, int degreeOfParallelism) {
+                if (length == 0)
+                    return;
+                Native::Moments m;
+                Load(m);
+                pin_ptr<float> p = &values[offset];
+                if (degreeOfParallelism == 1)
+                    Native::AccumulateMoments<float>(p, length, m);
+                else
+                    Native::AccumulateMomentsParallel<float>(p, length, m, degreeOfParallelism);
+                Store(m);
+            }
+
+        public:
+            /// <summary>
+            /// Creates an empty accumulator
+            /// </summary>
+            RunningStatistics() {}
+
+            /// <summary>
+            /// Summarizes an array, splitting it across at most the given number
+            /// of threads (0 means all hardware threads). The result does not
+            /// depend on the thread count beyond round-off.
+            /// </summary>
+            static RunningStatistics^ Compute(array<double>^ values, int degreeOfParallelism) {
+                CheckRange(values, 0, values != nullptr ? values->Length : 0);
+                if (degreeOfParallelism < 0)
+                    throw gcnew ArgumentOutOfRangeException("degreeOfParallelism");
+                RunningStatistics^ result = gcnew RunningStatistics();
+                result->PushNative(values, 0, values->Length, degreeOfParallelism);
+                return result;
+            }
+
+            /// <summary>
+            /// Summarizes an array, using the global Parallelism settings
+            /// </summary>
+            static RunningStatistics^ Compute(array<double>^ values) {
+                return Compute(values, Parallelism::DefaultDegree);
+            }
+
+            /// <summary>
+            /// Adds one value
+            /// </summary>
+            void Push(double value) {
+                Native::Moments m;
+                Load(m);
+                Native::PushMoment(m, value);
+                Store(m);
+            }
+
+            /// <summary>
+            /// Adds length values starting at offset
+            /// </summary>
+            void Push(array<double>^ values, int offset, int length) {
+                CheckRange(values, offset, length);
+                PushNative(values, offset, length, 1);
+            }
+
+            /// <summary>
+            /// Adds length values starting at offset
+            /// </summary>
+            void Push(array<float>^ values, int offset, int length) {
+                CheckRange(values, offset, length);
+                PushNative(values, offset, length, 1);
+            }
+
+            /// <summary>
+            /// Adds all values of an array
+            /// </summary>
+            void Push(array<double>^ values) {
+                Push(values, 0, values != nullptr ? values->Length : 0);
+            }
+
+            /// <summary>
+            /// Adds all elements of a vector
+            /// </summary>
+            generic<typename T>
+            where T : value class
+            void Push(Vector<T>^ values) {
+                if (values == nullptr)
+                    throw gcnew ArgumentNullException("values");
+                if (T::typeid == Double::typeid) {
+                    PushNative(safe_cast<array<double>^>((Object^)values->Elements), 0, values->Size, 1);
+                    return;
+                }
+                if (T::typeid == Single::typeid) {
+                    PushNative(safe_cast<array<float>^>((Object^)values->Elements), 0, values->Size, 1);
+                    return;
+                }
+                for (int i = 0; i < values->Size; i++)
+                    Push(Convert::ToDouble(values[i]));
+            }
+
+            /// <summary>
+            /// Folds another accumulator into this one, as if its values had
+            /// been pushed here
+            /// </summary>
+            void Merge(RunningStatistics^ other) {
+                if (other == nullptr)
+                    throw gcnew ArgumentNullException("other");
+                Native::Moments a, b;
+                Load(a);
+                other->Load(b);
+                Native::MergeMoments(a, b);
+                Store(a);
+            }
+
+            /// <summary>
+            /// Forgets all values
+            /// </summary>
+            void Clear() {
+                count = 0;
+                mean = m2 = m3 = m4 = min = max = 0;
+            }
+
+            /// <summary>
+            /// Gets the number of values
+            /// </summary>
+            property long long Count {
+                long long get() { return count; }
+            }
+
+            /// <summary>
+            /// Gets the mean (NaN when empty)
+            /// </summary>
+            property double Mean {
+                double get() { return count > 0 ? mean : Double::NaN; }
+            }
+
+            /// <summary>
+            /// Gets the unbiased sample variance (NaN below two values)
+            /// </summary>
+            property double Variance {
+                double get() { return count > 1 ? m2 / (count - 1) : Double::NaN; }
+            }
+
+            /// <summary>
+            /// Gets the population variance (NaN when empty)
+            /// </summary>
+            property double PopulationVariance {
+                double get() { return count > 0 ? m2 / count : Double::NaN; }
+            }
+
+            /// <summary>
+            /// Gets the sample standard deviation
+            /// </summary>
+            property double StandardDeviation {
+                double get() { return System::Math::Sqrt(Variance); }
+            }
+
+            /// <summary>
+            /// Gets the population skewness g1 (NaN when the variance is zero)
+            /// </summary>
+            property double Skewness {
+                double get() {
+                    if (count < 2 || m2 == 0)
+                        return Double::NaN;
+                    return System::Math::Sqrt((double)count) * m3 / System::Math::Pow(m2, 1.5);
+                }
+            }
+
+            /// <summary>
+            /// Gets the population excess kurtosis g2, zero for a normal
+            /// distribution (NaN when the variance is zero)
+            /// </summary>
+            property double Kurtosis {
+                double get() {
+                    if (count < 2 || m2 == 0)
+                        return Double::NaN;
+                    return (double)count * m4 / (m2 * m2) - 3.0;
+                }
+            }
+
+            /// <summary>
+            /// Gets the smallest value (NaN when empty)
+            /// </summary>
+            property double Minimum {
+                double get() { return count > 0 ? min : Double::NaN; }
+            }
+
+            /// <summary>
+            /// Gets the largest value (NaN when empty)
+            /// </summary>
+            property double Maximum {
+                double get() { return count > 0 ? max : Double::NaN; }
+            }
+        };
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "../Native/Transcendental.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Element-wise sin, cos, atan2, exp and log over arrays with SIMD
+        /// polynomial kernels, several times faster than calling System::Math
+        /// per element. Results go into caller-owned buffers and may overwrite
+        /// the inputs. Only the first count elements of each buffer are used.
+        ///
+        /// Measured max error against a long double reference, in units in the
+        /// last place: sin/cos 2 (double) and 3 (float), exp 2 and 1, log 1.5
+        /// and 1, atan2 3 and 3. Trigonometric arguments beyond 1e8 (double)
+        /// or 8192 (float) take the exact System::Math path.
+        /// </summary>
+        public ref class BatchMath {
+        private:
+            static void CheckBatch(Array^ buffer, String^ name, int count) {
+                if (buffer == nullptr)
+                    throw gcnew ArgumentNullException(name);
+                if (buffer->Length < count)
+                    throw gcnew ArgumentException("Buffer is shorter than the batch", name);
+            }
+
+            static void CheckCount(int count) {
+                if (count < 0)
+                    throw gcnew ArgumentOutOfRangeException("count");
+            }
+
+            template<typename T>
+            static void SinCosNative(array<T>^ x, array<T>^ sin, array<T>^ cos, int count) {
+                CheckCount(count);
+                CheckBatch(x, "x", count);
+                if (sin != nullptr)
+                    CheckBatch(sin, "sin", count);
+                if (cos != nullptr)
+                    CheckBatch(cos, "cos", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> px = &x[0];
+                pin_ptr<T> ps = nullptr;
+                if (sin != nullptr)
+                    ps = &sin[0];
+                pin_ptr<T> pc = nullptr;
+                if (cos != nullptr)
+                    pc = &cos[0];
+                Native::VectorSinCos<T>(px, ps, pc, count);
+            }
+
+            template<typename T>
+            static void ExpNative(array<T>^ x, array<T>^ result, int count, bool log) {
+                CheckCount(count);
+                CheckBatch(x, "x", count);
+                CheckBatch(result, "result", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> px = &x[0], pr = &result[0];
+                if (log)
+                    Native::VectorLog<T>(px, pr, count);
+                else
+                    Native::VectorExp<T>(px, pr, count);
+            }
+
+            template<typename T>
+            static void Atan2Native(array<T>^ y, array<T>^ x, array<T>^ result, int count) {
+                CheckCount(count);
+                CheckBatch(y, "y", count);
+                CheckBatch(x, "x", count);
+                CheckBatch(result, "result", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> py = &y[0], px = &x[0], pr = &result[0];
+                Native::VectorAtan2<T>(py, px, pr, count);
+            }
+
+        public:
+            /// <summary>
+            /// Computes result[i] = sin(x[i])
+            /// </summary>
+            static void Sin(array<double>^ x, array<double>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                SinCosNative<double>(x, result, nullptr, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = sin(x[i])
+            /// </summary>
+            static void Sin(array<float>^ x, array<float>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                SinCosNative<float>(x, result, nullptr, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = cos(x[i])
+            /// </summary>
+            static void Cos(array<double>^ x, array<double>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                SinCosNative<double>(x, nullptr, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = cos(x[i])
+            /// </summary>
+            static void Cos(array<float>^ x, array<float>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                SinCosNative<float>(x, nullptr, result, count);
+            }
+
+            /// <summary>
+            /// Computes sin[i] = sin(x[i]) and cos[i] = cos(x[i]) sharing one
+            /// argument reduction, as needed for rotations
+            /// </summary>
+            static void SinCos(array<double>^ x, array<double>^ sin, array<double>^ cos, int count) {
+                if (sin == nullptr || cos == nullptr)
+                    throw gcnew ArgumentNullException(sin == nullptr ? "sin" : "cos");
+                SinCosNative<double>(x, sin, cos, count);
+            }
+
+            /// <summary>
+            /// Computes sin[i] = sin(x[i]) and cos[i] = cos(x[i]) sharing one
+            /// argument reduction, as needed for rotations
+            /// </summary>
+            static void SinCos(array<float>^ x, array<float>^ sin, array<float>^ cos, int count) {
+                if (sin == nullptr || cos == nullptr)
+                    throw gcnew ArgumentNullException(sin == nullptr ? "sin" : "cos");
+                SinCosNative<float>(x, sin, cos, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = atan2(y[i], x[i]). Unlike System::Math,
+            /// -0 is treated as +0 and two infinite arguments give NaN.
+            /// </summary>
+            static void Atan2(array<double>^ y, array<double>^ x, array<double>^ result, int count) {
+                Atan2Native<double>(y, x, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = atan2(y[i], x[i]). Unlike System::Math,
+            /// -0 is treated as +0 and two infinite arguments give NaN.
+            /// </summary>
+            static void Atan2(array<float>^ y, array<float>^ x, array<float>^ result, int count) {
+                Atan2Native<float>(y, x, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = exp(x[i])
+            /// </summary>
+            static void Exp(array<double>^ x, array<double>^ result, int count) {
+                ExpNative<double>(x, result, count, false);
+            }
+
+            /// <summary>
+            /// Computes result[i] = exp(x[i])
+            /// </summary>
+            static void Exp(array<float>^ x, array<float>^ result, int count) {
+                ExpNative<float>(x, result, count, false);
+            }
+
+            /// <summary>
+            /// Computes result[i] = log(x[i]), the natural logarithm
+            /// </summary>
+            static void Log(array<double>^ x, array<double>^ result, int count) {
+                ExpNative<double>(x, result, count, true);
+            }
+
+            /// <summary>
+            /// Computes result[i] = log(x[i]), the natural logarithm
+            /// </summary>
+            static void Log(array<float>^ x, array<float>^ result, int count) {
+                ExpNative<float>(x, result, count, true);
+            }
+        };
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "../Native/Transcendental.h"
+
+using namespace System;
+
+namespace WindowPlus {
+    namespace Math {
+        /// <summary>
+        /// Lookup-table sin and cos with linear interpolation, for UI work
+        /// such as animation and layout where a few micro-units of error are
+        /// invisible. The table holds Size samples per period; the worst
+        /// absolute error is (2 pi / Size)^2 / 8, about 4.7e-6 for the
+        /// default 1024 entries. Arguments should stay below about 1e6.
+        /// </summary>
+        public ref class SineTable {
+        private:
+            int size;
+            array<double>^ table;
+            array<float>^ tableSingle;
+
+            static SineTable^ defaultTable;
+
+            static void CheckBatch(Array^ buffer, String^ name, int count) {
+                if (buffer == nullptr)
+                    throw gcnew ArgumentNullException(name);
+                if (buffer->Length < count)
+                    throw gcnew ArgumentException("Buffer is shorter than the batch", name);
+            }
+
+            template<typename T>
+            void Lookup(array<T>^ samples, array<T>^ x, array<T>^ sin, array<T>^ cos, int count) {
+                if (count < 0)
+                    throw gcnew ArgumentOutOfRangeException("count");
+                CheckBatch(x, "x", count);
+                if (sin != nullptr)
+                    CheckBatch(sin, "sin", count);
+                if (cos != nullptr)
+                    CheckBatch(cos, "cos", count);
+                if (count == 0)
+                    return;
+
+                pin_ptr<T> pt = &samples[0], px = &x[0];
+                pin_ptr<T> ps = nullptr;
+                if (sin != nullptr)
+                    ps = &sin[0];
+                pin_ptr<T> pc = nullptr;
+                if (cos != nullptr)
+                    pc = &cos[0];
+                Native::TableSinCos<T>(pt, size, px, ps, pc, count);
+            }
+
+        public:
+            /// <summary>
+            /// Creates a table with specified samples per period, a power of
+            /// two between 16 and 2^20
+            /// </summary>
+            SineTable(int size) {
+                if (size < 16 || size > (1 << 20) || (size & (size - 1)) != 0)
+                    throw gcnew ArgumentOutOfRangeException("size", "Size must be a power of two between 16 and 2^20");
+                this->size = size;
+                int length = size + size / 4 + 1;
+                table = gcnew array<double>(length);
+                tableSingle = gcnew array<float>(length);
+                pin_ptr<double> pt = &table[0];
+                Native::BuildSineTable<double>(pt, size);
+                for (int i = 0; i < length; i++)
+                    tableSingle[i] = (float)table[i];
+            }
+
+            /// <summary>
+            /// Gets a shared table with 1024 samples per period
+            /// </summary>
+            static property SineTable^ Default {
+                SineTable^ get() {
+                    if (defaultTable == nullptr)
+                        defaultTable = gcnew SineTable(1024);
+                    return defaultTable;
+                }
+            }
+
+            /// <summary>
+            /// Gets the number of samples per period
+            /// </summary>
+            property int Size {
+                int get() { return size; }
+            }
+
+            /// <summary>
+            /// Gets the worst-case interpolation error, excluding rounding
+            /// </summary>
+            property double MaxError {
+                double get() {
+                    double step = 2 * System::Math::PI / size;
+                    return step * step / 8;
+                }
+            }
+
+            /// <summary>
+            /// Computes result[i] = sin(x[i])
+            /// </summary>
+            void Sin(array<double>^ x, array<double>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                Lookup(table, x, result, nullptr, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = sin(x[i])
+            /// </summary>
+            void Sin(array<float>^ x, array<float>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                Lookup(tableSingle, x, result, nullptr, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = cos(x[i])
+            /// </summary>
+            void Cos(array<double>^ x, array<double>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                Lookup(table, x, nullptr, result, count);
+            }
+
+            /// <summary>
+            /// Computes result[i] = cos(x[i])
+            /// </summary>
+            void Cos(array<float>^ x, array<float>^ result, int count) {
+                if (result == nullptr)
+                    throw gcnew ArgumentNullException("result");
+                Lookup(tableSingle, x, nullptr, result, count);
+            }
+
+            /// <summary>
+            /// Computes sin[i] = sin(x[i]) and cos[i] = cos(x[i])
+            /// </summary>
+            void SinCos(array<double>^ x, array<double>^ sin, array<double>^ cos, int count) {
+                if (sin == nullptr || cos == nullptr)
+                    throw gcnew ArgumentNullException(sin == nullptr ? "sin" : "cos");
+                Lookup(table, x, sin, cos, count);
+            }
+
+            /// <summary>
+            /// Computes sin[i] = sin(x[i]) and cos[i] = cos(x[i])
+            /// </summary>
+            void SinCos(array<float>^ x, array<float>^ sin, array<float>^ cos, int count) {
+                if (sin == nullptr || cos == nullptr)
+                    throw gcnew ArgumentNullException(sin == nullptr ? "sin" : "cos");
+                Lookup(tableSingle, x, sin, cos, count);
+            }
+
+            /// <summary>
+            /// Gets sin(x) for one value
+            /// </summary>
+            double Sin(double x) {
+                return Interpolate(x, 0);
+            }
+
+            /// <summary>
+            /// Gets cos(x) for one value
+            /// </summary>
+            double Cos(double x) {
+                return Interpolate(x, size / 4);
+            }
+
+        private:
+            double Interpolate(double x, int offset) {
+                double t = x * (size / (2 * System::Math::PI));
+                double floor = System::Math::Floor(t);
+                int k = (int)((long long)floor & (size - 1)) + offset;
+                return table[k] + (t - floor) * (table[k + 1] - table[k]);
+            }
+        };
+    }
+}
@@ -0,0 +1,228 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    typedef Native::Box Box;
+
+    const double SceneSize = 4096;
+    const int QueryCount = 4096;
+
+    struct Random {
+        unsigned State;
+
+        double Next() {
+            State = State * 1664525u + 1013904223u;
+            return (State >> 8) * (1.0 / 16777216.0);
+        }
+    };
+
+    Box MakeBox(double x, double y, double width, double height) {
+        Box b = { x, y, x + width, y + height };
+        return b;
+    }
+
+    /// <summary>
+    /// n boxes over a SceneSize square. sparse: small controls barely
+    /// touching, about one hit per point. ui: mostly small controls with a
+    /// few large panels behind them, about two. dense: large boxes piled on
+    /// each other, a few dozen.
+    /// </summary>
+    std::vector<Box> Scene(const char* kind, int n) {
+        std::vector<Box> boxes(n);
+        Random random = { 17 };
+        double cell = SceneSize / std::sqrt((double)n);
+        for (int i = 0; i < n; ++i) {
+            double x = random.Next() * SceneSize, y = random.Next() * SceneSize;
+            if (kind[0] == 's') {
+                boxes[i] = MakeBox(x, y, cell * (0.3 + 0.4 * random.Next()), cell * (0.3 + 0.4 * random.Next()));
+            }
+            else if (kind[0] == 'u') {
+                double scale = i % 64 == 0 ? 8 : 1;
+                boxes[i] = MakeBox(x, y, cell * scale * (0.5 + random.Next()), cell * scale * (0.3 + 0.6 * random.Next()));
+            }
+            else {
+                boxes[i] = MakeBox(x, y, cell * (2 + 6 * random.Next()), cell * (2 + 6 * random.Next()));
+            }
+        }
+        return boxes;
+    }
+
+    /// <summary>
+    /// Whether the tree finds exactly the items a linear scan finds
+    /// </summary>
+    bool SameHits(const std::vector<Box>& boxes, const std::vector<int>& hits, int found, const Box& query, bool point) {
+        int expected = 0;
+        for (int i = 0; i < (int)boxes.size(); ++i) {
+            bool hit = point ? Native::BoxContainsPoint(boxes[i], query.MinX, query.MinY) : Native::BoxOverlaps(boxes[i], query);
+            if (!hit)
+                continue;
+            bool listed = false;
+            for (int k = 0; k < found && k < (int)hits.size() && !listed; ++k)
+                listed = hits[k] == i;
+            if (!listed)
+                return false;
+            expected++;
+        }
+        return expected == found;
+    }
+
+    bool SameNearest(const std::vector<Box>& boxes, int best, double distance, double x, double y) {
+        double closest = HUGE_VAL;
+        for (int i = 0; i < (int)boxes.size(); ++i)
+            closest = std::fmin(closest, Native::BoxDistanceSquared(boxes[i], x, y));
+        return best >= 0 && Native::BoxDistanceSquared(boxes[best], x, y) == closest && distance == closest;
+    }
+
+    /// <summary>
+    /// Point, rectangle and nearest queries over each scene, after a bulk
+    /// build and after every item moved and the tree was refit. Results
+    /// are checked against a linear scan on a sample of the queries.
+    /// </summary>
+    void RunQueries(Context& context) {
+        static const char* kinds[] = { "sparse", "ui", "dense" };
+        int n = context.Quick() ? 10000 : 100000;
+        int samples = context.Quick() ? 16 : 64;
+
+        std::vector<double> px(QueryCount), py(QueryCount);
+        std::vector<Box> rects(QueryCount);
+        Random random = { 29 };
+        double cell = SceneSize / std::sqrt((double)n);
+        for (int q = 0; q < QueryCount; ++q) {
+            px[q] = random.Next() * SceneSize;
+            py[q] = random.Next() * SceneSize;
+            rects[q] = MakeBox(px[q], py[q], cell * 2 * random.Next(), cell * 2 * random.Next());
+        }
+        std::vector<int> hits(4096);
+
+        for (int s = 0; s < 3; ++s) {
+            std::vector<Box> boxes = Scene(kinds[s], n);
+            Native::AabbTree tree;
+
+            Timing t = context.Measure([&]() { tree.Build(&boxes[0], n); });
+            context.Add("aabb-tree", "build", t).Param("scene", kinds[s]).Param("items", n)
+                .Counter("ns_per_item", t.Median / n * 1e9).Counter("height", tree.Height());
+
+            Native::AabbTree incremental;
+            t = context.Measure([&]() {
+                incremental.Clear();
+                for (int i = 0; i < n; ++i)
+                    incremental.Insert(boxes[i]);
+            });
+            context.Add("aabb-tree", "insert", t).Param("scene", kinds[s]).Param("items", n)
+                .Counter("ns_per_item", t.Median / n * 1e9).Counter("height", incremental.Height());
+
+            for (int pass = 0; pass < 2; ++pass) {
+                const char* state = pass == 0 ? "built" : "refit";
+                if (pass == 1) {
+                    // Every item drifts by up to half a cell, as in a scrolled or animated layout
+                    Random drift = { 31 };
+                    for (int i = 0; i < n; ++i) {
+                        double dx = (drift.Next() - 0.5) * cell, dy = (drift.Next() - 0.5) * cell;
+                        boxes[i] = MakeBox(boxes[i].MinX + dx, boxes[i].MinY + dy, boxes[i].MaxX - boxes[i].MinX,
+                                           boxes[i].MaxY - boxes[i].MinY);
+                    }
+                    t = context.Measure([&]() {
+                        for (int i = 0; i < n; ++i)
+                            tree.SetBounds(i, boxes[i]);
+                        tree.Refit();
+                    });
+                    context.Add("aabb-tree", "refit", t).Param("scene", kinds[s]).Param("items", n)
+                        .Counter("ns_per_item", t.Median / n * 1e9);
+                }
+
+                long long total = 0;
+                t = context.Measure([&]() {
+                    total = 0;
+                    for (int q = 0; q < QueryCount; ++q)
+                        total += tree.QueryPoint(px[q], py[q], &hits[0], (int)hits.size());
+                });
+                context.Add("aabb-tree", "point", t).Param("scene", kinds[s]).Param("tree", state).Param("items", n)
+                    .Counter("ns_per_query", t.Median / QueryCount * 1e9).Counter("hits_per_query", (double)total / QueryCount);
+
+                t = context.Measure([&]() {
+                    total = 0;
+                    for (int q = 0; q < QueryCount; ++q)
+                        total += tree.QueryBox(rects[q], &hits[0], (int)hits.size());
+                });
+                context.Add("aabb-tree", "rect", t).Param("scene", kinds[s]).Param("tree", state).Param("items", n)
+                    .Counter("ns_per_query", t.Median / QueryCount * 1e9).Counter("hits_per_query", (double)total / QueryCount);
+
+                double distances = 0;
+                t = context.Measure([&]() {
+                    distances = 0;
+                    for (int q = 0; q < QueryCount; ++q) {
+                        double d;
+                        tree.Nearest(px[q], py[q], HUGE_VAL, &d);
+                        distances += std::sqrt(d);
+                    }
+                });
+                context.Add("aabb-tree", "nearest", t).Param("scene", kinds[s]).Param("tree", state).Param("items", n)
+                    .Counter("ns_per_query", t.Median / QueryCount * 1e9).Counter("mean_distance", distances / QueryCount);
+
+                bool correct = true;
+                for (int q = 0; q < samples; ++q) {
+                    Box point = MakeBox(px[q], py[q], 0, 0);
+                    int found = tree.QueryPoint(px[q], py[q], &hits[0], (int)hits.size());
+                    correct = correct && SameHits(boxes, hits, found, point, true);
+                    found = tree.QueryBox(rects[q], &hits[0], (int)hits.size());
+                    correct = correct && SameHits(boxes, hits, found, rects[q], false);
+                    double distance;
+                    int best = tree.Nearest(px[q], py[q], HUGE_VAL, &distance);
+                    correct = correct && SameNearest(boxes, best, distance, px[q], py[q]);
+                }
+                context.Check(correct, "AabbTree query disagrees with a linear scan");
+            }
+        }
+    }
+
+    /// <summary>
+    /// Moving a share of the items per frame through Move, with the leaf
+    /// margin absorbing small steps and the rest reinserted
+    /// </summary>
+    void RunMoves(Context& context) {
+        int n = context.Quick() ? 10000 : 100000;
+        std::vector<Box> boxes = Scene("ui", n);
+        double cell = SceneSize / std::sqrt((double)n);
+        Native::AabbTree tree;
+        tree.SetMargin(cell * 0.25);
+        for (int i = 0; i < n; ++i)
+            tree.Insert(boxes[i]);
+
+        static const int shares[] = { 100, 10 };
+        for (int k = 0; k < 2; ++k) {
+            int moved = n / shares[k];
+            int frame = 0;
+            long long reshaped = 0, calls = 0;
+            Timing t = context.Measure([&]() {
+                // Drifting one way, items leave their margin every few frames
+                double dx = (frame++ % 64 < 32 ? 1 : -1) * cell * 0.1;
+                for (int i = 0; i < moved; ++i) {
+                    int h = (int)((long long)i * shares[k] % n);
+                    Box& b = boxes[h];
+                    b.MinX += dx;
+                    b.MaxX += dx;
+                    reshaped += tree.Move(h, b) ? 1 : 0;
+                }
+                calls += moved;
+            });
+            context.Add("aabb-tree", "move", t).Param("items", n).Param("moved", moved)
+                .Counter("ns_per_move", t.Median / moved * 1e9).Counter("reinserted_fraction", (double)reshaped / calls);
+        }
+
+        int found = tree.QueryPoint(boxes[0].MinX + 1e-9, boxes[0].MinY + 1e-9, 0, 0);
+        context.Check(found > 0, "A moved item was lost");
+    }
+
+    void Run(Context& context) {
+        RunQueries(context);
+        RunMoves(context);
+    }
+
+    SuiteRegistration registration("aabb-tree", &Run);
+}
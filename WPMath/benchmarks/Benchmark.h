@@ -0,0 +1,230 @@
+#pragma once
+
+// Small harness shared by the WPMath and WPAnimation native benchmarks.
+// Suites register themselves by name, time closures until a minimum duration
+// has passed, and report one record per case: a table line on stdout as it
+// runs and, with --json, one JSON document per run for regression tracking.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TileScheduler.h"
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Benchmarks {
+            /// <summary>
+            /// Command line settings of a run
+            /// </summary>
+            struct Options {
+                std::string Filter;         // suites whose name contains this, or all
+                std::string JsonPath;       // file for the JSON report, "-" for stdout, empty for none
+                double MinTime;             // seconds each repetition runs for at least
+                int Repetitions;
+                int MaxThreads;             // cap on the thread counts swept, 0 for all
+                bool Quick;                 // small sizes and short timings, for smoke tests
+            };
+
+            /// <summary>
+            /// Seconds per call over the repetitions of one case
+            /// </summary>
+            struct Timing {
+                double Median;
+                double Min;
+                long long Iterations;       // calls across all repetitions
+            };
+
+            /// <summary>
+            /// Keeps a value alive so the computation producing it is not
+            /// optimized away
+            /// </summary>
+            template<typename T>
+            inline void Consume(const T& value) {
+                static volatile T sink;
+                sink = value;
+            }
+
+            /// <summary>
+            /// Result of one case: its parameters, timing and derived counters
+            /// such as GFLOP/s or bytes
+            /// </summary>
+            class Record {
+            public:
+                std::string Suite;
+                std::string Name;
+                std::vector<std::pair<std::string, std::string> > Params;      // values already JSON-encoded
+                std::vector<std::pair<std::string, double> > Counters;
+                Timing Time;
+
+                Record& Param(const char* key, long long value) {
+                    char text[32];
+                    std::snprintf(text, sizeof(text), "%lld", value);
+                    Params.push_back(std::make_pair(std::string(key), std::string(text)));
+                    return *this;
+                }
+
+                Record& Param(const char* key, const char* value) {
+                    Params.push_back(std::make_pair(std::string(key), '"' + std::string(value) + '"'));
+                    return *this;
+                }
+
+                Record& Counter(const char* key, double value) {
+                    Counters.push_back(std::make_pair(std::string(key), value));
+                    return *this;
+                }
+            };
+
+            /// <summary>
+            /// State handed to each suite: settings, timing and the records
+            /// collected so far
+            /// </summary>
+            class Context {
+            private:
+                Options options;
+                std::vector<Record> records;
+                int failures;
+                bool printed;
+                std::FILE* log;             // table output, stderr when the JSON goes to stdout
+
+            public:
+                explicit Context(const Options& options)
+                    : options(options), failures(0), printed(true), log(options.JsonPath == "-" ? stderr : stdout) {}
+
+                const Options& Settings() const { return options; }
+
+                bool Quick() const { return options.Quick; }
+
+                int Failures() const { return failures; }
+
+                const std::vector<Record>& Records() const { return records; }
+
+                /// <summary>
+                /// Calls f once to warm up, then repeatedly for each repetition
+                /// until MinTime has passed, and returns the median and fastest
+                /// seconds per call
+                /// </summary>
+                template<typename F>
+                Timing Measure(F f) {
+                    typedef std::chrono::steady_clock Clock;
+                    f();
+                    std::vector<double> perCall;
+                    long long total = 0;
+                    for (int r = 0; r < options.Repetitions; ++r) {
+                        long long calls = 0;
+                        Clock::time_point start = Clock::now();
+                        double elapsed;
+                        do {
+                            f();
+                            ++calls;
+                            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+                        } while (elapsed < options.MinTime);
+                        perCall.push_back(elapsed / calls);
+                        total += calls;
+                    }
+                    std::sort(perCall.begin(), perCall.end());
+                    Timing t;
+                    t.Median = perCall[perCall.size() / 2];
+                    t.Min = perCall[0];
+                    t.Iterations = total;
+                    return t;
+                }
+
+                /// <summary>
+                /// Adds a record for a measured case; parameters and counters
+                /// are appended to the returned reference, which stays valid
+                /// until the next Add
+                /// </summary>
+                Record& Add(const char* suite, const char* name, const Timing& time) {
+                    Flush();
+                    records.push_back(Record());
+                    Record& r = records.back();
+                    r.Suite = suite;
+                    r.Name = name;
+                    r.Time = time;
+                    printed = false;
+                    return r;
+                }
+
+                /// <summary>
+                /// Prints the last record if it has not been printed yet
+                /// </summary>
+                void Flush() {
+                    if (records.empty() || printed)
+                        return;
+                    printed = true;
+                    const Record& r = records.back();
+                    std::string line = r.Suite + "/" + r.Name;
+                    for (std::size_t i = 0; i < r.Params.size(); ++i) {
+                        std::string value = r.Params[i].second;
+                        if (!value.empty() && value[0] == '"')
+                            value = value.substr(1, value.size() - 2);
+                        line += " " + r.Params[i].first + "=" + value;
+                    }
+                    std::fprintf(log, "%-72s %12.3f us", line.c_str(), r.Time.Median * 1e6);
+                    for (std::size_t i = 0; i < r.Counters.size(); ++i)
+                        std::fprintf(log, "  %s=%.4g", r.Counters[i].first.c_str(), r.Counters[i].second);
+                    std::fprintf(log, "\n");
+                    std::fflush(log);
+                }
+
+                /// <summary>
+                /// Records a failed correctness check; the run exits nonzero
+                /// </summary>
+                void Check(bool ok, const char* what) {
+                    if (ok)
+                        return;
+                    Flush();
+                    std::fprintf(log, "FAILED: %s\n", what);
+                    ++failures;
+                }
+
+                /// <summary>
+                /// Thread counts to sweep: powers of two up to the hardware
+                /// concurrency (or --threads), and that maximum itself
+                /// </summary>
+                std::vector<int> Threads() const {
+                    int most = Native::HardwareConcurrency();
+                    if (options.MaxThreads > 0 && options.MaxThreads < most)
+                        most = options.MaxThreads;
+                    std::vector<int> threads;
+                    for (int t = 1; t < most; t *= 2) {
+                        if (!options.Quick || t == 1)
+                            threads.push_back(t);
+                    }
+                    threads.push_back(most);
+                    return threads;
+                }
+            };
+
+            typedef void (*SuiteFunction)(Context& context);
+
+            struct Suite {
+                const char* Name;
+                SuiteFunction Run;
+            };
+
+            /// <summary>
+            /// Suites in registration order
+            /// </summary>
+            inline std::vector<Suite>& Suites() {
+                static std::vector<Suite> suites;
+                return suites;
+            }
+
+            /// <summary>
+            /// Registers a suite from a static initializer in its source file
+            /// </summary>
+            struct SuiteRegistration {
+                SuiteRegistration(const char* name, SuiteFunction run) {
+                    Suite suite = { name, run };
+                    Suites().push_back(suite);
+                }
+            };
+        }
+    }
+}
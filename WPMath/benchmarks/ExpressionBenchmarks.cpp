@@ -0,0 +1,240 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    typedef Native::ExpressionInstruction Instruction;
+
+    Instruction Op(int op, int input = 0, double scalar = 0) {
+        Instruction ins = { op, input, scalar };
+        return ins;
+    }
+
+    /// <summary>
+    /// A chain of element-wise operations over a few input vectors, as the
+    /// managed operators build it, with its maximum stack depth
+    /// </summary>
+    struct Chain {
+        const char* Name;
+        std::vector<Instruction> Program;
+        int Inputs;
+        int Depth;
+    };
+
+    std::vector<Chain> Chains() {
+        std::vector<Chain> chains(3);
+        // 2 * x + y
+        chains[0].Name = "axpy";
+        chains[0].Inputs = 2;
+        chains[0].Depth = 2;
+        chains[0].Program.push_back(Op(Native::ExprLoad, 0));
+        chains[0].Program.push_back(Op(Native::ExprMultiplyScalar, 0, 2.0));
+        chains[0].Program.push_back(Op(Native::ExprLoad, 1));
+        chains[0].Program.push_back(Op(Native::ExprAdd));
+
+        // (a + b) * (c - d) / 2
+        chains[1].Name = "product-of-sums";
+        chains[1].Inputs = 4;
+        chains[1].Depth = 3;
+        chains[1].Program.push_back(Op(Native::ExprLoad, 0));
+        chains[1].Program.push_back(Op(Native::ExprLoad, 1));
+        chains[1].Program.push_back(Op(Native::ExprAdd));
+        chains[1].Program.push_back(Op(Native::ExprLoad, 2));
+        chains[1].Program.push_back(Op(Native::ExprLoad, 3));
+        chains[1].Program.push_back(Op(Native::ExprSubtract));
+        chains[1].Program.push_back(Op(Native::ExprMultiply));
+        chains[1].Program.push_back(Op(Native::ExprDivideByScalar, 0, 2.0));
+
+        // sqrt(x * x + y * y + z * z)
+        chains[2].Name = "length3";
+        chains[2].Inputs = 3;
+        chains[2].Depth = 3;
+        for (int i = 0; i < 3; ++i) {
+            chains[2].Program.push_back(Op(Native::ExprLoad, i));
+            chains[2].Program.push_back(Op(Native::ExprLoad, i));
+            chains[2].Program.push_back(Op(Native::ExprMultiply));
+            if (i > 0)
+                chains[2].Program.push_back(Op(Native::ExprAdd));
+        }
+        chains[2].Program.push_back(Op(Native::ExprSqrt));
+        return chains;
+    }
+
+    /// <summary>
+    /// Evaluates a program the way chained operators did before lazy
+    /// evaluation: every operation is a full pass over the vectors into a
+    /// newly allocated temporary. Uses the same element kernels as the fused
+    /// path, so the difference is only passes and allocations, which it
+    /// counts.
+    /// </summary>
+    template<typename T>
+    class EagerEvaluator {
+    private:
+        std::vector<std::vector<T>*> stack;
+        std::vector<const T*> values;
+
+    public:
+        long long Passes;
+        long long Allocations;
+
+        EagerEvaluator() : Passes(0), Allocations(0) {}
+
+        void Run(const std::vector<Instruction>& program, const T* const* inputs, int n, T* dst) {
+            for (std::size_t k = 0; k < program.size(); ++k) {
+                const Instruction& ins = program[k];
+                if (ins.Op == Native::ExprLoad) {
+                    stack.push_back(nullptr);
+                    values.push_back(inputs[ins.Input]);
+                    continue;
+                }
+
+                bool binary = ins.Op <= Native::ExprDivide;
+                const T* a = values[values.size() - (binary ? 2 : 1)];
+                const T* b = values.back();
+                // The last operation writes the destination, as the fused
+                // path does; every other one allocates its temporary
+                std::vector<T>* result = nullptr;
+                T* out = dst;
+                if (k + 1 < program.size()) {
+                    result = new std::vector<T>(n);
+                    out = &(*result)[0];
+                    ++Allocations;
+                }
+                ++Passes;
+                T c = (T)ins.Scalar;
+                switch (ins.Op) {
+                case Native::ExprAdd: Native::Detail::Map<T, Native::Detail::AddOp>(a, b, out, n); break;
+                case Native::ExprSubtract: Native::Detail::Map<T, Native::Detail::SubtractOp>(a, b, out, n); break;
+                case Native::ExprMultiply: Native::Detail::Map<T, Native::Detail::MultiplyOp>(a, b, out, n); break;
+                case Native::ExprDivide: Native::Detail::Map<T, Native::Detail::DivideOp>(a, b, out, n); break;
+                case Native::ExprMultiplyScalar: Native::Detail::MapScalar<T, Native::Detail::MultiplyOp>(a, c, out, n, false); break;
+                case Native::ExprDivideByScalar: Native::Detail::MapScalar<T, Native::Detail::DivideOp>(a, c, out, n, false); break;
+                case Native::ExprSqrt: Native::Detail::MapSqrt(a, out, n); break;
+                }
+
+                for (int pop = binary ? 2 : 1; pop > 0; --pop) {
+                    delete stack.back();
+                    stack.pop_back();
+                    values.pop_back();
+                }
+                stack.push_back(result);
+                values.push_back(out);
+            }
+            delete stack.back();
+            stack.pop_back();
+            values.pop_back();
+        }
+    };
+
+    void Fill(std::vector<double>& v, unsigned seed) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (seed >> 8) * (1.0 / 16777216.0) + 0.5;
+        }
+    }
+
+    /// <summary>
+    /// Each chain evaluated eagerly, one temporary per operation, and fused
+    /// by EvaluateExpression in 256-element chunks. passes counts full
+    /// sweeps over the vector length, allocations the buffers allocated per
+    /// evaluation and alloc_bytes their total size.
+    /// The fused path makes one pass at any length and reuses a workspace
+    /// allocated once, as the managed expressions keep one per program.
+    /// </summary>
+    void Run(Context& context) {
+        static const int lengths[] = { 1000, 100000, 10000000 };
+        int count = context.Quick() ? 2 : 3;
+        std::vector<Chain> chains = Chains();
+
+        for (int s = 0; s < count; ++s) {
+            int n = lengths[s];
+            std::vector<std::vector<double> > data(4, std::vector<double>(n));
+            const double* inputs[4];
+            for (int i = 0; i < 4; ++i) {
+                Fill(data[i], 11 + i);
+                inputs[i] = &data[i][0];
+            }
+            std::vector<double> eager(n), fused(n);
+
+            for (std::size_t c = 0; c < chains.size(); ++c) {
+                const Chain& chain = chains[c];
+                int length = (int)chain.Program.size();
+                double bytes = ((double)chain.Inputs + 1) * n * sizeof(double);
+
+                EagerEvaluator<double> evaluator;
+                Timing t = context.Measure([&]() {
+                    evaluator.Run(chain.Program, inputs, n, &eager[0]);
+                });
+                double calls = (double)t.Iterations + 1;
+                context.Add("expression", "eager", t).Param("chain", chain.Name).Param("n", n)
+                    .Counter("passes", evaluator.Passes / calls).Counter("allocations", evaluator.Allocations / calls)
+                    .Counter("alloc_bytes", evaluator.Allocations / calls * n * sizeof(double))
+                    .Counter("gbps", bytes / t.Median * 1e-9);
+
+                Native::ExpressionWorkspace workspace(chain.Depth);
+                Timing f = context.Measure([&]() {
+                    Native::EvaluateExpression(&chain.Program[0], length, inputs, n, &fused[0], workspace);
+                });
+                context.Add("expression", "fused", f).Param("chain", chain.Name).Param("n", n)
+                    .Counter("passes", 1).Counter("allocations", 0).Counter("alloc_bytes", 0)
+                    .Counter("gbps", bytes / f.Median * 1e-9).Counter("speedup", t.Median / f.Median);
+                context.Check(eager == fused, "Fused evaluation differs from eager evaluation");
+            }
+
+            // ||a - b||^2 without storing a - b, against subtract then sum
+            std::vector<Instruction> difference;
+            difference.push_back(Op(Native::ExprLoad, 0));
+            difference.push_back(Op(Native::ExprLoad, 1));
+            difference.push_back(Op(Native::ExprSubtract));
+            EagerEvaluator<double> evaluator;
+            double eagerSum = 0, fusedSum = 0;
+            Timing t = context.Measure([&]() {
+                // a - b is a temporary here, not a destination
+                std::vector<double> temporary(n);
+                evaluator.Run(difference, inputs, n, &temporary[0]);
+                double sum = 0;
+                for (int i = 0; i < n; ++i)
+                    sum += temporary[i] * temporary[i];
+                eagerSum = sum;
+            });
+            context.Add("expression", "eager-reduce", t).Param("chain", "distance-squared").Param("n", n)
+                .Counter("passes", evaluator.Passes / ((double)t.Iterations + 1) + 1)
+                .Counter("allocations", evaluator.Allocations / ((double)t.Iterations + 1) + 1)
+                .Counter("alloc_bytes", (double)n * sizeof(double));
+            Native::ExpressionWorkspace workspace(2);
+            Timing f = context.Measure([&]() {
+                fusedSum = Native::ReduceExpression(&difference[0], 3, inputs, n, true, workspace);
+            });
+            context.Add("expression", "fused-reduce", f).Param("chain", "distance-squared").Param("n", n)
+                .Counter("passes", 1).Counter("allocations", 0).Counter("alloc_bytes", 0)
+                .Counter("speedup", t.Median / f.Median);
+            context.Check(std::fabs(eagerSum - fusedSum) <= 1e-9 * eagerSum, "Fused reduction differs from eager");
+
+            // The float reduction adds in double, so it matches a double sum
+            // of the same float differences to double rounding
+            std::vector<std::vector<float> > single(2, std::vector<float>(n));
+            double expected = 0;
+            for (int i = 0; i < n; ++i) {
+                single[0][i] = (float)data[0][i];
+                single[1][i] = (float)data[1][i];
+                double d = (float)(single[0][i] - single[1][i]);
+                expected += d * d;
+            }
+            const float* floatInputs[] = { &single[0][0], &single[1][0] };
+            double floatSum = 0;
+            f = context.Measure([&]() {
+                floatSum = Native::ReduceExpression(&difference[0], 3, floatInputs, n, true, workspace);
+            });
+            context.Add("expression", "fused-reduce-float", f).Param("chain", "distance-squared").Param("n", n)
+                .Counter("relative_error", std::fabs(floatSum - expected) / expected);
+            context.Check(std::fabs(floatSum - expected) <= 1e-9 * expected, "Float reduction does not accumulate in double");
+        }
+    }
+
+    SuiteRegistration registration("expression", &Run);
+}
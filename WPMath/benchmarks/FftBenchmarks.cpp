@@ -0,0 +1,82 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    void Fill(std::vector<double>& v, unsigned seed) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (seed >> 8) * (1.0 / 16777216.0) - 0.5;
+        }
+    }
+
+    /// <summary>
+    /// Complex forward and inverse transforms and the real forward transform
+    /// over powers of two and mixed-radix lengths. MFLOPS uses the
+    /// conventional 5 n log2(n) operation count for complex transforms and
+    /// half of it for real ones, so lengths are comparable.
+    /// </summary>
+    void Run(Context& context) {
+        static const int lengths[] = { 256, 4096, 65536, 1 << 20, 1000, 3 * 5 * 7 * 64, 3 * 3 * 5 * 5 * 7 * 7 * 11 };
+        static const bool quick[] = { true, true, false, false, true, true, false };
+
+        for (int s = 0; s < 7; ++s) {
+            if (context.Quick() && !quick[s])
+                continue;
+            int n = lengths[s];
+            const char* kind = (n & (n - 1)) == 0 ? "pow2" : "mixed";
+            double flops = 5.0 * n * std::log2((double)n);
+
+            Native::FftPlan plan(n);
+            std::vector<double> in(2 * (std::size_t)n), out(2 * (std::size_t)n), back(2 * (std::size_t)n);
+            Fill(in, 3);
+
+            Timing t = context.Measure([&]() {
+                plan.Execute(&in[0], &out[0], false);
+            });
+            context.Add("fft", "complex-forward", t).Param("radix", kind).Param("n", n)
+                .Counter("mflops", flops / t.Median * 1e-6);
+
+            t = context.Measure([&]() {
+                plan.Execute(&out[0], &back[0], true);
+            });
+            context.Add("fft", "complex-inverse", t).Param("radix", kind).Param("n", n)
+                .Counter("mflops", flops / t.Median * 1e-6);
+
+            // The inverse is unnormalized: back = n * in
+            double worst = 0;
+            for (std::size_t i = 0; i < in.size(); ++i)
+                worst = std::fmax(worst, std::fabs(back[i] / n - in[i]));
+            context.Check(worst < 1e-12, "FFT round trip lost accuracy");
+
+            Native::RealFftPlan real(n);
+            std::vector<double> samples(n), bins(2 * ((std::size_t)n / 2 + 1));
+            Fill(samples, 4);
+            t = context.Measure([&]() {
+                real.Forward(&samples[0], &bins[0]);
+            });
+            context.Add("fft", "real-forward", t).Param("radix", kind).Param("n", n)
+                .Counter("mflops", flops / 2 / t.Median * 1e-6);
+
+            // The plans reuse their work buffers: an in-place transform and a
+            // real round trip after the timed calls must still be exact
+            std::vector<double> inPlace(in);
+            plan.Execute(&inPlace[0], &inPlace[0], false);
+            plan.Execute(&in[0], &out[0], false);
+            context.Check(inPlace == out, "In-place FFT differs from out-of-place");
+            std::vector<double> restored(n);
+            real.Inverse(&bins[0], &restored[0]);
+            worst = 0;
+            for (int i = 0; i < n; ++i)
+                worst = std::fmax(worst, std::fabs(restored[i] / n - samples[i]));
+            context.Check(worst < 1e-12, "Real FFT round trip lost accuracy");
+        }
+    }
+
+    SuiteRegistration registration("fft", &Run);
+}
@@ -0,0 +1,130 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    template<typename T>
+    void Fill(std::vector<T>& v, unsigned seed) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (T)((seed >> 8) * (1.0 / 16777216.0) - 0.5);
+        }
+    }
+
+    template<typename T>
+    double MaxDifference(const std::vector<T>& a, const std::vector<T>& b) {
+        double worst = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            worst = std::fmax(worst, std::fabs((double)a[i] - (double)b[i]));
+        return worst;
+    }
+
+    /// <summary>
+    /// The product as Matrix::Multiply computed it before the packed
+    /// kernel: one dot product per element, striding down the columns of B
+    /// </summary>
+    template<typename T>
+    struct Naive {
+        const T* A;
+        const T* B;
+        T* C;
+        int N;
+
+        void Rows(int begin, int end) const {
+            for (int i = begin; i < end; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    T sum = T();
+                    for (int k = 0; k < N; ++k)
+                        sum += A[(std::size_t)i * N + k] * B[(std::size_t)k * N + j];
+                    C[(std::size_t)i * N + j] = sum;
+                }
+            }
+        }
+
+        /// <summary>
+        /// One tile per row, handed out by the same pool as the packed kernel
+        /// </summary>
+        static void Tile(void* context, int tile, int) {
+            static_cast<Naive*>(context)->Rows(tile, tile + 1);
+        }
+    };
+
+    /// <summary>
+    /// Square C = A * B through the naive loop and the packed kernel, serial
+    /// and at each thread count. The naive loop is skipped above n = 512,
+    /// where a single call takes seconds. speedup is the naive time at the
+    /// same thread count over the packed time.
+    /// </summary>
+    template<typename T>
+    void RunType(Context& context, const char* type) {
+        static const int sizes[] = { 64, 128, 256, 512, 1024 };
+        int count = context.Quick() ? 2 : 5;
+        std::vector<int> threads = context.Threads();
+
+        for (int s = 0; s < count; ++s) {
+            int n = sizes[s];
+            std::vector<T> a((std::size_t)n * n), b((std::size_t)n * n), c((std::size_t)n * n), serial((std::size_t)n * n);
+            Fill(a, 1);
+            Fill(b, 2);
+            double flops = 2.0 * n * n * n;
+            bool naive = n <= 512;
+            Naive<T> reference = { &a[0], &b[0], &c[0], n };
+            Timing baseline = { 0, 0, 0 };
+
+            if (naive) {
+                baseline = context.Measure([&]() {
+                    reference.Rows(0, n);
+                });
+                context.Add("gemm", "naive", baseline).Param("type", type).Param("n", n).Param("threads", 1)
+                    .Counter("gflops", flops / baseline.Median * 1e-9);
+            }
+
+            Timing t = context.Measure([&]() {
+                Native::Gemm(n, n, n, &a[0], &b[0], &serial[0]);
+            });
+            Record& packed = context.Add("gemm", "packed", t).Param("type", type).Param("n", n).Param("threads", 1)
+                .Counter("gflops", flops / t.Median * 1e-9);
+            if (naive) {
+                packed.Counter("speedup", baseline.Median / t.Median);
+                // Both sum k in order but the packed kernel uses FMA and
+                // blocks k, so allow rounding that grows with n
+                double tolerance = n * (sizeof(T) == sizeof(float) ? 1e-6 : 1e-14);
+                context.Check(MaxDifference(c, serial) <= tolerance, "Gemm differs from the naive product");
+            }
+
+            for (std::size_t k = 0; k < threads.size(); ++k) {
+                int p = threads[k];
+                if (naive) {
+                    baseline = context.Measure([&]() {
+                        Native::ParallelForTiles(n, p, &Naive<T>::Tile, &reference);
+                    });
+                    context.Add("gemm", "naive-parallel", baseline).Param("type", type).Param("n", n).Param("threads", p)
+                        .Counter("gflops", flops / baseline.Median * 1e-9);
+                }
+
+                t = context.Measure([&]() {
+                    Native::GemmParallel(Native::RowMajor(&a[0], n, n), Native::RowMajor(&b[0], n, n), &c[0], n, p);
+                });
+                Record& parallel = context.Add("gemm", "packed-parallel", t).Param("type", type).Param("n", n).Param("threads", p)
+                    .Counter("gflops", flops / t.Median * 1e-9);
+                if (naive)
+                    parallel.Counter("speedup", baseline.Median / t.Median);
+                // Tiles partition C and each runs the serial kernel, so the
+                // parallel product is bit-identical
+                context.Check(MaxDifference(c, serial) == 0, "GemmParallel differs from Gemm");
+            }
+        }
+    }
+
+    void Run(Context& context) {
+        RunType<float>(context, "float");
+        RunType<double>(context, "double");
+    }
+
+    SuiteRegistration registration("gemm", &Run);
+}
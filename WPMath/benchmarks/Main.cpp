@@ -0,0 +1,161 @@
+#include "Benchmark.h"
+#include "Platform.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    void PrintUsage(const char* program) {
+        std::printf(
+            "Usage: %s [options]\n"
+            "  --filter NAME     run only the suites whose name contains NAME\n"
+            "  --json PATH       write the results as JSON to PATH (- for stdout)\n"
+            "  --min-time SEC    minimum seconds per repetition (default 0.1)\n"
+            "  --repetitions N   repetitions per case, the median is reported (default 5)\n"
+            "  --threads N       largest thread count swept (default all hardware threads)\n"
+            "  --quick           small sizes and short timings, for smoke tests\n"
+            "  --list            list the suites and exit\n", program);
+    }
+
+    std::string Escape(const std::string& text) {
+        std::string out;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    void WriteNumber(std::FILE* f, double value) {
+        // JSON has no infinities or NaNs
+        if (std::isfinite(value))
+            std::fprintf(f, "%.9g", value);
+        else
+            std::fprintf(f, "null");
+    }
+
+    void WriteJson(std::FILE* f, const Context& context) {
+        const Options& o = context.Settings();
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        std::fprintf(f, "{\n  \"context\": {\n");
+        std::fprintf(f, "    \"date\": \"%s\",\n", date);
+#if defined(__clang__)
+        std::fprintf(f, "    \"compiler\": \"clang %s\",\n", Escape(__clang_version__).c_str());
+#elif defined(__GNUC__)
+        std::fprintf(f, "    \"compiler\": \"gcc %s\",\n", Escape(__VERSION__).c_str());
+#elif defined(_MSC_VER)
+        std::fprintf(f, "    \"compiler\": \"msvc %d\",\n", _MSC_FULL_VER);
+#endif
+        std::fprintf(f, "    \"hardware_concurrency\": %d,\n", WindowPlus::Math::Native::HardwareConcurrency());
+#if defined(WP_MATH_AVX2)
+        std::fprintf(f, "    \"simd\": \"avx2\",\n");
+#elif defined(WP_MATH_SSE2)
+        std::fprintf(f, "    \"simd\": \"sse2\",\n");
+#else
+        std::fprintf(f, "    \"simd\": \"none\",\n");
+#endif
+        std::fprintf(f, "    \"min_time\": %g,\n", o.MinTime);
+        std::fprintf(f, "    \"repetitions\": %d,\n", o.Repetitions);
+        std::fprintf(f, "    \"quick\": %s,\n", o.Quick ? "true" : "false");
+        std::fprintf(f, "    \"failures\": %d\n", context.Failures());
+        std::fprintf(f, "  },\n  \"benchmarks\": [");
+
+        const std::vector<Record>& records = context.Records();
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const Record& r = records[i];
+            std::fprintf(f, "%s\n    {\n", i == 0 ? "" : ",");
+            std::fprintf(f, "      \"suite\": \"%s\",\n", Escape(r.Suite).c_str());
+            std::fprintf(f, "      \"name\": \"%s\",\n", Escape(r.Name).c_str());
+            std::fprintf(f, "      \"params\": {");
+            for (std::size_t k = 0; k < r.Params.size(); ++k)
+                std::fprintf(f, "%s\"%s\": %s", k == 0 ? "" : ", ", r.Params[k].first.c_str(), r.Params[k].second.c_str());
+            std::fprintf(f, "},\n      \"iterations\": %lld,\n", r.Time.Iterations);
+            std::fprintf(f, "      \"seconds_median\": ");
+            WriteNumber(f, r.Time.Median);
+            std::fprintf(f, ",\n      \"seconds_min\": ");
+            WriteNumber(f, r.Time.Min);
+            std::fprintf(f, ",\n      \"counters\": {");
+            for (std::size_t k = 0; k < r.Counters.size(); ++k) {
+                std::fprintf(f, "%s\"%s\": ", k == 0 ? "" : ", ", r.Counters[k].first.c_str());
+                WriteNumber(f, r.Counters[k].second);
+            }
+            std::fprintf(f, "}\n    }");
+        }
+        std::fprintf(f, "\n  ]\n}\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    options.MinTime = 0.1;
+    options.Repetitions = 5;
+    options.MaxThreads = 0;
+    options.Quick = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue)
+            options.Filter = argv[++i];
+        else if (arg == "--json" && hasValue)
+            options.JsonPath = argv[++i];
+        else if (arg == "--min-time" && hasValue)
+            options.MinTime = std::atof(argv[++i]);
+        else if (arg == "--repetitions" && hasValue)
+            options.Repetitions = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue)
+            options.MaxThreads = std::atoi(argv[++i]);
+        else if (arg == "--quick")
+            options.Quick = true;
+        else if (arg == "--list") {
+            for (std::size_t s = 0; s < Suites().size(); ++s)
+                std::printf("%s\n", Suites()[s].Name);
+            return 0;
+        }
+        else {
+            PrintUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+    if (options.Quick) {
+        options.MinTime = 0.002;
+        options.Repetitions = 1;
+    }
+    if (options.Repetitions < 1)
+        options.Repetitions = 1;
+
+    Context context(options);
+    int ran = 0;
+    for (std::size_t s = 0; s < Suites().size(); ++s) {
+        const Suite& suite = Suites()[s];
+        if (!options.Filter.empty() && std::strstr(suite.Name, options.Filter.c_str()) == nullptr)
+            continue;
+        suite.Run(context);
+        context.Flush();
+        ++ran;
+    }
+    if (ran == 0) {
+        std::fprintf(stderr, "No suite matches '%s'\n", options.Filter.c_str());
+        return 2;
+    }
+
+    if (!options.JsonPath.empty()) {
+        std::FILE* f = options.JsonPath == "-" ? stdout : std::fopen(options.JsonPath.c_str(), "w");
+        if (f == nullptr) {
+            std::fprintf(stderr, "Cannot write %s\n", options.JsonPath.c_str());
+            return 2;
+        }
+        WriteJson(f, context);
+        if (f != stdout)
+            std::fclose(f);
+    }
+    return context.Failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    typedef Native::Point2 Point2;
+
+    const double Pi = 3.14159265358979323846;
+
+    Point2 At(double x, double y) {
+        Point2 p = { x, y };
+        return p;
+    }
+
+    /// <summary>
+    /// Regular n-gon of the given radius, counter-clockwise and convex
+    /// </summary>
+    std::vector<Point2> Regular(int n, double radius, double cx, double cy, double phase) {
+        std::vector<Point2> p(n);
+        for (int i = 0; i < n; ++i) {
+            double a = phase + 2 * Pi * i / n;
+            p[i] = At(cx + radius * std::cos(a), cy + radius * std::sin(a));
+        }
+        return p;
+    }
+
+    /// <summary>
+    /// Star with n vertices alternating between two radii: simple,
+    /// counter-clockwise, concave and not monotone in y
+    /// </summary>
+    std::vector<Point2> Star(int n, double outer, double inner, double cx, double cy, double phase) {
+        std::vector<Point2> p(n);
+        for (int i = 0; i < n; ++i) {
+            double a = phase + 2 * Pi * i / n, r = i % 2 == 0 ? outer : inner;
+            p[i] = At(cx + r * std::cos(a), cy + r * std::sin(a));
+        }
+        return p;
+    }
+
+    /// <summary>
+    /// Twice the signed area of a clipper result: outer contours count
+    /// positive and holes negative
+    /// </summary>
+    double ResultArea2(const Native::PolygonClipper& clipper) {
+        const std::vector<Point2>& points = clipper.Points();
+        const std::vector<int>& ends = clipper.Ends();
+        double sum = 0;
+        for (std::size_t c = 0, start = 0; c < ends.size(); start = ends[c++])
+            sum += Native::PolygonArea2(&points[start], ends[c] - (int)start);
+        return sum;
+    }
+
+    /// <summary>
+    /// Text-like path of closed contours, each two quadratics, two cubics
+    /// and two lines, so every verb takes part
+    /// </summary>
+    void Glyphs(int contours, std::vector<unsigned char>& verbs, std::vector<Point2>& points) {
+        for (int c = 0; c < contours; ++c) {
+            double x = (c % 64) * 12.0, y = (c / 64) * 16.0;
+            verbs.push_back(Native::PathMoveTo);
+            points.push_back(At(x, y));
+            verbs.push_back(Native::PathQuadraticTo);
+            points.push_back(At(x + 5, y - 4));
+            points.push_back(At(x + 10, y));
+            verbs.push_back(Native::PathLineTo);
+            points.push_back(At(x + 10, y + 6));
+            verbs.push_back(Native::PathCubicTo);
+            points.push_back(At(x + 10, y + 12));
+            points.push_back(At(x + 6, y + 14));
+            points.push_back(At(x + 4, y + 14));
+            verbs.push_back(Native::PathQuadraticTo);
+            points.push_back(At(x, y + 14));
+            points.push_back(At(x, y + 10));
+            verbs.push_back(Native::PathCubicTo);
+            points.push_back(At(x + 2, y + 8));
+            points.push_back(At(x - 2, y + 4));
+            points.push_back(At(x + 1, y + 2));
+            verbs.push_back(Native::PathLineTo);
+            points.push_back(At(x, y));
+            verbs.push_back(Native::PathClose);
+        }
+    }
+
+    /// <summary>
+    /// Curve flattening at screen and print tolerances, whole paths, and
+    /// the polygon queries, convex clipping, triangulation and boolean
+    /// operations over polygons of growing vertex count. Results are
+    /// checked against areas known in closed form.
+    /// </summary>
+    void Run(Context& context) {
+        static const double tolerances[] = { 0.25, 0.01 };
+        static const int sizes[] = { 16, 256, 4096 };
+        int sizeCount = context.Quick() ? 2 : 3;
+
+        // A large cubic arc and quadratic spanning a 1000 unit box
+        for (int k = 0; k < 2; ++k) {
+            double tolerance = tolerances[k];
+            std::vector<Point2> out(Native::MaxCurveSegments);
+            Point2 p0 = At(0, 0), p1 = At(0, 552), p2 = At(448, 1000), p3 = At(1000, 1000);
+            int count = 0;
+            Timing t = context.Measure([&]() {
+                count = Native::FlattenCubic(p0, p1, p2, p3, tolerance, &out[0], (int)out.size());
+            });
+            context.Add("path", "flatten-cubic", t).Param("tolerance_milli", (long long)(tolerance * 1000))
+                .Param("points", count).Counter("ns_per_point", t.Median / count * 1e9);
+            context.Check(count > 0 && out[count - 1].X == p3.X && out[count - 1].Y == p3.Y, "FlattenCubic lost its end point");
+
+            t = context.Measure([&]() {
+                count = Native::FlattenQuadratic(p0, p1, p3, tolerance, &out[0], (int)out.size());
+            });
+            context.Add("path", "flatten-quadratic", t).Param("tolerance_milli", (long long)(tolerance * 1000))
+                .Param("points", count).Counter("ns_per_point", t.Median / count * 1e9);
+            context.Check(count > 0 && out[count - 1].X == p3.X && out[count - 1].Y == p3.Y, "FlattenQuadratic lost its end point");
+        }
+
+        // Paths of many small contours, as text produces
+        {
+            int contours = context.Quick() ? 256 : 4096;
+            std::vector<unsigned char> verbs;
+            std::vector<Point2> points;
+            Glyphs(contours, verbs, points);
+            int ends = 0;
+            int needed = Native::FlattenPath(&verbs[0], (int)verbs.size(), &points[0], (int)points.size(), 0.25, nullptr, 0,
+                                             nullptr, 0, &ends);
+            std::vector<Point2> out(needed);
+            std::vector<int> contourEnds(ends);
+            int count = 0;
+            Timing t = context.Measure([&]() {
+                count = Native::FlattenPath(&verbs[0], (int)verbs.size(), &points[0], (int)points.size(), 0.25, &out[0],
+                                            needed, &contourEnds[0], ends, &ends);
+            });
+            context.Add("path", "flatten-path", t).Param("contours", contours).Param("verbs", (long long)verbs.size())
+                .Param("points", count).Counter("ns_per_verb", t.Median / verbs.size() * 1e9)
+                .Counter("ns_per_point", t.Median / count * 1e9);
+            context.Check(count == needed && ends == contours, "FlattenPath returned the wrong sizes");
+        }
+
+        for (int s = 0; s < sizeCount; ++s) {
+            int n = sizes[s];
+            std::vector<Point2> star = Star(n, 100, 60, 0, 0, 0);
+
+            double area = 0;
+            Timing t = context.Measure([&]() {
+                area = Native::PolygonArea2(&star[0], n);
+            });
+            context.Add("path", "area", t).Param("n", n).Counter("ns_per_vertex", t.Median / n * 1e9);
+            // The star is n triangles of sides 100 and 60 around the centre
+            double expected = n * 100 * 60 * std::sin(2 * Pi / n);
+            context.Check(std::fabs(area - expected) < 1e-9 * expected, "PolygonArea2 is wrong");
+
+            const int queries = 1024;
+            std::vector<Point2> probes(queries);
+            for (int i = 0; i < queries; ++i)
+                probes[i] = At(std::cos(i * 0.7) * i * 0.12, std::sin(i * 0.7) * i * 0.12);
+            int inside = 0;
+            t = context.Measure([&]() {
+                int hits = 0;
+                for (int i = 0; i < queries; ++i)
+                    hits += Native::PolygonContains(&star[0], n, probes[i]);
+                inside = hits;
+            });
+            context.Add("path", "contains", t).Param("n", n).Param("queries", queries)
+                .Counter("ns_per_query", t.Median / queries * 1e9);
+            // Everything within the inner radius is inside, nothing beyond the outer
+            int lower = 0, upper = 0;
+            for (int i = 0; i < queries; ++i) {
+                double r = i * 0.12;
+                lower += r < 60 * std::cos(2 * Pi / n);
+                upper += r < 100;
+            }
+            context.Check(inside >= lower && inside <= upper, "PolygonContains is wrong");
+
+            // A convex clip window over part of the star; each clip edge can
+            // cut every tooth, so a stage may add a vertex per subject edge
+            std::vector<Point2> window = Regular(8, 90, 40, 25, 0.1);
+            int capacity = 2 * n + 8;
+            std::vector<Point2> out(capacity), scratch(capacity);
+            int count = 0;
+            t = context.Measure([&]() {
+                count = Native::ClipToConvex(&star[0], n, &window[0], 8, &out[0], &scratch[0], capacity);
+            });
+            context.Add("path", "clip-convex", t).Param("n", n).Param("clip", 8)
+                .Counter("ns_per_vertex", t.Median / n * 1e9);
+            double clipped = count >= 3 ? Native::PolygonArea2(&out[0], count) : 0;
+            context.Check(clipped > 0 && clipped <= area && clipped <= Native::PolygonArea2(&window[0], 8),
+                          "ClipToConvex result is larger than its inputs");
+
+            // Convex input takes the monotone path, the star the ear clipper
+            Native::Triangulator triangulator;
+            std::vector<int> indices(3 * (n - 2));
+            for (int shape = 0; shape < 2; ++shape) {
+                std::vector<Point2> polygon = shape == 0 ? Regular(n, 100, 0, 0, 0.01) : star;
+                double polygonArea = Native::PolygonArea2(&polygon[0], n);
+                t = context.Measure([&]() {
+                    count = triangulator.Triangulate(&polygon[0], n, &indices[0], 0);
+                });
+                context.Add("path", "triangulate", t).Param("shape", shape == 0 ? "convex" : "star").Param("n", n)
+                    .Counter("ns_per_vertex", t.Median / n * 1e9);
+                double sum = 0;
+                for (int i = 0; i + 2 < count; i += 3)
+                    sum += std::fabs(Native::Orient(polygon[indices[i]], polygon[indices[i + 1]], polygon[indices[i + 2]]));
+                context.Check(count == 3 * (n - 2) && std::fabs(sum - polygonArea) < 1e-9 * polygonArea,
+                              "Triangulator does not cover the polygon");
+            }
+
+            // Two overlapping stars: |A u B| + |A n B| = |A| + |B| and
+            // |A - B| = |A| - |A n B|
+            {
+                std::vector<Point2> other = Star(n, 100, 60, 37.3, 21.9, 0.377);
+                double otherArea = Native::PolygonArea2(&other[0], n);
+                Native::PolygonClipper clipper;
+                static const Native::ClipOperation operations[] = { Native::ClipIntersection, Native::ClipUnion, Native::ClipDifference };
+                static const char* names[] = { "intersection", "union", "difference" };
+                double areas[3];
+                for (int o = 0; o < 3; ++o) {
+                    int contours = 0;
+                    t = context.Measure([&]() {
+                        contours = clipper.Combine(&star[0], n, &other[0], n, operations[o]);
+                    });
+                    areas[o] = ResultArea2(clipper);
+                    context.Add("path", "boolean", t).Param("operation", names[o]).Param("n", n).Param("contours", contours)
+                        .Counter("ns_per_vertex", t.Median / (2.0 * n) * 1e9);
+                }
+                double scale = area + otherArea;
+                context.Check(std::fabs(areas[1] + areas[0] - scale) < 1e-6 * scale &&
+                              std::fabs(areas[2] - (area - areas[0])) < 1e-6 * scale,
+                              "PolygonClipper areas do not add up");
+            }
+        }
+    }
+
+    SuiteRegistration registration("path", &Run);
+}
@@ -0,0 +1,131 @@
+#include "Benchmark.h"
+#include "SparseInputs.h"
+#include "WPMathNative.h"
+
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    struct Counting {
+        std::vector<long long> PerWorker;   // padded to a cache line per worker
+
+        static void Tile(void* context, int tile, int worker) {
+            static_cast<Counting*>(context)->PerWorker[(std::size_t)worker * 8] += tile;
+        }
+    };
+
+    /// <summary>
+    /// Tiles whose cost grows with their index, so a static split leaves the
+    /// first workers idle and only stealing keeps everyone busy
+    /// </summary>
+    struct Skewed {
+        std::vector<double> PerWorker;
+
+        static void Tile(void* context, int tile, int worker) {
+            double x = 1.0 + tile;
+            for (int i = 0; i < 200 * (tile + 1); ++i)
+                x = x * 0.999999 + 1e-6;
+            static_cast<Skewed*>(context)->PerWorker[(std::size_t)worker * 8] += x;
+        }
+    };
+
+    /// <summary>
+    /// Adds a scaling record: speedup over the one-thread time of the same
+    /// workload and efficiency, the speedup per thread
+    /// </summary>
+    Record& AddScaling(Context& context, const char* name, const Timing& t, double single, int threads) {
+        double speedup = single / t.Median;
+        return context.Add("scheduler", name, t).Param("threads", threads)
+            .Counter("speedup", speedup).Counter("efficiency", speedup / threads);
+    }
+
+    /// <summary>
+    /// Strong scaling of the kernels that run on the pool, each at every
+    /// thread count with a fixed problem size
+    /// </summary>
+    void RunScaling(Context& context) {
+        std::vector<int> threads = context.Threads();
+        int n = context.Quick() ? 256 : 1024;
+        int side = context.Quick() ? 128 : 1024;
+        int grid = context.Quick() ? 64 : 512;
+
+        std::vector<double> a((std::size_t)n * n, 0.5), b((std::size_t)n * n, 0.25), c((std::size_t)n * n);
+        std::vector<double> src((std::size_t)side * side, 1.0), dst((std::size_t)side * side);
+        CsrInput laplacian = Laplacian(grid);
+        std::vector<double> x(laplacian.Rows, 1.0), y(laplacian.Rows);
+        Skewed skewed;
+        skewed.PerWorker.assign((std::size_t)threads.back() * 8, 0);
+        double single[4] = { 0, 0, 0, 0 };
+
+        for (std::size_t k = 0; k < threads.size(); ++k) {
+            int p = threads[k];
+            Timing t = context.Measure([&]() {
+                Native::GemmParallel(Native::RowMajor(&a[0], n, n), Native::RowMajor(&b[0], n, n), &c[0], n, p);
+            });
+            if (k == 0)
+                single[0] = t.Median;
+            AddScaling(context, "scaling-gemm", t, single[0], p).Param("n", n);
+
+            t = context.Measure([&]() {
+                Native::TransposeParallel(&src[0], side, side, &dst[0], p);
+            });
+            if (k == 0)
+                single[1] = t.Median;
+            AddScaling(context, "scaling-transpose", t, single[1], p).Param("n", side);
+
+            t = context.Measure([&]() {
+                Native::SparseGatherParallel(&laplacian.Pointers[0], &laplacian.Indices[0], &laplacian.Values[0],
+                                             laplacian.Rows, &x[0], &y[0], p);
+            });
+            if (k == 0)
+                single[2] = t.Median;
+            AddScaling(context, "scaling-spmv", t, single[2], p).Param("n", laplacian.Rows);
+
+            t = context.Measure([&]() {
+                Native::ParallelForTiles(256, p, &Skewed::Tile, &skewed);
+            });
+            if (k == 0)
+                single[3] = t.Median;
+            AddScaling(context, "scaling-skewed", t, single[3], p).Param("tiles", 256);
+        }
+    }
+
+    /// <summary>
+    /// Cost of ParallelForTiles itself: waking the pool, handing out and
+    /// stealing tiles that do almost nothing, and joining
+    /// </summary>
+    void RunDispatch(Context& context) {
+        static const int tileCounts[] = { 1, 16, 256, 4096, 65536 };
+        int count = context.Quick() ? 3 : 5;
+        std::vector<int> threads = context.Threads();
+
+        for (std::size_t k = 0; k < threads.size(); ++k) {
+            int p = threads[k];
+            for (int s = 0; s < count; ++s) {
+                int tiles = tileCounts[s];
+                Counting counting;
+                counting.PerWorker.assign((std::size_t)p * 8, 0);
+                Timing t = context.Measure([&]() {
+                    Native::ParallelForTiles(tiles, p, &Counting::Tile, &counting);
+                });
+                context.Add("scheduler", "dispatch", t).Param("tiles", tiles).Param("threads", p)
+                    .Counter("ns_per_tile", t.Median / tiles * 1e9);
+
+                long long sum = 0;
+                for (int w = 0; w < p; ++w)
+                    sum += counting.PerWorker[(std::size_t)w * 8];
+                long long expected = (long long)tiles * (tiles - 1) / 2 * (t.Iterations + 1);
+                context.Check(sum == expected, "ParallelForTiles skipped or repeated a tile");
+            }
+        }
+    }
+
+    void Run(Context& context) {
+        RunDispatch(context);
+        RunScaling(context);
+    }
+
+    SuiteRegistration registration("scheduler", &Run);
+}
@@ -0,0 +1,257 @@
+#include "Benchmark.h"
+#include "SparseInputs.h"
+#include "WPMathNative.h"
+
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    void Fill(std::vector<double>& v, unsigned seed) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (seed >> 8) * (1.0 / 16777216.0) - 0.5;
+        }
+    }
+
+    /// <summary>
+    /// Symmetric positive definite n x n matrix: a random symmetric matrix
+    /// with n added to the diagonal
+    /// </summary>
+    std::vector<double> SpdMatrix(int n) {
+        std::vector<double> r((std::size_t)n * n), a((std::size_t)n * n);
+        Fill(r, 5);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j)
+                a[(std::size_t)i * n + j] = r[(std::size_t)i * n + j] + r[(std::size_t)j * n + i] + (i == j ? n : 0);
+        }
+        return a;
+    }
+
+    /// <summary>
+    /// Dense factorizations and decompositions; each call factors a fresh
+    /// copy, so the copy is part of the time
+    /// </summary>
+    void RunDense(Context& context) {
+        static const int sizes[] = { 64, 128, 256, 512 };
+        int count = context.Quick() ? 1 : 4;
+
+        for (int s = 0; s < count; ++s) {
+            int n = sizes[s];
+            std::vector<double> spd = SpdMatrix(n), work(spd.size());
+            std::vector<double> b(n), x(n), tau(n), scratch(2 * (std::size_t)n);
+            std::vector<int> perm(n);
+            Fill(b, 6);
+            double cube = (double)n * n * n;
+
+            Timing t = context.Measure([&]() {
+                work = spd;
+                Native::LuFactor(&work[0], n, &perm[0]);
+                Native::LuSolve(&work[0], n, &perm[0], &b[0], 1, &x[0]);
+            });
+            context.Add("solvers", "lu", t).Param("n", n).Counter("gflops", 2.0 / 3.0 * cube / t.Median * 1e-9);
+
+            // Residual of the last solve
+            double worst = 0;
+            for (int i = 0; i < n; ++i) {
+                double r = -b[i];
+                for (int j = 0; j < n; ++j)
+                    r += spd[(std::size_t)i * n + j] * x[j];
+                worst = std::fmax(worst, std::fabs(r));
+            }
+            context.Check(worst < 1e-9, "LU solve residual too large");
+
+            bool positive = true;
+            t = context.Measure([&]() {
+                work = spd;
+                positive = Native::CholeskyFactor(&work[0], n);
+            });
+            context.Add("solvers", "cholesky", t).Param("n", n).Counter("gflops", cube / 3.0 / t.Median * 1e-9);
+            context.Check(positive, "Cholesky rejected a positive definite matrix");
+
+            t = context.Measure([&]() {
+                work = spd;
+                Native::QrFactor(&work[0], n, n, &tau[0], &perm[0], &scratch[0]);
+            });
+            context.Add("solvers", "qr", t).Param("n", n).Counter("gflops", 4.0 / 3.0 * cube / t.Median * 1e-9);
+
+        }
+    }
+
+    /// <summary>
+    /// Frobenius norm of a - u diag(s) v^T over n x n row-major factors,
+    /// relative to that of a and to n * epsilon
+    /// </summary>
+    double Reconstruction(const std::vector<double>& a, const std::vector<double>& u, const double* s,
+                          const std::vector<double>& v, int n, int degree) {
+        std::vector<double> scaled(u.size()), product(a.size());
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j)
+                scaled[(std::size_t)i * n + j] = u[(std::size_t)i * n + j] * s[j];
+        }
+        Native::ConstMatrixRef<double> rs = { &scaled[0], n, n, n, 1 };
+        Native::ConstMatrixRef<double> rvt = { &v[0], n, n, 1, n };
+        Native::GemmParallel<double>(rs, rvt, &product[0], n, degree);
+        double error = 0, norm = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            error += (a[i] - product[i]) * (a[i] - product[i]);
+            norm += a[i] * a[i];
+        }
+        return std::sqrt(error / norm) / (n * DBL_EPSILON);
+    }
+
+    /// <summary>
+    /// Frobenius norm of v^T v - I for n x n row-major v, relative to
+    /// n * epsilon
+    /// </summary>
+    double Orthogonality(const std::vector<double>& v, int n, int degree) {
+        std::vector<double> product(v.size());
+        Native::ConstMatrixRef<double> rvt = { &v[0], n, n, 1, n };
+        Native::ConstMatrixRef<double> rv = { &v[0], n, n, n, 1 };
+        Native::GemmParallel<double>(rvt, rv, &product[0], n, degree);
+        double error = 0;
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                double d = product[(std::size_t)i * n + j] - (i == j ? 1 : 0);
+                error += d * d;
+            }
+        }
+        return std::sqrt(error) / (n * DBL_EPSILON);
+    }
+
+    /// <summary>
+    /// Symmetric eigendecomposition and SVD with vectors, up to the sizes
+    /// where the blocked reductions matter, across thread counts. The
+    /// residual counters are the reconstruction and orthogonality errors in
+    /// units of n * epsilon.
+    /// </summary>
+    void RunSpectral(Context& context) {
+        static const int sizes[] = { 64, 128, 256, 512, 1024, 2048 };
+        int count = context.Quick() ? 1 : 6;
+        std::vector<int> threads = context.Threads();
+
+        for (int s = 0; s < count; ++s) {
+            int n = sizes[s];
+            std::vector<double> spd = SpdMatrix(n), general((std::size_t)n * n), work(spd.size());
+            Fill(general, 8);
+            std::vector<double> values(n), vectors((std::size_t)n * n), u((std::size_t)n * n), v((std::size_t)n * n);
+
+            for (std::size_t c = 0; c < threads.size(); ++c) {
+                int degree = threads[c];
+                bool converged = true;
+                Timing t = context.Measure([&]() {
+                    work = spd;
+                    converged = Native::SymmetricEigen(&work[0], n, &values[0], &vectors[0], degree) && converged;
+                });
+                double residual = Reconstruction(spd, vectors, &values[0], vectors, n, degree);
+                double orthogonality = Orthogonality(vectors, n, degree);
+                context.Add("solvers", "symmetric-eigen", t).Param("n", n).Param("threads", degree)
+                    .Counter("residual", residual).Counter("orthogonality", orthogonality);
+                context.Check(converged, "SymmetricEigen did not converge");
+                context.Check(residual < 10 && orthogonality < 10, "SymmetricEigen lost accuracy");
+
+                t = context.Measure([&]() {
+                    converged = Native::Svd(&general[0], n, n, &values[0], &u[0], &v[0], degree) && converged;
+                });
+                residual = Reconstruction(general, u, &values[0], v, n, degree);
+                orthogonality = std::fmax(Orthogonality(u, n, degree), Orthogonality(v, n, degree));
+                context.Add("solvers", "svd", t).Param("n", n).Param("threads", degree)
+                    .Counter("residual", residual).Counter("orthogonality", orthogonality);
+                context.Check(converged, "Svd did not converge");
+                context.Check(residual < 10 && orthogonality < 10, "Svd lost accuracy");
+            }
+        }
+    }
+
+    /// <summary>
+    /// Preconditioned conjugate gradients on the native kernels, the same
+    /// iteration ConjugateGradientSolver runs. precondition is 0 for none,
+    /// 1 for Jacobi and 2 for ILU(0). Returns the iteration count.
+    /// </summary>
+    int Pcg(const CsrInput& a, const std::vector<double>& b, std::vector<double>& x, int precondition,
+            const std::vector<double>& inverseDiagonal, const std::vector<double>& ilu, const std::vector<int>& diagonal,
+            std::vector<double>& r, std::vector<double>& z, std::vector<double>& p, std::vector<double>& ap) {
+        int n = a.Rows;
+        const double tolerance = 1e-8;
+        double bNorm = std::sqrt(Native::KrylovDot(&b[0], &b[0], n));
+
+        std::fill(x.begin(), x.end(), 0.0);
+        r = b;
+        if (precondition == 1)
+            Native::KrylovDiagonalScale(&inverseDiagonal[0], &r[0], &z[0], n);
+        else if (precondition == 2)
+            Native::IluSolve(&a.Pointers[0], &a.Indices[0], &ilu[0], &diagonal[0], n, &r[0], &z[0]);
+        else
+            z = r;
+        p = z;
+        double rz = Native::KrylovDot(&r[0], &z[0], n);
+
+        for (int iteration = 1; iteration <= 10000; ++iteration) {
+            Native::SparseGather(&a.Pointers[0], &a.Indices[0], &a.Values[0], n, &p[0], &ap[0]);
+            double alpha = rz / Native::KrylovDot(&p[0], &ap[0], n);
+            Native::KrylovAxpy(alpha, &p[0], &x[0], n);
+            Native::KrylovAxpy(-alpha, &ap[0], &r[0], n);
+            if (std::sqrt(Native::KrylovDot(&r[0], &r[0], n)) / bNorm <= tolerance)
+                return iteration;
+
+            if (precondition == 1)
+                Native::KrylovDiagonalScale(&inverseDiagonal[0], &r[0], &z[0], n);
+            else if (precondition == 2)
+                Native::IluSolve(&a.Pointers[0], &a.Indices[0], &ilu[0], &diagonal[0], n, &r[0], &z[0]);
+            else
+                z = r;
+            double rzNext = Native::KrylovDot(&r[0], &z[0], n);
+            Native::KrylovXpay(&z[0], rzNext / rz, &p[0], n);
+            rz = rzNext;
+        }
+        return -1;
+    }
+
+    /// <summary>
+    /// Conjugate gradients on grid Laplacians to a relative residual of 1e-8,
+    /// unpreconditioned and with Jacobi and ILU(0), plus the ILU(0) setup
+    /// </summary>
+    void RunIterative(Context& context) {
+        static const int sides[] = { 64, 128, 256 };
+        static const char* names[] = { "cg", "cg-jacobi", "cg-ilu0" };
+        int count = context.Quick() ? 1 : 3;
+
+        for (int s = 0; s < count; ++s) {
+            CsrInput a = Laplacian(sides[s]);
+            int n = a.Rows;
+            std::vector<double> b(n), x(n), r(n), z(n), p(n), ap(n), inverseDiagonal(n, 0.25);
+            std::vector<double> ilu;
+            std::vector<int> diagonal(n);
+            Fill(b, 7);
+
+            int failed = 0;
+            Timing t = context.Measure([&]() {
+                ilu = a.Values;
+                failed = Native::IluFactor(&a.Pointers[0], &a.Indices[0], &ilu[0], n, &diagonal[0]);
+            });
+            context.Add("solvers", "ilu0-factor", t).Param("n", n).Param("nnz", a.NonZeros());
+            context.Check(failed < 0, "ILU(0) hit a zero pivot");
+
+            for (int kind = 0; kind < 3; ++kind) {
+                int iterations = 0;
+                t = context.Measure([&]() {
+                    iterations = Pcg(a, b, x, kind, inverseDiagonal, ilu, diagonal, r, z, p, ap);
+                });
+                context.Add("solvers", names[kind], t).Param("n", n).Param("nnz", a.NonZeros())
+                    .Counter("iterations", iterations).Counter("us_per_iteration", t.Median / iterations * 1e6);
+                context.Check(iterations > 0, "Conjugate gradients did not converge");
+            }
+        }
+    }
+
+    void Run(Context& context) {
+        RunDense(context);
+        RunSpectral(context);
+        RunIterative(context);
+    }
+
+    SuiteRegistration registration("solvers", &Run);
+}
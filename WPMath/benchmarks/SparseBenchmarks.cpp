@@ -0,0 +1,143 @@
+#include "Benchmark.h"
+#include "SparseInputs.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    struct NamedInput {
+        const char* Name;
+        CsrInput Matrix;
+    };
+
+    /// <summary>
+    /// Grid Laplacians, narrow band matrices and random sparse matrices, the
+    /// last with no locality in x. The smallest of each is small enough to
+    /// compare with dense storage.
+    /// </summary>
+    std::vector<NamedInput> Inputs(bool quick) {
+        static const int sides[] = { 64, 256, 1024 };
+        static const int lengths[] = { 2048, 65536, 1048576 };
+        int count = quick ? 1 : 3;
+        std::vector<NamedInput> inputs;
+        for (int s = 0; s < count; ++s) {
+            NamedInput laplacian = { "laplacian", Laplacian(sides[s]) };
+            NamedInput banded = { "banded", Banded(lengths[s], 4) };
+            NamedInput random = { "random", RandomSparse(lengths[s], 8, 17) };
+            inputs.push_back(laplacian);
+            inputs.push_back(banded);
+            inputs.push_back(random);
+        }
+        return inputs;
+    }
+
+    /// <summary>
+    /// Bytes a product streams: every value and column index once, the row
+    /// pointers, and x and y once each
+    /// </summary>
+    double ProductBytes(const CsrInput& a) {
+        return (double)a.NonZeros() * (sizeof(double) + sizeof(int)) + (a.Rows + 1.0) * sizeof(int) +
+               ((double)a.Rows + a.Columns) * sizeof(double);
+    }
+
+    /// <summary>
+    /// Bytes CSR storage holds: values, column indices and row pointers
+    /// </summary>
+    double StorageBytes(const CsrInput& a) {
+        return (double)a.NonZeros() * (sizeof(double) + sizeof(int)) + (a.Rows + 1.0) * sizeof(int);
+    }
+
+    double MaxDifference(const std::vector<double>& a, const std::vector<double>& b) {
+        double worst = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            worst = std::fmax(worst, std::fabs(a[i] - b[i]));
+        return worst;
+    }
+
+    /// <summary>
+    /// For each input: storage against dense, y = A x against the dense
+    /// product where dense fits, CSR products y = A x (gather) and
+    /// y = A^T x (scatter) serial and at each thread count, and
+    /// re-compression to CSC
+    /// </summary>
+    void Run(Context& context) {
+        std::vector<NamedInput> inputs = Inputs(context.Quick());
+        std::vector<int> threads = context.Threads();
+
+        for (std::size_t s = 0; s < inputs.size(); ++s) {
+            const char* kind = inputs[s].Name;
+            const CsrInput& a = inputs[s].Matrix;
+            int n = a.Rows, nnz = a.NonZeros();
+            std::vector<double> x(n), y(n), serial(n);
+            for (int i = 0; i < n; ++i)
+                x[i] = 1.0 + (i % 7) * 0.125;
+            double bytes = ProductBytes(a);
+            double denseBytes = (double)n * a.Columns * sizeof(double);
+
+            Timing t = context.Measure([&]() {
+                Native::SparseGather(&a.Pointers[0], &a.Indices[0], &a.Values[0], n, &x[0], &serial[0]);
+            });
+            context.Add("sparse", "gather", t).Param("matrix", kind).Param("n", n).Param("nnz", nnz).Param("threads", 1)
+                .Counter("gbps", bytes / t.Median * 1e-9).Counter("csr_bytes", StorageBytes(a))
+                .Counter("dense_bytes", denseBytes).Counter("compression", denseBytes / StorageBytes(a));
+
+            // The dense product reads all n^2 entries, zeros included
+            if (n <= 4096) {
+                std::vector<double> dense((std::size_t)n * n, 0.0);
+                for (int i = 0; i < n; ++i) {
+                    for (int k = a.Pointers[i]; k < a.Pointers[i + 1]; ++k)
+                        dense[(std::size_t)i * n + a.Indices[k]] = a.Values[k];
+                }
+                Timing d = context.Measure([&]() {
+                    for (int i = 0; i < n; ++i) {
+                        const double* row = &dense[(std::size_t)i * n];
+                        double sum = 0;
+                        for (int j = 0; j < n; ++j)
+                            sum += row[j] * x[j];
+                        y[i] = sum;
+                    }
+                });
+                context.Add("sparse", "dense-gemv", d).Param("matrix", kind).Param("n", n).Param("nnz", nnz)
+                    .Counter("gbps", denseBytes / d.Median * 1e-9).Counter("sparse_speedup", d.Median / t.Median);
+                context.Check(MaxDifference(y, serial) < 1e-12 * n, "SparseGather differs from the dense product");
+            }
+
+            for (std::size_t k = 0; k < threads.size(); ++k) {
+                int p = threads[k];
+                t = context.Measure([&]() {
+                    Native::SparseGatherParallel(&a.Pointers[0], &a.Indices[0], &a.Values[0], n, &x[0], &y[0], p);
+                });
+                context.Add("sparse", "gather-parallel", t).Param("matrix", kind).Param("n", n).Param("nnz", nnz)
+                    .Param("threads", p).Counter("gbps", bytes / t.Median * 1e-9);
+                context.Check(y == serial, "SparseGatherParallel differs from SparseGather");
+            }
+
+            std::vector<int> pointers(n + 1), indices(nnz);
+            std::vector<double> values(nnz);
+            t = context.Measure([&]() {
+                Native::SparseTranspose(&a.Pointers[0], &a.Indices[0], &a.Values[0], n, n, &pointers[0], &indices[0], &values[0]);
+            });
+            context.Add("sparse", "transpose", t).Param("matrix", kind).Param("n", n).Param("nnz", nnz)
+                .Counter("ns_per_nonzero", t.Median / nnz * 1e9);
+
+            // A^T x by scatter must match a gather over the transposed arrays
+            std::vector<double> transposed(n);
+            Native::SparseGather(&pointers[0], &indices[0], &values[0], n, &x[0], &transposed[0]);
+            for (std::size_t k = 0; k < threads.size(); ++k) {
+                int p = threads[k];
+                t = context.Measure([&]() {
+                    Native::SparseScatterParallel(&a.Pointers[0], &a.Indices[0], &a.Values[0], n, n, &x[0], &y[0], p);
+                });
+                context.Add("sparse", "scatter-parallel", t).Param("matrix", kind).Param("n", n).Param("nnz", nnz)
+                    .Param("threads", p).Counter("gbps", bytes / t.Median * 1e-9);
+                context.Check(MaxDifference(y, transposed) < 1e-12, "SparseScatterParallel differs from the transpose product");
+            }
+        }
+    }
+
+    SuiteRegistration registration("sparse", &Run);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+namespace WindowPlus {
+    namespace Math {
+        namespace Benchmarks {
+            /// <summary>
+            /// Compressed sparse row matrix with sorted column indices, the
+            /// layout the native sparse kernels take
+            /// </summary>
+            struct CsrInput {
+                int Rows;
+                int Columns;
+                std::vector<int> Pointers;
+                std::vector<int> Indices;
+                std::vector<double> Values;
+
+                int NonZeros() const { return Pointers[Rows]; }
+            };
+
+            /// <summary>
+            /// Five-point Laplacian of a side x side grid: symmetric positive
+            /// definite, four off-diagonals at distances 1 and side
+            /// </summary>
+            inline CsrInput Laplacian(int side) {
+                CsrInput a;
+                a.Rows = a.Columns = side * side;
+                a.Pointers.push_back(0);
+                for (int y = 0; y < side; ++y) {
+                    for (int x = 0; x < side; ++x) {
+                        int i = y * side + x;
+                        if (y > 0) { a.Indices.push_back(i - side); a.Values.push_back(-1); }
+                        if (x > 0) { a.Indices.push_back(i - 1); a.Values.push_back(-1); }
+                        a.Indices.push_back(i);
+                        a.Values.push_back(4);
+                        if (x + 1 < side) { a.Indices.push_back(i + 1); a.Values.push_back(-1); }
+                        if (y + 1 < side) { a.Indices.push_back(i + side); a.Values.push_back(-1); }
+                        a.Pointers.push_back((int)a.Indices.size());
+                    }
+                }
+                return a;
+            }
+
+            /// <summary>
+            /// n x n band matrix with halfWidth entries either side of a
+            /// dominant diagonal
+            /// </summary>
+            inline CsrInput Banded(int n, int halfWidth) {
+                CsrInput a;
+                a.Rows = a.Columns = n;
+                a.Pointers.push_back(0);
+                for (int i = 0; i < n; ++i) {
+                    int first = i - halfWidth > 0 ? i - halfWidth : 0;
+                    int last = i + halfWidth < n - 1 ? i + halfWidth : n - 1;
+                    for (int j = first; j <= last; ++j) {
+                        a.Indices.push_back(j);
+                        a.Values.push_back(j == i ? 2.0 * halfWidth + 1 : -1.0 / (1 + (j > i ? j - i : i - j)));
+                    }
+                    a.Pointers.push_back((int)a.Indices.size());
+                }
+                return a;
+            }
+
+            /// <summary>
+            /// n x n matrix with the diagonal and perRow - 1 other entries per
+            /// row in uniformly random columns, so x is read with no locality
+            /// </summary>
+            inline CsrInput RandomSparse(int n, int perRow, unsigned seed) {
+                CsrInput a;
+                a.Rows = a.Columns = n;
+                a.Pointers.push_back(0);
+                std::vector<int> columns;
+                for (int i = 0; i < n; ++i) {
+                    columns.assign(1, i);
+                    while ((int)columns.size() < perRow && (int)columns.size() < n) {
+                        seed = seed * 1664525u + 1013904223u;
+                        int j = (int)((unsigned long long)(seed >> 4) * (unsigned)n >> 28);
+                        if (std::find(columns.begin(), columns.end(), j) == columns.end())
+                            columns.push_back(j);
+                    }
+                    std::sort(columns.begin(), columns.end());
+                    for (std::size_t k = 0; k < columns.size(); ++k) {
+                        a.Indices.push_back(columns[k]);
+                        a.Values.push_back(columns[k] == i ? (double)perRow : 0.5);
+                    }
+                    a.Pointers.push_back((int)a.Indices.size());
+                }
+                return a;
+            }
+        }
+    }
+}
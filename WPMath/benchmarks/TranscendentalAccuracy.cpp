@@ -0,0 +1,242 @@
+// Accuracy harness for the vectorized transcendentals in Transcendental.h.
+// Measures the largest error in ulps of VectorSinCos, VectorExp, VectorLog and
+// VectorAtan2 over the ranges their comments document, and fails when a
+// function exceeds its documented bound. Float results are compared with the
+// CRT in double and double results with the CRT in long double, so the double
+// figures need a long double wider than double (x86 GCC and Clang; not MSVC).
+
+#include "WPMathNative.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace WindowPlus::Math;
+
+namespace {
+    typedef long double Wide;
+
+    /// <summary>
+    /// Deterministic uniform samples in [0, 1)
+    /// </summary>
+    class Samples {
+    private:
+        unsigned long long state;
+
+    public:
+        explicit Samples(unsigned long long seed) : state(seed) {}
+
+        double Next() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return (state >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        double Uniform(double low, double high) {
+            return low + (high - low) * Next();
+        }
+
+        /// <summary>
+        /// Magnitude spread evenly over the binary exponents of
+        /// [low, high], with a random sign when withSign is set
+        /// </summary>
+        double LogUniform(double low, double high, bool withSign) {
+            double v = std::exp2(Uniform(std::log2(low), std::log2(high)));
+            return withSign && Next() < 0.5 ? -v : v;
+        }
+    };
+
+    /// <summary>
+    /// Error of result against the reference in units of the last place of
+    /// T at the reference's magnitude; subnormal results use the smallest
+    /// subnormal spacing
+    /// </summary>
+    template<typename T>
+    double UlpError(T result, Wide reference) {
+        if (std::isnan(reference))
+            return std::isnan(result) ? 0 : std::numeric_limits<double>::infinity();
+        T rounded = (T)reference;
+        if (std::isinf(rounded))
+            return result == rounded ? 0 : std::numeric_limits<double>::infinity();
+        if ((Wide)result == reference)
+            return 0;
+        int exponent;
+        std::frexp(std::fabs(reference), &exponent);
+        if (exponent < std::numeric_limits<T>::min_exponent)
+            exponent = std::numeric_limits<T>::min_exponent;
+        Wide ulp = std::ldexp((Wide)1, exponent - std::numeric_limits<T>::digits);
+        return (double)(std::fabs((Wide)result - reference) / ulp);
+    }
+
+    /// <summary>
+    /// Reference values: the CRT one precision up
+    /// </summary>
+    template<typename T> struct Reference;
+
+    template<> struct Reference<float> {
+        static Wide Sin(float x) { return std::sin((double)x); }
+        static Wide Cos(float x) { return std::cos((double)x); }
+        static Wide Exp(float x) { return std::exp((double)x); }
+        static Wide Log(float x) { return std::log((double)x); }
+        static Wide Atan2(float y, float x) { return std::atan2((double)y, (double)x); }
+    };
+
+    template<> struct Reference<double> {
+        static Wide Sin(double x) { return std::sin((Wide)x); }
+        static Wide Cos(double x) { return std::cos((Wide)x); }
+        static Wide Exp(double x) { return std::exp((Wide)x); }
+        static Wide Log(double x) { return std::log((Wide)x); }
+        static Wide Atan2(double y, double x) { return std::atan2((Wide)y, (Wide)x); }
+    };
+
+    /// <summary>
+    /// Documented range and bounds per element type
+    /// </summary>
+    template<typename T> struct Documented;
+
+    template<> struct Documented<float> {
+        static const char* Name() { return "float"; }
+        static double TrigRange() { return 8192; }
+        static double TrigUlps() { return 3; }
+        static double ExpLow() { return -103.9; }
+        static double ExpHigh() { return 88.7; }
+        static double ExpUlps() { return 1.5; }
+        static double LogUlps() { return 1; }
+        static double Atan2Ulps() { return 3; }
+    };
+
+    template<> struct Documented<double> {
+        static const char* Name() { return "double"; }
+        static double TrigRange() { return 1e8; }
+        static double TrigUlps() { return 2; }
+        static double ExpLow() { return -745.1; }
+        static double ExpHigh() { return 709.7; }
+        static double ExpUlps() { return 2; }
+        static double LogUlps() { return 1.5; }
+        static double Atan2Ulps() { return 3; }
+    };
+
+    struct Worst {
+        double Ulps;
+        double X;
+        double Y;
+
+        Worst() : Ulps(0), X(0), Y(0) {}
+
+        void Update(double ulps, double x, double y = 0) {
+            if (ulps > Ulps) {
+                Ulps = ulps;
+                X = x;
+                Y = y;
+            }
+        }
+    };
+
+    int failures = 0;
+
+    void Report(const char* function, const char* type, const char* range, long long count, const Worst& worst, double bound,
+                bool twoArguments) {
+        bool ok = worst.Ulps <= bound;
+        if (!ok)
+            ++failures;
+        if (twoArguments)
+            std::printf("%-6s %-6s %-28s %10lld samples  max %7.3f ulp (bound %.1f) at (%.17g, %.17g)%s\n", function, type,
+                        range, count, worst.Ulps, bound, worst.Y, worst.X, ok ? "" : "  FAILED");
+        else
+            std::printf("%-6s %-6s %-28s %10lld samples  max %7.3f ulp (bound %.1f) at %.17g%s\n", function, type, range,
+                        count, worst.Ulps, bound, worst.X, ok ? "" : "  FAILED");
+    }
+
+    template<typename T>
+    void Check(long long samples) {
+        typedef Documented<T> D;
+        typedef Reference<T> R;
+        const int batch = 4096;
+        std::vector<T> x(batch), y(batch), a(batch), b(batch);
+        char range[64];
+
+        // sin and cos: half uniform over the whole range, half spread over
+        // magnitudes so small arguments are covered too
+        {
+            Samples random(1);
+            Worst sinWorst, cosWorst;
+            for (long long done = 0; done < samples; done += batch) {
+                for (int i = 0; i < batch; ++i)
+                    x[i] = (T)(i % 2 == 0 ? random.Uniform(-D::TrigRange(), D::TrigRange())
+                                          : random.LogUniform(1e-20, D::TrigRange(), true));
+                Native::VectorSinCos(&x[0], &a[0], &b[0], batch);
+                for (int i = 0; i < batch; ++i) {
+                    sinWorst.Update(UlpError(a[i], R::Sin(x[i])), x[i]);
+                    cosWorst.Update(UlpError(b[i], R::Cos(x[i])), x[i]);
+                }
+            }
+            std::snprintf(range, sizeof(range), "|x| <= %g", D::TrigRange());
+            Report("sin", D::Name(), range, samples, sinWorst, D::TrigUlps(), false);
+            Report("cos", D::Name(), range, samples, cosWorst, D::TrigUlps(), false);
+        }
+
+        // exp over the finite domain, including the subnormal results
+        {
+            Samples random(2);
+            Worst worst;
+            for (long long done = 0; done < samples; done += batch) {
+                for (int i = 0; i < batch; ++i)
+                    x[i] = (T)(i % 2 == 0 ? random.Uniform(D::ExpLow(), D::ExpHigh()) : random.Uniform(-1, 1));
+                Native::VectorExp(&x[0], &a[0], batch);
+                for (int i = 0; i < batch; ++i)
+                    worst.Update(UlpError(a[i], R::Exp(x[i])), x[i]);
+            }
+            std::snprintf(range, sizeof(range), "[%g, %g]", D::ExpLow(), D::ExpHigh());
+            Report("exp", D::Name(), range, samples, worst, D::ExpUlps(), false);
+        }
+
+        // log over every binade, subnormals included, and densely near 1
+        {
+            Samples random(3);
+            Worst worst;
+            double low = std::numeric_limits<T>::denorm_min(), high = std::numeric_limits<T>::max();
+            for (long long done = 0; done < samples; done += batch) {
+                for (int i = 0; i < batch; ++i)
+                    x[i] = (T)(i % 2 == 0 ? random.LogUniform(low, high / 2, false) : random.Uniform(0.5, 2));
+                Native::VectorLog(&x[0], &a[0], batch);
+                for (int i = 0; i < batch; ++i)
+                    worst.Update(UlpError(a[i], R::Log(x[i])), x[i]);
+            }
+            Report("log", D::Name(), "(0, max]", samples, worst, D::LogUlps(), false);
+        }
+
+        // atan2 in all four quadrants over a wide spread of ratios
+        {
+            Samples random(4);
+            Worst worst;
+            for (long long done = 0; done < samples; done += batch) {
+                for (int i = 0; i < batch; ++i) {
+                    y[i] = (T)random.LogUniform(1e-30, 1e30, true);
+                    x[i] = (T)random.LogUniform(1e-30, 1e30, true);
+                }
+                Native::VectorAtan2(&y[0], &x[0], &a[0], batch);
+                for (int i = 0; i < batch; ++i)
+                    worst.Update(UlpError(a[i], R::Atan2(y[i], x[i])), x[i], y[i]);
+            }
+            Report("atan2", D::Name(), "|x|, |y| in [1e-30, 1e30]", samples, worst, D::Atan2Ulps(), true);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    long long samples = 1 << 20;
+    if (argc > 1)
+        samples = std::atoll(argv[1]);
+    if (samples < 1) {
+        std::printf("Usage: TranscendentalAccuracy [samples per function]\n");
+        return 2;
+    }
+    if (std::numeric_limits<Wide>::digits <= DBL_MANT_DIG)
+        std::printf("long double is no wider than double; double figures are only indicative\n");
+
+    Check<float>(samples);
+    Check<double>(samples);
+    return failures == 0 ? 0 : 1;
+}
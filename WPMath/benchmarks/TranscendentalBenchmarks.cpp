@@ -0,0 +1,105 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    template<typename T>
+    void Fill(std::vector<T>& v, unsigned seed, double low, double high) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (T)(low + (high - low) * ((seed >> 8) * (1.0 / 16777216.0)));
+        }
+    }
+
+    /// <summary>
+    /// Adds the vector and CRT records of one function, with the time per
+    /// element and the vector kernel's speedup over the CRT loop
+    /// </summary>
+    void AddPair(Context& context, const char* function, const char* type, int n, const Timing& vector, const Timing& crt) {
+        context.Add("transcendental", "crt", crt).Param("function", function).Param("type", type).Param("n", n)
+            .Counter("ns_per_element", crt.Median / n * 1e9);
+        context.Add("transcendental", "vector", vector).Param("function", function).Param("type", type).Param("n", n)
+            .Counter("ns_per_element", vector.Median / n * 1e9).Counter("speedup", crt.Median / vector.Median);
+    }
+
+    /// <summary>
+    /// Throughput of the vector kernels against a loop over the CRT
+    /// functions on the same arguments, over arrays that stay in cache.
+    /// Accuracy is checked separately by TranscendentalAccuracy.
+    /// </summary>
+    template<typename T>
+    void RunType(Context& context, const char* type) {
+        int n = 4096;
+        std::vector<T> x(n), y(n), s(n), c(n);
+
+        Fill(x, 1, -100, 100);
+        Timing vector = context.Measure([&]() {
+            Native::VectorSinCos(&x[0], &s[0], &c[0], n);
+        });
+        Timing crt = context.Measure([&]() {
+            for (int i = 0; i < n; ++i) {
+                s[i] = std::sin(x[i]);
+                c[i] = std::cos(x[i]);
+            }
+        });
+        AddPair(context, "sincos", type, n, vector, crt);
+
+        Fill(x, 2, -80, 80);
+        vector = context.Measure([&]() {
+            Native::VectorExp(&x[0], &s[0], n);
+        });
+        crt = context.Measure([&]() {
+            for (int i = 0; i < n; ++i)
+                s[i] = std::exp(x[i]);
+        });
+        AddPair(context, "exp", type, n, vector, crt);
+
+        Fill(x, 3, 1e-3, 1e3);
+        vector = context.Measure([&]() {
+            Native::VectorLog(&x[0], &s[0], n);
+        });
+        crt = context.Measure([&]() {
+            for (int i = 0; i < n; ++i)
+                s[i] = std::log(x[i]);
+        });
+        AddPair(context, "log", type, n, vector, crt);
+
+        Fill(x, 4, -10, 10);
+        Fill(y, 5, -10, 10);
+        vector = context.Measure([&]() {
+            Native::VectorAtan2(&y[0], &x[0], &s[0], n);
+        });
+        crt = context.Measure([&]() {
+            for (int i = 0; i < n; ++i)
+                s[i] = std::atan2(y[i], x[i]);
+        });
+        AddPair(context, "atan2", type, n, vector, crt);
+
+        // Table lookup trades accuracy for speed; error is (2 pi / size)^2 / 8
+        const int size = 4096;
+        std::vector<T> table(size + size / 4 + 1);
+        Native::BuildSineTable(&table[0], size);
+        Fill(x, 1, -100, 100);
+        Timing lookup = context.Measure([&]() {
+            Native::TableSinCos(&table[0], size, &x[0], &s[0], &c[0], n);
+        });
+        context.Add("transcendental", "table", lookup).Param("function", "sincos").Param("type", type).Param("n", n)
+            .Param("table", size).Counter("ns_per_element", lookup.Median / n * 1e9);
+        double worst = 0;
+        for (int i = 0; i < n; ++i)
+            worst = std::fmax(worst, std::fabs(s[i] - std::sin((double)x[i])));
+        context.Check(worst < 1e-5, "TableSinCos exceeds its documented error");
+    }
+
+    void Run(Context& context) {
+        RunType<float>(context, "float");
+        RunType<double>(context, "double");
+    }
+
+    SuiteRegistration registration("transcendental", &Run);
+}
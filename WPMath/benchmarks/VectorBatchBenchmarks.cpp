@@ -0,0 +1,151 @@
+#include "Benchmark.h"
+#include "WPMathNative.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace WindowPlus::Math;
+using namespace WindowPlus::Math::Benchmarks;
+
+namespace {
+    template<typename T>
+    void Fill(std::vector<T>& v, unsigned seed, double low, double high) {
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            v[i] = (T)(low + (high - low) * ((seed >> 8) * (1.0 / 16777216.0)));
+        }
+    }
+
+    /// <summary>
+    /// Largest difference between a kernel's output and the scalar loop's,
+    /// relative to the scalar value where that is above one
+    /// </summary>
+    template<typename T>
+    double WorstError(const std::vector<T>& actual, const std::vector<T>& expected, std::size_t count) {
+        double worst = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            double scale = std::fmax(1.0, std::fabs((double)expected[i]));
+            worst = std::fmax(worst, std::fabs((double)actual[i] - (double)expected[i]) / scale);
+        }
+        return worst;
+    }
+
+    /// <summary>
+    /// Adds the kernel and scalar-loop records of one operation, with the
+    /// time per point and the kernel's speedup over the loop
+    /// </summary>
+    void AddPair(Context& context, const char* operation, const char* type, int n, const Timing& kernel, const Timing& scalar) {
+        context.Add("vector-batch", "scalar", scalar).Param("operation", operation).Param("type", type).Param("n", n)
+            .Counter("ns_per_point", scalar.Median / n * 1e9);
+        context.Add("vector-batch", "kernel", kernel).Param("operation", operation).Param("type", type).Param("n", n)
+            .Counter("ns_per_point", kernel.Median / n * 1e9).Counter("speedup", scalar.Median / kernel.Median);
+    }
+
+    /// <summary>
+    /// Throughput of the structure-of-arrays kernels against the plain
+    /// loop over the same points, on counts that are not a multiple of the
+    /// vector width so the tail runs too. Every kernel must agree with
+    /// its loop to a few ulps. The compiler vectorizes the dot and cross
+    /// loops itself, so a speedup near one is expected there.
+    /// </summary>
+    template<typename T>
+    void RunType(Context& context, const char* type, double tolerance) {
+        int n = 4099;
+        std::vector<T> ax(n), ay(n), az(n), bx(n), by(n), bz(n);
+        std::vector<T> rx(n), ry(n), rz(n), ex(n), ey(n), ez(n);
+        Fill(ax, 1, -10, 10);
+        Fill(ay, 2, -10, 10);
+        Fill(az, 3, -10, 10);
+        Fill(bx, 4, -10, 10);
+        Fill(by, 5, -10, 10);
+        Fill(bz, 6, -10, 10);
+
+        Timing kernel = context.Measure([&]() {
+            Native::BatchDot(&ax[0], &ay[0], &az[0], &bx[0], &by[0], &bz[0], &rx[0], n);
+        });
+        Timing scalar = context.Measure([&]() {
+            for (int i = 0; i < n; ++i)
+                ex[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+        });
+        AddPair(context, "dot3", type, n, kernel, scalar);
+        // Products of values up to 10 cancel, so compare against their magnitude
+        context.Check(WorstError(rx, ex, n) < 300 * tolerance, "BatchDot disagrees with the scalar loop");
+
+        kernel = context.Measure([&]() {
+            Native::BatchCross(&ax[0], &ay[0], &az[0], &bx[0], &by[0], &bz[0], &rx[0], &ry[0], &rz[0], n);
+        });
+        scalar = context.Measure([&]() {
+            for (int i = 0; i < n; ++i) {
+                ex[i] = ay[i] * bz[i] - az[i] * by[i];
+                ey[i] = az[i] * bx[i] - ax[i] * bz[i];
+                ez[i] = ax[i] * by[i] - ay[i] * bx[i];
+            }
+        });
+        AddPair(context, "cross", type, n, kernel, scalar);
+        double worst = std::fmax(WorstError(rx, ex, n), std::fmax(WorstError(ry, ey, n), WorstError(rz, ez, n)));
+        context.Check(worst < 200 * tolerance, "BatchCross disagrees with the scalar loop");
+
+        kernel = context.Measure([&]() {
+            Native::BatchDistance(&ax[0], &ay[0], &az[0], &bx[0], &by[0], &bz[0], &rx[0], n);
+        });
+        scalar = context.Measure([&]() {
+            for (int i = 0; i < n; ++i) {
+                T dx = ax[i] - bx[i], dy = ay[i] - by[i], dz = az[i] - bz[i];
+                ex[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+            }
+        });
+        AddPair(context, "distance3", type, n, kernel, scalar);
+        context.Check(WorstError(rx, ex, n) < 4 * tolerance, "BatchDistance disagrees with the scalar loop");
+
+        // A 256 x 259 block, row by row
+        const int rows = 256, columns = 259;
+        std::vector<T> matrix((std::size_t)rows * columns), expected(matrix.size());
+        kernel = context.Measure([&]() {
+            Native::PairwiseDistances(&ax[0], &ay[0], &az[0], rows, &bx[0], &by[0], &bz[0], columns, &matrix[0]);
+        });
+        scalar = context.Measure([&]() {
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < columns; ++j) {
+                    T dx = ax[i] - bx[j], dy = ay[i] - by[j], dz = az[i] - bz[j];
+                    expected[(std::size_t)i * columns + j] = std::sqrt(dx * dx + dy * dy + dz * dz);
+                }
+            }
+        });
+        AddPair(context, "pairwise3", type, rows * columns, kernel, scalar);
+        context.Check(WorstError(matrix, expected, matrix.size()) < 4 * tolerance,
+                      "PairwiseDistances disagrees with the scalar loop");
+
+        // A few zero and underflowing points among the rest
+        for (int i = 0; i < n; i += 97) {
+            ax[i] = ay[i] = az[i] = T();
+            if (i % 2)
+                ax[i] = std::numeric_limits<T>::denorm_min();
+        }
+        kernel = context.Measure([&]() {
+            Native::BatchNormalize(&ax[0], &ay[0], &az[0], &rx[0], &ry[0], &rz[0], n);
+        });
+        scalar = context.Measure([&]() {
+            for (int i = 0; i < n; ++i) {
+                T length = std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+                ex[i] = length > 0 ? ax[i] / length : T();
+                ey[i] = length > 0 ? ay[i] / length : T();
+                ez[i] = length > 0 ? az[i] / length : T();
+            }
+        });
+        AddPair(context, "normalize3", type, n, kernel, scalar);
+        worst = std::fmax(WorstError(rx, ex, n), std::fmax(WorstError(ry, ey, n), WorstError(rz, ez, n)));
+        context.Check(worst < 4 * tolerance, "BatchNormalize disagrees with the scalar loop");
+        bool zeros = true;
+        for (int i = 0; i < n; i += 97)
+            zeros = zeros && rx[i] == 0 && ry[i] == 0 && rz[i] == 0;
+        context.Check(zeros, "BatchNormalize moved a zero-length point off zero");
+    }
+
+    void Run(Context& context) {
+        RunType<float>(context, "float", 6e-8);
+        RunType<double>(context, "double", 1.2e-16);
+    }
+
+    SuiteRegistration registration("vector-batch", &Run);
+}